@@ -74,6 +74,7 @@ void *rx_thread(void *arg) {
     AMP_DEBUG_ENTRY("rx_thread","agent(%p)", agent);;
 #endif
     AMP_DEBUG_INFO("rx_thread","Receiver thread running...");
+    nmagent_select(agent);
     
 
     vecit_t it;
@@ -131,6 +132,7 @@ void *rx_thread(void *arg) {
             }
 
             msg_grp_release(grp, 1);
+            nmagent_pool_wake(agent);
         }
     }
    
@@ -215,7 +217,7 @@ void rx_handle_perf_ctrl(msg_metadata_t *meta, blob_t *contents)
 		}
 		else
 		{
-#if 0
+			/* Persist first; once queued the ctrl may run at any time. */
 			if(db_persist_ctrl(ctrl) != AMP_OK)
 			{
 				AMP_DEBUG_ERR("rx_ingest_ctrl", "Cannot persist ctrl.", NULL);
@@ -224,18 +226,20 @@ void rx_handle_perf_ctrl(msg_metadata_t *meta, blob_t *contents)
 			}
 
 
-			/* Load macro to VDB. */
+			/* Queue the ctrl by its start time. */
 			if(VDB_ADD_CTRL(ctrl, NULL) != AMP_OK)
 			{
-				db_forget(&(ctrl->desc), gDB.ctrls);
+				db_forget(&(ctrl->desc));
 				AMP_DEBUG_ERR("rx_ingest_ctrl", "Cannot store ctrl in RAM.", NULL);
 				ctrl_release(ctrl, 1);
 				break;
 			}
-#endif
 		}
 	}
 
+	/* Commit the whole schedule together. */
+	db_sync();
+
 	msg_ctrl_release(msg, 1);
 }
 
@@ -34,20 +34,279 @@
  *****************************************************************************/
 
 #include "instr.h"
+#include "../shared/utils/utils.h"
 
 #include <string.h>
+#include <stdatomic.h>
+#include <time.h>
 
-agent_instr_t gAgentInstr;
+
+/* One shard of the counters and histograms, on its own cache lines. */
+typedef struct {
+	atomic_uint_fast64_t ctrs[AGENT_INSTR_NUM_CTRS];
+	atomic_uint_fast64_t lat_counts[AGENT_INSTR_NUM_LATS][AGENT_INSTR_LAT_BUCKETS];
+	atomic_uint_fast64_t lat_total[AGENT_INSTR_NUM_LATS];
+	atomic_uint_fast64_t lat_max[AGENT_INSTR_NUM_LATS];
+} __attribute__((aligned(64))) agent_instr_shard_t;
+
+/* Collect times of one EDD, claimed by the first collection of it. */
+typedef struct {
+	_Atomic(ari_t *) id;
+	atomic_uint_fast64_t count;
+	atomic_uint_fast64_t total_us;
+	atomic_uint_fast64_t max_us;
+} agent_instr_edd_slot_t;
+
+static agent_instr_shard_t gInstrShards[AGENT_INSTR_SHARDS];
+static agent_instr_edd_slot_t gInstrEdds[AGENT_INSTR_EDD_SLOTS];
+
+static atomic_uint gInstrNextShard;
+static __thread agent_instr_shard_t *gInstrShard;
+
+static const char *gInstrLatNames[AGENT_INSTR_NUM_LATS] = {
+	"rule_lag",
+	"edd_collect",
+	"ctrl_run",
+	"rpt_queue",
+	"rpt_send"
+};
+
+
+/* The shard of the calling thread, assigned round-robin on first use. */
+static inline agent_instr_shard_t *agent_instr_shard()
+{
+	if(gInstrShard == NULL)
+	{
+		gInstrShard = &(gInstrShards[atomic_fetch_add_explicit(&gInstrNextShard, 1, memory_order_relaxed) % AGENT_INSTR_SHARDS]);
+	}
+	return gInstrShard;
+}
+
+static inline void agent_instr_max(atomic_uint_fast64_t *max, uint64_t val)
+{
+	uint_fast64_t cur = atomic_load_explicit(max, memory_order_relaxed);
+
+	while((val > cur) &&
+		  !atomic_compare_exchange_weak_explicit(max, &cur, val, memory_order_relaxed, memory_order_relaxed));
+}
+
+static inline int agent_instr_lat_bucket(uint64_t usec)
+{
+	int msb;
+
+	if(usec < (1 << AGENT_INSTR_LAT_SUB_BITS))
+	{
+		return (int) usec;
+	}
+	if(usec >= ((uint64_t)1 << AGENT_INSTR_LAT_MAX_BITS))
+	{
+		return AGENT_INSTR_LAT_BUCKETS - 1;
+	}
+
+	msb = 63 - __builtin_clzll(usec);
+	return ((msb - AGENT_INSTR_LAT_SUB_BITS + 1) << AGENT_INSTR_LAT_SUB_BITS)
+		   + (int)((usec >> (msb - AGENT_INSTR_LAT_SUB_BITS)) & ((1 << AGENT_INSTR_LAT_SUB_BITS) - 1));
+}
+
+/* The largest value held in a bucket. */
+static uint64_t agent_instr_lat_bound(int idx)
+{
+	int msb;
+	uint64_t sub;
+
+	if(idx >= AGENT_INSTR_LAT_BUCKETS - 1)
+	{
+		return ((uint64_t)1 << AGENT_INSTR_LAT_MAX_BITS) - 1;
+	}
+
+	/* One less than the smallest value of the next bucket. */
+	idx++;
+	if(idx < (1 << AGENT_INSTR_LAT_SUB_BITS))
+	{
+		return idx - 1;
+	}
+	msb = (idx >> AGENT_INSTR_LAT_SUB_BITS) + AGENT_INSTR_LAT_SUB_BITS - 1;
+	sub = (1 << AGENT_INSTR_LAT_SUB_BITS) | (idx & ((1 << AGENT_INSTR_LAT_SUB_BITS) - 1));
+	return (sub << (msb - AGENT_INSTR_LAT_SUB_BITS)) - 1;
+}
 
 
 void agent_instr_init()
 {
-	agent_instr_clear();
+	memset(gInstrShards, 0, sizeof(gInstrShards));
+	memset(gInstrEdds, 0, sizeof(gInstrEdds));
 }
 
+/* Clears everything counted since the last reset. Counts of known rules are kept. */
 void agent_instr_clear()
 {
-	memset(&gAgentInstr,0, sizeof(gAgentInstr));
+	for(int i = 0; i < AGENT_INSTR_SHARDS; i++)
+	{
+		agent_instr_shard_t *shard = &(gInstrShards[i]);
+
+		for(int ctr = 0; ctr < AGENT_INSTR_NUM_CTRS; ctr++)
+		{
+			if((ctr != AGENT_INSTR_TBRS) && (ctr != AGENT_INSTR_SBRS))
+			{
+				atomic_store_explicit(&(shard->ctrs[ctr]), 0, memory_order_relaxed);
+			}
+		}
+
+		for(int lat = 0; lat < AGENT_INSTR_NUM_LATS; lat++)
+		{
+			for(int j = 0; j < AGENT_INSTR_LAT_BUCKETS; j++)
+			{
+				atomic_store_explicit(&(shard->lat_counts[lat][j]), 0, memory_order_relaxed);
+			}
+			atomic_store_explicit(&(shard->lat_total[lat]), 0, memory_order_relaxed);
+			atomic_store_explicit(&(shard->lat_max[lat]), 0, memory_order_relaxed);
+		}
+	}
+
+	/* Slots stay claimed, as their EDDs are still known. */
+	for(int i = 0; i < AGENT_INSTR_EDD_SLOTS; i++)
+	{
+		atomic_store_explicit(&(gInstrEdds[i].count), 0, memory_order_relaxed);
+		atomic_store_explicit(&(gInstrEdds[i].total_us), 0, memory_order_relaxed);
+		atomic_store_explicit(&(gInstrEdds[i].max_us), 0, memory_order_relaxed);
+	}
+}
+
+void agent_instr_add(agent_instr_ctr_e ctr, int64_t num)
+{
+	/* A negative count wraps, and sums back correctly across shards. */
+	atomic_fetch_add_explicit(&(agent_instr_shard()->ctrs[ctr]), (uint64_t) num, memory_order_relaxed);
+}
+
+uint64_t agent_instr_get(agent_instr_ctr_e ctr)
+{
+	uint64_t total = 0;
+
+	for(int i = 0; i < AGENT_INSTR_SHARDS; i++)
+	{
+		total += atomic_load_explicit(&(gInstrShards[i].ctrs[ctr]), memory_order_relaxed);
+	}
+	return total;
+}
+
+void agent_instr_lat_record(agent_instr_lat_e lat, uint64_t usec)
+{
+	agent_instr_shard_t *shard = agent_instr_shard();
+
+	atomic_fetch_add_explicit(&(shard->lat_counts[lat][agent_instr_lat_bucket(usec)]), 1, memory_order_relaxed);
+	atomic_fetch_add_explicit(&(shard->lat_total[lat]), usec, memory_order_relaxed);
+	agent_instr_max(&(shard->lat_max[lat]), usec);
+}
+
+void agent_instr_lat_get(agent_instr_lat_e lat, agent_instr_lat_t *summary)
+{
+	uint64_t counts[AGENT_INSTR_LAT_BUCKETS] = {0};
+	uint64_t ranks[3];
+	uint64_t *pcts[3];
+	uint64_t seen = 0;
+	int next = 0;
+
+	CHKVOID(summary);
+	memset(summary, 0, sizeof(agent_instr_lat_t));
+
+	for(int i = 0; i < AGENT_INSTR_SHARDS; i++)
+	{
+		agent_instr_shard_t *shard = &(gInstrShards[i]);
+		uint64_t max = atomic_load_explicit(&(shard->lat_max[lat]), memory_order_relaxed);
+
+		for(int j = 0; j < AGENT_INSTR_LAT_BUCKETS; j++)
+		{
+			uint64_t num = atomic_load_explicit(&(shard->lat_counts[lat][j]), memory_order_relaxed);
+			counts[j] += num;
+			summary->count += num;
+		}
+		summary->total_us += atomic_load_explicit(&(shard->lat_total[lat]), memory_order_relaxed);
+		summary->max_us = (max > summary->max_us) ? max : summary->max_us;
+	}
+
+	if(summary->count == 0)
+	{
+		return;
+	}
+
+	/* Walk the buckets once for all percentiles. */
+	ranks[0] = (summary->count * 50 + 99) / 100;
+	ranks[1] = (summary->count * 90 + 99) / 100;
+	ranks[2] = (summary->count * 99 + 99) / 100;
+	pcts[0] = &(summary->p50_us);
+	pcts[1] = &(summary->p90_us);
+	pcts[2] = &(summary->p99_us);
+
+	for(int j = 0; (j < AGENT_INSTR_LAT_BUCKETS) && (next < 3); j++)
+	{
+		seen += counts[j];
+		while((next < 3) && (seen >= ranks[next]))
+		{
+			uint64_t bound = agent_instr_lat_bound(j);
+			*(pcts[next++]) = (bound < summary->max_us) ? bound : summary->max_us;
+		}
+	}
+}
+
+const char *agent_instr_lat_name(agent_instr_lat_e lat)
+{
+	return ((int) lat < AGENT_INSTR_NUM_LATS) ? gInstrLatNames[lat] : "unknown";
+}
+
+/*
+ * Records the collect time of an EDD, by the ARI of its definition. Once all
+ * slots are taken, other EDDs are only counted in the EDD collect histogram.
+ */
+void agent_instr_edd_record(ari_t *id, uint64_t usec)
+{
+	uintptr_t hash = ((uintptr_t) id) >> 4;
+
+	agent_instr_lat_record(AGENT_INSTR_LAT_EDD_COLLECT, usec);
+	CHKVOID(id);
+
+	for(int i = 0; i < AGENT_INSTR_EDD_SLOTS; i++)
+	{
+		agent_instr_edd_slot_t *slot = &(gInstrEdds[(hash + i) % AGENT_INSTR_EDD_SLOTS]);
+		ari_t *cur = atomic_load_explicit(&(slot->id), memory_order_acquire);
+
+		/* Claim a free slot, unless another thread just did. */
+		if((cur == NULL) &&
+		   atomic_compare_exchange_strong_explicit(&(slot->id), &cur, id, memory_order_acq_rel, memory_order_acquire))
+		{
+			cur = id;
+		}
+
+		if(cur == id)
+		{
+			atomic_fetch_add_explicit(&(slot->count), 1, memory_order_relaxed);
+			atomic_fetch_add_explicit(&(slot->total_us), usec, memory_order_relaxed);
+			agent_instr_max(&(slot->max_us), usec);
+			return;
+		}
+	}
 }
 
+/*
+ * Gets the collect times of the EDD in a slot.
+ *
+ * \returns AMP_OK if the slot holds an EDD, else AMP_FAIL.
+ */
+int agent_instr_edd_get(int idx, agent_instr_edd_t *edd)
+{
+	CHKUSR(edd, AMP_FAIL);
+
+	if((idx < 0) || (idx >= AGENT_INSTR_EDD_SLOTS))
+	{
+		return AMP_FAIL;
+	}
 
+	edd->id = atomic_load_explicit(&(gInstrEdds[idx].id), memory_order_acquire);
+	if(edd->id == NULL)
+	{
+		return AMP_FAIL;
+	}
+	edd->count = atomic_load_explicit(&(gInstrEdds[idx].count), memory_order_relaxed);
+	edd->total_us = atomic_load_explicit(&(gInstrEdds[idx].total_us), memory_order_relaxed);
+	edd->max_us = atomic_load_explicit(&(gInstrEdds[idx].max_us), memory_order_relaxed);
+	return AMP_OK;
+}
@@ -39,7 +39,10 @@
 #define _INSTR_H_
 
 
+#include <stdint.h>
 #include "../shared/utils/nm_types.h"
+#include "../shared/primitives/ari.h"
+#include "../shared/utils/utils.h"
 
 
 #ifdef __cplusplus
@@ -52,6 +55,22 @@ extern "C" {
  * +--------------------------------------------------------------------------+
  */
 
+/** Counters and histograms are split into this many shards. Each thread
+ * updates one shard, so updates from different threads rarely share a cache
+ * line. Readers sum all shards.
+ */
+#define AGENT_INSTR_SHARDS 16
+
+/** Latencies are in microseconds, held in buckets with 4 sub-buckets per
+ * power of two, so any recorded value is within 25% of its bucket bound.
+ * Values above 2^36 us (about 19 hours) are held in the last bucket.
+ */
+#define AGENT_INSTR_LAT_SUB_BITS 2
+#define AGENT_INSTR_LAT_MAX_BITS 36
+#define AGENT_INSTR_LAT_BUCKETS  (((AGENT_INSTR_LAT_MAX_BITS - 1) << AGENT_INSTR_LAT_SUB_BITS))
+
+/** Number of EDDs whose collect time is tracked one by one. */
+#define AGENT_INSTR_EDD_SLOTS 256
 
 
 /*
@@ -60,6 +79,10 @@ extern "C" {
  * +--------------------------------------------------------------------------+
  */
 
+/** Record the time since a start time from utils_now_us(). */
+#define AGENT_INSTR_LAT_SINCE(lat, start) \
+	agent_instr_lat_record((lat), utils_now_us() - (start))
+
 
 /*
  * +--------------------------------------------------------------------------+
@@ -67,17 +90,51 @@ extern "C" {
  * +--------------------------------------------------------------------------+
  */
 
-
+typedef enum {
+	AGENT_INSTR_SENT_RPTS,
+	AGENT_INSTR_SENT_TBLS,
+	AGENT_INSTR_TBRS,
+	AGENT_INSTR_TBRS_RUN,
+	AGENT_INSTR_SBRS,
+	AGENT_INSTR_SBRS_RUN,
+	AGENT_INSTR_MACROS_RUN,
+	AGENT_INSTR_CTRLS_RUN,
+	AGENT_INSTR_NUM_CTRS
+} agent_instr_ctr_e;
+
+typedef enum {
+	/** Time from when a rule was due to when it ran */
+	AGENT_INSTR_LAT_RULE_LAG,
+	/** Time to collect one EDD value */
+	AGENT_INSTR_LAT_EDD_COLLECT,
+	/** Time to run one control */
+	AGENT_INSTR_LAT_CTRL_RUN,
+	/** Time from when a report message was built to when it was sent */
+	AGENT_INSTR_LAT_RPT_QUEUE,
+	/** Time to encode and send, or hold, one report message */
+	AGENT_INSTR_LAT_RPT_SEND,
+	AGENT_INSTR_NUM_LATS
+} agent_instr_lat_e;
+
+/** Summary of one latency histogram, in microseconds. Percentiles are the
+ * upper bound of the bucket holding them.
+ */
+typedef struct {
+	uint64_t count;
+	uint64_t total_us;
+	uint64_t max_us;
+	uint64_t p50_us;
+	uint64_t p90_us;
+	uint64_t p99_us;
+} agent_instr_lat_t;
+
+/** Collect times of one EDD. */
 typedef struct {
-	unsigned long num_sent_rpts;
-	unsigned long num_sent_tbls;
-	unsigned long num_tbrs;
-	unsigned long num_tbrs_run;
-	unsigned long num_sbrs;
-	unsigned long num_sbrs_run;
-	unsigned long num_macros_run;
-	unsigned long num_ctrls_run;
-} agent_instr_t;
+	ari_t *id;
+	uint64_t count;
+	uint64_t total_us;
+	uint64_t max_us;
+} agent_instr_edd_t;
 
 
 
@@ -91,7 +148,17 @@ typedef struct {
 void agent_instr_init();
 void agent_instr_clear();
 
-extern agent_instr_t gAgentInstr;
+void     agent_instr_add(agent_instr_ctr_e ctr, int64_t num);
+#define  agent_instr_inc(ctr) agent_instr_add((ctr), 1)
+#define  agent_instr_dec(ctr) agent_instr_add((ctr), -1)
+uint64_t agent_instr_get(agent_instr_ctr_e ctr);
+
+void     agent_instr_lat_record(agent_instr_lat_e lat, uint64_t usec);
+void     agent_instr_lat_get(agent_instr_lat_e lat, agent_instr_lat_t *summary);
+const char *agent_instr_lat_name(agent_instr_lat_e lat);
+
+void     agent_instr_edd_record(ari_t *id, uint64_t usec);
+int      agent_instr_edd_get(int idx, agent_instr_edd_t *edd);
 
 
 #ifdef __cplusplus
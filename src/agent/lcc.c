@@ -39,6 +39,7 @@
 
 #include "../shared/primitives/rules.h"
 #include "instr.h"
+#include "../shared/utils/trace.h"
 #include "../shared/primitives/ctrl.h"
 #include "../shared/primitives/report.h"
 
@@ -46,6 +47,25 @@
 #include "rda.h"
 
 
+/* Class of the output of the rule or control running on this thread. */
+static __thread uint8_t gLccClass = AMP_PRIO_NORMAL;
+
+uint8_t lcc_get_class()
+{
+	return gLccClass;
+}
+
+uint8_t lcc_set_class(uint8_t prio)
+{
+	uint8_t prev = gLccClass;
+
+	if(prio < AMP_NUM_PRIO)
+	{
+		gLccClass = prio;
+	}
+	return prev;
+}
+
 
 int lcc_run_ac(ac_t *ac, tnvc_t *parent_parms)
 {
@@ -56,12 +76,12 @@ int lcc_run_ac(ac_t *ac, tnvc_t *parent_parms)
 	for(it = vecit_first(&(ac->values)); vecit_valid(it); it = vecit_next(it))
 	{
 		ari_t *id = (ari_t *) vecit_data(it);
-		ctrl_t *ctrl = ctrl_create(id);
+		ctrl_t ctrl;
 
-		if(ctrl != NULL)
+		/* The control only lives for this run, so it can borrow parms. */
+		if(ctrl_bind(&ctrl, id) == AMP_OK)
 		{
-			success = lcc_run_ctrl(ctrl, parent_parms);
-			ctrl_release(ctrl, 1);
+			success = lcc_run_ctrl(&ctrl, parent_parms);
 
 			if(success != AMP_OK)
 			{
@@ -104,7 +124,9 @@ int lcc_run_ctrl(ctrl_t *ctrl, tnvc_t *parent_parms)
 	int8_t status = CTRL_FAILURE;
     tnv_t* retval = NULL;
     tnvc_t *new_parms = NULL;
+    tnvc_t view;
     eid_t rx_eid;
+    uint8_t prev_class;
 
 	AMP_DEBUG_ENTRY("lcc_run_ctrl","(%"PRIxPTR")", ctrl);
 
@@ -123,19 +145,31 @@ int lcc_run_ctrl(ctrl_t *ctrl, tnvc_t *parent_parms)
 	}
 
 
+	prev_class = lcc_get_class();
+
+	NM_TRACE3(ctrl__start, ctrl->def.as_ctrl, ctrl->type, rx_eid.name);
+
+	/* Only mapped parms need resolving, and then only the mapped ones. */
+	new_parms = ctrl->mapped ? ari_resolve_parms_view(ctrl->parms, parent_parms, &view) : ctrl->parms;
+
 	if(ctrl->type == AMP_TYPE_CTRL)
 	{
-
-		new_parms = ari_resolve_parms(ctrl->parms, parent_parms);
+		/* A control with its own class overrides the class of its caller. */
+		const uint8_t ctrl_class = ctrldef_get_class(ctrl->def.as_ctrl);
+		if(ctrl_class != AMP_PRIO_INHERIT)
+		{
+			lcc_set_class(ctrl_class);
+		}
 
 		/* Run the control. */
+		uint64_t start_us = utils_now_us();
 		retval = ctrl->def.as_ctrl->run(&rx_eid, new_parms, &status);
-		gAgentInstr.num_ctrls_run++;
+		AGENT_INSTR_LAT_SINCE(AGENT_INSTR_LAT_CTRL_RUN, start_us);
+		agent_instr_inc(AGENT_INSTR_CTRLS_RUN);
 	}
 	else
 	{
-		new_parms = ari_resolve_parms(ctrl->parms, parent_parms);
-		status = lcc_run_macro(ctrl->def.as_mac, new_parms);
+		status = lcc_run_macro(ctrl->def.as_mac, new_parms, &rx_eid);
 	}
 
 	if(status != CTRL_SUCCESS)
@@ -148,40 +182,266 @@ int lcc_run_ctrl(ctrl_t *ctrl, tnvc_t *parent_parms)
 		lcc_send_retval(&rx_eid, retval, ctrl, new_parms);
 	}
 
-	tnvc_release(new_parms, 1);
+	ari_release_parms_view(new_parms, &view);
+	lcc_set_class(prev_class);
 
+	NM_TRACE3(ctrl__end, ctrl->def.as_ctrl, ctrl->type, status);
 	AMP_DEBUG_EXIT("lcc_run_ctrl","-> %d", status);
 	return status;
 }
 
 
-int lcc_run_macro(macdef_t *mac, tnvc_t *parent_parms)
+/* A return value held until its macro finishes running. */
+typedef struct
+{
+	rpt_t *rpt;
+	uint8_t prio;
+} lcc_retval_t;
+
+
+/*
+ * Runs one step of a compiled macro, building its parms from the slot map.
+ * A report of any return value is added to the batch.
+ */
+static int p_lcc_run_step(macstep_t *step, tnvc_t *parent_parms, eid_t *rx,
+		                  lcc_retval_t *batch, uint16_t *num_batched)
+{
+	int8_t status = CTRL_FAILURE;
+	tnv_t *retval = NULL;
+	tnvc_t *parms = step->ctrl->parms;
+	tnvc_t view;
+	uint8_t prev_class = lcc_get_class();
+	uint8_t i;
+
+	/* As in ari_resolve_parms_view(), with no parent parms they are used as written. */
+	if((step->num_slots > 0) && (!step->uses_parent || (tnvc_size(parent_parms) > 0)))
+	{
+		if(tnvc_init(&view, step->num_slots) != AMP_OK)
+		{
+			return AMP_FAIL;
+		}
+		for(i = 0; i < step->num_slots; i++)
+		{
+			macslot_t *slot = &(step->slots[i]);
+			tnv_t *val = slot->mapped ? tnvc_get(parent_parms, slot->idx) : slot->val;
+			tnv_t borrowed;
+
+			if(val == NULL)
+			{
+				AMP_DEBUG_ERR("lcc_run_macro", "Can't apply parm map: %d -> %d", i, slot->idx);
+				tnvc_release(&view, 0);
+				return AMP_FAIL;
+			}
+
+			borrowed = *val;
+			TNV_CLEAR_ALLOC(borrowed.flags);
+			if(tnvc_insert_val(&view, borrowed) != AMP_OK)
+			{
+				tnvc_release(&view, 0);
+				return AMP_FAIL;
+			}
+		}
+		parms = &view;
+	}
+
+	const uint8_t step_class = ctrldef_get_class(step->def);
+	if(step_class != AMP_PRIO_INHERIT)
+	{
+		lcc_set_class(step_class);
+	}
+
+	uint64_t start_us = utils_now_us();
+	retval = step->def->run(rx, parms, &status);
+	AGENT_INSTR_LAT_SINCE(AGENT_INSTR_LAT_CTRL_RUN, start_us);
+	agent_instr_inc(AGENT_INSTR_CTRLS_RUN);
+
+	if(status != CTRL_SUCCESS)
+	{
+		AMP_DEBUG_WARN("lcc_run_macro","Error running control.", NULL);
+		tnv_release(retval, 1);
+	}
+	else if(retval != NULL)
+	{
+		rpt_t *rpt = lcc_retval_rpt(retval, step->ctrl, parms);
+
+		if(rpt != NULL)
+		{
+			batch[*num_batched].rpt = rpt;
+			batch[*num_batched].prio = lcc_get_class();
+			(*num_batched)++;
+		}
+	}
+
+	if(parms == &view)
+	{
+		tnvc_release(&view, 0);
+	}
+	lcc_set_class(prev_class);
+
+	return status;
+}
+
+/*
+ * Adds the held reports to outgoing messages all at once, so that those of
+ * each class go out in a single message.
+ */
+static void p_lcc_send_batch(eid_t *rx, lcc_retval_t *batch, uint16_t num)
+{
+	uint8_t prev_class = lcc_get_class();
+	uint8_t prio;
+	uint16_t i;
+
+	vec_lock(&(gAgentDbInst->rpt_msgs));
+	for(prio = 0; prio < AMP_NUM_PRIO; prio++)
+	{
+		msg_rpt_t *msg_rpt = NULL;
+
+		for(i = 0; i < num; i++)
+		{
+			if(batch[i].prio != prio)
+			{
+				continue;
+			}
+			if(msg_rpt == NULL)
+			{
+				lcc_set_class(prio);
+				msg_rpt = rda_get_msg_rpt(*rx);
+			}
+			if((msg_rpt == NULL) || (msg_rpt_add_rpt(msg_rpt, batch[i].rpt) != AMP_OK))
+			{
+				AMP_DEBUG_ERR("lcc_run_macro", "Can't add report to msg_rpt.", NULL);
+				rpt_release(batch[i].rpt, 1);
+			}
+		}
+	}
+	vec_unlock(&(gAgentDbInst->rpt_msgs));
+	lcc_set_class(prev_class);
+}
+
+
+/******************************************************************************
+ *
+ * \par Function Name: lcc_run_macro
+ *
+ * \par Runs each control of a macro in turn.
+ *
+ * \return AMP Status Code
+ *
+ * \param[in]  mac          The macro.
+ * \param[in]  parent_parms The parameters the macro was run with.
+ * \param[in]  rx           The manager to receive return values.
+ *
+ * \par Notes:
+ *   - A compiled macro runs its flattened steps directly and holds their
+ *     return values until the end, so that they go out together. An
+ *     uncompiled one runs each control through lcc_run_ctrl().
+ *   - A failed control does not stop those after it.
+ *****************************************************************************/
+
+int lcc_run_macro(macdef_t *mac, tnvc_t *parent_parms, eid_t *rx)
 {
 	vecit_t it;
 	int result = AMP_OK;
+	lcc_retval_t *batch = NULL;
+	uint16_t num_batched = 0;
+	uint16_t i;
 
 	if(mac == NULL)
 	{
 		return AMP_FAIL;
 	}
 
-	gAgentInstr.num_macros_run++;
+	if(mac->steps == NULL)
+	{
+		agent_instr_inc(AGENT_INSTR_MACROS_RUN);
+
+		for(it = vecit_first(&(mac->ctrls)); vecit_valid(it); it = vecit_next(it))
+		{
+			ctrl_t *ctrl = (ctrl_t*) vecit_data(it);
+
+			if(lcc_run_ctrl(ctrl, parent_parms) != AMP_OK)
+			{
+				AMP_DEBUG_ERR("lcc_run_macro","Error running control %d", vecit_idx(it));
+				result = AMP_FAIL;
+			}
+		}
 
-	for(it = vecit_first(&(mac->ctrls)); vecit_valid(it); it = vecit_next(it))
+		return result;
+	}
+
+	agent_instr_add(AGENT_INSTR_MACROS_RUN, mac->num_macs);
+
+	if((mac->num_steps > 0) &&
+	   ((batch = STAKE(mac->num_steps * sizeof(lcc_retval_t))) == NULL))
 	{
-		ctrl_t *ctrl = (ctrl_t*) vecit_data(it);
+		return AMP_FAIL;
+	}
 
-		if(lcc_run_ctrl(ctrl, parent_parms) != AMP_OK)
+	for(i = 0; i < mac->num_steps; i++)
+	{
+		if(p_lcc_run_step(&(mac->steps[i]), parent_parms, rx, batch, &num_batched) != AMP_OK)
 		{
-			AMP_DEBUG_ERR("lcc_run_macro","Error running control %d", vecit_idx(it));
+			AMP_DEBUG_ERR("lcc_run_macro","Error running control %d", i);
 			result = AMP_FAIL;
 		}
 	}
 
+	if(num_batched > 0)
+	{
+		p_lcc_send_batch(rx, batch, num_batched);
+	}
+	SRELEASE(batch);
+
 	return result;
 }
 
 
+/*
+ * Builds the report of the return value of a control, whose template is the
+ * control itself. The return value is consumed.
+ */
+rpt_t *lcc_retval_rpt(tnv_t *retval, ctrl_t *ctrl, tnvc_t *parms)
+{
+	rpt_t *report = NULL;
+	ari_t *ari = NULL;
+	OS_time_t timestamp;
+
+	if((retval == NULL) || (ctrl == NULL))
+	{
+		tnv_release(retval, 1);
+		return NULL;
+	}
+
+	/*
+	 * Create a report whose template is the control.
+	 * If the ari copy or parm replace fail, this will be caught
+	 * by failing to create the report.
+	 *
+	 * The new parms are deep copied which is why it is OK to call
+	 * ari_release at the end.
+	 */
+	ari = ari_copy_ptr(ctrl_get_id(ctrl));
+	ari_replace_parms(ari, parms);
+
+	OS_GetLocalTime(&timestamp);
+	if((report = rpt_create(ari, timestamp, NULL)) == NULL)
+	{
+		tnv_release(retval, 1);
+		return NULL;
+	}
+
+	/* Add the single entry to this report. */
+	if(rpt_add_entry(report, retval) != AMP_OK)
+	{
+		AMP_DEBUG_ERR("lcc_retval_rpt", "Can't add retval to report.", NULL);
+		rpt_release(report, 1);
+		return NULL;
+	}
+
+	return report;
+}
+
+
 /******************************************************************************
  *
  * \par Function Name: lcc_send_retval
@@ -210,7 +470,6 @@ void lcc_send_retval(eid_t *rx, tnv_t *retval, ctrl_t *ctrl, tnvc_t *parms)
 {
 	msg_rpt_t *msg_rpt = NULL;
 	rpt_t *report = NULL;
-	ari_t *ari = NULL;
 
 	if((rx == NULL) || (retval == NULL) || (ctrl == NULL))
 	{
@@ -221,40 +480,12 @@ void lcc_send_retval(eid_t *rx, tnv_t *retval, ctrl_t *ctrl, tnvc_t *parms)
 	msg_rpt = rda_get_msg_rpt(*rx);
 	CHKVOID(msg_rpt);
 
-	/*
-	 * Create a report whose template is the control.
-	 * If the ari copy or parm replace fail, this will be caught
-	 * by failing to create the report.
-	 *
-	 * The new parms are deep copied which is why it is OK to call
-	 * ari_release at the end.
-	 */
-	ari_t *ctrl_ari = ctrl_get_id(ctrl);
-	ari = ari_copy_ptr(ctrl_ari);
-	ari_replace_parms(ari, parms);
-
-	OS_time_t timestamp;
-	OS_GetLocalTime(&timestamp);
-	report = rpt_create(ari, timestamp, NULL);
+	report = lcc_retval_rpt(retval, ctrl, parms);
 	CHKVOID(report);
 
-	/* Add the single entry to this report. */
-	if(rpt_add_entry(report, retval) != AMP_OK)
-	{
-		rpt_release(report, 1);
-		AMP_DEBUG_ERR("lcc_send_retval", "Can't add retval to report.", NULL);
-	}
-	else if(msg_rpt_add_rpt(msg_rpt, report) != AMP_OK)
+	if(msg_rpt_add_rpt(msg_rpt, report) != AMP_OK)
 	{
 		AMP_DEBUG_ERR("lcc_send_retval", "Can't add report to msg_rpt.", NULL);
 		rpt_release(report, 1);
 	}
-
 }
-
-
-
-
-
-
-
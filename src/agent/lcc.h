@@ -49,14 +49,22 @@ extern "C" {
 
 // Todo: Talk about why we separate out parameters.
 
+/*
+ * The class (amp_prio_e) of reports and tables produced by the calling
+ * thread. Setting an invalid class leaves it unchanged. The previous class
+ * is returned so that it can be restored.
+ */
+uint8_t lcc_get_class();
+uint8_t lcc_set_class(uint8_t prio);
+
 int lcc_run_ac(ac_t *ac, tnvc_t *parent_parms);
 
 int lcc_run_ctrl(ctrl_t *ctrl, tnvc_t *parent_parms);
 
-int lcc_run_macro(macdef_t *mac, tnvc_t *parent_parms);
-
+int lcc_run_macro(macdef_t *mac, tnvc_t *parent_parms, eid_t *rx);
 
 
+rpt_t *lcc_retval_rpt(tnv_t *retval, ctrl_t *ctrl, tnvc_t *parms);
 void lcc_send_retval(eid_t *rx, tnv_t *retval, ctrl_t *ctrl, tnvc_t *parms);
 
 
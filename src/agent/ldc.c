@@ -37,12 +37,59 @@
  *****************************************************************************/
 
 #include <inttypes.h>
+#include <stdatomic.h>
 #include "../shared/adm/adm.h"
 #include "../shared/primitives/report.h"
 #include "../shared/primitives/expr.h"
 
 #include "nmagent.h"
 #include "ldc.h"
+#include "instr.h"
+#include "../shared/utils/trace.h"
+
+
+/* Source of collection cycle numbers. Zero means no cycle. */
+static atomic_uint gLdcLastCycle;
+/* Cycle of the calling thread and its nesting. */
+static __thread uint32_t gLdcCycle;
+static __thread uint32_t gLdcCycleDepth;
+/* Staleness bound of all snapshots. */
+static atomic_uint gLdcSnapMaxAge;
+
+/* Most snapshots one thread keeps copies of within a cycle. */
+#define LDC_MAX_CYCLE_SNAPS (8)
+
+/* Copy of a snapshot as first read in the current cycle. */
+typedef struct
+{
+	ldc_snap_t *snap;
+	void *data;
+} ldc_cycle_snap_t;
+
+static __thread ldc_cycle_snap_t gLdcCycleSnaps[LDC_MAX_CYCLE_SNAPS];
+static __thread uint32_t gLdcNumCycleSnaps;
+
+
+static ldc_cycle_snap_t *ldc_cycle_snap_find(ldc_snap_t *snap)
+{
+	uint32_t i;
+
+	for(i = 0; i < gLdcNumCycleSnaps; i++)
+	{
+		if(gLdcCycleSnaps[i].snap == snap)
+		{
+			return &(gLdcCycleSnaps[i]);
+		}
+	}
+	return NULL;
+}
+
+static void ldc_cycle_snap_drop(ldc_cycle_snap_t *entry)
+{
+	SRELEASE(entry->data);
+	*entry = gLdcCycleSnaps[--gLdcNumCycleSnaps];
+	memset(&(gLdcCycleSnaps[gLdcNumCycleSnaps]), 0, sizeof(ldc_cycle_snap_t));
+}
 
 
 tnv_t* ldc_collect(ari_t *id, tnvc_t *parms)
@@ -95,12 +142,22 @@ tnv_t *ldc_collect_cnst(ari_t *id, tnvc_t *parms)
 tnv_t *ldc_collect_edd(ari_t *id, tnvc_t *parms)
 {
 	edd_t *edd = NULL;
+	tnv_t *result;
+	uint64_t start_us;
+	uint64_t elapsed_us;
 
 	CHKNULL(id);
 	edd = VDB_FINDKEY_EDD(id);
 	CHKNULL(edd);
 
-	return edd->def.collect(parms);
+	NM_TRACE1(edd__begin, edd);
+	start_us = utils_now_us();
+	result = edd->def.collect(parms);
+	elapsed_us = utils_now_us() - start_us;
+	agent_instr_edd_record(edd->def.id, elapsed_us);
+	NM_TRACE3(edd__end, edd, elapsed_us, (result != NULL));
+
+	return result;
 }
 
 tnv_t *ldc_collect_lit(ari_t *id)
@@ -224,13 +281,14 @@ int ldc_fill_rpt(rpttpl_t *rpttpl, rpt_t *rpt)
 	}
 
 	nesting++;
+	ldc_cycle_begin();
 
 	success = AMP_OK;
 	/* Step 2: For every item in the template, fill in the entry. */
 	for(i = 0; i < ac_get_count(&(rpttpl->contents)); i++)
 	{
-		uint8_t clear_parms = 1;
 		tnvc_t *parms = NULL;
+		tnvc_t view;
 		tnv_t *cur_val = NULL;
 
 		/* Grab the current template ID. */
@@ -240,26 +298,23 @@ int ldc_fill_rpt(rpttpl_t *rpttpl, rpt_t *rpt)
 		if(cur_id->type != AMP_TYPE_LIT)
 		{
 			/* Step 1: If a rpttpl is parameterized, then the acutal report
-			 * structure will contain the parameters.
+			 * structure will contain the parameters. Items are only resolved
+			 * if the template maps any parameters at all.
 			 */
-			parms = ari_resolve_parms(&(cur_id->as_reg.parms), &(rpt->id->as_reg.parms));
-			if(parms == NULL)
+			parms = &(cur_id->as_reg.parms);
+			if(rpttpl->mapped)
 			{
-				parms = &(cur_id->as_reg.parms);
-				clear_parms = 0;
+				parms = ari_resolve_parms_view(parms, &(rpt->id->as_reg.parms), &view);
+				if(parms == NULL)
+				{
+					parms = &(cur_id->as_reg.parms);
+				}
 			}
 		}
-		else
-		{
-			clear_parms = 0;
-		}
 
 
 		cur_val = ldc_collect(cur_id, parms);
-		if(clear_parms)
-		{
-			tnvc_release(parms, 1);
-		}
+		ari_release_parms_view(parms, &view);
 
 		if(rpt_add_entry(rpt, cur_val) != AMP_OK)
 		{
@@ -277,8 +332,182 @@ int ldc_fill_rpt(rpttpl_t *rpttpl, rpt_t *rpt)
     	tnvc_clear(rpt->entries);
     }
 
+	ldc_cycle_end();
 	nesting--;
 
 	return success;
 }
 
+
+
+/******************************************************************************
+ *
+ * \par Function Name: ldc_cycle_begin
+ *
+ * \par Purpose: Starts a collection cycle on the calling thread, within which
+ *               each snapshot is fetched at most once.
+ *
+ * \par Notes:
+ *  - Cycles nest, and only the outermost one counts. Each call MUST be paired
+ *    with a call to ldc_cycle_end().
+ *  - Report generation is always a cycle. Callers building several reports
+ *    or tables from the same state should wrap them in one.
+ *****************************************************************************/
+
+void ldc_cycle_begin()
+{
+	if(gLdcCycleDepth++ == 0)
+	{
+		/* Skip zero on wrap, as it means no cycle. */
+		while((gLdcCycle = atomic_fetch_add(&gLdcLastCycle, 1) + 1) == 0);
+	}
+}
+
+void ldc_cycle_end()
+{
+	if((gLdcCycleDepth > 0) && (--gLdcCycleDepth == 0))
+	{
+		while(gLdcNumCycleSnaps > 0)
+		{
+			ldc_cycle_snap_drop(&(gLdcCycleSnaps[0]));
+		}
+		gLdcCycle = 0;
+	}
+}
+
+
+
+/******************************************************************************
+ *
+ * \par Function Name: ldc_set_snap_max_age
+ *
+ * \par Purpose: Sets how long a snapshot may be reused outside of the cycle
+ *               it was fetched in.
+ *
+ * \param[in] max_age_ms  The staleness bound. Zero, the default, limits
+ *                        reuse to a single cycle.
+ *****************************************************************************/
+
+void ldc_set_snap_max_age(uint32_t max_age_ms)
+{
+	atomic_store(&gLdcSnapMaxAge, max_age_ms);
+}
+
+
+
+/******************************************************************************
+ *
+ * \par Function Name: ldc_snap_read
+ *
+ * \par Purpose: Reads a snapshot, fetching it first if it is not current.
+ *
+ * \return AMP Status Code
+ *
+ * \param[in]  snap  The snapshot
+ * \param[out] out   Copy of the snapshot, of snap->size bytes.
+ *
+ * \par Notes:
+ *  - The snapshot is copied out so that it may be read while another thread
+ *    fetches it again.
+ *  - Within a cycle, the first read also keeps a copy for the calling thread
+ *    and later reads return it. A cycle on another thread which fetches the
+ *    snapshot again meanwhile does not change what this cycle reads.
+ *****************************************************************************/
+
+int ldc_snap_read(ldc_snap_t *snap, void *out)
+{
+	uint32_t max_age_ms = atomic_load(&gLdcSnapMaxAge);
+	ldc_cycle_snap_t *entry;
+	OS_time_t now;
+	int success = AMP_OK;
+
+	CHKUSR(snap, AMP_FAIL);
+	CHKUSR(out, AMP_FAIL);
+
+	if((gLdcCycle != 0) && ((entry = ldc_cycle_snap_find(snap)) != NULL))
+	{
+		memcpy(out, entry->data, snap->size);
+		return AMP_OK;
+	}
+
+	OS_GetLocalTime(&now);
+
+	pthread_mutex_lock(&(snap->lock));
+
+	if(snap->valid && (max_age_ms > 0) &&
+	   (OS_TimeGetTotalMilliseconds(OS_TimeSubtract(now, snap->fetched)) <= max_age_ms))
+	{
+		/* Fresh enough to share. */
+	}
+	else
+	{
+		snap->valid = 0;
+		if((success = snap->fetch(snap->data)) == AMP_OK)
+		{
+			snap->valid = 1;
+			snap->fetched = now;
+		}
+	}
+
+	if(success == AMP_OK)
+	{
+		memcpy(out, snap->data, snap->size);
+	}
+
+	pthread_mutex_unlock(&(snap->lock));
+
+	/*
+	 * Keep this cycle's copy. Without room, later reads in the cycle fall
+	 * back to the shared snapshot.
+	 */
+	if((success == AMP_OK) && (gLdcCycle != 0) &&
+	   (gLdcNumCycleSnaps < LDC_MAX_CYCLE_SNAPS))
+	{
+		void *data = STAKE(snap->size);
+		if(data != NULL)
+		{
+			memcpy(data, out, snap->size);
+			entry = &(gLdcCycleSnaps[gLdcNumCycleSnaps++]);
+			entry->snap = snap;
+			entry->data = data;
+		}
+		else
+		{
+			AMP_DEBUG_WARN("ldc_snap_read", "Can't keep snapshot for cycle %u.", gLdcCycle);
+		}
+	}
+
+	return success;
+}
+
+
+
+/******************************************************************************
+ *
+ * \par Function Name: ldc_snap_invalidate
+ *
+ * \par Purpose: Forces the next read of a snapshot to fetch it, such as after
+ *               a control changes the state it holds.
+ *
+ * \param[in]  snap  The snapshot
+ *
+ * \par Notes:
+ *  - The copy kept by a cycle on the calling thread is dropped too. Cycles
+ *    on other threads keep theirs until they end.
+ *****************************************************************************/
+
+void ldc_snap_invalidate(ldc_snap_t *snap)
+{
+	ldc_cycle_snap_t *entry;
+
+	CHKVOID(snap);
+
+	if((entry = ldc_cycle_snap_find(snap)) != NULL)
+	{
+		ldc_cycle_snap_drop(entry);
+	}
+
+	pthread_mutex_lock(&(snap->lock));
+	snap->valid = 0;
+	pthread_mutex_unlock(&(snap->lock));
+}
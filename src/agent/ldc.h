@@ -38,6 +38,7 @@
 #ifndef _LDC_H_
 #define _LDC_H_
 
+#include <pthread.h>
 #include "../shared/adm/adm.h"
 
 #include "../shared/primitives/report.h"
@@ -49,6 +50,35 @@ extern "C" {
 #define LDC_MAX_NESTING (5)
 
 
+/*
+ * A snapshot of external state which several collect functions read, such
+ * as one set of ION counters. Within one collection cycle (see
+ * ldc_cycle_begin()) the state is fetched once and the calling thread keeps
+ * its own copy, so values in one report are consistent and cost a single
+ * fetch, even while cycles on other threads fetch the state again. Outside
+ * of a cycle, and in later cycles, the shared snapshot is reused only while
+ * it is younger than the staleness bound set by ldc_set_snap_max_age().
+ *
+ * Snapshots are declared statically with LDC_SNAP_INIT and read from any
+ * collect function with ldc_snap_read().
+ */
+typedef int (*ldc_fetch_fn)(void *data);
+
+typedef struct
+{
+	ldc_fetch_fn fetch;   /* Fills data with the current state. */
+	void *data;           /* The snapshot. */
+	size_t size;          /* Size of the snapshot. */
+
+	pthread_mutex_t lock;
+	OS_time_t fetched;    /* Time at which data was fetched. */
+	uint8_t valid;
+} ldc_snap_t;
+
+#define LDC_SNAP_INIT(fetch, data) \
+	{ (fetch), (data), sizeof(*(data)), PTHREAD_MUTEX_INITIALIZER, {0}, 0 }
+
+
 tnv_t* ldc_collect(ari_t *id, tnvc_t *parms);
 
 tnv_t *ldc_collect_cnst(ari_t *id, tnvc_t *parms);
@@ -59,6 +89,13 @@ tnv_t *ldc_collect_var(ari_t *id, tnvc_t *parms);
 
 int    ldc_fill_rpt(rpttpl_t *rpttpl, rpt_t *rpt);
 
+void   ldc_cycle_begin();
+void   ldc_cycle_end();
+
+void   ldc_set_snap_max_age(uint32_t max_age_ms);
+int    ldc_snap_read(ldc_snap_t *snap, void *out);
+void   ldc_snap_invalidate(ldc_snap_t *snap);
+
 
 #ifdef __cplusplus
 }
@@ -43,6 +43,7 @@
 #include "../shared/nm.h"
 #include "../shared/adm/adm.h"
 #include "../shared/utils/db.h"
+#include "../shared/primitives/time.h"
 
 #include "nmagent.h"
 #include "ingest.h"
@@ -54,6 +55,8 @@ bool nmagent_init(nmagent_t *agent)
 {
   memset(agent, 0, sizeof(nmagent_t));
   daemon_run_init(&agent->running);
+  agent->vdb = &(gVDB.inst);
+  agent->db = &gAgentDb;
 
   if ((utils_mem_int() != AMP_OK)
       || (db_init("nmagent_db", &adm_common_init) != AMP_OK))
@@ -66,8 +69,80 @@ bool nmagent_init(nmagent_t *agent)
   return true;
 }
 
+bool nmagent_init_instance(nmagent_t *agent)
+{
+  memset(agent, 0, sizeof(nmagent_t));
+  daemon_run_init(&agent->running);
+
+  agent->vdb = STAKE(sizeof(vdb_inst_t));
+  agent->db = STAKE(sizeof(agent_db_t));
+  if ((agent->vdb == NULL) || (agent->db == NULL)
+      || (vdb_inst_init(agent->vdb) != AMP_OK))
+  {
+    AMP_DEBUG_ERR("nmagent_init_instance", "Unable to initialize agent tables.", NULL);
+    SRELEASE(agent->vdb);
+    SRELEASE(agent->db);
+    daemon_run_cleanup(&agent->running);
+    return false;
+  }
+
+  return true;
+}
+
+void nmagent_select(nmagent_t *agent)
+{
+  vdb_inst_select((agent != NULL) ? agent->vdb : NULL);
+  rda_select((agent != NULL) ? agent->db : NULL);
+}
+
+static void nmagent_count_rule_cb(rh_elt_t *elt, void *tag)
+{
+  rule_t *rule = (elt != NULL) ? elt->value : NULL;
+
+  (void) tag;
+
+  if (rule == NULL)
+  {
+    return;
+  }
+  if (rule->id.type == AMP_TYPE_SBR)
+  {
+    agent_instr_inc(AGENT_INSTR_SBRS);
+  }
+  else
+  {
+    agent_instr_inc(AGENT_INSTR_TBRS);
+  }
+}
+
+bool nmagent_restore(nmagent_t *agent, char *db_path)
+{
+  if (agent->vdb != &(gVDB.inst))
+  {
+    AMP_DEBUG_ERR("nmagent_restore", "Only the process's own agent is persisted.", NULL);
+    return false;
+  }
+  if (db_read_objs(db_path) != AMP_OK)
+  {
+    AMP_DEBUG_ERR("nmagent_restore", "Unable to open persistent DB %s.", db_path);
+    return false;
+  }
+
+  // Restored rules count as active
+  rhht_foreach(&(gVDBInst->rules), nmagent_count_rule_cb, NULL);
+  return true;
+}
+
 bool nmagent_destroy(nmagent_t *agent)
 {
+  if ((agent->vdb != NULL) && (agent->vdb != &(gVDB.inst)))
+  {
+    vdb_inst_destroy(agent->vdb);
+    SRELEASE(agent->vdb);
+    SRELEASE(agent->db);
+  }
+  agent->vdb = NULL;
+  agent->db = NULL;
   daemon_run_cleanup(&agent->running);
   return true;
 }
@@ -92,16 +167,26 @@ bool nmagent_destroy(nmagent_t *agent)
 bool nmagent_start(nmagent_t *agent)
 {
     int rc;
+    bool pooled = (agent->worker != NULL);
     AMP_DEBUG_ENTRY("nmagent_start","(%p)", agent);
 
+    nmagent_select(agent);
     rda_init();
+    if (outq_open(&(gAgentDbInst->outq), &agent->outq) != AMP_OK)
+    {
+      AMP_DEBUG_ERR("nmagent_start", "Unable to open outbound queue.", NULL);
+      nmagent_select(NULL);
+      db_destroy();
+      return false;
+    }
+    nmagent_select(NULL);
 
-    /* Step 5: Start agent threads. */
+    /* Step 5: Start agent threads. A pool does the work of all but rx. */
     threadinfo_t threadinfo[] = {
         {&rx_thread, "rx_thread"},
-        {&rda_ctrls, "rda_ctrls"},
-        {&rda_reports, "rda_reports"},
-        {&rda_rules, "rda_rules"},
+        {pooled ? NULL : &rda_ctrls, "rda_ctrls"},
+        {pooled ? NULL : &rda_reports, "rda_reports"},
+        {pooled ? NULL : &rda_rules, "rda_rules"},
     };
     rc = threadset_start(&agent->threads, threadinfo, sizeof(threadinfo)/sizeof(threadinfo_t), agent);
     if (rc != AMP_OK)
@@ -131,6 +216,8 @@ bool nmagent_start(nmagent_t *agent)
 
 bool nmagent_stop(nmagent_t *agent)
 {
+  nmagent_select(agent);
+
   /* Notify threads */
   daemon_run_stop(&agent->running);
   rda_signal_shutdown();
@@ -140,6 +227,7 @@ bool nmagent_stop(nmagent_t *agent)
   AMP_DEBUG_ALWAYS("agent_main","Cleaning Agent Resources.",NULL);
   
   rda_cleanup();
+  nmagent_select(NULL);
   
   AMP_DEBUG_ALWAYS("agent_main","Stopping Agent.",NULL);
   
@@ -166,3 +254,152 @@ bool nmagent_register(nmagent_t *agent, const eid_t *agent_eid, const eid_t *mgr
   msg_agent_release(msg, 1);
   return valid;
 }
+
+static void *nmagent_pool_run(void *arg)
+{
+  nmagent_pool_worker_t *worker = arg;
+  nmagent_pool_t *pool = worker->pool;
+  size_t num_agents = nmagent_array_size(pool->agents);
+
+  AMP_DEBUG_INFO("nmagent_pool_run", "Worker %zu running.", worker->idx);
+
+  while (daemon_run_get(&pool->running))
+  {
+    OS_time_t next = OS_TIME_MAX;
+
+    pthread_mutex_lock(&worker->lock);
+    uint64_t wakes = worker->wakes;
+    pthread_mutex_unlock(&worker->lock);
+
+    for (size_t ix = worker->idx; ix < num_agents; ix += pool->num_workers)
+    {
+      nmagent_t *agent = *nmagent_array_get(pool->agents, ix);
+
+      if (!daemon_run_get(&agent->running))
+      {
+        continue;
+      }
+      nmagent_select(agent);
+      next = TimeMin(next, rda_step(agent));
+    }
+    nmagent_select(NULL);
+
+    /* Sleep until something is due, unless woken while running. */
+    pthread_mutex_lock(&worker->lock);
+    if (daemon_run_get(&pool->running) && (worker->wakes == wakes))
+    {
+      if (TimeCompare(next, OS_TIME_MAX) == 0)
+      {
+        pthread_cond_wait(&worker->cond, &worker->lock);
+      }
+      else
+      {
+        const struct timespec abstime = TimeToTimespec(next);
+        pthread_cond_timedwait(&worker->cond, &worker->lock, &abstime);
+      }
+    }
+    pthread_mutex_unlock(&worker->lock);
+  }
+
+  AMP_DEBUG_INFO("nmagent_pool_run", "Worker %zu stopped.", worker->idx);
+  return NULL;
+}
+
+bool nmagent_pool_init(nmagent_pool_t *pool, size_t num_workers)
+{
+  memset(pool, 0, sizeof(nmagent_pool_t));
+  if (num_workers == 0)
+  {
+    return false;
+  }
+
+  if ((pool->workers = STAKE(num_workers * sizeof(nmagent_pool_worker_t))) == NULL)
+  {
+    return false;
+  }
+  nmagent_array_init(pool->agents);
+  pool->num_workers = num_workers;
+  for (size_t ix = 0; ix < num_workers; ++ix)
+  {
+    nmagent_pool_worker_t *worker = pool->workers + ix;
+    worker->pool = pool;
+    worker->idx = ix;
+    pthread_mutex_init(&worker->lock, NULL);
+    pthread_cond_init(&worker->cond, NULL);
+  }
+  daemon_run_init(&pool->running);
+  return true;
+}
+
+bool nmagent_pool_destroy(nmagent_pool_t *pool)
+{
+  for (size_t ix = 0; ix < pool->num_workers; ++ix)
+  {
+    pthread_cond_destroy(&(pool->workers[ix].cond));
+    pthread_mutex_destroy(&(pool->workers[ix].lock));
+  }
+  SRELEASE(pool->workers);
+  pool->workers = NULL;
+  pool->num_workers = 0;
+  nmagent_array_clear(pool->agents);
+  daemon_run_cleanup(&pool->running);
+  return true;
+}
+
+bool nmagent_pool_add(nmagent_pool_t *pool, nmagent_t *agent)
+{
+  size_t ix = nmagent_array_size(pool->agents);
+
+  if (!list_thread_empty_p(pool->threads) || (agent->worker != NULL))
+  {
+    AMP_DEBUG_ERR("nmagent_pool_add", "Agent added after start.", NULL);
+    return false;
+  }
+  nmagent_array_push_back(pool->agents, agent);
+  agent->worker = pool->workers + (ix % pool->num_workers);
+  return true;
+}
+
+bool nmagent_pool_start(nmagent_pool_t *pool)
+{
+  const threadinfo_t threadinfo = {&nmagent_pool_run, "agent_pool"};
+
+  for (size_t ix = 0; ix < pool->num_workers; ++ix)
+  {
+    if (threadset_start(&pool->threads, &threadinfo, 1, pool->workers + ix) != AMP_OK)
+    {
+      nmagent_pool_stop(pool);
+      return false;
+    }
+  }
+  AMP_DEBUG_INFO("nmagent_pool_start", "Running %zu agents on %zu workers.",
+                 nmagent_array_size(pool->agents), pool->num_workers);
+  return true;
+}
+
+bool nmagent_pool_stop(nmagent_pool_t *pool)
+{
+  daemon_run_stop(&pool->running);
+  for (size_t ix = 0; ix < pool->num_workers; ++ix)
+  {
+    nmagent_pool_worker_t *worker = pool->workers + ix;
+    pthread_mutex_lock(&worker->lock);
+    pthread_cond_broadcast(&worker->cond);
+    pthread_mutex_unlock(&worker->lock);
+  }
+  return (threadset_join(&pool->threads) == AMP_OK);
+}
+
+void nmagent_pool_wake(nmagent_t *agent)
+{
+  nmagent_pool_worker_t *worker = agent->worker;
+
+  if (worker == NULL)
+  {
+    return;
+  }
+  pthread_mutex_lock(&worker->lock);
+  ++(worker->wakes);
+  pthread_cond_signal(&worker->cond);
+  pthread_mutex_unlock(&worker->lock);
+}
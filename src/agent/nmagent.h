@@ -40,6 +40,7 @@
 
 // Standard includes
 #include <stdint.h>
+#include <m-array.h>
 
 // Application includes
 #include "shared/platform.h"
@@ -47,10 +48,12 @@
 #include "shared/utils/nm_types.h"
 #include "shared/utils/daemon_run.h"
 #include "shared/utils/threadset.h"
+#include "shared/utils/db.h"
 #include "shared/primitives/ari.h"
 #include "shared/primitives/rules.h"
 #include "shared/msg/msg.h"
 #include "shared/msg/msg_if.h"
+#include "outq.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -75,6 +78,25 @@ extern "C" {
  * |							  DATA TYPES  								  +
  * +--------------------------------------------------------------------------+
  */
+struct agent_db_s;
+struct nmagent_pool_s;
+
+/** One worker of an agent pool.
+ */
+typedef struct {
+  /// The pool this belongs to
+  struct nmagent_pool_s *pool;
+  /// Index of this worker, which runs every agent at this index modulo
+  /// the number of workers
+  size_t idx;
+  /// Protects #wakes
+  pthread_mutex_t lock;
+  /// Signaled when any agent of this worker may have new work
+  pthread_cond_t cond;
+  /// Count of wakes, so that none are missed while the worker is busy
+  uint64_t wakes;
+} nmagent_pool_worker_t;
+
 typedef struct {
   /// Running state
   daemon_run_t running;
@@ -82,9 +104,42 @@ typedef struct {
   mif_cfg_t mif;
   /// Threads associated with the agent
   list_thread_t threads;
-
+  /// Handling of messages that cannot be sent right away
+  outq_cfg_t outq;
+
+  /// Rules, variables and other objects given to this agent, which are
+  /// &gVDB.inst for the process's own agent
+  vdb_inst_t *vdb;
+  /// Reports being built and held, which are &gAgentDb for the process's
+  /// own agent
+  struct agent_db_s *db;
+  /// The pool worker which runs this agent, or NULL if it has its own
+  /// threads
+  nmagent_pool_worker_t *worker;
 } nmagent_t;
 
+/// Growable array of agents, as a pool may run any number of them
+ARRAY_DEF(nmagent_array, nmagent_t *, M_PTR_OPLIST)
+
+/** A scheduler shared by many agents in one process.
+ * Each agent keeps its own receive thread, as that depends on its transport,
+ * while its controls, rules and reports are run by a fixed set of workers.
+ * Agents are added and started before the pool is started, and the pool is
+ * stopped before any of its agents.
+ */
+typedef struct nmagent_pool_s {
+  /// Running state
+  daemon_run_t running;
+  /// Agents run by the pool
+  nmagent_array_t agents;
+  /// Array of workers
+  nmagent_pool_worker_t *workers;
+  /// Size of #workers
+  size_t num_workers;
+  /// Worker threads
+  list_thread_t threads;
+} nmagent_pool_t;
+
 /*
  * +--------------------------------------------------------------------------+
  * |						  FUNCTION PROTOTYPES  							  +
@@ -93,8 +148,26 @@ typedef struct {
 
 bool nmagent_init(nmagent_t *agent);
 
+/** Initialize another agent in a process which already has its own agent
+ * from nmagent_init(). The new agent shares the ADMs of the process but has
+ * its own rules, variables, controls and reports. It is not persisted.
+ */
+bool nmagent_init_instance(nmagent_t *agent);
+
 bool nmagent_destroy(nmagent_t *agent);
 
+/** Make an agent the one whose state this thread uses.
+ * @param agent The agent, or NULL for the process's own agent.
+ */
+void nmagent_select(nmagent_t *agent);
+
+/** Open the persistent store and restore the objects it holds.
+ * This must be called after all ADMs are initialized and before the agent
+ * is started. Without it, nothing the agent is given is persisted.
+ * @param db_path The path prefix of the store files.
+ */
+bool nmagent_restore(nmagent_t *agent, char *db_path);
+
 bool nmagent_start(nmagent_t *agent);
 
 bool nmagent_stop(nmagent_t *agent);
@@ -104,6 +177,28 @@ bool nmagent_stop(nmagent_t *agent);
  */
 bool nmagent_register(nmagent_t *agent, const eid_t *agent_eid, const eid_t *mgr_eid);
 
+/** Initialize an agent pool.
+ * @param num_workers The number of worker threads, at least one.
+ */
+bool nmagent_pool_init(nmagent_pool_t *pool, size_t num_workers);
+
+bool nmagent_pool_destroy(nmagent_pool_t *pool);
+
+/** Have an agent run by a pool, in place of its own threads.
+ * This must be called before nmagent_start() for the agent and before
+ * the pool is started.
+ */
+bool nmagent_pool_add(nmagent_pool_t *pool, nmagent_t *agent);
+
+bool nmagent_pool_start(nmagent_pool_t *pool);
+
+bool nmagent_pool_stop(nmagent_pool_t *pool);
+
+/** Tell the pool worker of an agent that it may have new work.
+ * This does nothing for an agent with its own threads.
+ */
+void nmagent_pool_wake(nmagent_t *agent);
+
 
 /*
  * +--------------------------------------------------------------------------+
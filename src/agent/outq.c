@@ -0,0 +1,1058 @@
+/*
+ * Copyright (c) 2023 The Johns Hopkins University Applied Physics
+ * Laboratory LLC.
+ *
+ * This file is part of the Delay-Tolerant Networking Management
+ * Architecture (DTNMA) Tools package.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#include "shared/platform.h"
+#include "shared/utils/debug.h"
+#include "shared/utils/utils.h"
+#include "instr.h"
+#include "outq.h"
+
+/// Record marker, "OU"
+#define OUTQ_REC_MAGIC 0x554f
+/** Record layout version, 2 since records hold the time they were queued.
+ * Version 1 records began with the marker "OUTQ", which reads as version
+ * 0x5154 and so is rejected as well.
+ */
+#define OUTQ_REC_VERSION 2
+/// Record state of a message still to be sent
+#define OUTQ_REC_LIVE 1
+/// Record state of a message sent or dropped
+#define OUTQ_REC_DONE 2
+/// Record flag for a zlib-compressed message
+#define OUTQ_FLAG_ZLIB 0x01
+
+/** Spill file record header, followed by the destination and the message.
+ * Only #state is ever rewritten, so it is excluded from the CRC.
+ */
+typedef struct
+{
+  uint16_t magic;
+  uint16_t version;
+  uint32_t crc;
+  uint64_t seq;
+  int64_t queued_ms;
+  uint32_t len;
+  uint32_t raw_len;
+  uint32_t count;
+  uint8_t state;
+  uint8_t prio;
+  uint8_t flags;
+  uint8_t dest_len;
+} outq_rec_hdr_t;
+
+static size_t outq_dest_len(const eid_t *dest)
+{
+  return strnlen(dest->name, AMP_MAX_EID_LEN);
+}
+
+static size_t outq_rec_size(const outq_ent_t *ent)
+{
+  return sizeof(outq_rec_hdr_t) + outq_dest_len(&(ent->dest)) + ent->size;
+}
+
+static uint32_t outq_rec_crc(const outq_rec_hdr_t *hdr, const uint8_t *body)
+{
+  uint32_t crc = utils_crc32(0, (const uint8_t *) &(hdr->seq),
+                             offsetof(outq_rec_hdr_t, state) - offsetof(outq_rec_hdr_t, seq));
+  crc = utils_crc32(crc, &(hdr->prio), sizeof(outq_rec_hdr_t) - offsetof(outq_rec_hdr_t, prio));
+  return utils_crc32(crc, body, hdr->dest_len + hdr->len);
+}
+
+static int outq_pwrite_all(int fd, const uint8_t *data, size_t len, off_t pos)
+{
+  while (len > 0)
+  {
+    ssize_t got = pwrite(fd, data, len, pos);
+    if (got < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      return AMP_SYSERR;
+    }
+    data += got;
+    len -= got;
+    pos += got;
+  }
+  return AMP_OK;
+}
+
+static int outq_pread_all(int fd, uint8_t *data, size_t len, off_t pos)
+{
+  while (len > 0)
+  {
+    ssize_t got = pread(fd, data, len, pos);
+    if (got < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      return AMP_SYSERR;
+    }
+    if (got == 0)
+    {
+      return AMP_FAIL;
+    }
+    data += got;
+    len -= got;
+    pos += got;
+  }
+  return AMP_OK;
+}
+
+static void outq_cfg_defaults(outq_cfg_t *cfg)
+{
+  if (cfg->max_bytes == 0)
+  {
+    cfg->max_bytes = OUTQ_DEF_MAX_BYTES;
+  }
+  if (cfg->retry_ms == 0)
+  {
+    cfg->retry_ms = OUTQ_DEF_RETRY_MS;
+  }
+  if (cfg->burst == 0)
+  {
+    cfg->burst = cfg->rate;
+  }
+#ifndef HAVE_ZLIB
+  if (cfg->compress)
+  {
+    AMP_DEBUG_WARN("outq_open", "Compression is not available in this build.", NULL);
+    cfg->compress = false;
+  }
+#endif
+}
+
+/// Append a message to the tail of its class
+static void outq_link(outq_t *q, outq_ent_t *ent)
+{
+  ent->next = NULL;
+  if (q->tail[ent->prio])
+  {
+    q->tail[ent->prio]->next = ent;
+  }
+  else
+  {
+    q->head[ent->prio] = ent;
+  }
+  q->tail[ent->prio] = ent;
+  q->num++;
+  q->bytes += ent->size;
+  q->stats[ent->prio].held++;
+}
+
+/// Remove the message at the head of a class
+static outq_ent_t *outq_unlink_head(outq_t *q, int prio)
+{
+  outq_ent_t *ent = q->head[prio];
+  if (ent)
+  {
+    q->head[prio] = ent->next;
+    if (q->head[prio] == NULL)
+    {
+      q->tail[prio] = NULL;
+    }
+    ent->next = NULL;
+  }
+  return ent;
+}
+
+/// Forget an unlinked message and release it
+static void outq_retire(outq_t *q, outq_ent_t *ent)
+{
+  if ((ent->data == NULL) && (q->fd >= 0))
+  {
+    const uint8_t state = OUTQ_REC_DONE;
+    if (outq_pwrite_all(q->fd, &state, 1, ent->offset + offsetof(outq_rec_hdr_t, state)) != AMP_OK)
+    {
+      AMP_DEBUG_ERR("outq_retire", "Unable to mark record %"PRIu64" done: %s", ent->seq, strerror(errno));
+    }
+    q->live -= outq_rec_size(ent);
+  }
+
+  q->num--;
+  q->bytes -= ent->size;
+  q->stats[ent->prio].held--;
+  SRELEASE(ent->data);
+  SRELEASE(ent);
+
+  // Nothing live remains in the spill file
+  if ((q->num == 0) && (q->fd >= 0) && (q->end > 0))
+  {
+    if (ftruncate(q->fd, 0) == 0)
+    {
+      q->end = 0;
+      q->live = 0;
+    }
+  }
+}
+
+/// Get the rate limit of a destination, brought up to date
+static outq_bucket_t *outq_bucket(outq_t *q, const eid_t *dest, OS_time_t nowtime)
+{
+  outq_bucket_t *bkt;
+
+  for (bkt = q->buckets; bkt; bkt = bkt->next)
+  {
+    if (strncmp(bkt->dest.name, dest->name, AMP_MAX_EID_LEN) == 0)
+    {
+      break;
+    }
+  }
+  if (bkt == NULL)
+  {
+    if ((bkt = STAKE(sizeof(outq_bucket_t))) == NULL)
+    {
+      return NULL;
+    }
+    memcpy(bkt->dest.name, dest->name, outq_dest_len(dest));
+    bkt->tokens = q->cfg.burst;
+    bkt->filled = nowtime;
+    bkt->next = q->buckets;
+    q->buckets = bkt;
+    return bkt;
+  }
+
+  // Only whole tokens are added, so any remainder is kept for next time
+  const int64_t elapsed_us = OS_TimeGetTotalMicroseconds(OS_TimeSubtract(nowtime, bkt->filled));
+  const int64_t add = elapsed_us * q->cfg.rate / 1000000;
+  if (add <= 0)
+  {
+    return bkt;
+  }
+  bkt->tokens += add;
+  if (bkt->tokens >= (int64_t) q->cfg.burst)
+  {
+    bkt->tokens = q->cfg.burst;
+    bkt->filled = nowtime;
+  }
+  else
+  {
+    bkt->filled = OS_TimeAdd(bkt->filled, OS_TimeFromTotalMicroseconds(add * 1000000 / q->cfg.rate));
+  }
+  return bkt;
+}
+
+/// Account for a message dropped unsent
+static void outq_drop(outq_t *q, const eid_t *dest)
+{
+  OS_time_t nowtime;
+  outq_bucket_t *bkt;
+
+  OS_GetLocalTime(&nowtime);
+  if ((bkt = outq_bucket(q, dest, nowtime)) != NULL)
+  {
+    bkt->dropped++;
+  }
+}
+
+/** Determine if the rate limit allows a message to be sent now.
+ * @param[out] when If not allowed, the time at which it will be.
+ */
+static bool outq_allowed(outq_t *q, const eid_t *dest, int prio, OS_time_t nowtime, OS_time_t *when)
+{
+  outq_bucket_t *bkt;
+
+  if ((q->cfg.rate == 0) || (prio == AMP_PRIO_URGENT))
+  {
+    return true;
+  }
+  if (((bkt = outq_bucket(q, dest, nowtime)) == NULL) || (bkt->tokens > 0))
+  {
+    return true;
+  }
+  const int64_t wait_us = (1 - bkt->tokens) * 1000000 / q->cfg.rate + 1;
+  *when = OS_TimeAdd(bkt->filled, OS_TimeFromTotalMicroseconds(wait_us));
+  return false;
+}
+
+/// Account for a message sent
+static void outq_sent(outq_t *q, const eid_t *dest, int prio, size_t len,
+                      OS_time_t queued, OS_time_t nowtime)
+{
+  outq_stats_t *stats = &(q->stats[prio]);
+  int64_t delay_us = OS_TimeGetTotalMicroseconds(OS_TimeSubtract(nowtime, queued));
+  int64_t delay_ms = delay_us / 1000;
+
+  if (q->cfg.rate > 0)
+  {
+    outq_bucket_t *bkt = outq_bucket(q, dest, nowtime);
+    if (bkt != NULL)
+    {
+      bkt->tokens -= len;
+    }
+  }
+
+  if (delay_ms < 0)
+  {
+    delay_ms = 0;
+  }
+  agent_instr_lat_record(AGENT_INSTR_LAT_RPT_QUEUE, (delay_us > 0) ? delay_us : 0);
+  stats->sent++;
+  stats->delay_ms += delay_ms;
+  if (delay_ms > stats->max_delay_ms)
+  {
+    stats->max_delay_ms = (delay_ms > UINT32_MAX) ? UINT32_MAX : delay_ms;
+  }
+}
+
+/// Determine if anything of a class, or a more urgent one, is held
+static bool outq_held_through(const outq_t *q, int prio)
+{
+  for (int cls = 0; cls <= prio; ++cls)
+  {
+    if (q->head[cls] != NULL)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+/** Choose the next message to send.
+ * The head of a class which is over its rate limit is passed over, and if
+ * nothing can be sent the time at which something can is kept.
+ */
+static outq_ent_t *outq_pick(outq_t *q, OS_time_t nowtime)
+{
+  outq_ent_t *best = NULL;
+  OS_time_t limit_at = OS_TIME_MAX;
+
+  for (int prio = 0; prio < AMP_NUM_PRIO; ++prio)
+  {
+    outq_ent_t *ent = q->head[prio];
+    OS_time_t when;
+    if (ent == NULL)
+    {
+      continue;
+    }
+    if (!outq_allowed(q, &(ent->dest), prio, nowtime, &when))
+    {
+      if (TimeCompare(when, limit_at) < 0)
+      {
+        limit_at = when;
+      }
+      continue;
+    }
+    if (q->cfg.by_priority)
+    {
+      return ent;
+    }
+    if ((best == NULL) || (ent->seq < best->seq))
+    {
+      best = ent;
+    }
+  }
+  if (best == NULL)
+  {
+    q->limit_at = limit_at;
+  }
+  return best;
+}
+
+static bool outq_usable(const outq_t *q, OS_time_t nowtime)
+{
+  return q->link_open && (TimeCompare(nowtime, q->retry_at) >= 0);
+}
+
+static void outq_backoff(outq_t *q)
+{
+  OS_time_t nowtime;
+  OS_GetLocalTime(&nowtime);
+  q->retry_at = OS_TimeAdd(nowtime, OS_TimeFromTotalMilliseconds(q->cfg.retry_ms));
+}
+
+/** Rewrite the spill file with only its live records.
+ * On any failure the existing file is kept as it is.
+ */
+static void outq_compact(outq_t *q)
+{
+  const size_t path_len = strlen(q->cfg.path) + 5;
+  char *tmp_path = STAKE(path_len);
+  off_t *offsets = STAKE((q->num + 1) * sizeof(off_t));
+  uint8_t *buf = NULL;
+  size_t buf_cap = 0;
+  off_t pos = 0;
+  uint32_t idx = 0;
+  int fd = -1;
+  bool valid = (tmp_path != NULL) && (offsets != NULL);
+
+  if (valid)
+  {
+    snprintf(tmp_path, path_len, "%s.tmp", q->cfg.path);
+    fd = open(tmp_path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    valid = (fd >= 0);
+  }
+
+  for (int prio = 0; valid && (prio < AMP_NUM_PRIO); ++prio)
+  {
+    for (outq_ent_t *ent = q->head[prio]; valid && ent; ent = ent->next)
+    {
+      if (ent->data != NULL)
+      {
+        continue;
+      }
+      const size_t rec_size = outq_rec_size(ent);
+      if (rec_size > buf_cap)
+      {
+        SRELEASE(buf);
+        buf_cap = rec_size;
+        buf = STAKE(buf_cap);
+      }
+      valid = (buf != NULL)
+        && (outq_pread_all(q->fd, buf, rec_size, ent->offset) == AMP_OK)
+        && (outq_pwrite_all(fd, buf, rec_size, pos) == AMP_OK);
+      offsets[idx++] = pos;
+      pos += rec_size;
+    }
+  }
+  SRELEASE(buf);
+
+  valid = valid && (fdatasync(fd) == 0) && (rename(tmp_path, q->cfg.path) == 0);
+  if (valid)
+  {
+    close(q->fd);
+    q->fd = fd;
+    q->end = pos;
+    q->live = pos;
+
+    idx = 0;
+    for (int prio = 0; prio < AMP_NUM_PRIO; ++prio)
+    {
+      for (outq_ent_t *ent = q->head[prio]; ent; ent = ent->next)
+      {
+        if (ent->data == NULL)
+        {
+          ent->offset = offsets[idx++];
+        }
+      }
+    }
+    AMP_DEBUG_INFO("outq_compact", "Spill file compacted to %lld bytes", (long long) pos);
+  }
+  else
+  {
+    AMP_DEBUG_WARN("outq_compact", "Unable to compact spill file %s", q->cfg.path);
+    if (fd >= 0)
+    {
+      close(fd);
+      unlink(tmp_path);
+    }
+  }
+
+  SRELEASE(offsets);
+  SRELEASE(tmp_path);
+}
+
+/// Index the live records of the spill file
+static int outq_recover(outq_t *q)
+{
+  uint8_t *body = NULL;
+  size_t body_cap = 0;
+  off_t pos = 0;
+  struct stat st;
+
+  if (fstat(q->fd, &st) != 0)
+  {
+    return AMP_SYSERR;
+  }
+
+  while (pos + (off_t) sizeof(outq_rec_hdr_t) <= st.st_size)
+  {
+    outq_rec_hdr_t hdr;
+    if ((outq_pread_all(q->fd, (uint8_t *) &hdr, sizeof(hdr), pos) != AMP_OK)
+        || (hdr.magic != OUTQ_REC_MAGIC))
+    {
+      break;
+    }
+    if (hdr.version != OUTQ_REC_VERSION)
+    {
+      // Refuse to discard messages written in another layout
+      AMP_DEBUG_ERR("outq_recover", "Spill file record version %u, expected %u", hdr.version, OUTQ_REC_VERSION);
+      SRELEASE(body);
+      return AMP_FAIL;
+    }
+    if ((hdr.dest_len > AMP_MAX_EID_LEN)
+        || (hdr.prio >= AMP_NUM_PRIO))
+    {
+      break;
+    }
+
+    const size_t body_len = hdr.dest_len + hdr.len;
+    if (pos + (off_t) (sizeof(hdr) + body_len) > st.st_size)
+    {
+      break;
+    }
+    if (body_len > body_cap)
+    {
+      SRELEASE(body);
+      body_cap = body_len;
+      if ((body = STAKE(body_cap)) == NULL)
+      {
+        return AMP_SYSERR;
+      }
+    }
+    if ((outq_pread_all(q->fd, body, body_len, pos + sizeof(hdr)) != AMP_OK)
+        || (hdr.crc != outq_rec_crc(&hdr, body)))
+    {
+      break;
+    }
+
+    if (hdr.state == OUTQ_REC_LIVE)
+    {
+      outq_ent_t *ent = STAKE(sizeof(outq_ent_t));
+      if (ent == NULL)
+      {
+        SRELEASE(body);
+        return AMP_SYSERR;
+      }
+      ent->seq = hdr.seq;
+      ent->queued = OS_TimeFromTotalMilliseconds(hdr.queued_ms);
+      memcpy(ent->dest.name, body, hdr.dest_len);
+      ent->count = hdr.count;
+      ent->size = hdr.len;
+      ent->raw_size = hdr.raw_len;
+      ent->flags = hdr.flags;
+      ent->prio = hdr.prio;
+      ent->offset = pos;
+      outq_link(q, ent);
+      q->live += outq_rec_size(ent);
+    }
+    if (hdr.seq >= q->next_seq)
+    {
+      q->next_seq = hdr.seq + 1;
+    }
+    pos += sizeof(hdr) + body_len;
+  }
+  SRELEASE(body);
+
+  if (pos < st.st_size)
+  {
+    AMP_DEBUG_WARN("outq_recover", "Discarding %lld bytes of torn spill file", (long long) (st.st_size - pos));
+  }
+  if (q->num == 0)
+  {
+    pos = 0;
+  }
+  if ((pos < st.st_size) && (ftruncate(q->fd, pos) != 0))
+  {
+    return AMP_SYSERR;
+  }
+  q->end = pos;
+
+  AMP_DEBUG_INFO("outq_recover", "Recovered %u held messages (%"PRIu64" bytes)", q->num, q->bytes);
+  return AMP_OK;
+}
+
+/// Hold a message, with the queue locked
+static int outq_hold(outq_t *q, const blob_t *data, const eid_t *dest, amp_prio_e prio, uint32_t count,
+                     OS_time_t queued)
+{
+  outq_ent_t *ent;
+  uint8_t *held = NULL;
+  size_t held_len = data->length;
+  uint8_t flags = 0;
+
+#ifdef HAVE_ZLIB
+  if (q->cfg.compress && (data->length >= OUTQ_MIN_COMPRESS))
+  {
+    uLongf zlen = compressBound(data->length);
+    if ((held = STAKE(zlen)) != NULL)
+    {
+      if ((compress2(held, &zlen, data->value, data->length, Z_DEFAULT_COMPRESSION) == Z_OK)
+          && (zlen < data->length))
+      {
+        held_len = zlen;
+        flags |= OUTQ_FLAG_ZLIB;
+      }
+      else
+      {
+        SRELEASE(held);
+        held = NULL;
+      }
+    }
+  }
+#endif
+  if (held == NULL)
+  {
+    if ((held = STAKE(data->length)) == NULL)
+    {
+      return AMP_SYSERR;
+    }
+    memcpy(held, data->value, data->length);
+  }
+
+  // Make room by dropping the oldest of any less urgent class
+  while (q->bytes + held_len > q->cfg.max_bytes)
+  {
+    int victim = AMP_NUM_PRIO - 1;
+    while ((victim > (int) prio) && (q->head[victim] == NULL))
+    {
+      --victim;
+    }
+    if (victim <= (int) prio)
+    {
+      AMP_DEBUG_WARN("outq_hold", "Queue full, dropping %zu byte message to %s", held_len, dest->name);
+      q->num_dropped++;
+      SRELEASE(held);
+      return AMP_FAIL;
+    }
+
+    outq_ent_t *old = outq_unlink_head(q, victim);
+    AMP_DEBUG_WARN("outq_hold", "Queue full, dropping held message to %s", old->dest.name);
+    q->num_dropped++;
+    outq_drop(q, &(old->dest));
+    outq_retire(q, old);
+  }
+
+  if ((ent = STAKE(sizeof(outq_ent_t))) == NULL)
+  {
+    SRELEASE(held);
+    return AMP_SYSERR;
+  }
+  ent->seq = q->next_seq++;
+  memcpy(ent->dest.name, dest->name, outq_dest_len(dest));
+  ent->count = count;
+  ent->size = held_len;
+  ent->raw_size = data->length;
+  ent->flags = flags;
+  ent->prio = prio;
+  ent->queued = queued;
+  ent->offset = -1;
+  ent->data = held;
+
+  if (q->fd >= 0)
+  {
+    const size_t rec_size = outq_rec_size(ent);
+    uint8_t *rec = STAKE(rec_size);
+    if (rec != NULL)
+    {
+      outq_rec_hdr_t *hdr = (outq_rec_hdr_t *) rec;
+      uint8_t *body = rec + sizeof(outq_rec_hdr_t);
+      hdr->magic = OUTQ_REC_MAGIC;
+      hdr->version = OUTQ_REC_VERSION;
+      hdr->seq = ent->seq;
+      hdr->queued_ms = OS_TimeGetTotalMilliseconds(ent->queued);
+      hdr->len = ent->size;
+      hdr->raw_len = ent->raw_size;
+      hdr->count = ent->count;
+      hdr->state = OUTQ_REC_LIVE;
+      hdr->prio = ent->prio;
+      hdr->flags = ent->flags;
+      hdr->dest_len = outq_dest_len(&(ent->dest));
+      memcpy(body, ent->dest.name, hdr->dest_len);
+      memcpy(body + hdr->dest_len, held, held_len);
+      hdr->crc = outq_rec_crc(hdr, body);
+
+      if ((outq_pwrite_all(q->fd, rec, rec_size, q->end) == AMP_OK)
+          && (fdatasync(q->fd) == 0))
+      {
+        ent->offset = q->end;
+        ent->data = NULL;
+        q->end += rec_size;
+        q->live += rec_size;
+        SRELEASE(held);
+      }
+      SRELEASE(rec);
+    }
+    if (ent->data != NULL)
+    {
+      AMP_DEBUG_ERR("outq_hold", "Unable to spill message, holding in memory: %s", strerror(errno));
+    }
+  }
+
+  outq_link(q, ent);
+  return AMP_OK;
+}
+
+/// Get the serialized form of a held message
+static int outq_load(outq_t *q, const outq_ent_t *ent, blob_t *data)
+{
+  uint8_t *held = ent->data;
+  int success = AMP_OK;
+
+  if (held == NULL)
+  {
+    if ((held = STAKE(ent->size)) == NULL)
+    {
+      return AMP_SYSERR;
+    }
+    const off_t pos = ent->offset + sizeof(outq_rec_hdr_t) + outq_dest_len(&(ent->dest));
+    success = outq_pread_all(q->fd, held, ent->size, pos);
+  }
+
+  data->value = STAKE(ent->raw_size);
+  data->length = ent->raw_size;
+  data->alloc = ent->raw_size;
+  if (data->value == NULL)
+  {
+    success = AMP_SYSERR;
+  }
+  if (success != AMP_OK)
+  {
+    // Nothing more to do
+  }
+  else if (ent->flags & OUTQ_FLAG_ZLIB)
+  {
+#ifdef HAVE_ZLIB
+    uLongf raw_len = ent->raw_size;
+    if ((uncompress(data->value, &raw_len, held, ent->size) != Z_OK)
+        || (raw_len != ent->raw_size))
+    {
+      success = AMP_FAIL;
+    }
+#else
+    success = AMP_FAIL;
+#endif
+  }
+  else
+  {
+    memcpy(data->value, held, ent->size);
+  }
+
+  if (held != ent->data)
+  {
+    SRELEASE(held);
+  }
+  if (success != AMP_OK)
+  {
+    SRELEASE(data->value);
+    data->value = NULL;
+  }
+  return success;
+}
+
+int outq_init(outq_t *q)
+{
+  CHKUSR(q, AMP_FAIL);
+  memset(q, 0, sizeof(outq_t));
+  if (pthread_mutex_init(&(q->lock), NULL))
+  {
+    return AMP_SYSERR;
+  }
+  outq_cfg_defaults(&(q->cfg));
+  q->link_open = true;
+  q->fd = -1;
+  return AMP_OK;
+}
+
+int outq_open(outq_t *q, const outq_cfg_t *cfg)
+{
+  int success = AMP_OK;
+
+  CHKUSR(q, AMP_FAIL);
+  CHKUSR(cfg, AMP_FAIL);
+
+  pthread_mutex_lock(&(q->lock));
+  if ((q->num > 0) || (q->fd >= 0))
+  {
+    pthread_mutex_unlock(&(q->lock));
+    AMP_DEBUG_ERR("outq_open", "Queue already in use.", NULL);
+    return AMP_FAIL;
+  }
+
+  q->cfg = *cfg;
+  outq_cfg_defaults(&(q->cfg));
+
+  if (q->cfg.path != NULL)
+  {
+    q->fd = open(q->cfg.path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (q->fd < 0)
+    {
+      AMP_DEBUG_ERR("outq_open", "Unable to open spill file %s: %s", q->cfg.path, strerror(errno));
+      success = AMP_SYSERR;
+    }
+    else if ((success = outq_recover(q)) != AMP_OK)
+    {
+      AMP_DEBUG_ERR("outq_open", "Unable to recover spill file %s", q->cfg.path);
+    }
+  }
+  pthread_mutex_unlock(&(q->lock));
+
+  return success;
+}
+
+void outq_destroy(outq_t *q)
+{
+  uint32_t lost = 0;
+
+  CHKVOID(q);
+  pthread_mutex_lock(&(q->lock));
+  for (int prio = 0; prio < AMP_NUM_PRIO; ++prio)
+  {
+    outq_ent_t *ent;
+    while ((ent = outq_unlink_head(q, prio)) != NULL)
+    {
+      if (ent->data != NULL)
+      {
+        ++lost;
+      }
+      SRELEASE(ent->data);
+      SRELEASE(ent);
+    }
+  }
+  if (lost)
+  {
+    AMP_DEBUG_WARN("outq_destroy", "Discarding %u unsent messages held in memory", lost);
+  }
+  while (q->buckets)
+  {
+    outq_bucket_t *bkt = q->buckets;
+    q->buckets = bkt->next;
+    SRELEASE(bkt);
+  }
+  if (q->fd >= 0)
+  {
+    close(q->fd);
+    q->fd = -1;
+  }
+  q->num = 0;
+  q->bytes = 0;
+  pthread_mutex_unlock(&(q->lock));
+  pthread_mutex_destroy(&(q->lock));
+}
+
+int outq_send(outq_t *q, mif_cfg_t *mif, const blob_t *data, const eid_t *dest,
+              amp_prio_e prio, uint32_t count, OS_time_t queued)
+{
+  OS_time_t nowtime;
+  OS_time_t when;
+  bool direct;
+  int success;
+
+  CHKUSR(q, AMP_SYSERR);
+  CHKUSR(data, AMP_SYSERR);
+  CHKUSR(dest, AMP_SYSERR);
+  if (prio >= AMP_NUM_PRIO)
+  {
+    prio = AMP_NUM_PRIO - 1;
+  }
+
+  OS_GetLocalTime(&nowtime);
+  pthread_mutex_lock(&(q->lock));
+  direct = outq_usable(q, nowtime) && !outq_held_through(q, prio);
+  if (direct && !outq_allowed(q, dest, prio, nowtime, &when))
+  {
+    direct = false;
+    if ((TimeCompare(q->limit_at, nowtime) <= 0) || (TimeCompare(when, q->limit_at) < 0))
+    {
+      q->limit_at = when;
+    }
+  }
+  pthread_mutex_unlock(&(q->lock));
+
+  if (direct)
+  {
+    if (mif_send_blob(mif, data, dest) == AMP_OK)
+    {
+      pthread_mutex_lock(&(q->lock));
+      outq_sent(q, dest, prio, data->length, queued, nowtime);
+      pthread_mutex_unlock(&(q->lock));
+      return AMP_OK;
+    }
+  }
+
+  pthread_mutex_lock(&(q->lock));
+  if (direct)
+  {
+    // Whatever is held is next tried once the transport may have recovered
+    outq_backoff(q);
+    q->limit_at = OS_TimeFromTotalMilliseconds(0);
+  }
+  if ((success = outq_hold(q, data, dest, prio, count, queued)) != AMP_OK)
+  {
+    outq_drop(q, dest);
+  }
+  pthread_mutex_unlock(&(q->lock));
+
+  return (success == AMP_OK) ? AMP_FAIL : AMP_SYSERR;
+}
+
+uint32_t outq_drain(outq_t *q, mif_cfg_t *mif)
+{
+  OS_time_t nowtime;
+  uint32_t sent = 0;
+
+  CHKZERO(q);
+
+  pthread_mutex_lock(&(q->lock));
+  while (q->num > 0)
+  {
+    outq_ent_t *ent;
+    blob_t data;
+    int success;
+
+    // Sends may be slow, so rate limits are checked against the current time
+    OS_GetLocalTime(&nowtime);
+    if (!outq_usable(q, nowtime))
+    {
+      break;
+    }
+    if ((ent = outq_pick(q, nowtime)) == NULL)
+    {
+      // Everything held is over its rate limit
+      break;
+    }
+
+    // Only this thread removes messages, so the entry stays at its head
+    pthread_mutex_unlock(&(q->lock));
+    if ((success = outq_load(q, ent, &data)) == AMP_OK)
+    {
+      success = mif_send_blob(mif, &data, &(ent->dest));
+      SRELEASE(data.value);
+      if (success != AMP_OK)
+      {
+        success = AMP_SYSERR;
+      }
+    }
+    else
+    {
+      AMP_DEBUG_ERR("outq_drain", "Dropping unreadable message %"PRIu64" to %s", ent->seq, ent->dest.name);
+      success = AMP_FAIL;
+    }
+    pthread_mutex_lock(&(q->lock));
+    OS_GetLocalTime(&nowtime);
+
+    if (success == AMP_SYSERR)
+    {
+      outq_backoff(q);
+      break;
+    }
+    if (success == AMP_OK)
+    {
+      sent += ent->count;
+      outq_sent(q, &(ent->dest), ent->prio, data.length, ent->queued, nowtime);
+    }
+    else
+    {
+      outq_drop(q, &(ent->dest));
+    }
+    outq_unlink_head(q, ent->prio);
+    outq_retire(q, ent);
+  }
+
+  // Reclaim the spill file once it is mostly retired records
+  if ((q->fd >= 0) && (q->end - q->live > (off_t) (q->cfg.max_bytes / 2))
+      && (q->end - q->live > q->live))
+  {
+    outq_compact(q);
+  }
+  pthread_mutex_unlock(&(q->lock));
+
+  return sent;
+}
+
+OS_time_t outq_next_try(outq_t *q)
+{
+  OS_time_t next = OS_TIME_MAX;
+
+  CHKUSR(q, next);
+  pthread_mutex_lock(&(q->lock));
+  if ((q->num > 0) && q->link_open)
+  {
+    next = q->retry_at;
+    if (TimeCompare(q->limit_at, next) > 0)
+    {
+      next = q->limit_at;
+    }
+  }
+  pthread_mutex_unlock(&(q->lock));
+  return next;
+}
+
+void outq_set_link(outq_t *q, bool open)
+{
+  CHKVOID(q);
+  pthread_mutex_lock(&(q->lock));
+  q->link_open = open;
+  if (open)
+  {
+    q->retry_at = OS_TimeFromTotalMilliseconds(0);
+  }
+  pthread_mutex_unlock(&(q->lock));
+}
+
+uint32_t outq_size(outq_t *q)
+{
+  uint32_t num;
+
+  CHKZERO(q);
+  pthread_mutex_lock(&(q->lock));
+  num = q->num;
+  pthread_mutex_unlock(&(q->lock));
+  return num;
+}
+
+uint64_t outq_bytes(outq_t *q)
+{
+  uint64_t bytes;
+
+  CHKZERO(q);
+  pthread_mutex_lock(&(q->lock));
+  bytes = q->bytes;
+  pthread_mutex_unlock(&(q->lock));
+  return bytes;
+}
+
+uint64_t outq_dropped(outq_t *q, const eid_t *dest)
+{
+  outq_bucket_t *bkt;
+  uint64_t dropped = 0;
+
+  CHKZERO(q);
+  CHKZERO(dest);
+  pthread_mutex_lock(&(q->lock));
+  for (bkt = q->buckets; bkt; bkt = bkt->next)
+  {
+    if (strncmp(bkt->dest.name, dest->name, AMP_MAX_EID_LEN) == 0)
+    {
+      dropped = bkt->dropped;
+      break;
+    }
+  }
+  pthread_mutex_unlock(&(q->lock));
+  return dropped;
+}
+
+int outq_get_stats(outq_t *q, amp_prio_e prio, outq_stats_t *stats)
+{
+  CHKUSR(q, AMP_FAIL);
+  CHKUSR(stats, AMP_FAIL);
+  if (prio >= AMP_NUM_PRIO)
+  {
+    return AMP_FAIL;
+  }
+
+  pthread_mutex_lock(&(q->lock));
+  *stats = q->stats[prio];
+  pthread_mutex_unlock(&(q->lock));
+  return AMP_OK;
+}
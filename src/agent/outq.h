@@ -0,0 +1,270 @@
+/*
+ * Copyright (c) 2023 The Johns Hopkins University Applied Physics
+ * Laboratory LLC.
+ *
+ * This file is part of the Delay-Tolerant Networking Management
+ * Architecture (DTNMA) Tools package.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/** @file
+ * Store-and-forward queue for outbound agent messages.
+ *
+ * Messages are normally sent straight through the messaging interface.
+ * When the transport rejects a send, or the link is marked closed, the
+ * serialized message is held here instead and later messages queue behind
+ * it, so nothing is reordered. The queue is retried after
+ * outq_cfg_t::retry_ms, or as soon as the link is marked open.
+ *
+ * Held messages are kept in memory unless a spill file is configured, in
+ * which case they are appended to that file and only their index is kept
+ * in memory. The spill file is recovered on open, so messages held when
+ * the agent stops are sent after it restarts. Delivery is at-least-once: a
+ * message sent just before a crash may be sent again.
+ *
+ * The queue is bounded by outq_cfg_t::max_bytes of held payload. When full,
+ * older messages of a lower priority class are dropped to make room, and
+ * otherwise the new message is dropped.
+ *
+ * Sending to each destination can be limited by a token bucket of
+ * outq_cfg_t::rate bytes per second. Messages over the limit are held like
+ * any other. A new message is sent directly when nothing of its own or a
+ * more urgent class is held, so urgent output is never stuck behind bulk
+ * output, and #AMP_PRIO_URGENT messages are never rate limited. Order is kept
+ * within each class.
+ */
+#ifndef SRC_AGENT_OUTQ_H_
+#define SRC_AGENT_OUTQ_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include "shared/primitives/time.h"
+#include "shared/msg/msg_if.h"
+#include "shared/utils/nm_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Default bound on held payload bytes
+#define OUTQ_DEF_MAX_BYTES (4 * 1024 * 1024)
+/// Default time between send attempts while the transport is rejecting
+#define OUTQ_DEF_RETRY_MS 5000
+/// Messages smaller than this are never compressed
+#define OUTQ_MIN_COMPRESS 128
+
+/** Configuration of an outbound queue.
+ * Zero-valued fields take their defaults.
+ */
+typedef struct
+{
+  /// Path of the spill file, or NULL to hold messages in memory only
+  const char *path;
+  /// Bound on held payload bytes
+  size_t max_bytes;
+  /// Time between send attempts while the transport is rejecting
+  uint32_t retry_ms;
+  /// Drain the most urgent class first rather than strictly oldest first
+  bool by_priority;
+  /// Compress held messages, if supported by this build
+  bool compress;
+  /// Sustained rate to each destination in bytes per second, or zero for no limit
+  uint32_t rate;
+  /// Bytes which may be sent to a destination at once, defaulting to one second at #rate
+  uint32_t burst;
+} outq_cfg_t;
+
+/** Token bucket limiting the rate of sending to one destination, which
+ * also counts the messages to it that were dropped.
+ */
+typedef struct outq_bucket_s
+{
+  struct outq_bucket_s *next;
+  eid_t dest;
+  /// Bytes which may be sent, negative after a message larger than the balance
+  int64_t tokens;
+  /// Time up to which tokens have been added
+  OS_time_t filled;
+  /// Messages to the destination dropped unsent
+  uint64_t dropped;
+} outq_bucket_t;
+
+/** Statistics of one priority class. */
+typedef struct
+{
+  /// Number of messages currently held
+  uint32_t held;
+  /// Number of messages sent
+  uint64_t sent;
+  /// Sum of the queueing delay of sent messages, in milliseconds
+  uint64_t delay_ms;
+  /// Largest queueing delay of a sent message, in milliseconds
+  uint32_t max_delay_ms;
+} outq_stats_t;
+
+/** One held message. */
+typedef struct outq_ent_s
+{
+  /// Next message in the same priority class
+  struct outq_ent_s *next;
+  /// Queue order
+  uint64_t seq;
+  /// Destination of the message
+  eid_t dest;
+  /// Number of items (e.g. reports) in the message, for instrumentation
+  uint32_t count;
+  /// Held size of the message, after any compression
+  uint32_t size;
+  /// Serialized size of the message
+  uint32_t raw_size;
+  /// Record flags
+  uint8_t flags;
+  /// Priority class
+  uint8_t prio;
+  /// Time at which the message was first queued by the agent
+  OS_time_t queued;
+  /// Offset of the record in the spill file
+  off_t offset;
+  /// Held message if not spilled
+  uint8_t *data;
+} outq_ent_t;
+
+/** An outbound message queue.
+ * Only a single thread may push and drain, but any thread may inspect the
+ * queue or change its link state.
+ */
+typedef struct
+{
+  pthread_mutex_t lock;
+  outq_cfg_t cfg;
+
+  /// Held messages in FIFO order for each priority class
+  outq_ent_t *head[AMP_NUM_PRIO];
+  /// Last held message for each priority class
+  outq_ent_t *tail[AMP_NUM_PRIO];
+  /// Number of held messages
+  uint32_t num;
+  /// Held payload bytes
+  uint64_t bytes;
+  /// Next queue order
+  uint64_t next_seq;
+  /// Number of messages dropped because the queue was full
+  uint64_t num_dropped;
+
+  /// False while the link is known to be closed
+  bool link_open;
+  /// Earliest time to attempt the next send
+  OS_time_t retry_at;
+  /// Earliest time a held, rate limited message may be sent
+  OS_time_t limit_at;
+  /// Rate limit state of each destination sent to
+  outq_bucket_t *buckets;
+  /// Statistics of each priority class
+  outq_stats_t stats[AMP_NUM_PRIO];
+
+  /// Spill file descriptor, or -1
+  int fd;
+  /// Size of the spill file
+  off_t end;
+  /// Bytes of the spill file still holding live records
+  off_t live;
+} outq_t;
+
+/** Initialize an empty, in-memory queue with default configuration.
+ * @param q The queue to initialize.
+ * @return AMP_OK if successful.
+ */
+int outq_init(outq_t *q);
+
+/** Apply a configuration and recover any messages held in its spill file.
+ * @param q The queue, which must be empty.
+ * @param cfg The configuration, which is copied. The path is not.
+ * @return AMP_OK if successful.
+ */
+int outq_open(outq_t *q, const outq_cfg_t *cfg);
+
+/** Release the queue.
+ * Messages held in a spill file remain there for a later outq_open().
+ * @param q The queue to destroy.
+ */
+void outq_destroy(outq_t *q);
+
+/** Send a message, or hold it if it cannot be sent now.
+ * A message is sent directly only if nothing of the same or a more urgent
+ * class is already held and the rate limit allows, so that delivery order
+ * within a class is kept.
+ * @param q The queue.
+ * @param mif The messaging interface to send with.
+ * @param data The serialized message, which is not consumed.
+ * @param dest The destination of the message.
+ * @param prio The priority class of the message.
+ * @param count The number of items in the message.
+ * @param queued The time the message contents were first queued, from
+ * which queueing delay is measured.
+ * @return AMP_OK if sent, AMP_FAIL if held, or AMP_SYSERR if dropped.
+ */
+int outq_send(outq_t *q, mif_cfg_t *mif, const blob_t *data, const eid_t *dest,
+              amp_prio_e prio, uint32_t count, OS_time_t queued);
+
+/** Send as many held messages as the transport will take.
+ * Nothing is attempted before outq_next_try().
+ * @param q The queue.
+ * @param mif The messaging interface to send with.
+ * @return The sum of the counts of the messages sent.
+ */
+uint32_t outq_drain(outq_t *q, mif_cfg_t *mif);
+
+/** Get the time at which held messages should next be sent.
+ * @param q The queue.
+ * @return The retry time, which may be in the past, or OS_TIME_MAX if
+ * nothing is held or the link is closed.
+ */
+OS_time_t outq_next_try(outq_t *q);
+
+/** Mark the link open or closed.
+ * Opening the link allows an immediate send attempt.
+ * @param q The queue.
+ * @param open The new link state.
+ */
+void outq_set_link(outq_t *q, bool open);
+
+/** Get the number of held messages.
+ * @param q The queue.
+ */
+uint32_t outq_size(outq_t *q);
+
+/** Get the held payload size.
+ * @param q The queue.
+ */
+uint64_t outq_bytes(outq_t *q);
+
+/** Get the number of messages to a destination dropped unsent, so that a
+ * sender of incremental state can tell when to send it whole again.
+ * @param q The queue.
+ * @param dest The destination.
+ */
+uint64_t outq_dropped(outq_t *q, const eid_t *dest);
+
+/** Get the statistics of a priority class.
+ * @param q The queue.
+ * @param prio The class.
+ * @param[out] stats The statistics.
+ * @return AMP_OK if successful.
+ */
+int outq_get_stats(outq_t *q, amp_prio_e prio, outq_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRC_AGENT_OUTQ_H_ */
@@ -52,6 +52,7 @@
 #include "shared/primitives/time.h"
 
 #include "../shared/utils/utils.h"
+#include "../shared/utils/trace.h"
 #include "instr.h"
 #include "../shared/primitives/expr.h"
 
@@ -65,6 +66,7 @@
 
 
 agent_db_t gAgentDb;
+__thread agent_db_t *gAgentDbInst = &gAgentDb;
 
 /** Context for active rule scanning. */
 typedef struct
@@ -75,6 +77,27 @@ typedef struct
   vector_t *vec;
 } rda_scan_context_t;
 
+static void rda_tbl_sent_cb_del_fn(void *item)
+{
+  rda_tbl_sent_t *sent = item;
+
+  CHKVOID(sent);
+  ari_release(sent->id, 1);
+  tbl_release(sent->last, 1);
+  SRELEASE(sent);
+}
+
+/* Make an instance the one this thread uses and return the one it used
+ * before. NULL selects &gAgentDb.
+ */
+agent_db_t *rda_select(agent_db_t *db)
+{
+  agent_db_t *prev = gAgentDbInst;
+
+  gAgentDbInst = (db != NULL) ? db : &gAgentDb;
+  return prev;
+}
+
 /******************************************************************************
  *
  * \par Function Name: rda_cleanup
@@ -96,38 +119,47 @@ typedef struct
 
 void rda_cleanup()
 {
-        vec_release(&(gAgentDb.rpt_msgs), 0);
-        vec_release(&(gAgentDb.tbl_msgs), 0);
-        vec_release(&(gAgentDb.tbrs), 0);
-        vec_release(&(gAgentDb.sbrs), 0);
+        vec_release(&(gAgentDbInst->rpt_msgs), 0);
+        vec_release(&(gAgentDbInst->tbl_msgs), 0);
+        vec_release(&(gAgentDbInst->tbls_sent), 0);
+        vec_release(&(gAgentDbInst->tbrs), 0);
+        vec_release(&(gAgentDbInst->sbrs), 0);
+        outq_destroy(&(gAgentDbInst->outq));
 }
 
 int rda_init()
 {
         int success;
 
-        gAgentDb.rpt_msgs = vec_create(RDA_DEF_NUM_RPTS, msg_rpt_cb_del_fn, NULL, NULL, 0, &success);
-        gAgentDb.tbl_msgs = vec_create(RDA_DEF_NUM_TBLS, msg_tbl_cb_del_fn, NULL, NULL, 0, &success);
+        gAgentDbInst->rpt_msgs = vec_create(RDA_DEF_NUM_RPTS, msg_rpt_cb_del_fn, NULL, NULL, 0, &success);
+        gAgentDbInst->tbl_msgs = vec_create(RDA_DEF_NUM_TBLS, msg_tbl_cb_del_fn, NULL, NULL, 0, &success);
+        gAgentDbInst->tbls_sent = vec_create(RDA_DEF_NUM_TBLS, rda_tbl_sent_cb_del_fn, NULL, NULL, 0, &success);
+
+        gAgentDbInst->tbrs = vec_create(RDA_DEF_NUM_TBRS, NULL, NULL, NULL, 0, &success);
+        gAgentDbInst->sbrs = vec_create(RDA_DEF_NUM_SBRS, NULL, NULL, NULL, 0, &success);
 
-        gAgentDb.tbrs = vec_create(RDA_DEF_NUM_TBRS, NULL, NULL, NULL, 0, &success);
-        gAgentDb.sbrs = vec_create(RDA_DEF_NUM_SBRS, NULL, NULL, NULL, 0, &success);
+        if(success == AMP_OK)
+        {
+                success = outq_init(&(gAgentDbInst->outq));
+        }
 
         return success;
 }
 
 void rda_signal_shutdown()
 {
-  vector_t *vec = &(gVDB.ctrls);
-  pthread_mutex_lock(&vec->lock);
-  pthread_cond_broadcast(&vec->cond_ins_mod);
-  pthread_mutex_unlock(&vec->lock);
+  timeq_t *queue = &(gVDBInst->ctrls);
+  pthread_mutex_lock(&queue->lock);
+  pthread_cond_broadcast(&queue->cond_head);
+  pthread_mutex_unlock(&queue->lock);
 
-  rhht_t *ht = &(gVDB.rules);
+  vector_t *vec;
+  rhht_t *ht = &(gVDBInst->rules);
   pthread_mutex_lock(&ht->lock);
   pthread_cond_broadcast(&ht->cond_ins_mod);
   pthread_mutex_unlock(&ht->lock);
 
-  vec = &(gAgentDb.rpt_msgs);
+  vec = &(gAgentDbInst->rpt_msgs);
   pthread_mutex_lock(&vec->lock);
   pthread_cond_broadcast(&vec->cond_ins_mod);
   pthread_mutex_unlock(&vec->lock);
@@ -162,6 +194,7 @@ msg_rpt_t *rda_get_msg_rpt(eid_t recipient)
         vecit_t it;
         int success;
         msg_rpt_t *msg_rpt;
+        const uint8_t prio = lcc_get_class();
 
     AMP_DEBUG_ENTRY("rda_get_report","(%s)", recipient.name);
 
@@ -173,12 +206,16 @@ msg_rpt_t *rda_get_msg_rpt(eid_t recipient)
     }
 
     /* Step 1: See if we already have a report message going to
-     * that recipient. If so, return it.
+     * that recipient in the current class. If so, return it.
      */
-    for(it = vecit_first(&(gAgentDb.rpt_msgs)); vecit_valid(it); it = vecit_next(it))
+    for(it = vecit_first(&(gAgentDbInst->rpt_msgs)); vecit_valid(it); it = vecit_next(it))
     {
         msg_rpt_t *cur = vecit_data(it);
 
+        if(cur->prio != prio)
+        {
+                continue;
+        }
         vec_find(&(cur->rx), recipient.name, &success);
         if(success == AMP_OK)
         {
@@ -189,7 +226,9 @@ msg_rpt_t *rda_get_msg_rpt(eid_t recipient)
     /* Step 2; If we get here, create a new report for that recipient. */
     if((msg_rpt = msg_rpt_create(recipient.name)) != NULL)
     {
-        if(vec_push(&(gAgentDb.rpt_msgs), msg_rpt) != VEC_OK)
+        msg_rpt->prio = prio;
+        OS_GetLocalTime(&(msg_rpt->created));
+        if(vec_push(&(gAgentDbInst->rpt_msgs), msg_rpt) != VEC_OK)
         {
                 msg_rpt_release(msg_rpt, 1);
                 return NULL;
@@ -226,6 +265,7 @@ msg_tbl_t *rda_get_msg_tbl(eid_t recipient)
 {
     vecit_t it;
     msg_tbl_t *msg_tbl;
+    const uint8_t prio = lcc_get_class();
 
     AMP_DEBUG_ENTRY("rda_get_msg_tbl","(%s)", recipient.name);
 
@@ -239,11 +279,15 @@ msg_tbl_t *rda_get_msg_tbl(eid_t recipient)
     /* Step 1: See if we already have a report message going to
      * that recipient. If so, return it.
      */
-    for(it = vecit_first(&(gAgentDb.tbl_msgs)); vecit_valid(it); it = vecit_next(it))
+    for(it = vecit_first(&(gAgentDbInst->tbl_msgs)); vecit_valid(it); it = vecit_next(it))
     {
         int success;
         msg_tbl_t *cur = vecit_data(it);
 
+        if(cur->prio != prio)
+        {
+            continue;
+        }
         vec_find(&(cur->rx), recipient.name, &success);
         if(success == AMP_OK)
         {
@@ -254,7 +298,9 @@ msg_tbl_t *rda_get_msg_tbl(eid_t recipient)
     /* Step 2; If we get here, create a new report for that recipient. */
     if((msg_tbl = msg_tbl_create(recipient.name)) != NULL)
     {
-        if(vec_push(&(gAgentDb.tbl_msgs), msg_tbl) != VEC_OK)
+        msg_tbl->prio = prio;
+        OS_GetLocalTime(&(msg_tbl->created));
+        if(vec_push(&(gAgentDbInst->tbl_msgs), msg_tbl) != VEC_OK)
         {
             msg_tbl_release(msg_tbl, 1);
             return NULL;
@@ -265,23 +311,190 @@ msg_tbl_t *rda_get_msg_tbl(eid_t recipient)
 }
 
 
-OS_time_t rda_earliest_ctrl()
+/* Finds, or starts, the record of tables sent to a recipient from a template. */
+static rda_tbl_sent_t *rda_get_tbl_sent(eid_t recipient, ari_t *id)
 {
-  OS_time_t earliest = OS_TIME_MAX;
-  vecit_t it;
+    vecit_t it;
+    rda_tbl_sent_t *sent;
 
-  vec_lock(&(gVDB.ctrls));
-  for(it = vecit_first(&(gVDB.ctrls)); vecit_valid(it); it = vecit_next(it))
-  {
-    ctrl_t *ctrl = vecit_data(it);
-    if(ctrl == NULL)
+    for(it = vecit_first(&(gAgentDbInst->tbls_sent)); vecit_valid(it); it = vecit_next(it))
     {
-      continue;
+        sent = vecit_data(it);
+        if((strcmp(sent->recipient.name, recipient.name) == 0) && (ari_compare(sent->id, id, 1) == 0))
+        {
+            return sent;
+        }
     }
-    earliest = TimeMin(earliest, ctrl->start);
-  }
-  vec_unlock(&(gVDB.ctrls));
-  return earliest;
+
+    if((sent = STAKE(sizeof(rda_tbl_sent_t))) == NULL)
+    {
+        return NULL;
+    }
+    sent->recipient = recipient;
+
+    if(((sent->id = ari_copy_ptr(id)) == NULL) || (vec_push(&(gAgentDbInst->tbls_sent), sent) != VEC_OK))
+    {
+        AMP_DEBUG_WARN("rda_get_tbl_sent", "Too many incremental tables, sending whole.", NULL);
+        rda_tbl_sent_cb_del_fn(sent);
+        return NULL;
+    }
+
+    return sent;
+}
+
+/* Forgets the tables a recipient has, after a message to it was lost. */
+static void rda_tbl_sent_lost(eid_t *recipient)
+{
+    vecit_t it;
+
+    vec_lock(&(gAgentDbInst->tbls_sent));
+    for(it = vecit_first(&(gAgentDbInst->tbls_sent)); vecit_valid(it); it = vecit_next(it))
+    {
+        rda_tbl_sent_t *sent = vecit_data(it);
+        if(strcmp(sent->recipient.name, recipient->name) == 0)
+        {
+            tbl_release(sent->last, 1);
+            sent->last = NULL;
+        }
+    }
+    vec_unlock(&(gAgentDbInst->tbls_sent));
+}
+
+
+/******************************************************************************
+ *
+ * \par Function Name: rda_add_tbl
+ *
+ * \par Purpose: Builds a table and adds it to the table set for a recipient.
+ *               A table from an incremental template is added as the rows
+ *               changed since the table last sent to that recipient.
+ *
+ * \param[in]  recipient  The recipient of the table.
+ * \param[in]  def        The table template.
+ * \param[in]  id         The ID of the table, which may carry parameters.
+ *
+ * \par Notes:
+ *  - The whole table is sent first, and again after TBL_DELTA_MAX_CHAIN
+ *    deltas, so that a recipient which missed a delta catches up.
+ *  - It is also sent whole after the outbound queue drops any message to
+ *    the recipient, which may have held the delta the next one applies to.
+ *
+ * \return AMP Status Code
+ *****************************************************************************/
+
+int rda_add_tbl(eid_t recipient, tblt_t *def, ari_t *id)
+{
+    msg_tbl_t *msg_tbl;
+    rda_tbl_sent_t *sent = NULL;
+    tbl_delta_t *delta = NULL;
+    tbl_t *tbl = NULL;
+    uint64_t version = 0;
+    uint64_t dropped = 0;
+    int whole = 0;
+    int result = AMP_FAIL;
+
+    CHKUSR(def, AMP_FAIL);
+    CHKUSR(id, AMP_FAIL);
+
+    if((msg_tbl = rda_get_msg_tbl(recipient)) == NULL)
+    {
+        return AMP_FAIL;
+    }
+
+    vec_lock(&(gAgentDbInst->tbls_sent));
+
+    if(def->key != 0)
+    {
+        sent = rda_get_tbl_sent(recipient, id);
+    }
+    if(sent != NULL)
+    {
+        dropped = outq_dropped(&(gAgentDbInst->outq), &recipient);
+        if((sent->last != NULL) && (dropped != sent->dropped))
+        {
+            tbl_release(sent->last, 1);
+            sent->last = NULL;
+        }
+    }
+
+    if(def->version != NULL)
+    {
+        version = def->version(id);
+    }
+
+    /* Step 1: Find the changes, building the table only if it may have any. */
+    if((sent != NULL) && (sent->last != NULL) && (def->version != NULL) && (version == sent->version) &&
+       (sent->num_deltas < TBL_DELTA_MAX_CHAIN))
+    {
+        delta = tbl_delta_create(sent->last, sent->last, def->key);
+    }
+    else if((tbl = def->build(id)) == NULL)
+    {
+        AMP_DEBUG_ERR("rda_add_tbl", "Cannot build table.", NULL);
+    }
+    else if(sent != NULL)
+    {
+        if((sent->last != NULL) && (sent->num_deltas < TBL_DELTA_MAX_CHAIN))
+        {
+            delta = tbl_delta_create(sent->last, tbl, def->key);
+        }
+        else
+        {
+            delta = tbl_delta_create(NULL, tbl, def->key);
+            whole = 1;
+        }
+    }
+
+    /* Step 2: Add the delta and remember the table, or add the table. */
+    if(delta != NULL)
+    {
+        /* A whole table starts a new chain, which needs nothing before it. */
+        delta->base = whole ? 0 : sent->seq;
+        delta->seq = (sent->seq == UINT32_MAX) ? 1 : sent->seq + 1;
+
+        if((result = msg_tbl_add_delta(msg_tbl, delta)) == AMP_OK)
+        {
+            sent->seq = delta->seq;
+            sent->num_deltas = (delta->base == 0) ? 0 : sent->num_deltas + 1;
+            sent->version = version;
+            sent->dropped = dropped;
+            if(tbl != NULL)
+            {
+                tbl_release(sent->last, 1);
+                sent->last = tbl;
+                tbl = NULL;
+            }
+        }
+        else
+        {
+            tbl_delta_release(delta, 1);
+        }
+    }
+    else if(tbl != NULL)
+    {
+        /* Keys which aren't unique can't be tracked. Start again after this. */
+        if(sent != NULL)
+        {
+            tbl_release(sent->last, 1);
+            sent->last = NULL;
+        }
+
+        if((result = msg_tbl_add_tbl(msg_tbl, tbl)) == AMP_OK)
+        {
+            tbl = NULL;
+        }
+    }
+
+    vec_unlock(&(gAgentDbInst->tbls_sent));
+
+    tbl_release(tbl, 1);
+    return result;
+}
+
+
+OS_time_t rda_earliest_ctrl()
+{
+  return timeq_next(&(gVDBInst->ctrls));
 }
 
 
@@ -303,36 +516,25 @@ OS_time_t rda_earliest_ctrl()
  *****************************************************************************/
 int rda_process_ctrls(OS_time_t nowtime)
 {
-        vec_idx_t i;
-        ctrl_t *ctrl;
-    vecit_t it;
-
-        vec_lock(&(gVDB.ctrls));
-    for(i = 0, it = vecit_first(&(gVDB.ctrls)); vecit_valid(it); it = vecit_next(it),i++)
-        {
-        ctrl = vecit_data(it);
-
-                if(ctrl != NULL)
-                {
-                        if(TimeCompare(nowtime, ctrl->start) >= 0)
-                        {
-                                lcc_run_ctrl(ctrl, NULL);
-//                                db_forget(&(ctrl->desc), gDB.ctrls);
+    ctrl_t *ctrl;
 
-                                /* Don't access ctrl after this call...*/
-                                vec_del(&(gVDB.ctrls), i);
-                        }
-                }
-        }
-        vec_unlock(&(gVDB.ctrls));
-        return AMP_OK;
+    /* Controls come off the queue in start order, so stop at the first
+     * one not yet due. The queue is not locked while a control runs.
+     */
+    while((ctrl = timeq_pop_due(&(gVDBInst->ctrls), nowtime)) != NULL)
+    {
+        lcc_run_ctrl(ctrl, NULL);
+        db_forget(&(ctrl->desc));
+        ctrl_release(ctrl, 1);
+    }
+    return AMP_OK;
 }
 
-
 void* rda_ctrls(void *arg)
 {
   nmagent_t *agent = arg;
   bool running = true;
+  nmagent_select(agent);
 #ifndef mingw
     AMP_DEBUG_ENTRY("rda_ctrls","(0x%X)", (unsigned long) pthread_self()); //threadId);
 #endif
@@ -344,9 +546,9 @@ void* rda_ctrls(void *arg)
     {
         OS_time_t nowtime;
 
-        if (pthread_mutex_lock(&gVDB.ctrls.lock))
+        if (pthread_mutex_lock(&gVDBInst->ctrls.lock))
         {
-          AMP_DEBUG_ERR("rda_ctrls", "failed mutex %d lock", gVDB.ctrls.lock);
+          AMP_DEBUG_ERR("rda_ctrls", "failed mutex %d lock", gVDBInst->ctrls.lock);
           return NULL;
         }
         if (!daemon_run_get(&agent->running))
@@ -369,15 +571,16 @@ void* rda_ctrls(void *arg)
             AMP_DEBUG_INFO("rda_ctrls", "sleeping up to %lld", delta.ticks);
 
             const struct timespec abstime = TimeToTimespec(next_ctrl);
-            ret = pthread_cond_timedwait(&gVDB.ctrls.cond_ins_mod, &gVDB.ctrls.lock, &abstime);
+            // only woken early if the earliest ctrl changes
+            ret = pthread_cond_timedwait(&gVDBInst->ctrls.cond_head, &gVDBInst->ctrls.lock, &abstime);
             // return may have been earlier than the timeout
             OS_GetLocalTime(&nowtime);
             AMP_DEBUG_INFO("rda_ctrls", "running at %lld from %d (%s)", nowtime.ticks, ret, strerror(ret));
           }
         }
-        if (pthread_mutex_unlock(&gVDB.ctrls.lock))
+        if (pthread_mutex_unlock(&gVDBInst->ctrls.lock))
         {
-          AMP_DEBUG_ERR("rda_ctrls", "failed mutex %p unlock", &gVDB.ctrls.lock);
+          AMP_DEBUG_ERR("rda_ctrls", "failed mutex %p unlock", &gVDBInst->ctrls.lock);
           return NULL;
         }
 
@@ -499,7 +702,7 @@ OS_time_t rda_earliest_rule()
 {
   OS_time_t earliest = OS_TIME_MAX;
 
-  rhht_foreach(&(gVDB.rules), rda_scan_earliest_rule, &earliest);
+  rhht_foreach(&(gVDBInst->rules), rda_scan_earliest_rule, &earliest);
 
   return earliest;
 }
@@ -524,6 +727,15 @@ OS_time_t rda_earliest_rule()
  *  10/05/18  E. Birrane     Updated to AMP v0.5.
  *****************************************************************************/
 
+/* Record how long after it was due a rule is run. */
+static void rda_rule_lag(rule_t *rule, OS_time_t nowtime)
+{
+    int64_t lag_us = OS_TimeGetTotalMicroseconds(OS_TimeSubtract(nowtime, rule->eval_at));
+
+    NM_TRACE3(rule__due, rule, rule->id.type, lag_us);
+    agent_instr_lat_record(AGENT_INSTR_LAT_RULE_LAG, (lag_us > 0) ? lag_us : 0);
+}
+
 int rda_process_rules(OS_time_t nowtime)
 {
     vecit_t it;
@@ -531,22 +743,26 @@ int rda_process_rules(OS_time_t nowtime)
     rda_scan_context_t ctx;
     ctx.nowtime = nowtime;
 
-    pthread_mutex_lock(&gVDB.rules.lock);
+    pthread_mutex_lock(&gVDBInst->rules.lock);
 
-    ctx.vec = &(gAgentDb.tbrs);
-    rhht_foreach(&(gVDB.rules), rda_scan_tbrs_cb, &ctx);
+    ctx.vec = &(gAgentDbInst->tbrs);
+    rhht_foreach(&(gVDBInst->rules), rda_scan_tbrs_cb, &ctx);
 
-    ctx.vec = &(gAgentDb.sbrs);
-    rhht_foreach(&(gVDB.rules), rda_scan_sbrs_cb, &ctx);
+    ctx.vec = &(gAgentDbInst->sbrs);
+    rhht_foreach(&(gVDBInst->rules), rda_scan_sbrs_cb, &ctx);
 
-    AMP_DEBUG_INFO("rda_process_rules","Checking %d TBRs.", vec_num_entries_ptr(&(gAgentDb.tbrs)));
-    for(it = vecit_first(&(gAgentDb.tbrs)); vecit_valid(it); it = vecit_next(it))
+    AMP_DEBUG_INFO("rda_process_rules","Checking %d TBRs.", vec_num_entries_ptr(&(gAgentDbInst->tbrs)));
+    for(it = vecit_first(&(gAgentDbInst->tbrs)); vecit_valid(it); it = vecit_next(it))
     {
         rule_t *rule = vecit_data(it);
 
-                gAgentInstr.num_tbrs_run++;
+                rda_rule_lag(rule, ctx.nowtime);
+                agent_instr_inc(AGENT_INSTR_TBRS_RUN);
+                NM_TRACE3(rule__fire, rule, rule->id.type, rule->num_fire + 1);
 
+        uint8_t prev_class = lcc_set_class(rule->prio);
         lcc_run_ac(&(rule->action), &(rule->id.as_reg.parms));
+        lcc_set_class(prev_class);
 
                 rule->num_eval++;
                 rule->num_fire++;
@@ -554,16 +770,16 @@ int rda_process_rules(OS_time_t nowtime)
                 if(rule->num_fire >= rule->def.as_tbr.max_fire && rule->def.as_tbr.max_fire != 0)
                 {
                         /* Remove the rule. */
-//                        db_forget(&(rule->desc), gDB.rules);
+                        db_forget(&(rule->desc));
                         RULE_CLEAR_ACTIVE(rule->flags);
                         VDB_DELKEY_RULE(&(rule->id));
-                        gAgentInstr.num_tbrs--;
+                        agent_instr_dec(AGENT_INSTR_TBRS);
                 }
                 else
                 {
                         
                         rule->eval_at = OS_TimeAdd(ctx.nowtime, rule->def.as_tbr.period);
-                        if(db_persist_rule(rule) != AMP_OK)
+                        if(db_persist_rule_state(rule) != AMP_OK)
                         {
                                 AMP_DEBUG_ERR("rda_process_rules", "Unable to persist new TBR state.", NULL);
                         }
@@ -571,36 +787,44 @@ int rda_process_rules(OS_time_t nowtime)
     }
 
 
-    AMP_DEBUG_INFO("rda_process_rules","Checking %d SBRs.", vec_num_entries_ptr(&(gAgentDb.sbrs)));
-    for(it = vecit_first(&(gAgentDb.sbrs)); vecit_valid(it); it = vecit_next(it))
+    AMP_DEBUG_INFO("rda_process_rules","Checking %d SBRs.", vec_num_entries_ptr(&(gAgentDbInst->sbrs)));
+    for(it = vecit_first(&(gAgentDbInst->sbrs)); vecit_valid(it); it = vecit_next(it))
     {
         rule_t *rule = (rule_t*) vecit_data(it);
 
+        rda_rule_lag(rule, ctx.nowtime);
         rule->num_eval++;
         rule->eval_at = OS_TimeAdd(rule->eval_at, OS_TimeAssembleFromMilliseconds(1, 0)); // check again in 1s
         if(sbr_should_fire(rule))
         {
-                gAgentInstr.num_sbrs_run++;
+                agent_instr_inc(AGENT_INSTR_SBRS_RUN);
+                NM_TRACE3(rule__fire, rule, rule->id.type, rule->num_fire + 1);
 
+                uint8_t prev_class = lcc_set_class(rule->prio);
                 lcc_run_ac(&(rule->action), &(rule->id.as_reg.parms));
+                lcc_set_class(prev_class);
 
                 rule->num_fire++;
+                db_persist_rule_state(rule);
         }
 
         if((rule->num_eval >= rule->def.as_sbr.max_eval && rule->def.as_sbr.max_eval != 0) ||
            (rule->num_fire >= rule->def.as_sbr.max_fire && rule->def.as_sbr.max_fire != 0))
         {
                 /* Remove the rule. */
-//                db_forget(&(rule->desc), gDB.rules);
+                db_forget(&(rule->desc));
                 VDB_DELKEY_RULE(&(rule->id));
-                gAgentInstr.num_sbrs--;
+                agent_instr_dec(AGENT_INSTR_SBRS);
         }
     }
 
-    vec_clear(&(gAgentDb.sbrs));
-    vec_clear(&(gAgentDb.tbrs));
+    vec_clear(&(gAgentDbInst->sbrs));
+    vec_clear(&(gAgentDbInst->tbrs));
+
+    pthread_mutex_unlock(&gVDBInst->rules.lock);
 
-    pthread_mutex_unlock(&gVDB.rules.lock);
+    /* Commit this pass's rule updates, and any others, together. */
+    db_sync();
 
     AMP_DEBUG_EXIT("rda_eval_pending_rules","-> 0", NULL);
     return AMP_OK;
@@ -608,12 +832,60 @@ int rda_process_rules(OS_time_t nowtime)
 
 
 
+/* Send, or hold, one report or table set message to each of its recipients. */
+static uint32_t rda_send_msg(nmagent_t *agent, int msg_type, void *msg, vector_t *rx_vec,
+                             uint8_t prio, uint32_t count, OS_time_t created, OS_time_t nowtime)
+{
+    vecit_t it;
+    uint32_t sent = 0;
+
+    for(it = vecit_first(rx_vec); vecit_valid(it); it = vecit_next(it))
+    {
+        char *rx = vecit_data(it);
+        blob_t *data;
+
+        if(rx == NULL)
+        {
+            AMP_DEBUG_ERR("rda_send_msg", "NULL rx", NULL);
+            continue;
+        }
+        eid_t destination;
+        strncpy(destination.name, rx, AMP_MAX_EID_LEN);
+
+        uint64_t start_us = utils_now_us();
+        if((data = mif_serialize_msg(msg_type, msg, amp_tv_from_ctime(nowtime, NULL))) == NULL)
+        {
+            AMP_DEBUG_ERR("rda_send_msg", "Error serializing message to %s", rx);
+            rda_tbl_sent_lost(&destination);
+            continue;
+        }
+
+        /* Send, or hold until the transport and rate limit allow it. */
+        switch(outq_send(&(gAgentDbInst->outq), &agent->mif, data, &destination, prio, count, created))
+        {
+            case AMP_OK:
+                sent += count;
+                break;
+            case AMP_FAIL:
+                AMP_DEBUG_INFO("rda_send_msg", "Holding class %d message to %s", prio, rx);
+                break;
+            default:
+                AMP_DEBUG_ERR("rda_send_msg", "Error sending message to %s", rx);
+                break;
+        }
+        AGENT_INSTR_LAT_SINCE(AGENT_INSTR_LAT_RPT_SEND, start_us);
+        blob_release(data, 1);
+    }
+
+    return sent;
+}
+
 /******************************************************************************
  *
  * \par Function Name: rda_send_reports
  *
- * \par Purpose: For each report constructed during this evaluation period,
- *               create a message and send it.
+ * \par Purpose: For each report and table set constructed during this
+ *               evaluation period, create a message and send it.
  *
  * \retval int -  0 : Success
  *               -1 : Failure
@@ -623,7 +895,8 @@ int rda_process_rules(OS_time_t nowtime)
  *                per recipient. By the time we get to this function, we should have
  *                one report per recipient, so making one message per report should
  *                not result in multiple messages to the same recipient.
- *
+ *              - Reports are combined per recipient within a priority class
+ *                only, and classes are sent most urgent first.
  *
  * Modification History:
  *  MM/DD/YY  AUTHOR         DESCRIPTION
@@ -635,72 +908,103 @@ int rda_process_rules(OS_time_t nowtime)
 
 int rda_send_reports(nmagent_t *agent)
 {
-    vecit_t it1;
-    vecit_t it2;
+    vecit_t it;
     OS_time_t nowtime;
     OS_GetLocalTime(&nowtime);
     unsigned long num_rpts = 0;
+    unsigned long num_tbls = 0;
 
     AMP_DEBUG_ENTRY("rda_send_reports","()", NULL);
 
+    /* Step 1: Anything held from earlier that may now go. */
+    num_rpts += outq_drain(&(gAgentDbInst->outq), &agent->mif);
 
-    vec_lock(&(gAgentDb.rpt_msgs));
+    vec_lock(&(gAgentDbInst->rpt_msgs));
+    vec_lock(&(gAgentDbInst->tbl_msgs));
 
-    for(it1 = vecit_first(&(gAgentDb.rpt_msgs)); vecit_valid(it1); it1 = vecit_next(it1))
+    /* Step 2: New messages, most urgent class first. */
+    for(int prio = 0; prio < AMP_NUM_PRIO; ++prio)
     {
-        msg_rpt_t *msg_rpt = (msg_rpt_t*)vecit_data(it1);
-
-        if(msg_rpt == NULL)
+        for(it = vecit_first(&(gAgentDbInst->rpt_msgs)); vecit_valid(it); it = vecit_next(it))
         {
+            msg_rpt_t *msg_rpt = (msg_rpt_t*)vecit_data(it);
+
+            if((msg_rpt == NULL) || (msg_rpt->prio != prio))
+            {
                 continue;
-        }
-        if (vec_num_entries(msg_rpt->rpts) < 1)
-        {
-            AMP_DEBUG_WARN("rda_send_reports", "Vector has no reports");
-            continue;
+            }
+            if (vec_num_entries(msg_rpt->rpts) < 1)
+            {
+                AMP_DEBUG_WARN("rda_send_reports", "Vector has no reports");
+                continue;
+            }
+            num_rpts += rda_send_msg(agent, MSG_TYPE_RPT_SET, msg_rpt, &(msg_rpt->rx), prio,
+                                     vec_num_entries(msg_rpt->rpts), msg_rpt->created, nowtime);
         }
 
-        for(it2 = vecit_first(&(msg_rpt->rx)); vecit_valid(it2); it2 = vecit_next(it2))
+        for(it = vecit_first(&(gAgentDbInst->tbl_msgs)); vecit_valid(it); it = vecit_next(it))
         {
-                char *rx = vecit_data(it2);
+            msg_tbl_t *msg_tbl = (msg_tbl_t*)vecit_data(it);
 
-                if(rx == NULL)
-                {
-                        AMP_DEBUG_ERR("rda_send_reports", "NULL rx", NULL);
-                        continue;
-                }
-                eid_t destination;
-                strncpy(destination.name, rx, AMP_MAX_EID_LEN);
-                if(mif_send_msg(&agent->mif, MSG_TYPE_RPT_SET, msg_rpt, &destination, amp_tv_from_ctime(nowtime, NULL)) == AMP_OK)
-                {
-                        num_rpts += vec_num_entries(msg_rpt->rpts);
-                }
-                else
-                {
-                        AMP_DEBUG_ERR("rda_send_reports", "Error sending reports to %s", rx);
-                }
+            if((msg_tbl == NULL) || (msg_tbl->prio != prio))
+            {
+                continue;
+            }
+            if(vec_num_entries(msg_tbl->tbls) > 0)
+            {
+                num_tbls += rda_send_msg(agent, MSG_TYPE_TBL_SET, msg_tbl, &(msg_tbl->rx), prio,
+                                         vec_num_entries(msg_tbl->tbls), msg_tbl->created, nowtime);
+            }
+            if(vec_num_entries(msg_tbl->deltas) > 0)
+            {
+                num_tbls += rda_send_msg(agent, MSG_TYPE_TBL_DELTA, msg_tbl, &(msg_tbl->rx), prio,
+                                         vec_num_entries(msg_tbl->deltas), msg_tbl->created, nowtime);
+            }
         }
-        /* FIXME: cleanup belongs in the vector state
-        msg_rpt_release(msg_rpt, 1);
-        */
     }
-    AMP_DEBUG_INFO("rda_send_reports","Sent %u reports", num_rpts);
-    gAgentInstr.num_sent_rpts += num_rpts;
+    AMP_DEBUG_INFO("rda_send_reports","Sent %lu reports and %lu tables", num_rpts, num_tbls);
+    agent_instr_add(AGENT_INSTR_SENT_RPTS, num_rpts);
+    agent_instr_add(AGENT_INSTR_SENT_TBLS, num_tbls);
 
-    /* Sent successfully or not, clear the reports. */
-    vec_clear(&(gAgentDb.rpt_msgs));
+    /* Every message is now either sent or held, so clear them. */
+    vec_clear(&(gAgentDbInst->tbl_msgs));
+    vec_clear(&(gAgentDbInst->rpt_msgs));
 
-    vec_unlock(&(gAgentDb.rpt_msgs));
+    vec_unlock(&(gAgentDbInst->tbl_msgs));
+    vec_unlock(&(gAgentDbInst->rpt_msgs));
 
     AMP_DEBUG_EXIT("rda_send_reports","()", NULL);
     return AMP_OK;
 }
 
 
+/******************************************************************************
+ *
+ * \par Function Name: rda_set_link
+ *
+ * \par Purpose: Tell the agent whether the link to its managers is usable,
+ *               for example at the start and end of a contact window.
+ *               While closed, reports are held rather than sent. Opening
+ *               the link sends anything held without waiting for a retry.
+ *
+ * \param[in]  open  The new link state.
+ *****************************************************************************/
+
+void rda_set_link(bool open)
+{
+  outq_set_link(&(gAgentDbInst->outq), open);
+
+  pthread_mutex_lock(&(gAgentDbInst->rpt_msgs.lock));
+  pthread_cond_broadcast(&(gAgentDbInst->rpt_msgs.cond_ins_mod));
+  pthread_mutex_unlock(&(gAgentDbInst->rpt_msgs.lock));
+}
+
+
 void* rda_reports(void *arg)
 {
     nmagent_t *agent = arg;
     bool running = true;
+    nmagent_select(agent);
 #ifndef mingw
     AMP_DEBUG_ENTRY("rda_reports","(0x%"PRIxPTR")", pthread_self());
 #endif
@@ -710,9 +1014,9 @@ void* rda_reports(void *arg)
     /* While the DTNMP Agent is running...*/
     while(running)
     {
-      if (pthread_mutex_lock(&gAgentDb.rpt_msgs.lock))
+      if (pthread_mutex_lock(&gAgentDbInst->rpt_msgs.lock))
       {
-        AMP_DEBUG_ERR("rda_reports", "failed mutex %p lock", &gAgentDb.rpt_msgs.lock);
+        AMP_DEBUG_ERR("rda_reports", "failed mutex %p lock", &gAgentDbInst->rpt_msgs.lock);
         return NULL;
       }
       if (!daemon_run_get(&agent->running))
@@ -721,14 +1025,28 @@ void* rda_reports(void *arg)
         AMP_DEBUG_INFO("rda_reports","Daemon shutdown", NULL);
         running = false;
       }
-      if (running && (vec_num_entries_ptr(&gAgentDb.rpt_msgs) == 0))
+      if (running && (vec_num_entries_ptr(&gAgentDbInst->rpt_msgs) == 0)
+          && (vec_num_entries_ptr(&gAgentDbInst->tbl_msgs) == 0))
       {
-        AMP_DEBUG_INFO("rda_reports","Waiting for reports", NULL);
-        pthread_cond_wait(&gAgentDb.rpt_msgs.cond_ins_mod, &(gAgentDb.rpt_msgs.lock));
+        OS_time_t nowtime;
+        OS_GetLocalTime(&nowtime);
+        // Held reports are retried even if nothing new arrives
+        const OS_time_t next_try = outq_next_try(&(gAgentDbInst->outq));
+        if (TimeCompare(next_try, OS_TIME_MAX) == 0)
+        {
+          AMP_DEBUG_INFO("rda_reports","Waiting for reports", NULL);
+          pthread_cond_wait(&gAgentDbInst->rpt_msgs.cond_ins_mod, &(gAgentDbInst->rpt_msgs.lock));
+        }
+        else if (TimeCompare(next_try, nowtime) > 0)
+        {
+          AMP_DEBUG_INFO("rda_reports","Waiting for reports or retry", NULL);
+          const struct timespec abstime = TimeToTimespec(next_try);
+          pthread_cond_timedwait(&gAgentDbInst->rpt_msgs.cond_ins_mod, &(gAgentDbInst->rpt_msgs.lock), &abstime);
+        }
       }
-      if (pthread_mutex_unlock(&(gAgentDb.rpt_msgs.lock)))
+      if (pthread_mutex_unlock(&(gAgentDbInst->rpt_msgs.lock)))
       {
-        AMP_DEBUG_ERR("rda_reports", "failed mutex %p unlock", &(gAgentDb.rpt_msgs.lock));
+        AMP_DEBUG_ERR("rda_reports", "failed mutex %p unlock", &(gAgentDbInst->rpt_msgs.lock));
         return NULL;
       }
 
@@ -771,6 +1089,7 @@ void* rda_reports(void *arg)
 void* rda_rules(void *arg)
 {
   nmagent_t *agent = arg;
+  nmagent_select(agent);
 #ifndef mingw
     AMP_DEBUG_ENTRY("rda_rules","(0x%X)", (unsigned long) pthread_self()); //threadId);
 #endif
@@ -782,14 +1101,14 @@ void* rda_rules(void *arg)
     {
         OS_time_t nowtime;
 
-        if (pthread_mutex_lock(&(gVDB.rules.lock)))
+        if (pthread_mutex_lock(&(gVDBInst->rules.lock)))
         {
-          AMP_DEBUG_ERR("rda_rules", "failed mutex %p lock", &(gVDB.rules.lock));
+          AMP_DEBUG_ERR("rda_rules", "failed mutex %p lock", &(gVDBInst->rules.lock));
           return NULL;
         }
         if (!daemon_run_get(&agent->running))
         {
-          pthread_mutex_unlock(&(gVDB.rules.lock));
+          pthread_mutex_unlock(&(gVDBInst->rules.lock));
           break;
         }
 
@@ -804,14 +1123,14 @@ void* rda_rules(void *arg)
           AMP_DEBUG_INFO("rda_rules", "sleeping up to %lld", delta.ticks);
 
           const struct timespec abstime = TimeToTimespec(next_rule);
-          ret = pthread_cond_timedwait(&gVDB.rules.cond_ins_mod, &gVDB.rules.lock, &abstime);
+          ret = pthread_cond_timedwait(&gVDBInst->rules.cond_ins_mod, &gVDBInst->rules.lock, &abstime);
           // return may have been earlier than the timeout
           OS_GetLocalTime(&nowtime);
           AMP_DEBUG_INFO("rda_rules", "running at %lld from %d (%s)", nowtime.ticks, ret, strerror(ret));
         }
-        if (pthread_mutex_unlock(&(gVDB.rules.lock)))
+        if (pthread_mutex_unlock(&(gVDBInst->rules.lock)))
         {
-          AMP_DEBUG_ERR("rda_rules", "failed mutex %p unlock", &(gVDB.rules.lock));
+          AMP_DEBUG_ERR("rda_rules", "failed mutex %p unlock", &(gVDBInst->rules.lock));
           return NULL;
         }
 
@@ -825,3 +1144,54 @@ void* rda_rules(void *arg)
     AMP_DEBUG_ALWAYS("rda_rules","Shutting Down Remote Data Aggregator Thread.",NULL);
     return NULL;
 }
+
+
+/******************************************************************************
+ *
+ * \par Function Name: rda_step
+ *
+ * \par Purpose: Run the controls, rules and reports of this thread's agent
+ *               that are due now. This does the work of the rda_ctrls,
+ *               rda_rules and rda_reports threads for an agent run by a
+ *               pool, without waiting.
+ *
+ * \retval OS_time_t - When something is next due, or OS_TIME_MAX if
+ *                     nothing is scheduled.
+ *
+ * \param[in]  agent  The agent, which must be selected by this thread.
+ *****************************************************************************/
+
+OS_time_t rda_step(nmagent_t *agent)
+{
+    OS_time_t nowtime;
+    OS_time_t next;
+
+    OS_GetLocalTime(&nowtime);
+
+    if(TimeCompare(rda_earliest_ctrl(), nowtime) <= 0)
+    {
+        rda_process_ctrls(nowtime);
+    }
+
+    pthread_mutex_lock(&(gVDBInst->rules.lock));
+    next = rda_earliest_rule();
+    pthread_mutex_unlock(&(gVDBInst->rules.lock));
+    if(TimeCompare(next, nowtime) <= 0)
+    {
+        rda_process_rules(nowtime);
+    }
+
+    /* Controls and rules just run may have added reports. */
+    if((vec_num_entries_ptr(&(gAgentDbInst->rpt_msgs)) > 0)
+       || (vec_num_entries_ptr(&(gAgentDbInst->tbl_msgs)) > 0)
+       || (TimeCompare(outq_next_try(&(gAgentDbInst->outq)), nowtime) <= 0))
+    {
+        rda_send_reports(agent);
+    }
+
+    pthread_mutex_lock(&(gVDBInst->rules.lock));
+    next = rda_earliest_rule();
+    pthread_mutex_unlock(&(gVDBInst->rules.lock));
+    next = TimeMin(next, rda_earliest_ctrl());
+    return TimeMin(next, outq_next_try(&(gAgentDbInst->outq)));
+}
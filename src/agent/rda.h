@@ -41,6 +41,7 @@
 #include "../shared/primitives/report.h"
 #include "../shared/msg/msg.h"
 #include "nmagent.h"
+#include "outq.h"
 
 
 #ifdef __cplusplus
@@ -54,18 +55,43 @@ extern "C" {
 #define RDA_DEF_NUM_SBRS 8
 
 
+/**
+ * The last table sent to one recipient from an incremental table template,
+ * which the next table sent is a delta against.
+ */
+typedef struct
+{
+	eid_t recipient;
+	ari_t *id;           /* The ID of the tables. */
+	tbl_t *last;         /* As the recipient has it, or NULL. */
+	uint32_t seq;        /* Sequence number of last. */
+	uint32_t num_deltas; /* Deltas sent since the whole table. */
+	uint64_t version;    /* Template version when last was built. */
+	uint64_t dropped;    /* Messages to the recipient dropped by then. */
+} rda_tbl_sent_t;
+
 /*
+ * Reporting state of one agent instance.
  * TODO: Sort these vectors by time to execute.
  */
-typedef struct
+typedef struct agent_db_s
 {
 	vector_t rpt_msgs; /* of type (msg_rpt_t *)  */
 	vector_t tbl_msgs; /* of type (msg_tbl_t *)  */
+	vector_t tbls_sent; /* of type (rda_tbl_sent_t *) */
 	vector_t tbrs;    /* of type (rule_t *) */
 	vector_t sbrs;    /* of type (rule_t *) */
+	outq_t   outq;    /* Messages held until they can be sent */
 } agent_db_t;
 
+/** The process's own agent instance. */
 extern agent_db_t gAgentDb;
+/** The agent instance used by this thread, &gAgentDb unless changed by
+ * rda_select().
+ */
+extern __thread agent_db_t *gAgentDbInst;
+
+agent_db_t *rda_select(agent_db_t *db);
 
 int rda_init();
 
@@ -74,6 +100,7 @@ void         rda_cleanup();
 
 msg_rpt_t*   rda_get_msg_rpt(eid_t recipient);
 msg_tbl_t*   rda_get_msg_tbl(eid_t recipient);
+int          rda_add_tbl(eid_t recipient, tblt_t *def, ari_t *id);
 
 OS_time_t rda_earliest_ctrl();
 int rda_process_ctrls(OS_time_t nowtime);
@@ -88,9 +115,11 @@ void * rda_rules(void *arg);
 
 
 int          rda_send_reports(nmagent_t *agent);
-int          rda_send_tables(nmagent_t *agent);
+void         rda_set_link(bool open);
 void * rda_reports(void *arg);
 
+OS_time_t    rda_step(nmagent_t *agent);
+
 #ifdef __cplusplus
 }
 #endif
@@ -30,7 +30,7 @@
 #define _HAVE_AMP_AGENT_ADM_
 #ifdef _HAVE_AMP_AGENT_ADM_
 
-//vec_idx_t g_amp_agent_idx[11];
+//reg_idx_t g_amp_agent_idx[11];
 
 void amp_agent_init()
 {
@@ -58,96 +58,119 @@ void amp_agent_init()
 	amp_agent_init_tblt();
 }
 
+static const adm_desc_t amp_agent_meta_descs[] = {
+	ADM_DESC_CNST(ADM_META_IDX, AMP_AGENT_META_NAME, amp_agent_meta_name),
+	ADM_DESC_CNST(ADM_META_IDX, AMP_AGENT_META_NAMESPACE, amp_agent_meta_namespace),
+	ADM_DESC_CNST(ADM_META_IDX, AMP_AGENT_META_VERSION, amp_agent_meta_version),
+	ADM_DESC_CNST(ADM_META_IDX, AMP_AGENT_META_ORGANIZATION, amp_agent_meta_organization),
+};
+
 void amp_agent_init_meta()
 {
 
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_amp_agent_idx[ADM_META_IDX], AMP_AGENT_META_NAME), amp_agent_meta_name);
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_amp_agent_idx[ADM_META_IDX], AMP_AGENT_META_NAMESPACE), amp_agent_meta_namespace);
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_amp_agent_idx[ADM_META_IDX], AMP_AGENT_META_VERSION), amp_agent_meta_version);
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_amp_agent_idx[ADM_META_IDX], AMP_AGENT_META_ORGANIZATION), amp_agent_meta_organization);
+	adm_add_descs(g_amp_agent_idx, amp_agent_meta_descs, ADM_NUM_DESCS(amp_agent_meta_descs));
 }
 
+static const adm_desc_t amp_agent_cnst_descs[] = {
+	ADM_DESC_CNST(ADM_CONST_IDX, AMP_AGENT_CNST_AMP_EPOCH, amp_agent_get_amp_epoch),
+};
+
 void amp_agent_init_cnst()
 {
 
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_amp_agent_idx[ADM_CONST_IDX], AMP_AGENT_CNST_AMP_EPOCH), amp_agent_get_amp_epoch);
+	adm_add_descs(g_amp_agent_idx, amp_agent_cnst_descs, ADM_NUM_DESCS(amp_agent_cnst_descs));
 }
 
+static const adm_desc_t amp_agent_edd_descs[] = {
+	ADM_DESC_EDD(ADM_EDD_IDX, AMP_AGENT_EDD_NUM_RPT_TPLS, 0, amp_agent_get_num_rpt_tpls),
+	ADM_DESC_EDD(ADM_EDD_IDX, AMP_AGENT_EDD_NUM_TBL_TPLS, 0, amp_agent_get_num_tbl_tpls),
+	ADM_DESC_EDD(ADM_EDD_IDX, AMP_AGENT_EDD_SENT_REPORTS, 0, amp_agent_get_sent_reports),
+	ADM_DESC_EDD(ADM_EDD_IDX, AMP_AGENT_EDD_NUM_TBR, 0, amp_agent_get_num_tbr),
+	ADM_DESC_EDD(ADM_EDD_IDX, AMP_AGENT_EDD_RUN_TBR, 0, amp_agent_get_run_tbr),
+	ADM_DESC_EDD(ADM_EDD_IDX, AMP_AGENT_EDD_NUM_SBR, 0, amp_agent_get_num_sbr),
+	ADM_DESC_EDD(ADM_EDD_IDX, AMP_AGENT_EDD_RUN_SBR, 0, amp_agent_get_run_sbr),
+	ADM_DESC_EDD(ADM_EDD_IDX, AMP_AGENT_EDD_NUM_CONST, 0, amp_agent_get_num_const),
+	ADM_DESC_EDD(ADM_EDD_IDX, AMP_AGENT_EDD_NUM_VAR, 0, amp_agent_get_num_var),
+	ADM_DESC_EDD(ADM_EDD_IDX, AMP_AGENT_EDD_NUM_MACROS, 0, amp_agent_get_num_macros),
+	ADM_DESC_EDD(ADM_EDD_IDX, AMP_AGENT_EDD_RUN_MACROS, 0, amp_agent_get_run_macros),
+	ADM_DESC_EDD(ADM_EDD_IDX, AMP_AGENT_EDD_NUM_CONTROLS, 0, amp_agent_get_num_controls),
+	ADM_DESC_EDD(ADM_EDD_IDX, AMP_AGENT_EDD_RUN_CONTROLS, 0, amp_agent_get_run_controls),
+	ADM_DESC_EDD(ADM_EDD_IDX, AMP_AGENT_EDD_CUR_TIME, 0, amp_agent_get_cur_time),
+	ADM_DESC_EDD(ADM_EDD_IDX, AMP_AGENT_EDD_QUEUED_MSGS, 0, amp_agent_get_queued_msgs),
+	ADM_DESC_EDD(ADM_EDD_IDX, AMP_AGENT_EDD_QUEUED_BYTES, 0, amp_agent_get_queued_bytes),
+	ADM_DESC_EDD(ADM_EDD_IDX, AMP_AGENT_EDD_RULE_LAG_P99, 0, amp_agent_get_rule_lag_p99),
+	ADM_DESC_EDD(ADM_EDD_IDX, AMP_AGENT_EDD_EDD_COLLECT_P99, 0, amp_agent_get_edd_collect_p99),
+	ADM_DESC_EDD(ADM_EDD_IDX, AMP_AGENT_EDD_CTRL_RUN_P99, 0, amp_agent_get_ctrl_run_p99),
+	ADM_DESC_EDD(ADM_EDD_IDX, AMP_AGENT_EDD_RPT_QUEUE_P99, 0, amp_agent_get_rpt_queue_p99),
+	ADM_DESC_EDD(ADM_EDD_IDX, AMP_AGENT_EDD_RPT_SEND_P99, 0, amp_agent_get_rpt_send_p99),
+};
+
 void amp_agent_init_edd()
 {
 
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_amp_agent_idx[ADM_EDD_IDX], AMP_AGENT_EDD_NUM_RPT_TPLS), amp_agent_get_num_rpt_tpls);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_amp_agent_idx[ADM_EDD_IDX], AMP_AGENT_EDD_NUM_TBL_TPLS), amp_agent_get_num_tbl_tpls);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_amp_agent_idx[ADM_EDD_IDX], AMP_AGENT_EDD_SENT_REPORTS), amp_agent_get_sent_reports);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_amp_agent_idx[ADM_EDD_IDX], AMP_AGENT_EDD_NUM_TBR), amp_agent_get_num_tbr);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_amp_agent_idx[ADM_EDD_IDX], AMP_AGENT_EDD_RUN_TBR), amp_agent_get_run_tbr);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_amp_agent_idx[ADM_EDD_IDX], AMP_AGENT_EDD_NUM_SBR), amp_agent_get_num_sbr);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_amp_agent_idx[ADM_EDD_IDX], AMP_AGENT_EDD_RUN_SBR), amp_agent_get_run_sbr);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_amp_agent_idx[ADM_EDD_IDX], AMP_AGENT_EDD_NUM_CONST), amp_agent_get_num_const);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_amp_agent_idx[ADM_EDD_IDX], AMP_AGENT_EDD_NUM_VAR), amp_agent_get_num_var);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_amp_agent_idx[ADM_EDD_IDX], AMP_AGENT_EDD_NUM_MACROS), amp_agent_get_num_macros);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_amp_agent_idx[ADM_EDD_IDX], AMP_AGENT_EDD_RUN_MACROS), amp_agent_get_run_macros);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_amp_agent_idx[ADM_EDD_IDX], AMP_AGENT_EDD_NUM_CONTROLS), amp_agent_get_num_controls);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_amp_agent_idx[ADM_EDD_IDX], AMP_AGENT_EDD_RUN_CONTROLS), amp_agent_get_run_controls);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_amp_agent_idx[ADM_EDD_IDX], AMP_AGENT_EDD_CUR_TIME), amp_agent_get_cur_time);
+	adm_add_descs(g_amp_agent_idx, amp_agent_edd_descs, ADM_NUM_DESCS(amp_agent_edd_descs));
 }
 
+static const adm_desc_t amp_agent_op_descs[] = {
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_PLUSINT, 2, amp_agent_op_plusint, amp_agent_kernel_plusint),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_PLUSUINT, 2, amp_agent_op_plusuint, amp_agent_kernel_plusuint),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_PLUSVAST, 2, amp_agent_op_plusvast, amp_agent_kernel_plusvast),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_PLUSUVAST, 2, amp_agent_op_plusuvast, amp_agent_kernel_plusuvast),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_PLUSREAL32, 2, amp_agent_op_plusreal32, amp_agent_kernel_plusreal32),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_PLUSREAL64, 2, amp_agent_op_plusreal64, amp_agent_kernel_plusreal64),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_MINUSINT, 2, amp_agent_op_minusint, amp_agent_kernel_minusint),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_MINUSUINT, 2, amp_agent_op_minusuint, amp_agent_kernel_minusuint),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_MINUSVAST, 2, amp_agent_op_minusvast, amp_agent_kernel_minusvast),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_MINUSUVAST, 2, amp_agent_op_minusuvast, amp_agent_kernel_minusuvast),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_MINUSREAL32, 2, amp_agent_op_minusreal32, amp_agent_kernel_minusreal32),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_MINUSREAL64, 2, amp_agent_op_minusreal64, amp_agent_kernel_minusreal64),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_MULTINT, 2, amp_agent_op_multint, amp_agent_kernel_multint),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_MULTUINT, 2, amp_agent_op_multuint, amp_agent_kernel_multuint),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_MULTVAST, 2, amp_agent_op_multvast, amp_agent_kernel_multvast),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_MULTUVAST, 2, amp_agent_op_multuvast, amp_agent_kernel_multuvast),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_MULTREAL32, 2, amp_agent_op_multreal32, amp_agent_kernel_multreal32),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_MULTREAL64, 2, amp_agent_op_multreal64, amp_agent_kernel_multreal64),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_DIVINT, 2, amp_agent_op_divint, amp_agent_kernel_divint),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_DIVUINT, 2, amp_agent_op_divuint, amp_agent_kernel_divuint),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_DIVVAST, 2, amp_agent_op_divvast, amp_agent_kernel_divvast),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_DIVUVAST, 2, amp_agent_op_divuvast, amp_agent_kernel_divuvast),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_DIVREAL32, 2, amp_agent_op_divreal32, amp_agent_kernel_divreal32),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_DIVREAL64, 2, amp_agent_op_divreal64, amp_agent_kernel_divreal64),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_MODINT, 2, amp_agent_op_modint, amp_agent_kernel_modint),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_MODUINT, 2, amp_agent_op_moduint, amp_agent_kernel_moduint),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_MODVAST, 2, amp_agent_op_modvast, amp_agent_kernel_modvast),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_MODUVAST, 2, amp_agent_op_moduvast, amp_agent_kernel_moduvast),
+	ADM_DESC_OP(ADM_OPER_IDX, AMP_AGENT_OP_MODREAL32, 2, amp_agent_op_modreal32),
+	ADM_DESC_OP(ADM_OPER_IDX, AMP_AGENT_OP_MODREAL64, 2, amp_agent_op_modreal64),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_EXPINT, 2, amp_agent_op_expint, amp_agent_kernel_expint),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_EXPUINT, 2, amp_agent_op_expuint, amp_agent_kernel_expuint),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_EXPVAST, 2, amp_agent_op_expvast, amp_agent_kernel_expvast),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_EXPUVAST, 2, amp_agent_op_expuvast, amp_agent_kernel_expuvast),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_EXPREAL32, 2, amp_agent_op_expreal32, amp_agent_kernel_expreal32),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_EXPREAL64, 2, amp_agent_op_expreal64, amp_agent_kernel_expreal64),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_BITAND, 2, amp_agent_op_bitand, amp_agent_kernel_bitand),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_BITOR, 2, amp_agent_op_bitor, amp_agent_kernel_bitor),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_BITXOR, 2, amp_agent_op_bitxor, amp_agent_kernel_bitxor),
+	ADM_DESC_OP(ADM_OPER_IDX, AMP_AGENT_OP_BITNOT, 1, amp_agent_op_bitnot),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_LOGAND, 2, amp_agent_op_logand, amp_agent_kernel_logand),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_LOGOR, 2, amp_agent_op_logor, amp_agent_kernel_logor),
+	ADM_DESC_OP(ADM_OPER_IDX, AMP_AGENT_OP_LOGNOT, 1, amp_agent_op_lognot),
+	ADM_DESC_OP(ADM_OPER_IDX, AMP_AGENT_OP_ABS, 1, amp_agent_op_abs),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_LESSTHAN, 2, amp_agent_op_lessthan, amp_agent_kernel_lessthan),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_GREATERTHAN, 2, amp_agent_op_greaterthan, amp_agent_kernel_greaterthan),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_LESSEQUAL, 2, amp_agent_op_lessequal, amp_agent_kernel_lessequal),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_GREATEREQUAL, 2, amp_agent_op_greaterequal, amp_agent_kernel_greaterequal),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_NOTEQUAL, 2, amp_agent_op_notequal, amp_agent_kernel_notequal),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_EQUAL, 2, amp_agent_op_equal, amp_agent_kernel_equal),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_BITSHIFTLEFT, 2, amp_agent_op_bitshiftleft, amp_agent_kernel_bitshiftleft),
+	ADM_DESC_OP_KERNEL(ADM_OPER_IDX, AMP_AGENT_OP_BITSHIFTRIGHT, 2, amp_agent_op_bitshiftright, amp_agent_kernel_bitshiftright),
+	ADM_DESC_OP(ADM_OPER_IDX, AMP_AGENT_OP_STOR, 2, amp_agent_op_stor),
+};
+
 void amp_agent_init_op()
 {
 
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_PLUSINT, 2, amp_agent_op_plusint);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_PLUSUINT, 2, amp_agent_op_plusuint);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_PLUSVAST, 2, amp_agent_op_plusvast);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_PLUSUVAST, 2, amp_agent_op_plusuvast);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_PLUSREAL32, 2, amp_agent_op_plusreal32);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_PLUSREAL64, 2, amp_agent_op_plusreal64);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_MINUSINT, 2, amp_agent_op_minusint);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_MINUSUINT, 2, amp_agent_op_minusuint);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_MINUSVAST, 2, amp_agent_op_minusvast);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_MINUSUVAST, 2, amp_agent_op_minusuvast);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_MINUSREAL32, 2, amp_agent_op_minusreal32);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_MINUSREAL64, 2, amp_agent_op_minusreal64);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_MULTINT, 2, amp_agent_op_multint);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_MULTUINT, 2, amp_agent_op_multuint);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_MULTVAST, 2, amp_agent_op_multvast);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_MULTUVAST, 2, amp_agent_op_multuvast);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_MULTREAL32, 2, amp_agent_op_multreal32);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_MULTREAL64, 2, amp_agent_op_multreal64);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_DIVINT, 2, amp_agent_op_divint);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_DIVUINT, 2, amp_agent_op_divuint);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_DIVVAST, 2, amp_agent_op_divvast);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_DIVUVAST, 2, amp_agent_op_divuvast);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_DIVREAL32, 2, amp_agent_op_divreal32);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_DIVREAL64, 2, amp_agent_op_divreal64);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_MODINT, 2, amp_agent_op_modint);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_MODUINT, 2, amp_agent_op_moduint);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_MODVAST, 2, amp_agent_op_modvast);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_MODUVAST, 2, amp_agent_op_moduvast);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_MODREAL32, 2, amp_agent_op_modreal32);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_MODREAL64, 2, amp_agent_op_modreal64);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_EXPINT, 2, amp_agent_op_expint);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_EXPUINT, 2, amp_agent_op_expuint);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_EXPVAST, 2, amp_agent_op_expvast);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_EXPUVAST, 2, amp_agent_op_expuvast);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_EXPREAL32, 2, amp_agent_op_expreal32);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_EXPREAL64, 2, amp_agent_op_expreal64);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_BITAND, 2, amp_agent_op_bitand);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_BITOR, 2, amp_agent_op_bitor);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_BITXOR, 2, amp_agent_op_bitxor);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_BITNOT, 1, amp_agent_op_bitnot);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_LOGAND, 2, amp_agent_op_logand);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_LOGOR, 2, amp_agent_op_logor);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_LOGNOT, 1, amp_agent_op_lognot);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_ABS, 1, amp_agent_op_abs);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_LESSTHAN, 2, amp_agent_op_lessthan);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_GREATERTHAN, 2, amp_agent_op_greaterthan);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_LESSEQUAL, 2, amp_agent_op_lessequal);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_GREATEREQUAL, 2, amp_agent_op_greaterequal);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_NOTEQUAL, 2, amp_agent_op_notequal);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_EQUAL, 2, amp_agent_op_equal);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_BITSHIFTLEFT, 2, amp_agent_op_bitshiftleft);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_BITSHIFTRIGHT, 2, amp_agent_op_bitshiftright);
-	adm_add_op(g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_STOR, 2, amp_agent_op_stor);
+	adm_add_descs(g_amp_agent_idx, amp_agent_op_descs, ADM_NUM_DESCS(amp_agent_op_descs));
 }
 
 void amp_agent_init_var()
@@ -168,25 +191,39 @@ void amp_agent_init_var()
 	adm_add_var_from_expr(id, AMP_TYPE_UINT, expr);
 }
 
+static const adm_desc_t amp_agent_ctrl_descs[] = {
+	ADM_DESC_CTRL(ADM_CTRL_IDX, AMP_AGENT_CTRL_ADD_VAR, 3, amp_agent_ctrl_add_var),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, AMP_AGENT_CTRL_DEL_VAR, 1, amp_agent_ctrl_del_var),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, AMP_AGENT_CTRL_ADD_RPTT, 2, amp_agent_ctrl_add_rptt),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, AMP_AGENT_CTRL_DEL_RPTT, 1, amp_agent_ctrl_del_rptt),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, AMP_AGENT_CTRL_DESC_RPTT, 1, amp_agent_ctrl_desc_rptt),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, AMP_AGENT_CTRL_GEN_RPTS, 2, amp_agent_ctrl_gen_rpts),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, AMP_AGENT_CTRL_GEN_TBLS, 2, amp_agent_ctrl_gen_tbls),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, AMP_AGENT_CTRL_ADD_MACRO, 3, amp_agent_ctrl_add_macro),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, AMP_AGENT_CTRL_DEL_MACRO, 1, amp_agent_ctrl_del_macro),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, AMP_AGENT_CTRL_DESC_MACRO, 1, amp_agent_ctrl_desc_macro),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, AMP_AGENT_CTRL_ADD_TBR, 6, amp_agent_ctrl_add_tbr),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, AMP_AGENT_CTRL_ADD_SBR, 7, amp_agent_ctrl_add_sbr),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, AMP_AGENT_CTRL_DEL_RULE, 1, amp_agent_ctrl_del_rule),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, AMP_AGENT_CTRL_DESC_RULE, 1, amp_agent_ctrl_desc_rule),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, AMP_AGENT_CTRL_STORE_VAR, 2, amp_agent_ctrl_store_var),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, AMP_AGENT_CTRL_RESET_COUNTS, 0, amp_agent_ctrl_reset_counts),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, AMP_AGENT_CTRL_SET_CLASS, 2, amp_agent_ctrl_set_class),
+};
+
 void amp_agent_init_ctrl()
 {
 
-	adm_add_ctrldef(g_amp_agent_idx[ADM_CTRL_IDX], AMP_AGENT_CTRL_ADD_VAR, 3, amp_agent_ctrl_add_var);
-	adm_add_ctrldef(g_amp_agent_idx[ADM_CTRL_IDX], AMP_AGENT_CTRL_DEL_VAR, 1, amp_agent_ctrl_del_var);
-	adm_add_ctrldef(g_amp_agent_idx[ADM_CTRL_IDX], AMP_AGENT_CTRL_ADD_RPTT, 2, amp_agent_ctrl_add_rptt);
-	adm_add_ctrldef(g_amp_agent_idx[ADM_CTRL_IDX], AMP_AGENT_CTRL_DEL_RPTT, 1, amp_agent_ctrl_del_rptt);
-	adm_add_ctrldef(g_amp_agent_idx[ADM_CTRL_IDX], AMP_AGENT_CTRL_DESC_RPTT, 1, amp_agent_ctrl_desc_rptt);
-	adm_add_ctrldef(g_amp_agent_idx[ADM_CTRL_IDX], AMP_AGENT_CTRL_GEN_RPTS, 2, amp_agent_ctrl_gen_rpts);
-	adm_add_ctrldef(g_amp_agent_idx[ADM_CTRL_IDX], AMP_AGENT_CTRL_GEN_TBLS, 2, amp_agent_ctrl_gen_tbls);
-	adm_add_ctrldef(g_amp_agent_idx[ADM_CTRL_IDX], AMP_AGENT_CTRL_ADD_MACRO, 3, amp_agent_ctrl_add_macro);
-	adm_add_ctrldef(g_amp_agent_idx[ADM_CTRL_IDX], AMP_AGENT_CTRL_DEL_MACRO, 1, amp_agent_ctrl_del_macro);
-	adm_add_ctrldef(g_amp_agent_idx[ADM_CTRL_IDX], AMP_AGENT_CTRL_DESC_MACRO, 1, amp_agent_ctrl_desc_macro);
-	adm_add_ctrldef(g_amp_agent_idx[ADM_CTRL_IDX], AMP_AGENT_CTRL_ADD_TBR, 6, amp_agent_ctrl_add_tbr);
-	adm_add_ctrldef(g_amp_agent_idx[ADM_CTRL_IDX], AMP_AGENT_CTRL_ADD_SBR, 7, amp_agent_ctrl_add_sbr);
-	adm_add_ctrldef(g_amp_agent_idx[ADM_CTRL_IDX], AMP_AGENT_CTRL_DEL_RULE, 1, amp_agent_ctrl_del_rule);
-	adm_add_ctrldef(g_amp_agent_idx[ADM_CTRL_IDX], AMP_AGENT_CTRL_DESC_RULE, 1, amp_agent_ctrl_desc_rule);
-	adm_add_ctrldef(g_amp_agent_idx[ADM_CTRL_IDX], AMP_AGENT_CTRL_STORE_VAR, 2, amp_agent_ctrl_store_var);
-	adm_add_ctrldef(g_amp_agent_idx[ADM_CTRL_IDX], AMP_AGENT_CTRL_RESET_COUNTS, 0, amp_agent_ctrl_reset_counts);
+	adm_add_descs(g_amp_agent_idx, amp_agent_ctrl_descs, ADM_NUM_DESCS(amp_agent_ctrl_descs));
+
+	/* Table sets are large, so by default they do not hold up other reports. */
+	ari_t *id = adm_build_ari(AMP_TYPE_CTRL, 1, g_amp_agent_idx[ADM_CTRL_IDX], AMP_AGENT_CTRL_GEN_TBLS);
+	ctrldef_t *def = VDB_FINDKEY_CTRLDEF(id);
+	if(def != NULL)
+	{
+		def->prio = AMP_PRIO_BULK;
+	}
+	ari_release(id, 1);
 }
 
 void amp_agent_init_mac()
@@ -229,36 +266,76 @@ void amp_agent_init_tblt()
 
 	def = tblt_create(adm_build_ari(AMP_TYPE_TBLT, 0, g_amp_agent_idx[ADM_TBLT_IDX], AMP_AGENT_TBLT_ADMS), amp_agent_tblt_adms);
 	tblt_add_col(def, AMP_TYPE_STR, "adm_name");
+	tblt_set_key(def, 0x1, NULL);
 	adm_add_tblt(def);
 
 	/* VARIABLES */
 
 	def = tblt_create(adm_build_ari(AMP_TYPE_TBLT, 0, g_amp_agent_idx[ADM_TBLT_IDX], AMP_AGENT_TBLT_VARIABLES), amp_agent_tblt_variables);
 	tblt_add_col(def, AMP_TYPE_ARI, "ids");
+	tblt_set_key(def, 0x1, NULL);
 	adm_add_tblt(def);
 
 	/* RPTTS */
 
 	def = tblt_create(adm_build_ari(AMP_TYPE_TBLT, 0, g_amp_agent_idx[ADM_TBLT_IDX], AMP_AGENT_TBLT_RPTTS), amp_agent_tblt_rptts);
 	tblt_add_col(def, AMP_TYPE_ARI, "ids");
+	tblt_set_key(def, 0x1, NULL);
 	adm_add_tblt(def);
 
 	/* MACROS */
 
 	def = tblt_create(adm_build_ari(AMP_TYPE_TBLT, 0, g_amp_agent_idx[ADM_TBLT_IDX], AMP_AGENT_TBLT_MACROS), amp_agent_tblt_macros);
 	tblt_add_col(def, AMP_TYPE_ARI, "ids");
+	tblt_set_key(def, 0x1, NULL);
 	adm_add_tblt(def);
 
 	/* RULES */
 
 	def = tblt_create(adm_build_ari(AMP_TYPE_TBLT, 0, g_amp_agent_idx[ADM_TBLT_IDX], AMP_AGENT_TBLT_RULES), amp_agent_tblt_rules);
 	tblt_add_col(def, AMP_TYPE_ARI, "ids");
+	tblt_set_key(def, 0x1, NULL);
 	adm_add_tblt(def);
 
 	/* TBLTS */
 
 	def = tblt_create(adm_build_ari(AMP_TYPE_TBLT, 0, g_amp_agent_idx[ADM_TBLT_IDX], AMP_AGENT_TBLT_TBLTS), amp_agent_tblt_tblts);
 	tblt_add_col(def, AMP_TYPE_ARI, "ids");
+	tblt_set_key(def, 0x1, NULL);
+	adm_add_tblt(def);
+
+	/* REPORT_CLASSES */
+
+	def = tblt_create(adm_build_ari(AMP_TYPE_TBLT, 0, g_amp_agent_idx[ADM_TBLT_IDX], AMP_AGENT_TBLT_REPORT_CLASSES), amp_agent_tblt_report_classes);
+	tblt_add_col(def, AMP_TYPE_UINT, "class");
+	tblt_add_col(def, AMP_TYPE_UINT, "held");
+	tblt_add_col(def, AMP_TYPE_UVAST, "sent");
+	tblt_add_col(def, AMP_TYPE_UVAST, "mean_delay_ms");
+	tblt_add_col(def, AMP_TYPE_UINT, "max_delay_ms");
+	tblt_set_key(def, 0x1, NULL);
+	adm_add_tblt(def);
+
+	/* LATENCIES */
+
+	def = tblt_create(adm_build_ari(AMP_TYPE_TBLT, 0, g_amp_agent_idx[ADM_TBLT_IDX], AMP_AGENT_TBLT_LATENCIES), amp_agent_tblt_latencies);
+	tblt_add_col(def, AMP_TYPE_STR, "name");
+	tblt_add_col(def, AMP_TYPE_UVAST, "count");
+	tblt_add_col(def, AMP_TYPE_UVAST, "mean_us");
+	tblt_add_col(def, AMP_TYPE_UVAST, "p50_us");
+	tblt_add_col(def, AMP_TYPE_UVAST, "p90_us");
+	tblt_add_col(def, AMP_TYPE_UVAST, "p99_us");
+	tblt_add_col(def, AMP_TYPE_UVAST, "max_us");
+	tblt_set_key(def, 0x1, NULL);
+	adm_add_tblt(def);
+
+	/* EDD_TIMES */
+
+	def = tblt_create(adm_build_ari(AMP_TYPE_TBLT, 0, g_amp_agent_idx[ADM_TBLT_IDX], AMP_AGENT_TBLT_EDD_TIMES), amp_agent_tblt_edd_times);
+	tblt_add_col(def, AMP_TYPE_ARI, "id");
+	tblt_add_col(def, AMP_TYPE_UVAST, "count");
+	tblt_add_col(def, AMP_TYPE_UVAST, "mean_us");
+	tblt_add_col(def, AMP_TYPE_UVAST, "max_us");
+	tblt_set_key(def, 0x1, NULL);
 	adm_add_tblt(def);
 }
 
@@ -51,7 +51,6 @@ int amp_agent_build_ari_table(tbl_t *table, rhht_t *ht)
 {
 	int success;
 	vector_t vec = vec_create(4, NULL, NULL, NULL, 0, &success);
-	tnvc_t *cur_row;
 	vecit_t it;
 
 	if(success != VEC_OK)
@@ -65,9 +64,14 @@ int amp_agent_build_ari_table(tbl_t *table, rhht_t *ht)
 	for(it = vecit_first(&vec); vecit_valid(it); it = vecit_next(it))
 	{
 		ari_t *ari = (ari_t*) vecit_data(it);
-		cur_row = tnvc_create(1);
-		tnvc_insert(cur_row, tnv_from_obj(AMP_TYPE_ARI, ari_copy_ptr(ari)));
-		if(tbl_add_row(table, cur_row) != AMP_OK)
+		tnv_t val;
+
+		tnv_init(&val, AMP_TYPE_ARI);
+		if((val.value.as_ptr = ari_copy_ptr(ari)) != NULL)
+		{
+			TNV_SET_ALLOC(val.flags);
+		}
+		if((val.value.as_ptr == NULL) || (tbl_append_val(table, val) != AMP_OK))
 		{
 			success = AMP_FAIL;
 			break;
@@ -496,6 +500,7 @@ tnv_t *adm_agent_binary_log_op(amp_agent_op_e op, vector_t *stack)
 		case LTE:    result->value.as_byte = tnv_to_int(*lval, &ls) <= tnv_to_int(*rval, &rs); break;
 		case GTE:    result->value.as_byte = tnv_to_int(*lval, &ls) >= tnv_to_int(*rval, &rs); break;
 		case EQ:     result->value.as_byte = tnv_to_int(*lval, &ls) == tnv_to_int(*rval, &rs); break;
+		case NEQ:    result->value.as_byte = tnv_to_int(*lval, &ls) != tnv_to_int(*rval, &rs); break;
 		default: ls = rs = 0; break;
 		}
 		break;
@@ -509,6 +514,7 @@ tnv_t *adm_agent_binary_log_op(amp_agent_op_e op, vector_t *stack)
 		case LTE:    result->value.as_byte = tnv_to_uint(*lval, &ls) <= tnv_to_uint(*rval, &rs); break;
 		case GTE:    result->value.as_byte = tnv_to_uint(*lval, &ls) >= tnv_to_uint(*rval, &rs); break;
 		case EQ:     result->value.as_byte = tnv_to_uint(*lval, &ls) == tnv_to_uint(*rval, &rs); break;
+		case NEQ:    result->value.as_byte = tnv_to_uint(*lval, &ls) != tnv_to_uint(*rval, &rs); break;
 		default: ls = rs = 0; break;
 		}
 		break;
@@ -522,6 +528,7 @@ tnv_t *adm_agent_binary_log_op(amp_agent_op_e op, vector_t *stack)
 		case LTE:    result->value.as_byte = tnv_to_vast(*lval, &ls) <= tnv_to_vast(*rval, &rs); break;
 		case GTE:    result->value.as_byte = tnv_to_vast(*lval, &ls) >= tnv_to_vast(*rval, &rs); break;
 		case EQ:     result->value.as_byte = tnv_to_vast(*lval, &ls) == tnv_to_vast(*rval, &rs); break;
+		case NEQ:    result->value.as_byte = tnv_to_vast(*lval, &ls) != tnv_to_vast(*rval, &rs); break;
 		default: ls = rs = 0; break;
 		}
 		break;
@@ -535,6 +542,7 @@ tnv_t *adm_agent_binary_log_op(amp_agent_op_e op, vector_t *stack)
 		case LTE:    result->value.as_byte = tnv_to_uvast(*lval, &ls) <= tnv_to_uvast(*rval, &rs); break;
 		case GTE:    result->value.as_byte = tnv_to_uvast(*lval, &ls) >= tnv_to_uvast(*rval, &rs); break;
 		case EQ:     result->value.as_byte = tnv_to_uvast(*lval, &ls) == tnv_to_uvast(*rval, &rs); break;
+		case NEQ:    result->value.as_byte = tnv_to_uvast(*lval, &ls) != tnv_to_uvast(*rval, &rs); break;
 		default: ls = rs = 0; break;
 		}
 		break;
@@ -548,6 +556,7 @@ tnv_t *adm_agent_binary_log_op(amp_agent_op_e op, vector_t *stack)
 		case LTE:    result->value.as_byte = tnv_to_real32(*lval, &ls) <= tnv_to_real32(*rval, &rs); break;
 		case GTE:    result->value.as_byte = tnv_to_real32(*lval, &ls) >= tnv_to_real32(*rval, &rs); break;
 		case EQ:     result->value.as_byte = tnv_to_real32(*lval, &ls) == tnv_to_real32(*rval, &rs); break;
+		case NEQ:    result->value.as_byte = tnv_to_real32(*lval, &ls) != tnv_to_real32(*rval, &rs); break;
 		default: ls = rs = 0; break;
 		}
 		break;
@@ -561,6 +570,7 @@ tnv_t *adm_agent_binary_log_op(amp_agent_op_e op, vector_t *stack)
 		case LTE:    result->value.as_byte = tnv_to_real64(*lval, &ls) <= tnv_to_real64(*rval, &rs); break;
 		case GTE:    result->value.as_byte = tnv_to_real64(*lval, &ls) >= tnv_to_real64(*rval, &rs); break;
 		case EQ:     result->value.as_byte = tnv_to_real64(*lval, &ls) == tnv_to_real64(*rval, &rs); break;
+		case NEQ:    result->value.as_byte = tnv_to_real64(*lval, &ls) != tnv_to_real64(*rval, &rs); break;
 		default: ls = rs = 0; break;
 		}
 		break;
@@ -583,6 +593,153 @@ tnv_t *adm_agent_binary_log_op(amp_agent_op_e op, vector_t *stack)
 }
 
 
+/*
+ * Typed kernels of the numeric operators, applied by expr_eval() to unboxed
+ * values without touching the heap. Operands outside the numeric types fall
+ * back to the generic functions above, which give the same results.
+ */
+
+/* Loads a value as the type of an arithmetic result, as tnv_to_*() does. */
+#define AMP_AGENT_KERNEL_LOAD(rtype, ctype) \
+static inline int amp_agent_kernel_load_##rtype(const tnv_t *val, ctype *out) \
+{ \
+	if(TNV_IS_MAP(val->flags)) return AMP_FAIL; \
+	switch(val->type) \
+	{ \
+		case AMP_TYPE_BOOL: \
+		case AMP_TYPE_BYTE:   *out = (ctype) val->value.as_byte;   break; \
+		case AMP_TYPE_INT:    *out = (ctype) val->value.as_int;    break; \
+		case AMP_TYPE_UINT:   *out = (ctype) val->value.as_uint;   break; \
+		case AMP_TYPE_VAST:   *out = (ctype) val->value.as_vast;   break; \
+		case AMP_TYPE_TV: \
+		case AMP_TYPE_TS: \
+		case AMP_TYPE_UVAST:  *out = (ctype) val->value.as_uvast;  break; \
+		case AMP_TYPE_REAL32: *out = (ctype) val->value.as_real32; break; \
+		case AMP_TYPE_REAL64: *out = (ctype) val->value.as_real64; break; \
+		default: return AMP_FAIL; \
+	} \
+	return AMP_OK; \
+}
+
+AMP_AGENT_KERNEL_LOAD(INT, int32_t)
+AMP_AGENT_KERNEL_LOAD(UINT, uint32_t)
+AMP_AGENT_KERNEL_LOAD(VAST, amp_vast)
+AMP_AGENT_KERNEL_LOAD(UVAST, amp_uvast)
+AMP_AGENT_KERNEL_LOAD(REAL32, float)
+AMP_AGENT_KERNEL_LOAD(REAL64, double)
+
+/* An arithmetic operator whose operands are converted to its result type. */
+#define AMP_AGENT_KERNEL_ARITH(name, rtype, ctype, field, expr) \
+int amp_agent_kernel_##name(const tnv_t *args, tnv_t *result) \
+{ \
+	ctype l; \
+	ctype r; \
+	if((amp_agent_kernel_load_##rtype(&(args[0]), &l) != AMP_OK) || \
+	   (amp_agent_kernel_load_##rtype(&(args[1]), &r) != AMP_OK)) \
+	{ \
+		return AMP_FAIL; \
+	} \
+	tnv_init(result, AMP_TYPE_##rtype); \
+	result->value.field = (expr); \
+	return AMP_OK; \
+}
+
+#define AMP_AGENT_KERNEL_ARITH_ALL(suffix, rtype, ctype, field) \
+	AMP_AGENT_KERNEL_ARITH(plus##suffix,  rtype, ctype, field, l + r) \
+	AMP_AGENT_KERNEL_ARITH(minus##suffix, rtype, ctype, field, l - r) \
+	AMP_AGENT_KERNEL_ARITH(mult##suffix,  rtype, ctype, field, l * r) \
+	AMP_AGENT_KERNEL_ARITH(div##suffix,   rtype, ctype, field, AMP_SAFE_DIV(l, r)) \
+	AMP_AGENT_KERNEL_ARITH(exp##suffix,   rtype, ctype, field, (ctype) pow(l, r))
+
+AMP_AGENT_KERNEL_ARITH_ALL(int, INT, int32_t, as_int)
+AMP_AGENT_KERNEL_ARITH_ALL(uint, UINT, uint32_t, as_uint)
+AMP_AGENT_KERNEL_ARITH_ALL(vast, VAST, amp_vast, as_vast)
+AMP_AGENT_KERNEL_ARITH_ALL(uvast, UVAST, amp_uvast, as_uvast)
+AMP_AGENT_KERNEL_ARITH_ALL(real32, REAL32, float, as_real32)
+AMP_AGENT_KERNEL_ARITH_ALL(real64, REAL64, double, as_real64)
+
+AMP_AGENT_KERNEL_ARITH(modint,   INT,   int32_t,   as_int,   AMP_SAFE_MOD(l, r))
+AMP_AGENT_KERNEL_ARITH(moduint,  UINT,  uint32_t,  as_uint,  AMP_SAFE_MOD(l, r))
+AMP_AGENT_KERNEL_ARITH(modvast,  VAST,  amp_vast,  as_vast,  AMP_SAFE_MOD(l, r))
+AMP_AGENT_KERNEL_ARITH(moduvast, UVAST, amp_uvast, as_uvast, AMP_SAFE_MOD(l, r))
+
+AMP_AGENT_KERNEL_ARITH(bitand,        UVAST, amp_uvast, as_uvast, l & r)
+AMP_AGENT_KERNEL_ARITH(bitor,         UVAST, amp_uvast, as_uvast, l | r)
+AMP_AGENT_KERNEL_ARITH(bitxor,        UVAST, amp_uvast, as_uvast, l ^ r)
+AMP_AGENT_KERNEL_ARITH(bitshiftleft,  UVAST, amp_uvast, as_uvast, l << (uint32_t) r)
+AMP_AGENT_KERNEL_ARITH(bitshiftright, UVAST, amp_uvast, as_uvast, l >> (uint32_t) r)
+
+/*
+ * Comparisons and logical operators are computed in the type of the left
+ * operand, so there is one kernel for each pair of operand types. These
+ * are generated from the type lists below into a matrix indexed like
+ * gValNumCvtResult.
+ */
+#define AMP_AGENT_KERNEL_TYPES_L(X, ...) \
+	X(INT, int32_t, as_int, __VA_ARGS__) \
+	X(UINT, uint32_t, as_uint, __VA_ARGS__) \
+	X(VAST, amp_vast, as_vast, __VA_ARGS__) \
+	X(UVAST, amp_uvast, as_uvast, __VA_ARGS__) \
+	X(REAL32, float, as_real32, __VA_ARGS__) \
+	X(REAL64, double, as_real64, __VA_ARGS__)
+
+#define AMP_AGENT_KERNEL_TYPES_R(X, ...) \
+	X(INT, as_int, __VA_ARGS__) \
+	X(UINT, as_uint, __VA_ARGS__) \
+	X(VAST, as_vast, __VA_ARGS__) \
+	X(UVAST, as_uvast, __VA_ARGS__) \
+	X(REAL32, as_real32, __VA_ARGS__) \
+	X(REAL64, as_real64, __VA_ARGS__)
+
+#define AMP_AGENT_KERNEL_CMP_FN(rtype, rfield, name, op, ltype, ctype, lfield) \
+static int amp_agent_kernel_##name##_##ltype##_##rtype(const tnv_t *args, tnv_t *result) \
+{ \
+	tnv_init(result, AMP_TYPE_BOOL); \
+	result->value.as_byte = args[0].value.lfield op (ctype) args[1].value.rfield; \
+	return AMP_OK; \
+}
+#define AMP_AGENT_KERNEL_CMP_ROW_FNS(ltype, ctype, lfield, name, op) \
+	AMP_AGENT_KERNEL_TYPES_R(AMP_AGENT_KERNEL_CMP_FN, name, op, ltype, ctype, lfield)
+
+#define AMP_AGENT_KERNEL_CMP_ENTRY(rtype, rfield, name, ltype) \
+	amp_agent_kernel_##name##_##ltype##_##rtype,
+#define AMP_AGENT_KERNEL_CMP_ROW(ltype, ctype, lfield, name) \
+	{ AMP_AGENT_KERNEL_TYPES_R(AMP_AGENT_KERNEL_CMP_ENTRY, name, ltype) },
+
+#define AMP_AGENT_KERNEL_CMP(name, op) \
+AMP_AGENT_KERNEL_TYPES_L(AMP_AGENT_KERNEL_CMP_ROW_FNS, name, op) \
+static const op_kernel_fn gAmpAgentKernel_##name[6][6] = { \
+	AMP_AGENT_KERNEL_TYPES_L(AMP_AGENT_KERNEL_CMP_ROW, name) \
+}; \
+int amp_agent_kernel_##name(const tnv_t *args, tnv_t *result) \
+{ \
+	unsigned int l = args[0].type - AMP_TYPE_INT; \
+	unsigned int r = args[1].type - AMP_TYPE_INT; \
+	if((l >= 6) || (r >= 6) || TNV_IS_MAP(args[0].flags) || TNV_IS_MAP(args[1].flags)) \
+	{ \
+		return AMP_FAIL; \
+	} \
+	return gAmpAgentKernel_##name[l][r](args, result); \
+}
+
+AMP_AGENT_KERNEL_CMP(lessthan, <)
+AMP_AGENT_KERNEL_CMP(greaterthan, >)
+AMP_AGENT_KERNEL_CMP(lessequal, <=)
+AMP_AGENT_KERNEL_CMP(greaterequal, >=)
+AMP_AGENT_KERNEL_CMP(equal, ==)
+AMP_AGENT_KERNEL_CMP(notequal, !=)
+AMP_AGENT_KERNEL_CMP(logand, &&)
+AMP_AGENT_KERNEL_CMP(logor, ||)
+
+/* The 99th percentile of a latency, in microseconds. */
+tnv_t *amp_agent_get_lat_p99(agent_instr_lat_e lat)
+{
+	agent_instr_lat_t summary;
+
+	agent_instr_lat_get(lat, &summary);
+	return tnv_from_uvast(summary.p99_us);
+}
+
 
 /*   STOP CUSTOM FUNCTIONS HERE  */
 
@@ -669,11 +826,7 @@ tbl_t *amp_agent_tblt_adms(ari_t *id)
 	 * |START CUSTOM FUNCTION tblt_adms BODY
 	 * +-------------------------------------------------------------------------+
 	 */
-	tnvc_t *cur_row = NULL;
-
-	cur_row = tnvc_create(1);
-	tnvc_insert(cur_row, tnv_from_str("AMP AGENT"));
-	if(tbl_add_row(table, cur_row) != AMP_OK)
+	if(tbl_append_str(table, "AMP AGENT") != AMP_OK)
 	{
 		tbl_release(table, 1);
 		return NULL;
@@ -704,7 +857,8 @@ tbl_t *amp_agent_tblt_variables(ari_t *id)
 	 * |START CUSTOM FUNCTION tblt_variables BODY
 	 * +-------------------------------------------------------------------------+
 	 */
-	if(amp_agent_build_ari_table(table, &(gVDB.vars)) != AMP_OK)
+	if((amp_agent_build_ari_table(table, &(gVDB.adm.vars)) != AMP_OK)
+	   || (amp_agent_build_ari_table(table, &(gVDBInst->vars)) != AMP_OK))
 	{
 		tbl_release(table, 1);
 		table = NULL;
@@ -735,7 +889,8 @@ tbl_t *amp_agent_tblt_rptts(ari_t *id)
 	 * |START CUSTOM FUNCTION tblt_rptts BODY
 	 * +-------------------------------------------------------------------------+
 	 */
-	if(amp_agent_build_ari_table(table, &(gVDB.rpttpls)) != AMP_OK)
+	if((amp_agent_build_ari_table(table, &(gVDB.adm.rpttpls)) != AMP_OK)
+	   || (amp_agent_build_ari_table(table, &(gVDBInst->rpttpls)) != AMP_OK))
 	{
 		tbl_release(table, 1);
 		table = NULL;
@@ -767,7 +922,8 @@ tbl_t *amp_agent_tblt_macros(ari_t *id)
 	 * +-------------------------------------------------------------------------+
 	 */
 
-	if(amp_agent_build_ari_table(table, &(gVDB.macdefs)) != AMP_OK)
+	if((amp_agent_build_ari_table(table, &(gVDB.adm.macdefs)) != AMP_OK)
+	   || (amp_agent_build_ari_table(table, &(gVDBInst->macdefs)) != AMP_OK))
 	{
 		tbl_release(table, 1);
 		table = NULL;
@@ -799,7 +955,7 @@ tbl_t *amp_agent_tblt_rules(ari_t *id)
 	 * +-------------------------------------------------------------------------+
 	 */
 
-	if(amp_agent_build_ari_table(table, &(gVDB.rules)) != AMP_OK)
+	if(amp_agent_build_ari_table(table, &(gVDBInst->rules)) != AMP_OK)
 	{
 		tbl_release(table, 1);
 		table = NULL;
@@ -846,6 +1002,146 @@ tbl_t *amp_agent_tblt_tblts(ari_t *id)
 }
 
 
+/*
+ * This table lists, for each report priority class, the messages held and sent and their queueing del
+ * ay.
+ */
+tbl_t *amp_agent_tblt_report_classes(ari_t *id)
+{
+	tbl_t *table = NULL;
+	if((table = tbl_create(id)) == NULL)
+	{
+		return NULL;
+	}
+
+	/*
+	 * +-------------------------------------------------------------------------+
+	 * |START CUSTOM FUNCTION tblt_report_classes BODY
+	 * +-------------------------------------------------------------------------+
+	 */
+	for(int prio = 0; prio < AMP_NUM_PRIO; prio++)
+	{
+		outq_stats_t stats;
+
+		if(outq_get_stats(&(gAgentDbInst->outq), prio, &stats) != AMP_OK)
+		{
+			continue;
+		}
+
+		if((tbl_append_uint(table, prio) != AMP_OK) ||
+		   (tbl_append_uint(table, stats.held) != AMP_OK) ||
+		   (tbl_append_uvast(table, stats.sent) != AMP_OK) ||
+		   (tbl_append_uvast(table, (stats.sent > 0) ? stats.delay_ms / stats.sent : 0) != AMP_OK) ||
+		   (tbl_append_uint(table, stats.max_delay_ms) != AMP_OK))
+		{
+			tbl_release(table, 1);
+			return NULL;
+		}
+	}
+
+	/*
+	 * +-------------------------------------------------------------------------+
+	 * |STOP CUSTOM FUNCTION tblt_report_classes BODY
+	 * +-------------------------------------------------------------------------+
+	 */
+	return table;
+}
+
+
+/*
+ * This table lists, for each timed agent activity, the number of times and percentiles of its duration in microseconds.
+ */
+tbl_t *amp_agent_tblt_latencies(ari_t *id)
+{
+	tbl_t *table = NULL;
+	if((table = tbl_create(id)) == NULL)
+	{
+		return NULL;
+	}
+
+	/*
+	 * +-------------------------------------------------------------------------+
+	 * |START CUSTOM FUNCTION tblt_latencies BODY
+	 * +-------------------------------------------------------------------------+
+	 */
+	for(int lat = 0; lat < AGENT_INSTR_NUM_LATS; lat++)
+	{
+		agent_instr_lat_t summary;
+
+		agent_instr_lat_get(lat, &summary);
+		if((tbl_append_str(table, agent_instr_lat_name(lat)) != AMP_OK) ||
+		   (tbl_append_uvast(table, summary.count) != AMP_OK) ||
+		   (tbl_append_uvast(table, (summary.count > 0) ? summary.total_us / summary.count : 0) != AMP_OK) ||
+		   (tbl_append_uvast(table, summary.p50_us) != AMP_OK) ||
+		   (tbl_append_uvast(table, summary.p90_us) != AMP_OK) ||
+		   (tbl_append_uvast(table, summary.p99_us) != AMP_OK) ||
+		   (tbl_append_uvast(table, summary.max_us) != AMP_OK))
+		{
+			tbl_release(table, 1);
+			return NULL;
+		}
+	}
+
+	/*
+	 * +-------------------------------------------------------------------------+
+	 * |STOP CUSTOM FUNCTION tblt_latencies BODY
+	 * +-------------------------------------------------------------------------+
+	 */
+	return table;
+}
+
+
+/*
+ * This table lists, for each EDD collected by the agent, the number of times and its collect time in microseconds.
+ */
+tbl_t *amp_agent_tblt_edd_times(ari_t *id)
+{
+	tbl_t *table = NULL;
+	if((table = tbl_create(id)) == NULL)
+	{
+		return NULL;
+	}
+
+	/*
+	 * +-------------------------------------------------------------------------+
+	 * |START CUSTOM FUNCTION tblt_edd_times BODY
+	 * +-------------------------------------------------------------------------+
+	 */
+	for(int i = 0; i < AGENT_INSTR_EDD_SLOTS; i++)
+	{
+		agent_instr_edd_t edd;
+		tnv_t val;
+
+		if((agent_instr_edd_get(i, &edd) != AMP_OK) || (edd.count == 0))
+		{
+			continue;
+		}
+
+		tnv_init(&val, AMP_TYPE_ARI);
+		if((val.value.as_ptr = ari_copy_ptr(edd.id)) != NULL)
+		{
+			TNV_SET_ALLOC(val.flags);
+		}
+		if((val.value.as_ptr == NULL) ||
+		   (tbl_append_val(table, val) != AMP_OK) ||
+		   (tbl_append_uvast(table, edd.count) != AMP_OK) ||
+		   (tbl_append_uvast(table, edd.total_us / edd.count) != AMP_OK) ||
+		   (tbl_append_uvast(table, edd.max_us) != AMP_OK))
+		{
+			tbl_release(table, 1);
+			return NULL;
+		}
+	}
+
+	/*
+	 * +-------------------------------------------------------------------------+
+	 * |STOP CUSTOM FUNCTION tblt_edd_times BODY
+	 * +-------------------------------------------------------------------------+
+	 */
+	return table;
+}
+
+
 /* Collect Functions */
 /*
  * This is the number of report templates known to the Agent.
@@ -858,7 +1154,7 @@ tnv_t *amp_agent_get_num_rpt_tpls(tnvc_t *parms)
 	 * |START CUSTOM FUNCTION get_num_rpt_tpls BODY
 	 * +-------------------------------------------------------------------------+
 	 */
-	result = tnv_from_uint(gVDB.rpttpls.num_elts);
+	result = tnv_from_uint(gVDB.adm.rpttpls.num_elts + gVDBInst->rpttpls.num_elts);
 
 	/*
 	 * +-------------------------------------------------------------------------+
@@ -904,7 +1200,7 @@ tnv_t *amp_agent_get_sent_reports(tnvc_t *parms)
 	 * +-------------------------------------------------------------------------+
 	 */
 
-	result = tnv_from_uint(gAgentInstr.num_sent_rpts);
+	result = tnv_from_uint(agent_instr_get(AGENT_INSTR_SENT_RPTS));
 
 	/*
 	 * +-------------------------------------------------------------------------+
@@ -927,7 +1223,7 @@ tnv_t *amp_agent_get_num_tbr(tnvc_t *parms)
 	 * +-------------------------------------------------------------------------+
 	 */
 
-	result = tnv_from_uint(gAgentInstr.num_tbrs);
+	result = tnv_from_uint(agent_instr_get(AGENT_INSTR_TBRS));
 
 	/*
 	 * +-------------------------------------------------------------------------+
@@ -950,7 +1246,7 @@ tnv_t *amp_agent_get_run_tbr(tnvc_t *parms)
 	 * +-------------------------------------------------------------------------+
 	 */
 
-	result = tnv_from_uint(gAgentInstr.num_tbrs_run);
+	result = tnv_from_uint(agent_instr_get(AGENT_INSTR_TBRS_RUN));
 
 	/*
 	 * +-------------------------------------------------------------------------+
@@ -973,7 +1269,7 @@ tnv_t *amp_agent_get_num_sbr(tnvc_t *parms)
 	 * +-------------------------------------------------------------------------+
 	 */
 
-	result = tnv_from_uint(gAgentInstr.num_sbrs);
+	result = tnv_from_uint(agent_instr_get(AGENT_INSTR_SBRS));
 
 	/*
 	 * +-------------------------------------------------------------------------+
@@ -996,7 +1292,7 @@ tnv_t *amp_agent_get_run_sbr(tnvc_t *parms)
 	 * +-------------------------------------------------------------------------+
 	 */
 
-	result = tnv_from_uint(gAgentInstr.num_sbrs_run);
+	result = tnv_from_uint(agent_instr_get(AGENT_INSTR_SBRS_RUN));
 
 	/*
 	 * +-------------------------------------------------------------------------+
@@ -1042,7 +1338,7 @@ tnv_t *amp_agent_get_num_var(tnvc_t *parms)
 	 * +-------------------------------------------------------------------------+
 	 */
 
-	result = tnv_from_uint(gVDB.vars.num_elts);
+	result = tnv_from_uint(gVDB.adm.vars.num_elts + gVDBInst->vars.num_elts);
 
 	/*
 	 * +-------------------------------------------------------------------------+
@@ -1064,7 +1360,7 @@ tnv_t *amp_agent_get_num_macros(tnvc_t *parms)
 	 * |START CUSTOM FUNCTION get_num_macros BODY
 	 * +-------------------------------------------------------------------------+
 	 */
-	result = tnv_from_uint(gVDB.macdefs.num_elts);
+	result = tnv_from_uint(gVDB.adm.macdefs.num_elts + gVDBInst->macdefs.num_elts);
 
 	/*
 	 * +-------------------------------------------------------------------------+
@@ -1086,7 +1382,7 @@ tnv_t *amp_agent_get_run_macros(tnvc_t *parms)
 	 * |START CUSTOM FUNCTION get_run_macros BODY
 	 * +-------------------------------------------------------------------------+
 	 */
-	result = tnv_from_uint(gAgentInstr.num_macros_run);
+	result = tnv_from_uint(agent_instr_get(AGENT_INSTR_MACROS_RUN));
 	/*
 	 * +-------------------------------------------------------------------------+
 	 * |STOP CUSTOM FUNCTION get_run_macros BODY
@@ -1107,8 +1403,7 @@ tnv_t *amp_agent_get_num_controls(tnvc_t *parms)
 	 * |START CUSTOM FUNCTION get_num_controls BODY
 	 * +-------------------------------------------------------------------------+
 	 */
-	//FIXME: not thread safe
-	result = tnv_from_uint(gVDB.ctrls.total_slots - gVDB.ctrls.num_free);
+	result = tnv_from_uint(timeq_size(&(gVDBInst->ctrls)));
 
 	/*
 	 * +-------------------------------------------------------------------------+
@@ -1130,7 +1425,7 @@ tnv_t *amp_agent_get_run_controls(tnvc_t *parms)
 	 * |START CUSTOM FUNCTION get_run_controls BODY
 	 * +-------------------------------------------------------------------------+
 	 */
-	result = tnv_from_uint(gAgentInstr.num_ctrls_run);
+	result = tnv_from_uint(agent_instr_get(AGENT_INSTR_CTRLS_RUN));
 
 	/*
 	 * +-------------------------------------------------------------------------+
@@ -1167,6 +1462,153 @@ tnv_t *amp_agent_get_cur_time(tnvc_t *parms)
 }
 
 
+/*
+ * This is the number of messages held by the agent until they can be sent.
+ */
+tnv_t *amp_agent_get_queued_msgs(tnvc_t *parms)
+{
+	tnv_t *result = NULL;
+	/*
+	 * +-------------------------------------------------------------------------+
+	 * |START CUSTOM FUNCTION get_queued_msgs BODY
+	 * +-------------------------------------------------------------------------+
+	 */
+	result = tnv_from_uint(outq_size(&(gAgentDbInst->outq)));
+	/*
+	 * +-------------------------------------------------------------------------+
+	 * |STOP CUSTOM FUNCTION get_queued_msgs BODY
+	 * +-------------------------------------------------------------------------+
+	 */
+	return result;
+}
+
+
+/*
+ * This is the size in bytes of the messages held by the agent until they can be sent.
+ */
+tnv_t *amp_agent_get_queued_bytes(tnvc_t *parms)
+{
+	tnv_t *result = NULL;
+	/*
+	 * +-------------------------------------------------------------------------+
+	 * |START CUSTOM FUNCTION get_queued_bytes BODY
+	 * +-------------------------------------------------------------------------+
+	 */
+	result = tnv_from_uvast(outq_bytes(&(gAgentDbInst->outq)));
+	/*
+	 * +-------------------------------------------------------------------------+
+	 * |STOP CUSTOM FUNCTION get_queued_bytes BODY
+	 * +-------------------------------------------------------------------------+
+	 */
+	return result;
+}
+
+
+/*
+ * This is the 99th percentile, in microseconds, of how late rules run after they are due.
+ */
+tnv_t *amp_agent_get_rule_lag_p99(tnvc_t *parms)
+{
+	tnv_t *result = NULL;
+	/*
+	 * +-------------------------------------------------------------------------+
+	 * |START CUSTOM FUNCTION get_rule_lag_p99 BODY
+	 * +-------------------------------------------------------------------------+
+	 */
+	result = amp_agent_get_lat_p99(AGENT_INSTR_LAT_RULE_LAG);
+	/*
+	 * +-------------------------------------------------------------------------+
+	 * |STOP CUSTOM FUNCTION get_rule_lag_p99 BODY
+	 * +-------------------------------------------------------------------------+
+	 */
+	return result;
+}
+
+
+/*
+ * This is the 99th percentile, in microseconds, of the time to collect one EDD value.
+ */
+tnv_t *amp_agent_get_edd_collect_p99(tnvc_t *parms)
+{
+	tnv_t *result = NULL;
+	/*
+	 * +-------------------------------------------------------------------------+
+	 * |START CUSTOM FUNCTION get_edd_collect_p99 BODY
+	 * +-------------------------------------------------------------------------+
+	 */
+	result = amp_agent_get_lat_p99(AGENT_INSTR_LAT_EDD_COLLECT);
+	/*
+	 * +-------------------------------------------------------------------------+
+	 * |STOP CUSTOM FUNCTION get_edd_collect_p99 BODY
+	 * +-------------------------------------------------------------------------+
+	 */
+	return result;
+}
+
+
+/*
+ * This is the 99th percentile, in microseconds, of the time to run one control.
+ */
+tnv_t *amp_agent_get_ctrl_run_p99(tnvc_t *parms)
+{
+	tnv_t *result = NULL;
+	/*
+	 * +-------------------------------------------------------------------------+
+	 * |START CUSTOM FUNCTION get_ctrl_run_p99 BODY
+	 * +-------------------------------------------------------------------------+
+	 */
+	result = amp_agent_get_lat_p99(AGENT_INSTR_LAT_CTRL_RUN);
+	/*
+	 * +-------------------------------------------------------------------------+
+	 * |STOP CUSTOM FUNCTION get_ctrl_run_p99 BODY
+	 * +-------------------------------------------------------------------------+
+	 */
+	return result;
+}
+
+
+/*
+ * This is the 99th percentile, in microseconds, of the time from building a report message to sending it.
+ */
+tnv_t *amp_agent_get_rpt_queue_p99(tnvc_t *parms)
+{
+	tnv_t *result = NULL;
+	/*
+	 * +-------------------------------------------------------------------------+
+	 * |START CUSTOM FUNCTION get_rpt_queue_p99 BODY
+	 * +-------------------------------------------------------------------------+
+	 */
+	result = amp_agent_get_lat_p99(AGENT_INSTR_LAT_RPT_QUEUE);
+	/*
+	 * +-------------------------------------------------------------------------+
+	 * |STOP CUSTOM FUNCTION get_rpt_queue_p99 BODY
+	 * +-------------------------------------------------------------------------+
+	 */
+	return result;
+}
+
+
+/*
+ * This is the 99th percentile, in microseconds, of the time to encode and send one report message.
+ */
+tnv_t *amp_agent_get_rpt_send_p99(tnvc_t *parms)
+{
+	tnv_t *result = NULL;
+	/*
+	 * +-------------------------------------------------------------------------+
+	 * |START CUSTOM FUNCTION get_rpt_send_p99 BODY
+	 * +-------------------------------------------------------------------------+
+	 */
+	result = amp_agent_get_lat_p99(AGENT_INSTR_LAT_RPT_SEND);
+	/*
+	 * +-------------------------------------------------------------------------+
+	 * |STOP CUSTOM FUNCTION get_rpt_send_p99 BODY
+	 * +-------------------------------------------------------------------------+
+	 */
+	return result;
+}
+
+
 
 /* Control Functions */
 
@@ -1264,7 +1706,7 @@ tnv_t *amp_agent_ctrl_del_var(eid_t *def_mgr, tnvc_t *parms, int8_t *status)
 		}
 		else
 		{
-//			db_forget(&(var->desc), gDB.vars);
+			db_forget(&(var->desc));
 			VDB_DELKEY_VAR(cur_id);
 		}
 	}
@@ -1368,7 +1810,7 @@ tnv_t *amp_agent_ctrl_del_rptt(eid_t *def_mgr, tnvc_t *parms, int8_t *status)
 		}
 		else
 		{
-//			db_forget(&(def->desc), gDB.rpttpls);
+			db_forget(&(def->desc));
 			VDB_DELKEY_RPTT(cur_id);
 		}
 	}
@@ -1456,7 +1898,8 @@ tnv_t *amp_agent_ctrl_gen_rpts(eid_t *def_mgr, tnvc_t *parms, int8_t *status)
 
 
 	vecit_t ac_it;
-	vecit_t mgr_it;
+	uint8_t mgr_idx;
+	uint8_t num_mgrs;
 
 	ac_t *ids = adm_get_parm_obj(parms, 0, AMP_TYPE_AC);
 	tnvc_t *mgrs = adm_get_parm_obj(parms, 1, AMP_TYPE_TNVC);
@@ -1467,33 +1910,33 @@ tnv_t *amp_agent_ctrl_gen_rpts(eid_t *def_mgr, tnvc_t *parms, int8_t *status)
 		return result;
 	}
 
-	if(tnvc_get_count(mgrs) == 0)
-	{
-		if((tnvc_insert(mgrs, tnv_from_str(def_mgr->name))) != AMP_OK)
-		{
-			AMP_DEBUG_ERR("GEN_RPTT","Empty TNVC and can't add default mgr.", NULL);
-			return result;
-		}
-	}
+	/* With no managers given, send to the default manager. */
+	num_mgrs = tnvc_get_count(mgrs);
 
 	/* For each manager receiving a report. */
-	for(mgr_it = vecit_first(&(mgrs->values)); vecit_valid(mgr_it); mgr_it = vecit_next(mgr_it))
+	for(mgr_idx = 0; mgr_idx < ((num_mgrs > 0) ? num_mgrs : 1); mgr_idx++)
 	{
-		tnv_t *cur_mgr = (tnv_t*)vecit_data(mgr_it);
+		tnv_t *cur_mgr = tnvc_get(mgrs, mgr_idx);
+		const char *mgr_name = def_mgr->name;
 		eid_t mgr_eid;
 		msg_rpt_t* msg_rpt;
 
-		if((cur_mgr == NULL) || (cur_mgr->type != AMP_TYPE_STR))
+		if(num_mgrs > 0)
 		{
-			AMP_DEBUG_ERR("GEN_RPTT","Cannot parse MGR EID to send to.", NULL);
-			return result;
+			if((cur_mgr == NULL) || (cur_mgr->type != AMP_TYPE_STR))
+			{
+				AMP_DEBUG_ERR("GEN_RPTT","Cannot parse MGR EID to send to.", NULL);
+				return result;
+			}
+			mgr_name = cur_mgr->value.as_ptr;
 		}
 
-                pthread_mutex_lock(&gAgentDb.rpt_msgs.lock);
-		strncpy(mgr_eid.name, cur_mgr->value.as_ptr, AMP_MAX_EID_LEN-1);
+                pthread_mutex_lock(&gAgentDbInst->rpt_msgs.lock);
+		strncpy(mgr_eid.name, mgr_name, AMP_MAX_EID_LEN-1);
 		msg_rpt = rda_get_msg_rpt(mgr_eid);
 
-		/* For each report being sent. */
+		/* For each report being sent, all from the same snapshots. */
+		ldc_cycle_begin();
 		for(ac_it = vecit_first(&(ids->values)); vecit_valid(ac_it); ac_it = vecit_next(ac_it))
 		{
 			ari_t *cur_id = vecit_data(ac_it);
@@ -1515,10 +1958,11 @@ tnv_t *amp_agent_ctrl_gen_rpts(eid_t *def_mgr, tnvc_t *parms, int8_t *status)
 
 			msg_rpt_add_rpt(msg_rpt, rpt);
 		}
+		ldc_cycle_end();
 
                 AMP_DEBUG_ERR("GEN_RPTT","Finished adding %d reports for: %s", vec_num_entries(msg_rpt->rpts), mgr_eid.name);
-                pthread_cond_signal(&gAgentDb.rpt_msgs.cond_ins_mod);
-                pthread_mutex_unlock(&gAgentDb.rpt_msgs.lock);
+                pthread_cond_signal(&gAgentDbInst->rpt_msgs.cond_ins_mod);
+                pthread_mutex_unlock(&gAgentDbInst->rpt_msgs.lock);
 	}
 
 	*status = CTRL_SUCCESS;
@@ -1547,7 +1991,8 @@ tnv_t *amp_agent_ctrl_gen_tbls(eid_t *def_mgr, tnvc_t *parms, int8_t *status)
 	 */
 
 	vecit_t ac_it;
-	vecit_t mgr_it;
+	uint8_t mgr_idx;
+	uint8_t num_mgrs;
 
 	ac_t *ids = adm_get_parm_obj(parms, 0, AMP_TYPE_AC);
 	tnvc_t *mgrs = adm_get_parm_obj(parms, 1, AMP_TYPE_TNVC);
@@ -1558,55 +2003,52 @@ tnv_t *amp_agent_ctrl_gen_tbls(eid_t *def_mgr, tnvc_t *parms, int8_t *status)
 		return result;
 	}
 
-	if(tnvc_get_count(mgrs) == 0)
-	{
-		if((tnvc_insert(mgrs, tnv_from_str(def_mgr->name))) != AMP_OK)
-		{
-			AMP_DEBUG_ERR("GEN_TBLT","Empty TNVC and can't add default mgr.", NULL);
-			return result;
-		}
-	}
+	/* With no managers given, send to the default manager. */
+	num_mgrs = tnvc_get_count(mgrs);
 
 	/* For each manager receiving a report. */
-	for(mgr_it = vecit_first(&(mgrs->values)); vecit_valid(mgr_it); mgr_it = vecit_next(mgr_it))
+	for(mgr_idx = 0; mgr_idx < ((num_mgrs > 0) ? num_mgrs : 1); mgr_idx++)
 	{
-		tnv_t *cur_mgr = (tnv_t*)vecit_data(mgr_it);
+		tnv_t *cur_mgr = tnvc_get(mgrs, mgr_idx);
+		const char *mgr_name = def_mgr->name;
 		eid_t mgr_eid;
-		msg_tbl_t* msg_tbl = NULL;
 
-		if((cur_mgr == NULL) || (cur_mgr->type != AMP_TYPE_STR))
+		if(num_mgrs > 0)
 		{
-			AMP_DEBUG_ERR("GEN_TBLT","Cannot parse MGR EID to send to.", NULL);
-			return result;
+			if((cur_mgr == NULL) || (cur_mgr->type != AMP_TYPE_STR))
+			{
+				AMP_DEBUG_ERR("GEN_TBLT","Cannot parse MGR EID to send to.", NULL);
+				return result;
+			}
+			mgr_name = cur_mgr->value.as_ptr;
 		}
 
-		strncpy(mgr_eid.name, cur_mgr->value.as_ptr, AMP_MAX_EID_LEN-1);
+		strncpy(mgr_eid.name, mgr_name, AMP_MAX_EID_LEN-1);
 
-		msg_tbl = rda_get_msg_tbl(mgr_eid);
-
-		/* For each table being sent. */
+		/*
+		 * For each table being sent, all from the same snapshots. Tables
+		 * from incremental templates go as their changes since last sent.
+		 */
+		ldc_cycle_begin();
 		for(ac_it = vecit_first(&(ids->values)); vecit_valid(ac_it); ac_it = vecit_next(ac_it))
 		{
 			ari_t *cur_id = vecit_data(ac_it);
 			tblt_t *def = VDB_FINDKEY_TBLT(cur_id);
-			tbl_t *tbl = NULL;
-			tnv_t *val = NULL;
 
-			if( (def == NULL) ||
-				((tbl = def->build(cur_id)) == NULL) ||
-				((val = tnv_from_obj(AMP_TYPE_TBL, tbl)) == NULL))
+			if((def == NULL) || (rda_add_tbl(mgr_eid, def, cur_id) != AMP_OK))
 			{
-				tbl_release(tbl, 1);
-
 				AMP_DEBUG_ERR("GEN_TBLT","Cannot build table.", NULL);
-				continue;
 			}
-
-			msg_tbl_add_tbl(msg_tbl, tbl);
 		}
+		ldc_cycle_end();
 
 	}
 
+	/* Wake the sender, which waits on the report queue. */
+	pthread_mutex_lock(&(gAgentDbInst->rpt_msgs.lock));
+	pthread_cond_broadcast(&(gAgentDbInst->rpt_msgs.cond_ins_mod));
+	pthread_mutex_unlock(&(gAgentDbInst->rpt_msgs.lock));
+
 	*status = CTRL_SUCCESS;
 
 	/*
@@ -1651,6 +2093,11 @@ tnv_t *amp_agent_ctrl_add_macro(eid_t *def_mgr, tnvc_t *parms, int8_t *status)
 		macdef_append(macro, cur_ctrl);
 	}
 
+	if(macdef_compile(macro) != AMP_OK)
+	{
+		AMP_DEBUG_WARN("ADD_MACRO", "Macro will run uncompiled.", NULL);
+	}
+
 	if(VDB_FINDKEY_MACDEF(macro->ari) == NULL)
 	{
 		int rh_code = VDB_ADD_MACDEF(macro->ari, macro);
@@ -1715,7 +2162,7 @@ tnv_t *amp_agent_ctrl_del_macro(eid_t *def_mgr, tnvc_t *parms, int8_t *status)
 		}
 		else
 		{
-//			db_forget(&(def->desc), gDB.macdefs);
+			db_forget(&(def->desc));
 			VDB_DELKEY_MACDEF(cur_id);
 		}
 	}
@@ -1836,7 +2283,7 @@ tnv_t *amp_agent_ctrl_add_tbr(eid_t *def_mgr, tnvc_t *parms, int8_t *status)
 		}
 		else
 		{
-			gAgentInstr.num_tbrs++;
+			agent_instr_inc(AGENT_INSTR_TBRS);
 			*status = CTRL_SUCCESS;
 			db_persist_rule(tbr);
 		}
@@ -1906,7 +2353,7 @@ tnv_t *amp_agent_ctrl_add_sbr(eid_t *def_mgr, tnvc_t *parms, int8_t *status)
 		}
 		else
 		{
-			gAgentInstr.num_sbrs++;
+			agent_instr_inc(AGENT_INSTR_SBRS);
 			*status = CTRL_SUCCESS;
 			db_persist_rule(sbr);
 		}
@@ -1960,7 +2407,7 @@ tnv_t *amp_agent_ctrl_del_rule(eid_t *def_mgr, tnvc_t *parms, int8_t *status)
 		}
 		else
 		{
-//			db_forget(&(rule->desc), gDB.rules);
+			db_forget(&(rule->desc));
 			VDB_DELKEY_RULE(cur_id);
 		}
 	}
@@ -2055,6 +2502,24 @@ tnv_t *amp_agent_ctrl_store_var(eid_t *def_mgr, tnvc_t *parms, int8_t *status)
 	}
 
 	tnv_t *tmp = expr_eval(expr);
+
+	/* ADM variables are shared by all instances, so this instance stores
+	 * into its own copy, which is found before the shared one from now on.
+	 */
+	if((tmp != NULL) && (var == VDB_FINDKEY_ADM_VAR(id)))
+	{
+		var_t *copy = var_copy_ptr(var);
+
+		if((copy == NULL) || (VDB_ADD_VAR(copy->id, copy) != RH_OK))
+		{
+			AMP_DEBUG_ERR("stor_var","Cannot copy ADM variable.", NULL);
+			var_release(copy, 1);
+			tnv_release(tmp, 1);
+			return result;
+		}
+		var = copy;
+	}
+
 	if(tmp != NULL)
 	{
 		tnv_release(var->value, 1);
@@ -2100,6 +2565,85 @@ tnv_t *amp_agent_ctrl_reset_counts(eid_t *def_mgr, tnvc_t *parms, int8_t *status
 }
 
 
+/*
+ * This control sets the priority class, from 0 (urgent) to 3 (bulk), of reports and tables produced b
+ * y each identified rule or control.
+ */
+tnv_t *amp_agent_ctrl_set_class(eid_t *def_mgr, tnvc_t *parms, int8_t *status)
+{
+	tnv_t *result = NULL;
+	*status = CTRL_FAILURE;
+	/*
+	 * +-------------------------------------------------------------------------+
+	 * |START CUSTOM FUNCTION ctrl_set_class BODY
+	 * +-------------------------------------------------------------------------+
+	 */
+
+	int success;
+	vecit_t it;
+	ac_t *ids = adm_get_parm_obj(parms, 0, AMP_TYPE_AC);
+	uint32_t prio = adm_get_parm_uint(parms, 1, &success);
+
+	if((ids == NULL) || (success != AMP_OK) || (prio >= AMP_NUM_PRIO))
+	{
+		AMP_DEBUG_ERR("SET_CLASS", "Bad parameters.", NULL);
+		return result;
+	}
+
+	for(it = vecit_first(&(ids->values)); vecit_valid(it); it = vecit_next(it))
+	{
+		ari_t *cur_id = vecit_data(it);
+
+		if((cur_id->type == AMP_TYPE_TBR) || (cur_id->type == AMP_TYPE_SBR))
+		{
+			rule_t *rule;
+
+			/* The rules thread reads the class as it fires the rule. */
+			pthread_mutex_lock(&(gVDBInst->rules.lock));
+			if((rule = VDB_FINDKEY_RULE(cur_id)) == NULL)
+			{
+				pthread_mutex_unlock(&(gVDBInst->rules.lock));
+				AMP_DEBUG_WARN("SET_CLASS", "Cannot find RULE.", NULL);
+				continue;
+			}
+			rule->prio = prio;
+			db_persist_rule_state(rule);
+			pthread_mutex_unlock(&(gVDBInst->rules.lock));
+		}
+		else if(cur_id->type == AMP_TYPE_CTRL)
+		{
+			/* Control classes are not persisted, only rule classes are.
+			 * They apply only to the agent instance running this control.
+			 */
+			ctrldef_t *def = VDB_FINDKEY_CTRLDEF(cur_id);
+
+			if(def == NULL)
+			{
+				AMP_DEBUG_WARN("SET_CLASS", "Cannot find CTRL.", NULL);
+				continue;
+			}
+			if(ctrldef_set_class(def, prio) != AMP_OK)
+			{
+				AMP_DEBUG_WARN("SET_CLASS", "Cannot set class of CTRL.", NULL);
+			}
+		}
+		else
+		{
+			AMP_DEBUG_WARN("SET_CLASS", "Cannot set class of type %d.", cur_id->type);
+		}
+	}
+
+	*status = CTRL_SUCCESS;
+
+	/*
+	 * +-------------------------------------------------------------------------+
+	 * |STOP CUSTOM FUNCTION ctrl_set_class BODY
+	 * +-------------------------------------------------------------------------+
+	 */
+	return result;
+}
+
+
 
 /* OP Functions */
 
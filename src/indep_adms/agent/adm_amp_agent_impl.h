@@ -19,7 +19,7 @@
 #define ADM_AMP_AGENT_IMPL_H_
 
 /*   START CUSTOM INCLUDES HERE  */
-/*             TODO              */
+#include "agent/instr.h"
 /*   STOP CUSTOM INCLUDES HERE  */
 
 
@@ -80,6 +80,57 @@ int adm_agent_op_prep(uint8_t num, tnv_t **lval, tnv_t **rval, vector_t *stack);
 tnv_t *amp_agent_binary_num_op(amp_agent_op_e op, vector_t *stack, amp_type_e result_type);
 tnv_t *adm_agent_unary_num_op(amp_agent_op_e op, vector_t *stack, amp_type_e result_type);
 
+/* Typed kernels of the numeric operators, named after the operator. */
+int amp_agent_kernel_plusint(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_minusint(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_multint(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_divint(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_modint(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_expint(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_plusuint(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_minusuint(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_multuint(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_divuint(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_moduint(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_expuint(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_plusvast(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_minusvast(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_multvast(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_divvast(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_modvast(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_expvast(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_plusuvast(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_minusuvast(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_multuvast(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_divuvast(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_moduvast(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_expuvast(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_plusreal32(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_minusreal32(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_multreal32(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_divreal32(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_expreal32(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_plusreal64(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_minusreal64(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_multreal64(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_divreal64(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_expreal64(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_bitand(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_bitor(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_bitxor(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_bitshiftleft(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_bitshiftright(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_logand(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_logor(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_lessthan(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_greaterthan(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_lessequal(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_greaterequal(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_notequal(const tnv_t *args, tnv_t *result);
+int amp_agent_kernel_equal(const tnv_t *args, tnv_t *result);
+
+tnv_t *amp_agent_get_lat_p99(agent_instr_lat_e lat);
+
 /*   STOP CUSTOM FUNCTIONS HERE  */
 
 void amp_agent_setup();
@@ -110,6 +161,13 @@ tnv_t *amp_agent_get_run_macros(tnvc_t *parms);
 tnv_t *amp_agent_get_num_controls(tnvc_t *parms);
 tnv_t *amp_agent_get_run_controls(tnvc_t *parms);
 tnv_t *amp_agent_get_cur_time(tnvc_t *parms);
+tnv_t *amp_agent_get_queued_msgs(tnvc_t *parms);
+tnv_t *amp_agent_get_queued_bytes(tnvc_t *parms);
+tnv_t *amp_agent_get_rule_lag_p99(tnvc_t *parms);
+tnv_t *amp_agent_get_edd_collect_p99(tnvc_t *parms);
+tnv_t *amp_agent_get_ctrl_run_p99(tnvc_t *parms);
+tnv_t *amp_agent_get_rpt_queue_p99(tnvc_t *parms);
+tnv_t *amp_agent_get_rpt_send_p99(tnvc_t *parms);
 
 
 /* Control Functions */
@@ -129,6 +187,7 @@ tnv_t *amp_agent_ctrl_del_rule(eid_t *def_mgr, tnvc_t *parms, int8_t *status);
 tnv_t *amp_agent_ctrl_desc_rule(eid_t *def_mgr, tnvc_t *parms, int8_t *status);
 tnv_t *amp_agent_ctrl_store_var(eid_t *def_mgr, tnvc_t *parms, int8_t *status);
 tnv_t *amp_agent_ctrl_reset_counts(eid_t *def_mgr, tnvc_t *parms, int8_t *status);
+tnv_t *amp_agent_ctrl_set_class(eid_t *def_mgr, tnvc_t *parms, int8_t *status);
 
 
 /* OP Functions */
@@ -194,6 +253,9 @@ tbl_t *amp_agent_tblt_rptts(ari_t *id);
 tbl_t *amp_agent_tblt_macros(ari_t *id);
 tbl_t *amp_agent_tblt_rules(ari_t *id);
 tbl_t *amp_agent_tblt_tblts(ari_t *id);
+tbl_t *amp_agent_tblt_report_classes(ari_t *id);
+tbl_t *amp_agent_tblt_latencies(ari_t *id);
+tbl_t *amp_agent_tblt_edd_times(ari_t *id);
 
 #ifdef __cplusplus
 }
@@ -28,7 +28,7 @@
 extern "C" {
 #endif
 
-extern vec_idx_t g_amp_agent_idx[11];
+extern reg_idx_t g_amp_agent_idx[11];
 
 /*
  * +---------------------------------------------------------------------------------------------+
@@ -119,6 +119,33 @@ extern vec_idx_t g_amp_agent_idx[11];
  * +---------------------+--------------------------------------+-------+
  * |cur_time             |This is the current system time.      |TV     |
  * +---------------------+--------------------------------------+-------+
+ * |queued_msgs          |This is the number of messages held by|       |
+ * |                     | the agent until they can be sent.    |UINT   |
+ * +---------------------+--------------------------------------+-------+
+ * |queued_bytes         |This is the size in bytes of the messa|       |
+ * |                     |ges held by the agent until they can b|       |
+ * |                     |e sent.                               |UVAST  |
+ * +---------------------+--------------------------------------+-------+
+ * |rule_lag_p99         |This is the 99th percentile, in micros|       |
+ * |                     |econds, of how late rules run after th|       |
+ * |                     |ey are due.                           |UVAST  |
+ * +---------------------+--------------------------------------+-------+
+ * |edd_collect_p99      |This is the 99th percentile, in micros|       |
+ * |                     |econds, of the time to collect one EDD|       |
+ * |                     | value.                               |UVAST  |
+ * +---------------------+--------------------------------------+-------+
+ * |ctrl_run_p99         |This is the 99th percentile, in micros|       |
+ * |                     |econds, of the time to run one control|       |
+ * |                     |.                                     |UVAST  |
+ * +---------------------+--------------------------------------+-------+
+ * |rpt_queue_p99        |This is the 99th percentile, in micros|       |
+ * |                     |econds, of the time from building a re|       |
+ * |                     |port message to sending it.           |UVAST  |
+ * +---------------------+--------------------------------------+-------+
+ * |rpt_send_p99         |This is the 99th percentile, in micros|       |
+ * |                     |econds, of the time to encode and send|       |
+ * |                     | one report message.                  |UVAST  |
+ * +---------------------+--------------------------------------+-------+
  */
 #define AMP_AGENT_EDD_NUM_RPT_TPLS 0x00
 #define AMP_AGENT_EDD_NUM_TBL_TPLS 0x01
@@ -134,6 +161,13 @@ extern vec_idx_t g_amp_agent_idx[11];
 #define AMP_AGENT_EDD_NUM_CONTROLS 0x0b
 #define AMP_AGENT_EDD_RUN_CONTROLS 0x0c
 #define AMP_AGENT_EDD_CUR_TIME 0x0d
+#define AMP_AGENT_EDD_QUEUED_MSGS 0x0e
+#define AMP_AGENT_EDD_QUEUED_BYTES 0x0f
+#define AMP_AGENT_EDD_RULE_LAG_P99 0x10
+#define AMP_AGENT_EDD_EDD_COLLECT_P99 0x11
+#define AMP_AGENT_EDD_CTRL_RUN_P99 0x12
+#define AMP_AGENT_EDD_RPT_QUEUE_P99 0x13
+#define AMP_AGENT_EDD_RPT_SEND_P99 0x14
 
 
 /*
@@ -188,6 +222,19 @@ extern vec_idx_t g_amp_agent_idx[11];
  * |                     |le template that is known to the agent|       |
  * |                     |.                                     |       |
  * +---------------------+--------------------------------------+-------+
+ * |report_classes       |This table lists, for each report prio|       |
+ * |                     |rity class, the messages held and sent|       |
+ * |                     | and their queueing delay.            |       |
+ * +---------------------+--------------------------------------+-------+
+ * |latencies            |This table lists, for each timed agent|       |
+ * |                     | activity, the number of times and per|       |
+ * |                     |centiles of its duration in microsecon|       |
+ * |                     |ds.                                   |       |
+ * +---------------------+--------------------------------------+-------+
+ * |edd_times            |This table lists, for each EDD collect|       |
+ * |                     |ed by the agent, the number of times a|       |
+ * |                     |nd its collect time in microseconds.  |       |
+ * +---------------------+--------------------------------------+-------+
  */
 #define AMP_AGENT_TBLT_ADMS 0x00
 #define AMP_AGENT_TBLT_VARIABLES 0x01
@@ -195,6 +242,9 @@ extern vec_idx_t g_amp_agent_idx[11];
 #define AMP_AGENT_TBLT_MACROS 0x03
 #define AMP_AGENT_TBLT_RULES 0x04
 #define AMP_AGENT_TBLT_TBLTS 0x05
+#define AMP_AGENT_TBLT_REPORT_CLASSES 0x06
+#define AMP_AGENT_TBLT_LATENCIES 0x07
+#define AMP_AGENT_TBLT_EDD_TIMES 0x08
 
 
 /*
@@ -258,6 +308,11 @@ extern vec_idx_t g_amp_agent_idx[11];
  * |                     |istics reported in the Agent ADM repor|       |
  * |                     |t.                                    |       |
  * +---------------------+--------------------------------------+-------+
+ * |set_class            |This control sets the priority class, |       |
+ * |                     |from 0 (urgent) to 3 (bulk), of report|       |
+ * |                     |s and tables produced by each identifi|       |
+ * |                     |ed rule or control.                   |       |
+ * +---------------------+--------------------------------------+-------+
  */
 #define AMP_AGENT_CTRL_ADD_VAR 0x00
 #define AMP_AGENT_CTRL_DEL_VAR 0x01
@@ -275,6 +330,7 @@ extern vec_idx_t g_amp_agent_idx[11];
 #define AMP_AGENT_CTRL_DESC_RULE 0x0d
 #define AMP_AGENT_CTRL_STORE_VAR 0x0e
 #define AMP_AGENT_CTRL_RESET_COUNTS 0x0f
+#define AMP_AGENT_CTRL_SET_CLASS 0x10
 
 
 /*
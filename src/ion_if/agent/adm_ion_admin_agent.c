@@ -30,7 +30,7 @@
 #define _HAVE_DTN_ION_IONADMIN_ADM_
 #ifdef _HAVE_DTN_ION_IONADMIN_ADM_
 
-static vec_idx_t g_dtn_ion_ionadmin_idx[11];
+static reg_idx_t g_dtn_ion_ionadmin_idx[11];
 
 void dtn_ion_ionadmin_init()
 {
@@ -54,13 +54,17 @@ void dtn_ion_ionadmin_init()
 	dtn_ion_ionadmin_init_tblt();
 }
 
+static const adm_desc_t dtn_ion_ionadmin_meta_descs[] = {
+	ADM_DESC_CNST(ADM_META_IDX, DTN_ION_IONADMIN_META_NAME, dtn_ion_ionadmin_meta_name),
+	ADM_DESC_CNST(ADM_META_IDX, DTN_ION_IONADMIN_META_NAMESPACE, dtn_ion_ionadmin_meta_namespace),
+	ADM_DESC_CNST(ADM_META_IDX, DTN_ION_IONADMIN_META_VERSION, dtn_ion_ionadmin_meta_version),
+	ADM_DESC_CNST(ADM_META_IDX, DTN_ION_IONADMIN_META_ORGANIZATION, dtn_ion_ionadmin_meta_organization),
+};
+
 void dtn_ion_ionadmin_init_meta()
 {
 
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_dtn_ion_ionadmin_idx[ADM_META_IDX], DTN_ION_IONADMIN_META_NAME), dtn_ion_ionadmin_meta_name);
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_dtn_ion_ionadmin_idx[ADM_META_IDX], DTN_ION_IONADMIN_META_NAMESPACE), dtn_ion_ionadmin_meta_namespace);
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_dtn_ion_ionadmin_idx[ADM_META_IDX], DTN_ION_IONADMIN_META_VERSION), dtn_ion_ionadmin_meta_version);
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_dtn_ion_ionadmin_idx[ADM_META_IDX], DTN_ION_IONADMIN_META_ORGANIZATION), dtn_ion_ionadmin_meta_organization);
+	adm_add_descs(g_dtn_ion_ionadmin_idx, dtn_ion_ionadmin_meta_descs, ADM_NUM_DESCS(dtn_ion_ionadmin_meta_descs));
 }
 
 void dtn_ion_ionadmin_init_cnst()
@@ -68,23 +72,27 @@ void dtn_ion_ionadmin_init_cnst()
 
 }
 
+static const adm_desc_t dtn_ion_ionadmin_edd_descs[] = {
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_ION_IONADMIN_EDD_CLOCK_ERROR, 0, dtn_ion_ionadmin_get_clock_error),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_ION_IONADMIN_EDD_CLOCK_SYNC, 0, dtn_ion_ionadmin_get_clock_sync),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_ION_IONADMIN_EDD_CONGESTION_ALARM_CONTROL, 0, dtn_ion_ionadmin_get_congestion_alarm_control),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_ION_IONADMIN_EDD_CONGESTION_END_TIME_FORECASTS, 0, dtn_ion_ionadmin_get_congestion_end_time_forecasts),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_ION_IONADMIN_EDD_CONSUMPTION_RATE, 0, dtn_ion_ionadmin_get_consumption_rate),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_ION_IONADMIN_EDD_INBOUND_FILE_SYSTEM_OCCUPANCY_LIMIT, 0, dtn_ion_ionadmin_get_inbound_file_system_occupancy_limit),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_ION_IONADMIN_EDD_INBOUND_HEAP_OCCUPANCY_LIMIT, 0, dtn_ion_ionadmin_get_inbound_heap_occupancy_limit),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_ION_IONADMIN_EDD_NUMBER, 0, dtn_ion_ionadmin_get_number),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_ION_IONADMIN_EDD_OUTBOUND_FILE_SYSTEM_OCCUPANCY_LIMIT, 0, dtn_ion_ionadmin_get_outbound_file_system_occupancy_limit),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_ION_IONADMIN_EDD_OUTBOUND_HEAP_OCCUPANCY_LIMIT, 0, dtn_ion_ionadmin_get_outbound_heap_occupancy_limit),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_ION_IONADMIN_EDD_PRODUCTION_RATE, 0, dtn_ion_ionadmin_get_production_rate),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_ION_IONADMIN_EDD_REF_TIME, 0, dtn_ion_ionadmin_get_ref_time),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_ION_IONADMIN_EDD_TIME_DELTA, 0, dtn_ion_ionadmin_get_time_delta),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_ION_IONADMIN_EDD_VERSION, 0, dtn_ion_ionadmin_get_version),
+};
+
 void dtn_ion_ionadmin_init_edd()
 {
 
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_ion_ionadmin_idx[ADM_EDD_IDX], DTN_ION_IONADMIN_EDD_CLOCK_ERROR), dtn_ion_ionadmin_get_clock_error);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_ion_ionadmin_idx[ADM_EDD_IDX], DTN_ION_IONADMIN_EDD_CLOCK_SYNC), dtn_ion_ionadmin_get_clock_sync);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_ion_ionadmin_idx[ADM_EDD_IDX], DTN_ION_IONADMIN_EDD_CONGESTION_ALARM_CONTROL), dtn_ion_ionadmin_get_congestion_alarm_control);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_ion_ionadmin_idx[ADM_EDD_IDX], DTN_ION_IONADMIN_EDD_CONGESTION_END_TIME_FORECASTS), dtn_ion_ionadmin_get_congestion_end_time_forecasts);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_ion_ionadmin_idx[ADM_EDD_IDX], DTN_ION_IONADMIN_EDD_CONSUMPTION_RATE), dtn_ion_ionadmin_get_consumption_rate);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_ion_ionadmin_idx[ADM_EDD_IDX], DTN_ION_IONADMIN_EDD_INBOUND_FILE_SYSTEM_OCCUPANCY_LIMIT), dtn_ion_ionadmin_get_inbound_file_system_occupancy_limit);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_ion_ionadmin_idx[ADM_EDD_IDX], DTN_ION_IONADMIN_EDD_INBOUND_HEAP_OCCUPANCY_LIMIT), dtn_ion_ionadmin_get_inbound_heap_occupancy_limit);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_ion_ionadmin_idx[ADM_EDD_IDX], DTN_ION_IONADMIN_EDD_NUMBER), dtn_ion_ionadmin_get_number);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_ion_ionadmin_idx[ADM_EDD_IDX], DTN_ION_IONADMIN_EDD_OUTBOUND_FILE_SYSTEM_OCCUPANCY_LIMIT), dtn_ion_ionadmin_get_outbound_file_system_occupancy_limit);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_ion_ionadmin_idx[ADM_EDD_IDX], DTN_ION_IONADMIN_EDD_OUTBOUND_HEAP_OCCUPANCY_LIMIT), dtn_ion_ionadmin_get_outbound_heap_occupancy_limit);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_ion_ionadmin_idx[ADM_EDD_IDX], DTN_ION_IONADMIN_EDD_PRODUCTION_RATE), dtn_ion_ionadmin_get_production_rate);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_ion_ionadmin_idx[ADM_EDD_IDX], DTN_ION_IONADMIN_EDD_REF_TIME), dtn_ion_ionadmin_get_ref_time);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_ion_ionadmin_idx[ADM_EDD_IDX], DTN_ION_IONADMIN_EDD_TIME_DELTA), dtn_ion_ionadmin_get_time_delta);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_ion_ionadmin_idx[ADM_EDD_IDX], DTN_ION_IONADMIN_EDD_VERSION), dtn_ion_ionadmin_get_version);
+	adm_add_descs(g_dtn_ion_ionadmin_idx, dtn_ion_ionadmin_edd_descs, ADM_NUM_DESCS(dtn_ion_ionadmin_edd_descs));
 }
 
 void dtn_ion_ionadmin_init_op()
@@ -97,24 +105,28 @@ void dtn_ion_ionadmin_init_var()
 
 }
 
+static const adm_desc_t dtn_ion_ionadmin_ctrl_descs[] = {
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_IONADMIN_CTRL_NODE_INIT, 2, dtn_ion_ionadmin_ctrl_node_init),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_IONADMIN_CTRL_NODE_CLOCK_ERROR_SET, 1, dtn_ion_ionadmin_ctrl_node_clock_error_set),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_IONADMIN_CTRL_NODE_CLOCK_SYNC_SET, 1, dtn_ion_ionadmin_ctrl_node_clock_sync_set),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_IONADMIN_CTRL_NODE_CONGESTION_ALARM_CONTROL_SET, 1, dtn_ion_ionadmin_ctrl_node_congestion_alarm_control_set),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_IONADMIN_CTRL_NODE_CONGESTION_END_TIME_FORECASTS_SET, 1, dtn_ion_ionadmin_ctrl_node_congestion_end_time_forecasts_set),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_IONADMIN_CTRL_NODE_CONSUMPTION_RATE_SET, 1, dtn_ion_ionadmin_ctrl_node_consumption_rate_set),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_IONADMIN_CTRL_NODE_CONTACT_ADD, 6, dtn_ion_ionadmin_ctrl_node_contact_add),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_IONADMIN_CTRL_NODE_CONTACT_DEL, 3, dtn_ion_ionadmin_ctrl_node_contact_del),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_IONADMIN_CTRL_NODE_INBOUND_HEAP_OCCUPANCY_LIMIT_SET, 2, dtn_ion_ionadmin_ctrl_node_inbound_heap_occupancy_limit_set),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_IONADMIN_CTRL_NODE_OUTBOUND_HEAP_OCCUPANCY_LIMIT_SET, 2, dtn_ion_ionadmin_ctrl_node_outbound_heap_occupancy_limit_set),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_IONADMIN_CTRL_NODE_PRODUCTION_RATE_SET, 1, dtn_ion_ionadmin_ctrl_node_production_rate_set),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_IONADMIN_CTRL_NODE_RANGE_ADD, 5, dtn_ion_ionadmin_ctrl_node_range_add),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_IONADMIN_CTRL_NODE_RANGE_DEL, 3, dtn_ion_ionadmin_ctrl_node_range_del),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_IONADMIN_CTRL_NODE_REF_TIME_SET, 1, dtn_ion_ionadmin_ctrl_node_ref_time_set),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_IONADMIN_CTRL_NODE_TIME_DELTA_SET, 1, dtn_ion_ionadmin_ctrl_node_time_delta_set),
+};
+
 void dtn_ion_ionadmin_init_ctrl()
 {
 
-	adm_add_ctrldef(g_dtn_ion_ionadmin_idx[ADM_CTRL_IDX], DTN_ION_IONADMIN_CTRL_NODE_INIT, 2, dtn_ion_ionadmin_ctrl_node_init);
-	adm_add_ctrldef(g_dtn_ion_ionadmin_idx[ADM_CTRL_IDX], DTN_ION_IONADMIN_CTRL_NODE_CLOCK_ERROR_SET, 1, dtn_ion_ionadmin_ctrl_node_clock_error_set);
-	adm_add_ctrldef(g_dtn_ion_ionadmin_idx[ADM_CTRL_IDX], DTN_ION_IONADMIN_CTRL_NODE_CLOCK_SYNC_SET, 1, dtn_ion_ionadmin_ctrl_node_clock_sync_set);
-	adm_add_ctrldef(g_dtn_ion_ionadmin_idx[ADM_CTRL_IDX], DTN_ION_IONADMIN_CTRL_NODE_CONGESTION_ALARM_CONTROL_SET, 1, dtn_ion_ionadmin_ctrl_node_congestion_alarm_control_set);
-	adm_add_ctrldef(g_dtn_ion_ionadmin_idx[ADM_CTRL_IDX], DTN_ION_IONADMIN_CTRL_NODE_CONGESTION_END_TIME_FORECASTS_SET, 1, dtn_ion_ionadmin_ctrl_node_congestion_end_time_forecasts_set);
-	adm_add_ctrldef(g_dtn_ion_ionadmin_idx[ADM_CTRL_IDX], DTN_ION_IONADMIN_CTRL_NODE_CONSUMPTION_RATE_SET, 1, dtn_ion_ionadmin_ctrl_node_consumption_rate_set);
-	adm_add_ctrldef(g_dtn_ion_ionadmin_idx[ADM_CTRL_IDX], DTN_ION_IONADMIN_CTRL_NODE_CONTACT_ADD, 6, dtn_ion_ionadmin_ctrl_node_contact_add);
-	adm_add_ctrldef(g_dtn_ion_ionadmin_idx[ADM_CTRL_IDX], DTN_ION_IONADMIN_CTRL_NODE_CONTACT_DEL, 3, dtn_ion_ionadmin_ctrl_node_contact_del);
-	adm_add_ctrldef(g_dtn_ion_ionadmin_idx[ADM_CTRL_IDX], DTN_ION_IONADMIN_CTRL_NODE_INBOUND_HEAP_OCCUPANCY_LIMIT_SET, 2, dtn_ion_ionadmin_ctrl_node_inbound_heap_occupancy_limit_set);
-	adm_add_ctrldef(g_dtn_ion_ionadmin_idx[ADM_CTRL_IDX], DTN_ION_IONADMIN_CTRL_NODE_OUTBOUND_HEAP_OCCUPANCY_LIMIT_SET, 2, dtn_ion_ionadmin_ctrl_node_outbound_heap_occupancy_limit_set);
-	adm_add_ctrldef(g_dtn_ion_ionadmin_idx[ADM_CTRL_IDX], DTN_ION_IONADMIN_CTRL_NODE_PRODUCTION_RATE_SET, 1, dtn_ion_ionadmin_ctrl_node_production_rate_set);
-	adm_add_ctrldef(g_dtn_ion_ionadmin_idx[ADM_CTRL_IDX], DTN_ION_IONADMIN_CTRL_NODE_RANGE_ADD, 5, dtn_ion_ionadmin_ctrl_node_range_add);
-	adm_add_ctrldef(g_dtn_ion_ionadmin_idx[ADM_CTRL_IDX], DTN_ION_IONADMIN_CTRL_NODE_RANGE_DEL, 3, dtn_ion_ionadmin_ctrl_node_range_del);
-	adm_add_ctrldef(g_dtn_ion_ionadmin_idx[ADM_CTRL_IDX], DTN_ION_IONADMIN_CTRL_NODE_REF_TIME_SET, 1, dtn_ion_ionadmin_ctrl_node_ref_time_set);
-	adm_add_ctrldef(g_dtn_ion_ionadmin_idx[ADM_CTRL_IDX], DTN_ION_IONADMIN_CTRL_NODE_TIME_DELTA_SET, 1, dtn_ion_ionadmin_ctrl_node_time_delta_set);
+	adm_add_descs(g_dtn_ion_ionadmin_idx, dtn_ion_ionadmin_ctrl_descs, ADM_NUM_DESCS(dtn_ion_ionadmin_ctrl_descs));
 }
 
 void dtn_ion_ionadmin_init_mac()
@@ -141,6 +153,7 @@ void dtn_ion_ionadmin_init_tblt()
 	tblt_add_col(def, AMP_TYPE_UINT, "dest_node");
 	tblt_add_col(def, AMP_TYPE_UVAST, "xmit_data");
 	tblt_add_col(def, AMP_TYPE_UVAST, "confidence");
+	tblt_set_key(def, 0xD, NULL);
 	adm_add_tblt(def);
 
 	/* RANGES */
@@ -151,6 +164,7 @@ void dtn_ion_ionadmin_init_tblt()
 	tblt_add_col(def, AMP_TYPE_UINT, "node");
 	tblt_add_col(def, AMP_TYPE_UINT, "other_node");
 	tblt_add_col(def, AMP_TYPE_UINT, "distance");
+	tblt_set_key(def, 0xD, NULL);
 	adm_add_tblt(def);
 }
 
@@ -17,6 +17,7 @@
 
 /*   START CUSTOM INCLUDES HERE  */
 #include "rfx.h"
+#include "agent/ldc.h"
 /*   STOP CUSTOM INCLUDES HERE  */
 
 
@@ -24,6 +25,25 @@
 #include "adm_ion_admin_impl.h"
 
 /*   START CUSTOM FUNCTIONS HERE */
+
+/*
+ * The ION database record is staged once per collection cycle and shared by
+ * the EDDs which read only its fields.
+ */
+static IonDB gIonDb;
+
+static int dtn_ion_ionadmin_fetch_iondb(void *data)
+{
+	Sdr sdr = getIonsdr();
+
+	CHKZERO(sdr_begin_xn(sdr));
+	sdr_stage(sdr, (char *) data, getIonDbObject(), sizeof(IonDB));
+	sdr_end_xn(sdr);
+	return AMP_OK;
+}
+
+static ldc_snap_t gIonDbSnap = LDC_SNAP_INIT(dtn_ion_ionadmin_fetch_iondb, &gIonDb);
+
 /*   STOP CUSTOM FUNCTIONS HERE  */
 
 void dtn_ion_ionadmin_setup()
@@ -110,7 +130,6 @@ tbl_t *dtn_ion_ionadmin_tblt_contacts(ari_t *id)
 	PsmAddress      elt;
 	PsmAddress      addr;
 	IonCXref        *contact;
-	tnvc_t *cur_row = NULL;
 
 	CHKNULL(sdr_begin_xn(sdr));
 	for (elt = sm_rbt_first(ionwm, vdb->contactIndex); elt;
@@ -126,21 +145,12 @@ tbl_t *dtn_ion_ionadmin_tblt_contacts(ari_t *id)
 		}
 
 		 /* Table is: (TV)Start, (TV)Stop, (UINT)Src Node, (UINT)Dest Node, (UVAST)Xmit, (UVAST)Confidence */
-		if((cur_row = tnvc_create(6)) != NULL)
-		{
-		  tnvc_insert(cur_row, tnv_from_tv(amp_tv_from_ctime(OS_TimeFromTotalSeconds(contact->fromTime), NULL)));
-		  tnvc_insert(cur_row, tnv_from_tv(amp_tv_from_ctime(OS_TimeFromTotalSeconds(contact->toTime), NULL)));
-		  tnvc_insert(cur_row, tnv_from_uint(contact->fromNode));
-		  tnvc_insert(cur_row, tnv_from_uint(contact->toNode));
-		  tnvc_insert(cur_row, tnv_from_uvast(contact->xmitRate));
-		  tnvc_insert(cur_row, tnv_from_uvast(contact->confidence));
-		  
-		  tbl_add_row(table, cur_row);
-		}
-		else
-		{
-		  AMP_DEBUG_WARN("dtn_ion_ionadmin_tblt_contacts", "Can't allocate row. Skipping.", NULL);
-		}
+		tbl_append_tv(table, amp_tv_from_ctime(OS_TimeFromTotalSeconds(contact->fromTime), NULL));
+		tbl_append_tv(table, amp_tv_from_ctime(OS_TimeFromTotalSeconds(contact->toTime), NULL));
+		tbl_append_uint(table, contact->fromNode);
+		tbl_append_uint(table, contact->toNode);
+		tbl_append_uvast(table, contact->xmitRate);
+		tbl_append_uvast(table, contact->confidence);
 	}
 
 	sdr_exit_xn(sdr);
@@ -178,7 +188,6 @@ tbl_t *dtn_ion_ionadmin_tblt_ranges(ari_t *id)
 	PsmAddress      elt;
 	PsmAddress      addr;
 	IonRXref        *range = NULL;
-	tnvc_t *cur_row = NULL;
 
 
 	CHKNULL(sdr_begin_xn(sdr));
@@ -195,20 +204,11 @@ tbl_t *dtn_ion_ionadmin_tblt_ranges(ari_t *id)
 		}
 
 		 /* Table is: (TV)Start, (TV)Stop, (UINT) Node, (UINT)Other Node, (UINT) Dist */
-		if((cur_row = tnvc_create(5)) != NULL)
-		{
-			tnvc_insert(cur_row, tnv_from_tv(amp_tv_from_ctime(OS_TimeFromTotalSeconds(range->fromTime), NULL)));
-			tnvc_insert(cur_row, tnv_from_tv(amp_tv_from_ctime(OS_TimeFromTotalSeconds(range->toTime), NULL)));
-			tnvc_insert(cur_row, tnv_from_uint(range->fromNode));
-			tnvc_insert(cur_row, tnv_from_uint(range->toNode));
-			tnvc_insert(cur_row, tnv_from_uint(range->owlt));
-
-			tbl_add_row(table, cur_row);
-		}
-		else
-		{
-			AMP_DEBUG_WARN("dtn_ion_ionadmin_tblt_ranges", "Can't allocate row. Skipping.", NULL);
-		}
+		tbl_append_tv(table, amp_tv_from_ctime(OS_TimeFromTotalSeconds(range->fromTime), NULL));
+		tbl_append_tv(table, amp_tv_from_ctime(OS_TimeFromTotalSeconds(range->toTime), NULL));
+		tbl_append_uint(table, range->fromNode);
+		tbl_append_uint(table, range->toNode);
+		tbl_append_uint(table, range->owlt);
 	}
 
 	  sdr_exit_xn(sdr);
@@ -235,14 +235,12 @@ tnv_t *dtn_ion_ionadmin_get_clock_error(tnvc_t *parms)
 	 * +-------------------------------------------------------------------------+
 	 */
 
-	 Sdr     sdr = getIonsdr();
-	 Object  iondbObj = getIonDbObject();
-	 IonDB   iondb;
+	IonDB iondb;
 
-	 CHKNULL(sdr_begin_xn(sdr));
-	 sdr_stage(sdr, (char *) &iondb, iondbObj, sizeof(IonDB));
-	 result = tnv_from_int(iondb.maxClockError);
-	 sdr_end_xn(sdr);
+	if(ldc_snap_read(&gIonDbSnap, &iondb) == AMP_OK)
+	{
+		result = tnv_from_int(iondb.maxClockError);
+	}
 
 	/*
 	 * +-------------------------------------------------------------------------+
@@ -265,16 +263,13 @@ tnv_t *dtn_ion_ionadmin_get_clock_sync(tnvc_t *parms)
 	 * |START CUSTOM FUNCTION get_clock_sync BODY
 	 * +-------------------------------------------------------------------------+
 	 */
-	Sdr     sdr;
-	Object  iondbObj;
-	IonDB   iondb;
 
-	sdr = getIonsdr();
-	iondbObj = getIonDbObject();
-	CHKNULL(sdr_begin_xn(sdr));
-	sdr_stage(sdr, (char *) &iondb, iondbObj, sizeof(IonDB));
-	result = tnv_from_int(iondb.clockIsSynchronized);
-	sdr_end_xn(sdr);
+	IonDB iondb;
+
+	if(ldc_snap_read(&gIonDbSnap, &iondb) == AMP_OK)
+	{
+		result = tnv_from_int(iondb.clockIsSynchronized);
+	}
 
 	/*
 	 * +-------------------------------------------------------------------------+
@@ -337,14 +332,12 @@ tnv_t *dtn_ion_ionadmin_get_congestion_end_time_forecasts(tnvc_t *parms)
 	 * +-------------------------------------------------------------------------+
 	 */
 
-	Sdr     sdr = getIonsdr();
-	Object  iondbObj = getIonDbObject();
-	IonDB   iondb;
+	IonDB iondb;
 
-	CHKNULL(sdr_begin_xn(sdr));
-	sdr_stage(sdr, (char *) &iondb, iondbObj, sizeof(IonDB));
-	result = tnv_from_uint(iondb.horizon);
-	sdr_end_xn(sdr);
+	if(ldc_snap_read(&gIonDbSnap, &iondb) == AMP_OK)
+	{
+		result = tnv_from_uint(iondb.horizon);
+	}
 
 	/*
 	 * +-------------------------------------------------------------------------+
@@ -367,14 +360,12 @@ tnv_t *dtn_ion_ionadmin_get_consumption_rate(tnvc_t *parms)
 	 * +-------------------------------------------------------------------------+
 	 */
 
-	Sdr     sdr = getIonsdr();
-	Object  iondbObj = getIonDbObject();
-	IonDB   iondb;
+	IonDB iondb;
 
-	CHKNULL(sdr_begin_xn(sdr));
-	sdr_stage(sdr, (char *) &iondb, iondbObj, sizeof(IonDB));
-	result = tnv_from_uint(iondb.consumptionRate);
-	sdr_end_xn(sdr);
+	if(ldc_snap_read(&gIonDbSnap, &iondb) == AMP_OK)
+	{
+		result = tnv_from_uint(iondb.consumptionRate);
+	}
 
 	/*
 	 * +-------------------------------------------------------------------------+
@@ -462,14 +453,12 @@ tnv_t *dtn_ion_ionadmin_get_number(tnvc_t *parms)
 	 * +-------------------------------------------------------------------------+
 	 */
 
-	Sdr     sdr = getIonsdr();
-	Object  iondbObj = getIonDbObject();
-	IonDB   iondb;
+	IonDB iondb;
 
-	CHKNULL(sdr_begin_xn(sdr));
-	sdr_stage(sdr, (char *) &iondb, iondbObj, sizeof(IonDB));
-	result = tnv_from_uvast(iondb.ownNodeNbr);
-	sdr_end_xn(sdr);
+	if(ldc_snap_read(&gIonDbSnap, &iondb) == AMP_OK)
+	{
+		result = tnv_from_uvast(iondb.ownNodeNbr);
+	}
 
 	/*
 	 * +-------------------------------------------------------------------------+
@@ -557,14 +546,12 @@ tnv_t *dtn_ion_ionadmin_get_production_rate(tnvc_t *parms)
 	 * +-------------------------------------------------------------------------+
 	 */
 
-	Sdr sdr = getIonsdr();
-	Object iondbObj = getIonDbObject();
 	IonDB iondb;
 
-	CHKNULL(sdr_begin_xn(sdr));
-	sdr_stage(sdr, (char *) &iondb, iondbObj, sizeof(IonDB));
-	result = tnv_from_int(iondb.productionRate);
-	sdr_end_xn(sdr);
+	if(ldc_snap_read(&gIonDbSnap, &iondb) == AMP_OK)
+	{
+		result = tnv_from_int(iondb.productionRate);
+	}
 
 	/*
 	 * +-------------------------------------------------------------------------+
@@ -615,14 +602,12 @@ tnv_t *dtn_ion_ionadmin_get_time_delta(tnvc_t *parms)
 	 * +-------------------------------------------------------------------------+
 	 */
 
-	Sdr sdr = getIonsdr();
-	Object iondbObj = getIonDbObject();
 	IonDB iondb;
 
-	CHKNULL(sdr_begin_xn(sdr));
-	sdr_stage(sdr, (char *) &iondb, iondbObj, sizeof(IonDB));
-	result = tnv_from_int(iondb.deltaFromUTC);
-	sdr_end_xn(sdr);
+	if(ldc_snap_read(&gIonDbSnap, &iondb) == AMP_OK)
+	{
+		result = tnv_from_int(iondb.deltaFromUTC);
+	}
 
 	/*
 	 * +-------------------------------------------------------------------------+
@@ -720,6 +705,7 @@ tnv_t *dtn_ion_ionadmin_ctrl_node_clock_error_set(eid_t *def_mgr, tnvc_t *parms,
 		 iondb.maxClockError = newMaxClockError;
 		 sdr_write(sdr, iondbObj, (char *) &iondb, sizeof(IonDB));
 		 sdr_end_xn(sdr);
+		 ldc_snap_invalidate(&gIonDbSnap);
 		 *status = CTRL_SUCCESS;
 	 }
 
@@ -762,6 +748,7 @@ tnv_t *dtn_ion_ionadmin_ctrl_node_clock_sync_set(eid_t *def_mgr, tnvc_t *parms,
 		 iondb.clockIsSynchronized = (!(newSyncVal == 0));
 		 sdr_write(sdr, iondbObj, (char *) &iondb, sizeof(IonDB));
 		 sdr_end_xn(sdr);
+		 ldc_snap_invalidate(&gIonDbSnap);
 		 *status = CTRL_SUCCESS;
 	 }
 
@@ -808,6 +795,7 @@ tnv_t *dtn_ion_ionadmin_ctrl_node_congestion_alarm_control_set(eid_t *def_mgr, t
         iondb.alarmScript = sdr_string_create(sdr, newAlarmScript);
         sdr_write(sdr, iondbObj, (char *) &iondb, sizeof(IonDB));
         sdr_end_xn(sdr);
+        ldc_snap_invalidate(&gIonDbSnap);
         *status = CTRL_SUCCESS;
 	}
 
@@ -862,6 +850,7 @@ tnv_t *dtn_ion_ionadmin_ctrl_node_congestion_end_time_forecasts_set(eid_t *def_m
 	iondb.horizon = horizon;
 	sdr_write(sdr, iondbObj, (char *) &iondb, sizeof(IonDB));
 	sdr_end_xn(sdr);
+	ldc_snap_invalidate(&gIonDbSnap);
 	*status = CTRL_SUCCESS;
 
 	/*
@@ -910,6 +899,7 @@ tnv_t *dtn_ion_ionadmin_ctrl_node_consumption_rate_set(eid_t *def_mgr, tnvc_t *p
 		iondb.consumptionRate = newRate;
 		sdr_write(sdr, iondbObj, (char *) &iondb, sizeof(IonDB));
 		sdr_end_xn(sdr);
+		ldc_snap_invalidate(&gIonDbSnap);
 		*status = CTRL_SUCCESS;
 	}
 
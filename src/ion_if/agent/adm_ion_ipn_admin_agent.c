@@ -30,7 +30,7 @@
 #define _HAVE_DTN_ION_IPNADMIN_ADM_
 #ifdef _HAVE_DTN_ION_IPNADMIN_ADM_
 
-static vec_idx_t g_dtn_ion_ipnadmin_idx[11];
+static reg_idx_t g_dtn_ion_ipnadmin_idx[11];
 
 void dtn_ion_ipnadmin_init()
 {
@@ -54,13 +54,17 @@ void dtn_ion_ipnadmin_init()
 	dtn_ion_ipnadmin_init_tblt();
 }
 
+static const adm_desc_t dtn_ion_ipnadmin_meta_descs[] = {
+	ADM_DESC_CNST(ADM_META_IDX, DTN_ION_IPNADMIN_META_NAME, dtn_ion_ipnadmin_meta_name),
+	ADM_DESC_CNST(ADM_META_IDX, DTN_ION_IPNADMIN_META_NAMESPACE, dtn_ion_ipnadmin_meta_namespace),
+	ADM_DESC_CNST(ADM_META_IDX, DTN_ION_IPNADMIN_META_VERSION, dtn_ion_ipnadmin_meta_version),
+	ADM_DESC_CNST(ADM_META_IDX, DTN_ION_IPNADMIN_META_ORGANIZATION, dtn_ion_ipnadmin_meta_organization),
+};
+
 void dtn_ion_ipnadmin_init_meta()
 {
 
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_dtn_ion_ipnadmin_idx[ADM_META_IDX], DTN_ION_IPNADMIN_META_NAME), dtn_ion_ipnadmin_meta_name);
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_dtn_ion_ipnadmin_idx[ADM_META_IDX], DTN_ION_IPNADMIN_META_NAMESPACE), dtn_ion_ipnadmin_meta_namespace);
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_dtn_ion_ipnadmin_idx[ADM_META_IDX], DTN_ION_IPNADMIN_META_VERSION), dtn_ion_ipnadmin_meta_version);
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_dtn_ion_ipnadmin_idx[ADM_META_IDX], DTN_ION_IPNADMIN_META_ORGANIZATION), dtn_ion_ipnadmin_meta_organization);
+	adm_add_descs(g_dtn_ion_ipnadmin_idx, dtn_ion_ipnadmin_meta_descs, ADM_NUM_DESCS(dtn_ion_ipnadmin_meta_descs));
 }
 
 void dtn_ion_ipnadmin_init_cnst()
@@ -68,10 +72,14 @@ void dtn_ion_ipnadmin_init_cnst()
 
 }
 
+static const adm_desc_t dtn_ion_ipnadmin_edd_descs[] = {
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_ION_IPNADMIN_EDD_ION_VERSION, 0, dtn_ion_ipnadmin_get_ion_version),
+};
+
 void dtn_ion_ipnadmin_init_edd()
 {
 
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_ion_ipnadmin_idx[ADM_EDD_IDX], DTN_ION_IPNADMIN_EDD_ION_VERSION), dtn_ion_ipnadmin_get_ion_version);
+	adm_add_descs(g_dtn_ion_ipnadmin_idx, dtn_ion_ipnadmin_edd_descs, ADM_NUM_DESCS(dtn_ion_ipnadmin_edd_descs));
 }
 
 void dtn_ion_ipnadmin_init_op()
@@ -84,15 +92,19 @@ void dtn_ion_ipnadmin_init_var()
 
 }
 
+static const adm_desc_t dtn_ion_ipnadmin_ctrl_descs[] = {
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_IPNADMIN_CTRL_EXIT_ADD, 3, dtn_ion_ipnadmin_ctrl_exit_add),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_IPNADMIN_CTRL_EXIT_CHANGE, 3, dtn_ion_ipnadmin_ctrl_exit_change),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_IPNADMIN_CTRL_EXIT_DEL, 2, dtn_ion_ipnadmin_ctrl_exit_del),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_IPNADMIN_CTRL_PLAN_ADD, 2, dtn_ion_ipnadmin_ctrl_plan_add),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_IPNADMIN_CTRL_PLAN_CHANGE, 2, dtn_ion_ipnadmin_ctrl_plan_change),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_IPNADMIN_CTRL_PLAN_DEL, 1, dtn_ion_ipnadmin_ctrl_plan_del),
+};
+
 void dtn_ion_ipnadmin_init_ctrl()
 {
 
-	adm_add_ctrldef(g_dtn_ion_ipnadmin_idx[ADM_CTRL_IDX], DTN_ION_IPNADMIN_CTRL_EXIT_ADD, 3, dtn_ion_ipnadmin_ctrl_exit_add);
-	adm_add_ctrldef(g_dtn_ion_ipnadmin_idx[ADM_CTRL_IDX], DTN_ION_IPNADMIN_CTRL_EXIT_CHANGE, 3, dtn_ion_ipnadmin_ctrl_exit_change);
-	adm_add_ctrldef(g_dtn_ion_ipnadmin_idx[ADM_CTRL_IDX], DTN_ION_IPNADMIN_CTRL_EXIT_DEL, 2, dtn_ion_ipnadmin_ctrl_exit_del);
-	adm_add_ctrldef(g_dtn_ion_ipnadmin_idx[ADM_CTRL_IDX], DTN_ION_IPNADMIN_CTRL_PLAN_ADD, 2, dtn_ion_ipnadmin_ctrl_plan_add);
-	adm_add_ctrldef(g_dtn_ion_ipnadmin_idx[ADM_CTRL_IDX], DTN_ION_IPNADMIN_CTRL_PLAN_CHANGE, 2, dtn_ion_ipnadmin_ctrl_plan_change);
-	adm_add_ctrldef(g_dtn_ion_ipnadmin_idx[ADM_CTRL_IDX], DTN_ION_IPNADMIN_CTRL_PLAN_DEL, 1, dtn_ion_ipnadmin_ctrl_plan_del);
+	adm_add_descs(g_dtn_ion_ipnadmin_idx, dtn_ion_ipnadmin_ctrl_descs, ADM_NUM_DESCS(dtn_ion_ipnadmin_ctrl_descs));
 }
 
 void dtn_ion_ipnadmin_init_mac()
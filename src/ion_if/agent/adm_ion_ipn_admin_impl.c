@@ -111,7 +111,6 @@ tbl_t *dtn_ion_ipnadmin_tblt_exits(ari_t *id)
 	Object	elt;
 	OBJ_POINTER(IpnExit, exit);
 	char	eidString[SDRSTRING_BUFSZ];
-	tnvc_t  *cur_row = NULL;
 
 	CHKNULL(sdr_begin_xn(sdr));
 	for (elt = sdr_list_first(sdr, (getIpnConstants())->exits); elt;
@@ -122,18 +121,9 @@ tbl_t *dtn_ion_ipnadmin_tblt_exits(ari_t *id)
 		sdr_string_read(getIonsdr(), eidString, exit->eid);
 
 		/* (uint) FirstNode (UINT) last node (STR) gatewaye EID */
-		if((cur_row = tnvc_create(4)) != NULL)
-		{
-			tnvc_insert(cur_row, tnv_from_uvast(exit->firstNodeNbr));
-			tnvc_insert(cur_row, tnv_from_uvast(exit->lastNodeNbr));
-			tnvc_insert(cur_row, tnv_from_str(eidString));
-
-			tbl_add_row(table, cur_row);
-		}
-		else
-		{
-			AMP_DEBUG_WARN("dtn_ion_bpadmin_tblt_protocols", "Can't allocate row. Skipping.", NULL);
-		}
+		tbl_append_uvast(table, exit->firstNodeNbr);
+		tbl_append_uvast(table, exit->lastNodeNbr);
+		tbl_append_str(table, eidString);
 	}
 
 	sdr_exit_xn(sdr);
@@ -174,7 +164,6 @@ tbl_t *dtn_ion_ipnadmin_tblt_plans(ari_t *id)
 	Object	ductElt;
 	Object	outductElt;
 	Outduct	outduct;
-	tnvc_t  *cur_row = NULL;
 
 
 	CHKNULL(sdr_begin_xn(sdr));
@@ -207,18 +196,9 @@ tbl_t *dtn_ion_ipnadmin_tblt_plans(ari_t *id)
 		}
 
 		/* (uint) FirstNode (UINT) last node (STR) gatewaye EID */
-		if((cur_row = tnvc_create(3)) != NULL)
-		{
-			tnvc_insert(cur_row, tnv_from_uvast(plan->neighborNodeNbr));
-			tnvc_insert(cur_row, tnv_from_str(action));
-			tnvc_insert(cur_row, tnv_from_str(spec));
-
-			tbl_add_row(table, cur_row);
-		}
-		else
-		{
-			AMP_DEBUG_WARN("dtn_ion_ipnadmin_tblt_plans", "Can't allocate row. Skipping.", NULL);
-		}
+		tbl_append_uvast(table, plan->neighborNodeNbr);
+		tbl_append_str(table, action);
+		tbl_append_str(table, spec);
 	}
 
 	sdr_exit_xn(sdr);
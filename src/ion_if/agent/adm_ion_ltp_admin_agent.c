@@ -30,7 +30,7 @@
 #define _HAVE_DTN_ION_LTPADMIN_ADM_
 #ifdef _HAVE_DTN_ION_LTPADMIN_ADM_
 
-static vec_idx_t g_dtn_ion_ltpadmin_idx[11];
+static reg_idx_t g_dtn_ion_ltpadmin_idx[11];
 
 void dtn_ion_ltpadmin_init()
 {
@@ -54,13 +54,17 @@ void dtn_ion_ltpadmin_init()
 	dtn_ion_ltpadmin_init_tblt();
 }
 
+static const adm_desc_t dtn_ion_ltpadmin_meta_descs[] = {
+	ADM_DESC_CNST(ADM_META_IDX, DTN_ION_LTPADMIN_META_NAME, dtn_ion_ltpadmin_meta_name),
+	ADM_DESC_CNST(ADM_META_IDX, DTN_ION_LTPADMIN_META_NAMESPACE, dtn_ion_ltpadmin_meta_namespace),
+	ADM_DESC_CNST(ADM_META_IDX, DTN_ION_LTPADMIN_META_VERSION, dtn_ion_ltpadmin_meta_version),
+	ADM_DESC_CNST(ADM_META_IDX, DTN_ION_LTPADMIN_META_ORGANIZATION, dtn_ion_ltpadmin_meta_organization),
+};
+
 void dtn_ion_ltpadmin_init_meta()
 {
 
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_dtn_ion_ltpadmin_idx[ADM_META_IDX], DTN_ION_LTPADMIN_META_NAME), dtn_ion_ltpadmin_meta_name);
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_dtn_ion_ltpadmin_idx[ADM_META_IDX], DTN_ION_LTPADMIN_META_NAMESPACE), dtn_ion_ltpadmin_meta_namespace);
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_dtn_ion_ltpadmin_idx[ADM_META_IDX], DTN_ION_LTPADMIN_META_VERSION), dtn_ion_ltpadmin_meta_version);
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_dtn_ion_ltpadmin_idx[ADM_META_IDX], DTN_ION_LTPADMIN_META_ORGANIZATION), dtn_ion_ltpadmin_meta_organization);
+	adm_add_descs(g_dtn_ion_ltpadmin_idx, dtn_ion_ltpadmin_meta_descs, ADM_NUM_DESCS(dtn_ion_ltpadmin_meta_descs));
 }
 
 void dtn_ion_ltpadmin_init_cnst()
@@ -68,10 +72,14 @@ void dtn_ion_ltpadmin_init_cnst()
 
 }
 
+static const adm_desc_t dtn_ion_ltpadmin_edd_descs[] = {
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_ION_LTPADMIN_EDD_ION_VERSION, 0, dtn_ion_ltpadmin_get_ion_version),
+};
+
 void dtn_ion_ltpadmin_init_edd()
 {
 
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_ion_ltpadmin_idx[ADM_EDD_IDX], DTN_ION_LTPADMIN_EDD_ION_VERSION), dtn_ion_ltpadmin_get_ion_version);
+	adm_add_descs(g_dtn_ion_ltpadmin_idx, dtn_ion_ltpadmin_edd_descs, ADM_NUM_DESCS(dtn_ion_ltpadmin_edd_descs));
 }
 
 void dtn_ion_ltpadmin_init_op()
@@ -84,18 +92,22 @@ void dtn_ion_ltpadmin_init_var()
 
 }
 
+static const adm_desc_t dtn_ion_ltpadmin_ctrl_descs[] = {
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_LTPADMIN_CTRL_MANAGE_HEAP, 1, dtn_ion_ltpadmin_ctrl_manage_heap),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_LTPADMIN_CTRL_MANAGE_MAX_BER, 1, dtn_ion_ltpadmin_ctrl_manage_max_ber),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_LTPADMIN_CTRL_MANAGE_OWN_QUEUE_TIME, 1, dtn_ion_ltpadmin_ctrl_manage_own_queue_time),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_LTPADMIN_CTRL_MANAGE_SCREENING, 1, dtn_ion_ltpadmin_ctrl_manage_screening),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_LTPADMIN_CTRL_SPAN_ADD, 8, dtn_ion_ltpadmin_ctrl_span_add),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_LTPADMIN_CTRL_SPAN_CHANGE, 8, dtn_ion_ltpadmin_ctrl_span_change),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_LTPADMIN_CTRL_SPAN_DEL, 1, dtn_ion_ltpadmin_ctrl_span_del),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_LTPADMIN_CTRL_STOP, 0, dtn_ion_ltpadmin_ctrl_stop),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_LTPADMIN_CTRL_WATCH_SET, 1, dtn_ion_ltpadmin_ctrl_watch_set),
+};
+
 void dtn_ion_ltpadmin_init_ctrl()
 {
 
-	adm_add_ctrldef(g_dtn_ion_ltpadmin_idx[ADM_CTRL_IDX], DTN_ION_LTPADMIN_CTRL_MANAGE_HEAP, 1, dtn_ion_ltpadmin_ctrl_manage_heap);
-	adm_add_ctrldef(g_dtn_ion_ltpadmin_idx[ADM_CTRL_IDX], DTN_ION_LTPADMIN_CTRL_MANAGE_MAX_BER, 1, dtn_ion_ltpadmin_ctrl_manage_max_ber);
-	adm_add_ctrldef(g_dtn_ion_ltpadmin_idx[ADM_CTRL_IDX], DTN_ION_LTPADMIN_CTRL_MANAGE_OWN_QUEUE_TIME, 1, dtn_ion_ltpadmin_ctrl_manage_own_queue_time);
-	adm_add_ctrldef(g_dtn_ion_ltpadmin_idx[ADM_CTRL_IDX], DTN_ION_LTPADMIN_CTRL_MANAGE_SCREENING, 1, dtn_ion_ltpadmin_ctrl_manage_screening);
-	adm_add_ctrldef(g_dtn_ion_ltpadmin_idx[ADM_CTRL_IDX], DTN_ION_LTPADMIN_CTRL_SPAN_ADD, 8, dtn_ion_ltpadmin_ctrl_span_add);
-	adm_add_ctrldef(g_dtn_ion_ltpadmin_idx[ADM_CTRL_IDX], DTN_ION_LTPADMIN_CTRL_SPAN_CHANGE, 8, dtn_ion_ltpadmin_ctrl_span_change);
-	adm_add_ctrldef(g_dtn_ion_ltpadmin_idx[ADM_CTRL_IDX], DTN_ION_LTPADMIN_CTRL_SPAN_DEL, 1, dtn_ion_ltpadmin_ctrl_span_del);
-	adm_add_ctrldef(g_dtn_ion_ltpadmin_idx[ADM_CTRL_IDX], DTN_ION_LTPADMIN_CTRL_STOP, 0, dtn_ion_ltpadmin_ctrl_stop);
-	adm_add_ctrldef(g_dtn_ion_ltpadmin_idx[ADM_CTRL_IDX], DTN_ION_LTPADMIN_CTRL_WATCH_SET, 1, dtn_ion_ltpadmin_ctrl_watch_set);
+	adm_add_descs(g_dtn_ion_ltpadmin_idx, dtn_ion_ltpadmin_ctrl_descs, ADM_NUM_DESCS(dtn_ion_ltpadmin_ctrl_descs));
 }
 
 void dtn_ion_ltpadmin_init_mac()
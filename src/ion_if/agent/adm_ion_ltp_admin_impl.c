@@ -119,7 +119,6 @@ tbl_t *dtn_ion_ltpadmin_tblt_spans(ari_t *id)
 	LtpVspan	*vspan;
 	char	cmd[SDRSTRING_BUFSZ];
 	OBJ_POINTER(LtpSpan, span);
-	tnvc_t  *cur_row = NULL;
 
 
 	CHKNULL(sdr_begin_xn(sdr));	/*	Just to lock memory.	*/
@@ -137,23 +136,14 @@ tbl_t *dtn_ion_ltpadmin_tblt_spans(ari_t *id)
 		 * (UINT) max-seg-size, (UINT) agg_size_limit, (UINT) agg_time_limit,
 		 * (STR) lso_ctrl, (UINT) q_latency
 		 */
-		if((cur_row = tnvc_create(8)) != NULL)
-		{
-			tnvc_insert(cur_row, tnv_from_uvast(vspan->engineId));
-			tnvc_insert(cur_row, tnv_from_uint(span->maxExportSessions));
-			tnvc_insert(cur_row, tnv_from_uint(span->maxImportSessions));
-			tnvc_insert(cur_row, tnv_from_uint(span->maxSegmentSize));
-			tnvc_insert(cur_row, tnv_from_uint(span->aggrSizeLimit));
-			tnvc_insert(cur_row, tnv_from_uint(span->aggrTimeLimit));
-			tnvc_insert(cur_row, tnv_from_str(cmd));
-			tnvc_insert(cur_row, tnv_from_uint(span->remoteQtime));
-
-			tbl_add_row(table, cur_row);
-		}
-		else
-		{
-			AMP_DEBUG_WARN("dtn_ion_ltpadmin_tblt_spans", "Can't allocate row. Skipping.", NULL);
-		}
+		tbl_append_uvast(table, vspan->engineId);
+		tbl_append_uint(table, span->maxExportSessions);
+		tbl_append_uint(table, span->maxImportSessions);
+		tbl_append_uint(table, span->maxSegmentSize);
+		tbl_append_uint(table, span->aggrSizeLimit);
+		tbl_append_uint(table, span->aggrTimeLimit);
+		tbl_append_str(table, cmd);
+		tbl_append_uint(table, span->remoteQtime);
 	}
 
 	sdr_exit_xn(sdr);
@@ -30,7 +30,7 @@
 #define _HAVE_DTN_ION_IONSECADMIN_ADM_
 #ifdef _HAVE_DTN_ION_IONSECADMIN_ADM_
 
-static vec_idx_t g_dtn_ion_ionsecadmin_idx[11];
+static reg_idx_t g_dtn_ion_ionsecadmin_idx[11];
 
 void dtn_ion_ionsecadmin_init()
 {
@@ -53,13 +53,17 @@ void dtn_ion_ionsecadmin_init()
 	dtn_ion_ionsecadmin_init_tblt();
 }
 
+static const adm_desc_t dtn_ion_ionsecadmin_meta_descs[] = {
+	ADM_DESC_CNST(ADM_META_IDX, DTN_ION_IONSECADMIN_META_NAME, dtn_ion_ionsecadmin_meta_name),
+	ADM_DESC_CNST(ADM_META_IDX, DTN_ION_IONSECADMIN_META_NAMESPACE, dtn_ion_ionsecadmin_meta_namespace),
+	ADM_DESC_CNST(ADM_META_IDX, DTN_ION_IONSECADMIN_META_VERSION, dtn_ion_ionsecadmin_meta_version),
+	ADM_DESC_CNST(ADM_META_IDX, DTN_ION_IONSECADMIN_META_ORGANIZATION, dtn_ion_ionsecadmin_meta_organization),
+};
+
 void dtn_ion_ionsecadmin_init_meta()
 {
 
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_dtn_ion_ionsecadmin_idx[ADM_META_IDX], DTN_ION_IONSECADMIN_META_NAME), dtn_ion_ionsecadmin_meta_name);
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_dtn_ion_ionsecadmin_idx[ADM_META_IDX], DTN_ION_IONSECADMIN_META_NAMESPACE), dtn_ion_ionsecadmin_meta_namespace);
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_dtn_ion_ionsecadmin_idx[ADM_META_IDX], DTN_ION_IONSECADMIN_META_VERSION), dtn_ion_ionsecadmin_meta_version);
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_dtn_ion_ionsecadmin_idx[ADM_META_IDX], DTN_ION_IONSECADMIN_META_ORGANIZATION), dtn_ion_ionsecadmin_meta_organization);
+	adm_add_descs(g_dtn_ion_ionsecadmin_idx, dtn_ion_ionsecadmin_meta_descs, ADM_NUM_DESCS(dtn_ion_ionsecadmin_meta_descs));
 }
 
 void dtn_ion_ionsecadmin_init_cnst()
@@ -82,21 +86,25 @@ void dtn_ion_ionsecadmin_init_var()
 
 }
 
+static const adm_desc_t dtn_ion_ionsecadmin_ctrl_descs[] = {
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_IONSECADMIN_CTRL_KEY_ADD, 2, dtn_ion_ionsecadmin_ctrl_key_add),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_IONSECADMIN_CTRL_KEY_CHANGE, 2, dtn_ion_ionsecadmin_ctrl_key_change),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_IONSECADMIN_CTRL_KEY_DEL, 1, dtn_ion_ionsecadmin_ctrl_key_del),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_IONSECADMIN_CTRL_LTP_RX_RULE_ADD, 3, dtn_ion_ionsecadmin_ctrl_ltp_rx_rule_add),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_IONSECADMIN_CTRL_LTP_RX_RULE_CHANGE, 3, dtn_ion_ionsecadmin_ctrl_ltp_rx_rule_change),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_IONSECADMIN_CTRL_LTP_RX_RULE_DEL, 1, dtn_ion_ionsecadmin_ctrl_ltp_rx_rule_del),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_IONSECADMIN_CTRL_LTP_TX_RULE_ADD, 3, dtn_ion_ionsecadmin_ctrl_ltp_tx_rule_add),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_IONSECADMIN_CTRL_LTP_TX_RULE_CHANGE, 3, dtn_ion_ionsecadmin_ctrl_ltp_tx_rule_change),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_IONSECADMIN_CTRL_LTP_TX_RULE_DEL, 1, dtn_ion_ionsecadmin_ctrl_ltp_tx_rule_del),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_IONSECADMIN_CTRL_LIST_KEYS, 0, dtn_ion_ionsecadmin_ctrl_list_keys),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_IONSECADMIN_CTRL_LIST_LTP_RX_RULES, 0, dtn_ion_ionsecadmin_ctrl_list_ltp_rx_rules),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_IONSECADMIN_CTRL_LIST_LTP_TX_RULES, 0, dtn_ion_ionsecadmin_ctrl_list_ltp_tx_rules),
+};
+
 void dtn_ion_ionsecadmin_init_ctrl()
 {
 
-	adm_add_ctrldef(g_dtn_ion_ionsecadmin_idx[ADM_CTRL_IDX], DTN_ION_IONSECADMIN_CTRL_KEY_ADD, 2, dtn_ion_ionsecadmin_ctrl_key_add);
-	adm_add_ctrldef(g_dtn_ion_ionsecadmin_idx[ADM_CTRL_IDX], DTN_ION_IONSECADMIN_CTRL_KEY_CHANGE, 2, dtn_ion_ionsecadmin_ctrl_key_change);
-	adm_add_ctrldef(g_dtn_ion_ionsecadmin_idx[ADM_CTRL_IDX], DTN_ION_IONSECADMIN_CTRL_KEY_DEL, 1, dtn_ion_ionsecadmin_ctrl_key_del);
-	adm_add_ctrldef(g_dtn_ion_ionsecadmin_idx[ADM_CTRL_IDX], DTN_ION_IONSECADMIN_CTRL_LTP_RX_RULE_ADD, 3, dtn_ion_ionsecadmin_ctrl_ltp_rx_rule_add);
-	adm_add_ctrldef(g_dtn_ion_ionsecadmin_idx[ADM_CTRL_IDX], DTN_ION_IONSECADMIN_CTRL_LTP_RX_RULE_CHANGE, 3, dtn_ion_ionsecadmin_ctrl_ltp_rx_rule_change);
-	adm_add_ctrldef(g_dtn_ion_ionsecadmin_idx[ADM_CTRL_IDX], DTN_ION_IONSECADMIN_CTRL_LTP_RX_RULE_DEL, 1, dtn_ion_ionsecadmin_ctrl_ltp_rx_rule_del);
-	adm_add_ctrldef(g_dtn_ion_ionsecadmin_idx[ADM_CTRL_IDX], DTN_ION_IONSECADMIN_CTRL_LTP_TX_RULE_ADD, 3, dtn_ion_ionsecadmin_ctrl_ltp_tx_rule_add);
-	adm_add_ctrldef(g_dtn_ion_ionsecadmin_idx[ADM_CTRL_IDX], DTN_ION_IONSECADMIN_CTRL_LTP_TX_RULE_CHANGE, 3, dtn_ion_ionsecadmin_ctrl_ltp_tx_rule_change);
-	adm_add_ctrldef(g_dtn_ion_ionsecadmin_idx[ADM_CTRL_IDX], DTN_ION_IONSECADMIN_CTRL_LTP_TX_RULE_DEL, 1, dtn_ion_ionsecadmin_ctrl_ltp_tx_rule_del);
-	adm_add_ctrldef(g_dtn_ion_ionsecadmin_idx[ADM_CTRL_IDX], DTN_ION_IONSECADMIN_CTRL_LIST_KEYS, 0, dtn_ion_ionsecadmin_ctrl_list_keys);
-	adm_add_ctrldef(g_dtn_ion_ionsecadmin_idx[ADM_CTRL_IDX], DTN_ION_IONSECADMIN_CTRL_LIST_LTP_RX_RULES, 0, dtn_ion_ionsecadmin_ctrl_list_ltp_rx_rules);
-	adm_add_ctrldef(g_dtn_ion_ionsecadmin_idx[ADM_CTRL_IDX], DTN_ION_IONSECADMIN_CTRL_LIST_LTP_TX_RULES, 0, dtn_ion_ionsecadmin_ctrl_list_ltp_tx_rules);
+	adm_add_descs(g_dtn_ion_ionsecadmin_idx, dtn_ion_ionsecadmin_ctrl_descs, ADM_NUM_DESCS(dtn_ion_ionsecadmin_ctrl_descs));
 }
 
 void dtn_ion_ionsecadmin_init_mac()
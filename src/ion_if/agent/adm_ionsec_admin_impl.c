@@ -114,7 +114,6 @@ tbl_t *dtn_ion_ionsecadmin_tblt_ltp_rx_rules(ari_t *id)
 	OBJ_POINTER(LtpRecvAuthRule, rule);
 	Object	elt;
 	Object	obj;
-	tnvc_t  *cur_row = NULL;
 
 	GET_OBJ_POINTER(sdr, SecDB, db, getSecDbObject());
 
@@ -126,18 +125,9 @@ tbl_t *dtn_ion_ionsecadmin_tblt_ltp_rx_rules(ari_t *id)
 		GET_OBJ_POINTER(sdr, LtpRecvAuthRule, rule, obj);
 
 		/* (UINT engine_id, (UINT) cipher_nbr, (STR) key ame */
-		if((cur_row = tnvc_create(3)) != NULL)
-		{
-			tnvc_insert(cur_row, tnv_from_uint(rule->ltpEngineId));
-			tnvc_insert(cur_row, tnv_from_uint(rule->ciphersuiteNbr));
-			tnvc_insert(cur_row, tnv_from_str(rule->keyName));
-
-			tbl_add_row(table, cur_row);
-		}
-		else
-		{
-			AMP_DEBUG_WARN("dtn_ion_ionsecadmin_tblt_ltp_rx_rules", "Can't allocate row. Skipping.", NULL);
-		}
+		tbl_append_uint(table, rule->ltpEngineId);
+		tbl_append_uint(table, rule->ciphersuiteNbr);
+		tbl_append_str(table, rule->keyName);
 	}
 
 	sdr_exit_xn(sdr);
@@ -173,7 +163,6 @@ tbl_t *dtn_ion_ionsecadmin_tblt_ltp_tx_rules(ari_t *id)
 	OBJ_POINTER(LtpXmitAuthRule, rule);
 	Object	elt;
 	Object	obj;
-	tnvc_t  *cur_row = NULL;
 
 	GET_OBJ_POINTER(sdr, SecDB, db, getSecDbObject());
 
@@ -185,18 +174,9 @@ tbl_t *dtn_ion_ionsecadmin_tblt_ltp_tx_rules(ari_t *id)
 		GET_OBJ_POINTER(sdr, LtpXmitAuthRule, rule, obj);
 
 		/* (UINT engine_id, (UINT) cipher_nbr, (STR) key ame */
-		if((cur_row = tnvc_create(3)) != NULL)
-		{
-			tnvc_insert(cur_row, tnv_from_uint(rule->ltpEngineId));
-			tnvc_insert(cur_row, tnv_from_uint(rule->ciphersuiteNbr));
-			tnvc_insert(cur_row, tnv_from_str(rule->keyName));
-
-			tbl_add_row(table, cur_row);
-		}
-		else
-		{
-			AMP_DEBUG_WARN("dtn_ion_ionsecadmin_tblt_ltp_tx_rules", "Can't allocate row. Skipping.", NULL);
-		}
+		tbl_append_uint(table, rule->ltpEngineId);
+		tbl_append_uint(table, rule->ciphersuiteNbr);
+		tbl_append_str(table, rule->keyName);
 	}
 
 	sdr_exit_xn(sdr);
@@ -30,7 +30,7 @@
 #define _HAVE_DTN_LTP_AGENT_ADM_
 #ifdef _HAVE_DTN_LTP_AGENT_ADM_
 
-static vec_idx_t g_dtn_ltp_agent_idx[11];
+static reg_idx_t g_dtn_ltp_agent_idx[11];
 
 void dtn_ltp_agent_init()
 {
@@ -55,13 +55,17 @@ void dtn_ltp_agent_init()
 	dtn_ltp_agent_init_tblt();
 }
 
+static const adm_desc_t dtn_ltp_agent_meta_descs[] = {
+	ADM_DESC_CNST(ADM_META_IDX, DTN_LTP_AGENT_META_NAME, dtn_ltp_agent_meta_name),
+	ADM_DESC_CNST(ADM_META_IDX, DTN_LTP_AGENT_META_NAMESPACE, dtn_ltp_agent_meta_namespace),
+	ADM_DESC_CNST(ADM_META_IDX, DTN_LTP_AGENT_META_VERSION, dtn_ltp_agent_meta_version),
+	ADM_DESC_CNST(ADM_META_IDX, DTN_LTP_AGENT_META_ORGANIZATION, dtn_ltp_agent_meta_organization),
+};
+
 void dtn_ltp_agent_init_meta()
 {
 
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_dtn_ltp_agent_idx[ADM_META_IDX], DTN_LTP_AGENT_META_NAME), dtn_ltp_agent_meta_name);
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_dtn_ltp_agent_idx[ADM_META_IDX], DTN_LTP_AGENT_META_NAMESPACE), dtn_ltp_agent_meta_namespace);
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_dtn_ltp_agent_idx[ADM_META_IDX], DTN_LTP_AGENT_META_VERSION), dtn_ltp_agent_meta_version);
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_dtn_ltp_agent_idx[ADM_META_IDX], DTN_LTP_AGENT_META_ORGANIZATION), dtn_ltp_agent_meta_organization);
+	adm_add_descs(g_dtn_ltp_agent_idx, dtn_ltp_agent_meta_descs, ADM_NUM_DESCS(dtn_ltp_agent_meta_descs));
 }
 
 void dtn_ltp_agent_init_cnst()
@@ -69,51 +73,55 @@ void dtn_ltp_agent_init_cnst()
 
 }
 
+static const adm_desc_t dtn_ltp_agent_edd_descs[] = {
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_REMOTE_ENGINE_NBR, 1, dtn_ltp_agent_get_span_remote_engine_nbr),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_CUR_EXPT_SESS, 1, dtn_ltp_agent_get_span_cur_expt_sess),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_CUR_OUT_SEG, 1, dtn_ltp_agent_get_span_cur_out_seg),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_CUR_IMP_SESS, 1, dtn_ltp_agent_get_span_cur_imp_sess),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_CUR_IN_SEG, 1, dtn_ltp_agent_get_span_cur_in_seg),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_RESET_TIME, 1, dtn_ltp_agent_get_span_reset_time),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_OUT_SEG_Q_CNT, 1, dtn_ltp_agent_get_span_out_seg_q_cnt),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_OUT_SEG_Q_BYTES, 1, dtn_ltp_agent_get_span_out_seg_q_bytes),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_OUT_SEG_POP_CNT, 1, dtn_ltp_agent_get_span_out_seg_pop_cnt),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_OUT_SEG_POP_BYTES, 1, dtn_ltp_agent_get_span_out_seg_pop_bytes),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_OUT_CKPT_XMIT_CNT, 1, dtn_ltp_agent_get_span_out_ckpt_xmit_cnt),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_OUT_POS_ACK_RX_CNT, 1, dtn_ltp_agent_get_span_out_pos_ack_rx_cnt),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_OUT_NEG_ACK_RX_CNT, 1, dtn_ltp_agent_get_span_out_neg_ack_rx_cnt),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_OUT_CANCEL_RX_CNT, 1, dtn_ltp_agent_get_span_out_cancel_rx_cnt),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_OUT_CKPT_REXMIT_CNT, 1, dtn_ltp_agent_get_span_out_ckpt_rexmit_cnt),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_OUT_CANCEL_XMIT_CNT, 1, dtn_ltp_agent_get_span_out_cancel_xmit_cnt),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_OUT_COMPLETE_CNT, 1, dtn_ltp_agent_get_span_out_complete_cnt),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_IN_SEG_RX_RED_CNT, 1, dtn_ltp_agent_get_span_in_seg_rx_red_cnt),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_IN_SEG_RX_RED_BYTES, 1, dtn_ltp_agent_get_span_in_seg_rx_red_bytes),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_IN_SEG_RX_GREEN_CNT, 1, dtn_ltp_agent_get_span_in_seg_rx_green_cnt),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_IN_SEG_RX_GREEN_BYTES, 1, dtn_ltp_agent_get_span_in_seg_rx_green_bytes),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_IN_SEG_RX_REDUNDANT_CNT, 1, dtn_ltp_agent_get_span_in_seg_rx_redundant_cnt),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_IN_SEG_RX_REDUNDANT_BYTES, 1, dtn_ltp_agent_get_span_in_seg_rx_redundant_bytes),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_IN_SEG_RX_MAL_CNT, 1, dtn_ltp_agent_get_span_in_seg_rx_mal_cnt),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_IN_SEG_RX_MAL_BYTES, 1, dtn_ltp_agent_get_span_in_seg_rx_mal_bytes),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_IN_SEG_RX_UNK_SENDER_CNT, 1, dtn_ltp_agent_get_span_in_seg_rx_unk_sender_cnt),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_IN_SEG_RX_UNK_SENDER_BYTES, 1, dtn_ltp_agent_get_span_in_seg_rx_unk_sender_bytes),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_IN_SEG_RX_UNK_CLIENT_CNT, 1, dtn_ltp_agent_get_span_in_seg_rx_unk_client_cnt),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_IN_SEG_RX_UNK_CLIENT_BYTES, 1, dtn_ltp_agent_get_span_in_seg_rx_unk_client_bytes),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_IN_SEG_STRAY_CNT, 1, dtn_ltp_agent_get_span_in_seg_stray_cnt),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_IN_SEG_STRAY_BYTES, 1, dtn_ltp_agent_get_span_in_seg_stray_bytes),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_IN_SEG_MISCOLOR_CNT, 1, dtn_ltp_agent_get_span_in_seg_miscolor_cnt),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_IN_SEG_MISCOLOR_BYTES, 1, dtn_ltp_agent_get_span_in_seg_miscolor_bytes),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_IN_SEG_CLOSED_CNT, 1, dtn_ltp_agent_get_span_in_seg_closed_cnt),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_IN_SEG_CLOSED_BYTES, 1, dtn_ltp_agent_get_span_in_seg_closed_bytes),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_IN_CKPT_RX_CNT, 1, dtn_ltp_agent_get_span_in_ckpt_rx_cnt),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_IN_POS_ACK_TX_CNT, 1, dtn_ltp_agent_get_span_in_pos_ack_tx_cnt),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_IN_NEG_ACK_TX_CNT, 1, dtn_ltp_agent_get_span_in_neg_ack_tx_cnt),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_IN_CANCEL_TX_CNT, 1, dtn_ltp_agent_get_span_in_cancel_tx_cnt),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_IN_ACK_RETX_CNT, 1, dtn_ltp_agent_get_span_in_ack_retx_cnt),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_IN_CANCEL_RX_CNT, 1, dtn_ltp_agent_get_span_in_cancel_rx_cnt),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_LTP_AGENT_EDD_SPAN_IN_COMPLETE_CNT, 1, dtn_ltp_agent_get_span_in_complete_cnt),
+};
+
 void dtn_ltp_agent_init_edd()
 {
 
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_REMOTE_ENGINE_NBR), dtn_ltp_agent_get_span_remote_engine_nbr);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_CUR_EXPT_SESS), dtn_ltp_agent_get_span_cur_expt_sess);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_CUR_OUT_SEG), dtn_ltp_agent_get_span_cur_out_seg);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_CUR_IMP_SESS), dtn_ltp_agent_get_span_cur_imp_sess);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_CUR_IN_SEG), dtn_ltp_agent_get_span_cur_in_seg);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_RESET_TIME), dtn_ltp_agent_get_span_reset_time);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_OUT_SEG_Q_CNT), dtn_ltp_agent_get_span_out_seg_q_cnt);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_OUT_SEG_Q_BYTES), dtn_ltp_agent_get_span_out_seg_q_bytes);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_OUT_SEG_POP_CNT), dtn_ltp_agent_get_span_out_seg_pop_cnt);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_OUT_SEG_POP_BYTES), dtn_ltp_agent_get_span_out_seg_pop_bytes);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_OUT_CKPT_XMIT_CNT), dtn_ltp_agent_get_span_out_ckpt_xmit_cnt);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_OUT_POS_ACK_RX_CNT), dtn_ltp_agent_get_span_out_pos_ack_rx_cnt);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_OUT_NEG_ACK_RX_CNT), dtn_ltp_agent_get_span_out_neg_ack_rx_cnt);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_OUT_CANCEL_RX_CNT), dtn_ltp_agent_get_span_out_cancel_rx_cnt);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_OUT_CKPT_REXMIT_CNT), dtn_ltp_agent_get_span_out_ckpt_rexmit_cnt);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_OUT_CANCEL_XMIT_CNT), dtn_ltp_agent_get_span_out_cancel_xmit_cnt);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_OUT_COMPLETE_CNT), dtn_ltp_agent_get_span_out_complete_cnt);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_IN_SEG_RX_RED_CNT), dtn_ltp_agent_get_span_in_seg_rx_red_cnt);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_IN_SEG_RX_RED_BYTES), dtn_ltp_agent_get_span_in_seg_rx_red_bytes);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_IN_SEG_RX_GREEN_CNT), dtn_ltp_agent_get_span_in_seg_rx_green_cnt);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_IN_SEG_RX_GREEN_BYTES), dtn_ltp_agent_get_span_in_seg_rx_green_bytes);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_IN_SEG_RX_REDUNDANT_CNT), dtn_ltp_agent_get_span_in_seg_rx_redundant_cnt);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_IN_SEG_RX_REDUNDANT_BYTES), dtn_ltp_agent_get_span_in_seg_rx_redundant_bytes);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_IN_SEG_RX_MAL_CNT), dtn_ltp_agent_get_span_in_seg_rx_mal_cnt);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_IN_SEG_RX_MAL_BYTES), dtn_ltp_agent_get_span_in_seg_rx_mal_bytes);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_IN_SEG_RX_UNK_SENDER_CNT), dtn_ltp_agent_get_span_in_seg_rx_unk_sender_cnt);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_IN_SEG_RX_UNK_SENDER_BYTES), dtn_ltp_agent_get_span_in_seg_rx_unk_sender_bytes);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_IN_SEG_RX_UNK_CLIENT_CNT), dtn_ltp_agent_get_span_in_seg_rx_unk_client_cnt);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_IN_SEG_RX_UNK_CLIENT_BYTES), dtn_ltp_agent_get_span_in_seg_rx_unk_client_bytes);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_IN_SEG_STRAY_CNT), dtn_ltp_agent_get_span_in_seg_stray_cnt);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_IN_SEG_STRAY_BYTES), dtn_ltp_agent_get_span_in_seg_stray_bytes);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_IN_SEG_MISCOLOR_CNT), dtn_ltp_agent_get_span_in_seg_miscolor_cnt);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_IN_SEG_MISCOLOR_BYTES), dtn_ltp_agent_get_span_in_seg_miscolor_bytes);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_IN_SEG_CLOSED_CNT), dtn_ltp_agent_get_span_in_seg_closed_cnt);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_IN_SEG_CLOSED_BYTES), dtn_ltp_agent_get_span_in_seg_closed_bytes);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_IN_CKPT_RX_CNT), dtn_ltp_agent_get_span_in_ckpt_rx_cnt);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_IN_POS_ACK_TX_CNT), dtn_ltp_agent_get_span_in_pos_ack_tx_cnt);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_IN_NEG_ACK_TX_CNT), dtn_ltp_agent_get_span_in_neg_ack_tx_cnt);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_IN_CANCEL_TX_CNT), dtn_ltp_agent_get_span_in_cancel_tx_cnt);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_IN_ACK_RETX_CNT), dtn_ltp_agent_get_span_in_ack_retx_cnt);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_IN_CANCEL_RX_CNT), dtn_ltp_agent_get_span_in_cancel_rx_cnt);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_ltp_agent_idx[ADM_EDD_IDX], DTN_LTP_AGENT_EDD_SPAN_IN_COMPLETE_CNT), dtn_ltp_agent_get_span_in_complete_cnt);
+	adm_add_descs(g_dtn_ltp_agent_idx, dtn_ltp_agent_edd_descs, ADM_NUM_DESCS(dtn_ltp_agent_edd_descs));
 }
 
 void dtn_ltp_agent_init_op()
@@ -126,10 +134,14 @@ void dtn_ltp_agent_init_var()
 
 }
 
+static const adm_desc_t dtn_ltp_agent_ctrl_descs[] = {
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_LTP_AGENT_CTRL_RESET, 1, dtn_ltp_agent_ctrl_reset),
+};
+
 void dtn_ltp_agent_init_ctrl()
 {
 
-	adm_add_ctrldef(g_dtn_ltp_agent_idx[ADM_CTRL_IDX], DTN_LTP_AGENT_CTRL_RESET, 1, dtn_ltp_agent_ctrl_reset);
+	adm_add_descs(g_dtn_ltp_agent_idx, dtn_ltp_agent_ctrl_descs, ADM_NUM_DESCS(dtn_ltp_agent_ctrl_descs));
 }
 
 void dtn_ltp_agent_init_mac()
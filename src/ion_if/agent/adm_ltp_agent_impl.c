@@ -129,7 +129,6 @@ tbl_t *dtn_ltp_agent_tblt_engines(ari_t *id)
 	OBJ_POINTER(LtpDB, ltpdb);
 	PsmAddress	elt;
 	LtpVspan	*vspan;
-	tnvc_t  *cur_row = NULL;
 
 
 	CHKNULL(sdr_begin_xn(sdr));	/*	Just to lock memory.	*/
@@ -140,15 +139,7 @@ tbl_t *dtn_ltp_agent_tblt_engines(ari_t *id)
 		vspan = (LtpVspan *) psp(ionwm, sm_list_data(ionwm, elt));
 
 		/* (UVAST) peer_engine_nbr */
-		if((cur_row = tnvc_create(1)) != NULL)
-		{
-			tnvc_insert(cur_row, tnv_from_uvast(vspan->engineId));
-			tbl_add_row(table, cur_row);
-		}
-		else
-		{
-			AMP_DEBUG_WARN("dtn_ltp_agent_tblt_engines", "Can't allocate row. Skipping.", NULL);
-		}
+		tbl_append_uvast(table, vspan->engineId);
 	}
 
 	sdr_exit_xn(sdr);
@@ -30,7 +30,7 @@
 #define _HAVE_DTN_BP_AGENT_ADM_
 #ifdef _HAVE_DTN_BP_AGENT_ADM_
 
-static vec_idx_t g_dtn_bp_agent_idx[11];
+static reg_idx_t g_dtn_bp_agent_idx[11];
 
 void dtn_bp_agent_init()
 {
@@ -54,13 +54,17 @@ void dtn_bp_agent_init()
 	dtn_bp_agent_init_tblt();
 }
 
+static const adm_desc_t dtn_bp_agent_meta_descs[] = {
+	ADM_DESC_CNST(ADM_META_IDX, DTN_BP_AGENT_META_NAME, dtn_bp_agent_meta_name),
+	ADM_DESC_CNST(ADM_META_IDX, DTN_BP_AGENT_META_NAMESPACE, dtn_bp_agent_meta_namespace),
+	ADM_DESC_CNST(ADM_META_IDX, DTN_BP_AGENT_META_VERSION, dtn_bp_agent_meta_version),
+	ADM_DESC_CNST(ADM_META_IDX, DTN_BP_AGENT_META_ORGANIZATION, dtn_bp_agent_meta_organization),
+};
+
 void dtn_bp_agent_init_meta()
 {
 
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_dtn_bp_agent_idx[ADM_META_IDX], DTN_BP_AGENT_META_NAME), dtn_bp_agent_meta_name);
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_dtn_bp_agent_idx[ADM_META_IDX], DTN_BP_AGENT_META_NAMESPACE), dtn_bp_agent_meta_namespace);
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_dtn_bp_agent_idx[ADM_META_IDX], DTN_BP_AGENT_META_VERSION), dtn_bp_agent_meta_version);
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_dtn_bp_agent_idx[ADM_META_IDX], DTN_BP_AGENT_META_ORGANIZATION), dtn_bp_agent_meta_organization);
+	adm_add_descs(g_dtn_bp_agent_idx, dtn_bp_agent_meta_descs, ADM_NUM_DESCS(dtn_bp_agent_meta_descs));
 }
 
 void dtn_bp_agent_init_cnst()
@@ -68,38 +72,42 @@ void dtn_bp_agent_init_cnst()
 
 }
 
+static const adm_desc_t dtn_bp_agent_edd_descs[] = {
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BP_AGENT_EDD_BP_NODE_ID, 0, dtn_bp_agent_get_bp_node_id),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BP_AGENT_EDD_BP_NODE_VERSION, 0, dtn_bp_agent_get_bp_node_version),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BP_AGENT_EDD_AVAILABLE_STORAGE, 0, dtn_bp_agent_get_available_storage),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BP_AGENT_EDD_LAST_RESET_TIME, 0, dtn_bp_agent_get_last_reset_time),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BP_AGENT_EDD_NUM_REGISTRATIONS, 0, dtn_bp_agent_get_num_registrations),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BP_AGENT_EDD_NUM_PEND_FWD, 0, dtn_bp_agent_get_num_pend_fwd),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BP_AGENT_EDD_NUM_PEND_DIS, 0, dtn_bp_agent_get_num_pend_dis),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BP_AGENT_EDD_NUM_IN_CUST, 0, dtn_bp_agent_get_num_in_cust),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BP_AGENT_EDD_NUM_PEND_REASSEMBLY, 0, dtn_bp_agent_get_num_pend_reassembly),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BP_AGENT_EDD_BUNDLES_BY_PRIORITY, 1, dtn_bp_agent_get_bundles_by_priority),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BP_AGENT_EDD_BYTES_BY_PRIORITY, 1, dtn_bp_agent_get_bytes_by_priority),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BP_AGENT_EDD_SRC_BUNDLES_BY_PRIORITY, 1, dtn_bp_agent_get_src_bundles_by_priority),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BP_AGENT_EDD_SRC_BYTES_BY_PRIORITY, 1, dtn_bp_agent_get_src_bytes_by_priority),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BP_AGENT_EDD_NUM_FRAGMENTED_BUNDLES, 0, dtn_bp_agent_get_num_fragmented_bundles),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BP_AGENT_EDD_NUM_FRAGMENTS_PRODUCED, 0, dtn_bp_agent_get_num_fragments_produced),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BP_AGENT_EDD_NUM_FAILED_BY_REASON, 1, dtn_bp_agent_get_num_failed_by_reason),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BP_AGENT_EDD_NUM_BUNDLES_DELETED, 0, dtn_bp_agent_get_num_bundles_deleted),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BP_AGENT_EDD_FAILED_CUSTODY_BUNDLES, 0, dtn_bp_agent_get_failed_custody_bundles),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BP_AGENT_EDD_FAILED_CUSTODY_BYTES, 0, dtn_bp_agent_get_failed_custody_bytes),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BP_AGENT_EDD_FAILED_FORWARD_BUNDLES, 0, dtn_bp_agent_get_failed_forward_bundles),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BP_AGENT_EDD_FAILED_FORWARD_BYTES, 0, dtn_bp_agent_get_failed_forward_bytes),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BP_AGENT_EDD_ABANDONED_BUNDLES, 0, dtn_bp_agent_get_abandoned_bundles),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BP_AGENT_EDD_ABANDONED_BYTES, 0, dtn_bp_agent_get_abandoned_bytes),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BP_AGENT_EDD_DISCARDED_BUNDLES, 0, dtn_bp_agent_get_discarded_bundles),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BP_AGENT_EDD_DISCARDED_BYTES, 0, dtn_bp_agent_get_discarded_bytes),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BP_AGENT_EDD_ENDPOINT_NAMES, 0, dtn_bp_agent_get_endpoint_names),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BP_AGENT_EDD_ENDPOINT_ACTIVE, 1, dtn_bp_agent_get_endpoint_active),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BP_AGENT_EDD_ENDPOINT_SINGLETON, 1, dtn_bp_agent_get_endpoint_singleton),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BP_AGENT_EDD_ENDPOINT_POLICY, 1, dtn_bp_agent_get_endpoint_policy),
+};
+
 void dtn_bp_agent_init_edd()
 {
 
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bp_agent_idx[ADM_EDD_IDX], DTN_BP_AGENT_EDD_BP_NODE_ID), dtn_bp_agent_get_bp_node_id);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bp_agent_idx[ADM_EDD_IDX], DTN_BP_AGENT_EDD_BP_NODE_VERSION), dtn_bp_agent_get_bp_node_version);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bp_agent_idx[ADM_EDD_IDX], DTN_BP_AGENT_EDD_AVAILABLE_STORAGE), dtn_bp_agent_get_available_storage);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bp_agent_idx[ADM_EDD_IDX], DTN_BP_AGENT_EDD_LAST_RESET_TIME), dtn_bp_agent_get_last_reset_time);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bp_agent_idx[ADM_EDD_IDX], DTN_BP_AGENT_EDD_NUM_REGISTRATIONS), dtn_bp_agent_get_num_registrations);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bp_agent_idx[ADM_EDD_IDX], DTN_BP_AGENT_EDD_NUM_PEND_FWD), dtn_bp_agent_get_num_pend_fwd);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bp_agent_idx[ADM_EDD_IDX], DTN_BP_AGENT_EDD_NUM_PEND_DIS), dtn_bp_agent_get_num_pend_dis);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bp_agent_idx[ADM_EDD_IDX], DTN_BP_AGENT_EDD_NUM_IN_CUST), dtn_bp_agent_get_num_in_cust);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bp_agent_idx[ADM_EDD_IDX], DTN_BP_AGENT_EDD_NUM_PEND_REASSEMBLY), dtn_bp_agent_get_num_pend_reassembly);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_bp_agent_idx[ADM_EDD_IDX], DTN_BP_AGENT_EDD_BUNDLES_BY_PRIORITY), dtn_bp_agent_get_bundles_by_priority);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_bp_agent_idx[ADM_EDD_IDX], DTN_BP_AGENT_EDD_BYTES_BY_PRIORITY), dtn_bp_agent_get_bytes_by_priority);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_bp_agent_idx[ADM_EDD_IDX], DTN_BP_AGENT_EDD_SRC_BUNDLES_BY_PRIORITY), dtn_bp_agent_get_src_bundles_by_priority);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_bp_agent_idx[ADM_EDD_IDX], DTN_BP_AGENT_EDD_SRC_BYTES_BY_PRIORITY), dtn_bp_agent_get_src_bytes_by_priority);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bp_agent_idx[ADM_EDD_IDX], DTN_BP_AGENT_EDD_NUM_FRAGMENTED_BUNDLES), dtn_bp_agent_get_num_fragmented_bundles);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bp_agent_idx[ADM_EDD_IDX], DTN_BP_AGENT_EDD_NUM_FRAGMENTS_PRODUCED), dtn_bp_agent_get_num_fragments_produced);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_bp_agent_idx[ADM_EDD_IDX], DTN_BP_AGENT_EDD_NUM_FAILED_BY_REASON), dtn_bp_agent_get_num_failed_by_reason);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bp_agent_idx[ADM_EDD_IDX], DTN_BP_AGENT_EDD_NUM_BUNDLES_DELETED), dtn_bp_agent_get_num_bundles_deleted);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bp_agent_idx[ADM_EDD_IDX], DTN_BP_AGENT_EDD_FAILED_CUSTODY_BUNDLES), dtn_bp_agent_get_failed_custody_bundles);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bp_agent_idx[ADM_EDD_IDX], DTN_BP_AGENT_EDD_FAILED_CUSTODY_BYTES), dtn_bp_agent_get_failed_custody_bytes);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bp_agent_idx[ADM_EDD_IDX], DTN_BP_AGENT_EDD_FAILED_FORWARD_BUNDLES), dtn_bp_agent_get_failed_forward_bundles);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bp_agent_idx[ADM_EDD_IDX], DTN_BP_AGENT_EDD_FAILED_FORWARD_BYTES), dtn_bp_agent_get_failed_forward_bytes);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bp_agent_idx[ADM_EDD_IDX], DTN_BP_AGENT_EDD_ABANDONED_BUNDLES), dtn_bp_agent_get_abandoned_bundles);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bp_agent_idx[ADM_EDD_IDX], DTN_BP_AGENT_EDD_ABANDONED_BYTES), dtn_bp_agent_get_abandoned_bytes);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bp_agent_idx[ADM_EDD_IDX], DTN_BP_AGENT_EDD_DISCARDED_BUNDLES), dtn_bp_agent_get_discarded_bundles);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bp_agent_idx[ADM_EDD_IDX], DTN_BP_AGENT_EDD_DISCARDED_BYTES), dtn_bp_agent_get_discarded_bytes);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bp_agent_idx[ADM_EDD_IDX], DTN_BP_AGENT_EDD_ENDPOINT_NAMES), dtn_bp_agent_get_endpoint_names);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_bp_agent_idx[ADM_EDD_IDX], DTN_BP_AGENT_EDD_ENDPOINT_ACTIVE), dtn_bp_agent_get_endpoint_active);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_bp_agent_idx[ADM_EDD_IDX], DTN_BP_AGENT_EDD_ENDPOINT_SINGLETON), dtn_bp_agent_get_endpoint_singleton);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_bp_agent_idx[ADM_EDD_IDX], DTN_BP_AGENT_EDD_ENDPOINT_POLICY), dtn_bp_agent_get_endpoint_policy);
+	adm_add_descs(g_dtn_bp_agent_idx, dtn_bp_agent_edd_descs, ADM_NUM_DESCS(dtn_bp_agent_edd_descs));
 }
 
 void dtn_bp_agent_init_op()
@@ -112,10 +120,14 @@ void dtn_bp_agent_init_var()
 
 }
 
+static const adm_desc_t dtn_bp_agent_ctrl_descs[] = {
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_BP_AGENT_CTRL_RESET_ALL_COUNTS, 0, dtn_bp_agent_ctrl_reset_all_counts),
+};
+
 void dtn_bp_agent_init_ctrl()
 {
 
-	adm_add_ctrldef(g_dtn_bp_agent_idx[ADM_CTRL_IDX], DTN_BP_AGENT_CTRL_RESET_ALL_COUNTS, 0, dtn_bp_agent_ctrl_reset_all_counts);
+	adm_add_descs(g_dtn_bp_agent_idx, dtn_bp_agent_ctrl_descs, ADM_NUM_DESCS(dtn_bp_agent_ctrl_descs));
 }
 
 void dtn_bp_agent_init_mac()
@@ -20,6 +20,7 @@
 #include "bp.h"
 #include "bpP.h"
 #include "bpnm.h"
+#include "agent/ldc.h"
 
 
 /*   STOP CUSTOM INCLUDES HERE  */
@@ -29,7 +30,29 @@
 #include "adm_bp_agent_impl.h"
 
 /*   START CUSTOM FUNCTIONS HERE */
-/*             TODO              */
+
+/*
+ * Node and disposition state are each read once per collection cycle and
+ * shared by every EDD drawn from them.
+ */
+static NmbpNode gBpNode;
+static NmbpDisposition gBpDisposition;
+
+static int dtn_bp_agent_fetch_node(void *data)
+{
+	bpnm_node_get((NmbpNode *) data);
+	return AMP_OK;
+}
+
+static int dtn_bp_agent_fetch_disposition(void *data)
+{
+	bpnm_disposition_get((NmbpDisposition *) data);
+	return AMP_OK;
+}
+
+static ldc_snap_t gBpNodeSnap = LDC_SNAP_INIT(dtn_bp_agent_fetch_node, &gBpNode);
+static ldc_snap_t gBpDispSnap = LDC_SNAP_INIT(dtn_bp_agent_fetch_disposition, &gBpDisposition);
+
 /*   STOP CUSTOM FUNCTIONS HERE  */
 
 void dtn_bp_agent_setup()
@@ -107,7 +130,7 @@ tnv_t *dtn_bp_agent_get_bp_node_id(tnvc_t *parms)
 	 * +-------------------------------------------------------------------------+
 	 */
 	NmbpNode node_state;
-	bpnm_node_get(&node_state);
+	ldc_snap_read(&gBpNodeSnap, &node_state);
 
 	result = tnv_from_str((char *) node_state.nodeID);
 
@@ -132,7 +155,7 @@ tnv_t *dtn_bp_agent_get_bp_node_version(tnvc_t *parms)
 	 * +-------------------------------------------------------------------------+
 	 */
 	NmbpNode node_state;
-	bpnm_node_get(&node_state);
+	ldc_snap_read(&gBpNodeSnap, &node_state);
 
 	result = tnv_from_str((char *) node_state.bpVersionNbr);
 
@@ -157,7 +180,7 @@ tnv_t *dtn_bp_agent_get_available_storage(tnvc_t *parms)
 	 * +-------------------------------------------------------------------------+
 	 */
 	NmbpNode node_state;
-	bpnm_node_get(&node_state);
+	ldc_snap_read(&gBpNodeSnap, &node_state);
 
 	result = tnv_from_uvast(node_state.avblStorage);
 
@@ -214,7 +237,7 @@ tnv_t *dtn_bp_agent_get_num_registrations(tnvc_t *parms)
 	 * +-------------------------------------------------------------------------+
 	 */
 	NmbpNode node_state;
-	bpnm_node_get(&node_state);
+	ldc_snap_read(&gBpNodeSnap, &node_state);
 
 	result = tnv_from_uint(node_state.nbrOfRegistrations);
 	
@@ -239,7 +262,7 @@ tnv_t *dtn_bp_agent_get_num_pend_fwd(tnvc_t *parms)
 	 * +-------------------------------------------------------------------------+
 	 */
 	NmbpDisposition state;
-	bpnm_disposition_get(&state);
+	ldc_snap_read(&gBpDispSnap, &state);
 
 	result = tnv_from_uvast(state.currentForwardPending);
 	
@@ -264,7 +287,7 @@ tnv_t *dtn_bp_agent_get_num_pend_dis(tnvc_t *parms)
 	 * +-------------------------------------------------------------------------+
 	 */
 	NmbpDisposition state;
-	bpnm_disposition_get(&state);
+	ldc_snap_read(&gBpDispSnap, &state);
 
 	result = tnv_from_uvast(state.currentDispatchPending);
 	
@@ -289,7 +312,7 @@ tnv_t *dtn_bp_agent_get_num_in_cust(tnvc_t *parms)
 	 * +-------------------------------------------------------------------------+
 	 */
 	NmbpDisposition state;
-	bpnm_disposition_get(&state);
+	ldc_snap_read(&gBpDispSnap, &state);
 
 	result = tnv_from_uvast(state.currentInCustody);
 	
@@ -314,7 +337,7 @@ tnv_t *dtn_bp_agent_get_num_pend_reassembly(tnvc_t *parms)
 	 * +-------------------------------------------------------------------------+
 	 */
 	NmbpDisposition state;
-	bpnm_disposition_get(&state);
+	ldc_snap_read(&gBpDispSnap, &state);
 
 	result = tnv_from_uvast(state.currentReassemblyPending);
 	/*
@@ -342,7 +365,7 @@ tnv_t *dtn_bp_agent_get_bundles_by_priority(tnvc_t *parms)
 	NmbpDisposition state;
 	int success = 0;
 
-	bpnm_disposition_get(&state);
+	ldc_snap_read(&gBpDispSnap, &state);
 	uvast val = 0;
 	uint32_t mask = adm_get_parm_uint(parms, 0, &success);
 
@@ -385,7 +408,7 @@ tnv_t *dtn_bp_agent_get_bytes_by_priority(tnvc_t *parms)
 	 */
 	NmbpDisposition state;
 	int success = 0;
-	bpnm_disposition_get(&state);
+	ldc_snap_read(&gBpDispSnap, &state);
 	uvast val = 0;
 	uint32_t mask = adm_get_parm_uint(parms, 0, &success);
 
@@ -428,7 +451,7 @@ tnv_t *dtn_bp_agent_get_src_bundles_by_priority(tnvc_t *parms)
 	 */
 	NmbpDisposition state;
 	int success = 0;
-	bpnm_disposition_get(&state);
+	ldc_snap_read(&gBpDispSnap, &state);
 
 	uvast val = 0;
 	uint32_t mask = adm_get_parm_uint(parms, 0, &success);
@@ -472,7 +495,7 @@ tnv_t *dtn_bp_agent_get_src_bytes_by_priority(tnvc_t *parms)
 	 */
 	NmbpDisposition state;
 	int success = 0;
-	bpnm_disposition_get(&state);
+	ldc_snap_read(&gBpDispSnap, &state);
 
 	uvast val = 0;
 	uint32_t mask = adm_get_parm_uint(parms, 0, &success);
@@ -514,7 +537,7 @@ tnv_t *dtn_bp_agent_get_num_fragmented_bundles(tnvc_t *parms)
 	 */
 
 	NmbpDisposition state;
-	bpnm_disposition_get(&state);
+	ldc_snap_read(&gBpDispSnap, &state);
 
 	result = tnv_from_uvast(state.bundlesFragmented);
 	
@@ -539,7 +562,7 @@ tnv_t *dtn_bp_agent_get_num_fragments_produced(tnvc_t *parms)
 	 * +-------------------------------------------------------------------------+
 	 */
 	NmbpDisposition state;
-	bpnm_disposition_get(&state);
+	ldc_snap_read(&gBpDispSnap, &state);
 
 	result = tnv_from_uvast(state.fragmentsProduced);
 	
@@ -566,7 +589,7 @@ tnv_t *dtn_bp_agent_get_num_failed_by_reason(tnvc_t *parms)
 	 */
 	NmbpDisposition state;
 	int success = 0;
-	bpnm_disposition_get(&state);
+	ldc_snap_read(&gBpDispSnap, &state);
 
 	uint32_t mask = adm_get_parm_uint(parms, 0, &success);
 	uvast val = 0;
@@ -630,7 +653,7 @@ tnv_t *dtn_bp_agent_get_num_bundles_deleted(tnvc_t *parms)
 	 * +-------------------------------------------------------------------------+
 	 */
 	NmbpDisposition state;
-	bpnm_disposition_get(&state);
+	ldc_snap_read(&gBpDispSnap, &state);
 
 	result = tnv_from_uvast(state.delNoneCount + state.delExpiredCount + state.delFwdUnidirCount + state.delCanceledCount + state.delDepletionCount + state.delEidMalformedCount + state.delNoRouteCount + state.delNoContactCount + state.delBlkMalformedCount);
 
@@ -655,7 +678,7 @@ tnv_t *dtn_bp_agent_get_failed_custody_bundles(tnvc_t *parms)
 	 * +-------------------------------------------------------------------------+
 	 */
 	NmbpDisposition state;
-	bpnm_disposition_get(&state);
+	ldc_snap_read(&gBpDispSnap, &state);
 
 	result = tnv_from_uvast(state.custodyRefusedCount);
 	
@@ -680,7 +703,7 @@ tnv_t *dtn_bp_agent_get_failed_custody_bytes(tnvc_t *parms)
 	 * +-------------------------------------------------------------------------+
 	 */
 	NmbpDisposition state;
-	bpnm_disposition_get(&state);
+	ldc_snap_read(&gBpDispSnap, &state);
 
 	result = tnv_from_uvast(state.custodyRefusedBytes);
 	
@@ -705,7 +728,7 @@ tnv_t *dtn_bp_agent_get_failed_forward_bundles(tnvc_t *parms)
 	 * +-------------------------------------------------------------------------+
 	 */
 	NmbpDisposition state;
-	bpnm_disposition_get(&state);
+	ldc_snap_read(&gBpDispSnap, &state);
 
 	result = tnv_from_uvast(state.bundleFwdFailedCount);
 	
@@ -730,7 +753,7 @@ tnv_t *dtn_bp_agent_get_failed_forward_bytes(tnvc_t *parms)
 	 * +-------------------------------------------------------------------------+
 	 */
 	NmbpDisposition state;
-	bpnm_disposition_get(&state);
+	ldc_snap_read(&gBpDispSnap, &state);
 
 	result = tnv_from_uvast(state.bundleFwdFailedBytes);
 	
@@ -755,7 +778,7 @@ tnv_t *dtn_bp_agent_get_abandoned_bundles(tnvc_t *parms)
 	 * +-------------------------------------------------------------------------+
 	 */
 	NmbpDisposition state;
-	bpnm_disposition_get(&state);
+	ldc_snap_read(&gBpDispSnap, &state);
 
 	result = tnv_from_uvast(state.bundleAbandonCount);
 	
@@ -780,7 +803,7 @@ tnv_t *dtn_bp_agent_get_abandoned_bytes(tnvc_t *parms)
 	 * +-------------------------------------------------------------------------+
 	 */
 	NmbpDisposition state;
-	bpnm_disposition_get(&state);
+	ldc_snap_read(&gBpDispSnap, &state);
 
 	result = tnv_from_uvast(state.bundleAbandonBytes);
 	
@@ -805,7 +828,7 @@ tnv_t *dtn_bp_agent_get_discarded_bundles(tnvc_t *parms)
 	 * +-------------------------------------------------------------------------+
 	 */
 	NmbpDisposition state;
-	bpnm_disposition_get(&state);
+	ldc_snap_read(&gBpDispSnap, &state);
 
 	result = tnv_from_uvast(state.bundleDiscardCount);
 	
@@ -830,7 +853,7 @@ tnv_t *dtn_bp_agent_get_discarded_bytes(tnvc_t *parms)
 	 * +-------------------------------------------------------------------------+
 	 */
 	NmbpDisposition state;
-	bpnm_disposition_get(&state);
+	ldc_snap_read(&gBpDispSnap, &state);
 
 	result = tnv_from_uvast(state.bundleDiscardBytes);
 
@@ -987,6 +1010,7 @@ tnv_t *dtn_bp_agent_ctrl_reset_all_counts(eid_t *def_mgr, tnvc_t *parms, int8_t
 	 */
 
 	bpnm_disposition_reset();
+	ldc_snap_invalidate(&gBpDispSnap);
 	*status = CTRL_SUCCESS;
 
 	/*
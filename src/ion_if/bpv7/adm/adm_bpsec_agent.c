@@ -31,7 +31,7 @@
 #define _HAVE_DTN_BPSEC_ADM_
 #ifdef _HAVE_DTN_BPSEC_ADM_
 
-static vec_idx_t g_dtn_bpsec_idx[11];
+static reg_idx_t g_dtn_bpsec_idx[11];
 
 void dtn_bpsec_init()
 {
@@ -57,13 +57,17 @@ void dtn_bpsec_init()
 	dtn_bpsec_init_tblt();
 }
 
+static const adm_desc_t dtn_bpsec_meta_descs[] = {
+	ADM_DESC_CNST(ADM_META_IDX, DTN_BPSEC_META_NAME, dtn_bpsec_meta_name),
+	ADM_DESC_CNST(ADM_META_IDX, DTN_BPSEC_META_NAMESPACE, dtn_bpsec_meta_namespace),
+	ADM_DESC_CNST(ADM_META_IDX, DTN_BPSEC_META_VERSION, dtn_bpsec_meta_version),
+	ADM_DESC_CNST(ADM_META_IDX, DTN_BPSEC_META_ORGANIZATION, dtn_bpsec_meta_organization),
+};
+
 void dtn_bpsec_init_meta()
 {
 
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_dtn_bpsec_idx[ADM_META_IDX], DTN_BPSEC_META_NAME), dtn_bpsec_meta_name);
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_dtn_bpsec_idx[ADM_META_IDX], DTN_BPSEC_META_NAMESPACE), dtn_bpsec_meta_namespace);
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_dtn_bpsec_idx[ADM_META_IDX], DTN_BPSEC_META_VERSION), dtn_bpsec_meta_version);
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_dtn_bpsec_idx[ADM_META_IDX], DTN_BPSEC_META_ORGANIZATION), dtn_bpsec_meta_organization);
+	adm_add_descs(g_dtn_bpsec_idx, dtn_bpsec_meta_descs, ADM_NUM_DESCS(dtn_bpsec_meta_descs));
 }
 
 void dtn_bpsec_init_cnst()
@@ -71,65 +75,69 @@ void dtn_bpsec_init_cnst()
 
 }
 
+static const adm_desc_t dtn_bpsec_edd_descs[] = {
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_GOOD_TX_BCB_BLK, 0, dtn_bpsec_get_num_good_tx_bcb_blk),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_BAD_TX_BCB_BLK, 0, dtn_bpsec_get_num_bad_tx_bcb_blk),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_GOOD_RX_BCB_BLK, 0, dtn_bpsec_get_num_good_rx_bcb_blk),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_BAD_RX_BCB_BLK, 0, dtn_bpsec_get_num_bad_rx_bcb_blk),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_MISSING_RX_BCB_BLKS, 0, dtn_bpsec_get_num_missing_rx_bcb_blks),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_FWD_BCB_BLKS, 0, dtn_bpsec_get_num_fwd_bcb_blks),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_GOOD_TX_BCB_BYTES, 0, dtn_bpsec_get_num_good_tx_bcb_bytes),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_BAD_TX_BCB_BYTES, 0, dtn_bpsec_get_num_bad_tx_bcb_bytes),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_BAD_TX_BCB_BLKS, 0, dtn_bpsec_get_num_bad_tx_bcb_blks),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_GOOD_RX_BCB_BYTES, 0, dtn_bpsec_get_num_good_rx_bcb_bytes),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_BAD_RX_BCB_BYTES, 0, dtn_bpsec_get_num_bad_rx_bcb_bytes),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_MISSING_RX_BCB_BYTES, 0, dtn_bpsec_get_num_missing_rx_bcb_bytes),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_FWD_BCB_BYTES, 0, dtn_bpsec_get_num_fwd_bcb_bytes),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_GOOD_TX_BIB_BLKS, 0, dtn_bpsec_get_num_good_tx_bib_blks),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_BAD_TX_BIB_BLKS, 0, dtn_bpsec_get_num_bad_tx_bib_blks),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_GOOD_RX_BIB_BLKS, 0, dtn_bpsec_get_num_good_rx_bib_blks),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_BAD_RX_BIB_BLKS, 0, dtn_bpsec_get_num_bad_rx_bib_blks),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_MISS_RX_BIB_BLKS, 0, dtn_bpsec_get_num_miss_rx_bib_blks),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_FWD_BIB_BLKS, 0, dtn_bpsec_get_num_fwd_bib_blks),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_GOOD_TX_BIB_BYTES, 0, dtn_bpsec_get_num_good_tx_bib_bytes),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_BAD_TX_BIB_BYTES, 0, dtn_bpsec_get_num_bad_tx_bib_bytes),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_GOOD_RX_BIB_BYTES, 0, dtn_bpsec_get_num_good_rx_bib_bytes),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_BAD_RX_BIB_BYTES, 0, dtn_bpsec_get_num_bad_rx_bib_bytes),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_MISS_RX_BIB_BYTES, 0, dtn_bpsec_get_num_miss_rx_bib_bytes),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_FWD_BIB_BYTES, 0, dtn_bpsec_get_num_fwd_bib_bytes),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_LAST_UPDATE, 0, dtn_bpsec_get_last_update),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_KNOWN_KEYS, 0, dtn_bpsec_get_num_known_keys),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_KEY_NAMES, 0, dtn_bpsec_get_key_names),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_CIPHERSUITE_NAMES, 0, dtn_bpsec_get_ciphersuite_names),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_RULE_SOURCE, 0, dtn_bpsec_get_rule_source),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_GOOD_TX_BCB_BLKS_SRC, 1, dtn_bpsec_get_num_good_tx_bcb_blks_src),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_BAD_TX_BCB_BLKS_SRC, 1, dtn_bpsec_get_num_bad_tx_bcb_blks_src),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_GOOD_RX_BCB_BLKS_SRC, 1, dtn_bpsec_get_num_good_rx_bcb_blks_src),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_BAD_RX_BCB_BLKS_SRC, 1, dtn_bpsec_get_num_bad_rx_bcb_blks_src),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_MISSING_RX_BCB_BLKS_SRC, 1, dtn_bpsec_get_num_missing_rx_bcb_blks_src),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_FWD_BCB_BLKS_SRC, 1, dtn_bpsec_get_num_fwd_bcb_blks_src),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_GOOD_TX_BCB_BYTES_SRC, 1, dtn_bpsec_get_num_good_tx_bcb_bytes_src),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_BAD_TX_BCB_BYTES_SRC, 1, dtn_bpsec_get_num_bad_tx_bcb_bytes_src),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_GOOD_RX_BCB_BYTES_SRC, 1, dtn_bpsec_get_num_good_rx_bcb_bytes_src),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_BAD_RX_BCB_BYTES_SRC, 1, dtn_bpsec_get_num_bad_rx_bcb_bytes_src),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_MISSING_RX_BCB_BYTES_SRC, 1, dtn_bpsec_get_num_missing_rx_bcb_bytes_src),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_FWD_BCB_BYTES_SRC, 1, dtn_bpsec_get_num_fwd_bcb_bytes_src),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_GOOD_TX_BIB_BLKS_SRC, 1, dtn_bpsec_get_num_good_tx_bib_blks_src),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_BAD_TX_BIB_BLKS_SRC, 1, dtn_bpsec_get_num_bad_tx_bib_blks_src),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_GOOD_RX_BIB_BLKS_SRC, 1, dtn_bpsec_get_num_good_rx_bib_blks_src),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_BAD_RX_BIB_BLKS_SRC, 1, dtn_bpsec_get_num_bad_rx_bib_blks_src),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_MISS_RX_BIB_BLKS_SRC, 1, dtn_bpsec_get_num_miss_rx_bib_blks_src),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_FWD_BIB_BLKS_SRC, 1, dtn_bpsec_get_num_fwd_bib_blks_src),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_GOOD_TX_BIB_BYTES_SRC, 1, dtn_bpsec_get_num_good_tx_bib_bytes_src),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_BAD_TX_BIB_BYTES_SRC, 1, dtn_bpsec_get_num_bad_tx_bib_bytes_src),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_GOOD_RX_BIB_BYTES_SRC, 1, dtn_bpsec_get_num_good_rx_bib_bytes_src),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_BAD_RX_BIB_BYTES_SRC, 1, dtn_bpsec_get_num_bad_rx_bib_bytes_src),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_MISSING_RX_BIB_BYTES_SRC, 1, dtn_bpsec_get_num_missing_rx_bib_bytes_src),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_NUM_FWD_BIB_BYTES_SRC, 1, dtn_bpsec_get_num_fwd_bib_bytes_src),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_LAST_UPDATE_SRC, 1, dtn_bpsec_get_last_update_src),
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_BPSEC_EDD_LAST_RESET, 1, dtn_bpsec_get_last_reset),
+};
+
 void dtn_bpsec_init_edd()
 {
 
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_GOOD_TX_BCB_BLK), dtn_bpsec_get_num_good_tx_bcb_blk);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_BAD_TX_BCB_BLK), dtn_bpsec_get_num_bad_tx_bcb_blk);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_GOOD_RX_BCB_BLK), dtn_bpsec_get_num_good_rx_bcb_blk);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_BAD_RX_BCB_BLK), dtn_bpsec_get_num_bad_rx_bcb_blk);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_MISSING_RX_BCB_BLKS), dtn_bpsec_get_num_missing_rx_bcb_blks);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_FWD_BCB_BLKS), dtn_bpsec_get_num_fwd_bcb_blks);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_GOOD_TX_BCB_BYTES), dtn_bpsec_get_num_good_tx_bcb_bytes);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_BAD_TX_BCB_BYTES), dtn_bpsec_get_num_bad_tx_bcb_bytes);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_BAD_TX_BCB_BLKS), dtn_bpsec_get_num_bad_tx_bcb_blks);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_GOOD_RX_BCB_BYTES), dtn_bpsec_get_num_good_rx_bcb_bytes);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_BAD_RX_BCB_BYTES), dtn_bpsec_get_num_bad_rx_bcb_bytes);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_MISSING_RX_BCB_BYTES), dtn_bpsec_get_num_missing_rx_bcb_bytes);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_FWD_BCB_BYTES), dtn_bpsec_get_num_fwd_bcb_bytes);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_GOOD_TX_BIB_BLKS), dtn_bpsec_get_num_good_tx_bib_blks);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_BAD_TX_BIB_BLKS), dtn_bpsec_get_num_bad_tx_bib_blks);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_GOOD_RX_BIB_BLKS), dtn_bpsec_get_num_good_rx_bib_blks);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_BAD_RX_BIB_BLKS), dtn_bpsec_get_num_bad_rx_bib_blks);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_MISS_RX_BIB_BLKS), dtn_bpsec_get_num_miss_rx_bib_blks);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_FWD_BIB_BLKS), dtn_bpsec_get_num_fwd_bib_blks);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_GOOD_TX_BIB_BYTES), dtn_bpsec_get_num_good_tx_bib_bytes);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_BAD_TX_BIB_BYTES), dtn_bpsec_get_num_bad_tx_bib_bytes);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_GOOD_RX_BIB_BYTES), dtn_bpsec_get_num_good_rx_bib_bytes);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_BAD_RX_BIB_BYTES), dtn_bpsec_get_num_bad_rx_bib_bytes);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_MISS_RX_BIB_BYTES), dtn_bpsec_get_num_miss_rx_bib_bytes);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_FWD_BIB_BYTES), dtn_bpsec_get_num_fwd_bib_bytes);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_LAST_UPDATE), dtn_bpsec_get_last_update);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_KNOWN_KEYS), dtn_bpsec_get_num_known_keys);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_KEY_NAMES), dtn_bpsec_get_key_names);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_CIPHERSUITE_NAMES), dtn_bpsec_get_ciphersuite_names);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_RULE_SOURCE), dtn_bpsec_get_rule_source);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_GOOD_TX_BCB_BLKS_SRC), dtn_bpsec_get_num_good_tx_bcb_blks_src);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_BAD_TX_BCB_BLKS_SRC), dtn_bpsec_get_num_bad_tx_bcb_blks_src);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_GOOD_RX_BCB_BLKS_SRC), dtn_bpsec_get_num_good_rx_bcb_blks_src);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_BAD_RX_BCB_BLKS_SRC), dtn_bpsec_get_num_bad_rx_bcb_blks_src);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_MISSING_RX_BCB_BLKS_SRC), dtn_bpsec_get_num_missing_rx_bcb_blks_src);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_FWD_BCB_BLKS_SRC), dtn_bpsec_get_num_fwd_bcb_blks_src);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_GOOD_TX_BCB_BYTES_SRC), dtn_bpsec_get_num_good_tx_bcb_bytes_src);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_BAD_TX_BCB_BYTES_SRC), dtn_bpsec_get_num_bad_tx_bcb_bytes_src);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_GOOD_RX_BCB_BYTES_SRC), dtn_bpsec_get_num_good_rx_bcb_bytes_src);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_BAD_RX_BCB_BYTES_SRC), dtn_bpsec_get_num_bad_rx_bcb_bytes_src);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_MISSING_RX_BCB_BYTES_SRC), dtn_bpsec_get_num_missing_rx_bcb_bytes_src);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_FWD_BCB_BYTES_SRC), dtn_bpsec_get_num_fwd_bcb_bytes_src);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_GOOD_TX_BIB_BLKS_SRC), dtn_bpsec_get_num_good_tx_bib_blks_src);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_BAD_TX_BIB_BLKS_SRC), dtn_bpsec_get_num_bad_tx_bib_blks_src);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_GOOD_RX_BIB_BLKS_SRC), dtn_bpsec_get_num_good_rx_bib_blks_src);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_BAD_RX_BIB_BLKS_SRC), dtn_bpsec_get_num_bad_rx_bib_blks_src);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_MISS_RX_BIB_BLKS_SRC), dtn_bpsec_get_num_miss_rx_bib_blks_src);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_FWD_BIB_BLKS_SRC), dtn_bpsec_get_num_fwd_bib_blks_src);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_GOOD_TX_BIB_BYTES_SRC), dtn_bpsec_get_num_good_tx_bib_bytes_src);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_BAD_TX_BIB_BYTES_SRC), dtn_bpsec_get_num_bad_tx_bib_bytes_src);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_GOOD_RX_BIB_BYTES_SRC), dtn_bpsec_get_num_good_rx_bib_bytes_src);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_BAD_RX_BIB_BYTES_SRC), dtn_bpsec_get_num_bad_rx_bib_bytes_src);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_MISSING_RX_BIB_BYTES_SRC), dtn_bpsec_get_num_missing_rx_bib_bytes_src);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_NUM_FWD_BIB_BYTES_SRC), dtn_bpsec_get_num_fwd_bib_bytes_src);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_LAST_UPDATE_SRC), dtn_bpsec_get_last_update_src);
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 1, g_dtn_bpsec_idx[ADM_EDD_IDX], DTN_BPSEC_EDD_LAST_RESET), dtn_bpsec_get_last_reset);
+	adm_add_descs(g_dtn_bpsec_idx, dtn_bpsec_edd_descs, ADM_NUM_DESCS(dtn_bpsec_edd_descs));
 }
 
 void dtn_bpsec_init_op()
@@ -155,17 +163,21 @@ void dtn_bpsec_init_var()
 	adm_add_var_from_expr(id, AMP_TYPE_UINT, expr);
 }
 
+static const adm_desc_t dtn_bpsec_ctrl_descs[] = {
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_BPSEC_CTRL_RST_ALL_CNTS, 0, dtn_bpsec_ctrl_rst_all_cnts),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_BPSEC_CTRL_RST_SRC_CNTS, 1, dtn_bpsec_ctrl_rst_src_cnts),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_BPSEC_CTRL_DELETE_KEY, 1, dtn_bpsec_ctrl_delete_key),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_BPSEC_CTRL_ADD_KEY, 2, dtn_bpsec_ctrl_add_key),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_BPSEC_CTRL_ADD_BIB_RULE, 5, dtn_bpsec_ctrl_add_bib_rule),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_BPSEC_CTRL_DEL_BIB_RULE, 3, dtn_bpsec_ctrl_del_bib_rule),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_BPSEC_CTRL_ADD_BCB_RULE, 5, dtn_bpsec_ctrl_add_bcb_rule),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_BPSEC_CTRL_DEL_BCB_RULE, 3, dtn_bpsec_ctrl_del_bcb_rule),
+};
+
 void dtn_bpsec_init_ctrl()
 {
 
-	adm_add_ctrldef(g_dtn_bpsec_idx[ADM_CTRL_IDX], DTN_BPSEC_CTRL_RST_ALL_CNTS, 0, dtn_bpsec_ctrl_rst_all_cnts);
-	adm_add_ctrldef(g_dtn_bpsec_idx[ADM_CTRL_IDX], DTN_BPSEC_CTRL_RST_SRC_CNTS, 1, dtn_bpsec_ctrl_rst_src_cnts);
-	adm_add_ctrldef(g_dtn_bpsec_idx[ADM_CTRL_IDX], DTN_BPSEC_CTRL_DELETE_KEY, 1, dtn_bpsec_ctrl_delete_key);
-	adm_add_ctrldef(g_dtn_bpsec_idx[ADM_CTRL_IDX], DTN_BPSEC_CTRL_ADD_KEY, 2, dtn_bpsec_ctrl_add_key);
-	adm_add_ctrldef(g_dtn_bpsec_idx[ADM_CTRL_IDX], DTN_BPSEC_CTRL_ADD_BIB_RULE, 5, dtn_bpsec_ctrl_add_bib_rule);
-	adm_add_ctrldef(g_dtn_bpsec_idx[ADM_CTRL_IDX], DTN_BPSEC_CTRL_DEL_BIB_RULE, 3, dtn_bpsec_ctrl_del_bib_rule);
-	adm_add_ctrldef(g_dtn_bpsec_idx[ADM_CTRL_IDX], DTN_BPSEC_CTRL_ADD_BCB_RULE, 5, dtn_bpsec_ctrl_add_bcb_rule);
-	adm_add_ctrldef(g_dtn_bpsec_idx[ADM_CTRL_IDX], DTN_BPSEC_CTRL_DEL_BCB_RULE, 3, dtn_bpsec_ctrl_del_bcb_rule);
+	adm_add_descs(g_dtn_bpsec_idx, dtn_bpsec_ctrl_descs, ADM_NUM_DESCS(dtn_bpsec_ctrl_descs));
 }
 
 void dtn_bpsec_init_mac()
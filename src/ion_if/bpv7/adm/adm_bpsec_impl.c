@@ -229,7 +229,6 @@ tbl_t *dtn_bpsec_tblt_bib_rules(ari_t *id)
 	Object	elt = 0;
 	OBJ_POINTER(BPsecBibRule, rule);
 	char strBuffer[SDRSTRING_BUFSZ];
-	tnvc_t *cur_row = NULL;
 	int len = 0;
 
 	if((listObj = sec_get_bpsecBibRuleList()) == 0)
@@ -249,32 +248,24 @@ tbl_t *dtn_bpsec_tblt_bib_rules(ari_t *id)
 	for (elt = sdr_list_first(sdr, listObj); elt; elt = sdr_list_next(sdr, elt))
 	{
 
-		if((cur_row = tnvc_create(5)) != NULL)
-		{
-			GET_OBJ_POINTER(sdr, BPsecBibRule, rule, sdr_list_data(sdr, elt));
+		GET_OBJ_POINTER(sdr, BPsecBibRule, rule, sdr_list_data(sdr, elt));
 
-			if(rule != NULL)
-			{
-				len = sdr_string_read(sdr, strBuffer, rule->securitySrcEid);
-				tnvc_insert(cur_row, tnv_from_str( (len > 0) ? strBuffer : "unk"));
+		if(rule != NULL)
+		{
+			len = sdr_string_read(sdr, strBuffer, rule->securitySrcEid);
+			tbl_append_str(table, (len > 0) ? strBuffer : "unk");
 
-				len = sdr_string_read(sdr, strBuffer, rule->destEid);
-				tnvc_insert(cur_row, tnv_from_str( (len > 0) ? strBuffer : "unk"));
+			len = sdr_string_read(sdr, strBuffer, rule->destEid);
+			tbl_append_str(table, (len > 0) ? strBuffer : "unk");
 
-				tnvc_insert(cur_row, tnv_from_uint(rule->blockType));
-				tnvc_insert(cur_row, tnv_from_str(rule->profileName));
-				tnvc_insert(cur_row, tnv_from_str(rule->keyName));
+			tbl_append_uint(table, rule->blockType);
+			tbl_append_str(table, rule->profileName);
+			tbl_append_str(table, rule->keyName);
 
-				tbl_add_row(table, cur_row);
-			}
-			else
-			{
-				AMP_DEBUG_WARN("dtn_bpsec_tblt_bib_rules", "NULL rule?", NULL);
-			}
 		}
 		else
 		{
-			AMP_DEBUG_WARN("dtn_bpsec_tblt_bib_rules", "Can't allocate row. Skipping.", NULL);
+			AMP_DEBUG_WARN("dtn_bpsec_tblt_bib_rules", "NULL rule?", NULL);
 		}
 	}
 
@@ -311,7 +302,6 @@ tbl_t *dtn_bpsec_tblt_bcb_rules(ari_t *id)
 	Object	elt = 0;
 	OBJ_POINTER(BPsecBcbRule, rule);
 	char strBuffer[SDRSTRING_BUFSZ];
-	tnvc_t *cur_row = NULL;
 	int len = 0;
 
 	if((listObj = sec_get_bpsecBcbRuleList()) == 0)
@@ -330,32 +320,24 @@ tbl_t *dtn_bpsec_tblt_bcb_rules(ari_t *id)
 
 	for (elt = sdr_list_first(sdr, listObj); elt; elt = sdr_list_next(sdr, elt))
 	{
-		if((cur_row = tnvc_create(5)) != NULL)
-		{
-			GET_OBJ_POINTER(sdr, BPsecBcbRule, rule, sdr_list_data(sdr, elt));
+		GET_OBJ_POINTER(sdr, BPsecBcbRule, rule, sdr_list_data(sdr, elt));
 
-			if(rule != NULL)
-			{
-				len = sdr_string_read(sdr, strBuffer, rule->securitySrcEid);
-				tnvc_insert(cur_row, tnv_from_str( (len > 0) ? strBuffer : "unk"));
+		if(rule != NULL)
+		{
+			len = sdr_string_read(sdr, strBuffer, rule->securitySrcEid);
+			tbl_append_str(table, (len > 0) ? strBuffer : "unk");
 
-				len = sdr_string_read(sdr, strBuffer, rule->destEid);
-				tnvc_insert(cur_row, tnv_from_str( (len > 0) ? strBuffer : "unk"));
+			len = sdr_string_read(sdr, strBuffer, rule->destEid);
+			tbl_append_str(table, (len > 0) ? strBuffer : "unk");
 
-				tnvc_insert(cur_row, tnv_from_uint(rule->blockType));
-				tnvc_insert(cur_row, tnv_from_str(rule->profileName));
-				tnvc_insert(cur_row, tnv_from_str(rule->keyName));
+			tbl_append_uint(table, rule->blockType);
+			tbl_append_str(table, rule->profileName);
+			tbl_append_str(table, rule->keyName);
 
-				tbl_add_row(table, cur_row);
-			}
-			else
-			{
-				AMP_DEBUG_WARN("dtn_bpsec_tblt_bcb_rules", "NULL rule?", NULL);
-			}
 		}
 		else
 		{
-			AMP_DEBUG_WARN("dtn_bpsec_tblt_bcb_rules", "Can't allocate row. Skipping.", NULL);
+			AMP_DEBUG_WARN("dtn_bpsec_tblt_bcb_rules", "NULL rule?", NULL);
 		}
 	}
 
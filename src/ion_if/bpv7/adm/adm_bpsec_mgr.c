@@ -31,7 +31,7 @@
 
 #define _HAVE_DTN_BPSEC_ADM_
 #ifdef _HAVE_DTN_BPSEC_ADM_
-static vec_idx_t g_dtn_bpsec_idx[11];
+static reg_idx_t g_dtn_bpsec_idx[11];
 
 void dtn_bpsec_init()
 {
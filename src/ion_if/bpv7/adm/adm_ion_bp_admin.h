@@ -32,7 +32,7 @@
  *
  * ADM ROOT STRING:dtn_ion_bpadmin
  */
-extern vec_idx_t g_dtn_ion_bpadmin_idx[11];
+extern reg_idx_t g_dtn_ion_bpadmin_idx[11];
 
 /*
  * +---------------------------------------------------------------------------------------------+
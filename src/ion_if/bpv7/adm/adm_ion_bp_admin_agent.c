@@ -25,7 +25,7 @@
 #include "adm_ion_bp_admin_impl.h"
 #include "agent/rda.h"
 
-vec_idx_t g_dtn_ion_bpadmin_idx[11];
+reg_idx_t g_dtn_ion_bpadmin_idx[11];
 
 static void dtn_ion_bpadmin_init_meta(void);
 static void dtn_ion_bpadmin_init_cnst(void);
@@ -59,14 +59,18 @@ void dtn_ion_bpadmin_init()
 	dtn_ion_bpadmin_init_tblt();
 }
 
+static const adm_desc_t dtn_ion_bpadmin_meta_descs[] = {
+	ADM_DESC_CNST(ADM_META_IDX, DTN_ION_BPADMIN_META_NAME, dtn_ion_bpadmin_meta_name),
+	ADM_DESC_CNST(ADM_META_IDX, DTN_ION_BPADMIN_META_ENUM, dtn_ion_bpadmin_meta_enum),
+	ADM_DESC_CNST(ADM_META_IDX, DTN_ION_BPADMIN_META_NAMESPACE, dtn_ion_bpadmin_meta_namespace),
+	ADM_DESC_CNST(ADM_META_IDX, DTN_ION_BPADMIN_META_VERSION, dtn_ion_bpadmin_meta_version),
+	ADM_DESC_CNST(ADM_META_IDX, DTN_ION_BPADMIN_META_ORGANIZATION, dtn_ion_bpadmin_meta_organization),
+};
+
 void dtn_ion_bpadmin_init_meta()
 {
 
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_dtn_ion_bpadmin_idx[ADM_META_IDX], DTN_ION_BPADMIN_META_NAME), dtn_ion_bpadmin_meta_name);
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_dtn_ion_bpadmin_idx[ADM_META_IDX], DTN_ION_BPADMIN_META_ENUM), dtn_ion_bpadmin_meta_enum);
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_dtn_ion_bpadmin_idx[ADM_META_IDX], DTN_ION_BPADMIN_META_NAMESPACE), dtn_ion_bpadmin_meta_namespace);
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_dtn_ion_bpadmin_idx[ADM_META_IDX], DTN_ION_BPADMIN_META_VERSION), dtn_ion_bpadmin_meta_version);
-	adm_add_cnst(adm_build_ari(AMP_TYPE_CNST, 0, g_dtn_ion_bpadmin_idx[ADM_META_IDX], DTN_ION_BPADMIN_META_ORGANIZATION), dtn_ion_bpadmin_meta_organization);
+	adm_add_descs(g_dtn_ion_bpadmin_idx, dtn_ion_bpadmin_meta_descs, ADM_NUM_DESCS(dtn_ion_bpadmin_meta_descs));
 }
 
 void dtn_ion_bpadmin_init_cnst()
@@ -74,10 +78,14 @@ void dtn_ion_bpadmin_init_cnst()
 
 }
 
+static const adm_desc_t dtn_ion_bpadmin_edd_descs[] = {
+	ADM_DESC_EDD(ADM_EDD_IDX, DTN_ION_BPADMIN_EDD_BP_VERSION, 0, dtn_ion_bpadmin_get_bp_version),
+};
+
 void dtn_ion_bpadmin_init_edd()
 {
 
-	adm_add_edd(adm_build_ari(AMP_TYPE_EDD, 0, g_dtn_ion_bpadmin_idx[ADM_EDD_IDX], DTN_ION_BPADMIN_EDD_BP_VERSION), dtn_ion_bpadmin_get_bp_version);
+	adm_add_descs(g_dtn_ion_bpadmin_idx, dtn_ion_bpadmin_edd_descs, ADM_NUM_DESCS(dtn_ion_bpadmin_edd_descs));
 }
 
 void dtn_ion_bpadmin_init_op()
@@ -90,39 +98,43 @@ void dtn_ion_bpadmin_init_var()
 
 }
 
+static const adm_desc_t dtn_ion_bpadmin_ctrl_descs[] = {
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_BPADMIN_CTRL_ENDPOINT_ADD, 3, dtn_ion_bpadmin_ctrl_endpoint_add),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_BPADMIN_CTRL_ENDPOINT_CHANGE, 3, dtn_ion_bpadmin_ctrl_endpoint_change),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_BPADMIN_CTRL_ENDPOINT_DEL, 1, dtn_ion_bpadmin_ctrl_endpoint_del),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_BPADMIN_CTRL_INDUCT_ADD, 3, dtn_ion_bpadmin_ctrl_induct_add),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_BPADMIN_CTRL_INDUCT_CHANGE, 3, dtn_ion_bpadmin_ctrl_induct_change),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_BPADMIN_CTRL_INDUCT_DEL, 2, dtn_ion_bpadmin_ctrl_induct_del),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_BPADMIN_CTRL_INDUCT_START, 2, dtn_ion_bpadmin_ctrl_induct_start),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_BPADMIN_CTRL_INDUCT_STOP, 2, dtn_ion_bpadmin_ctrl_induct_stop),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_BPADMIN_CTRL_MANAGE_HEAP_MAX, 1, dtn_ion_bpadmin_ctrl_manage_heap_max),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_BPADMIN_CTRL_OUTDUCT_ADD, 4, dtn_ion_bpadmin_ctrl_outduct_add),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_BPADMIN_CTRL_OUTDUCT_CHANGE, 4, dtn_ion_bpadmin_ctrl_outduct_change),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_BPADMIN_CTRL_OUTDUCT_DEL, 2, dtn_ion_bpadmin_ctrl_outduct_del),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_BPADMIN_CTRL_OUTDUCT_START, 2, dtn_ion_bpadmin_ctrl_outduct_start),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_BPADMIN_CTRL_OUTDUCT_STOP, 2, dtn_ion_bpadmin_ctrl_outduct_stop),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_BPADMIN_CTRL_EGRESS_PLAN_ADD, 3, dtn_ion_bpadmin_ctrl_egress_plan_add),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_BPADMIN_CTRL_EGRESS_PLAN_DEL, 2, dtn_ion_bpadmin_ctrl_egress_plan_del),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_BPADMIN_CTRL_EGRESS_PLAN_START, 2, dtn_ion_bpadmin_ctrl_egress_plan_start),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_BPADMIN_CTRL_EGRESS_PLAN_STOP, 2, dtn_ion_bpadmin_ctrl_egress_plan_stop),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_BPADMIN_CTRL_EGRESS_PLAN_BLOCK, 1, dtn_ion_bpadmin_ctrl_egress_plan_block),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_BPADMIN_CTRL_EGRESS_PLAN_UNBLOCK, 1, dtn_ion_bpadmin_ctrl_egress_plan_unblock),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_BPADMIN_CTRL_PROTOCOL_ADD, 4, dtn_ion_bpadmin_ctrl_protocol_add),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_BPADMIN_CTRL_PROTOCOL_DEL, 1, dtn_ion_bpadmin_ctrl_protocol_del),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_BPADMIN_CTRL_PROTOCOL_START, 1, dtn_ion_bpadmin_ctrl_protocol_start),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_BPADMIN_CTRL_PROTOCOL_STOP, 1, dtn_ion_bpadmin_ctrl_protocol_stop),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_BPADMIN_CTRL_SCHEME_ADD, 3, dtn_ion_bpadmin_ctrl_scheme_add),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_BPADMIN_CTRL_SCHEME_CHANGE, 3, dtn_ion_bpadmin_ctrl_scheme_change),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_BPADMIN_CTRL_SCHEME_DEL, 1, dtn_ion_bpadmin_ctrl_scheme_del),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_BPADMIN_CTRL_SCHEME_START, 1, dtn_ion_bpadmin_ctrl_scheme_start),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_BPADMIN_CTRL_SCHEME_STOP, 1, dtn_ion_bpadmin_ctrl_scheme_stop),
+	ADM_DESC_CTRL(ADM_CTRL_IDX, DTN_ION_BPADMIN_CTRL_WATCH, 2, dtn_ion_bpadmin_ctrl_watch),
+};
+
 void dtn_ion_bpadmin_init_ctrl()
 {
 
-	adm_add_ctrldef(g_dtn_ion_bpadmin_idx[ADM_CTRL_IDX], DTN_ION_BPADMIN_CTRL_ENDPOINT_ADD, 3, dtn_ion_bpadmin_ctrl_endpoint_add);
-	adm_add_ctrldef(g_dtn_ion_bpadmin_idx[ADM_CTRL_IDX], DTN_ION_BPADMIN_CTRL_ENDPOINT_CHANGE, 3, dtn_ion_bpadmin_ctrl_endpoint_change);
-	adm_add_ctrldef(g_dtn_ion_bpadmin_idx[ADM_CTRL_IDX], DTN_ION_BPADMIN_CTRL_ENDPOINT_DEL, 1, dtn_ion_bpadmin_ctrl_endpoint_del);
-	adm_add_ctrldef(g_dtn_ion_bpadmin_idx[ADM_CTRL_IDX], DTN_ION_BPADMIN_CTRL_INDUCT_ADD, 3, dtn_ion_bpadmin_ctrl_induct_add);
-	adm_add_ctrldef(g_dtn_ion_bpadmin_idx[ADM_CTRL_IDX], DTN_ION_BPADMIN_CTRL_INDUCT_CHANGE, 3, dtn_ion_bpadmin_ctrl_induct_change);
-	adm_add_ctrldef(g_dtn_ion_bpadmin_idx[ADM_CTRL_IDX], DTN_ION_BPADMIN_CTRL_INDUCT_DEL, 2, dtn_ion_bpadmin_ctrl_induct_del);
-	adm_add_ctrldef(g_dtn_ion_bpadmin_idx[ADM_CTRL_IDX], DTN_ION_BPADMIN_CTRL_INDUCT_START, 2, dtn_ion_bpadmin_ctrl_induct_start);
-	adm_add_ctrldef(g_dtn_ion_bpadmin_idx[ADM_CTRL_IDX], DTN_ION_BPADMIN_CTRL_INDUCT_STOP, 2, dtn_ion_bpadmin_ctrl_induct_stop);
-	adm_add_ctrldef(g_dtn_ion_bpadmin_idx[ADM_CTRL_IDX], DTN_ION_BPADMIN_CTRL_MANAGE_HEAP_MAX, 1, dtn_ion_bpadmin_ctrl_manage_heap_max);
-	adm_add_ctrldef(g_dtn_ion_bpadmin_idx[ADM_CTRL_IDX], DTN_ION_BPADMIN_CTRL_OUTDUCT_ADD, 4, dtn_ion_bpadmin_ctrl_outduct_add);
-	adm_add_ctrldef(g_dtn_ion_bpadmin_idx[ADM_CTRL_IDX], DTN_ION_BPADMIN_CTRL_OUTDUCT_CHANGE, 4, dtn_ion_bpadmin_ctrl_outduct_change);
-	adm_add_ctrldef(g_dtn_ion_bpadmin_idx[ADM_CTRL_IDX], DTN_ION_BPADMIN_CTRL_OUTDUCT_DEL, 2, dtn_ion_bpadmin_ctrl_outduct_del);
-	adm_add_ctrldef(g_dtn_ion_bpadmin_idx[ADM_CTRL_IDX], DTN_ION_BPADMIN_CTRL_OUTDUCT_START, 2, dtn_ion_bpadmin_ctrl_outduct_start);
-	adm_add_ctrldef(g_dtn_ion_bpadmin_idx[ADM_CTRL_IDX], DTN_ION_BPADMIN_CTRL_OUTDUCT_STOP, 2, dtn_ion_bpadmin_ctrl_outduct_stop);
-	adm_add_ctrldef(g_dtn_ion_bpadmin_idx[ADM_CTRL_IDX], DTN_ION_BPADMIN_CTRL_EGRESS_PLAN_ADD, 3, dtn_ion_bpadmin_ctrl_egress_plan_add);
-	adm_add_ctrldef(g_dtn_ion_bpadmin_idx[ADM_CTRL_IDX], DTN_ION_BPADMIN_CTRL_EGRESS_PLAN_DEL, 2, dtn_ion_bpadmin_ctrl_egress_plan_del);
-	adm_add_ctrldef(g_dtn_ion_bpadmin_idx[ADM_CTRL_IDX], DTN_ION_BPADMIN_CTRL_EGRESS_PLAN_START, 2, dtn_ion_bpadmin_ctrl_egress_plan_start);
-	adm_add_ctrldef(g_dtn_ion_bpadmin_idx[ADM_CTRL_IDX], DTN_ION_BPADMIN_CTRL_EGRESS_PLAN_STOP, 2, dtn_ion_bpadmin_ctrl_egress_plan_stop);
-	adm_add_ctrldef(g_dtn_ion_bpadmin_idx[ADM_CTRL_IDX], DTN_ION_BPADMIN_CTRL_EGRESS_PLAN_BLOCK, 1, dtn_ion_bpadmin_ctrl_egress_plan_block);
-	adm_add_ctrldef(g_dtn_ion_bpadmin_idx[ADM_CTRL_IDX], DTN_ION_BPADMIN_CTRL_EGRESS_PLAN_UNBLOCK, 1, dtn_ion_bpadmin_ctrl_egress_plan_unblock);
-	adm_add_ctrldef(g_dtn_ion_bpadmin_idx[ADM_CTRL_IDX], DTN_ION_BPADMIN_CTRL_PROTOCOL_ADD, 4, dtn_ion_bpadmin_ctrl_protocol_add);
-	adm_add_ctrldef(g_dtn_ion_bpadmin_idx[ADM_CTRL_IDX], DTN_ION_BPADMIN_CTRL_PROTOCOL_DEL, 1, dtn_ion_bpadmin_ctrl_protocol_del);
-	adm_add_ctrldef(g_dtn_ion_bpadmin_idx[ADM_CTRL_IDX], DTN_ION_BPADMIN_CTRL_PROTOCOL_START, 1, dtn_ion_bpadmin_ctrl_protocol_start);
-	adm_add_ctrldef(g_dtn_ion_bpadmin_idx[ADM_CTRL_IDX], DTN_ION_BPADMIN_CTRL_PROTOCOL_STOP, 1, dtn_ion_bpadmin_ctrl_protocol_stop);
-	adm_add_ctrldef(g_dtn_ion_bpadmin_idx[ADM_CTRL_IDX], DTN_ION_BPADMIN_CTRL_SCHEME_ADD, 3, dtn_ion_bpadmin_ctrl_scheme_add);
-	adm_add_ctrldef(g_dtn_ion_bpadmin_idx[ADM_CTRL_IDX], DTN_ION_BPADMIN_CTRL_SCHEME_CHANGE, 3, dtn_ion_bpadmin_ctrl_scheme_change);
-	adm_add_ctrldef(g_dtn_ion_bpadmin_idx[ADM_CTRL_IDX], DTN_ION_BPADMIN_CTRL_SCHEME_DEL, 1, dtn_ion_bpadmin_ctrl_scheme_del);
-	adm_add_ctrldef(g_dtn_ion_bpadmin_idx[ADM_CTRL_IDX], DTN_ION_BPADMIN_CTRL_SCHEME_START, 1, dtn_ion_bpadmin_ctrl_scheme_start);
-	adm_add_ctrldef(g_dtn_ion_bpadmin_idx[ADM_CTRL_IDX], DTN_ION_BPADMIN_CTRL_SCHEME_STOP, 1, dtn_ion_bpadmin_ctrl_scheme_stop);
-	adm_add_ctrldef(g_dtn_ion_bpadmin_idx[ADM_CTRL_IDX], DTN_ION_BPADMIN_CTRL_WATCH, 2, dtn_ion_bpadmin_ctrl_watch);
+	adm_add_descs(g_dtn_ion_bpadmin_idx, dtn_ion_bpadmin_ctrl_descs, ADM_NUM_DESCS(dtn_ion_bpadmin_ctrl_descs));
 }
 
 void dtn_ion_bpadmin_init_mac()
@@ -123,7 +123,6 @@ tbl_t *dtn_ion_bpadmin_tblt_endpoints(ari_t *id)
 	char	recvRule;
 	char	recvScriptBuffer[SDRSTRING_BUFSZ];
 	char	*recvScript = recvScriptBuffer;
-	tnvc_t  *cur_row = NULL;
 
 	OBJ_POINTER(Endpoint, endpoint);
 	OBJ_POINTER(Scheme, scheme);
@@ -157,23 +156,14 @@ tbl_t *dtn_ion_bpadmin_tblt_endpoints(ari_t *id)
 
 			/* (STR) scheme_name, (STR) endpoint_nss, (UINT) app_pid, (STR) recv_rule, (STR) rcv_script */
 
-			if((cur_row = tnvc_create(5)) != NULL)
-			{
-				char tmp[2];
-				tmp[0] = recvRule;
-				tmp[1] = 0;
-				tnvc_insert(cur_row, tnv_from_str(scheme->name));
-				tnvc_insert(cur_row, tnv_from_str(endpoint->nss));
-				tnvc_insert(cur_row, tnv_from_uint(vpoint->appPid));
-				tnvc_insert(cur_row, tnv_from_str(tmp));
-				tnvc_insert(cur_row, tnv_from_str(recvScript));
-
-				tbl_add_row(table, cur_row);
-			}
-			else
-			{
-				AMP_DEBUG_WARN("dtn_ion_bpadmin_tblt_endpoints", "Can't allocate row. Skipping.", NULL);
-			}
+			char tmp[2];
+			tmp[0] = recvRule;
+			tmp[1] = 0;
+			tbl_append_str(table, scheme->name);
+			tbl_append_str(table, endpoint->nss);
+			tbl_append_uint(table, vpoint->appPid);
+			tbl_append_str(table, tmp);
+			tbl_append_str(table, recvScript);
 		}
 	}
 
@@ -215,7 +205,6 @@ tbl_t *dtn_ion_bpadmin_tblt_inducts(ari_t *id)
 	OBJ_POINTER(ClProtocol, clp);
 	char	cliCmdBuffer[SDRSTRING_BUFSZ];
 	char	*cliCmd;
-	tnvc_t  *cur_row = NULL;
 
 
 	CHKNULL(sdr_begin_xn(sdr));
@@ -243,18 +232,9 @@ tbl_t *dtn_ion_bpadmin_tblt_inducts(ari_t *id)
 				}
 
 				/* (STR) protocol_name, (STR) duct_name, (STR) cli_control */
-				if((cur_row = tnvc_create(3)) != NULL)
-				{
-					tnvc_insert(cur_row, tnv_from_str(clp->name));
-					tnvc_insert(cur_row, tnv_from_str(duct->name));
-					tnvc_insert(cur_row, tnv_from_str(cliCmd));
-
-					tbl_add_row(table, cur_row);
-				}
-				else
-				{
-					AMP_DEBUG_WARN("dtn_ion_bpadmin_tblt_inducts", "Can't allocate row. Skipping.", NULL);
-				}
+				tbl_append_str(table, clp->name);
+				tbl_append_str(table, duct->name);
+				tbl_append_str(table, cliCmd);
 
 			}
 		}
@@ -298,7 +278,6 @@ tbl_t *dtn_ion_bpadmin_tblt_outducts(ari_t *id)
 	OBJ_POINTER(ClProtocol, clp);
 	char	cloCmdBuffer[SDRSTRING_BUFSZ];
 	char	*cloCmd;
-	tnvc_t  *cur_row = NULL;
 
 
 	CHKNULL(sdr_begin_xn(sdr));
@@ -331,20 +310,11 @@ tbl_t *dtn_ion_bpadmin_tblt_outducts(ari_t *id)
 				}
 
 				/* (STR) protocol_name, (STR) duct_name, (UINT) clo_pid, (STR) clo_control, (STR) max_ayload_len */
-				if((cur_row = tnvc_create(5)) != NULL)
-				{
-					tnvc_insert(cur_row, tnv_from_str(clp->name));
-					tnvc_insert(cur_row, tnv_from_str(duct->name));
-					tnvc_insert(cur_row, tnv_from_uint(vduct->cloPid));
-					tnvc_insert(cur_row, tnv_from_str(cloCmd));
-					tnvc_insert(cur_row, tnv_from_uint(duct->maxPayloadLen));
-
-					tbl_add_row(table, cur_row);
-				}
-				else
-				{
-					AMP_DEBUG_WARN("dtn_ion_bpadmin_tblt_outducts", "Can't allocate row. Skipping.", NULL);
-				}
+				tbl_append_str(table, clp->name);
+				tbl_append_str(table, duct->name);
+				tbl_append_uint(table, vduct->cloPid);
+				tbl_append_str(table, cloCmd);
+				tbl_append_uint(table, duct->maxPayloadLen);
 
 			}
 		}
@@ -381,7 +351,6 @@ tbl_t *dtn_ion_bpadmin_tblt_protocols(ari_t *id)
 	Sdr	sdr = getIonsdr();
 	Object	elt;
 	OBJ_POINTER(ClProtocol, clp);
-	tnvc_t  *cur_row = NULL;
 
 	CHKNULL(sdr_begin_xn(sdr));
 	for (elt = sdr_list_first(sdr, (getBpConstants())->protocols); elt;
@@ -390,17 +359,8 @@ tbl_t *dtn_ion_bpadmin_tblt_protocols(ari_t *id)
 		GET_OBJ_POINTER(sdr, ClProtocol, clp, sdr_list_data(sdr, elt));
 
 		/* (STR) name, (UINT) protocol_class */
-		if((cur_row = tnvc_create(2)) != NULL)
-		{
-			tnvc_insert(cur_row, tnv_from_str(clp->name));
-			tnvc_insert(cur_row, tnv_from_uint(clp->protocolClass));
-
-			tbl_add_row(table, cur_row);
-		}
-		else
-		{
-			AMP_DEBUG_WARN("dtn_ion_bpadmin_tblt_protocols", "Can't allocate row. Skipping.", NULL);
-		}
+		tbl_append_str(table, clp->name);
+		tbl_append_uint(table, clp->protocolClass);
 	}
 
 	sdr_exit_xn(sdr);
@@ -441,7 +401,6 @@ tbl_t *dtn_ion_bpadmin_tblt_schemes(ari_t *id)
 	char	*fwdCmd;
 	char	admAppCmdBuffer[SDRSTRING_BUFSZ];
 	char	*admAppCmd;
-	tnvc_t  *cur_row = NULL;
 
 	CHKNULL(sdr_begin_xn(sdr));
 	for (elt = sm_list_first(ionwm, (getBpVdb())->schemes); elt;
@@ -469,20 +428,11 @@ tbl_t *dtn_ion_bpadmin_tblt_schemes(ari_t *id)
 		}
 
 		/* (STR) name, (UINT) fwd_pid, (STR) fwd_cmd, (UINT) admin_app_pid (STR) admin_app_cmd */
-		if((cur_row = tnvc_create(5)) != NULL)
-		{
-			tnvc_insert(cur_row, tnv_from_str(scheme->name));
-			tnvc_insert(cur_row, tnv_from_uint(vscheme->fwdPid));
-			tnvc_insert(cur_row, tnv_from_str(fwdCmd));
-			tnvc_insert(cur_row, tnv_from_uint(vscheme->admAppPid));
-			tnvc_insert(cur_row, tnv_from_str(admAppCmd));
-
-			tbl_add_row(table, cur_row);
-		}
-		else
-		{
-			AMP_DEBUG_WARN("dtn_ion_bpadmin_tblt_schemess", "Can't allocate row. Skipping.", NULL);
-		}
+		tbl_append_str(table, scheme->name);
+		tbl_append_uint(table, vscheme->fwdPid);
+		tbl_append_str(table, fwdCmd);
+		tbl_append_uint(table, vscheme->admAppPid);
+		tbl_append_str(table, admAppCmd);
 	}
 
 	sdr_exit_xn(sdr);
@@ -518,7 +468,6 @@ tbl_t *dtn_ion_bpadmin_tblt_egress_plans(ari_t *id)
 	PsmAddress	elt;
 	VPlan		*vplan;
 	OBJ_POINTER(BpPlan, plan);
-	tnvc_t  *cur_row = NULL;
 
 
 	CHKNULL(sdr_begin_xn(sdr));
@@ -529,18 +478,9 @@ tbl_t *dtn_ion_bpadmin_tblt_egress_plans(ari_t *id)
 		GET_OBJ_POINTER(sdr, BpPlan, plan, sdr_list_data(sdr, vplan->planElt));
 
 		/* (STR) neighbor EID, (UINT) clm_pid, (UINT) nominal rate*/
-		if((cur_row = tnvc_create(3)) != NULL)
-		{
-			tnvc_insert(cur_row, tnv_from_str(plan->neighborEid));
-			tnvc_insert(cur_row, tnv_from_uint(vplan->clmPid));
-			tnvc_insert(cur_row, tnv_from_uint(plan->nominalRate));
-
-			tbl_add_row(table, cur_row);
-		}
-		else
-		{
-			AMP_DEBUG_WARN("dtn_ion_bpadmin_tblt_egress_plans", "Can't allocate row. Skipping.", NULL);
-		}
+		tbl_append_str(table, plan->neighborEid);
+		tbl_append_uint(table, vplan->clmPid);
+		tbl_append_uint(table, plan->nominalRate);
 	}
 
 	sdr_exit_xn(sdr);
@@ -30,7 +30,7 @@
 
 #define _HAVE_AMP_AGENT_ADM_
 #ifdef _HAVE_AMP_AGENT_ADM_
-//vec_idx_t g_amp_agent_idx[11];
+//reg_idx_t g_amp_agent_idx[11];
 
 void amp_agent_init()
 {
@@ -152,6 +152,34 @@ void amp_agent_init_edd()
 	adm_add_edd(id, NULL);
 	meta_add_edd(AMP_TYPE_TV, id, ADM_ENUM_AMP_AGENT, "cur_time", "This is the current system time.");
 
+	id = adm_build_ari(AMP_TYPE_EDD, 0, g_amp_agent_idx[ADM_EDD_IDX], AMP_AGENT_EDD_QUEUED_MSGS);
+	adm_add_edd(id, NULL);
+	meta_add_edd(AMP_TYPE_UINT, id, ADM_ENUM_AMP_AGENT, "queued_msgs", "This is the number of messages held by the agent until they can be sent.");
+
+	id = adm_build_ari(AMP_TYPE_EDD, 0, g_amp_agent_idx[ADM_EDD_IDX], AMP_AGENT_EDD_QUEUED_BYTES);
+	adm_add_edd(id, NULL);
+	meta_add_edd(AMP_TYPE_UVAST, id, ADM_ENUM_AMP_AGENT, "queued_bytes", "This is the size in bytes of the messages held by the agent until they can be sent.");
+
+	id = adm_build_ari(AMP_TYPE_EDD, 0, g_amp_agent_idx[ADM_EDD_IDX], AMP_AGENT_EDD_RULE_LAG_P99);
+	adm_add_edd(id, NULL);
+	meta_add_edd(AMP_TYPE_UVAST, id, ADM_ENUM_AMP_AGENT, "rule_lag_p99", "This is the 99th percentile, in microseconds, of how late rules run after they are due.");
+
+	id = adm_build_ari(AMP_TYPE_EDD, 0, g_amp_agent_idx[ADM_EDD_IDX], AMP_AGENT_EDD_EDD_COLLECT_P99);
+	adm_add_edd(id, NULL);
+	meta_add_edd(AMP_TYPE_UVAST, id, ADM_ENUM_AMP_AGENT, "edd_collect_p99", "This is the 99th percentile, in microseconds, of the time to collect one EDD value.");
+
+	id = adm_build_ari(AMP_TYPE_EDD, 0, g_amp_agent_idx[ADM_EDD_IDX], AMP_AGENT_EDD_CTRL_RUN_P99);
+	adm_add_edd(id, NULL);
+	meta_add_edd(AMP_TYPE_UVAST, id, ADM_ENUM_AMP_AGENT, "ctrl_run_p99", "This is the 99th percentile, in microseconds, of the time to run one control.");
+
+	id = adm_build_ari(AMP_TYPE_EDD, 0, g_amp_agent_idx[ADM_EDD_IDX], AMP_AGENT_EDD_RPT_QUEUE_P99);
+	adm_add_edd(id, NULL);
+	meta_add_edd(AMP_TYPE_UVAST, id, ADM_ENUM_AMP_AGENT, "rpt_queue_p99", "This is the 99th percentile, in microseconds, of the time from building a report message to sending it.");
+
+	id = adm_build_ari(AMP_TYPE_EDD, 0, g_amp_agent_idx[ADM_EDD_IDX], AMP_AGENT_EDD_RPT_SEND_P99);
+	adm_add_edd(id, NULL);
+	meta_add_edd(AMP_TYPE_UVAST, id, ADM_ENUM_AMP_AGENT, "rpt_send_p99", "This is the 99th percentile, in microseconds, of the time to encode and send one report message.");
+
 }
 
 void amp_agent_init_op()
@@ -704,6 +732,15 @@ void amp_agent_init_ctrl()
 	adm_add_ctrldef_ari(id, 0, NULL);
 	meta_add_ctrl(id, ADM_ENUM_AMP_AGENT, "reset_counts", "This control resets all Agent ADM statistics reported in the Agent ADM report.");
 
+	/* SET_CLASS */
+
+	id = adm_build_ari(AMP_TYPE_CTRL, 1, g_amp_agent_idx[ADM_CTRL_IDX], AMP_AGENT_CTRL_SET_CLASS);
+	adm_add_ctrldef_ari(id, 2, NULL);
+	meta = meta_add_ctrl(id, ADM_ENUM_AMP_AGENT, "set_class", "This control sets the priority class, from 0 (urgent) to 3 (bulk), of reports and tables produced by each identified rule or control.");
+
+	meta_add_parm(meta, "ids", AMP_TYPE_AC);
+	meta_add_parm(meta, "class", AMP_TYPE_UINT);
+
 }
 
 void amp_agent_init_mac()
@@ -784,6 +821,40 @@ void amp_agent_init_tblt()
 	tblt_add_col(def, AMP_TYPE_ARI, "ids");
 	adm_add_tblt(def);
 	meta_add_tblt(def->id, ADM_ENUM_AMP_AGENT, "tblts", "This table lists the ARI for every table template that is known to the agent.");
+
+	/* REPORT_CLASSES */
+
+	def = tblt_create(adm_build_ari(AMP_TYPE_TBLT, 0, g_amp_agent_idx[ADM_TBLT_IDX], AMP_AGENT_TBLT_REPORT_CLASSES), NULL);
+	tblt_add_col(def, AMP_TYPE_UINT, "class");
+	tblt_add_col(def, AMP_TYPE_UINT, "held");
+	tblt_add_col(def, AMP_TYPE_UVAST, "sent");
+	tblt_add_col(def, AMP_TYPE_UVAST, "mean_delay_ms");
+	tblt_add_col(def, AMP_TYPE_UINT, "max_delay_ms");
+	adm_add_tblt(def);
+	meta_add_tblt(def->id, ADM_ENUM_AMP_AGENT, "report_classes", "This table lists, for each report priority class, the messages held and sent and their queueing delay.");
+
+	/* LATENCIES */
+
+	def = tblt_create(adm_build_ari(AMP_TYPE_TBLT, 0, g_amp_agent_idx[ADM_TBLT_IDX], AMP_AGENT_TBLT_LATENCIES), NULL);
+	tblt_add_col(def, AMP_TYPE_STR, "name");
+	tblt_add_col(def, AMP_TYPE_UVAST, "count");
+	tblt_add_col(def, AMP_TYPE_UVAST, "mean_us");
+	tblt_add_col(def, AMP_TYPE_UVAST, "p50_us");
+	tblt_add_col(def, AMP_TYPE_UVAST, "p90_us");
+	tblt_add_col(def, AMP_TYPE_UVAST, "p99_us");
+	tblt_add_col(def, AMP_TYPE_UVAST, "max_us");
+	adm_add_tblt(def);
+	meta_add_tblt(def->id, ADM_ENUM_AMP_AGENT, "latencies", "This table lists, for each timed agent activity, the number of times and percentiles of its duration in microseconds.");
+
+	/* EDD_TIMES */
+
+	def = tblt_create(adm_build_ari(AMP_TYPE_TBLT, 0, g_amp_agent_idx[ADM_TBLT_IDX], AMP_AGENT_TBLT_EDD_TIMES), NULL);
+	tblt_add_col(def, AMP_TYPE_ARI, "id");
+	tblt_add_col(def, AMP_TYPE_UVAST, "count");
+	tblt_add_col(def, AMP_TYPE_UVAST, "mean_us");
+	tblt_add_col(def, AMP_TYPE_UVAST, "max_us");
+	adm_add_tblt(def);
+	meta_add_tblt(def->id, ADM_ENUM_AMP_AGENT, "edd_times", "This table lists, for each EDD collected by the agent, the number of times and its collect time in microseconds.");
 }
 
 #endif // _HAVE_AMP_AGENT_ADM_
@@ -30,7 +30,7 @@
 
 #define _HAVE_DTN_ION_IONADMIN_ADM_
 #ifdef _HAVE_DTN_ION_IONADMIN_ADM_
-static vec_idx_t g_dtn_ion_ionadmin_idx[11];
+static reg_idx_t g_dtn_ion_ionadmin_idx[11];
 
 void dtn_ion_ionadmin_init()
 {
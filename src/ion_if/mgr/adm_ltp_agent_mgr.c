@@ -30,7 +30,7 @@
 
 #define _HAVE_DTN_LTP_AGENT_ADM_
 #ifdef _HAVE_DTN_LTP_AGENT_ADM_
-static vec_idx_t g_dtn_ltp_agent_idx[11];
+static reg_idx_t g_dtn_ltp_agent_idx[11];
 
 void dtn_ltp_agent_init()
 {
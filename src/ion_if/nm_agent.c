@@ -16,6 +16,7 @@
  * limitations under the License.
  */
 #include <signal.h>
+#include <unistd.h>
 #include <osapi-common.h>
 #include <osapi-bsp.h>
 #include <osapi-error.h>
@@ -24,6 +25,7 @@
 #include "shared/adm/adm.h"
 #include "shared/primitives/blob.h"
 #include "agent/instr.h"
+#include "agent/ldc.h"
 #include "agent/nmagent.h"
 #include "ion_if.h"
 
@@ -45,6 +47,8 @@ static nmagent_t agent;
 static iif_t ion_ptr;
 static eid_t manager_eid;
 static eid_t agent_eid;
+static char *db_path = NULL;
+static outq_cfg_t outq_cfg;
 
 static void
 daemon_signal_handler(int signum)
@@ -63,11 +67,55 @@ OS_Application_Startup()
   }
 
   /* Step 1: Process Command Line Arguments. */
-  const int argc = OS_BSP_GetArgC();
+  int argc = OS_BSP_GetArgC();
   char *const *argv = OS_BSP_GetArgV();
+  int c;
+  while ((c = getopt(argc, argv, "j:q:Q:pzr:b:s:")) != -1)
+  {
+    switch (c)
+    {
+      case 'j':
+        db_path = optarg;
+        break;
+      case 'q':
+        outq_cfg.path = optarg;
+        break;
+      case 'Q':
+        outq_cfg.max_bytes = strtoul(optarg, NULL, 10) * 1024;
+        break;
+      case 'p':
+        outq_cfg.by_priority = true;
+        break;
+      case 'z':
+        outq_cfg.compress = true;
+        break;
+      case 'r':
+        outq_cfg.rate = strtoul(optarg, NULL, 10) * 1024;
+        break;
+      case 'b':
+        outq_cfg.burst = strtoul(optarg, NULL, 10) * 1024;
+        break;
+      case 's':
+        ldc_set_snap_max_age(strtoul(optarg, NULL, 10));
+        break;
+      default:
+        argc = 0;
+        break;
+    }
+  }
+  argc -= optind - 1;
+  argv += optind - 1;
   if (argc != 3)
   {
-    printf("Usage: nmagent <agent eid> <manager eid>\n");
+    printf("Usage: nmagent [-j <db path>] [-q <spill path>] [-Q <KiB>] [-p] [-z] [-r <KiB/s>] [-b <KiB>] [-s <ms>] <agent eid> <manager eid>\n");
+    printf("  -j  Persist definitions to <db path>.jnl/.snap and restore them\n");
+    printf("  -q  Hold unsent reports in <spill path> across restarts\n");
+    printf("  -Q  Hold at most this many KiB of unsent reports\n");
+    printf("  -p  Send held reports by priority rather than oldest first\n");
+    printf("  -z  Compress held reports\n");
+    printf("  -r  Send at most this many KiB/s to each manager, except urgent reports\n");
+    printf("  -b  Allow bursts of this many KiB above the -r rate\n");
+    printf("  -s  Reuse ION state read for a report for up to this many ms\n");
     printf("AMP Protocol Version %d - %s, built on %s %s\n", AMP_VERSION,
            AMP_PROTOCOL_URL, __DATE__, __TIME__);
     OS_ApplicationExit(0);
@@ -119,6 +167,7 @@ OS_Application_Startup()
   }
   agent.mif.send = msg_bp_send;
   agent.mif.receive = msg_bp_recv;
+  agent.outq = outq_cfg;
   agent.mif.ctx = &ion_ptr;
 
   /* Step 3: Initialize objects and instrumentation. */
@@ -139,6 +188,11 @@ OS_Application_Startup()
 //  dtn_bpsec_init();
 #endif
 
+  if (db_path && !nmagent_restore(&agent, db_path))
+  {
+    OS_ApplicationExit(EXIT_FAILURE);
+  }
+
   /* Step 4: Register signal handlers. */
   struct sigaction act;
   memset(&act, 0, sizeof(struct sigaction));
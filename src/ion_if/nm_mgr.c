@@ -25,6 +25,7 @@
 #include "shared/adm/adm.h"
 #include "shared/primitives/blob.h"
 #include "mgr/agents.h"
+#include "mgr/nm_mgr_log.h"
 #include "mgr/nmmgr.h"
 #include "ion_if.h"
 
@@ -34,6 +35,8 @@ static void mgr_print_usage(void);
 
 static iif_t ion_ptr;
 static nmmgr_t mgr;
+/// Receive workers, kept until the manager is initialized
+static size_t rx_workers = 0;
 
 static void
 daemon_signal_handler(int signum)
@@ -117,6 +120,7 @@ OS_Application_Startup()
       AMP_DEBUG_ERR("main","Can't init Manager.", NULL);
       OS_ApplicationExit(EXIT_FAILURE);
   }
+  mgr.rx_workers = rx_workers;
 
 
   
@@ -180,10 +184,13 @@ char* mgr_parse_args(int argc, char *const argv[])
 
             {"log-dir", required_argument, 0,'D'},
             {"log-limit", required_argument, 0,'L'},
+            {"log-flush-ms", required_argument, 0,'F'},
+            {"log-compress", no_argument, 0,'z'},
             {"automator", required_argument, 0,'a'},
+            {"rx-workers", required_argument, 0,'w'},
             {"help", required_argument, 0,'h'},
         };
-    while ((c = getopt_long(argc, argv, "ldL:D:rtTRaAjJs:u:p:S:", long_options, &option_index)) != -1)
+    while ((c = getopt_long(argc, argv, "ldL:D:F:zrtTRaAjJs:u:p:S:w:", long_options, &option_index)) != -1)
     {
         switch(c)
         {
@@ -234,6 +241,20 @@ char* mgr_parse_args(int argc, char *const argv[])
         case 'L':
             agent_log_cfg.limit = atoi(optarg);
             break;
+        case 'F':
+            agent_log_cfg.flush_ms = atoi(optarg);
+            break;
+        case 'z':
+            agent_log_cfg.compress = 1;
+            break;
+        case 'w':
+            rx_workers = strtoul(optarg, NULL, 10);
+            if ((rx_workers == 0) || (rx_workers > MGR_RX_MAX_WORKERS))
+            {
+                fprintf(stderr, "Receive workers must be 1 to %d\n", MGR_RX_MAX_WORKERS);
+                return NULL;
+            }
+            break;
         case 'a':
         case 'A':
             mgr.mgr_ui_mode = MGR_UI_AUTOMATOR;
@@ -279,10 +300,13 @@ void mgr_print_usage(void)
     printf("-d       Log each agent to a different directory\n");
     printf("-L #      Specify maximum number of entries (reports+tables) per file before rotating\n");
     printf("-D DIR   NM logs will be placed in this directory\n");
+    printf("-F #     Flush buffered log files at most every # milliseconds (default %d)\n", MGR_LOG_DEF_FLUSH_MS);
+    printf("-z       Compress log files after rotation (requires zlib)\n");
     printf("-r       Log all received reports to file in text format (as shown in UI)\n");
     printf("-t       Log all received tables to file in text format (as shown in UI)\n");
     printf("-T       Log all transmitted message as ASCII-encoded CBOR HEX strings\n");
     printf("-R       Log all received messages as ASCII-encoded CBOR HEX strings\n");
+    printf("-w #     Process received messages on 1 to %d threads, sharded by agent (default in the receive thread)\n", MGR_RX_MAX_WORKERS);
 #if defined(HAVE_MYSQL) || defined(HAVE_POSTGRESQL)
     printf("--sql-user MySQL Username\n");
     printf("--sql-pass MySQL Password\n");
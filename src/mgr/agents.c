@@ -42,6 +42,7 @@
 
 #include "../shared/utils/debug.h"
 #include "nmmgr.h"
+#include "nm_mgr_log.h"
 
 agent_autologging_cfg_t agent_log_cfg = {
  // Defaults (nominal, disabled on startup)
@@ -56,6 +57,8 @@ agent_autologging_cfg_t agent_log_cfg = {
 #endif
 	50, // Number of reports per file before rotation
 	0, // Create discrete sub-folders per agent
+	MGR_LOG_DEF_FLUSH_MS, // Flush buffered log output at least this often
+	0, // Compress rotated log files
 	"." // root log directory will be the working directory mgr started from as default
 };
 
@@ -90,34 +93,53 @@ int agent_add(eid_t id)
 	printf("agent_add(%s)\n", id.name);
 
 
-	/* Check if the agent is already known. */
+	/* Check if the agent is already known. The check and insert are one
+	 * step, as agents may register through several receive workers.
+	 */
+	vec_lock(&(gMgrDB.agents));
 	if((agent = agent_get(&id)) != NULL)
 	{
+		vec_unlock(&(gMgrDB.agents));
 		AMP_DEBUG_WARN("agent_add","Agent already added: %s", id.name);
 		return AMP_OK;
 	}
 
 	if((agent = agent_create(&id)) == NULL)
 	{
+		vec_unlock(&(gMgrDB.agents));
 		AMP_DEBUG_ERR("agent_add","Can't create new agent.", NULL);
 		return AMP_SYSERR;
 	}
 
 	if((vec_insert(&(gMgrDB.agents), agent, &(agent->idx))) != VEC_OK)
 	{
+		vec_unlock(&(gMgrDB.agents));
 		AMP_DEBUG_ERR("agent_add", "Can't insert new agent.", NULL);
 		agent_release(agent, 1);
 		return AMP_FAIL;
 	}
-
-	agent_rotate_log(agent, 1);
+	/* Queued while the list still holds its reference. */
+	mgr_log_rotate(agent, 1);
+	vec_unlock(&(gMgrDB.agents));
 	
 	return AMP_OK;
 }
 
+static void agent_close_log(agent_t *agent)
+{
+	fclose(agent->log_fd);
+	agent->log_fd = NULL;
+	agent->log_dirty = 0;
+
+	if (agent_log_cfg.compress)
+	{
+		mgr_log_compress_later(agent->log_fn);
+	}
+}
+
 void agent_rotate_log(agent_t *agent, int force)
 {
-	char fn[128];
+	char *fn = agent->log_fn;
 	char agent_autologging_sep = '_';
 	if (agent_log_cfg.enabled)
 	{
@@ -128,7 +150,7 @@ void agent_rotate_log(agent_t *agent, int force)
 					agent_log_cfg.limit > 0 && agent->log_fd_cnt > agent_log_cfg.limit)
 				)
 			{
-				fclose(agent->log_fd);
+				agent_close_log(agent);
 			}
 			else
 			{
@@ -140,7 +162,7 @@ void agent_rotate_log(agent_t *agent, int force)
 			agent_autologging_sep = '/';
 
 			if (agent->log_fd_cnt == 0) {
-				sprintf(fn, "%s/%s",
+				snprintf(fn, sizeof(agent->log_fn), "%s/%s",
 						agent_log_cfg.dir,
 						agent->eid.name
 					);
@@ -151,7 +173,7 @@ void agent_rotate_log(agent_t *agent, int force)
 #endif
 			}
 		}
-		sprintf(fn, "%s/%s%c%d.log",
+		snprintf(fn, sizeof(agent->log_fn), "%s/%s%c%d.log",
 				agent_log_cfg.dir,
 				agent->eid.name,
 				agent_autologging_sep, // Set to "/" to use seperate directories per agent
@@ -160,6 +182,15 @@ void agent_rotate_log(agent_t *agent, int force)
 
 		agent->log_fd = fopen(fn, "a");
 		if (agent->log_fd != NULL) {
+			// Large buffer, flushed on a timer by the log writer
+			if (agent->log_buf == NULL)
+			{
+				agent->log_buf = STAKE(MGR_LOG_FILE_BUFSIZE);
+			}
+			if (agent->log_buf != NULL)
+			{
+				setvbuf(agent->log_fd, agent->log_buf, _IOFBF, MGR_LOG_FILE_BUFSIZE);
+			}
 			agent->log_fd_cnt = 0;
 			agent->log_file_num++;
 		} else {
@@ -168,8 +199,7 @@ void agent_rotate_log(agent_t *agent, int force)
 	}
 	else if (agent->log_fd != NULL)
 	{
-		fclose(agent->log_fd);
-		agent->log_fd = NULL;
+		agent_close_log(agent);
 	}
 }
 
@@ -188,22 +218,22 @@ int agent_cb_comp(void *key, void *cur_val)
 }
 
 
-void agent_cb_del(void *item)
+static void agent_tbl_base_cb_del(void *item)
 {
-	agent_t *agent = (agent_t *) item;
+	agent_tbl_base_t *base = (agent_tbl_base_t *) item;
+
+	CHKVOID(base);
+	tbl_release(base->tbl, 1);
+	SRELEASE(base);
+}
 
-	CHKVOID(agent);
-	
-	vec_release(&(agent->rpts), 0);
-	vec_release(&(agent->tbls), 0);
-	
-	if (agent->log_fd != NULL)
-	{
-		fclose(agent->log_fd);
-	}
-	
 
-	SRELEASE(item);
+/* Drops the reference held by gMgrDB.agents. The log writer or a receive
+ * worker may still hold the agent, in which case the last of them frees it.
+ */
+void agent_cb_del(void *item)
+{
+	agent_put((agent_t *) item);
 }
 
 
@@ -244,6 +274,7 @@ agent_t* agent_create(eid_t *eid)
 	}
 
 	strncpy(agent->eid.name, eid->name, AMP_MAX_EID_LEN);
+	atomic_init(&(agent->refs), 1);
 
 	agent->rpts = vec_create(AGENT_DEF_NUM_RPTS, rpt_cb_del_fn, rpt_cb_comp_fn, NULL, VEC_FLAG_AS_STACK, &success);
 	if(success != VEC_OK)
@@ -257,6 +288,17 @@ agent_t* agent_create(eid_t *eid)
 	if(success != VEC_OK)
 	{
 		AMP_DEBUG_ERR("agent_create","Can'tmake agent tables vector.", NULL);
+		vec_release(&(agent->rpts), 0);
+		SRELEASE(agent);
+		return NULL;
+	}
+
+	agent->tbl_bases = vec_create(AGENT_DEF_NUM_TBLS, agent_tbl_base_cb_del, NULL, NULL, 0, &success);
+	if(success != VEC_OK)
+	{
+		AMP_DEBUG_ERR("agent_create","Can't make agent table bases vector.", NULL);
+		vec_release(&(agent->rpts), 0);
+		vec_release(&(agent->tbls), 0);
 		SRELEASE(agent);
 		agent = NULL;
 	}
@@ -305,6 +347,52 @@ agent_t* agent_get(eid_t* eid)
 
 
 
+/******************************************************************************
+ *
+ * \par Function Name: agent_acquire
+ *
+ * \par Retrieve an agent and take a reference to it, so that it stays valid
+ *      after being removed from the list of known agents.
+ *
+ * \param[in]  eid  - The endpoint identifier for the agent.
+ *
+ * \return NULL - Error
+ *        !NULL - The retrieved agent, to be given back with agent_put().
+ *****************************************************************************/
+agent_t* agent_acquire(eid_t* eid)
+{
+	agent_t *result = NULL;
+
+	CHKNULL(eid);
+
+	vec_lock(&(gMgrDB.agents));
+	if((result = agent_get(eid)) != NULL)
+	{
+		agent_hold(result);
+	}
+	vec_unlock(&(gMgrDB.agents));
+	return result;
+}
+
+/* Take another reference to an agent which the caller already holds. */
+void agent_hold(agent_t *agent)
+{
+	CHKVOID(agent);
+	atomic_fetch_add(&(agent->refs), 1);
+}
+
+/* Give back a reference, freeing the agent with the last one. */
+void agent_put(agent_t *agent)
+{
+	CHKVOID(agent);
+	if(atomic_fetch_sub(&(agent->refs), 1) == 1)
+	{
+		agent_release(agent, 1);
+	}
+}
+
+
+
 /******************************************************************************
  *
  * \par Function Name: agent_release
@@ -328,10 +416,13 @@ void agent_release(agent_t *agent, int destroy)
 	CHKVOID(agent);
 
 	vec_release(&(agent->rpts), 0);
+	vec_release(&(agent->tbls), 0);
+	vec_release(&(agent->tbl_bases), 0);
 	if (agent->log_fd != NULL)
 	{
 		fclose(agent->log_fd);
 	}
+	SRELEASE(agent->log_buf);
 
 	if(destroy)
 	{
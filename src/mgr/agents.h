@@ -38,6 +38,7 @@
 #define AGENTS_H
 
 // Standard includes
+#include <stdatomic.h>
 
 // ION includes
 #include "shared/platform.h"
@@ -45,6 +46,7 @@
 #include "../shared/utils/utils.h"
 
 #include "../shared/utils/vector.h"
+#include "../shared/primitives/table.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -55,6 +57,12 @@ extern "C" {
 #define AGENT_DEF_NUM_RPTS (8)
 #define AGENT_DEF_NUM_TBLS (8)
 
+/** The last table rebuilt from an agent's incremental table template. */
+typedef struct {
+	tbl_t *tbl;
+	uint32_t seq;
+} agent_tbl_base_t;
+
 /**
  * Data structure representing a managed remote agent.
  **/
@@ -63,10 +71,19 @@ typedef struct {
 	vec_idx_t idx;
 	vector_t rpts;
 	vector_t tbls;
+	vector_t tbl_bases; /**> What table deltas apply to (agent_tbl_base_t *) */
+	atomic_uint_fast64_t rx_rpts; /**> Reports received, for metrics (nm_mgr_metrics.h) */
+	atomic_uint_fast64_t rx_tbls; /**> Tables received, for metrics */
+	atomic_int refs; /**> References held, including the one by gMgrDB.agents */
 	
+	/* Log file state is owned by the log writer thread (nm_mgr_log.h), and
+	 * is closed by whichever thread drops the last reference. */
 	FILE *log_fd;
 	int log_fd_cnt;
 	int log_file_num;
+	int log_dirty; // Data written since the last flush
+	char log_fn[128]; // Name of the currently open log file
+	char *log_buf; // stdio buffer for log_fd
 } agent_t;
 
 /**
@@ -84,6 +101,8 @@ typedef struct {
 #endif
 	int limit; // Number of entries (reports+tables) per file
 	int agent_dirs; // If true, create discrete directories for each agent
+	int flush_ms; // Maximum time buffered log output is held before being flushed to disk
+	int compress; // If true, gzip each log file once it has been rotated out
 	char dir[32]; // directory to save report logs to (or place sub-directories in)
 	
 } agent_autologging_cfg_t;
@@ -94,10 +113,13 @@ int      agent_cb_comp(void *i1, void *i2);
 void     agent_cb_del(void *item);
 agent_t* agent_create(eid_t *eid);
 agent_t* agent_get(eid_t* eid);
+agent_t* agent_acquire(eid_t* eid);
+void     agent_hold(agent_t *agent);
+void     agent_put(agent_t *agent);
 void     agent_release(agent_t *agent, int destroy);
 
 
-// File Logging function utilities
+// File Logging function utilities, used only by the log writer thread
 void     agent_rotate_log(agent_t *agent, int force);
 
 
@@ -0,0 +1,1382 @@
+/*
+ * Copyright (c) 2023 The Johns Hopkins University Applied Physics
+ * Laboratory LLC.
+ *
+ * This file is part of the Delay-Tolerant Networking Management
+ * Architecture (DTNMA) Tools package.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+
+#ifdef USE_CIVETWEB
+#include <civetweb.h>
+#endif
+
+#include "shared/platform.h"
+#include "../shared/utils/utils.h"
+#include "../shared/primitives/blob.h"
+#include "nm_mgr_fmt.h"
+#include "nmmgr.h"
+
+/** A cached name of an interned ARI identity.
+ */
+typedef struct {
+  const ari_ident_t *ident;
+  /// The metadata of the identity, or NULL if there is none
+  metadata_t *meta;
+  /// Without metadata, the hex encoding of the ARI without parameters
+  char *anon;
+} mgr_fmt_name_t;
+
+static mgr_fmt_name_t name_cache[MGR_FMT_NAME_CACHE_SIZE];
+static pthread_mutex_t name_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static const char hex_digits[] = "0123456789abcdef";
+
+/* Hands buffered output to the sink. */
+static void mgr_fmt_flush(mgr_fmt_t *fmt)
+{
+  if (!fmt->to_sink || (fmt->len == 0))
+  {
+    return;
+  }
+
+  if ((fmt->sink != NULL) && (fmt->sink->fd != NULL))
+  {
+    fwrite(fmt->buf, 1, fmt->len, fmt->sink->fd);
+  }
+#ifdef USE_CIVETWEB
+  else if ((fmt->sink != NULL) && (fmt->sink->conn != NULL))
+  {
+    mg_write(fmt->sink->conn, fmt->buf, fmt->len);
+  }
+#endif
+  else
+  {
+    ui_fprintf(fmt->sink, "%s", fmt->buf);
+  }
+
+  fmt->len = 0;
+  fmt->buf[0] = '\0';
+}
+
+/* Makes room for num more bytes and a terminator, flushing first if possible. */
+static int mgr_fmt_reserve(mgr_fmt_t *fmt, size_t num)
+{
+  size_t new_max;
+  char *tmp;
+
+  if (fmt->err)
+  {
+    return AMP_FAIL;
+  }
+
+  if (fmt->len + num + 1 <= fmt->max)
+  {
+    return AMP_OK;
+  }
+
+  mgr_fmt_flush(fmt);
+  if (fmt->len + num + 1 <= fmt->max)
+  {
+    return AMP_OK;
+  }
+
+  new_max = fmt->max * 2;
+  while (new_max < fmt->len + num + 1)
+  {
+    new_max *= 2;
+  }
+
+  if ((tmp = STAKE(new_max)) == NULL)
+  {
+    fmt->err = 1;
+    return AMP_SYSERR;
+  }
+  memcpy(tmp, fmt->buf, fmt->len + 1);
+  if (fmt->buf != fmt->local)
+  {
+    SRELEASE(fmt->buf);
+  }
+  fmt->buf = tmp;
+  fmt->max = new_max;
+  return AMP_OK;
+}
+
+/* Appends bytes as they are. */
+static void mgr_fmt_raw(mgr_fmt_t *fmt, const char *data, size_t len)
+{
+  if (mgr_fmt_reserve(fmt, len) != AMP_OK)
+  {
+    return;
+  }
+  memcpy(fmt->buf + fmt->len, data, len);
+  fmt->len += len;
+  fmt->buf[fmt->len] = '\0';
+
+  if (fmt->to_sink && (fmt->len >= MGR_FMT_LOCAL_SIZE / 2))
+  {
+    mgr_fmt_flush(fmt);
+  }
+}
+
+/* Whether bytes must be escaped inside a JSON string. */
+static int mgr_fmt_needs_escape(const char *data, size_t len)
+{
+  size_t i;
+
+  for (i = 0; i < len; i++)
+  {
+    unsigned char c = (unsigned char) data[i];
+    if ((c < 0x20) || (c == '"') || (c == '\\'))
+    {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/* Appends bytes inside a JSON string, escaped. */
+static void mgr_fmt_escaped(mgr_fmt_t *fmt, const char *data, size_t len)
+{
+  size_t start = 0;
+  size_t i;
+  char esc[7];
+
+  for (i = 0; i < len; i++)
+  {
+    unsigned char c = (unsigned char) data[i];
+
+    if ((c >= 0x20) && (c != '"') && (c != '\\'))
+    {
+      continue;
+    }
+
+    mgr_fmt_raw(fmt, data + start, i - start);
+    switch (c)
+    {
+      case '"':  mgr_fmt_raw(fmt, "\\\"", 2); break;
+      case '\\': mgr_fmt_raw(fmt, "\\\\", 2); break;
+      case '\n': mgr_fmt_raw(fmt, "\\n", 2);  break;
+      case '\r': mgr_fmt_raw(fmt, "\\r", 2);  break;
+      case '\t': mgr_fmt_raw(fmt, "\\t", 2);  break;
+      default:
+        esc[0] = '\\';
+        esc[1] = 'u';
+        esc[2] = '0';
+        esc[3] = '0';
+        esc[4] = hex_digits[c >> 4];
+        esc[5] = hex_digits[c & 0xF];
+        mgr_fmt_raw(fmt, esc, 6);
+        break;
+    }
+    start = i + 1;
+  }
+  mgr_fmt_raw(fmt, data + start, len - start);
+}
+
+
+/******************************************************************************
+ * Starts a formatter which keeps its output, to be taken as a string.
+ *
+ * \param[out] fmt  The formatter.
+ *****************************************************************************/
+
+void mgr_fmt_init_buf(mgr_fmt_t *fmt)
+{
+  CHKVOID(fmt);
+  memset(fmt, 0, offsetof(mgr_fmt_t, local));
+  fmt->buf = fmt->local;
+  fmt->max = sizeof(fmt->local);
+  fmt->buf[0] = '\0';
+}
+
+/******************************************************************************
+ * Starts a formatter which writes to a sink as its buffer fills.
+ *
+ * \param[out] fmt   The formatter.
+ * \param[in]  sink  Where output goes, or NULL for the UI display.
+ *
+ * \note mgr_fmt_finish() MUST be called to write the last of the output.
+ *****************************************************************************/
+
+void mgr_fmt_init_sink(mgr_fmt_t *fmt, ui_print_cfg_t *sink)
+{
+  CHKVOID(fmt);
+  mgr_fmt_init_buf(fmt);
+  fmt->to_sink = 1;
+  fmt->sink = sink;
+}
+
+/******************************************************************************
+ * Takes the output of a formatter started with mgr_fmt_init_buf().
+ *
+ * \returns The output, which the caller MUST release, or NULL on error.
+ *****************************************************************************/
+
+char* mgr_fmt_take(mgr_fmt_t *fmt)
+{
+  char *result;
+
+  CHKNULL(fmt);
+
+  if (fmt->err)
+  {
+    mgr_fmt_finish(fmt);
+    return NULL;
+  }
+
+  if (fmt->buf != fmt->local)
+  {
+    result = fmt->buf;
+  }
+  else if ((result = STAKE(fmt->len + 1)) != NULL)
+  {
+    memcpy(result, fmt->buf, fmt->len + 1);
+  }
+
+  fmt->buf = fmt->local;
+  fmt->max = sizeof(fmt->local);
+  fmt->len = 0;
+  fmt->buf[0] = '\0';
+  return result;
+}
+
+/******************************************************************************
+ * Writes the last of the output of a formatter to its sink and releases it.
+ * A formatter started with mgr_fmt_init_buf() just has its output discarded.
+ *****************************************************************************/
+
+void mgr_fmt_finish(mgr_fmt_t *fmt)
+{
+  CHKVOID(fmt);
+
+  mgr_fmt_flush(fmt);
+  if (fmt->buf != fmt->local)
+  {
+    SRELEASE(fmt->buf);
+  }
+  fmt->buf = fmt->local;
+  fmt->max = sizeof(fmt->local);
+  fmt->len = 0;
+  fmt->buf[0] = '\0';
+}
+
+void mgr_fmt_write(mgr_fmt_t *fmt, const char *data, size_t len)
+{
+  CHKVOID(fmt);
+  CHKVOID(data);
+
+  if (fmt->in_str)
+  {
+    mgr_fmt_escaped(fmt, data, len);
+  }
+  else
+  {
+    mgr_fmt_raw(fmt, data, len);
+  }
+}
+
+void mgr_fmt_puts(mgr_fmt_t *fmt, const char *str)
+{
+  mgr_fmt_write(fmt, (str == NULL) ? "(null)" : str, (str == NULL) ? 6 : strlen(str));
+}
+
+void mgr_fmt_printf(mgr_fmt_t *fmt, const char *format, ...)
+{
+  va_list args;
+  int num;
+  size_t start;
+
+  CHKVOID(fmt);
+
+  /* Usually the output fits in what is left of the buffer. */
+  va_start(args, format);
+  num = vsnprintf(fmt->buf + fmt->len, fmt->max - fmt->len, format, args);
+  va_end(args);
+
+  if (num < 0)
+  {
+    fmt->buf[fmt->len] = '\0';
+    return;
+  }
+
+  if (fmt->len + num >= fmt->max)
+  {
+    fmt->buf[fmt->len] = '\0';
+    if (mgr_fmt_reserve(fmt, num) != AMP_OK)
+    {
+      return;
+    }
+    va_start(args, format);
+    vsnprintf(fmt->buf + fmt->len, fmt->max - fmt->len, format, args);
+    va_end(args);
+  }
+
+  start = fmt->len;
+  fmt->len += num;
+
+  /* Output inside a JSON string is escaped, if it needs to be. */
+  if (fmt->in_str && mgr_fmt_needs_escape(fmt->buf + start, num))
+  {
+    char *tmp = STAKE(num + 1);
+    if (tmp == NULL)
+    {
+      fmt->err = 1;
+      return;
+    }
+    memcpy(tmp, fmt->buf + start, num + 1);
+    fmt->len = start;
+    fmt->buf[fmt->len] = '\0';
+    mgr_fmt_escaped(fmt, tmp, num);
+    SRELEASE(tmp);
+  }
+  else
+  {
+    mgr_fmt_raw(fmt, "", 0);
+  }
+}
+
+void mgr_fmt_hex(mgr_fmt_t *fmt, const uint8_t *data, size_t len)
+{
+  // Encoded straight into the buffer, a part at a time so a sink never grows it
+  const size_t part_max = MGR_FMT_LOCAL_SIZE / 4;
+  size_t part;
+
+  mgr_fmt_write(fmt, "0x", 2);
+  for (; len > 0; data += part, len -= part)
+  {
+    part = MIN(len, part_max);
+    if (mgr_fmt_reserve(fmt, 2 * part) != AMP_OK)
+    {
+      return;
+    }
+    fmt->len += utils_hex_encode(fmt->buf + fmt->len, data, part);
+    if (fmt->to_sink && (fmt->len >= MGR_FMT_LOCAL_SIZE / 2))
+    {
+      mgr_fmt_flush(fmt);
+    }
+  }
+}
+
+
+/* JSON structure */
+
+/* Writes the separator needed before a value or key. */
+static void mgr_fmt_json_sep(mgr_fmt_t *fmt)
+{
+  uint32_t bit;
+
+  if (fmt->after_key)
+  {
+    fmt->after_key = 0;
+    return;
+  }
+
+  if ((fmt->depth <= 0) || (fmt->depth > MGR_FMT_JSON_MAX_DEPTH))
+  {
+    return;
+  }
+
+  bit = 1u << (fmt->depth - 1);
+  if (fmt->more & bit)
+  {
+    mgr_fmt_raw(fmt, ",", 1);
+  }
+  fmt->more |= bit;
+}
+
+void mgr_fmt_json_open(mgr_fmt_t *fmt, char type)
+{
+  CHKVOID(fmt);
+  mgr_fmt_json_sep(fmt);
+  mgr_fmt_raw(fmt, &type, 1);
+  fmt->depth++;
+  if (fmt->depth <= MGR_FMT_JSON_MAX_DEPTH)
+  {
+    fmt->more &= ~(1u << (fmt->depth - 1));
+  }
+}
+
+void mgr_fmt_json_close(mgr_fmt_t *fmt, char type)
+{
+  CHKVOID(fmt);
+  fmt->depth--;
+  mgr_fmt_raw(fmt, &type, 1);
+}
+
+void mgr_fmt_json_key_begin(mgr_fmt_t *fmt)
+{
+  CHKVOID(fmt);
+  mgr_fmt_json_sep(fmt);
+  mgr_fmt_raw(fmt, "\"", 1);
+  fmt->in_str = 1;
+}
+
+void mgr_fmt_json_key_end(mgr_fmt_t *fmt)
+{
+  CHKVOID(fmt);
+  fmt->in_str = 0;
+  mgr_fmt_raw(fmt, "\":", 2);
+  fmt->after_key = 1;
+}
+
+void mgr_fmt_json_key(mgr_fmt_t *fmt, const char *key)
+{
+  mgr_fmt_json_key_begin(fmt);
+  mgr_fmt_puts(fmt, key);
+  mgr_fmt_json_key_end(fmt);
+}
+
+void mgr_fmt_json_str_begin(mgr_fmt_t *fmt)
+{
+  CHKVOID(fmt);
+  mgr_fmt_json_sep(fmt);
+  mgr_fmt_raw(fmt, "\"", 1);
+  fmt->in_str = 1;
+}
+
+void mgr_fmt_json_str_end(mgr_fmt_t *fmt)
+{
+  CHKVOID(fmt);
+  fmt->in_str = 0;
+  mgr_fmt_raw(fmt, "\"", 1);
+}
+
+void mgr_fmt_json_str(mgr_fmt_t *fmt, const char *str)
+{
+  mgr_fmt_json_str_begin(fmt);
+  mgr_fmt_puts(fmt, str);
+  mgr_fmt_json_str_end(fmt);
+}
+
+void mgr_fmt_json_uint(mgr_fmt_t *fmt, uint64_t val)
+{
+  CHKVOID(fmt);
+  mgr_fmt_json_sep(fmt);
+  mgr_fmt_printf(fmt, "%"PRIu64, val);
+}
+
+void mgr_fmt_json_null(mgr_fmt_t *fmt)
+{
+  CHKVOID(fmt);
+  mgr_fmt_json_sep(fmt);
+  mgr_fmt_raw(fmt, "null", 4);
+}
+
+static void mgr_fmt_json_real(mgr_fmt_t *fmt, double val)
+{
+  mgr_fmt_json_sep(fmt);
+  if (isfinite(val))
+  {
+    mgr_fmt_printf(fmt, "%.17g", val);
+  }
+  else
+  {
+    mgr_fmt_raw(fmt, "null", 4);
+  }
+}
+
+
+/* ARI names */
+
+/* The slot of the name cache for an interned identity. */
+static mgr_fmt_name_t *mgr_fmt_name_slot(const ari_ident_t *ident)
+{
+  uintptr_t key = (uintptr_t) ident;
+  key ^= key >> 17;
+  return &(name_cache[(key >> 4) % MGR_FMT_NAME_CACHE_SIZE]);
+}
+
+/* Finds the metadata of an ARI, through the cache if it is interned. */
+static metadata_t *mgr_fmt_meta(ari_t *id)
+{
+  mgr_fmt_name_t *slot;
+  metadata_t *meta;
+
+  if (id->as_reg.ident == NULL)
+  {
+    return rhht_retrieve_key(&(gMgrDB.metadata), id);
+  }
+
+  pthread_mutex_lock(&name_cache_lock);
+  slot = mgr_fmt_name_slot(id->as_reg.ident);
+  if (slot->ident != id->as_reg.ident)
+  {
+    SRELEASE(slot->anon);
+    slot->anon = NULL;
+    slot->ident = id->as_reg.ident;
+    slot->meta = rhht_retrieve_key(&(gMgrDB.metadata), id);
+  }
+  meta = slot->meta;
+  pthread_mutex_unlock(&name_cache_lock);
+
+  return meta;
+}
+
+/******************************************************************************
+ * Forgets all cached ARI names, as when the metadata they point to is
+ * released.
+ *****************************************************************************/
+
+void mgr_fmt_names_clear()
+{
+  int i;
+
+  pthread_mutex_lock(&name_cache_lock);
+  for (i = 0; i < MGR_FMT_NAME_CACHE_SIZE; i++)
+  {
+    SRELEASE(name_cache[i].anon);
+    memset(&(name_cache[i]), 0, sizeof(mgr_fmt_name_t));
+  }
+  pthread_mutex_unlock(&name_cache_lock);
+}
+
+/* Writes the hex encoding of an ARI, with parameters if given. */
+static void mgr_fmt_ari_hex(mgr_fmt_t *fmt, ari_t *id, tnvc_t *ap)
+{
+  ari_t *print_id = id;
+  blob_t *blob;
+
+  if (ap != NULL)
+  {
+    if ((print_id = ari_copy_ptr(id)) == NULL)
+    {
+      mgr_fmt_puts(fmt, "NULL ARI");
+      return;
+    }
+    ari_replace_parms(print_id, ap);
+  }
+
+  if ((blob = ari_serialize_wrapper(print_id)) != NULL)
+  {
+    mgr_fmt_puts(fmt, "Anonymous ARI: ");
+    mgr_fmt_hex(fmt, blob->value, blob->length);
+    blob_release(blob, 1);
+  }
+  else
+  {
+    mgr_fmt_puts(fmt, "NULL ARI");
+  }
+
+  if (print_id != id)
+  {
+    ari_release(print_id, 1);
+  }
+}
+
+/* Writes an ARI with no metadata, encoding it once if it is interned. */
+static void mgr_fmt_ari_anon(mgr_fmt_t *fmt, ari_t *id, tnvc_t *ap)
+{
+  mgr_fmt_name_t *slot;
+  mgr_fmt_t tmp;
+
+  if ((ap != NULL) || (id->as_reg.ident == NULL) || (tnvc_size(&(id->as_reg.parms)) > 0))
+  {
+    mgr_fmt_ari_hex(fmt, id, ap);
+    return;
+  }
+
+  pthread_mutex_lock(&name_cache_lock);
+  slot = mgr_fmt_name_slot(id->as_reg.ident);
+  if ((slot->ident == id->as_reg.ident) && (slot->anon == NULL))
+  {
+    mgr_fmt_init_buf(&tmp);
+    mgr_fmt_ari_hex(&tmp, id, NULL);
+    slot->anon = mgr_fmt_take(&tmp);
+  }
+
+  if ((slot->ident == id->as_reg.ident) && (slot->anon != NULL))
+  {
+    mgr_fmt_puts(fmt, slot->anon);
+    pthread_mutex_unlock(&name_cache_lock);
+  }
+  else
+  {
+    pthread_mutex_unlock(&name_cache_lock);
+    mgr_fmt_ari_hex(fmt, id, NULL);
+  }
+}
+
+
+/* Values, as text */
+
+void mgr_fmt_ac(mgr_fmt_t *fmt, ac_t *ac)
+{
+  vecit_t it;
+
+  CHKVOID(ac);
+  for (it = vecit_first(&(ac->values)); vecit_valid(it); it = vecit_next(it))
+  {
+    mgr_fmt_ari(fmt, (ari_t*) vecit_data(it), NULL, 0);
+    mgr_fmt_puts(fmt, " ");
+  }
+}
+
+/******************************************************************************
+ * Writes an ARI by name, or as its encoding if the manager has no name for it.
+ *
+ * \param[in,out] fmt   The formatter.
+ * \param[in]     id    The ARI.
+ * \param[in]     ap    Actual parameters to write in place of those of id.
+ * \param[in]     desc  Non-zero to follow the name with its description.
+ *****************************************************************************/
+
+void mgr_fmt_ari(mgr_fmt_t *fmt, ari_t *id, tnvc_t *ap, int desc)
+{
+  metadata_t *meta;
+
+  if (id == NULL)
+  {
+    mgr_fmt_puts(fmt, "null");
+    return;
+  }
+
+  if (id->type == AMP_TYPE_LIT)
+  {
+    mgr_fmt_tnv(fmt, &(id->as_lit));
+    return;
+  }
+
+  if ((meta = mgr_fmt_meta(id)) == NULL)
+  {
+    mgr_fmt_ari_anon(fmt, id, ap);
+    return;
+  }
+
+  mgr_fmt_puts(fmt, meta->name);
+
+  /* If we have actual parameters, print those. */
+  if (ap != NULL)
+  {
+    mgr_fmt_puts(fmt, "(");
+    mgr_fmt_tnvc(fmt, ap);
+    mgr_fmt_puts(fmt, ")");
+  }
+  else if (vec_num_entries(meta->parmspec) > 0)
+  {
+    mgr_fmt_puts(fmt, "(");
+    mgr_fmt_fp(fmt, meta);
+    mgr_fmt_puts(fmt, ")");
+  }
+
+  if (desc)
+  {
+    mgr_fmt_puts(fmt, "\t: ");
+    mgr_fmt_puts(fmt, meta->descr);
+  }
+}
+
+void mgr_fmt_expr(mgr_fmt_t *fmt, expr_t *expr)
+{
+  CHKVOID(expr);
+  mgr_fmt_printf(fmt, "EXPR: (%s) ", type_to_str(expr->type));
+  mgr_fmt_ac(fmt, &(expr->rpn));
+}
+
+/* Writes the formal parameters of an object. */
+void mgr_fmt_fp(mgr_fmt_t *fmt, metadata_t *meta)
+{
+  vecit_t it;
+  int j;
+
+  CHKVOID(meta);
+
+  mgr_fmt_puts(fmt, "(");
+  for (j = 0, it = vecit_first(&(meta->parmspec)); vecit_valid(it); it = vecit_next(it), j++)
+  {
+    meta_fp_t *parm = (meta_fp_t *) vecit_data(it);
+
+    if (j != 0)
+    {
+      mgr_fmt_puts(fmt, ",");
+    }
+    if (parm == NULL)
+    {
+      mgr_fmt_puts(fmt, "? ?");
+    }
+    else
+    {
+      mgr_fmt_printf(fmt, "%s %s", type_to_str(parm->type), parm->name);
+    }
+  }
+  mgr_fmt_puts(fmt, ")");
+}
+
+void mgr_fmt_mac(mgr_fmt_t *fmt, macdef_t *mac)
+{
+  vecit_t it;
+  int i = 0;
+
+  CHKVOID(mac);
+
+  mgr_fmt_ari(fmt, mac->ari, NULL, 0);
+  mgr_fmt_puts(fmt, " = [");
+  for (it = vecit_first(&(mac->ctrls)); vecit_valid(it); it = vecit_next(it), i++)
+  {
+    ctrl_t *ctrl = (ctrl_t*) vecit_data(it);
+
+    if (i != 0)
+    {
+      mgr_fmt_puts(fmt, ", ");
+    }
+    mgr_fmt_ari(fmt, ctrl->def.as_ctrl->ari, ctrl->parms, 0);
+  }
+  mgr_fmt_puts(fmt, "]");
+}
+
+void mgr_fmt_rpttpl(mgr_fmt_t *fmt, rpttpl_t *rpttpl)
+{
+  int num;
+  int i;
+
+  CHKVOID(rpttpl);
+
+  mgr_fmt_ari(fmt, rpttpl->id, NULL, 0);
+  mgr_fmt_puts(fmt, " = [");
+  num = ac_get_count(&(rpttpl->contents));
+  for (i = 0; i < num; i++)
+  {
+    if (i != 0)
+    {
+      mgr_fmt_puts(fmt, ", ");
+    }
+    mgr_fmt_ari(fmt, ac_get(&(rpttpl->contents), i), NULL, 0);
+  }
+  mgr_fmt_puts(fmt, "]");
+}
+
+void mgr_fmt_sbr(mgr_fmt_t *fmt, rule_t *sbr)
+{
+  CHKVOID(sbr);
+
+  mgr_fmt_puts(fmt, "SBR: ID=");
+  mgr_fmt_ari(fmt, &(sbr->id), NULL, 0);
+  mgr_fmt_printf(fmt, ", S=%"PRId64", E=", (int64_t) OS_TimeGetTotalSeconds(sbr->start));
+  mgr_fmt_expr(fmt, &(sbr->def.as_sbr.expr));
+  mgr_fmt_printf(fmt, ", M=%"PRIu64", C=%"PRIu64", A=",
+                 (uint64_t) sbr->def.as_sbr.max_eval, (uint64_t) sbr->def.as_sbr.max_fire);
+  mgr_fmt_ac(fmt, &(sbr->action));
+  mgr_fmt_puts(fmt, "\n");
+}
+
+/* Writes the column headers and rows of a table. */
+void mgr_fmt_tbl(mgr_fmt_t *fmt, tbl_t *tbl)
+{
+  mgr_fmt_t cell;
+  int num_rows;
+  int i;
+  int j;
+
+  CHKVOID(tbl);
+
+  mgr_fmt_tblt(fmt, VDB_FINDKEY_TBLT(tbl->id));
+  mgr_fmt_puts(fmt, "----------------------------------------------------------------------\n");
+
+  num_rows = tbl_num_rows(tbl);
+  for (i = 0; i < num_rows; i++)
+  {
+    tnv_t val;
+
+    for (j = 0; tbl_get_cell(tbl, i, j, &val) == AMP_OK; j++)
+    {
+      if (j == 0)
+      {
+        mgr_fmt_puts(fmt, "|");
+      }
+
+      /* Cells are right-aligned in at least 23 characters, formatted in the
+       * local buffer of the cell formatter so most need no allocation. */
+      mgr_fmt_init_buf(&cell);
+      mgr_fmt_tnv(&cell, &val);
+      mgr_fmt_printf(fmt, "   %23s", cell.err ? "null" : cell.buf);
+      mgr_fmt_finish(&cell);
+      mgr_fmt_puts(fmt, "   |");
+    }
+    mgr_fmt_puts(fmt, "\n");
+  }
+  mgr_fmt_puts(fmt, "----------------------------------------------------------------------\n");
+}
+
+/* Writes the column headers of a table template, if there is one. */
+void mgr_fmt_tblt(mgr_fmt_t *fmt, tblt_t *tblt)
+{
+  vecit_t it;
+  int i = 0;
+
+  if (tblt == NULL)
+  {
+    return;
+  }
+
+  mgr_fmt_puts(fmt, "----------------------------------------------------------------------\n");
+  for (it = vecit_first(&(tblt->cols)); vecit_valid(it); it = vecit_next(it))
+  {
+    tblt_col_t *col = (tblt_col_t*) vecit_data(it);
+
+    if (i == 0)
+    {
+      mgr_fmt_puts(fmt, "|");
+    }
+    mgr_fmt_printf(fmt, "   %7s %15s   |",
+                   (col) ? type_to_str(col->type) : "null",
+                   (col) ? col->name : "null");
+    i = 1;
+  }
+  mgr_fmt_puts(fmt, "\n");
+}
+
+void mgr_fmt_tbr(mgr_fmt_t *fmt, rule_t *tbr)
+{
+  CHKVOID(tbr);
+
+  mgr_fmt_puts(fmt, "TBR: ID=");
+  mgr_fmt_ari(fmt, &(tbr->id), NULL, 0);
+  mgr_fmt_printf(fmt, ", S=%"PRId64", P=%"PRId64", C=%"PRIu64", A=",
+                 (int64_t) OS_TimeGetTotalSeconds(tbr->start),
+                 (int64_t) OS_TimeGetTotalSeconds(tbr->def.as_tbr.period),
+                 (uint64_t) tbr->def.as_tbr.max_fire);
+  mgr_fmt_ac(fmt, &(tbr->action));
+  mgr_fmt_puts(fmt, "\n");
+}
+
+void mgr_fmt_tnv(mgr_fmt_t *fmt, tnv_t *tnv)
+{
+  if (tnv == NULL)
+  {
+    mgr_fmt_puts(fmt, "null");
+    return;
+  }
+
+  switch (tnv->type)
+  {
+    case AMP_TYPE_CNST:
+    case AMP_TYPE_EDD:
+    {
+      edd_t *edd = tnv->value.as_ptr;
+      if (edd != NULL)
+      {
+        mgr_fmt_ari(fmt, edd->def.id, edd->parms, 0);
+      }
+      break;
+    }
+    case AMP_TYPE_CTRL:
+    {
+      ctrl_t *ctrl = tnv->value.as_ptr;
+      if (ctrl != NULL)
+      {
+        mgr_fmt_ari(fmt, ctrl->def.as_ctrl->ari, ctrl->parms, 0);
+      }
+      break;
+    }
+    case AMP_TYPE_LIT:
+    case AMP_TYPE_ARI:    mgr_fmt_ari(fmt, tnv->value.as_ptr, NULL, 0);   break;
+    case AMP_TYPE_MAC:    mgr_fmt_mac(fmt, tnv->value.as_ptr);            break;
+    case AMP_TYPE_OPER:
+    {
+      op_t *op = tnv->value.as_ptr;
+      if (op != NULL)
+      {
+        mgr_fmt_ari(fmt, op->id, NULL, 0);
+      }
+      break;
+    }
+    case AMP_TYPE_RPT:                                                    break;
+    case AMP_TYPE_RPTTPL: mgr_fmt_rpttpl(fmt, tnv->value.as_ptr);         break;
+    case AMP_TYPE_SBR:    mgr_fmt_sbr(fmt, tnv->value.as_ptr);            break;
+    case AMP_TYPE_TBL:    mgr_fmt_tbl(fmt, tnv->value.as_ptr);            break;
+    case AMP_TYPE_TBLT:   mgr_fmt_tblt(fmt, tnv->value.as_ptr);           break;
+    case AMP_TYPE_TBR:    mgr_fmt_tbr(fmt, tnv->value.as_ptr);            break;
+    case AMP_TYPE_VAR:
+    {
+      var_t *var = tnv->value.as_ptr;
+      if (var != NULL)
+      {
+        mgr_fmt_tnv(fmt, var->value);
+      }
+      break;
+    }
+
+    /* Primitive Types */
+    case AMP_TYPE_BOOL:
+    case AMP_TYPE_BYTE:   mgr_fmt_printf(fmt, "%d", tnv->value.as_byte);          break;
+    case AMP_TYPE_STR:    mgr_fmt_puts(fmt, (char*) tnv->value.as_ptr);           break;
+    case AMP_TYPE_INT:    mgr_fmt_printf(fmt, "%d", tnv->value.as_int);           break;
+    case AMP_TYPE_UINT:   mgr_fmt_printf(fmt, "%u", tnv->value.as_uint);          break;
+    case AMP_TYPE_VAST:   mgr_fmt_printf(fmt, "%"PRId64, tnv->value.as_vast);     break;
+    case AMP_TYPE_TV:
+    case AMP_TYPE_TS:
+    case AMP_TYPE_UVAST:  mgr_fmt_printf(fmt, "%"PRIu64, tnv->value.as_uvast);    break;
+    case AMP_TYPE_REAL32: mgr_fmt_printf(fmt, "%f", tnv->value.as_real32);        break;
+    case AMP_TYPE_REAL64: mgr_fmt_printf(fmt, "%lf", tnv->value.as_real64);       break;
+
+    /* Compound Objects */
+    case AMP_TYPE_TNV:    mgr_fmt_tnv(fmt, tnv->value.as_ptr);                    break;
+    case AMP_TYPE_TNVC:   mgr_fmt_tnvc(fmt, tnv->value.as_ptr);                   break;
+    case AMP_TYPE_AC:     mgr_fmt_ac(fmt, tnv->value.as_ptr);                     break;
+    case AMP_TYPE_EXPR:   mgr_fmt_expr(fmt, tnv->value.as_ptr);                   break;
+    case AMP_TYPE_BYTESTR:
+    {
+      blob_t *blob = tnv->value.as_ptr;
+      if (blob != NULL)
+      {
+        mgr_fmt_hex(fmt, blob->value, blob->length);
+      }
+      break;
+    }
+
+    default:
+      mgr_fmt_puts(fmt, "UNK");
+      break;
+  }
+}
+
+void mgr_fmt_tnvc(mgr_fmt_t *fmt, tnvc_t *tnvc)
+{
+  int max = tnvc_get_count(tnvc);
+  int i;
+
+  if (max == 0)
+  {
+    mgr_fmt_puts(fmt, "null");
+    return;
+  }
+
+  for (i = 0; i < max; i++)
+  {
+    if (i != 0)
+    {
+      mgr_fmt_puts(fmt, ", ");
+    }
+    mgr_fmt_tnv(fmt, tnvc_get(tnvc, i));
+  }
+}
+
+
+/* Values, as JSON */
+
+/******************************************************************************
+ * Writes a value as JSON: numbers and booleans as themselves, collections as
+ * arrays and everything else as its text in a string.
+ *****************************************************************************/
+
+void mgr_fmt_json_tnv(mgr_fmt_t *fmt, tnv_t *tnv)
+{
+  if (tnv == NULL)
+  {
+    mgr_fmt_json_null(fmt);
+    return;
+  }
+
+  switch (tnv->type)
+  {
+    case AMP_TYPE_BOOL:
+      mgr_fmt_json_sep(fmt);
+      mgr_fmt_puts(fmt, tnv->value.as_byte ? "true" : "false");
+      break;
+    case AMP_TYPE_INT:
+      mgr_fmt_json_sep(fmt);
+      mgr_fmt_printf(fmt, "%d", tnv->value.as_int);
+      break;
+    case AMP_TYPE_UINT:   mgr_fmt_json_uint(fmt, tnv->value.as_uint);     break;
+    case AMP_TYPE_VAST:
+      mgr_fmt_json_sep(fmt);
+      mgr_fmt_printf(fmt, "%"PRId64, tnv->value.as_vast);
+      break;
+    case AMP_TYPE_TV:
+    case AMP_TYPE_TS:
+    case AMP_TYPE_UVAST:  mgr_fmt_json_uint(fmt, tnv->value.as_uvast);    break;
+    case AMP_TYPE_REAL32: mgr_fmt_json_real(fmt, tnv->value.as_real32);   break;
+    case AMP_TYPE_REAL64: mgr_fmt_json_real(fmt, tnv->value.as_real64);   break;
+
+    /* Compound Objects */
+    case AMP_TYPE_TNV:    mgr_fmt_json_tnv(fmt, tnv->value.as_ptr);       break;
+    case AMP_TYPE_TNVC:   mgr_fmt_json_tnvc(fmt, tnv->value.as_ptr);      break;
+
+    default:
+      mgr_fmt_json_str_begin(fmt);
+      mgr_fmt_tnv(fmt, tnv);
+      mgr_fmt_json_str_end(fmt);
+      break;
+  }
+}
+
+/* Writes a collection as null, its only value, or an array of its values. */
+void mgr_fmt_json_tnvc(mgr_fmt_t *fmt, tnvc_t *tnvc)
+{
+  int max = tnvc_get_count(tnvc);
+  int i;
+
+  if (max == 0)
+  {
+    mgr_fmt_json_null(fmt);
+    return;
+  }
+  else if (max == 1)
+  {
+    mgr_fmt_json_tnv(fmt, tnvc_get(tnvc, 0));
+    return;
+  }
+
+  mgr_fmt_json_open(fmt, '[');
+  for (i = 0; i < max; i++)
+  {
+    mgr_fmt_json_tnv(fmt, tnvc_get(tnvc, i));
+  }
+  mgr_fmt_json_close(fmt, ']');
+}
+
+
+/* Reports and tables */
+
+/* Writes the name of entry i of a report, with the parameters it was given. */
+static void mgr_fmt_entry_name(mgr_fmt_t *fmt, rpt_t *rpt, rpttpl_t *tpl, int i)
+{
+  ari_t *entry_id = (tpl == NULL) ? NULL : ac_get(&(tpl->contents), i);
+  metadata_t *entry_info = (entry_id == NULL) ? NULL : mgr_fmt_meta(entry_id);
+  tnvc_t *parms;
+
+  if (entry_info == NULL)
+  {
+    mgr_fmt_printf(fmt, "Entry %d", i);
+    return;
+  }
+
+  mgr_fmt_puts(fmt, entry_info->name);
+
+  parms = ari_resolve_parms(&(entry_id->as_reg.parms), &(rpt->id->as_reg.parms));
+  if (parms != NULL)
+  {
+    if (tnvc_size(parms) > 0)
+    {
+      mgr_fmt_puts(fmt, "(");
+      mgr_fmt_tnvc(fmt, parms);
+      mgr_fmt_puts(fmt, ")");
+    }
+    tnvc_release(parms, 1);
+  }
+}
+
+/* The template of a report, if its entries match it. */
+static rpttpl_t *mgr_fmt_rpt_tpl(rpt_t *rpt)
+{
+  rpttpl_t *tpl = VDB_FINDKEY_RPTT(rpt->id);
+  int num_entries = tnvc_get_count(rpt->entries);
+
+  if ((tpl != NULL) && (ac_get_count(&(tpl->contents)) != num_entries))
+  {
+    AMP_DEBUG_ERR("mgr_fmt_rpt_tpl",
+                  "Template mismatch. Expected %d entries but have %d. Not using template.",
+                  ac_get_count(&(tpl->contents)), num_entries);
+    tpl = NULL;
+  }
+
+  return tpl;
+}
+
+/* Writes the name of a report, with its parameters. */
+static void mgr_fmt_rpt_name(mgr_fmt_t *fmt, rpt_t *rpt, metadata_t *rpt_info)
+{
+  if (rpt_info == NULL)
+  {
+    mgr_fmt_ari(fmt, rpt->id, NULL, 0);
+    return;
+  }
+
+  mgr_fmt_puts(fmt, rpt_info->name);
+  if (tnvc_size(&(rpt->id->as_reg.parms)) > 0)
+  {
+    mgr_fmt_puts(fmt, "(");
+    mgr_fmt_tnvc(fmt, &(rpt->id->as_reg.parms));
+    mgr_fmt_puts(fmt, ")");
+  }
+}
+
+/******************************************************************************
+ * Writes a report as text, with a banner naming it.
+ *****************************************************************************/
+
+void mgr_fmt_report(mgr_fmt_t *fmt, rpt_t *rpt)
+{
+  metadata_t *rpt_info;
+  int num_entries;
+  char timestr[32];
+  time_t secs;
+  int i;
+
+  if ((rpt == NULL) || (rpt->id == NULL))
+  {
+    return;
+  }
+
+  /* Step 1: Print the report banner, including the report name. */
+  rpt_info = mgr_fmt_meta(rpt->id);
+  num_entries = tnvc_get_count(rpt->entries);
+
+  mgr_fmt_puts(fmt, "\n----------------------------------------");
+  mgr_fmt_puts(fmt, "\n             AMP DATA REPORT            ");
+  mgr_fmt_puts(fmt, "\n----------------------------------------");
+  mgr_fmt_printf(fmt, "\nSent to   : %s", rpt->recipient.name);
+  mgr_fmt_puts(fmt, "\nRpt Name  : ");
+  mgr_fmt_rpt_name(fmt, rpt, rpt_info);
+
+  secs = OS_TimeGetTotalSeconds(rpt->time);
+  mgr_fmt_printf(fmt, "\nTimestamp : %s", ctime_r(&secs, timestr));
+  mgr_fmt_printf(fmt, "\n# Entries : %d", num_entries);
+  mgr_fmt_puts(fmt, "\n----------------------------------------\n");
+
+  /* Step 2: Print individual entries, based on type. */
+  if (rpt->id->type == AMP_TYPE_RPTTPL)
+  {
+    rpttpl_t *tpl = mgr_fmt_rpt_tpl(rpt);
+
+    for (i = 0; i < num_entries; i++)
+    {
+      tnv_t *val = tnvc_get(rpt->entries, i);
+
+      mgr_fmt_entry_name(fmt, rpt, tpl, i);
+      if (val == NULL)
+      {
+        mgr_fmt_puts(fmt, ": null");
+      }
+      else
+      {
+        mgr_fmt_puts(fmt, " : ");
+        mgr_fmt_tnv(fmt, val);
+      }
+      mgr_fmt_puts(fmt, "\n");
+    }
+  }
+  else if (rpt->id->type == AMP_TYPE_TBLT)
+  {
+    for (i = 0; i < num_entries; i++)
+    {
+      tnv_t *val = tnvc_get(rpt->entries, i);
+      if ((val != NULL) && (val->type == AMP_TYPE_TBL))
+      {
+        mgr_fmt_table(fmt, (tbl_t *) val->value.as_ptr);
+      }
+    }
+  }
+  else
+  {
+    tnv_t *val = tnvc_get(rpt->entries, 0);
+
+    if (rpt_info == NULL)
+    {
+      mgr_fmt_puts(fmt, "Entry 1");
+    }
+    else
+    {
+      mgr_fmt_printf(fmt, "%.30s", rpt_info->name);
+    }
+
+    if (val == NULL)
+    {
+      mgr_fmt_puts(fmt, ": null");
+    }
+    else
+    {
+      mgr_fmt_puts(fmt, " : ");
+      mgr_fmt_tnv(fmt, val);
+    }
+    mgr_fmt_puts(fmt, "\n");
+  }
+
+  /* Step 3: Print report trailer. */
+  mgr_fmt_puts(fmt, "\n----------------------------------------\n\n");
+}
+
+/******************************************************************************
+ * Writes a report as a JSON object.
+ *****************************************************************************/
+
+void mgr_fmt_report_json(mgr_fmt_t *fmt, rpt_t *rpt)
+{
+  metadata_t *rpt_info;
+  int num_entries;
+  char timestr[32];
+  time_t secs;
+  int i;
+
+  if ((rpt == NULL) || (rpt->id == NULL))
+  {
+    mgr_fmt_json_null(fmt);
+    return;
+  }
+
+  rpt_info = mgr_fmt_meta(rpt->id);
+  num_entries = tnvc_get_count(rpt->entries);
+
+  mgr_fmt_json_open(fmt, '{');
+  mgr_fmt_json_key(fmt, "num_entries");
+  mgr_fmt_json_uint(fmt, num_entries);
+  mgr_fmt_json_key(fmt, "recipient_name");
+  mgr_fmt_json_str(fmt, rpt->recipient.name);
+
+  mgr_fmt_json_key(fmt, "name");
+  if (rpt_info == NULL)
+  {
+    mgr_fmt_json_str_begin(fmt);
+    mgr_fmt_ari(fmt, rpt->id, NULL, 0);
+    mgr_fmt_json_str_end(fmt);
+  }
+  else
+  {
+    mgr_fmt_json_str(fmt, rpt_info->name);
+    if (tnvc_size(&(rpt->id->as_reg.parms)) > 0)
+    {
+      mgr_fmt_json_key(fmt, "arguments");
+      mgr_fmt_json_tnvc(fmt, &(rpt->id->as_reg.parms));
+    }
+  }
+
+  secs = OS_TimeGetTotalSeconds(rpt->time);
+  mgr_fmt_json_key(fmt, "timestamp");
+  mgr_fmt_json_str(fmt, ctime_r(&secs, timestr));
+
+  if (rpt->id->type == AMP_TYPE_RPTTPL)
+  {
+    rpttpl_t *tpl = mgr_fmt_rpt_tpl(rpt);
+
+    mgr_fmt_json_key(fmt, "entries");
+    mgr_fmt_json_open(fmt, '{');
+    for (i = 0; i < num_entries; i++)
+    {
+      mgr_fmt_json_key_begin(fmt);
+      mgr_fmt_entry_name(fmt, rpt, tpl, i);
+      mgr_fmt_json_key_end(fmt);
+      mgr_fmt_json_tnv(fmt, tnvc_get(rpt->entries, i));
+    }
+    mgr_fmt_json_close(fmt, '}');
+    mgr_fmt_json_key(fmt, "type");
+    mgr_fmt_json_str(fmt, "rpttpl");
+  }
+  else if (rpt->id->type == AMP_TYPE_TBLT)
+  {
+    mgr_fmt_json_key(fmt, "entries");
+    mgr_fmt_json_open(fmt, '[');
+    mgr_fmt_json_close(fmt, ']');
+    mgr_fmt_json_key(fmt, "type");
+    mgr_fmt_json_str(fmt, "tblt");
+
+    for (i = 0; i < num_entries; i++)
+    {
+      tnv_t *val = tnvc_get(rpt->entries, i);
+      if ((val != NULL) && (val->type == AMP_TYPE_TBL))
+      {
+        mgr_fmt_json_key(fmt, "table");
+        mgr_fmt_table_json(fmt, (tbl_t *) val->value.as_ptr);
+      }
+    }
+  }
+  else
+  {
+    mgr_fmt_json_key(fmt, "entries");
+    mgr_fmt_json_open(fmt, '[');
+    if (num_entries > 0)
+    {
+      mgr_fmt_json_tnvc(fmt, rpt->entries);
+    }
+    mgr_fmt_json_close(fmt, ']');
+    mgr_fmt_json_key(fmt, "type");
+    mgr_fmt_json_str(fmt, "unknown");
+  }
+
+  mgr_fmt_json_close(fmt, '}');
+}
+
+/******************************************************************************
+ * Writes a table as text, with a line naming it.
+ *****************************************************************************/
+
+void mgr_fmt_table(mgr_fmt_t *fmt, tbl_t *tbl)
+{
+  CHKVOID(tbl);
+
+  mgr_fmt_puts(fmt, "\nTable Name: ");
+  mgr_fmt_ari(fmt, tbl->id, NULL, 0);
+  mgr_fmt_puts(fmt, " \n");
+
+  mgr_fmt_tbl(fmt, tbl);
+  mgr_fmt_puts(fmt, "\n");
+}
+
+/******************************************************************************
+ * Writes a table as a JSON object of its name, columns and rows, or null if
+ * its template is unknown.
+ *****************************************************************************/
+
+void mgr_fmt_table_json(mgr_fmt_t *fmt, tbl_t *tbl)
+{
+  tblt_t *tblt;
+  vecit_t it;
+  int num_rows;
+  int i;
+  int j;
+
+  if ((tbl == NULL) || ((tblt = VDB_FINDKEY_TBLT(tbl->id)) == NULL))
+  {
+    mgr_fmt_json_null(fmt);
+    return;
+  }
+
+  mgr_fmt_json_open(fmt, '{');
+  mgr_fmt_json_key(fmt, "table name");
+  mgr_fmt_json_str_begin(fmt);
+  mgr_fmt_ari(fmt, tbl->id, NULL, 0);
+  mgr_fmt_json_str_end(fmt);
+
+  /* Columns */
+  mgr_fmt_json_key(fmt, "cols");
+  mgr_fmt_json_open(fmt, '[');
+  for (it = vecit_first(&(tblt->cols)); vecit_valid(it); it = vecit_next(it))
+  {
+    tblt_col_t *col = (tblt_col_t*) vecit_data(it);
+
+    mgr_fmt_json_open(fmt, '{');
+    if (col != NULL)
+    {
+      mgr_fmt_json_key(fmt, "name");
+      mgr_fmt_json_str(fmt, col->name);
+      mgr_fmt_json_key(fmt, "type");
+      mgr_fmt_json_str(fmt, type_to_str(col->type));
+    }
+    mgr_fmt_json_close(fmt, '}');
+  }
+  mgr_fmt_json_close(fmt, ']');
+
+  /* Rows */
+  mgr_fmt_json_key(fmt, "rows");
+  mgr_fmt_json_open(fmt, '[');
+  num_rows = tbl_num_rows(tbl);
+  for (i = 0; i < num_rows; i++)
+  {
+    tnv_t val;
+
+    mgr_fmt_json_open(fmt, '[');
+    for (j = 0; tbl_get_cell(tbl, i, j, &val) == AMP_OK; j++)
+    {
+      mgr_fmt_json_tnv(fmt, &val);
+    }
+    mgr_fmt_json_close(fmt, ']');
+  }
+  mgr_fmt_json_close(fmt, ']');
+
+  mgr_fmt_json_close(fmt, '}');
+}
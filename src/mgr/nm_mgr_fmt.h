@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2023 The Johns Hopkins University Applied Physics
+ * Laboratory LLC.
+ *
+ * This file is part of the Delay-Tolerant Networking Management
+ * Architecture (DTNMA) Tools package.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/** @file
+ * Streaming formatter for reports, tables and the values they hold.
+ *
+ * Text and JSON are written straight into one output buffer, with no
+ * intermediate strings. The buffer is either kept as a string or flushed to
+ * a sink as it fills: a FILE, a REST connection or the UI display. Writing to
+ * a sink allocates nothing unless a single value outgrows the buffer.
+ *
+ * The metadata of interned ARIs, and the encoding of those without any, is
+ * looked up once and cached for all formatters.
+ */
+#ifndef NM_MGR_FMT_H_
+#define NM_MGR_FMT_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "../shared/primitives/report.h"
+#include "../shared/primitives/rules.h"
+#include "../shared/primitives/expr.h"
+#include "../shared/primitives/table.h"
+#include "nm_mgr_ui.h"
+#include "metadata.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Size of the buffer held in each formatter
+#define MGR_FMT_LOCAL_SIZE (4096)
+/// Entries in the shared cache of ARI names
+#define MGR_FMT_NAME_CACHE_SIZE (1024)
+/// Deepest nesting of JSON containers
+#define MGR_FMT_JSON_MAX_DEPTH (32)
+
+/** State of one formatter.
+ */
+typedef struct {
+  /// Output not yet flushed, always NUL-terminated
+  char *buf;
+  size_t len;
+  size_t max;
+  /// Non-zero if output is flushed to #sink rather than kept
+  int to_sink;
+  /// The sink, or NULL for the UI display
+  ui_print_cfg_t *sink;
+  /// Non-zero if output was lost for lack of memory
+  int err;
+
+  /// Non-zero while writing inside a JSON string, which escapes all output
+  int in_str;
+  /// Non-zero if a JSON key was just written
+  int after_key;
+  /// Depth of JSON containers
+  int depth;
+  /// For each depth, whether its container has a member yet
+  uint32_t more;
+
+  char local[MGR_FMT_LOCAL_SIZE];
+} mgr_fmt_t;
+
+void  mgr_fmt_init_buf(mgr_fmt_t *fmt);
+void  mgr_fmt_init_sink(mgr_fmt_t *fmt, ui_print_cfg_t *sink);
+char* mgr_fmt_take(mgr_fmt_t *fmt);
+void  mgr_fmt_finish(mgr_fmt_t *fmt);
+
+void  mgr_fmt_names_clear();
+
+void  mgr_fmt_write(mgr_fmt_t *fmt, const char *data, size_t len);
+void  mgr_fmt_puts(mgr_fmt_t *fmt, const char *str);
+void  mgr_fmt_printf(mgr_fmt_t *fmt, const char *format, ...);
+void  mgr_fmt_hex(mgr_fmt_t *fmt, const uint8_t *data, size_t len);
+
+void  mgr_fmt_json_open(mgr_fmt_t *fmt, char type);
+void  mgr_fmt_json_close(mgr_fmt_t *fmt, char type);
+void  mgr_fmt_json_key_begin(mgr_fmt_t *fmt);
+void  mgr_fmt_json_key_end(mgr_fmt_t *fmt);
+void  mgr_fmt_json_key(mgr_fmt_t *fmt, const char *key);
+void  mgr_fmt_json_str_begin(mgr_fmt_t *fmt);
+void  mgr_fmt_json_str_end(mgr_fmt_t *fmt);
+void  mgr_fmt_json_str(mgr_fmt_t *fmt, const char *str);
+void  mgr_fmt_json_uint(mgr_fmt_t *fmt, uint64_t val);
+void  mgr_fmt_json_null(mgr_fmt_t *fmt);
+
+/* Values, as text */
+void  mgr_fmt_ac(mgr_fmt_t *fmt, ac_t *ac);
+void  mgr_fmt_ari(mgr_fmt_t *fmt, ari_t *id, tnvc_t *ap, int desc);
+void  mgr_fmt_expr(mgr_fmt_t *fmt, expr_t *expr);
+void  mgr_fmt_fp(mgr_fmt_t *fmt, metadata_t *meta);
+void  mgr_fmt_mac(mgr_fmt_t *fmt, macdef_t *mac);
+void  mgr_fmt_rpttpl(mgr_fmt_t *fmt, rpttpl_t *rpttpl);
+void  mgr_fmt_sbr(mgr_fmt_t *fmt, rule_t *sbr);
+void  mgr_fmt_tbl(mgr_fmt_t *fmt, tbl_t *tbl);
+void  mgr_fmt_tblt(mgr_fmt_t *fmt, tblt_t *tblt);
+void  mgr_fmt_tbr(mgr_fmt_t *fmt, rule_t *tbr);
+void  mgr_fmt_tnv(mgr_fmt_t *fmt, tnv_t *tnv);
+void  mgr_fmt_tnvc(mgr_fmt_t *fmt, tnvc_t *tnvc);
+
+/* Values, as JSON */
+void  mgr_fmt_json_tnv(mgr_fmt_t *fmt, tnv_t *tnv);
+void  mgr_fmt_json_tnvc(mgr_fmt_t *fmt, tnvc_t *tnvc);
+
+/* Reports and tables */
+void  mgr_fmt_report(mgr_fmt_t *fmt, rpt_t *rpt);
+void  mgr_fmt_report_json(mgr_fmt_t *fmt, rpt_t *rpt);
+void  mgr_fmt_table(mgr_fmt_t *fmt, tbl_t *tbl);
+void  mgr_fmt_table_json(mgr_fmt_t *fmt, tbl_t *tbl);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NM_MGR_FMT_H_ */
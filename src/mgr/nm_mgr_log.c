@@ -0,0 +1,414 @@
+/*
+ * Copyright (c) 2023 The Johns Hopkins University Applied Physics
+ * Laboratory LLC.
+ *
+ * This file is part of the Delay-Tolerant Networking Management
+ * Architecture (DTNMA) Tools package.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <stdatomic.h>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#include "shared/platform.h"
+#include "../shared/utils/debug.h"
+#include "../shared/utils/lfq.h"
+#include "../shared/utils/threadset.h"
+#include "../shared/primitives/time.h"
+
+#include "nm_mgr_log.h"
+#include "nmmgr.h"
+
+/// Records waiting for the writer thread
+static lfq_t g_log_queue;
+/// Signaled whenever a record is queued
+static sem_t g_log_wake;
+/// Count of records which could not be queued
+static atomic_uint_fast64_t g_log_dropped;
+/// Rotated files waiting for the compressor thread, as strdup() paths
+static lfq_t g_log_compress_queue;
+/// Signaled once for each path queued, and once more to stop
+static sem_t g_log_compress_wake;
+
+
+static void mgr_log_rec_release(mgr_log_rec_t *rec)
+{
+  agent_put(rec->agent);
+  free(rec->text);
+  SRELEASE(rec);
+}
+
+/* Queue a record, which holds a reference to its agent until handled. */
+static int mgr_log_push(mgr_log_rec_t *rec)
+{
+  agent_hold(rec->agent);
+  if (!lfq_push(&g_log_queue, rec))
+  {
+    atomic_fetch_add(&g_log_dropped, 1);
+    mgr_log_rec_release(rec);
+    return AMP_FAIL;
+  }
+  sem_post(&g_log_wake);
+  return AMP_OK;
+}
+
+static void mgr_log_handle(mgr_log_rec_t *rec)
+{
+  agent_t *agent = rec->agent;
+
+  switch (rec->type)
+  {
+    case MGR_LOG_REC_TEXT:
+      if (agent->log_fd == NULL)
+      {
+        break;
+      }
+      if (fwrite(rec->text, 1, rec->len, agent->log_fd) != rec->len)
+      {
+        AMP_DEBUG_ERR("mgr_log_handle", "Failed to write log for agent %s", agent->eid.name);
+      }
+      agent->log_dirty = 1;
+      if (rec->entries > 0)
+      {
+        agent->log_fd_cnt += rec->entries;
+        // Sets are never split across files
+        agent_rotate_log(agent, 0);
+      }
+      break;
+    case MGR_LOG_REC_ROTATE:
+      agent_rotate_log(agent, rec->force);
+      break;
+  }
+
+  mgr_log_rec_release(rec);
+}
+
+/// Handle every queued record, returning the number handled
+static size_t mgr_log_drain()
+{
+  size_t count = 0;
+  mgr_log_rec_t *rec;
+
+  while ((rec = lfq_pop(&g_log_queue)) != NULL)
+  {
+    mgr_log_handle(rec);
+    ++count;
+  }
+  return count;
+}
+
+static void mgr_log_flush_all()
+{
+  vecit_t it;
+
+  vec_lock(&(gMgrDB.agents));
+  for (it = vecit_first(&(gMgrDB.agents)); vecit_valid(it); it = vecit_next(it))
+  {
+    agent_t *agent = vecit_data(it);
+    if ((agent != NULL) && agent->log_dirty && (agent->log_fd != NULL))
+    {
+      fflush(agent->log_fd);
+      agent->log_dirty = 0;
+    }
+  }
+  vec_unlock(&(gMgrDB.agents));
+}
+
+/* Compress rotated files, at a low priority, until woken with none queued. */
+static void *mgr_log_compress_thread(void *arg)
+{
+  char *path;
+
+#ifdef SCHED_IDLE
+  const struct sched_param param = { .sched_priority = 0 };
+  pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+#endif
+
+  while (true)
+  {
+    if (sem_wait(&g_log_compress_wake) != 0)
+    {
+      continue;
+    }
+    if ((path = lfq_pop(&g_log_compress_queue)) == NULL)
+    {
+      break;
+    }
+    mgr_log_compress(path);
+    free(path);
+  }
+  return NULL;
+}
+
+int mgr_log_init(size_t capacity)
+{
+  atomic_init(&g_log_dropped, 0);
+  if (sem_init(&g_log_wake, 0, 0) || sem_init(&g_log_compress_wake, 0, 0))
+  {
+    AMP_DEBUG_ERR("mgr_log_init", "Failed to create semaphore", NULL);
+    sem_destroy(&g_log_wake);
+    return AMP_SYSERR;
+  }
+  if (lfq_init(&g_log_queue, capacity) != AMP_OK)
+  {
+    sem_destroy(&g_log_compress_wake);
+    sem_destroy(&g_log_wake);
+    return AMP_SYSERR;
+  }
+  if (lfq_init(&g_log_compress_queue, MGR_LOG_COMPRESS_QUEUE_LEN) != AMP_OK)
+  {
+    lfq_destroy(&g_log_queue);
+    sem_destroy(&g_log_compress_wake);
+    sem_destroy(&g_log_wake);
+    return AMP_SYSERR;
+  }
+  return AMP_OK;
+}
+
+void mgr_log_destroy()
+{
+  mgr_log_rec_t *rec;
+  char *path;
+
+  // Anything left was queued after the writer exited
+  while ((rec = lfq_pop(&g_log_queue)) != NULL)
+  {
+    mgr_log_rec_release(rec);
+  }
+  while ((path = lfq_pop(&g_log_compress_queue)) != NULL)
+  {
+    free(path);
+  }
+  lfq_destroy(&g_log_compress_queue);
+  lfq_destroy(&g_log_queue);
+  sem_destroy(&g_log_compress_wake);
+  sem_destroy(&g_log_wake);
+}
+
+void mgr_log_wake()
+{
+  sem_post(&g_log_wake);
+}
+
+void *mgr_log_thread(void *arg)
+{
+  nmmgr_t *mgr = arg;
+  const threadinfo_t compress_info = {&mgr_log_compress_thread, "nm_mgr_log_gz"};
+  list_thread_t compressor;
+  OS_time_t nowtime;
+  OS_time_t next_flush;
+  bool running = true;
+
+  AMP_DEBUG_INFO("mgr_log_thread", "Log writer thread running...", NULL);
+
+  list_thread_init(compressor);
+  if (threadset_start(&compressor, &compress_info, 1, NULL) != AMP_OK)
+  {
+    AMP_DEBUG_WARN("mgr_log_thread", "Rotated logs will not be compressed.", NULL);
+  }
+
+  OS_GetLocalTime(&next_flush);
+  while (running)
+  {
+    running = daemon_run_get(&mgr->running);
+
+    mgr_log_drain();
+
+    OS_GetLocalTime(&nowtime);
+    if (TimeCompare(nowtime, next_flush) >= 0)
+    {
+      int flush_ms = (agent_log_cfg.flush_ms > 0) ? agent_log_cfg.flush_ms : MGR_LOG_DEF_FLUSH_MS;
+      mgr_log_flush_all();
+      next_flush = OS_TimeAdd(nowtime, OS_TimeFromTotalMilliseconds(flush_ms));
+    }
+
+    if (running && (lfq_size(&g_log_queue) == 0))
+    {
+      const struct timespec abstime = TimeToTimespec(next_flush);
+      sem_timedwait(&g_log_wake, &abstime);
+    }
+  }
+
+  // Nothing queued before shutdown is lost
+  mgr_log_drain();
+  mgr_log_flush_all();
+
+  // The compressor finishes the files queued before it is stopped
+  sem_post(&g_log_compress_wake);
+  threadset_join(&compressor);
+  list_thread_clear(compressor);
+
+  AMP_DEBUG_ALWAYS("mgr_log_thread", "Exiting.", NULL);
+  return NULL;
+}
+
+int mgr_log_buf_open(mgr_log_buf_t *buf)
+{
+  CHKUSR(buf, AMP_FAIL);
+  buf->text = NULL;
+  buf->len = 0;
+  buf->fd = open_memstream(&(buf->text), &(buf->len));
+  if (buf->fd == NULL)
+  {
+    AMP_DEBUG_ERR("mgr_log_buf_open", "Failed to open memory stream", NULL);
+    return AMP_SYSERR;
+  }
+  return AMP_OK;
+}
+
+int mgr_log_buf_commit(mgr_log_buf_t *buf, agent_t *agent, int entries)
+{
+  mgr_log_rec_t *rec;
+
+  CHKUSR(buf, AMP_FAIL);
+  CHKUSR(buf->fd, AMP_FAIL);
+  fclose(buf->fd);
+  buf->fd = NULL;
+
+  if ((agent == NULL) || (buf->len == 0)
+      || ((rec = STAKE(sizeof(mgr_log_rec_t))) == NULL))
+  {
+    free(buf->text);
+    buf->text = NULL;
+    return AMP_FAIL;
+  }
+
+  rec->type = MGR_LOG_REC_TEXT;
+  rec->agent = agent;
+  rec->entries = entries;
+  rec->len = buf->len;
+  rec->text = buf->text;
+  buf->text = NULL;
+  buf->len = 0;
+
+  return mgr_log_push(rec);
+}
+
+int mgr_log_printf(agent_t *agent, const char *format, ...)
+{
+  mgr_log_rec_t *rec;
+  va_list args;
+  int len;
+
+  CHKUSR(agent, AMP_FAIL);
+  if ((rec = STAKE(sizeof(mgr_log_rec_t))) == NULL)
+  {
+    return AMP_SYSERR;
+  }
+
+  va_start(args, format);
+  len = vasprintf(&(rec->text), format, args);
+  va_end(args);
+  if (len < 0)
+  {
+    SRELEASE(rec);
+    return AMP_SYSERR;
+  }
+
+  rec->type = MGR_LOG_REC_TEXT;
+  rec->agent = agent;
+  rec->len = len;
+  return mgr_log_push(rec);
+}
+
+int mgr_log_rotate(agent_t *agent, int force)
+{
+  mgr_log_rec_t *rec;
+
+  CHKUSR(agent, AMP_FAIL);
+  if ((rec = STAKE(sizeof(mgr_log_rec_t))) == NULL)
+  {
+    return AMP_SYSERR;
+  }
+  rec->type = MGR_LOG_REC_ROTATE;
+  rec->agent = agent;
+  rec->force = force;
+  return mgr_log_push(rec);
+}
+
+size_t mgr_log_backlog()
+{
+  return lfq_size(&g_log_queue);
+}
+
+uint64_t mgr_log_dropped()
+{
+  return atomic_load(&g_log_dropped);
+}
+
+int mgr_log_compress_later(const char *path)
+{
+  char *copy;
+
+  CHKUSR(path, AMP_FAIL);
+  if ((copy = strdup(path)) == NULL)
+  {
+    return AMP_SYSERR;
+  }
+  if (!lfq_push(&g_log_compress_queue, copy))
+  {
+    AMP_DEBUG_WARN("mgr_log_compress_later", "Too many files waiting, leaving %s uncompressed", path);
+    free(copy);
+    return AMP_FAIL;
+  }
+  sem_post(&g_log_compress_wake);
+  return AMP_OK;
+}
+
+void mgr_log_compress(const char *path)
+{
+#ifdef HAVE_ZLIB
+  char gzpath[sizeof(((agent_t *)0)->log_fn) + 4];
+  char buf[16384];
+  size_t got;
+  int ok = 1;
+  FILE *in;
+  gzFile out;
+
+  snprintf(gzpath, sizeof(gzpath), "%s.gz", path);
+  if ((in = fopen(path, "rb")) == NULL)
+  {
+    AMP_DEBUG_ERR("mgr_log_compress", "Failed to open %s", path);
+    return;
+  }
+  if ((out = gzopen(gzpath, "wb")) == NULL)
+  {
+    AMP_DEBUG_ERR("mgr_log_compress", "Failed to open %s", gzpath);
+    fclose(in);
+    return;
+  }
+
+  while (ok && ((got = fread(buf, 1, sizeof(buf), in)) > 0))
+  {
+    ok = (gzwrite(out, buf, got) == (int)got);
+  }
+  fclose(in);
+  if ((gzclose(out) != Z_OK) || !ok)
+  {
+    AMP_DEBUG_ERR("mgr_log_compress", "Failed to compress %s", path);
+    unlink(gzpath);
+    return;
+  }
+  unlink(path);
+#else
+  AMP_DEBUG_WARN("mgr_log_compress", "Not built with zlib, leaving %s uncompressed", path);
+#endif
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2023 The Johns Hopkins University Applied Physics
+ * Laboratory LLC.
+ *
+ * This file is part of the Delay-Tolerant Networking Management
+ * Architecture (DTNMA) Tools package.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/** @file
+ * Buffered, asynchronous writer for the per-agent log files.
+ *
+ * The receive thread formats each report or table set into memory and hands
+ * the text to the log writer through a lock-free queue. A dedicated thread
+ * owns all of the agent log files: it batches writes through large stdio
+ * buffers, flushes them on a timer and rotates files. Rotated segments are
+ * optionally compressed by a second, low-priority thread, so that neither
+ * a slow disk nor compression stalls message ingest or the writer.
+ *
+ * Each queued record holds a reference to its agent, so an agent removed
+ * while records are waiting is freed only after the last is written.
+ * Callers must themselves hold the agent, by agent_acquire() or by holding
+ * the lock of gMgrDB.agents, while queuing.
+ */
+#ifndef NM_MGR_LOG_H_
+#define NM_MGR_LOG_H_
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "agents.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Default number of records which can wait for the writer
+#define MGR_LOG_DEF_QUEUE_LEN (4096)
+/// Size of the stdio buffer given to each open log file
+#define MGR_LOG_FILE_BUFSIZE (256 * 1024)
+/// Default interval between forced flushes, in milliseconds
+#define MGR_LOG_DEF_FLUSH_MS (1000)
+/// Number of rotated files which can wait for the compressor
+#define MGR_LOG_COMPRESS_QUEUE_LEN (256)
+
+/** Types of record handled by the log writer.
+ */
+typedef enum {
+  /// Append text to the log file of an agent
+  MGR_LOG_REC_TEXT,
+  /// Check or force log file rotation for an agent
+  MGR_LOG_REC_ROTATE,
+} mgr_log_rec_type_e;
+
+/** A single queued request to the log writer.
+ */
+typedef struct {
+  mgr_log_rec_type_e type;
+  /// The agent whose log file is affected, held until the record is handled
+  agent_t *agent;
+  /// Number of reports and tables in #text, counted against the rotation limit
+  int entries;
+  /// For MGR_LOG_REC_ROTATE, non-zero to rotate even below the limit
+  int force;
+  /// Length of #text in bytes
+  size_t len;
+  /// Owned heap text, released with free()
+  char *text;
+} mgr_log_rec_t;
+
+/** In-memory buffer used to format one record before it is queued.
+ * Formatting functions which take a FILE pointer can write to #fd.
+ */
+typedef struct {
+  FILE *fd;
+  char *text;
+  size_t len;
+} mgr_log_buf_t;
+
+/** Initialize the log writer state.
+ * @param capacity The maximum number of records waiting for the writer.
+ * @return AMP_OK if successful.
+ */
+int mgr_log_init(size_t capacity);
+
+/** Release writer state and any records not yet written.
+ * The writer thread must already have been joined.
+ */
+void mgr_log_destroy();
+
+/** Wake the writer thread, for example to notice a shutdown.
+ */
+void mgr_log_wake();
+
+/** Thread entry point for the log writer.
+ * The writer runs the compressor thread for as long as it runs itself.
+ * @param arg The ::nmmgr_t which owns this thread.
+ */
+void *mgr_log_thread(void *arg);
+
+/** Begin formatting a record in memory.
+ * @param[out] buf The buffer to open.
+ * @return AMP_OK if successful.
+ */
+int mgr_log_buf_open(mgr_log_buf_t *buf);
+
+/** Hand a formatted buffer to the writer.
+ * The buffer is closed and its text is owned by the writer afterward,
+ * whether or not it could be queued.
+ * @param buf The buffer previously opened with mgr_log_buf_open().
+ * @param agent The agent whose log receives the text.
+ * @param entries The number of reports and tables formatted into the buffer.
+ * @return AMP_OK if queued, AMP_FAIL if the record was dropped.
+ */
+int mgr_log_buf_commit(mgr_log_buf_t *buf, agent_t *agent, int entries);
+
+/** Queue a single formatted line for an agent log.
+ * @return AMP_OK if queued, AMP_FAIL if the record was dropped.
+ */
+int mgr_log_printf(agent_t *agent, const char *format, ...);
+
+/** Queue a rotation request for an agent log.
+ * @param agent The agent whose log file is rotated.
+ * @param force Non-zero to rotate regardless of the entry limit.
+ * @return AMP_OK if queued.
+ */
+int mgr_log_rotate(agent_t *agent, int force);
+
+/** Queue a rotated log file for the compressor thread.
+ * If too many files are waiting, this one is left uncompressed.
+ * @param path The closed log file to compress.
+ * @return AMP_OK if queued.
+ */
+int mgr_log_compress_later(const char *path);
+
+/** Compress a rotated log file to a ".gz" sibling and remove the original.
+ * This is called from the compressor thread, and blocks until done.
+ * @param path The closed log file to compress.
+ */
+void mgr_log_compress(const char *path);
+
+/** Get the number of records waiting for the writer.
+ */
+size_t mgr_log_backlog();
+
+/** Get the number of records dropped because the queue was full.
+ */
+uint64_t mgr_log_dropped();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NM_MGR_LOG_H_ */
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2023 The Johns Hopkins University Applied Physics
+ * Laboratory LLC.
+ *
+ * This file is part of the Delay-Tolerant Networking Management
+ * Architecture (DTNMA) Tools package.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <inttypes.h>
+#include <time.h>
+
+#include "shared/platform.h"
+#include "../shared/utils/utils.h"
+
+#include "nm_mgr_metrics.h"
+#include "nm_mgr_log.h"
+#include "agents.h"
+#include "nmmgr.h"
+
+mgr_metrics_t gMgrMetrics;
+
+/// Scale from microseconds to the seconds used by Prometheus
+#define METRICS_US_SCALE (1e-6)
+
+
+void mgr_metrics_hist_record(mgr_metrics_hist_t *hist, uint64_t val)
+{
+  // The smallest i with val <= 2^i
+  unsigned int idx = (val <= 1) ? 0 : 64 - __builtin_clzll(val - 1);
+
+  CHKVOID(hist);
+  if (idx < MGR_METRICS_HIST_BUCKETS)
+  {
+    MGR_METRICS_ADD(hist->buckets[idx], 1);
+  }
+  else
+  {
+    MGR_METRICS_ADD(hist->over, 1);
+  }
+  MGR_METRICS_ADD(hist->count, 1);
+  MGR_METRICS_ADD(hist->sum, val);
+}
+
+static uint64_t metrics_get(atomic_uint_fast64_t *ctr)
+{
+  return atomic_load_explicit(ctr, memory_order_relaxed);
+}
+
+static void metrics_family(mgr_fmt_t *fmt, const char *name, const char *type, const char *help)
+{
+  mgr_fmt_printf(fmt, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+static void metrics_value(mgr_fmt_t *fmt, const char *name, const char *type, const char *help, uint64_t val)
+{
+  metrics_family(fmt, name, type, help);
+  mgr_fmt_printf(fmt, "%s %" PRIu64 "\n", name, val);
+}
+
+/* Writes a label value, escaped as the exposition format requires. */
+static void metrics_label(mgr_fmt_t *fmt, const char *val)
+{
+  const char *start = val;
+
+  for (; *val != '\0'; ++val)
+  {
+    const char *esc = NULL;
+    switch (*val)
+    {
+      case '\\':
+        esc = "\\\\";
+        break;
+      case '"':
+        esc = "\\\"";
+        break;
+      case '\n':
+        esc = "\\n";
+        break;
+      default:
+        continue;
+    }
+    mgr_fmt_write(fmt, start, val - start);
+    mgr_fmt_puts(fmt, esc);
+    start = val + 1;
+  }
+  mgr_fmt_write(fmt, start, val - start);
+}
+
+/* Writes a histogram, scaling its bounds and sum by scale. Buckets are
+ * cumulative in the exposition format, so counts are summed while writing.
+ * Updates racing with this can make the buckets and count disagree slightly.
+ */
+static void metrics_hist(mgr_fmt_t *fmt, const char *name, const char *help, mgr_metrics_hist_t *hist, double scale)
+{
+  uint64_t cumul = 0;
+  int i;
+
+  metrics_family(fmt, name, "histogram", help);
+  for (i = 0; i < MGR_METRICS_HIST_BUCKETS; ++i)
+  {
+    cumul += metrics_get(&(hist->buckets[i]));
+    mgr_fmt_printf(fmt, "%s_bucket{le=\"%.9g\"} %" PRIu64 "\n", name, (double)(1ULL << i) * scale, cumul);
+  }
+  cumul += metrics_get(&(hist->over));
+  mgr_fmt_printf(fmt, "%s_bucket{le=\"+Inf\"} %" PRIu64 "\n", name, cumul);
+  mgr_fmt_printf(fmt, "%s_sum %.9g\n", name, (double)metrics_get(&(hist->sum)) * scale);
+  mgr_fmt_printf(fmt, "%s_count %" PRIu64 "\n", name, cumul);
+}
+
+/* Writes one family with a sample for each agent. */
+static void metrics_agents(mgr_fmt_t *fmt, const char *name, const char *type, const char *help, uint64_t (*get)(agent_t *))
+{
+  vecit_t it;
+
+  metrics_family(fmt, name, type, help);
+  for (it = vecit_first(&(gMgrDB.agents)); vecit_valid(it); it = vecit_next(it))
+  {
+    agent_t *agent = vecit_data(it);
+    if (agent == NULL)
+    {
+      continue;
+    }
+    mgr_fmt_printf(fmt, "%s{agent=\"", name);
+    metrics_label(fmt, agent->eid.name);
+    mgr_fmt_printf(fmt, "\"} %" PRIu64 "\n", get(agent));
+  }
+}
+
+static uint64_t metrics_agent_rx_rpts(agent_t *agent)
+{
+  return metrics_get(&(agent->rx_rpts));
+}
+
+static uint64_t metrics_agent_rx_tbls(agent_t *agent)
+{
+  return metrics_get(&(agent->rx_tbls));
+}
+
+static uint64_t metrics_agent_rpts(agent_t *agent)
+{
+  return vec_num_entries(agent->rpts);
+}
+
+static uint64_t metrics_agent_tbls(agent_t *agent)
+{
+  return vec_num_entries(agent->tbls);
+}
+
+void mgr_metrics_write(mgr_fmt_t *fmt)
+{
+  CHKVOID(fmt);
+
+  metrics_value(fmt, "nm_mgr_rx_groups_total", "counter",
+                "Message groups received.", metrics_get(&(gMgrMetrics.rx_groups)));
+  metrics_value(fmt, "nm_mgr_rx_bytes_total", "counter",
+                "Bytes of message groups received.", metrics_get(&(gMgrMetrics.rx_bytes)));
+  metrics_value(fmt, "nm_mgr_rx_invalid_groups_total", "counter",
+                "Message groups discarded because they failed to decode.", metrics_get(&(gMgrMetrics.rx_invalid)));
+  metrics_value(fmt, "nm_mgr_rx_dropped_total", "counter",
+                "Reports and tables discarded on receipt.", metrics_get(&(gMgrMetrics.rx_dropped)));
+  metrics_value(fmt, "nm_mgr_evicted_total", "counter",
+                "Reports and tables cleared after being stored.", metrics_get(&(gMgrMetrics.evicted)));
+  metrics_hist(fmt, "nm_mgr_rx_decode_seconds",
+               "Time to decode a message group.", &(gMgrMetrics.decode_us), METRICS_US_SCALE);
+
+  metrics_value(fmt, "nm_mgr_stored_reports", "gauge",
+                "Reports held for all agents.", gMgrDB.tot_rpts);
+  metrics_value(fmt, "nm_mgr_stored_tables", "gauge",
+                "Tables held for all agents.", gMgrDB.tot_tbls);
+
+  vec_lock(&(gMgrDB.agents));
+  metrics_value(fmt, "nm_mgr_agents", "gauge",
+                "Known agents.", vec_num_entries(gMgrDB.agents));
+  metrics_agents(fmt, "nm_mgr_agent_rx_reports_total", "counter",
+                 "Reports received from an agent.", metrics_agent_rx_rpts);
+  metrics_agents(fmt, "nm_mgr_agent_rx_tables_total", "counter",
+                 "Tables received from an agent.", metrics_agent_rx_tbls);
+  metrics_agents(fmt, "nm_mgr_agent_stored_reports", "gauge",
+                 "Reports held for an agent.", metrics_agent_rpts);
+  metrics_agents(fmt, "nm_mgr_agent_stored_tables", "gauge",
+                 "Tables held for an agent.", metrics_agent_tbls);
+  vec_unlock(&(gMgrDB.agents));
+
+  metrics_hist(fmt, "nm_mgr_sql_insert_seconds",
+               "Time to insert and commit a message group.", &(gMgrMetrics.sql_insert_us), METRICS_US_SCALE);
+  metrics_hist(fmt, "nm_mgr_sql_batch_size",
+               "Reports and tables inserted per transaction.", &(gMgrMetrics.sql_batch), 1);
+
+  metrics_value(fmt, "nm_mgr_log_backlog", "gauge",
+                "Records waiting for the log writer.", mgr_log_backlog());
+  metrics_value(fmt, "nm_mgr_log_dropped_total", "counter",
+                "Log records dropped because the writer queue was full.", mgr_log_dropped());
+
+  metrics_hist(fmt, "nm_mgr_rest_request_seconds",
+               "Time to handle a REST request.", &(gMgrMetrics.rest_us), METRICS_US_SCALE);
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2023 The Johns Hopkins University Applied Physics
+ * Laboratory LLC.
+ *
+ * This file is part of the Delay-Tolerant Networking Management
+ * Architecture (DTNMA) Tools package.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/** @file
+ * Counters and histograms describing the manager's own ingest pipeline.
+ *
+ * Every metric is a relaxed atomic, so the receive thread, the log writer
+ * and REST workers update them without locks. They are read all at once in
+ * the Prometheus text exposition format, where rates such as groups received
+ * per second are derived from the counters by the scraper.
+ */
+#ifndef NM_MGR_METRICS_H_
+#define NM_MGR_METRICS_H_
+
+#include <stdint.h>
+#include <stdatomic.h>
+
+#include "nm_mgr_fmt.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Number of finite buckets in a histogram.
+ * Bucket i counts values up to 2^i, so microsecond histograms reach about
+ * two minutes before falling into the overflow bucket.
+ */
+#define MGR_METRICS_HIST_BUCKETS (28)
+
+/** A histogram with power-of-two bucket bounds.
+ */
+typedef struct {
+  atomic_uint_fast64_t buckets[MGR_METRICS_HIST_BUCKETS];
+  /// Values larger than the last bucket bound
+  atomic_uint_fast64_t over;
+  atomic_uint_fast64_t count;
+  atomic_uint_fast64_t sum;
+} mgr_metrics_hist_t;
+
+/** All manager-wide metrics.
+ * Per-agent counts are kept in each ::agent_t.
+ */
+typedef struct {
+  /// Message groups received, whether or not they decoded
+  atomic_uint_fast64_t rx_groups;
+  /// Bytes of message groups received
+  atomic_uint_fast64_t rx_bytes;
+  /// Message groups discarded because they failed to decode
+  atomic_uint_fast64_t rx_invalid;
+  /// Reports and tables discarded on receipt
+  atomic_uint_fast64_t rx_dropped;
+  /// Reports and tables cleared from agents after being stored
+  atomic_uint_fast64_t evicted;
+
+  /// Time to decode each message group and its messages
+  mgr_metrics_hist_t decode_us;
+  /// Time to insert each message group into the database and commit it
+  mgr_metrics_hist_t sql_insert_us;
+  /// Reports and tables inserted in each database transaction
+  mgr_metrics_hist_t sql_batch;
+  /// Time to handle each REST request
+  mgr_metrics_hist_t rest_us;
+} mgr_metrics_t;
+
+extern mgr_metrics_t gMgrMetrics;
+
+/// Add to one of the counters in ::gMgrMetrics or an ::agent_t
+#define MGR_METRICS_ADD(ctr, val) atomic_fetch_add_explicit(&(ctr), (val), memory_order_relaxed)
+
+/** Record one value in a histogram.
+ * @param hist The histogram to update.
+ * @param val The value, in the units of the histogram.
+ */
+void mgr_metrics_hist_record(mgr_metrics_hist_t *hist, uint64_t val);
+
+/** Write all metrics in the Prometheus text exposition format.
+ * @param fmt The formatter to write to.
+ */
+void mgr_metrics_write(mgr_fmt_t *fmt);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NM_MGR_METRICS_H_ */
@@ -40,12 +40,7 @@
 #include "agents.h"
 #include "ui_input.h"
 
-#ifdef USE_JSON
-
-// JSON Prototypes (TODO: Move to header and/or discrete file)
-cJSON* ui_json_from_tnvc(tnvc_t *tnvc);
-cJSON *ui_json_from_tnv(tnv_t *tnv);
-#endif
+#include "nm_mgr_fmt.h"
 
 #include "../shared/utils/utils.h"
 #include "../shared/primitives/blob.h"
@@ -68,7 +63,6 @@ ui_menu_list_t agent_submenu_list[] = {
 };
 
 static int ui_print_agents_cb_parse(int idx, int keypress, void* data, char* status_msg);
-static void ui_print_report_entry(ui_print_cfg_t *fd, char *name, tnv_t *val);
 
 /******************************************************************************
  *
@@ -287,450 +281,57 @@ int ui_print_agents()
 }
 
 #ifdef USE_JSON
-/* Convert a TBL into cJSON */
-cJSON* ui_json_table(tbl_t *tbl)
-{
-   size_t num_rows;
-   tblt_t *tblt;
-   vecit_t it;
-   cJSON *out_tbl;
-   
-   CHKNULL(tbl);
-   
-   tblt = VDB_FINDKEY_TBLT(tbl->id);
-   CHKNULL(tblt);
-
-   out_tbl = cJSON_CreateObject();
-
-   /* Add the table name to the JSON table */
-   char *tbl_name = ui_str_from_ari(tbl->id, NULL, 0);
-   cJSON_AddStringToObject(out_tbl, "table name", (tbl_name == NULL) ? "Unknown" : tbl_name);
-   SRELEASE(tbl_name);
-      
-   cJSON *cols = cJSON_AddArrayToObject(out_tbl, "cols");
-   cJSON *rows = cJSON_AddArrayToObject(out_tbl, "rows");
-
-   // Build Columns Description
-   for(it = vecit_first(&tblt->cols); vecit_valid(it); it = vecit_next(it))
-   {
-      tblt_col_t *col = (tblt_col_t*) vecit_data(it);
-      cJSON *jcol = cJSON_CreateObject();
-      
-      if (col != NULL) {
-         cJSON_AddStringToObject(jcol, "name", col->name);
-         cJSON_AddStringToObject(jcol, "type", type_to_str(col->type) );
-      } // Else we add an empty object
-      cJSON_AddItemToArray(cols, jcol);
-   }
-
-   // For each row (if there are no rows, we will return an empty array)
-   num_rows = tbl_num_rows(tbl);
-   for(int i = 0; i < num_rows; i++)
-   {
-      	tnvc_t *cur_row = tbl_get_row(tbl, i);
-        cJSON *obj = cJSON_CreateArray();
-        vecit_t it;
-        int j;
-
-        // For each column; Simultaneously iterate on data col and title columns
-        for(j = 0; j < tnvc_get_count(cur_row); j++)
-        {
-           tnv_t *val = tnvc_get(cur_row, j);
-
-           cJSON_AddItemToArray(obj,
-                                 ui_json_from_tnv(val)
-              );
-        }
-
-        cJSON_AddItemToArray(rows, obj);
-   }
-   
-   
-   return out_tbl;
-}
-
 void ui_fprint_json_table(ui_print_cfg_t *fd, tbl_t *table)
 {
+   mgr_fmt_t fmt;
 
-  /* Step 1: Print the table name */
-  char *tbl_name = ui_str_from_ari(table->id, NULL, 0);
-  ui_fprintf(fd, "\nTable Name: %s \n", (tbl_name == NULL) ? "Unknown" : tbl_name);
-  SRELEASE(tbl_name);
-
-  /* Step 2: Print table contents */
+   CHKVOID(table);
 
-  cJSON *json = ui_json_table(table);
-   if (json == NULL)
-   {
-      return;
-   }
-   else
-   {
-      char *str = cJSON_Print(json);
-      ui_fprintf(fd, str);
-      cJSON_free(str);
-      cJSON_Delete(json);
-   }
+   mgr_fmt_init_sink(&fmt, fd);
+   mgr_fmt_puts(&fmt, "\nTable Name: ");
+   mgr_fmt_ari(&fmt, table->id, NULL, 0);
+   mgr_fmt_puts(&fmt, " \n");
+   mgr_fmt_table_json(&fmt, table);
+   mgr_fmt_finish(&fmt);
 }
-
 #endif
 
 void ui_fprint_table(ui_print_cfg_t *fd, tbl_t *tbl)
 {
+   mgr_fmt_t fmt;
 
-  /* Step 1: Print the table name */
-  char *tbl_name = ui_str_from_ari(tbl->id, NULL, 0);
-  ui_fprintf(fd, "\nTable Name: %s \n", (tbl_name == NULL) ? "Unknown" : tbl_name);
-  SRELEASE(tbl_name);
+   CHKVOID(tbl);
 
-  /* Step 2: Print table contents */
-  char *tmp = ui_str_from_tbl(tbl);
-   if (tmp != NULL) {
-      ui_fprintf(fd,"%s\n", tmp);
-      SRELEASE(tmp);
-   }
-   else
-   {
-      ui_fprintf(fd, "***ERROR: Unable to prepare Table for output\n");
-   }
+   mgr_fmt_init_sink(&fmt, fd);
+   mgr_fmt_table(&fmt, tbl);
+   mgr_fmt_finish(&fmt);
 }
 
 void ui_fprint_report(ui_print_cfg_t *fd, rpt_t *rpt)
 {
-	int num_entries = 0;
-	tnv_t *val = NULL;
-	char name[META_NAME_MAX+3];
-	metadata_t *rpt_info = NULL;
-	metadata_t *entry_info = NULL;
-
-	if((rpt == NULL) || (rpt->id == NULL))
-	{
-		return;
-	}
-
-	/* Step 1: Print the report banner. This will include the report
-	 *         name.
-	 */
-	rpt_info = rhht_retrieve_key(&(gMgrDB.metadata), rpt->id);
-    num_entries = tnvc_get_count(rpt->entries);
-
-    ui_fprintf(fd,"\n----------------------------------------");
-    ui_fprintf(fd,"\n             AMP DATA REPORT            ");
-    ui_fprintf(fd,"\n----------------------------------------");
-    ui_fprintf(fd,"\nSent to   : %s", rpt->recipient.name);
-
-    if(rpt_info == NULL)
-    {
-    	char *rpt_str = ui_str_from_ari(rpt->id, NULL, 0);
-        ui_fprintf(fd,"\nRpt Name  : %s", (rpt_str == NULL) ? "Unknown" : rpt_str);
-        SRELEASE(rpt_str);
-    }
-    else
-    {
-    	if(vec_num_entries(rpt->id->as_reg.parms.values) > 0)
-    	{
-    		char *parm_str = ui_str_from_tnvc(&(rpt->id->as_reg.parms));
-    		ui_fprintf(fd,"\nRpt Name  : %s(%s)", rpt_info->name, (parm_str == NULL) ? "" : parm_str);
-    		SRELEASE(parm_str);
-    	}
-    	else
-    	{
-    		ui_fprintf(fd,"\nRpt Name  : %s", rpt_info->name);
-    	}
-    }
-    time_t secs = OS_TimeGetTotalSeconds(rpt->time);
-    ui_fprintf(fd,"\nTimestamp : %s", ctime(&secs));
-    ui_fprintf(fd,"\n# Entries : %d", num_entries);
-    ui_fprintf(fd,"\n----------------------------------------\n");
-
-
-    /* Step 2: Print individual entries, based on type. */
-
-	if(rpt->id->type == AMP_TYPE_RPTTPL)
-	{
-		int i = 0;
-		rpttpl_t *tpl = VDB_FINDKEY_RPTT(rpt->id);
-
-		if((tpl != NULL) && (ac_get_count(&(tpl->contents)) != num_entries))
-		{
-			AMP_DEBUG_ERR("ui_print_report",
-					      "Template mismatch. Expected %d entries but have %d. Not using template.",
-						  ac_get_count(&(tpl->contents)),
-						  num_entries);
-			tpl = NULL;
-		}
-
-		for(i = 0; i < num_entries; i++)
-		{
-			ari_t *entry_id = (tpl == NULL) ? NULL : ac_get(&(tpl->contents), i);
-			entry_info = (entry_id == NULL) ? NULL : rhht_retrieve_key(&(gMgrDB.metadata), entry_id);
-			val = tnvc_get(rpt->entries, i);
-
-			if(entry_info == NULL)
-			{
-				sprintf(name, "Entry %d", i);
-			}
-			else
-			{
-				tnvc_t *parms = ari_resolve_parms(&(entry_id->as_reg.parms), &(rpt->id->as_reg.parms));
-				char *parm_str = NULL;
-
-				if(parms != NULL)
-				{
-					if(vec_num_entries(parms->values) > 0)
-					{
-						parm_str = ui_str_from_tnvc(parms);
-					}
-					tnvc_release(parms, 1);
-				}
-
-				if(parm_str != NULL)
-				{
-                   if(snprintf(name, sizeof(name),"%s(%s)", entry_info->name, parm_str) < 0) {
-                      snprintf(name, sizeof(name), "%s(.)", entry_info->name);
-                   }
-					SRELEASE(parm_str);
-				}
-				else
-				{
-                   strncpy(name, entry_info->name, sizeof(name));
-				}
-			}
-
-			ui_print_report_entry(fd, name, val);
-			ui_fprintf(fd,"\n");
-		}
-	}
-	else if(rpt->id->type == AMP_TYPE_TBLT)
-	{
-		int i = 0;
-		vecit_t it;
-		tbl_t *tbl = NULL;
-
-		for(i = 0; i < num_entries; i++)
-		{
-			val = tnvc_get(rpt->entries, i);
-			if(val->type == AMP_TYPE_TBL)
-			{
-				tbl = (tbl_t *) val->value.as_ptr;
-                ui_fprint_table(fd, tbl);
-			}
-		}
-	}
-	else
-	{
-		if(rpt_info == NULL)
-		{
-			sprintf(name, "Entry 1");
-		}
-		else
-		{
-			sprintf(name, "%.30s", rpt_info->name);
-		}
+   mgr_fmt_t fmt;
 
-		val = tnvc_get(rpt->entries, 0);
-
-		ui_print_report_entry(fd, name, val);
-		ui_fprintf(fd,"\n");
-	}
-
-
-	/* Step 3: Print report trailer. */
-    ui_fprintf(fd,"\n----------------------------------------\n\n");
+   mgr_fmt_init_sink(&fmt, fd);
+   mgr_fmt_report(&fmt, rpt);
+   mgr_fmt_finish(&fmt);
 }
 
 #ifdef USE_JSON
-/** Output a report in JSON format
- * @returns A cJSON object representing the given report.  
- *   Caller is responsible for freeing with cJSON_Delete
- */
-cJSON* ui_json_report(rpt_t *rpt)
-{
-	int num_entries = 0;
-	tnv_t *val = NULL;
-	char name[META_NAME_MAX+3];
-	metadata_t *rpt_info = NULL;
-	metadata_t *entry_info = NULL;
-    cJSON *rtv = cJSON_CreateObject();
-
-	if((rtv == NULL || rpt == NULL) || (rpt->id == NULL))
-	{
-		return NULL;
-	}
-
-	/* Step 1: Print the report banner. This will include the report
-	 *         name.
-	 */
-	rpt_info = rhht_retrieve_key(&(gMgrDB.metadata), rpt->id);
-    num_entries = tnvc_get_count(rpt->entries);
-
-    cJSON_AddNumberToObject(rtv, "num_entries", num_entries);
-    cJSON_AddStringToObject(rtv, "recipient_name", rpt->recipient.name);
-
-    if(rpt_info == NULL)
-    {
-    	char *rpt_str = ui_str_from_ari(rpt->id, NULL, 0);
-        cJSON_AddStringToObject(rtv, "name", (rpt_str == NULL) ? "Unknown" : rpt_str);
-        SRELEASE(rpt_str);
-    }
-    else
-    {
-       cJSON_AddStringToObject(rtv, "name", rpt_info->name);                                       
-
-       if(vec_num_entries(rpt->id->as_reg.parms.values) > 0)
-       {
-          cJSON* obj = ui_json_from_tnvc(&(rpt->id->as_reg.parms));
-          if (obj != NULL) {
-             cJSON_AddItemToObject(rtv,
-                                "arguments",
-                                   obj);
-          }
-       }
-    }
-    time_t secs = OS_TimeGetTotalSeconds(rpt->time);
-    cJSON_AddStringToObject(rtv, "timestamp", ctime(&secs));
-
-    /* Step 2: Print individual entries, based on type. */
-	if(rpt->id->type == AMP_TYPE_RPTTPL)
-	{
-		int i = 0;
-		rpttpl_t *tpl = VDB_FINDKEY_RPTT(rpt->id);
-        cJSON *entries = cJSON_AddObjectToObject(rtv, "entries");
-        cJSON_AddStringToObject(rtv, "type", "rpttpl");
-
-		if((tpl != NULL) && (ac_get_count(&(tpl->contents)) != num_entries))
-		{
-			AMP_DEBUG_ERR("ui_print_report",
-					      "Template mismatch. Expected %d entries but have %d. Not using template.",
-						  ac_get_count(&(tpl->contents)),
-						  num_entries);
-			tpl = NULL;
-		}
-
-
-		for(i = 0; i < num_entries; i++)
-		{
-			ari_t *entry_id = (tpl == NULL) ? NULL : ac_get(&(tpl->contents), i);
-			entry_info = (entry_id == NULL) ? NULL : rhht_retrieve_key(&(gMgrDB.metadata), entry_id);
-			val = tnvc_get(rpt->entries, i);
-            
-			if(entry_info == NULL)
-			{
-				sprintf(name, "Entry %d", i);
-			}
-			else
-			{
-				tnvc_t *parms = ari_resolve_parms(&(entry_id->as_reg.parms), &(rpt->id->as_reg.parms));
-				char *parm_str = NULL;
-
-				if(parms != NULL)
-				{
-					if(vec_num_entries(parms->values) > 0)
-					{
-						parm_str = ui_str_from_tnvc(parms);
-					}
-					tnvc_release(parms, 1);
-				}
-
-				if(parm_str != NULL)
-				{
-                   if(snprintf(name, sizeof(name),"%s(%s)", entry_info->name, parm_str) < 0) {
-                      snprintf(name, sizeof(name), "%s(.)", entry_info->name);
-                   }
-					SRELEASE(parm_str);
-				}
-				else
-				{
-                   strncpy(name, entry_info->name, sizeof(name));
-				}
-			}
-
-            cJSON_AddItemToObject(entries, name, ui_json_from_tnv(val));
-		}
-        
-	}
-	else if(rpt->id->type == AMP_TYPE_TBLT)
-	{
-		int i = 0;
-		vecit_t it;
-		tbl_t *tbl = NULL;
-        cJSON *entries = cJSON_AddArrayToObject(rtv, "entries");
-                cJSON_AddStringToObject(rtv, "type", "tblt");
-		for(i = 0; i < num_entries; i++)
-		{
-			val = tnvc_get(rpt->entries, i);
-			if(val->type == AMP_TYPE_TBL)
-			{
-				tbl = (tbl_t *) val->value.as_ptr;
-                cJSON_AddItemToObject(rtv, "table", ui_json_table(tbl));                
-			}
-		}
-	}
-	else
-	{
-       cJSON *entries = cJSON_AddArrayToObject(rtv, "entries");
-       cJSON_AddStringToObject(rtv, "type", "unknown");
-       
-		if(rpt_info == NULL)
-		{
-           cJSON_AddItemToObject(entries,
-                                 "(Entry 1)",
-                                 ui_json_from_tnvc(rpt->entries)
-           );
-		}
-		else
-		{
-           cJSON_AddItemToObject(entries,
-                                 rpt_info->name,
-                                 ui_json_from_tnvc(rpt->entries)
-           );
-		}
-	}
-
-
-	/* Step 3: Add report to object */
-    return rtv;
-}
-
 void ui_fprint_json_report(ui_print_cfg_t *fd, rpt_t *rpt)
 {
-   cJSON *json = ui_json_report(rpt);
-   if (json == NULL)
+   mgr_fmt_t fmt;
+
+   if((rpt == NULL) || (rpt->id == NULL))
    {
       return;
    }
-   else
-   {
-      char *str = cJSON_Print(json);
-      ui_fprintf(fd, str);
-      ui_fprintf(fd, "\n");
-      cJSON_free(str);
-      cJSON_Delete(json);
-   }
-}
-#endif
-
 
-static void ui_print_report_entry(ui_print_cfg_t *fd, char *name, tnv_t *val)
-{
-	if(val == NULL)
-	{
-		ui_fprintf(fd,"%s: null", name);
-		return;
-	}
-
-	char *str = ui_str_from_tnv(val);
-	if(name)
-	{
-		ui_fprintf(fd,"%s : %s", name, (str == NULL) ? "null" : str);
-	}
-	else
-	{
-		ui_fprintf(fd,"%s", (str == NULL) ? "null" : str);
-	}
-
-	SRELEASE(str);
+   mgr_fmt_init_sink(&fmt, fd);
+   mgr_fmt_report_json(&fmt, rpt);
+   mgr_fmt_puts(&fmt, "\n");
+   mgr_fmt_finish(&fmt);
 }
+#endif
 
 /******************************************************************************
  *
@@ -813,610 +414,119 @@ void ui_print_table_set(agent_t* agent)
 
 }
 
+/*
+ * The string forms below are kept for callers which need a value as a string;
+ * they format through nm_mgr_fmt.h. The caller MUST release the result.
+ */
+#define UI_STR_FROM(call) \
+	do { \
+		mgr_fmt_t buf; \
+		mgr_fmt_t *fmt = &buf; \
+		mgr_fmt_init_buf(fmt); \
+		call; \
+		return mgr_fmt_take(fmt); \
+	} while(0)
 
 char *ui_str_from_ac(ac_t *ac)
 {
-	char *str = STAKE(1024);
-	vecit_t it;
-
-	for(it = vecit_first(&(ac->values)); vecit_valid(it); it = vecit_next(it))
-	{
-		ari_t *id = (ari_t*) vecit_data(it);
-		char *alt_str = ui_str_from_ari(id, NULL, 0);
-		strcat(str, (alt_str==NULL) ? "null" : alt_str);
-		strcat(str, " ");
-		SRELEASE(alt_str);
-	}
-
-	return str;
+	CHKNULL(ac);
+	UI_STR_FROM(mgr_fmt_ac(fmt, ac));
 }
 
 char *ui_str_from_ari(ari_t *id, tnvc_t *ap, int desc)
 {
-	metadata_t *meta = NULL;
-	ari_t *print_id = NULL;
-	char *str = STAKE(1024);
-
-	CHKNULL(str);
-
-	if(id == NULL)
-	{
-		strcat(str,"null");
-		return str;
-	}
-
-	if(id->type == AMP_TYPE_LIT)
-	{
-		SRELEASE(str);
-		return ui_str_from_tnv(&(id->as_lit));
-	}
-
-	meta = rhht_retrieve_key(&(gMgrDB.metadata), id);
-
-	if(ap != NULL)
-	{
-		print_id = ari_copy_ptr(id);
-		ari_replace_parms(print_id, ap);
-	}
-	else
-	{
-		print_id = id;
-	}
-
-	if(meta == NULL)
-	{
-		blob_t *blob = ari_serialize_wrapper(print_id);
-
-		if(blob != NULL)
-		{
-			char *nm_str = utils_hex_to_string(blob->value, blob->length);
-			blob_release(blob, 1);
-			sprintf(str, "Anonymous ARI: %s", nm_str);
-			SRELEASE(nm_str);
-		}
-		else
-		{
-			sprintf(str, "NULL ARI");
-		}
-	}
-	else
-	{
-		char *parm_str = NULL;
-
-		/* If we have actual parameters, print those. */
-		if(ap != NULL)
-		{
-			parm_str = ui_str_from_tnvc(ap);
-		}
-		else if (vec_num_entries(meta->parmspec) > 0)
-		{
-			parm_str = ui_str_from_fp(meta);
-		}
-
-		if(parm_str != NULL)
-		{
-			sprintf(str,"%s(%s)", meta->name, parm_str);
-			SRELEASE(parm_str);
-		}
-		else
-		{
-			sprintf(str,"%s", meta->name);
-		}
-
-		if(desc)
-		{
-			strcat(str,"\t: ");
-			strcat(str,meta->descr);
-		}
-	}
-
-	if(print_id != id)
-	{
-		ari_release(print_id, 1);
-	}
-
-	return str;
+	UI_STR_FROM(mgr_fmt_ari(fmt, id, ap, desc));
 }
 
-
 char *ui_str_from_blob(blob_t *blob)
 {
 	CHKNULL(blob);
 	return utils_hex_to_string(blob->value, blob->length);
 }
 
-
 char *ui_str_from_ctrl(ctrl_t *ctrl)
 {
+	CHKNULL(ctrl);
 	return ui_str_from_ari(ctrl->def.as_ctrl->ari, ctrl->parms, 0);
 }
 
-
 char *ui_str_from_edd(edd_t *edd)
 {
+	CHKNULL(edd);
 	return ui_str_from_ari(edd->def.id, edd->parms, 0);
 }
 
 char *ui_str_from_expr(expr_t *expr)
 {
-	char *str = STAKE(1024);
 	CHKNULL(expr);
-	CHKNULL(str);
-
-	char *alt_str = ui_str_from_ac(&(expr->rpn));
-	snprintf(str, 1023, "EXPR: (%s) %s", type_to_str(expr->type), (alt_str == NULL) ? "null" : alt_str);
-	SRELEASE(alt_str);
-	return str;
+	UI_STR_FROM(mgr_fmt_expr(fmt, expr));
 }
 
-
 char *ui_str_from_fp(metadata_t *meta)
 {
-	char *str = STAKE(1024);
-	CHKNULL(str);
-
-    vecit_t itp;
-    int j = 0;
-
-    strcat(str, "(");
-
-    for(j=0, itp = vecit_first(&(meta->parmspec)); vecit_valid(itp); itp = vecit_next(itp), j++)
-    {
-    	meta_fp_t *parm = (meta_fp_t *) vecit_data(itp);
-    	if(j != 0)
-    	{
-    		strcat(str, ",");
-    	}
-    	if(parm == NULL)
-    	{
-    		strcat(str, "? ?");
-    	}
-    	else
-    	{
-    		strcat(str, type_to_str(parm->type));
-    		strcat(str, " ");
-    		strcat(str, parm->name);
-    	}
-    }
-
-    strcat(str, ")");
-
-	return str;
+	CHKNULL(meta);
+	UI_STR_FROM(mgr_fmt_fp(fmt, meta));
 }
 
 char *ui_str_from_mac(macdef_t *mac)
 {
-	char *result = STAKE(4096);
-	char fmt[1024];
-	char *tmp = NULL;
-	int i = 0;
-	vecit_t it;
-
-	tmp = ui_str_from_ari(mac->ari, NULL, 0);
-	sprintf(fmt,"%s = [", (tmp==NULL) ? "null" : tmp);
-	SRELEASE(tmp);
-
-	strcat(result, fmt);
-
-	for(it = vecit_first(&(mac->ctrls)); vecit_valid(it); it = vecit_next(it))
-	{
-		ctrl_t *cur_ctrl = (ctrl_t*) vecit_data(it);
-		tmp = ui_str_from_ctrl(cur_ctrl);
-		if(i != 0)
-		{
-			strcat(result,", ");
-		}
-		strcat(result, tmp);
-		SRELEASE(tmp);
-		i++;
-	}
-
-	strcat(result, "]");
-
-	return result;
+	CHKNULL(mac);
+	UI_STR_FROM(mgr_fmt_mac(fmt, mac));
 }
 
 char *ui_str_from_op(op_t *op)
 {
+	CHKNULL(op);
 	return ui_str_from_ari(op->id, NULL, 0);
 }
 
 char *ui_str_from_rpt(rpt_t *rpt)
 {
-// TODO
-	return NULL;
+	CHKNULL(rpt);
+	UI_STR_FROM(mgr_fmt_report(fmt, rpt));
 }
 
 char *ui_str_from_rpttpl(rpttpl_t *rpttpl)
 {
-	char *result = STAKE(4096);
-	char fmt[1024];
-	char *tmp = NULL;
-	int num = 0;
-	int i = 0;
-
-	tmp = ui_str_from_ari(rpttpl->id, NULL, 0);
-	sprintf(fmt,"%s = [", (tmp==NULL) ? "null" : tmp);
-	SRELEASE(tmp);
-
-	strcat(result, fmt);
-
-	num = ac_get_count(&(rpttpl->contents));
-	for(i = 0; i < num; i++)
-	{
-		ari_t *cur_ari = ac_get(&(rpttpl->contents), i);
-		tmp = ui_str_from_ari(cur_ari, NULL, 0);
-		if(i != 0)
-		{
-			strcat(result,", ");
-		}
-		strcat(result, tmp);
-		SRELEASE(tmp);
-	}
-	strcat(result, "]");
-
-	return result;
+	CHKNULL(rpttpl);
+	UI_STR_FROM(mgr_fmt_rpttpl(fmt, rpttpl));
 }
 
 char *ui_str_from_sbr(rule_t *sbr)
 {
-	char *str = STAKE(1024);
-
-	if(str != NULL) {
-		char *id_str = ui_str_from_ari(&(sbr->id), NULL, 0);
-		char *ac_str = ui_str_from_ac(&(sbr->action));
-		char *expr_str = ui_str_from_expr(&(sbr->def.as_sbr.expr));
-
-		snprintf(str,
-				1023,
-				"SBR: ID=%s, S=%"PRId64", E=%s, M=%"PRId64", C=%"PRId64", A=%s\n",
-				(id_str == NULL) ? "null" :id_str,
-				OS_TimeGetTotalSeconds(sbr->start),
-				(expr_str == NULL) ? "null" : expr_str,
-				sbr->def.as_sbr.max_eval,
-				sbr->def.as_sbr.max_fire,
-				(ac_str == NULL) ? "null" : ac_str);
-
-		SRELEASE(id_str);
-		SRELEASE(ac_str);
-		SRELEASE(expr_str);
-	}
-	return str;
+	CHKNULL(sbr);
+	UI_STR_FROM(mgr_fmt_sbr(fmt, sbr));
 }
 
 char *ui_str_from_tbl(tbl_t *tbl)
 {
-	char *result = STAKE(8192); // todo dynamically size this.
-	char fmt[100];
-	vecit_t it;
-	int i, j;
-	size_t num_rows = 0;
-	tnvc_t *cur_row = NULL;
-	tblt_t *tblt = VDB_FINDKEY_TBLT(tbl->id);
-	char *tmp = NULL;
-
-	CHKNULL(result);
-
-	/* Print table headers, if we have a table template. */
-	if((tmp = ui_str_from_tblt(tblt)) == NULL)
-	{
-		SRELEASE(result);
-		return NULL;
-	}
-
-	strcat(result, tmp);
-	SRELEASE(tmp);
-	
-	num_rows = tbl_num_rows(tbl);
-
-	strcat(result, "----------------------------------------------------------------------\n");
-
-	/* For each row */
-	for(i = 0; i < num_rows; i++)
-	{
-		cur_row = tbl_get_row(tbl, i);
-		
-		for(j = 0; j < tnvc_get_count(cur_row); j++)
-		{
-		  tnv_t *val = tnvc_get(cur_row, j);
-			if(j == 0)
-			{
-				strcat(result, "|");
-			}
-			char *tmp = ui_str_from_tnv(val);
-			snprintf(fmt,100,"   %23s   ", tmp);
-			SRELEASE(tmp);
-			strcat(result, fmt);
-			strcat(result, "|");
-		}
-		strcat(result, "\n");
-	}
-	strcat(result, "----------------------------------------------------------------------\n");
-
-	return result;
-}
-
-// TODO
-#if 0 //def USE_JSON
-
-void ui_json_from_tbl(cJSON *obj, tbl_t *tbl)
-{
-	char fmt[100];
-	vecit_t it;
-	int i, j;
-	size_t num_rows = 0;
-	tnvc_t *cur_row = NULL;
-	tblt_t *tblt = VDB_FINDKEY_TBLT(tbl->id);
-	char *tmp = NULL;
-
-	CHKVOID(obj);
-	CHKVOID(tbl);
-
-	/* Print table headers, if we have a table template. */
-	if((tmp = ui_str_from_tblt(tblt)) == NULL)
-	{
-		return;
-	}
-	strcat(result, tmp);
-	SRELEASE(tmp);
-
-	num_rows = tbl_num_rows(tbl);
-
-	strcat(result, "----------------------------------------------------------------------\n");
-
-	/* For each row */
-	for(i = 0; i < num_rows; i++)
-	{
-		cur_row = tbl_get_row(tbl, i);
-
-		for(j = 0; j < tnvc_get_count(cur_row); j++)
-		{
-			tnv_t *val = tnvc_get(cur_row, j);
-			if(j == 0)
-			{
-				strcat(result, "|");
-			}
-			char *tmp = ui_str_from_tnv(val);
-			snprintf(fmt,100,"   %23s   ", tmp);
-			SRELEASE(tmp);
-			strcat(result, fmt);
-			strcat(result, "|");
-		}
-		strcat(result, "\n");
-	}
-	strcat(result, "----------------------------------------------------------------------\n");
-
-	return result;
+	CHKNULL(tbl);
+	UI_STR_FROM(mgr_fmt_tbl(fmt, tbl));
 }
-#endif
 
 char *ui_str_from_tblt(tblt_t *tblt)
 {
-	char *result = STAKE(1024);
-	int i = 0;
-	vecit_t it;
-
-	CHKNULL(result);
-
-	if(tblt != NULL)
-	{
-		i = 0;
-		strcat(result, "----------------------------------------------------------------------\n");
-		for(it = vecit_first(&(tblt->cols)); vecit_valid(it); it = vecit_next(it))
-		{
-			tblt_col_t *col = (tblt_col_t*) vecit_data(it);
-			char tmp[64];
-
-			if(i == 0)
-			{
-				strcat(result, "|");
-			}
-			sprintf(tmp, "   %7s %15s   |",
-					(col) ? type_to_str(col->type) : "null",
-					(col) ? col->name : "null");
-			strcat(result, tmp);
-			i = 1;
-		}
-		strcat(result, "\n");
-	}
-
-	return result;
+	UI_STR_FROM(mgr_fmt_tblt(fmt, tblt));
 }
 
 char *ui_str_from_tbr(rule_t *tbr)
 {
-	char *str = STAKE(1024);
-	if(str != NULL)
-	{
-		char *id_str = ui_str_from_ari(&(tbr->id), NULL, 0);
-		char *ac_str = ui_str_from_ac(&(tbr->action));
-		snprintf(str,
-				1024,
-				"TBR: ID=%s, S=" \
-				PRId64 ", P=" \
-				PRId64 ", C=" \
-				PRId64 ", A=%s\n",
-				(id_str == NULL) ? "null" :id_str,
-				tbr->start,
-			    tbr->def.as_tbr.period,
-			    tbr->def.as_tbr.max_fire,
-		        (ac_str == NULL) ? "null" : ac_str);
-
-		SRELEASE(id_str);
-		SRELEASE(ac_str);
-	}
-
-	return str;
-}
-
-#ifdef USE_JSON
-cJSON *ui_json_from_tnv(tnv_t *tnv)
-{
-   char *str;
-   CHKNULL(tnv);
-
-   // TODO: Additional data types from ui_str_from_tnv() can be converted to json
-   switch(tnv->type)
-   {
-      /* Primitive Types */
-   case AMP_TYPE_BOOL:   return cJSON_CreateBool(tnv->value.as_byte);
-   case AMP_TYPE_INT:    return cJSON_CreateNumber(tnv->value.as_int);
-   case AMP_TYPE_UINT:   return cJSON_CreateNumber(tnv->value.as_uint);
-   case AMP_TYPE_VAST:   return cJSON_CreateNumber(tnv->value.as_vast);
-   case AMP_TYPE_TV:
-   case AMP_TYPE_TS:
-   case AMP_TYPE_UVAST:  return cJSON_CreateNumber(tnv->value.as_uvast);
-   case AMP_TYPE_REAL32: return cJSON_CreateNumber(tnv->value.as_real32);
-   case AMP_TYPE_REAL64: return cJSON_CreateNumber(tnv->value.as_real64);
-      
-      /* Compound Objects */
-   case AMP_TYPE_TNV:    return ui_json_from_tnv(tnv->value.as_ptr);
-   case AMP_TYPE_TNVC:   return ui_json_from_tnvc(tnv->value.as_ptr);
-      
-   default: // Fallback to STR Parsing
-      str = ui_str_from_tnv(tnv);
-      if (str != NULL)
-      {
-         cJSON *rtv = cJSON_CreateString(str);
-         SRELEASE(str);
-         return rtv;
-      }
-      else
-      {
-         return NULL;
-      }
-   }
+	CHKNULL(tbr);
+	UI_STR_FROM(mgr_fmt_tbr(fmt, tbr));
 }
-#endif
 
 char *ui_str_from_tnv(tnv_t *tnv)
 {
-	char *str = STAKE(1024);
-	char *alt_str = NULL;
-	CHKNULL(str);
-
-	if(tnv == NULL)
-	{
-		strcat(str, "null");
-		return str;
-	}
-
-	switch(tnv->type)
-	{
-		case AMP_TYPE_CNST:
-		case AMP_TYPE_EDD:   alt_str = ui_str_from_edd(tnv->value.as_ptr);    break;
-		case AMP_TYPE_CTRL:  alt_str = ui_str_from_ctrl(tnv->value.as_ptr);   break;
-		case AMP_TYPE_LIT:
-		case AMP_TYPE_ARI:   alt_str = ui_str_from_ari(tnv->value.as_ptr, NULL, 0);    break;
-		case AMP_TYPE_MAC:   alt_str = ui_str_from_mac(tnv->value.as_ptr);    break;
-		case AMP_TYPE_OPER:  alt_str = ui_str_from_op(tnv->value.as_ptr);     break;
-		case AMP_TYPE_RPT:   alt_str = ui_str_from_rpt(tnv->value.as_ptr);    break;
-		case AMP_TYPE_RPTTPL:alt_str = ui_str_from_rpttpl(tnv->value.as_ptr); break;
-		case AMP_TYPE_SBR:   alt_str = ui_str_from_sbr(tnv->value.as_ptr);    break;
-		case AMP_TYPE_TBL:   alt_str = ui_str_from_tbl(tnv->value.as_ptr);    break;
-		case AMP_TYPE_TBLT:  alt_str = ui_str_from_tblt(tnv->value.as_ptr);   break;
-		case AMP_TYPE_TBR:   alt_str = ui_str_from_tbr(tnv->value.as_ptr);    break;
-		case AMP_TYPE_VAR:   alt_str = ui_str_from_var(tnv->value.as_ptr);    break;
-
-		/* Primitive Types */
-		case AMP_TYPE_BOOL:
-		case AMP_TYPE_BYTE:  sprintf(str,"%d", tnv->value.as_byte);    break;
-		case AMP_TYPE_STR:   snprintf(str, 1023, "%s", (char*) tnv->value.as_ptr); break;
-		case AMP_TYPE_INT:   sprintf(str,"%d", tnv->value.as_int);     break;
-		case AMP_TYPE_UINT:  sprintf(str,"%d", tnv->value.as_uint);    break;
-		case AMP_TYPE_VAST:  sprintf(str, PRId64, tnv->value.as_vast);   break;
-		case AMP_TYPE_TV:
-		case AMP_TYPE_TS:
-		case AMP_TYPE_UVAST: sprintf(str, PRIu64, tnv->value.as_uvast);  break;
-		case AMP_TYPE_REAL32:sprintf(str,"%f", tnv->value.as_real32);  break;
-		case AMP_TYPE_REAL64:sprintf(str,"%lf", tnv->value.as_real64); break;
-
-		/* Compound Objects */
-		case AMP_TYPE_TNV:    alt_str = ui_str_from_tnv(tnv->value.as_ptr);  break;
-		case AMP_TYPE_TNVC:   alt_str = ui_str_from_tnvc(tnv->value.as_ptr); break;
-		case AMP_TYPE_AC:     alt_str = ui_str_from_ac(tnv->value.as_ptr);   break;
-		case AMP_TYPE_EXPR:   alt_str = ui_str_from_expr(tnv->value.as_ptr); break;
-		case AMP_TYPE_BYTESTR:alt_str = ui_str_from_blob(tnv->value.as_ptr); break;
-
-		default:
-			strcat(str, "UNK");
-			break;
-	}
-
-	if(alt_str != NULL)
-	{
-		strncat(str, alt_str, 1023);
-		SRELEASE(alt_str);
-	}
-
-	return str;
-}
-
-#ifdef USE_JSON
-/* Convert a TNVC into a JSON Array and insert into specified object */
-cJSON* ui_json_from_tnvc(tnvc_t *tnvc)
-{
-	int i;
-	int max;
-    CHKNULL(tnvc);
-
-	max = tnvc_get_count(tnvc);
-	if(max == 0)
-	{
-		return NULL;
-	}
-    else if (max == 1)
-    {
-       return ui_json_from_tnv(tnvc_get(tnvc,0));
-    }
-
-    cJSON *obj = cJSON_CreateArray();
-    
-	for(i = 0; i < max; i++)
-	{
-       cJSON_AddItemToArray(obj, ui_json_from_tnv(tnvc_get(tnvc,i)));
-	}
-
-	return obj;
+	UI_STR_FROM(mgr_fmt_tnv(fmt, tnv));
 }
-#endif
 
 char *ui_str_from_tnvc(tnvc_t *tnvc)
 {
-	char *str = STAKE(1024);
-	int i;
-	int max;
-	CHKNULL(str);
-
-	max = tnvc_get_count(tnvc);
-	if(max == 0)
-	{
-		strcat(str,"null");
-		return str;
-	}
-
-	for(i = 0; i < max; i++)
-	{
-		char *val_str = ui_str_from_tnv(tnvc_get(tnvc,i));
-		if(i != 0)
-		{
-			strcat(str, ", ");
-		}
-		strcat(str, val_str);
-		SRELEASE(val_str);
-	}
-
-	return str;
+	UI_STR_FROM(mgr_fmt_tnvc(fmt, tnvc));
 }
 
-
-
 char *ui_str_from_var(var_t *var)
 {
+	CHKNULL(var);
 	return ui_str_from_tnv(var->value);
 }
-
-
-
-
-
@@ -55,10 +55,6 @@
 extern "C" {
 #endif
 
-#ifdef USE_JSON
-#include <cjson/cJSON.h>
-#endif
-
 // ASCII Color Codes & Macros for formatting stdout
 #define RST  "\x1B[0m"
 #define KRED  "\x1B[31m"
@@ -89,8 +85,6 @@ void  ui_fprint_report(ui_print_cfg_t *fd, rpt_t *rpt);
 void  ui_print_report_set(agent_t* agent);
 
 #ifdef USE_JSON
-cJSON* ui_json_report(rpt_t *rpt);
-cJSON* ui_json_table(tbl_t *tbl);
 void ui_fprint_json_report(ui_print_cfg_t *fd, rpt_t *rpt);
 void ui_fprint_json_table(ui_print_cfg_t *fd, tbl_t *rpt);
 #endif
@@ -46,10 +46,14 @@
 
 #include <inttypes.h>
 #include <pthread.h>
+#include <semaphore.h>
 
 #include "../shared/utils/nm_types.h"
 #include "../shared/utils/utils.h"
 #include "../shared/utils/debug.h"
+#include "../shared/utils/trace.h"
+#include "../shared/utils/lfq.h"
+#include "../shared/utils/threadset.h"
 
 #include "../shared/msg/msg.h"
 
@@ -57,7 +61,12 @@
 #include "nm_mgr_sql.h"
 #endif
 
-#include "nm_mgr_print.h" // For direct report file logging
+#include "nm_mgr_print.h" // For report file logging
+#include "nm_mgr_log.h"
+#include "nm_mgr_metrics.h"
+
+/// Groups which may wait for each receive worker
+#define MGR_RX_QUEUE_LEN 256
 
 
 /******************************************************************************
@@ -69,10 +78,10 @@
  * \return 0 - Success
  *        -1 - Failure
  *
- * \param[in]  sender_eid  - The agent providing the report.
- * \param[in]  cursor      - Start of the serialized message.
- * \param[in]  size        - The size of the serialized stream holding the msg
- * \param[out] bytes_used  - Bytes used in deserializing the report.
+ * \param[in]  agent       - The agent providing the report, held by the
+ *                          caller, or NULL if it is unknown.
+ * \param[in]  meta        - Where the report came from.
+ * \param[in]  msg         - The reports, which are moved to the agent.
  *
  * \par Notes:
  *		- \todo: We do not process Access Control Lists (ACLs) at this time.
@@ -84,68 +93,76 @@
  *  08/20/13  E. Birrane     Initial Implementation.
  *****************************************************************************/
 
-void rx_data_rpt(msg_metadata_t *meta, msg_rpt_t *msg)
+void rx_data_rpt(agent_t *agent, msg_metadata_t *meta, msg_rpt_t *msg)
 {
-    agent_t *agent = NULL;
-    int result = -1;
-
     CHKVOID(meta);
     CHKVOID(msg);
 
     // TODO: Check to see if we are listed as a recipient for this report.
 
-	/* Step 1: Retrieve stored information about this agent. */
-	if((agent = agent_get(&(meta->source))) == NULL)
+	if(agent == NULL)
 	{
 		AMP_DEBUG_WARN("msg_rx_data_rpt",
 				        "Received group is from an unknown sender (%s); ignoring it.",
 						meta->source.name);
-        agent_t *agent = (agent_t*) vec_at(&gMgrDB.agents, 0);
+		MGR_METRICS_ADD(gMgrMetrics.rx_dropped, vec_num_entries(msg->rpts));
 	}
 	else
 	{
 		vecit_t it;
+		mgr_log_buf_t log_buf = { NULL, NULL, 0 };
+		int log_cnt = 0;
+
+		/* Reports are formatted here and handed off to the log writer. */
+		int log_on = agent_log_cfg.rx_rpt;
+#ifdef USE_JSON
+		log_on |= agent_log_cfg.rx_json_rpt;
+#endif
+		if (agent_log_cfg.enabled && log_on)
+		{
+			mgr_log_buf_open(&log_buf);
+		}
 
 		for(it = vecit_first(&(msg->rpts)); vecit_valid(it); it = vecit_next(it))
 		{
 			rpt_t *rpt = vecit_data(it);
             int status = vec_push(&(agent->rpts), rpt);
 
-            if (agent->log_fd != NULL)
+            if (log_buf.fd != NULL)
             {
                 if (agent_log_cfg.rx_rpt)
                 {
-                    ui_print_cfg_t fd = INIT_UI_PRINT_CFG_FD(agent->log_fd);
+                    ui_print_cfg_t fd = INIT_UI_PRINT_CFG_FD(log_buf.fd);
                     ui_fprint_report(&fd, rpt);
-                    agent->log_fd_cnt++;
+                    log_cnt++;
                 }
 #ifdef USE_JSON
                 if (agent_log_cfg.rx_json_rpt)
                 {
-                    ui_print_cfg_t fd = INIT_UI_PRINT_CFG_FD(agent->log_fd);
+                    ui_print_cfg_t fd = INIT_UI_PRINT_CFG_FD(log_buf.fd);
                     ui_fprint_json_report(&fd, rpt);
-                    agent->log_fd_cnt++;
+                    log_cnt++;
                 }
 #endif
             }
             
             if (status == VEC_OK)
             {
-                gMgrDB.tot_rpts++;
+                MGR_METRICS_ADD(gMgrDB.tot_rpts, 1);
+                MGR_METRICS_ADD(agent->rx_rpts, 1);
             }
             else // Vector may be full.  Discard (and release) report
             {
                 // TODO: Consider retrying after a vec_pop() to replace oldest report
                 AMP_DEBUG_WARN("rx_data_rpt", "Failed to push rpt, discarding", NULL);
+                MGR_METRICS_ADD(gMgrMetrics.rx_dropped, 1);
                 rpt_release(rpt, 1);
             }
 		}
 
-        if (agent->log_fd != NULL && agent_log_cfg.rx_rpt) {
-            fflush(agent->log_fd); // Flush file after we've written set
-
-            // And check for file rotation (we won't break up a set between files)
-            agent_rotate_log(agent,0);
+        if (log_buf.fd != NULL) {
+            // Queue the whole set as one record (we won't break up a set between files)
+            mgr_log_buf_commit(&log_buf, agent, log_cnt);
         }
 	}
 
@@ -154,6 +171,67 @@ void rx_data_rpt(msg_metadata_t *meta, msg_rpt_t *msg)
 	msg->rpts.delete_fn = NULL;
 }
 
+/*
+ * Rebuilds whole tables from the incremental tables in a table set and adds
+ * them to its tables. A delta which doesn't apply to the last table rebuilt
+ * is dropped; the agent sends the whole table again often enough to recover.
+ */
+static void rx_tbl_deltas(agent_t *agent, msg_tbl_t *msg)
+{
+	vecit_t it;
+	vecit_t base_it;
+
+	for(it = vecit_first(&(msg->deltas)); vecit_valid(it); it = vecit_next(it))
+	{
+		tbl_delta_t *delta = vecit_data(it);
+		agent_tbl_base_t *base = NULL;
+		tbl_t *tbl;
+
+		for(base_it = vecit_first(&(agent->tbl_bases)); vecit_valid(base_it); base_it = vecit_next(base_it))
+		{
+			agent_tbl_base_t *cur = vecit_data(base_it);
+			if(ari_compare(cur->tbl->id, delta->rows->id, 1) == 0)
+			{
+				base = cur;
+				break;
+			}
+		}
+
+		if((delta->base != 0) && ((base == NULL) || (base->seq != delta->base)))
+		{
+			AMP_DEBUG_WARN("rx_tbl_deltas", "Table delta %u from %s is for table %u, which we don't have.",
+			               delta->seq, agent->eid.name, delta->base);
+			continue;
+		}
+
+		if((tbl = tbl_delta_apply((delta->base != 0) ? base->tbl : NULL, delta)) == NULL)
+		{
+			continue;
+		}
+
+		if(base == NULL)
+		{
+			if(((base = STAKE(sizeof(agent_tbl_base_t))) == NULL) ||
+			   (vec_push(&(agent->tbl_bases), base) != VEC_OK))
+			{
+				AMP_DEBUG_WARN("rx_tbl_deltas", "Can't track table from %s.", agent->eid.name);
+				SRELEASE(base);
+				tbl_release(tbl, 1);
+				continue;
+			}
+		}
+		tbl_release(base->tbl, 1);
+		base->tbl = tbl;
+		base->seq = delta->seq;
+
+		/* The set's tables are handed on to the agent, so add a copy. */
+		if(((tbl = tbl_copy_ptr(tbl)) == NULL) || (msg_tbl_add_tbl(msg, tbl) != AMP_OK))
+		{
+			tbl_release(tbl, 1);
+		}
+	}
+}
+
 /******************************************************************************
  *
  * \par Function Name: msg_rx_data_tbl
@@ -163,10 +241,11 @@ void rx_data_rpt(msg_metadata_t *meta, msg_rpt_t *msg)
  * \return 0 - Success
  *        -1 - Failure
  *
- * \param[in]  sender_eid  - The agent providing the report.
- * \param[in]  cursor      - Start of the serialized message.
- * \param[in]  size        - The size of the serialized stream holding the msg
- * \param[out] bytes_used  - Bytes used in deserializing the report.
+ * \param[in]  agent       - The agent providing the tables, held by the
+ *                          caller, or NULL if it is unknown.
+ * \param[in]  meta        - Where the tables came from.
+ * \param[in]  msg         - The tables, with any deltas already rebuilt by
+ *                          rx_tbl_deltas(), which are moved to the agent.
  *
  * \par Notes:
  *		- \todo: We do not process Access Control Lists (ACLs) at this time.
@@ -178,46 +257,54 @@ void rx_data_rpt(msg_metadata_t *meta, msg_rpt_t *msg)
  *  08/20/13  E. Birrane     Initial Implementation.
  *****************************************************************************/
 
-void rx_data_tbl(msg_metadata_t *meta, msg_tbl_t *msg)
+void rx_data_tbl(agent_t *agent, msg_metadata_t *meta, msg_tbl_t *msg)
 {
-    agent_t *agent = NULL;
-    int result = -1;
-
     CHKVOID(meta);
     CHKVOID(msg);
 
     // TODO: Check to see if we are listed as a recipient for this report.
 
-	/* Step 1: Retrieve stored information about this agent. */
-	if((agent = agent_get(&(meta->source))) == NULL)
+	if(agent == NULL)
 	{
 		AMP_DEBUG_WARN("msg_rx_data_tbl",
 				        "Received group is from an unknown sender (%s); ignoring it.",
-						meta->source);
+						meta->source.name);
+		MGR_METRICS_ADD(gMgrMetrics.rx_dropped, vec_num_entries(msg->tbls) + vec_num_entries(msg->deltas));
 	}
 	else
 	{
 		vecit_t it;
+		mgr_log_buf_t log_buf = { NULL, NULL, 0 };
+		int log_cnt = 0;
+
+		int log_on = agent_log_cfg.rx_tbl;
+#ifdef USE_JSON
+		log_on |= agent_log_cfg.rx_json_tbl;
+#endif
+		if (agent_log_cfg.enabled && log_on)
+		{
+			mgr_log_buf_open(&log_buf);
+		}
 
 		for(it = vecit_first(&(msg->tbls)); vecit_valid(it); it = vecit_next(it))
 		{
 			tbl_t *tbl = vecit_data(it);
             int status = vec_push(&(agent->tbls), tbl);
 
-            if (agent->log_fd != NULL)
+            if (log_buf.fd != NULL)
             {
                 if(agent_log_cfg.rx_tbl)
                 {
-                    ui_print_cfg_t fd = INIT_UI_PRINT_CFG_FD(agent->log_fd);
+                    ui_print_cfg_t fd = INIT_UI_PRINT_CFG_FD(log_buf.fd);
                     ui_fprint_table(&fd, tbl);
-                    agent->log_fd_cnt++;
+                    log_cnt++;
                 }
 #ifdef USE_JSON
                 if (agent_log_cfg.rx_json_tbl)
                 {
-                    ui_print_cfg_t fd = INIT_UI_PRINT_CFG_FD(agent->log_fd);
+                    ui_print_cfg_t fd = INIT_UI_PRINT_CFG_FD(log_buf.fd);
                     ui_fprint_json_table(&fd, tbl);
-                    agent->log_fd_cnt++;
+                    log_cnt++;
                 }
 #endif
 
@@ -225,21 +312,21 @@ void rx_data_tbl(msg_metadata_t *meta, msg_tbl_t *msg)
 
             if (status == VEC_OK)
             {
-                gMgrDB.tot_tbls++;
+                MGR_METRICS_ADD(gMgrDB.tot_tbls, 1);
+                MGR_METRICS_ADD(agent->rx_tbls, 1);
             }
             else // Vector may be full.  Discard (and release) report
             {
                 // TODO: Consider retrying after a vec_pop() to replace oldest report
                 AMP_DEBUG_WARN("rx_data_tbl", "Failed to push tbl, discarding", NULL);
+                MGR_METRICS_ADD(gMgrMetrics.rx_dropped, 1);
                 tbl_release(tbl, 1);
             }
 		}
 
-        if (agent->log_fd != NULL && agent_log_cfg.rx_tbl) {
-            fflush(agent->log_fd); // Flush file after we've written set
-
-            // And check for file rotation (we won't break up a set between files)
-            agent_rotate_log(agent,0);
+        if (log_buf.fd != NULL) {
+            // Queue the whole set as one record (we won't break up a set between files)
+            mgr_log_buf_commit(&log_buf, agent, log_cnt);
         }
 	}
 
@@ -257,6 +344,363 @@ void rx_agent_reg(msg_metadata_t *meta, msg_agent_t *msg)
 
 }
 
+/** Hex of each group, in a buffer kept for the life of a thread. */
+typedef struct
+{
+    char *text;
+    size_t max;
+} mgr_rx_hex_t;
+
+/** One message of a group, decoded. */
+typedef struct
+{
+    int type;
+    void *msg;
+} mgr_rx_msg_t;
+
+/** One received group waiting for a worker. */
+typedef struct
+{
+    msg_metadata_t meta;
+    blob_t *buf;
+} mgr_rx_item_t;
+
+/** A receive worker, which handles the groups from the agents whose EIDs
+ * hash to it in the order they were received.
+ */
+typedef struct
+{
+    lfq_t queue;
+    /// Signaled once for each group queued, and once more to stop
+    sem_t wake;
+    /// Counts free queue slots, so the receiver waits rather than drops
+    sem_t space;
+} mgr_rx_shard_t;
+
+/* FNV-1a over an EID name. */
+static uint64_t mgr_rx_eid_hash(const eid_t *eid)
+{
+    uint64_t hash = UINT64_C(0xcbf29ce484222325);
+
+    for(size_t ix = 0; (ix < AMP_MAX_EID_LEN) && (eid->name[ix] != '\0'); ++ix)
+    {
+        hash ^= (uint8_t) eid->name[ix];
+        hash *= UINT64_C(0x100000001b3);
+    }
+    return hash;
+}
+
+static void mgr_rx_msg_release(mgr_rx_msg_t *msg)
+{
+    switch(msg->type)
+    {
+        case MSG_TYPE_RPT_SET:
+            msg_rpt_release(msg->msg, 1);
+            break;
+        case MSG_TYPE_TBL_SET:
+        case MSG_TYPE_TBL_DELTA:
+            msg_tbl_release(msg->msg, 1);
+            break;
+        case MSG_TYPE_REG_AGENT:
+            msg_agent_release(msg->msg, 1);
+            break;
+        default:
+            break;
+    }
+}
+
+/*
+ * Decode, store and hand on one message group. Everything but storing is
+ * done outside the database lock, so only the database calls themselves are
+ * serialized when several workers share its connection. Agents register
+ * and table deltas are rebuilt before storing, since the rebuilt tables are
+ * stored, and the agent is held until its reports and tables are handed on.
+ */
+static void mgr_rx_group(msg_metadata_t *meta, blob_t *buf, mgr_rx_hex_t *hex)
+{
+    vecit_t it;
+    int success;
+    agent_t *agent;
+    msg_grp_t *grp = NULL;
+    mgr_rx_msg_t *msgs = NULL;
+    size_t num_msgs;
+    uint64_t start_us;
+    uint64_t decode_us;
+#if defined(HAVE_MYSQL) || defined(HAVE_POSTGRESQL)
+    uint64_t sql_us;
+    uint64_t sql_batch;
+#endif
+
+    // Convert to HEX for logging (DB, Shell & agent log)
+    if (2 * buf->length + 3 > hex->max)
+    {
+        SRELEASE(hex->text);
+        hex->max = 2 * buf->length + 3;
+        if ((hex->text = STAKE(hex->max)) == NULL)
+        {
+            hex->max = 0;
+            blob_release(buf, 1);
+            return;
+        }
+    }
+    hex->text[0] = '0';
+    hex->text[1] = 'x';
+    utils_hex_encode(hex->text + 2, buf->value, buf->length);
+
+    agent = agent_acquire(&(meta->source));
+    if (agent && agent_log_cfg.enabled && agent_log_cfg.rx_cbor == 1) {
+        mgr_log_printf(agent, "RX: msgs:%s\n", hex->text);
+    }
+#if AMP_DEBUGGING == 1
+    printf("RX from %s: msgs:%s\n", meta->source.name, hex->text);
+#endif
+
+    start_us = utils_now_us();
+    grp = msg_grp_deserialize(buf, &success);
+    blob_release(buf, 1);
+
+    if((grp == NULL) || (success != AMP_OK))
+    {
+        decode_us = utils_now_us() - start_us;
+        MGR_METRICS_ADD(gMgrMetrics.rx_invalid, 1);
+        NM_TRACE2(rx__invalid, meta->source.name, decode_us);
+#if defined(HAVE_MYSQL) || defined(HAVE_POSTGRESQL)
+        // Log discarded message in DB
+        pthread_mutex_lock(&(gMgrDB.sql_info.lock));
+        db_incoming_finalize(0, AMP_FAIL, meta->source.name, hex->text);
+        pthread_mutex_unlock(&(gMgrDB.sql_info.lock));
+#endif
+        AMP_DEBUG_ERR("mgr_rx_group","Discarding invalid message.", NULL);
+        msg_grp_release(grp, 1);
+        agent_put(agent);
+        return;
+    }
+
+    AMP_DEBUG_INFO("mgr_rx_group","Group had %d msgs", vec_num_entries(grp->msgs));
+
+    num_msgs = vec_num_entries(grp->msgs);
+    if ((num_msgs > 0) && ((msgs = STAKE(num_msgs * sizeof(mgr_rx_msg_t))) == NULL))
+    {
+        msg_grp_release(grp, 1);
+        agent_put(agent);
+        return;
+    }
+
+    /* Step 1: Decode each message in the group. */
+    for(it = vecit_first(&(grp->msgs)); vecit_valid(it); it = vecit_next(it))
+    {
+        vec_idx_t i = vecit_idx(it);
+        blob_t *msg_data = (blob_t*) vecit_data(it);
+        mgr_rx_msg_t *msg = msgs + i;
+
+        msg->type = msg_grp_get_type(grp, i);
+        switch(msg->type)
+        {
+            case MSG_TYPE_RPT_SET:
+                msg->msg = msg_rpt_deserialize(msg_data, &success);
+                break;
+            case MSG_TYPE_TBL_SET:
+            case MSG_TYPE_TBL_DELTA:
+                msg->msg = msg_tbl_deserialize(msg_data, &success);
+                break;
+            case MSG_TYPE_REG_AGENT:
+                msg->msg = msg_agent_deserialize(msg_data, &success);
+                break;
+            default:
+                AMP_DEBUG_WARN("mgr_rx_group","Unknown message type: %d", msg->type);
+                msg->msg = NULL;
+                break;
+        }
+    }
+    decode_us = utils_now_us() - start_us;
+
+    /* Step 2: Register agents, then rebuild tables from their deltas. */
+    for(size_t ix = 0; ix < num_msgs; ++ix)
+    {
+        if ((msgs[ix].type == MSG_TYPE_REG_AGENT) && (msgs[ix].msg != NULL))
+        {
+            rx_agent_reg(meta, msgs[ix].msg);
+        }
+    }
+    if (agent == NULL)
+    {
+        agent = agent_acquire(&(meta->source));
+    }
+    for(size_t ix = 0; (agent != NULL) && (ix < num_msgs); ++ix)
+    {
+        if (((msgs[ix].type == MSG_TYPE_TBL_SET) || (msgs[ix].type == MSG_TYPE_TBL_DELTA))
+            && (msgs[ix].msg != NULL))
+        {
+            rx_tbl_deltas(agent, msgs[ix].msg);
+        }
+    }
+
+#if defined(HAVE_MYSQL) || defined(HAVE_POSTGRESQL)
+    /* Step 3: Copy the message group to the database tables. */
+    sql_batch = 0;
+    start_us = utils_now_us();
+    pthread_mutex_lock(&(gMgrDB.sql_info.lock));
+    uint32_t incoming_idx = db_incoming_initialize(grp->timestamp, meta->source);
+    int32_t db_status = AMP_OK;
+
+    for(size_t ix = 0; ix < num_msgs; ++ix)
+    {
+        mgr_rx_msg_t *msg = msgs + ix;
+
+        if (msg->msg == NULL)
+        {
+            continue;
+        }
+        switch(msg->type)
+        {
+            case MSG_TYPE_RPT_SET:
+                db_insert_msg_rpt_set(incoming_idx, msg->msg, &db_status);
+                sql_batch += vec_num_entries(((msg_rpt_t *) msg->msg)->rpts);
+                break;
+            case MSG_TYPE_TBL_SET:
+            case MSG_TYPE_TBL_DELTA:
+                db_insert_msg_tbl_set(incoming_idx, msg->msg, &db_status);
+                sql_batch += vec_num_entries(((msg_tbl_t *) msg->msg)->tbls);
+                break;
+            case MSG_TYPE_REG_AGENT:
+                db_insert_msg_reg_agent(incoming_idx, msg->msg, &db_status);
+                break;
+            default:
+                break;
+        }
+    }
+
+    // Commit transaction and log as applicable
+    db_incoming_finalize(incoming_idx, db_status, meta->source.name, hex->text);
+    pthread_mutex_unlock(&(gMgrDB.sql_info.lock));
+    sql_us = utils_now_us() - start_us;
+    mgr_metrics_hist_record(&(gMgrMetrics.sql_insert_us), sql_us);
+    mgr_metrics_hist_record(&(gMgrMetrics.sql_batch), sql_batch);
+#endif
+
+    /* Step 4: Hand each message on to its agent, in group order. */
+    for(size_t ix = 0; ix < num_msgs; ++ix)
+    {
+        mgr_rx_msg_t *msg = msgs + ix;
+
+        if (msg->msg == NULL)
+        {
+            continue;
+        }
+        switch(msg->type)
+        {
+            case MSG_TYPE_RPT_SET:
+                rx_data_rpt(agent, meta, msg->msg);
+                break;
+            case MSG_TYPE_TBL_SET:
+            case MSG_TYPE_TBL_DELTA:
+                rx_data_tbl(agent, meta, msg->msg);
+                break;
+            default:
+                break;
+        }
+        mgr_rx_msg_release(msg);
+    }
+
+    mgr_metrics_hist_record(&(gMgrMetrics.decode_us), decode_us);
+    NM_TRACE3(rx__decode, meta->source.name, num_msgs, decode_us);
+    agent_put(agent);
+    SRELEASE(msgs);
+    msg_grp_release(grp, 1);
+}
+
+static void *mgr_rx_worker(void *arg)
+{
+    mgr_rx_shard_t *shard = arg;
+    mgr_rx_hex_t hex = { NULL, 0 };
+    mgr_rx_item_t *item;
+
+    while(true)
+    {
+        if (sem_wait(&(shard->wake)) != 0)
+        {
+            continue;
+        }
+        // Woken with nothing queued only to stop
+        if ((item = lfq_pop(&(shard->queue))) == NULL)
+        {
+            break;
+        }
+        sem_post(&(shard->space));
+
+        mgr_rx_group(&(item->meta), item->buf, &hex);
+        SRELEASE(item);
+    }
+
+    SRELEASE(hex.text);
+    return NULL;
+}
+
+static mgr_rx_shard_t *mgr_rx_shards_start(size_t count, list_thread_t *threads)
+{
+    const threadinfo_t info = {&mgr_rx_worker, "nm_mgr_rx_work"};
+    mgr_rx_shard_t *shards;
+    size_t ix;
+
+    if ((shards = STAKE(count * sizeof(mgr_rx_shard_t))) == NULL)
+    {
+        return NULL;
+    }
+    for(ix = 0; ix < count; ++ix)
+    {
+        mgr_rx_shard_t *shard = shards + ix;
+        if (lfq_init(&(shard->queue), MGR_RX_QUEUE_LEN) != AMP_OK)
+        {
+            break;
+        }
+        sem_init(&(shard->wake), 0, 0);
+        sem_init(&(shard->space), 0, MGR_RX_QUEUE_LEN);
+        if (threadset_start(threads, &info, 1, shard) != AMP_OK)
+        {
+            sem_destroy(&(shard->space));
+            sem_destroy(&(shard->wake));
+            lfq_destroy(&(shard->queue));
+            break;
+        }
+    }
+    if (ix < count)
+    {
+        AMP_DEBUG_ERR("mgr_rx_thread", "Started only %zu of %zu workers.", ix, count);
+        count = ix;
+        for(ix = 0; ix < count; ++ix)
+        {
+            sem_post(&(shards[ix].wake));
+        }
+        threadset_join(threads);
+        for(ix = 0; ix < count; ++ix)
+        {
+            sem_destroy(&(shards[ix].space));
+            sem_destroy(&(shards[ix].wake));
+            lfq_destroy(&(shards[ix].queue));
+        }
+        SRELEASE(shards);
+        return NULL;
+    }
+    return shards;
+}
+
+/* Stop workers once they have handled everything queued. */
+static void mgr_rx_shards_stop(mgr_rx_shard_t *shards, size_t count, list_thread_t *threads)
+{
+    for(size_t ix = 0; ix < count; ++ix)
+    {
+        sem_post(&(shards[ix].wake));
+    }
+    threadset_join(threads);
+    for(size_t ix = 0; ix < count; ++ix)
+    {
+        sem_destroy(&(shards[ix].space));
+        sem_destroy(&(shards[ix].wake));
+        lfq_destroy(&(shards[ix].queue));
+    }
+    SRELEASE(shards);
+}
+
 /******************************************************************************
  *
  * \par Function Name: mgr_rx_thread
@@ -269,6 +713,9 @@ void rx_agent_reg(msg_metadata_t *meta, msg_agent_t *msg)
  *
  * \par Notes:
  *		- \todo: We do not process Access Control Lists (ACLs) at this time.
+ *		- With nmmgr_t::rx_workers set, groups are handed to that many
+ *		  worker threads by source EID, so each agent's groups are still
+ *		  handled in order.
  *
  *
  * Modification History:
@@ -283,15 +730,25 @@ void *mgr_rx_thread(void *arg)
   AMP_DEBUG_ENTRY("mgr_rx_thread","mgr (%p)", mgr);
     
     AMP_DEBUG_INFO("mgr_rx_thread","Receiver thread running...", NULL);
-    
-    vecit_t it;
 
     int success;
     blob_t *buf = NULL;
-    msg_grp_t *grp = NULL;
     msg_metadata_t meta;
-    int msg_type;
-
+    mgr_rx_hex_t hex = { NULL, 0 };
+    size_t num_shards = mgr->rx_workers;
+    mgr_rx_shard_t *shards = NULL;
+    list_thread_t workers;
+
+    if (num_shards > MGR_RX_MAX_WORKERS)
+    {
+        AMP_DEBUG_WARN("mgr_rx_thread", "Using %d of %zu receive workers.", MGR_RX_MAX_WORKERS, num_shards);
+        num_shards = MGR_RX_MAX_WORKERS;
+    }
+    list_thread_init(workers);
+    if ((num_shards > 0) && ((shards = mgr_rx_shards_start(num_shards, &workers)) == NULL))
+    {
+        num_shards = 0;
+    }
 
     /* 
      * g_running controls the overall execution of threads in the
@@ -307,107 +764,48 @@ void *mgr_rx_thread(void *arg)
         }
         else if(buf != NULL)
         {
-            if (agent_log_cfg.rx_cbor == 1) {
-                agent_t *agent = agent_get(&(meta.source));
-                if (agent && agent->log_fd) {
-                    char *tmp = utils_hex_to_string(buf->value, buf->length);
-                    fprintf(agent->log_fd, "RX: msgs:%s\n", tmp);
-                    fflush(agent->log_fd);
-                    SRELEASE(tmp);
-                }
-            }
-
-            // Convert to HEX for logging (DB & Shell)
-            char *tmp = utils_hex_to_string(buf->value, buf->length);
-            printf("RX from %s: msgs:%s\n", meta.source.name, tmp);
-
-        	grp = msg_grp_deserialize(buf, &success);
-        	blob_release(buf, 1);
-
-    		if((grp == NULL) || (success != AMP_OK))
-    		{
-#if defined(HAVE_MYSQL) || defined(HAVE_POSTGRESQL)
-                // Log discarded message in DB
-                db_incoming_finalize(0, AMP_FAIL, meta.source.name, tmp);
-#endif
-                SRELEASE(tmp);
-    			AMP_DEBUG_ERR("mgr_rx_thread","Discarding invalid message.", NULL);
-    			continue;
-    		}
-
-    		AMP_DEBUG_INFO("mgr_rx_thread","Group had %d msgs", vec_num_entries(grp->msgs));
-//FIXME:	AMP_DEBUG_INFO("mgr_rx_thread","Group timestamp %lu", grp->timestamp);
-
-#if defined(HAVE_MYSQL) || defined(HAVE_POSTGRESQL)
-            /* Copy the message group to the database tables */
-            uint32_t incoming_idx = db_incoming_initialize(grp->timestamp, meta.source);
-            int32_t db_status = AMP_OK;
-#endif
+            MGR_METRICS_ADD(gMgrMetrics.rx_groups, 1);
+            MGR_METRICS_ADD(gMgrMetrics.rx_bytes, buf->length);
+            NM_TRACE2(rx__recv, meta.source.name, buf->length);
 
-            /* For each message in the group. */
-            for(it = vecit_first(&(grp->msgs)); vecit_valid(it); it = vecit_next(it))
+            if (num_shards == 0)
             {
-            	vec_idx_t i = vecit_idx(it);
-            	blob_t *msg_data = (blob_t*) vecit_data(it);
-
-            	/* Get the message type. */
-            	msg_type = msg_grp_get_type(grp, i);
-            	success = AMP_FAIL;
-            	switch(msg_type)
-            	{
-            		case MSG_TYPE_RPT_SET:
-            		{
-            			msg_rpt_t *rpt_msg = msg_rpt_deserialize(msg_data, &success);
-#if defined(HAVE_MYSQL) || defined(HAVE_POSTGRESQL)
-                        db_insert_msg_rpt_set(incoming_idx, rpt_msg, &db_status);
-#endif
-            			rx_data_rpt(&meta, rpt_msg);
-                        msg_rpt_release(rpt_msg, 1);
-            			break;
-            		}
-            		case MSG_TYPE_TBL_SET:
-            		{
-            			msg_tbl_t *tbl_msg = msg_tbl_deserialize(msg_data, &success);
-            			rx_data_tbl(&meta, tbl_msg);
-#if defined(HAVE_MYSQL) || defined(HAVE_POSTGRESQL)
-                        db_insert_msg_tbl_set(incoming_idx, tbl_msg, &db_status);
-#endif
-                        msg_tbl_release(tbl_msg, 1);
-
-            			break;
-            		}
-            		case MSG_TYPE_REG_AGENT:
-            		{
-            			msg_agent_t *agent_msg = msg_agent_deserialize(msg_data, &success);
-            			rx_agent_reg(&meta, agent_msg);
-#if defined(HAVE_MYSQL) || defined(HAVE_POSTGRESQL)
+                mgr_rx_group(&meta, buf, &hex);
+            }
+            else
+            {
+                mgr_rx_shard_t *shard = shards + (mgr_rx_eid_hash(&(meta.source)) % num_shards);
+                mgr_rx_item_t *item = STAKE(sizeof(mgr_rx_item_t));
 
-                        db_insert_msg_reg_agent(incoming_idx, agent_msg, &db_status);
-#endif
-                        msg_agent_release(agent_msg, 1);
-            			break;
-            		}
-            		default:
-            			AMP_DEBUG_WARN("mgr_rx_thread","Unknown message type: %d", msg_type);
-            			break;
-            	}
+                if (item == NULL)
+                {
+                    MGR_METRICS_ADD(gMgrMetrics.rx_dropped, 1);
+                    blob_release(buf, 1);
+                    continue;
+                }
+                item->meta = meta;
+                item->buf = buf;
 
+                /* Wait for room rather than drop a group. */
+                while (sem_wait(&(shard->space)) != 0)
+                {
+                    continue;
+                }
+                lfq_push(&(shard->queue), item);
+                sem_post(&(shard->wake));
             }
-
-#if defined(HAVE_MYSQL) || defined(HAVE_POSTGRESQL)
-            // Commit transaction and log as applicable
-            db_incoming_finalize(incoming_idx, db_status, meta.source.name, tmp);
-#endif
-            msg_grp_release(grp, 1);
-            SRELEASE(tmp);
             memset(&meta, 0, sizeof(meta));
         }
     }
-   
 
+    if (num_shards > 0)
+    {
+        mgr_rx_shards_stop(shards, num_shards, &workers);
+    }
+    list_thread_clear(workers);
+    SRELEASE(hex.text);
     AMP_DEBUG_ALWAYS("mgr_rx_thread", "Exiting.", NULL);
     AMP_DEBUG_EXIT("mgr_rx_thread","->.", NULL);
     pthread_exit(NULL);
-    return NULL;
 }
 
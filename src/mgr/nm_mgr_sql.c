@@ -53,6 +53,7 @@
 
 #include "nmmgr.h"
 #include "nm_mgr_sql.h"
+#include "../shared/utils/trace.h"
 
 /* Number of threads interacting with the database.
  - DB Polling Thread - Check for reports pending transmission
@@ -493,7 +494,9 @@ int32_t db_incoming_finalize(uint32_t id, uint32_t grp_status, char* src_eid, ch
 				   id // Override line as a debug record of associated group_id
 			);
 	}
+	NM_TRACE3(db__commit__begin, id, grp_status, src_eid);
 	db_mgt_txn_commit(DB_RPT_CON);
+	NM_TRACE2(db__commit__end, id, grp_status);
 	AMP_DEBUG_EXIT("db_incoming_finalize","-->%d", AMP_OK);
 	return AMP_OK;
 }
@@ -1702,8 +1705,8 @@ int db_query_tnvc(size_t dbidx, int tnvc_id, tnvc_t *parms)
 	#endif // HAVE_POSTGRESQL
 	int *cache_ids = STAKE(array_len * sizeof(int) );
 	
-	// Create vector
-	parms->values = vec_create(array_len, tnv_cb_del,tnv_cb_comp,tnv_cb_copy, VEC_FLAG_AS_STACK, &rtv);
+	// Create collection
+	rtv = tnvc_init(parms, array_len);
 	if (rtv != AMP_OK) {
 		#ifdef HAVE_MYSQL
  		mysql_stmt_free_result(stmt);
@@ -1761,7 +1764,7 @@ int db_query_tnvc(size_t dbidx, int tnvc_id, tnvc_t *parms)
 			AMP_DEBUG_ERR(__FUNCTION__, "SQL Support for TNV type %d not implemented", tnv_type);
 			rtv = AMP_FAIL;
 		}
-		vec_insert(&(parms->values), val, NULL);
+		tnvc_insert(parms, val);
 	}
 
 	#ifdef HAVE_MYSQL
@@ -1772,7 +1775,7 @@ int db_query_tnvc(size_t dbidx, int tnvc_id, tnvc_t *parms)
 	#endif // HAVE_POSTGRESQL
 
 	for(int i = 0; i < array_len && rtv == AMP_OK; i++) {
-		tnv_t *val = (tnv_t*)vec_at(&(parms->values), i);
+		tnv_t *val = tnvc_get(parms, i);
 		switch(val->type) {
 		case AMP_TYPE_AC:
 			ac_entry = db_query_ac(dbidx, cache_ids[i]);
@@ -5300,7 +5303,7 @@ uint32_t db_insert_tnvc(db_con_t dbidx, tnvc_t *tnvc, int *status)
 {
 	CHKZERO(tnvc);
 	
-	int num = vec_num_entries(tnvc->values);
+	int num = tnvc_size(tnvc);
 	if (num == 0) {
 		// We won't create a tnvc if empty (0 will be converted to NULL by calller)
 		return 0;
@@ -5350,7 +5353,7 @@ uint32_t db_insert_tnvc(db_con_t dbidx, tnvc_t *tnvc, int *status)
 	/* Add entries */
 	for(int i = 0; i < num; i++)
 	{
-		tnv_t *tnv = (tnv_t*) vec_at(&(tnvc->values),i);
+		tnv_t *tnv = tnvc_get(tnvc, i);
 		db_insert_tnv(dbidx, rtv, tnv, status);
 
 	}
@@ -56,6 +56,8 @@
 #include "nmmgr.h"
 #include "ui_input.h"
 #include "nm_mgr_print.h"
+#include "nm_mgr_log.h"
+#include "nm_mgr_metrics.h"
 #include "metadata.h"
 
 #if defined(HAVE_MYSQL) || defined(HAVE_POSTGRESQL)
@@ -182,13 +184,12 @@ void ui_log_transmit_msg(agent_t* agent, msg_ctrl_t *msg) {
    blob_t *data;
    char *msg_str;
    
-   if (agent_log_cfg.tx_cbor && agent->log_fd) {
+   if (agent_log_cfg.enabled && agent_log_cfg.tx_cbor) {
       data = msg_ctrl_serialize_wrapper(msg);
       if (data) {
          msg_str = utils_hex_to_string(data->value, data->length);
          if (msg_str) {
-            fprintf(agent->log_fd, "TX: msg:%s\n", msg_str);
-            fflush(agent->log_fd);
+            mgr_log_printf(agent, "TX: msg:%s\n", msg_str);
             SRELEASE(msg_str);
          }
          blob_release(data, 1);
@@ -287,6 +288,7 @@ void ui_clear_reports(agent_t* agent)
 	CHKVOID(agent);
 
 	gMgrDB.tot_rpts -= vec_num_entries(agent->rpts);
+	MGR_METRICS_ADD(gMgrMetrics.evicted, vec_num_entries(agent->rpts));
 
 	vec_clear(&(agent->rpts));
 }
@@ -307,6 +309,7 @@ void ui_clear_tables(agent_t* agent)
 	CHKVOID(agent);
 
 	gMgrDB.tot_tbls -= vec_num_entries(agent->tbls);
+	MGR_METRICS_ADD(gMgrMetrics.evicted, vec_num_entries(agent->tbls));
 
 	vec_clear(&(agent->tbls));
 }
@@ -499,6 +502,8 @@ void ui_log_cfg_menu()
 #endif
       {"Use discrete directories per agent", NULL, 8, 0, TYPE_CHECK_BOOL, &agent_log_cfg.agent_dirs},
       {"Max Entries Per Log File", NULL, 8, 0, TYPE_CHECK_NUM, &agent_log_cfg.limit},
+      {"Log Flush Interval (ms)", NULL, 8, 0, TYPE_CHECK_NUM, &agent_log_cfg.flush_ms},
+      {"Compress Rotated Log Files", NULL, 8, 0, TYPE_CHECK_BOOL, &agent_log_cfg.compress},
       {"Root Log directory", agent_log_cfg.dir, 32, 0, 0},
    };
 
@@ -512,7 +517,7 @@ void ui_log_cfg_menu()
 
       for(it = vecit_first(&(gMgrDB.agents)); vecit_valid(it); it = vecit_next(it))
       {
-         agent_rotate_log((agent_t *) vecit_data(it), 1 );
+         mgr_log_rotate((agent_t *) vecit_data(it), 1 );
       }
    }
    else
@@ -1659,12 +1664,12 @@ void ui_ctrl_list_menu(nmmgr_t *mgr)
    sprintf(ctrl_menu_list_descriptions[1], "(%d known)", gVDB.adm_edds.num_elts);
    sprintf(ctrl_menu_list_descriptions[2], "(%d known)",  gVDB.adm_atomics.num_elts);
    sprintf(ctrl_menu_list_descriptions[3], "(%d known)",  gVDB.adm_ctrl_defs.num_elts);
-   sprintf(ctrl_menu_list_descriptions[4], "(%d known)",  gVDB.macdefs.num_elts);
+   sprintf(ctrl_menu_list_descriptions[4], "(%d known)",  gVDB.adm.macdefs.num_elts + gVDB.inst.macdefs.num_elts);
    sprintf(ctrl_menu_list_descriptions[5], "(%d known)",  gVDB.adm_ops.num_elts);
-   sprintf(ctrl_menu_list_descriptions[6], "(%d known)",  gVDB.rpttpls.num_elts);
-   sprintf(ctrl_menu_list_descriptions[7], "(%d known)",  gVDB.rules.num_elts);
+   sprintf(ctrl_menu_list_descriptions[6], "(%d known)",  gVDB.adm.rpttpls.num_elts + gVDB.inst.rpttpls.num_elts);
+   sprintf(ctrl_menu_list_descriptions[7], "(%d known)",  gVDB.inst.rules.num_elts);
    sprintf(ctrl_menu_list_descriptions[8], "(%d known)",  gVDB.adm_tblts.num_elts);
-   sprintf(ctrl_menu_list_descriptions[9], "(%d known)",  gVDB.vars.num_elts);
+   sprintf(ctrl_menu_list_descriptions[9], "(%d known)",  gVDB.adm.vars.num_elts + gVDB.inst.vars.num_elts);
    
 
    while(daemon_run_get(&mgr->running))
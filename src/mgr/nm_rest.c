@@ -40,6 +40,8 @@
 #include "nmmgr.h"
 #include "nm_mgr_ui.h"
 #include "nm_mgr_print.h"
+#include "nm_mgr_fmt.h"
+#include "nm_mgr_metrics.h"
 
 
 struct mg_context *ctx;
@@ -51,12 +53,17 @@ struct mg_context *ctx;
 #define AGENTS_URI BASE_API_URI "/agents"
 #define AGENTS_IDX_URI AGENTS_URI "/idx"
 #define AGENTS_EID_URI AGENTS_URI "/eid"
+#define METRICS_URI BASE_API_URI "/metrics"
 
 // REST API Handler Declarations
 static int versionHandler(struct mg_connection *conn, void *cbdata);
 static int agentsHandler(struct mg_connection *conn, void *cbdata);
 static int agentIdxHandler(struct mg_connection *conn, void *cbdata);
 static int agentEidHandler(struct mg_connection *conn, void *cbdata);
+static int metricsHandler(struct mg_connection *conn, void *cbdata);
+
+/// Start of the request being handled by this worker thread
+static __thread uint64_t rest_start_us;
 
 /*** Start Common API Functions ***/
 static int
@@ -77,6 +84,26 @@ SendJSON(struct mg_connection *conn, cJSON *json_obj)
 	return (int)json_str_len;
 }
 
+/* Sends, and releases, the JSON written by a formatter. */
+static int
+SendJSONFmt(struct mg_connection *conn, mgr_fmt_t *fmt)
+{
+	size_t json_str_len;
+	char *json_str = mgr_fmt_take(fmt);
+
+	if (json_str == NULL)
+	{
+		return -1;
+	}
+	json_str_len = strlen(json_str);
+
+	mg_send_http_ok(conn, "application/json; charset=utf-8", json_str_len);
+	mg_write(conn, json_str, json_str_len);
+	SRELEASE(json_str);
+
+	return (int)json_str_len;
+}
+
 static void start_text_page(struct mg_connection *conn)
 {
    mg_printf(conn,
@@ -94,6 +121,23 @@ log_message(const struct mg_connection *conn, const char *message)
   return 1;
 }
 
+/* Each worker thread handles one request at a time, from begin to end. */
+static int
+begin_request(struct mg_connection *conn)
+{
+  (void)conn; /* currently unused */
+  rest_start_us = utils_now_us();
+  return 0;
+}
+
+static void
+end_request(const struct mg_connection *conn, int reply_status_code)
+{
+  (void)conn; /* currently unused */
+  (void)reply_status_code;
+  mgr_metrics_hist_record(&(gMgrMetrics.rest_us), utils_now_us() - rest_start_us);
+}
+
 int nm_rest_start(nmmgr_t *mgr)
 {
 	const char *options[] = {"listening_ports",
@@ -142,6 +186,8 @@ int nm_rest_start(nmmgr_t *mgr)
 	/* Callback will print error messages to console */
 	memset(&callbacks, 0, sizeof(callbacks));
 	callbacks.log_message = log_message;
+	callbacks.begin_request = begin_request;
+	callbacks.end_request = end_request;
 
 	/* Start CivetWeb web server */
 	ctx = mg_start(&callbacks, mgr, options);
@@ -154,6 +200,7 @@ int nm_rest_start(nmmgr_t *mgr)
 
 	/* Add URL Handlers.   */
 	mg_set_request_handler(ctx, VERSION_URI, versionHandler, 0);
+	mg_set_request_handler(ctx, METRICS_URI, metricsHandler, 0);
 
     mg_set_request_handler(ctx, AGENTS_IDX_URI, agentIdxHandler, 0);
     mg_set_request_handler(ctx, AGENTS_EID_URI, agentEidHandler, 0);
@@ -217,6 +264,41 @@ static int versionHandler(struct mg_connection *conn, void *cbdata)
 	return HTTP_OK;
 }
 
+/** Handler for /metrics
+ *    Supported requests:
+ *    - GET /metrics - Manager statistics in the Prometheus text format.
+ */
+static int metricsHandler(struct mg_connection *conn, void *cbdata)
+{
+   mgr_fmt_t fmt;
+   size_t len;
+   char *text;
+   const struct mg_request_info *ri = mg_get_request_info(conn);
+   (void)cbdata; /* currently unused */
+
+   if (0 != strcmp(ri->request_method, "GET")) {
+      mg_send_http_error(conn,
+                         HTTP_METHOD_NOT_ALLOWED,
+                         "Only GET method supported for this page");
+      return HTTP_METHOD_NOT_ALLOWED;
+   }
+
+   mgr_fmt_init_buf(&fmt);
+   mgr_metrics_write(&fmt);
+   if ((text = mgr_fmt_take(&fmt)) == NULL)
+   {
+      mg_send_http_error(conn, HTTP_INTERNAL_ERROR, "Server error");
+      return HTTP_INTERNAL_ERROR;
+   }
+   len = strlen(text);
+
+   mg_send_http_ok(conn, "text/plain; version=0.0.4; charset=utf-8", len);
+   mg_write(conn, text, len);
+   SRELEASE(text);
+
+   return HTTP_OK;
+}
+
 static int agentsGETHandler(struct mg_connection *conn)
 {
    cJSON *obj = cJSON_CreateObject();
@@ -440,96 +522,111 @@ static int agentShowTextTables(struct mg_connection *conn, agent_t *agent)
 
 static int agentShowJSONReports(struct mg_connection *conn, agent_t *agent)
 {
-   cJSON *obj;
-   cJSON *reports;
+   mgr_fmt_t fmt;
    vecit_t rpt_it;
-   ui_print_cfg_t fd = INIT_UI_PRINT_CFG_CONN(conn);
 
    if (agent == NULL)
    {
       return HTTP_INTERNAL_ERROR;
    }
 
-   obj = cJSON_CreateObject();
-   cJSON_AddStringToObject(obj, "eid", agent->eid.name);
-   reports = cJSON_AddArrayToObject(obj, "reports");
-   
+   mgr_fmt_init_buf(&fmt);
+   mgr_fmt_json_open(&fmt, '{');
+   mgr_fmt_json_key(&fmt, "eid");
+   mgr_fmt_json_str(&fmt, agent->eid.name);
+   mgr_fmt_json_key(&fmt, "reports");
+   mgr_fmt_json_open(&fmt, '[');
+
    /* Iterate through all reports for this agent. */
    for(rpt_it = vecit_first(&(agent->rpts)); vecit_valid(rpt_it); rpt_it = vecit_next(rpt_it))
    {
-      rpt_t *rpt = ( (rpt_t*)vecit_data(rpt_it) );
-
-      cJSON_AddItemToArray(reports, ui_json_report(rpt) );
+      mgr_fmt_report_json(&fmt, (rpt_t*)vecit_data(rpt_it));
    }
 
-   SendJSON(conn, obj);
-   cJSON_Delete(obj);
+   mgr_fmt_json_close(&fmt, ']');
+   mgr_fmt_json_close(&fmt, '}');
+
+   if (SendJSONFmt(conn, &fmt) < 0)
+   {
+      return HTTP_INTERNAL_ERROR;
+   }
    return HTTP_OK;
 
 }
 
 static int agentShowJSONTables(struct mg_connection *conn, agent_t *agent)
 {
-   cJSON *obj;
-   cJSON *tables;
+   mgr_fmt_t fmt;
    vecit_t table_it;
-   ui_print_cfg_t fd = INIT_UI_PRINT_CFG_CONN(conn);
 
    if (agent == NULL)
    {
       return HTTP_INTERNAL_ERROR;
    }
 
-   obj = cJSON_CreateObject();
-   cJSON_AddStringToObject(obj, "eid", agent->eid.name);
-   tables = cJSON_AddArrayToObject(obj, "tables");
-   
+   mgr_fmt_init_buf(&fmt);
+   mgr_fmt_json_open(&fmt, '{');
+   mgr_fmt_json_key(&fmt, "eid");
+   mgr_fmt_json_str(&fmt, agent->eid.name);
+   mgr_fmt_json_key(&fmt, "tables");
+   mgr_fmt_json_open(&fmt, '[');
+
    /* Iterate through all tables for this agent. */
    for(table_it = vecit_first(&(agent->tbls)); vecit_valid(table_it); table_it = vecit_next(table_it))
    {
-      tbl_t *table = ( (tbl_t*)vecit_data(table_it) );
-
-      /* Populate the data in the table */
-      cJSON_AddItemToArray(tables, ui_json_table(table) );
+      mgr_fmt_table_json(&fmt, (tbl_t*)vecit_data(table_it));
    }
 
-   SendJSON(conn, obj);
-   cJSON_Delete(obj);
+   mgr_fmt_json_close(&fmt, ']');
+   mgr_fmt_json_close(&fmt, '}');
+
+   if (SendJSONFmt(conn, &fmt) < 0)
+   {
+      return HTTP_INTERNAL_ERROR;
+   }
    return HTTP_OK;
 
 }
 
 static int agentShowRawReports(struct mg_connection *conn, agent_t *agent)
 {
-   cJSON *obj;
-   cJSON *reports;
+   mgr_fmt_t fmt;
    vecit_t rpt_it;
 
    if (agent == NULL)
    {
       return HTTP_INTERNAL_ERROR;
    }
-   
-   obj = cJSON_CreateObject();
-   cJSON_AddStringToObject(obj, "eid", agent->eid.name);
-   reports = cJSON_AddArrayToObject(obj, "reports");
-   
+
+   mgr_fmt_init_buf(&fmt);
+   mgr_fmt_json_open(&fmt, '{');
+   mgr_fmt_json_key(&fmt, "eid");
+   mgr_fmt_json_str(&fmt, agent->eid.name);
+   mgr_fmt_json_key(&fmt, "reports");
+   mgr_fmt_json_open(&fmt, '[');
+
    /* Iterate through all reports for this agent. */
    for(rpt_it = vecit_first(&(agent->rpts)); vecit_valid(rpt_it); rpt_it = vecit_next(rpt_it))
    {
-      // TODO: Erorr checking
       // TODO: Prepend "rpt:" to string to match amp.me convention for decoding
-      
       blob_t *rpt = rpt_serialize_wrapper( (rpt_t*)vecit_data(rpt_it) );
-      char *rpt_str = utils_hex_to_string(rpt->value, rpt->length);
-
-      cJSON_AddItemToArray(reports, cJSON_CreateStringReference( rpt_str ));
-      SRELEASE(rpt_str);
+      if (rpt == NULL)
+      {
+         continue;
+      }
+      mgr_fmt_json_str_begin(&fmt);
+      mgr_fmt_hex(&fmt, rpt->value, rpt->length);
+      mgr_fmt_json_str_end(&fmt);
       blob_release(rpt,1);
    }
 
-   SendJSON(conn, obj);
-   cJSON_Delete(obj);
+   mgr_fmt_json_close(&fmt, ']');
+   mgr_fmt_json_close(&fmt, '}');
+
+   if (SendJSONFmt(conn, &fmt) < 0)
+   {
+      return HTTP_INTERNAL_ERROR;
+   }
    return HTTP_OK;
 
 }
@@ -537,32 +634,42 @@ static int agentShowRawReports(struct mg_connection *conn, agent_t *agent)
 
 static int agentShowRawTables(struct mg_connection *conn, agent_t *agent)
 {
-   cJSON *obj;
-   cJSON *tables;
+   mgr_fmt_t fmt;
    vecit_t table_it;
 
    if (agent == NULL)
    {
       return HTTP_INTERNAL_ERROR;
    }
-   
-   obj = cJSON_CreateObject();
-   cJSON_AddStringToObject(obj, "eid", agent->eid.name);
-   tables = cJSON_AddArrayToObject(obj, "tables");
-   
+
+   mgr_fmt_init_buf(&fmt);
+   mgr_fmt_json_open(&fmt, '{');
+   mgr_fmt_json_key(&fmt, "eid");
+   mgr_fmt_json_str(&fmt, agent->eid.name);
+   mgr_fmt_json_key(&fmt, "tables");
+   mgr_fmt_json_open(&fmt, '[');
+
    /* Iterate through all tables for this agent. */
    for(table_it = vecit_first(&(agent->tbls)); vecit_valid(table_it); table_it = vecit_next(table_it))
    {
       blob_t *tbl = tbl_serialize_wrapper( (tbl_t*)vecit_data(table_it) );
-      char *tbl_str = utils_hex_to_string(tbl->value, tbl->length);
-
-      cJSON_AddItemToArray(tables, cJSON_CreateStringReference(tbl_str));
-      SRELEASE(tbl_str);
+      if (tbl == NULL)
+      {
+         continue;
+      }
+      mgr_fmt_json_str_begin(&fmt);
+      mgr_fmt_hex(&fmt, tbl->value, tbl->length);
+      mgr_fmt_json_str_end(&fmt);
       blob_release(tbl,1);
    }
 
-   SendJSON(conn, obj);
-   cJSON_Delete(obj);
+   mgr_fmt_json_close(&fmt, ']');
+   mgr_fmt_json_close(&fmt, '}');
+
+   if (SendJSONFmt(conn, &fmt) < 0)
+   {
+      return HTTP_INTERNAL_ERROR;
+   }
    return HTTP_OK;
 
 }
@@ -51,6 +51,8 @@
 #include "nm_rest.h"
 #endif
 #include "agents.h"
+#include "nm_mgr_fmt.h"
+#include "nm_mgr_log.h"
 #include "nmmgr.h"
 
 
@@ -81,7 +83,9 @@ int nmmgr_destroy(nmmgr_t *mgr)
 	db_mgt_close();
 #endif
 
+	mgr_log_destroy();
 	vec_release(&(gMgrDB.agents), 0);
+	mgr_fmt_names_clear();
 	rhht_release(&(gMgrDB.metadata), 0);
 
 	db_destroy();
@@ -141,6 +145,12 @@ int nmmgr_init(nmmgr_t *mgr)
 	gMgrDB.tot_rpts = 0;
 	gMgrDB.tot_tbls = 0;
 
+	if(mgr_log_init(MGR_LOG_DEF_QUEUE_LEN) != AMP_OK)
+	{
+		AMP_DEBUG_ERR("nmmgr_init", "Can't make log writer queue.", NULL);
+		return AMP_FAIL;
+	}
+
 	if((utils_mem_int() != AMP_OK) ||
 			(db_init("nmmgr_db", &adm_common_init) != AMP_OK))
 	{
@@ -162,10 +172,11 @@ int nmmgr_start(nmmgr_t *mgr)
   threadinfo_t threadinfo[] = {
       {&mgr_rx_thread, "nm_mgr_rx"},
       {&ui_thread, "nm_mgr_ui"},
+      {&mgr_log_thread, "nm_mgr_log"},
       {NULL, NULL},
   };
 #if defined(HAVE_MYSQL) || defined(HAVE_POSTGRESQL)
-  threadinfo[2] = (threadinfo_t){&db_mgt_daemon, "nm_mgr_db"};
+  threadinfo[3] = (threadinfo_t){&db_mgt_daemon, "nm_mgr_db"};
 #endif
   if (threadset_start(&mgr->threads, threadinfo, sizeof(threadinfo)/sizeof(threadinfo_t), mgr) != AMP_OK)
   {
@@ -183,6 +194,7 @@ int nmmgr_stop(nmmgr_t *mgr)
 {
   /* Notify threads */
   daemon_run_stop(&mgr->running);
+  mgr_log_wake();
   threadset_join(&mgr->threads);
 
 #ifdef USE_CIVETWEB
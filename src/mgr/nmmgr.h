@@ -44,6 +44,7 @@
 // Standard includes
 #include <stdint.h>
 #include <pthread.h>
+#include <stdatomic.h>
 #include <unistd.h>
 
 
@@ -73,6 +74,8 @@ extern "C" {
 
 /* Constants */
 #define NM_MGR_MAX_META (1024)
+/// Most threads which may process received groups
+#define MGR_RX_MAX_WORKERS (64)
 
 
 typedef enum mgr_ui_mode_enum {
@@ -97,6 +100,9 @@ typedef struct {
   mif_cfg_t mif;
   /// Threads associated with the mgr
   list_thread_t threads;
+  /// Number of threads processing received groups, each taking the
+  /// agents whose EIDs hash to it. Zero processes them in the receive thread.
+  size_t rx_workers;
 
 } nmmgr_t;
 
@@ -105,8 +111,8 @@ typedef struct
 {
 	vector_t agents;  /* (agent_t *) */
 	rhht_t metadata; /* (metadata_t*) */
-	amp_uvast tot_rpts;
-	amp_uvast tot_tbls;
+	atomic_uint_fast64_t tot_rpts;
+	atomic_uint_fast64_t tot_tbls;
 
 #if defined(HAVE_MYSQL) || defined(HAVE_POSTGRESQL)
 	sql_db_t sql_info;
@@ -386,7 +386,7 @@ ac_t *ui_input_ac(const char *prompt)
 		char ari_prompt[24];
 		snprintf(ari_prompt, 24, "Build ARI %d", i);
 		ari_t *cur = ui_input_ari(ari_prompt, ADM_ENUM_ALL, TYPE_MASK_ALL);
-		if(cur == NULL || vec_push(&(result->values), cur) != VEC_OK)
+		if(cur == NULL || vec_push(&(result->values), cur) != AMP_OK)
 		{
 			AMP_DEBUG_ERR("ui_input_ac","Could not input ARI %d.", i);
 			ac_release(result, 1);
@@ -526,7 +526,7 @@ ari_t* ui_input_ari_build(amp_uvast mask)
 	if(ARI_GET_FLAG_NN(flags))
 	{
 		amp_uvast nn = ui_input_uvast("ARI Nickname:");
-		if(VDB_ADD_NN(nn, &(result->as_reg.nn_idx)) != VEC_OK)
+		if(VDB_ADD_NN(nn, &(result->as_reg.nn_idx)) != AMP_OK)
 		{
 			AMP_DEBUG_ERR("ui_input_ari","Unable to add nickname.", NULL);
 			ari_release(result, 1);
@@ -538,7 +538,7 @@ ari_t* ui_input_ari_build(amp_uvast mask)
 	{
 #if AMP_VERSION < 7
 		amp_uvast iss = ui_input_uvast("ARI Issuer:");
-		if(VDB_ADD_ISS(iss, &(result->as_reg.iss_idx)) != VEC_OK)
+		if(VDB_ADD_ISS(iss, &(result->as_reg.iss_idx)) != AMP_OK)
 		{
 			AMP_DEBUG_ERR("ui_input_ari","Unable to add issuer.", NULL);
 			ari_release(result, 1);
@@ -552,7 +552,7 @@ ari_t* ui_input_ari_build(amp_uvast mask)
 			ari_release(result, 1);
 			return NULL;
         }
-		else if(VDB_ADD_ISS(*issuer, &(result->as_reg.iss_idx)) != VEC_OK)
+		else if(VDB_ADD_ISS(*issuer, &(result->as_reg.iss_idx)) != AMP_OK)
 		{
 			AMP_DEBUG_ERR("ui_input_ari","Unable to add issuer.", NULL);
 			blob_release(issuer, 1);
@@ -573,7 +573,7 @@ ari_t* ui_input_ari_build(amp_uvast mask)
 			ari_release(result, 1);
 			return NULL;
         }
-		else if(VDB_ADD_TAG(*tag, &(result->as_reg.tag_idx)) != VEC_OK)
+		else if(VDB_ADD_TAG(*tag, &(result->as_reg.tag_idx)) != AMP_OK)
 		{
 			AMP_DEBUG_ERR("ui_input_ari","Unable to add issuer.", NULL);
 			blob_release(tag, 1);
@@ -921,10 +921,9 @@ int ui_input_parms(ari_t *id)
 			return AMP_FAIL;
         }
         
-		if(vec_push(&(id->as_reg.parms.values), val) != VEC_OK)
+		if(tnvc_insert(&(id->as_reg.parms), val) != AMP_OK)
 		{
 			AMP_DEBUG_ERR("ui_input_parms", "Can't add parameter.", NULL);
-			tnv_release(val, 1);
 			return AMP_FAIL;
 		}
 	}
@@ -56,7 +56,7 @@ vector_t g_adm_info;
  * It is initialized in adm_amp_agent_(agent|mgr).c, but it is a resource global to all ADMs.
  * That initialization should be moved to this file at a later date (TODO)
  */
-vec_idx_t g_amp_agent_idx[11];
+reg_idx_t g_amp_agent_idx[11];
 
 int adm_add_adm_info(char *name, int id)
 {
@@ -171,13 +171,84 @@ int adm_add_ctrldef_ari(ari_t *id, uint8_t num, ctrldef_run_fn run)
 	return ((rh_code == RH_OK) || (rh_code == RH_DUPLICATE)) ? AMP_OK : AMP_FAIL;
 }
 
-int adm_add_ctrldef(uint8_t nn, amp_uvast name, uint8_t num, ctrldef_run_fn run)
+int adm_add_ctrldef(reg_idx_t nn, amp_uvast name, uint8_t num, ctrldef_run_fn run)
 {
 	ari_t *id = adm_build_ari(AMP_TYPE_CTRL, (num > 0) ? 1 : 0, nn, name);
 
 	return adm_add_ctrldef_ari(id, num, run);
 }
 
+/******************************************************************************
+ *
+ * \par Function Name: adm_add_descs
+ *
+ * \par Registers a static table of ADM constants, EDDs, operators and controls
+ *      with the local AMP actor.
+ *
+ * \retval AMP STATUS CODE
+ *
+ * \param[in] nn     The nickname indices of the ADM, by ADM_*_IDX slot.
+ * \param[in] descs  The descriptors, usually from ADM_DESC_* entries.
+ * \param[in] num    The number of descriptors.
+ *
+ * \par Notes:
+ *   - Every descriptor is attempted. The result is AMP_FAIL if any failed.
+ *   - Names were CBOR-encoded when the table was built, so each ARI is made
+ *     by copying bytes rather than running an encoder.
+ *****************************************************************************/
+int adm_add_descs(const reg_idx_t *nn, const adm_desc_t *descs, size_t num)
+{
+	const adm_desc_t *desc;
+	ari_t *id;
+	size_t failed = 0;
+	int success;
+
+	CHKUSR(nn, AMP_FAIL);
+	CHKUSR(descs, AMP_FAIL);
+
+	for(desc = descs; desc < descs + num; desc++)
+	{
+		uint8_t has_parms = ((desc->type == AMP_TYPE_EDD) || (desc->type == AMP_TYPE_CTRL)) && (desc->num_parms > 0);
+
+		if(desc->name_len > 0)
+		{
+			id = adm_build_ari_name(desc->type, has_parms, nn[desc->nn], desc->name, desc->name_len);
+		}
+		else
+		{
+			id = adm_build_ari(desc->type, has_parms, nn[desc->nn], desc->id);
+		}
+
+		switch(desc->type)
+		{
+			case AMP_TYPE_CNST:
+				success = adm_add_cnst(id, desc->fn.collect);
+				break;
+			case AMP_TYPE_EDD:
+				success = adm_add_edd(id, desc->fn.collect);
+				break;
+			case AMP_TYPE_OPER:
+				success = adm_add_op_kernel(id, desc->num_parms, desc->fn.apply, desc->kernel);
+				break;
+			case AMP_TYPE_CTRL:
+				success = adm_add_ctrldef_ari(id, desc->num_parms, desc->fn.run);
+				break;
+			default:
+				ari_release(id, 1);
+				success = AMP_FAIL;
+				break;
+		}
+
+		if(success != AMP_OK)
+		{
+			AMP_DEBUG_ERR("adm_add_descs","Cannot add %s %d.", type_to_str(desc->type), (int) desc->id);
+			failed++;
+		}
+	}
+
+	return (failed == 0) ? AMP_OK : AMP_FAIL;
+}
+
 /******************************************************************************
  *
  * \par Function Name: adm_add_edd
@@ -315,7 +386,7 @@ int adm_add_macdef(macdef_t *def)
 		return AMP_FAIL;
 	}
 
-	rh_code = VDB_ADD_MACDEF(def->ari, def);
+	rh_code = VDB_ADD_ADM_MACDEF(def->ari, def);
 
 	if(rh_code == RH_DUPLICATE)
 	{
@@ -370,6 +441,11 @@ int adm_add_macdef_ctrl(macdef_t *def, ari_t *id)
  *  10/02/18  E. Birrane     Updated to AMP v0.5 (JHU/APL)
  *****************************************************************************/
 int adm_add_op_ari(ari_t *id, uint8_t num_parm, op_fn apply_fn)
+{
+	return adm_add_op_kernel(id, num_parm, apply_fn, NULL);
+}
+
+int adm_add_op_kernel(ari_t *id, uint8_t num_parm, op_fn apply_fn, op_kernel_fn kernel)
 {
 	op_t *def = NULL;
 	int rh_code;
@@ -381,6 +457,7 @@ int adm_add_op_ari(ari_t *id, uint8_t num_parm, op_fn apply_fn)
 		ari_release(id, 1);
 		return AMP_FAIL;
 	}
+	def->kernel = kernel;
 
 	rh_code = VDB_ADD_OP(def->id, def);
 
@@ -398,7 +475,7 @@ int adm_add_op_ari(ari_t *id, uint8_t num_parm, op_fn apply_fn)
 	return ((rh_code == RH_OK) || (rh_code == RH_DUPLICATE)) ? AMP_OK : AMP_FAIL;
 }
 
-int adm_add_op(vec_idx_t nn, amp_uvast name, uint8_t num_parm, op_fn apply_fn)
+int adm_add_op(reg_idx_t nn, amp_uvast name, uint8_t num_parm, op_fn apply_fn)
 {
 	// The OPER ARI itself has no parameters, but the operator consumes stack items
 	// the OPER ARI could have parameters but the num_parm is actually num_operands
@@ -441,7 +518,7 @@ int adm_add_rpttpl(rpttpl_t *def)
 		return AMP_FAIL;
 	}
 
-	rh_code = VDB_ADD_RPTT(def->id, def);
+	rh_code = VDB_ADD_ADM_RPTT(def->id, def);
 
 	if(rh_code == RH_DUPLICATE)
 	{
@@ -499,7 +576,7 @@ int	adm_add_var_from_expr(ari_t *id, amp_type_e type, expr_t *expr)
 		return AMP_FAIL;
 	}
 
-	rh_code = VDB_ADD_VAR(new_var->id, new_var);
+	rh_code = VDB_ADD_ADM_VAR(new_var->id, new_var);
 
 	if(rh_code == RH_DUPLICATE)
 	{
@@ -531,7 +608,7 @@ int adm_add_var_from_tnv(ari_t *id, tnv_t value)
 		return AMP_FAIL;
 	}
 
-	rh_code = VDB_ADD_VAR(new_var->id, new_var);
+	rh_code = VDB_ADD_ADM_VAR(new_var->id, new_var);
 
 	if(rh_code == RH_DUPLICATE)
 	{
@@ -546,8 +623,41 @@ int adm_add_var_from_tnv(ari_t *id, tnv_t value)
 }
 
 
+/*
+ * Builds an ADM ARI from its already encoded name.
+ */
+ari_t* adm_build_ari_name(amp_type_e type, uint8_t has_parms, reg_idx_t nn, const uint8_t *name, size_t len)
+{
+	ari_t *result = ari_create(type);
+	CHKNULL(result);
+
+	result->as_reg.flags = 0;
+	ARI_SET_FLAG_TYPE(result->as_reg.flags, type);
+	ARI_SET_FLAG_NN(result->as_reg.flags);
+	if(has_parms)
+	{
+		ARI_SET_FLAG_PARM(result->as_reg.flags);
+	}
+
+	result->as_reg.nn_idx = nn;
+
+	if(blob_init(&(result->as_reg.name), (uint8_t *) name, len, len) != AMP_OK)
+	{
+		ari_release(result, 1);
+		return NULL;
+	}
+
+	if(ari_intern(result) != AMP_OK)
+	{
+		ari_release(result, 1);
+		return NULL;
+	}
+
+	return result;
+}
+
 // Takes over name and parms, no matter what.
-ari_t* adm_build_ari(amp_type_e type, uint8_t has_parms, vec_idx_t nn, amp_uvast id)
+ari_t* adm_build_ari(amp_type_e type, uint8_t has_parms, reg_idx_t nn, amp_uvast id)
 {
 	ari_t *result = ari_create(type);
 	CHKNULL(result);
@@ -578,11 +688,17 @@ ari_t* adm_build_ari(amp_type_e type, uint8_t has_parms, vec_idx_t nn, amp_uvast
 		return NULL;
 	}
 
+	if(ari_intern(result) != AMP_OK)
+	{
+		ari_release(result, 1);
+		return NULL;
+	}
+
 	return result;
 }
 
 
-ari_t *adm_build_ari_parm_6(amp_type_e type, vec_idx_t nn, amp_uvast id, tnv_t *p1, tnv_t *p2, tnv_t* p3, tnv_t *p4, tnv_t *p5, tnv_t *p6)
+ari_t *adm_build_ari_parm_6(amp_type_e type, reg_idx_t nn, amp_uvast id, tnv_t *p1, tnv_t *p2, tnv_t* p3, tnv_t *p4, tnv_t *p5, tnv_t *p6)
 {
 	ari_t *ari = adm_build_ari(type, 1, nn, id);
 
@@ -94,6 +94,32 @@ extern vector_t g_adm_info;
 #define ADM_BUILD_ARI_PARM_5(t, n, i, p1, p2, p3, p4, p5) adm_build_ari_parm_6(t, n, i, p1, p2, p3, p4, p5, NULL)
 #define ADM_BUILD_ARI_PARM_6(t, n, i, p1, p2, p3, p4, p5, p6) adm_build_ari_parm_6(t, n, i, p1, p2, p3, p4, p5, p6)
 
+/*
+ * The CBOR encoding of an object name, computed at build time for names up
+ * to 16 bits. Larger names have a zero length and are encoded at startup.
+ */
+#define ADM_CBOR_UINT_LEN(v) (((v) < 24) ? 1 : (((v) < 0x100) ? 2 : (((v) < 0x10000) ? 3 : 0)))
+#define ADM_CBOR_UINT(v) { \
+	((v) < 24) ? (uint8_t)(v) : (((v) < 0x100) ? 0x18 : 0x19), \
+	((v) < 0x100) ? (uint8_t)(v) : (uint8_t)((v) >> 8), \
+	(uint8_t)(v) }
+
+#define ADM_DESC_NAME(obj) .id = (obj), .name_len = ADM_CBOR_UINT_LEN(obj), .name = ADM_CBOR_UINT(obj)
+
+/* Entries of a static ADM descriptor table, see adm_add_descs(). */
+#define ADM_DESC_CNST(slot, obj, func) \
+	{ .type = AMP_TYPE_CNST, .nn = (slot), ADM_DESC_NAME(obj), .fn.collect = (func) }
+#define ADM_DESC_EDD(slot, obj, has_parms, func) \
+	{ .type = AMP_TYPE_EDD, .nn = (slot), .num_parms = (has_parms), ADM_DESC_NAME(obj), .fn.collect = (func) }
+#define ADM_DESC_OP(slot, obj, num, func) \
+	{ .type = AMP_TYPE_OPER, .nn = (slot), .num_parms = (num), ADM_DESC_NAME(obj), .fn.apply = (func) }
+#define ADM_DESC_OP_KERNEL(slot, obj, num, func, kern) \
+	{ .type = AMP_TYPE_OPER, .nn = (slot), .num_parms = (num), ADM_DESC_NAME(obj), .fn.apply = (func), .kernel = (kern) }
+#define ADM_DESC_CTRL(slot, obj, num, func) \
+	{ .type = AMP_TYPE_CTRL, .nn = (slot), .num_parms = (num), ADM_DESC_NAME(obj), .fn.run = (func) }
+
+#define ADM_NUM_DESCS(descs) (sizeof(descs) / sizeof((descs)[0]))
+
 
 /*
  * +--------------------------------------------------------------------------+
@@ -108,6 +134,29 @@ typedef struct
 } adm_info_t;
 
 
+/**
+ * A read-only description of one ADM constant, EDD, operator or control,
+ * generated as part of a static table so that a whole ADM registers in one
+ * call without building each ARI by hand.
+ */
+typedef struct
+{
+	amp_type_e type;      /**> CNST, EDD, OPER or CTRL. */
+	uint8_t    nn;        /**> Nickname slot within the ADM, e.g. ADM_EDD_IDX. */
+	uint8_t    num_parms; /**> Parameters of a CTRL, operands of an OPER, non-zero for a parameterized EDD. */
+	uint8_t    name_len;  /**> Length of the encoded name, or 0 to encode id. */
+	uint8_t    name[3];   /**> The id, already CBOR-encoded. */
+	amp_uvast  id;
+	union
+	{
+		edd_collect_fn collect;
+		op_fn          apply;
+		ctrldef_run_fn run;
+	} fn;
+	op_kernel_fn kernel;  /**> Optional unboxed fast path of an OPER. */
+} adm_desc_t;
+
+
 /*
  * +--------------------------------------------------------------------------+
  * |						  FUNCTION PROTOTYPES  							  +
@@ -117,15 +166,17 @@ typedef struct
 int adm_add_adm_info(char *name, int id);
 
 int adm_add_cnst(ari_t *id, edd_collect_fn collect);
-int adm_add_ctrldef(uint8_t nn, amp_uvast id, uint8_t num, ctrldef_run_fn run);
+int adm_add_ctrldef(reg_idx_t nn, amp_uvast id, uint8_t num, ctrldef_run_fn run);
 int adm_add_ctrldef_ari(ari_t *id, uint8_t num, ctrldef_run_fn run);
 
+int adm_add_descs(const reg_idx_t *nn, const adm_desc_t *descs, size_t num);
 int adm_add_edd(ari_t *id, edd_collect_fn collect);
 int adm_add_lit(ari_t *id);
 int adm_add_macdef(macdef_t *def);
 int adm_add_macdef_ctrl(macdef_t *def, ari_t *id);
-int adm_add_op(vec_idx_t nn, amp_uvast name, uint8_t num_parm, op_fn apply_fn);
+int adm_add_op(reg_idx_t nn, amp_uvast name, uint8_t num_parm, op_fn apply_fn);
 int adm_add_op_ari(ari_t *id, uint8_t num_parm, op_fn apply_fn);
+int adm_add_op_kernel(ari_t *id, uint8_t num_parm, op_fn apply_fn, op_kernel_fn kernel);
 
 int adm_add_rpttpl(rpttpl_t *def);
 int adm_add_tblt(tblt_t *def);
@@ -133,8 +184,9 @@ int	adm_add_var_from_expr(ari_t *id, amp_type_e type, expr_t *expr);
 int adm_add_var_from_tnv(ari_t *id, tnv_t value)
 ;
 
-ari_t* adm_build_ari(amp_type_e type, uint8_t has_parms, vec_idx_t nn, amp_uvast id);
-ari_t *adm_build_ari_parm_6(amp_type_e type, vec_idx_t nn, amp_uvast id, tnv_t *p1, tnv_t *p2, tnv_t* p3, tnv_t *p4, tnv_t *p5, tnv_t *p6);
+ari_t* adm_build_ari(amp_type_e type, uint8_t has_parms, reg_idx_t nn, amp_uvast id);
+ari_t* adm_build_ari_name(amp_type_e type, uint8_t has_parms, reg_idx_t nn, const uint8_t *name, size_t len);
+ari_t *adm_build_ari_parm_6(amp_type_e type, reg_idx_t nn, amp_uvast id, tnv_t *p1, tnv_t *p2, tnv_t* p3, tnv_t *p4, tnv_t *p5, tnv_t *p6);
 
 
 int32_t adm_get_parm_int(tnvc_t *parms, uint8_t idx, int *success);
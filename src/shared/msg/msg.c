@@ -42,6 +42,7 @@
 #include "../msg/msg.h"
 #include "../utils/utils.h"
 #include "../utils/cbor_utils.h"
+#include "../utils/trace.h"
 #include "../utils/vector.h"
 
 msg_hdr_t msg_hdr_deserialize(QCBORDecodeContext *it, int *success)
@@ -289,6 +290,7 @@ int msg_rpt_add_rpt(msg_rpt_t *msg, rpt_t *rpt)
 		return AMP_FAIL;
 	}
 
+	NM_TRACE3(rpt__add, msg, rpt, vec_num_entries(msg->rpts));
 	return AMP_OK;
 }
 
@@ -308,6 +310,7 @@ msg_rpt_t* msg_rpt_create(char *rx_name)
 	CHKNULL(result);
 
 	MSG_HDR_SET_OPCODE(result->hdr.flags,MSG_TYPE_RPT_SET);
+	result->prio = AMP_PRIO_NORMAL;
 
 	if(vec_str_init(&(result->rx), 0) != VEC_OK)
 	{
@@ -440,6 +443,19 @@ blob_t* msg_rpt_serialize_wrapper(msg_rpt_t *msg)
 }
 
 
+int msg_tbl_add_delta(msg_tbl_t *msg, tbl_delta_t *delta)
+{
+	CHKUSR(msg, AMP_FAIL);
+	CHKUSR(delta, AMP_FAIL);
+
+	if(vec_push(&(msg->deltas), delta) != VEC_OK)
+	{
+		return AMP_FAIL;
+	}
+
+	return AMP_OK;
+}
+
 int msg_tbl_add_tbl(msg_tbl_t *msg, tbl_t *tbl)
 {
 	CHKUSR(msg, AMP_FAIL);
@@ -467,6 +483,7 @@ msg_tbl_t* msg_tbl_create(char *rx_name)
 	CHKNULL(result);
 
 	MSG_HDR_SET_OPCODE(result->hdr.flags,MSG_TYPE_TBL_SET);
+	result->prio = AMP_PRIO_NORMAL;
 
 	if(vec_str_init(&(result->rx), 0) != VEC_OK)
 	{
@@ -503,6 +520,15 @@ msg_tbl_t* msg_tbl_create(char *rx_name)
 		return NULL;
 	}
 
+	result->deltas = vec_create(0, tbl_delta_cb_del_fn, NULL, NULL, VEC_FLAG_AS_STACK, &success);
+	if(success != VEC_OK)
+	{
+		vec_release(&(result->rx), 0);
+		vec_release(&(result->tbls), 0);
+		SRELEASE(result);
+		return NULL;
+	}
+
 	return result;
 }
 
@@ -537,8 +563,17 @@ msg_tbl_t *msg_tbl_deserialize(blob_t *data, int *success)
 		return NULL;
 	}
 
-	/* Step 3: Grab the array of table entries. */
-	if((cut_deserialize_vector(&(result->tbls), &it, tbl_deserialize_ptr)) != AMP_OK)
+	/* Step 3: Grab the array of table entries, whole or incremental. */
+	if(MSG_HDR_GET_OPCODE(result->hdr.flags) == MSG_TYPE_TBL_DELTA)
+	{
+		*success = cut_deserialize_vector(&(result->deltas), &it, tbl_delta_deserialize_ptr);
+	}
+	else
+	{
+		*success = cut_deserialize_vector(&(result->tbls), &it, tbl_deserialize_ptr);
+	}
+
+	if(*success != AMP_OK)
 	{
 		*success = AMP_FAIL;
 		msg_tbl_release(result, 1);
@@ -557,6 +592,7 @@ void msg_tbl_release(msg_tbl_t *msg, int destroy)
 	CHKVOID(msg);
 	vec_release(&(msg->rx), 0);
 	vec_release(&(msg->tbls), 0);
+	vec_release(&(msg->deltas), 0);
 	if(destroy)
 	{
 		SRELEASE(msg);
@@ -590,6 +626,32 @@ blob_t* msg_tbl_serialize_wrapper(msg_tbl_t *msg)
 	return cut_serialize_wrapper(MSG_DEFAULT_ENC_SIZE, msg, (cut_enc_fn)msg_tbl_serialize);
 }
 
+
+/*
+ * Serializes the incremental tables of a table set, which go in a message of
+ * their own so that a manager which can't rebuild them rejects only those.
+ */
+int msg_tbl_delta_serialize(QCBOREncodeContext *encoder, void *item)
+{
+	msg_tbl_t *msg = (msg_tbl_t *)item;
+	msg_hdr_t hdr;
+
+	hdr.flags = msg->hdr.flags & ~MSG_HDR_FLG_OPCODE;
+	MSG_HDR_SET_OPCODE(hdr.flags, MSG_TYPE_TBL_DELTA);
+
+	if (msg_hdr_serialize(encoder, hdr) != AMP_OK)
+	{
+		return AMP_FAIL;
+	}
+
+	if (cut_serialize_vector(encoder, &(msg->rx), (cut_enc_fn)cut_char_serialize) != AMP_OK)
+	{
+		return AMP_FAIL;
+	}
+
+	return cut_serialize_vector(encoder, &(msg->deltas), (cut_enc_fn)tbl_delta_serialize);
+}
+
 #if 0
 void msg_release(void *msg, int msg_type, int destroy)
 {
@@ -698,6 +760,26 @@ int msg_grp_add_msg_tbl(msg_grp_t *grp, msg_tbl_t *msg)
 }
 
 
+int msg_grp_add_msg_tbl_delta(msg_grp_t *grp, msg_tbl_t *msg)
+{
+	blob_t *result = NULL;
+	int success;
+
+	CHKUSR(grp, AMP_FAIL);
+	CHKUSR(msg, AMP_FAIL);
+
+	result = cut_serialize_wrapper(MSG_DEFAULT_ENC_SIZE, msg, (cut_enc_fn)msg_tbl_delta_serialize);
+	CHKUSR(result, AMP_FAIL);
+
+	if((success = msg_grp_add_msg(grp, result, MSG_TYPE_TBL_DELTA)) != AMP_OK)
+	{
+		blob_release(result, 1);
+	}
+
+	return success;
+}
+
+
 msg_grp_t  *msg_grp_create(uint8_t length)
 {
 	msg_grp_t *result = STAKE(sizeof(msg_grp_t));
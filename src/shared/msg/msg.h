@@ -61,6 +61,7 @@ extern "C" {
 #define MSG_TYPE_RPT_SET   (1)
 #define MSG_TYPE_PERF_CTRL (2)
 #define MSG_TYPE_TBL_SET   (3)
+#define MSG_TYPE_TBL_DELTA (4)
 
 
 #define MSG_HDR_FLG_OPCODE (0x7)
@@ -109,6 +110,10 @@ typedef struct
 	msg_hdr_t hdr;
 	vector_t rx;   /**> Recipients for the report. (char *)*/
 	vector_t rpts; /**> (rpt_t *) */
+
+	/* Agent-local, never serialized. */
+	uint8_t prio;      /**> Class of the reports (amp_prio_e). */
+	OS_time_t created; /**> When the message was started. */
 } msg_rpt_t;
 
 typedef struct
@@ -116,6 +121,11 @@ typedef struct
 	msg_hdr_t hdr;
 	vector_t rx; /**> (char *) */
 	vector_t tbls; /**> (tbl_t *) */
+	vector_t deltas; /**> (tbl_delta_t *), sent as a MSG_TYPE_TBL_DELTA message */
+
+	/* Agent-local, never serialized. */
+	uint8_t prio;      /**> Class of the tables (amp_prio_e). */
+	OS_time_t created; /**> When the message was started. */
 } msg_tbl_t;
 
 /*
@@ -182,6 +192,7 @@ int msg_rpt_serialize(QCBOREncodeContext *encoder, void *item);
 blob_t*    msg_rpt_serialize_wrapper(msg_rpt_t *msg);
 
 
+int        msg_tbl_add_delta(msg_tbl_t *msg_tbl, tbl_delta_t *delta);
 int        msg_tbl_add_tbl(msg_tbl_t *msg_tbl, tbl_t *tbl);
 
 void       msg_tbl_cb_del_fn(void *item);
@@ -195,6 +206,7 @@ void       msg_tbl_release(msg_tbl_t *pdu, int destroy);
 int msg_tbl_serialize(QCBOREncodeContext *encoder, void *item);
 
 blob_t*    msg_tbl_serialize_wrapper(msg_tbl_t *msg);
+int        msg_tbl_delta_serialize(QCBOREncodeContext *encoder, void *item);
 
 
 
@@ -204,6 +216,7 @@ int        msg_grp_add_msg_agent(msg_grp_t *grp, msg_agent_t *msg);
 int        msg_grp_add_msg_ctrl(msg_grp_t *grp, msg_ctrl_t *msg);
 int        msg_grp_add_msg_rpt(msg_grp_t *grp, msg_rpt_t *msg);
 int        msg_grp_add_msg_tbl(msg_grp_t *grp, msg_tbl_t *msg);
+int        msg_grp_add_msg_tbl_delta(msg_grp_t *grp, msg_tbl_t *msg);
 
 msg_grp_t* msg_grp_create(uint8_t length);
 
@@ -42,6 +42,7 @@
 #include <inttypes.h>
 #include "../utils/nm_types.h"
 #include "../utils/utils.h"
+#include "../utils/trace.h"
 #include "msg.h"
 #include "msg_if.h"
 
@@ -108,49 +109,105 @@ blob_t *mif_receive(mif_cfg_t *cfg, msg_metadata_t *meta, daemon_run_t *running,
 int mif_send_grp(mif_cfg_t *cfg, const msg_grp_t *group, const eid_t *destination)
 {
     blob_t *data = NULL;
+    int success;
 
     CHKZERO(cfg);
-    CHKZERO(cfg->send);
     CHKZERO(group);
     CHKZERO(destination);
     AMP_DEBUG_ENTRY("mif_send","(%p,%s)", group, destination->name);
 
     /* Step 1 - Serialize the bundle. */
+    NM_TRACE2(grp__encode__begin, group, vec_num_entries(group->msgs));
     if((data = msg_grp_serialize_wrapper(group)) == NULL)
     {
     	AMP_DEBUG_ERR("mif_send","Bad message of length 0.", NULL);
     	AMP_DEBUG_EXIT("mif_send", "->0.", NULL);
     	return 0;
     }
+    NM_TRACE2(grp__encode__end, group, data->length);
+
+    /* Step 2 - Hand it to the transport. */
+    success = mif_send_blob(cfg, data, destination);
+
+    blob_release(data, 1);
+    AMP_DEBUG_EXIT("mif_send", "->%d.", success);
+    return success;
+}
+
+
+/******************************************************************************
+ *
+ * \par Function Name: mif_send_blob
+ *
+ * \par Sends an already-serialized message group to the recipient node.
+ *
+ * \retval AMP_OK if the transport accepted the data, otherwise the
+ *         transport did not and the data may be sent again later.
+ *
+ * \param[in] cfg          The registered interface
+ * \param[in] data         The serialized message group.
+ * \param[in] destination  The EID of the recipient of the data.
+ *****************************************************************************/
+
+int mif_send_blob(mif_cfg_t *cfg, const blob_t *data, const eid_t *destination)
+{
+    CHKZERO(cfg);
+    CHKZERO(cfg->send);
+    CHKZERO(data);
+    CHKZERO(destination);
 
     if(data->length == 0)
     {
     	AMP_DEBUG_ERR("mif_send","Cannot send empty data.", NULL);
-    	blob_release(data, 1);
     	return AMP_FAIL;
     }
 
-    /* Information on bitstream we are sending. */
-    char *msg_str = utils_hex_to_string(data->value, data->length);
+#if AMP_DEBUGGING == 1
+    /* Information on bitstream we are sending, as much as a log line holds. */
+    char msg_str[AMP_GMSG_BUFLEN];
+    msg_str[0] = '0';
+    msg_str[1] = 'x';
+    utils_hex_encode(msg_str + 2, data->value, MIN(data->length, (AMP_GMSG_BUFLEN - 3) / 2));
     AMP_DEBUG_ALWAYS("mif_send","Sending msgs:%s to %s:", msg_str, destination->name);
-    SRELEASE(msg_str);
+#endif
 
-    (cfg->send)(data, destination, cfg->ctx);
+    NM_TRACE2(grp__send__begin, destination->name, data->length);
+    if((cfg->send)(data, destination, cfg->ctx) != AMP_OK)
+    {
+    	AMP_DEBUG_WARN("mif_send","Transport rejected %zu bytes to %s.", data->length, destination->name);
+    	NM_TRACE3(grp__send__end, destination->name, data->length, AMP_FAIL);
+    	return AMP_FAIL;
+    }
 
-    blob_release(data, 1);
-    AMP_DEBUG_EXIT("mif_send", "->1.", NULL);
-    return 1;
+    NM_TRACE3(grp__send__end, destination->name, data->length, AMP_OK);
+    return AMP_OK;
 }
 
-// Caller MUST release msg.
-int mif_send_msg(mif_cfg_t *cfg, int msg_type, const void *msg, const eid_t *destination, amp_tv_t timestamp)
+
+/******************************************************************************
+ *
+ * \par Function Name: mif_serialize_msg
+ *
+ * \par Wraps a single message in a group and serializes that group, so that
+ *      it can be held and sent later with mif_send_blob().
+ *
+ * \retval NULL - Error
+ *         !NULL - The serialized group, which the caller must release.
+ *
+ * \param[in] msg_type   The MSG_TYPE_* of the message.
+ * \param[in] msg        The message, which is not consumed.
+ * \param[in] timestamp  The group timestamp.
+ *****************************************************************************/
+
+blob_t *mif_serialize_msg(int msg_type, const void *msg, amp_tv_t timestamp)
 {
-	msg_grp_t *grp = msg_grp_create(1);
-	grp->timestamp = timestamp;
+	msg_grp_t *grp = NULL;
+	blob_t *data = NULL;
 	int success;
 
-	CHKERR(msg);
-	CHKERR(grp);
+	CHKNULL(msg);
+	CHKNULL(grp = msg_grp_create(1));
+	grp->timestamp = timestamp;
 
 	switch(msg_type)
 	{
@@ -165,6 +222,9 @@ int mif_send_msg(mif_cfg_t *cfg, int msg_type, const void *msg, const eid_t *des
 			break;
 		case MSG_TYPE_TBL_SET:
             success = msg_grp_add_msg_tbl(grp, msg);
+            break;
+		case MSG_TYPE_TBL_DELTA:
+            success = msg_grp_add_msg_tbl_delta(grp, msg);
             break;
 		default:
 			success = AMP_FAIL;
@@ -173,9 +233,27 @@ int mif_send_msg(mif_cfg_t *cfg, int msg_type, const void *msg, const eid_t *des
 
 	if(success == AMP_OK)
 	{
-            success = mif_send_grp(cfg, grp, destination);
+		data = msg_grp_serialize_wrapper(grp);
 	}
 
 	msg_grp_release(grp, 1);
+	return data;
+}
+
+// Caller MUST release msg.
+int mif_send_msg(mif_cfg_t *cfg, int msg_type, const void *msg, const eid_t *destination, amp_tv_t timestamp)
+{
+	blob_t *data;
+	int success;
+
+	CHKERR(msg);
+
+	if((data = mif_serialize_msg(msg_type, msg, timestamp)) == NULL)
+	{
+		return AMP_FAIL;
+	}
+
+	success = mif_send_blob(cfg, data, destination);
+	blob_release(data, 1);
 	return success;
 }
@@ -109,6 +109,8 @@ typedef struct
 blob_t *mif_receive(mif_cfg_t *cfg, msg_metadata_t *meta, daemon_run_t *running, int *success);
 int     mif_send_grp(mif_cfg_t *cfg, const msg_grp_t *group, const eid_t *destination);
 int     mif_send_msg(mif_cfg_t *cfg, int msg_type, const void *msg, const eid_t *destination, amp_tv_t timestamp);
+int     mif_send_blob(mif_cfg_t *cfg, const blob_t *data, const eid_t *destination);
+blob_t *mif_serialize_msg(int msg_type, const void *msg, amp_tv_t timestamp);
 
 #ifdef __cplusplus
 }
@@ -36,6 +36,7 @@
  *****************************************************************************/
 
 #include <inttypes.h>
+#include <pthread.h>
 #include "shared/platform.h"
 #include "shared/utils/utils.h"
 #include "shared/utils/nm_types.h"
@@ -43,12 +44,162 @@
 #include "ari.h"
 #include "tnv.h"
 
+/*
+ * An interned ARI identity. Only the objects an ADM defines are interned,
+ * so there are a bounded number of them. Identities are never released, so
+ * that a pointer to one stays valid for as long as any ARI may hold it. They
+ * are allocated outside of STAKE as they outlive the memory utilities.
+ */
+struct ari_ident_s
+{
+	struct ari_ident_s *next; /* Next identity in the same bucket. */
+	uint64_t hash;
+
+	amp_type_e type;
+	uint8_t flags;
+	reg_idx_t nn_idx;
+	reg_idx_t iss_idx;
+	reg_idx_t tag_idx;
+	uint32_t name_len;
+	uint8_t name[];
+};
+
+#define ARI_IDENT_INIT_BKTS 256
+
+/* The table of interned identities, grown as it fills. */
+static pthread_mutex_t gAriIdentLock = PTHREAD_MUTEX_INITIALIZER;
+static ari_ident_t   **gAriIdentBkts = NULL;
+static size_t          gAriIdentNumBkts = 0;
+static size_t          gAriIdentNum = 0;
+
 /*
  * +--------------------------------------------------------------------------+
  * |					   Private Functions  								  +
  * +--------------------------------------------------------------------------+
  */
 
+/* FNV-1a over a run of bytes. */
+static uint64_t p_ari_hash_bytes(uint64_t hash, const void *data, size_t len)
+{
+	const uint8_t *cursor = data;
+
+	while(len-- > 0)
+	{
+		hash ^= *(cursor++);
+		hash *= UINT64_C(0x100000001b3);
+	}
+	return hash;
+}
+
+/******************************************************************************
+ * Private helper function to hash the identity of a regular ARI. This is the
+ * hash precomputed for interned ARIs and must cover the same fields as
+ * p_ari_ident_match().
+ *
+ * \returns The 64-bit hash.
+ *
+ * \param[in]  ari  The regular ARI.
+ *****************************************************************************/
+
+static uint64_t p_ari_hash_reg(const ari_t *ari)
+{
+	uint64_t hash = UINT64_C(0xcbf29ce484222325);
+	const uint8_t type = ari->type;
+
+	hash = p_ari_hash_bytes(hash, &type, sizeof(type));
+	hash = p_ari_hash_bytes(hash, &(ari->as_reg.flags), sizeof(ari->as_reg.flags));
+	hash = p_ari_hash_bytes(hash, &(ari->as_reg.nn_idx), sizeof(ari->as_reg.nn_idx));
+	hash = p_ari_hash_bytes(hash, &(ari->as_reg.iss_idx), sizeof(ari->as_reg.iss_idx));
+	hash = p_ari_hash_bytes(hash, &(ari->as_reg.tag_idx), sizeof(ari->as_reg.tag_idx));
+	if(ari->as_reg.name.length > 0)
+	{
+		hash = p_ari_hash_bytes(hash, ari->as_reg.name.value, ari->as_reg.name.length);
+	}
+	return hash;
+}
+
+static int p_ari_ident_match(const ari_ident_t *ident, uint64_t hash, const ari_t *ari)
+{
+	return (ident->hash == hash) &&
+		   (ident->type == ari->type) &&
+		   (ident->flags == ari->as_reg.flags) &&
+		   (ident->nn_idx == ari->as_reg.nn_idx) &&
+		   (ident->iss_idx == ari->as_reg.iss_idx) &&
+		   (ident->tag_idx == ari->as_reg.tag_idx) &&
+		   (ident->name_len == ari->as_reg.name.length) &&
+		   ((ident->name_len == 0) ||
+			(memcmp(ident->name, ari->as_reg.name.value, ident->name_len) == 0));
+}
+
+/* Find an interned identity. Must be called with gAriIdentLock held. */
+static ari_ident_t *p_ari_ident_find(uint64_t hash, const ari_t *ari)
+{
+	ari_ident_t *cur = NULL;
+
+	if(gAriIdentNumBkts > 0)
+	{
+		for(cur = gAriIdentBkts[hash % gAriIdentNumBkts]; cur != NULL; cur = cur->next)
+		{
+			if(p_ari_ident_match(cur, hash, ari))
+			{
+				break;
+			}
+		}
+	}
+	return cur;
+}
+
+/*
+ * Points a regular ARI at its identity if that is already interned, and
+ * otherwise leaves it uninterned. This never adds an identity, so ARIs from
+ * outside the agent (as from a message) can't grow the table.
+ */
+static void p_ari_ident_attach(ari_t *ari)
+{
+	uint64_t hash;
+
+	if((ari->type == AMP_TYPE_LIT) || (ari->type == AMP_TYPE_UNK))
+	{
+		return;
+	}
+
+	hash = p_ari_hash_reg(ari);
+	pthread_mutex_lock(&gAriIdentLock);
+	ari->as_reg.ident = p_ari_ident_find(hash, ari);
+	pthread_mutex_unlock(&gAriIdentLock);
+}
+
+/* Double the intern table. Must be called with gAriIdentLock held. */
+static int p_ari_ident_grow()
+{
+	size_t num_bkts = (gAriIdentNumBkts == 0) ? ARI_IDENT_INIT_BKTS : (2 * gAriIdentNumBkts);
+	ari_ident_t **bkts = calloc(num_bkts, sizeof(ari_ident_t *));
+	size_t i;
+
+	if(bkts == NULL)
+	{
+		return AMP_SYSERR;
+	}
+
+	for(i = 0; i < gAriIdentNumBkts; i++)
+	{
+		ari_ident_t *cur = gAriIdentBkts[i];
+		while(cur != NULL)
+		{
+			ari_ident_t *next = cur->next;
+			size_t idx = cur->hash % num_bkts;
+			cur->next = bkts[idx];
+			bkts[idx] = cur;
+			cur = next;
+		}
+	}
+
+	free(gAriIdentBkts);
+	gAriIdentBkts = bkts;
+	gAriIdentNumBkts = num_bkts;
+	return AMP_OK;
+}
+
 /******************************************************************************
  * Private helper function to de-serialize a literal ARI.
  *
@@ -178,6 +329,7 @@ static ari_t p_ari_deserialize_reg(QCBORDecodeContext *it, uint8_t flags, int *s
 		return result;
 	}
 
+	p_ari_ident_attach(&result);
 	return result;
 }
 
@@ -407,7 +559,6 @@ rh_idx_t  ari_cb_hash(void *table, void *key)
 {
 	unsigned int seed = 131; /* 31 131 1313 13131 131313 etc.. */
     unsigned int hash = 0;
-	unsigned int i    = 0;
 	rhht_t *ht = (rhht_t*) table;
 	ari_t *id = (ari_t*) key;
 
@@ -417,27 +568,18 @@ rh_idx_t  ari_cb_hash(void *table, void *key)
 		return ht->num_bkts;
 	}
 
-	/* Add the type */
-	hash = (hash * seed) + id->type;
-
-	/* Based on type hash ther body. */
-	if(id->type == AMP_TYPE_LIT)
+	/* Regular ARIs hash their identity, which is precomputed if interned. */
+	if(id->type != AMP_TYPE_LIT)
 	{
-		hash = (hash * seed) + id->as_lit.flags;
-		hash = (hash * seed) + id->as_lit.value.as_uvast;
-	}
-	else
-	{
-		hash = (hash * seed) + id->as_reg.flags;
-			hash = (hash * seed) + id->as_reg.iss_idx;
-			hash = (hash * seed) + id->as_reg.nn_idx;
-			hash = (hash * seed) + id->as_reg.tag_idx;
-		for(i = 0; i < id->as_reg.name.length; i++)
-		{
-			hash = (hash * seed) + id->as_reg.name.value[i];
-		}
+		uint64_t reg_hash = (id->as_reg.ident != NULL) ? id->as_reg.ident->hash : p_ari_hash_reg(id);
+		return reg_hash % ht->num_bkts;
 	}
 
+	/* Add the type */
+	hash = (hash * seed) + id->type;
+	hash = (hash * seed) + id->as_lit.flags;
+	hash = (hash * seed) + id->as_lit.value.as_uvast;
+
    return hash % ht->num_bkts;
 }
 
@@ -508,9 +650,6 @@ void ari_cb_ht_del(rh_elt_t *elt)
 
 int ari_compare(ari_t *ari1, ari_t *ari2, int parms)
 {
-    AMP_DEBUG_ENTRY("ari_compare","(%"PRIxPTR",%"PRIxPTR")",
-    		         ari1, ari2);
-
     if((ari1 == NULL) || (ari2 == NULL))
     {
     	return -1;
@@ -526,7 +665,15 @@ int ari_compare(ari_t *ari1, ari_t *ari2, int parms)
     }
     else
     {
-    	if( (ari1->as_reg.flags    != ari2->as_reg.flags) ||
+    	/* Interned identities are the same object iff they are the same pointer. */
+    	if((ari1->as_reg.ident != NULL) && (ari2->as_reg.ident != NULL))
+    	{
+    		if(ari1->as_reg.ident != ari2->as_reg.ident)
+    		{
+    			return 1;
+    		}
+    	}
+    	else if( (ari1->as_reg.flags    != ari2->as_reg.flags) ||
     		(ari1->as_reg.iss_idx  != ari2->as_reg.iss_idx) ||
 			(ari1->as_reg.nn_idx   != ari2->as_reg.nn_idx) ||
 			(ari1->as_reg.tag_idx  != ari2->as_reg.tag_idx))
@@ -834,6 +981,85 @@ void ari_init(ari_t *ari)
 
 
 
+/******************************************************************************
+ *
+ * Points a regular ARI at the interned copy of its identity, interning the
+ * identity if this is the first ARI to name that object.
+ *
+ * \returns AMP status code.
+ *
+ * \param[in,out] ari  The ARI to intern.
+ *
+ * \notes
+ *  1. Only the identity (type, flags, nickname, issuer, tag, and name) is
+ *     interned. Parameters remain owned by each ARI.
+ *  2. Literal ARIs are not interned, and are left unchanged.
+ *  3. The identity fields of an interned ARI MUST NOT be changed afterward.
+ *  4. Interned identities are never freed, so only ARIs built from an ADM
+ *     (adm_build_ari()) are interned. Others, as deserialized from messages
+ *     or created by users, share an identity only if one already exists.
+ *****************************************************************************/
+
+int ari_intern(ari_t *ari)
+{
+	ari_ident_t *cur;
+	uint64_t hash;
+	int result = AMP_OK;
+
+	CHKUSR(ari, AMP_FAIL);
+
+	if((ari->type == AMP_TYPE_LIT) || (ari->type == AMP_TYPE_UNK))
+	{
+		return AMP_OK;
+	}
+
+	hash = p_ari_hash_reg(ari);
+
+	pthread_mutex_lock(&gAriIdentLock);
+
+	if((gAriIdentNum >= gAriIdentNumBkts) && (p_ari_ident_grow() != AMP_OK))
+	{
+		pthread_mutex_unlock(&gAriIdentLock);
+		AMP_DEBUG_ERR("ari_intern","Cannot grow intern table.", NULL);
+		return AMP_SYSERR;
+	}
+
+	if((cur = p_ari_ident_find(hash, ari)) == NULL)
+	{
+		if((cur = malloc(sizeof(ari_ident_t) + ari->as_reg.name.length)) == NULL)
+		{
+			AMP_DEBUG_ERR("ari_intern","Cannot allocate identity.", NULL);
+			result = AMP_SYSERR;
+		}
+		else
+		{
+			size_t idx = hash % gAriIdentNumBkts;
+
+			cur->hash = hash;
+			cur->type = ari->type;
+			cur->flags = ari->as_reg.flags;
+			cur->nn_idx = ari->as_reg.nn_idx;
+			cur->iss_idx = ari->as_reg.iss_idx;
+			cur->tag_idx = ari->as_reg.tag_idx;
+			cur->name_len = ari->as_reg.name.length;
+			if(cur->name_len > 0)
+			{
+				memcpy(cur->name, ari->as_reg.name.value, cur->name_len);
+			}
+			cur->next = gAriIdentBkts[idx];
+			gAriIdentBkts[idx] = cur;
+			gAriIdentNum++;
+		}
+	}
+
+	pthread_mutex_unlock(&gAriIdentLock);
+
+	ari->as_reg.ident = cur;
+	return result;
+}
+
+
+
 
 ari_t ari_null()
 {
@@ -879,6 +1105,7 @@ void ari_release(ari_t *ari, int destroy)
 	{
 		blob_release(&(ari->as_reg.name), 0);
 		tnvc_release(&(ari->as_reg.parms), 0);
+		ari->as_reg.ident = NULL;
 	}
 
 	if(destroy)
@@ -952,6 +1179,127 @@ tnvc_t *ari_resolve_parms(tnvc_t *src_parms, tnvc_t *parent_parms)
 	return result;
 }
 
+/******************************************************************************
+ *
+ * Determines whether any parameter in a set is mapped from the parameters of
+ * an enclosing object. Objects holding parameters compute this once so that
+ * unmapped parameters are never resolved.
+ *
+ * \returns 1 if any parameter is mapped, 0 otherwise.
+ *
+ * \param[in]  parms  The parameters, which may be NULL.
+ *****************************************************************************/
+
+uint8_t ari_parms_mapped(tnvc_t *parms)
+{
+	uint8_t idx;
+
+	for(idx = 0; idx < tnvc_size(parms); idx++)
+	{
+		tnv_t *cur_val = tnvc_get(parms, idx);
+
+		if((cur_val != NULL) && TNV_IS_MAP(cur_val->flags))
+		{
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+
+
+/******************************************************************************
+ *
+ * Resolves parameter flow-down from parent_parms into src_parms without
+ * copying any parameter.
+ *
+ * \returns src_parms itself if nothing needs to be resolved, view if it was
+ *          initialized with the resolved parameters, or NULL on error.
+ *
+ * \param[in]  src_parms     The parameters, some of which may be mapped.
+ * \param[in]  parent_parms  The parameters mapped from.
+ * \param[out] view          Storage for resolved parameters.
+ *
+ * \notes
+ *  1. The view holds shallow copies of each unmapped parameter of src_parms
+ *     and each mapped one from parent_parms, so it is only valid while both
+ *     are and must not outlive them.
+ *  2. The result MUST be released with ari_release_parms_view().
+ *****************************************************************************/
+
+tnvc_t *ari_resolve_parms_view(tnvc_t *src_parms, tnvc_t *parent_parms, tnvc_t *view)
+{
+	uint8_t idx;
+	uint8_t num;
+
+	CHKNULL(view);
+
+	if((tnvc_size(parent_parms) == 0) ||
+	   (ari_parms_mapped(src_parms) == 0))
+	{
+		return src_parms;
+	}
+
+	num = tnvc_size(src_parms);
+	if(tnvc_init(view, num) != AMP_OK)
+	{
+		AMP_DEBUG_ERR("ari_resolve_parms_view", "Can't allocate view.", NULL);
+		return NULL;
+	}
+
+	for(idx = 0; idx < num; idx++)
+	{
+		tnv_t *cur_val = tnvc_get(src_parms, idx);
+		tnv_t borrowed;
+
+		if(TNV_IS_MAP(cur_val->flags))
+		{
+			uint8_t parent_idx = cur_val->value.as_uint;
+
+			if((cur_val = tnvc_get(parent_parms, parent_idx)) == NULL)
+			{
+				AMP_DEBUG_ERR("ari_resolve_parms_view",
+						      "Can't apply parm map: %d -> %d", idx, parent_idx);
+				tnvc_release(view, 0);
+				return NULL;
+			}
+		}
+
+		/* The view never owns what its values point to. */
+		borrowed = *cur_val;
+		TNV_CLEAR_ALLOC(borrowed.flags);
+		if(tnvc_insert_val(view, borrowed) != AMP_OK)
+		{
+			tnvc_release(view, 0);
+			return NULL;
+		}
+	}
+
+	return view;
+}
+
+
+
+/******************************************************************************
+ *
+ * Releases parameters returned by ari_resolve_parms_view(). Borrowed
+ * parameters are left alone.
+ *
+ * \param[in]     parms  The resolved parameters.
+ * \param[in,out] view   The view passed to ari_resolve_parms_view().
+ *****************************************************************************/
+
+void ari_release_parms_view(tnvc_t *parms, tnvc_t *view)
+{
+	if((parms != NULL) && (parms == view))
+	{
+		tnvc_release(view, 0);
+	}
+}
+
+
+
 int ari_serialize(QCBOREncodeContext *encoder, void *item)
 {
 	ari_t *ari = (ari_t *) item;
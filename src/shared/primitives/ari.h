@@ -42,6 +42,7 @@
 #include "shared/utils/debug.h"
 #include "shared/utils/rhht.h"
 #include "shared/utils/vector.h"
+#include "shared/utils/reg.h"
 #include "tnv.h"
 
 #ifdef __cplusplus
@@ -121,24 +122,33 @@ extern "C" {
  * The name field is an unparsed bytestring whose value is determined by naming
  * rules for the ADM or user that defines the object being identified.
  *
+ * The identity of a regular ARI (everything but its parameters) may be
+ * interned, in which case ident points to the single shared copy of that
+ * identity. Only ADM objects are interned. Two interned ARIs identify the same object iff their ident
+ * pointers are equal, and the hash of an interned ARI is precomputed.
+ *
  * \todo: Nicknames, Issuers, Tags, and Names might all more efficiently by
  *        stored as an index into a tree structure, such as a radix tree.
  */
 
+typedef struct ari_ident_s ari_ident_t;
+
 typedef struct
 {
 	uint8_t flags;
 
-	vec_idx_t nn_idx;
+	reg_idx_t nn_idx;
 
-	vec_idx_t iss_idx;
+	reg_idx_t iss_idx;
 
-	vec_idx_t tag_idx;  // Might make this a radix tree.
+	reg_idx_t tag_idx;
 
 	blob_t name; // Might make this a radix tree.
 
 	tnvc_t parms;
 
+	const ari_ident_t *ident; // Interned identity, or NULL.
+
 } ari_reg_t;
 
 
@@ -210,10 +220,14 @@ ari_t*    ari_from_parm_reg(uint8_t flags, amp_uvast nn, amp_uvast iss, blob_t *
 tnv_t*    ari_get_param(ari_t *id, int i);
 uint8_t   ari_get_num_parms(ari_t *ari);
 void      ari_init(ari_t *ari);
+int       ari_intern(ari_t *ari);
 ari_t     ari_null();
+uint8_t   ari_parms_mapped(tnvc_t *parms);
 void      ari_release(ari_t *ari, int destroy);
+void      ari_release_parms_view(tnvc_t *parms, tnvc_t *view);
 int       ari_replace_parms(ari_t *ari, tnvc_t *new_parms);
 tnvc_t*   ari_resolve_parms(tnvc_t *src_parms, tnvc_t *cur_parms);
+tnvc_t*   ari_resolve_parms_view(tnvc_t *src_parms, tnvc_t *parent_parms, tnvc_t *view);
 int       ari_serialize(QCBOREncodeContext *encoder, void *item);
 blob_t*   ari_serialize_wrapper(ari_t *ari);
 
@@ -121,8 +121,11 @@ ctrl_t *ctrl_copy_ptr(ctrl_t *src)
 	}
 
 	result->def = src->def;
+	result->type = src->type;
 	result->start = src->start;
+	result->caller = src->caller;
 	result->parms = tnvc_copy(src->parms);
+	result->mapped = src->mapped;
 	return result;
 }
 
@@ -156,39 +159,16 @@ ctrl_t *ctrl_create(ari_t *ari)
 
 	CHKNULL(ari);
 
-
-	if((ari->type != AMP_TYPE_CTRL) && (ari->type != AMP_TYPE_MAC))
-	{
-		AMP_DEBUG_ERR("ctrl_create","Bad ARI type %d", ari->type);
-		return NULL;
-	}
-
 	if((result = STAKE(sizeof(ctrl_t))) == NULL)
 	{
 		AMP_DEBUG_ERR("ctrl_create","Can't allocate CTRL.", NULL);
 		return NULL;
 	}
 
-	result->type = ari->type;
-
-	/* Step 1: Grab the basic information for this control. */
-	if(ari->type == AMP_TYPE_CTRL)
+	if(ctrl_bind(result, ari) != AMP_OK)
 	{
-		if((result->def.as_ctrl = VDB_FINDKEY_CTRLDEF(ari)) == NULL)
-		{
-			AMP_DEBUG_ERR("ctrl_create","Can't find base ctrldef.", NULL);
-			SRELEASE(result);
-			return NULL;
-		}
-	}
-	else
-	{
-		if((result->def.as_mac = VDB_FINDKEY_MACDEF(ari)) == NULL)
-		{
-			AMP_DEBUG_ERR("ctrl_create","Can't find base macdef.", NULL);
-			SRELEASE(result);
-			return NULL;
-		}
+		SRELEASE(result);
+		return NULL;
 	}
 
     /* Store any parameters needed for this control. */
@@ -206,6 +186,66 @@ ctrl_t *ctrl_create(ari_t *ari)
 }
 
 
+
+/******************************************************************************
+ *
+ * \par Function Name: ctrl_bind
+ *
+ * \par Initializes a control instance that borrows the parameters of its ARI
+ *      rather than copying them, for running a control without allocation.
+ *
+ * \retval AMP status code.
+ *
+ * \param[out] ctrl  The control instance, which is usually on the stack.
+ * \param[in]  ari   The ARI defining this control instance.
+ *
+ * Notes:
+ *   - The control MUST NOT outlive the ARI and MUST NOT be released.
+ *****************************************************************************/
+
+int ctrl_bind(ctrl_t *ctrl, ari_t *ari)
+{
+	CHKUSR(ctrl, AMP_FAIL);
+	CHKUSR(ari, AMP_FAIL);
+
+	memset(ctrl, 0, sizeof(ctrl_t));
+
+	if((ari->type != AMP_TYPE_CTRL) && (ari->type != AMP_TYPE_MAC))
+	{
+		AMP_DEBUG_ERR("ctrl_bind","Bad ARI type %d", ari->type);
+		return AMP_FAIL;
+	}
+
+	ctrl->type = ari->type;
+
+	/* Grab the basic information for this control. */
+	if(ari->type == AMP_TYPE_CTRL)
+	{
+		if((ctrl->def.as_ctrl = VDB_FINDKEY_CTRLDEF(ari)) == NULL)
+		{
+			AMP_DEBUG_ERR("ctrl_bind","Can't find base ctrldef.", NULL);
+			return AMP_FAIL;
+		}
+	}
+	else
+	{
+		if((ctrl->def.as_mac = VDB_FINDKEY_MACDEF(ari)) == NULL)
+		{
+			AMP_DEBUG_ERR("ctrl_bind","Can't find base macdef.", NULL);
+			return AMP_FAIL;
+		}
+	}
+
+	if(ARI_GET_FLAG_PARM(ari->as_reg.flags))
+	{
+		ctrl->parms = &(ari->as_reg.parms);
+		ctrl->mapped = ari_parms_mapped(ctrl->parms);
+	}
+
+	return AMP_OK;
+}
+
+
 ctrl_t *ctrl_db_deserialize(blob_t *data)
 {
 	QCBORDecodeContext it;
@@ -231,6 +271,7 @@ ctrl_t *ctrl_db_deserialize(blob_t *data)
 		ctrl_release(result, 1);
 		return NULL;
 	}
+	cut_get_cbor_str_ptr(&it, caller.name, AMP_MAX_EID_LEN - 1);
 
 	ctrl_set_exec(result, start, caller);
 
@@ -493,6 +534,7 @@ ctrldef_t *ctrldef_create(ari_t *ari, uint8_t num, ctrldef_run_fn run)
 	result->ari = ari;
 	result->num_parms = num;
 	result->run =run;
+	result->prio = AMP_PRIO_INHERIT;
 
 	return result;
 }
@@ -516,6 +558,59 @@ void    ctrldef_release(ctrldef_t *def, int destroy)
 	}
 }
 
+/*
+ * The class of a control's output in this thread's agent instance. A class
+ * set by the instance overrides the one its ADM gave the control.
+ */
+uint8_t ctrldef_get_class(ctrldef_t *def)
+{
+	uint8_t *prio;
+
+	if(gVDBInst->ctrl_classes.num_elts == 0)
+	{
+		return def->prio;
+	}
+	prio = rhht_retrieve_key(&(gVDBInst->ctrl_classes), def->ari);
+	return (prio != NULL) ? *prio : def->prio;
+}
+
+/*
+ * Set the class of a control's output in this thread's agent instance only.
+ * The definition is shared by all instances, so it is left unchanged.
+ */
+int ctrldef_set_class(ctrldef_t *def, uint8_t prio)
+{
+	uint8_t *cur;
+
+	CHKUSR(def, AMP_FAIL);
+
+	if((cur = rhht_retrieve_key(&(gVDBInst->ctrl_classes), def->ari)) != NULL)
+	{
+		*cur = prio;
+		return AMP_OK;
+	}
+
+	if((cur = STAKE(sizeof(uint8_t))) == NULL)
+	{
+		return AMP_SYSERR;
+	}
+	*cur = prio;
+
+	/* The key is the definition's own ARI, which outlives every instance. */
+	if(rhht_insert(&(gVDBInst->ctrl_classes), def->ari, cur, NULL) != RH_OK)
+	{
+		SRELEASE(cur);
+		return AMP_FAIL;
+	}
+	return AMP_OK;
+}
+
+void ctrldef_class_cb_ht_del_fn(rh_elt_t *elt)
+{
+	CHKVOID(elt);
+	SRELEASE(elt->value);
+}
+
 
 /* shallow copies ctrl */
 
@@ -526,6 +621,8 @@ int macdef_append(macdef_t *mac, ctrl_t *ctrl)
 		return AMP_FAIL;
 	}
 
+	/* Any compiled form is now out of date. */
+	macdef_decompile(mac);
 	return vec_push(&(mac->ctrls), ctrl);
 }
 
@@ -574,13 +671,253 @@ void    macdef_cb_ht_del_fn(rh_elt_t *elt)
 void    macdef_clear(macdef_t *mac)
 {
 	CHKVOID(mac);
+	macdef_decompile(mac);
 	vec_clear(&(mac->ctrls));
 }
 
+
+
+/*
+ * Counts the steps and macros of a macro once nested macros are expanded,
+ * failing if nesting is too deep (which also catches a macro that has come
+ * to contain itself) or there are too many steps.
+ */
+static int p_macdef_count(macdef_t *mac, int depth, uint32_t *steps, uint32_t *macs)
+{
+	vecit_t it;
+
+	if(depth > MACDEF_MAX_NESTING)
+	{
+		AMP_DEBUG_ERR("macdef_compile", "Macros nested deeper than %d.", MACDEF_MAX_NESTING);
+		return AMP_FAIL;
+	}
+
+	(*macs)++;
+	for(it = vecit_first(&(mac->ctrls)); vecit_valid(it); it = vecit_next(it))
+	{
+		ctrl_t *ctrl = (ctrl_t *) vecit_data(it);
+
+		if(ctrl->type == AMP_TYPE_MAC)
+		{
+			if((ctrl->def.as_mac == NULL) ||
+			   (p_macdef_count(ctrl->def.as_mac, depth + 1, steps, macs) != AMP_OK))
+			{
+				return AMP_FAIL;
+			}
+		}
+		else if((ctrl->def.as_ctrl == NULL) || (++(*steps) > MACDEF_MAX_STEPS))
+		{
+			AMP_DEBUG_ERR("macdef_compile", "Bad control or more than %d.", MACDEF_MAX_STEPS);
+			return AMP_FAIL;
+		}
+	}
+
+	return AMP_OK;
+}
+
+/*
+ * Maps the parms of a control in terms of the parms of the top-level macro.
+ * The context holds the parms of the enclosing nested macro, or is NULL at
+ * the top level. As in ari_resolve_parms_view(), mapped parms with nothing
+ * to map from are used as written.
+ */
+static int p_macdef_map(tnvc_t *parms, macslot_t *ctx, uint8_t ctx_num,
+		                macslot_t **slots, uint8_t *num)
+{
+	uint8_t i;
+
+	*slots = NULL;
+	*num = tnvc_size(parms);
+	if(*num == 0)
+	{
+		return AMP_OK;
+	}
+
+	if((*slots = STAKE(*num * sizeof(macslot_t))) == NULL)
+	{
+		return AMP_SYSERR;
+	}
+
+	for(i = 0; i < *num; i++)
+	{
+		tnv_t *val = tnvc_get(parms, i);
+
+		if(!TNV_IS_MAP(val->flags) || ((ctx != NULL) && (ctx_num == 0)))
+		{
+			(*slots)[i].val = val;
+		}
+		else if(ctx == NULL)
+		{
+			(*slots)[i].mapped = 1;
+			(*slots)[i].idx = val->value.as_uint;
+		}
+		else if(val->value.as_uint < ctx_num)
+		{
+			(*slots)[i] = ctx[val->value.as_uint];
+		}
+		else
+		{
+			AMP_DEBUG_ERR("macdef_compile", "Can't apply parm map: %d -> %d", i, val->value.as_uint);
+			SRELEASE(*slots);
+			*slots = NULL;
+			return AMP_FAIL;
+		}
+	}
+
+	return AMP_OK;
+}
+
+static int p_macdef_flatten(macdef_t *top, macdef_t *mac, macslot_t *ctx, uint8_t ctx_num)
+{
+	vecit_t it;
+	int result = AMP_OK;
+
+	for(it = vecit_first(&(mac->ctrls)); vecit_valid(it) && (result == AMP_OK); it = vecit_next(it))
+	{
+		ctrl_t *ctrl = (ctrl_t *) vecit_data(it);
+		macslot_t *slots = NULL;
+		uint8_t num = 0;
+		uint8_t i;
+
+		/* Controls with no mapped parms use them as written. */
+		if((ctrl->type == AMP_TYPE_MAC) || (ctrl->mapped != 0))
+		{
+			if((result = p_macdef_map(ctrl->parms, ctx, ctx_num, &slots, &num)) != AMP_OK)
+			{
+				break;
+			}
+		}
+
+		if(ctrl->type == AMP_TYPE_MAC)
+		{
+			/* Even with no parms, a nested macro is not the top level. */
+			static macslot_t none;
+
+			result = p_macdef_flatten(top, ctrl->def.as_mac, (slots != NULL) ? slots : &none, num);
+			SRELEASE(slots);
+		}
+		else
+		{
+			macstep_t *step = &(top->steps[top->num_steps++]);
+
+			/*
+			 * The step owns copies of what it runs, so it outlives changes
+			 * to the nested macros it was expanded from.
+			 */
+			step->def = ctrl->def.as_ctrl;
+			step->slots = slots;
+			step->num_slots = num;
+			if((step->ctrl = ctrl_copy_ptr(ctrl)) == NULL)
+			{
+				result = AMP_SYSERR;
+			}
+			for(i = 0; i < num; i++)
+			{
+				step->uses_parent |= slots[i].mapped;
+				if(slots[i].mapped)
+				{
+					continue;
+				}
+				/* After a failure, clear the rest so none are released. */
+				slots[i].val = (result == AMP_OK) ? tnv_copy_ptr(slots[i].val) : NULL;
+				if(slots[i].val == NULL)
+				{
+					result = AMP_SYSERR;
+				}
+			}
+		}
+	}
+
+	return result;
+}
+
+
+
+/******************************************************************************
+ *
+ * \par Function Name: macdef_compile
+ *
+ * \par Compiles a macro into a flat sequence of control definitions to run,
+ *      expanding nested macros in place and working out ahead of time where
+ *      each parameter of each control comes from.
+ *
+ * \retval AMP Status Code
+ *
+ * \param[in,out] mac  The macro to compile.
+ *
+ * \par Notes:
+ *   - Steps hold copies of the controls and literal parms of nested
+ *     macros, so nested macros run as they were when this one compiled.
+ *   - Compile a macro once its definition is complete, as each append
+ *     undoes it. A macro that fails to compile keeps running uncompiled.
+ *****************************************************************************/
+
+int macdef_compile(macdef_t *mac)
+{
+	uint32_t num_steps = 0;
+	uint32_t num_macs = 0;
+	int result;
+
+	CHKUSR(mac, AMP_FAIL);
+
+	macdef_decompile(mac);
+
+	if(p_macdef_count(mac, 0, &num_steps, &num_macs) != AMP_OK)
+	{
+		return AMP_FAIL;
+	}
+
+	/* Always allocate, so an empty macro still counts as compiled. */
+	if((mac->steps = STAKE((num_steps + 1) * sizeof(macstep_t))) == NULL)
+	{
+		return AMP_SYSERR;
+	}
+	mac->num_macs = num_macs;
+
+	if((result = p_macdef_flatten(mac, mac, NULL, 0)) != AMP_OK)
+	{
+		macdef_decompile(mac);
+	}
+
+	return result;
+}
+
+void macdef_decompile(macdef_t *mac)
+{
+	uint16_t i;
+
+	CHKVOID(mac);
+
+	if(mac->steps != NULL)
+	{
+		for(i = 0; i < mac->num_steps; i++)
+		{
+			macstep_t *step = &(mac->steps[i]);
+			uint8_t j;
+
+			for(j = 0; j < step->num_slots; j++)
+			{
+				if(!step->slots[j].mapped)
+				{
+					tnv_release(step->slots[j].val, 1);
+				}
+			}
+			SRELEASE(step->slots);
+			ctrl_release(step->ctrl, 1);
+		}
+		SRELEASE(mac->steps);
+	}
+	mac->steps = NULL;
+	mac->num_steps = 0;
+	mac->num_macs = 0;
+}
+
 macdef_t macdef_copy(macdef_t *src, int *success)
 {
 	macdef_t result;
 
+	/* The copy is never run, so is left uncompiled. */
+	memset(&result, 0, sizeof(result));
 	result.ari = ari_copy_ptr(src->ari);
 	result.ctrls = vec_copy(&(src->ctrls), success);
 	if(*success != VEC_OK)
@@ -746,6 +1083,7 @@ void    macdef_release(macdef_t *mac, int destroy)
 {
 	CHKVOID(mac);
 
+	macdef_decompile(mac);
 	ari_release(mac->ari, 1);
 	vec_release(&(mac->ctrls), 0);
 
@@ -60,6 +60,12 @@ extern "C" {
 #define CTRL_SUCCESS (AMP_OK)
 #define CTRL_FAILURE (AMP_FAIL)
 
+/* Deepest nesting of macros within a compiled macro. */
+#define MACDEF_MAX_NESTING (5)
+
+/* Most controls in a compiled macro, after expanding nested macros. */
+#define MACDEF_MAX_STEPS (1024)
+
 
 /*
  * +--------------------------------------------------------------------------+
@@ -91,25 +97,61 @@ typedef struct
 
     ctrldef_run_fn run;  /**> Function implementing the control.   */
 
+    uint8_t prio;        /**> Class of the control's output, or AMP_PRIO_INHERIT. */
+
     db_desc_t desc;
 } ctrldef_t;
 
 
+typedef struct ctrl_s ctrl_t;
+
+/**
+ * Where one parameter of a compiled macro step comes from.
+ */
+typedef struct
+{
+	uint8_t mapped; /**> Whether the value is taken from the macro's parms. */
+	uint8_t idx;    /**> Index into the macro's parms, if mapped.   */
+	tnv_t *val;     /**> Literal value, if not mapped.              */
+} macslot_t;
+
+/**
+ * One control of a compiled macro, with nested macros expanded in place.
+ */
+typedef struct
+{
+	ctrl_t *ctrl;       /**> Copy of the control as written.           */
+	ctrldef_t *def;     /**> Its definition. Shallow pointer.          */
+	uint8_t num_slots;  /**> # parms to build, or 0 to use ctrl parms. */
+	uint8_t uses_parent;/**> Whether any slot is mapped.               */
+	macslot_t *slots;
+} macstep_t;
+
+
 typedef struct
 {
 
 	ari_t *ari;     /* The name of the macro. */
 	vector_t ctrls; /* Of type ctrl_t*/
 
+	/*
+	 * Compiled form of the ctrls, built by macdef_compile(). NULL if the
+	 * macro has not been compiled, in which case ctrls are walked instead.
+	 */
+	macstep_t *steps;
+	uint16_t num_steps;
+	uint16_t num_macs; /* This macro and each nested one, for instrumentation. */
+
 	db_desc_t desc;
 } macdef_t;
 
 
-typedef struct
+struct ctrl_s
 {
 	OS_time_t start;   /**> ALways kept as an absolute time once rx.*/
 	eid_t caller;   /**> EID of entity that created the control. */
 	tnvc_t *parms;
+	uint8_t mapped; /**> Whether any parm is mapped from a parent object. */
 	amp_type_e type;
 
 	union {
@@ -118,7 +160,7 @@ typedef struct
 	} def;
 
 	db_desc_t desc;
-} ctrl_t;
+};
 
 
 
@@ -137,6 +179,7 @@ rh_idx_t ctrl_cb_hash(void *table, void *key);
 
 ctrl_t *ctrl_copy_ptr(ctrl_t *src);
 ctrl_t *ctrl_create(ari_t *ari);
+int     ctrl_bind(ctrl_t *ctrl, ari_t *ari);
 
 
 ctrl_t *ctrl_db_deserialize(blob_t *data);
@@ -155,6 +198,10 @@ ctrldef_t *ctrldef_create(ari_t *ari, uint8_t num, ctrldef_run_fn run);
 void       ctrldef_del_fn(rh_elt_t *elt);
 void       ctrldef_release(ctrldef_t *def, int destroy);
 
+uint8_t    ctrldef_get_class(ctrldef_t *def);
+int        ctrldef_set_class(ctrldef_t *def, uint8_t prio);
+void       ctrldef_class_cb_ht_del_fn(rh_elt_t *elt);
+
 
 
 
@@ -167,6 +214,9 @@ void    macdef_cb_ht_del_fn(rh_elt_t *elt);
 
 void    macdef_clear(macdef_t *mac);
 
+int     macdef_compile(macdef_t *mac);
+void    macdef_decompile(macdef_t *mac);
+
 macdef_t   macdef_copy(macdef_t *src, int *success);
 macdef_t*  macdef_copy_ptr(macdef_t *src);
 
@@ -319,95 +319,203 @@ expr_t* expr_deserialize_raw(blob_t *data, int *success)
  * - We are at the end of the process, so we verify we have just one
  *   value left on the stack, which we do, so the answer is 1.
  *
- *   The stack is a stack of value_t.
+ *   The stack holds unboxed tnv_t values. Each either owns what it points
+ *   to (TNV_IS_ALLOC) or borrows from the expression, which outlives the
+ *   evaluation. An operator with a kernel is applied to them in place, and
+ *   any other is given a vector of boxed values.
  */
 
-tnv_t *expr_eval(expr_t *expr)
+/* Boxes a stack value, moving it if owned and copying it otherwise. */
+static tnv_t *p_expr_box(tnv_t *val)
 {
 	tnv_t *result = NULL;
+	int success;
+
+	if((result = STAKE(sizeof(tnv_t))) == NULL)
+	{
+		return NULL;
+	}
+
+	if(TNV_IS_ALLOC(val->flags))
+	{
+		*result = *val;
+		TNV_CLEAR_ALLOC(val->flags);
+	}
+	else
+	{
+		*result = tnv_copy(*val, &success);
+		if(success != AMP_OK)
+		{
+			SRELEASE(result);
+			return NULL;
+		}
+	}
 
+	return result;
+}
+
+/* Applies an operator through its op_fn, consuming its operands. */
+static int p_expr_apply_boxed(op_t *op, tnv_t *args, tnv_t *out)
+{
 	vector_t stack;
-	vec_idx_t max;
-	vecit_t it;
+	tnv_t *result;
 	int success;
+	uint8_t i;
 
-	AMP_DEBUG_ENTRY("expr_eval","(0x%"PRIxPTR")", expr);
+	stack = vec_create(op->num_parms, tnv_cb_del, tnv_cb_comp, tnv_cb_copy, VEC_FLAG_AS_STACK, &success);
+	if(success != AMP_OK)
+	{
+		return AMP_FAIL;
+	}
 
-	/* Sanity Checks. */
-	if((expr == NULL) || ((max = vec_num_entries(expr->rpn.values)) == 0))
+	for(i = 0; (i < op->num_parms) && (success == AMP_OK); i++)
 	{
-		AMP_DEBUG_ERR("expr_eval","Bad args.", NULL);
-		return NULL;
+		tnv_t *box = p_expr_box(&(args[i]));
+
+		if((box == NULL) || (vec_push(&stack, box) != VEC_OK))
+		{
+			tnv_release(box, 1);
+			success = AMP_FAIL;
+		}
 	}
 
-	/*
-	 * Build the stack used to hold the results. This can't be larger than
-	 * the RPN used to build it.
-	 */
-	stack = vec_create(max, tnv_cb_del, tnv_cb_comp, tnv_cb_copy, VEC_FLAG_AS_STACK, &success);
-	if(success != AMP_OK)
+	result = (success == AMP_OK) ? op->apply(&stack) : NULL;
+	vec_release(&stack, 0);
+
+	if(result == NULL)
 	{
-		AMP_DEBUG_ERR("expr_eval","Cannot create stack.", NULL);
+		AMP_DEBUG_ERR("expr_eval","Can't apply operator.", NULL);
+		return AMP_FAIL;
+	}
+
+	/* Keep the value, not the box. */
+	*out = *result;
+	SRELEASE(result);
+	return AMP_OK;
+}
+
+static int p_expr_push_op(ari_t *id, tnv_t *stack, vec_idx_t *num)
+{
+	op_t *op = NULL;
+	tnv_t *args;
+	tnv_t result;
+	uint8_t i;
+
+	if((op = VDB_FINDKEY_OP(id)) == NULL)
+	{
+		AMP_DEBUG_ERR("expr_eval","Can't find operator.", NULL);
+		return AMP_FAIL;
+	}
+	if(*num < op->num_parms)
+	{
+		AMP_DEBUG_ERR("expr_eval","Operator needs %d operands.", op->num_parms);
+		return AMP_FAIL;
+	}
+
+	args = &(stack[*num - op->num_parms]);
+	tnv_init(&result, AMP_TYPE_UNK);
+
+	if((op->kernel == NULL) || (op->kernel(args, &result) != AMP_OK))
+	{
+		if(p_expr_apply_boxed(op, args, &result) != AMP_OK)
+		{
+			return AMP_FAIL;
+		}
+	}
+
+	for(i = 0; i < op->num_parms; i++)
+	{
+		tnv_release(&(args[i]), 0);
+	}
+	*num -= op->num_parms;
+	stack[(*num)++] = result;
+	return AMP_OK;
+}
+
+static int p_expr_push_val(ari_t *ari, tnv_t *stack, vec_idx_t *num)
+{
+	tnv_t *val;
+
+	/* Literals are borrowed rather than copied. */
+	if(ari->type == AMP_TYPE_LIT)
+	{
+		stack[*num] = ari->as_lit;
+		TNV_CLEAR_ALLOC(stack[*num].flags);
+		(*num)++;
+		return AMP_OK;
+	}
+
+	if((val = expr_get_val(ari)) == NULL)
+	{
+		return AMP_FAIL;
+	}
+	stack[(*num)++] = *val;
+	SRELEASE(val);
+	return AMP_OK;
+}
+
+tnv_t *expr_eval(expr_t *expr)
+{
+	tnv_t *result = NULL;
+	tnv_t stack[VEC_MAX_IDX];
+	vec_idx_t num = 0;
+	vecit_t it;
+	int success = AMP_OK;
+
+	AMP_DEBUG_ENTRY("expr_eval","(0x%"PRIxPTR")", expr);
+
+	/* Sanity Checks. */
+	if((expr == NULL) || (vec_num_entries(expr->rpn.values) == 0))
+	{
+		AMP_DEBUG_ERR("expr_eval","Bad args.", NULL);
 		return NULL;
 	}
 
-	for(it = vecit_first(&(expr->rpn.values)); vecit_valid(it); it = vecit_next(it))
+	/* The stack can't be larger than the RPN used to build it. */
+	for(it = vecit_first(&(expr->rpn.values)); vecit_valid(it) && (success == AMP_OK); it = vecit_next(it))
 	{
 		ari_t *cur_ari = NULL;
 
 		if((cur_ari = (ari_t *) vecit_data(it)) == NULL)
 		{
 			AMP_DEBUG_ERR("expr_eval","Bad ARI in expression at %d.", vecit_idx(it));
-			vec_release(&stack, 0);
-			return NULL;
+			success = AMP_FAIL;
 		}
-
-		/* Step 2.2: Based on what kind of object this is,
-		 *           calculate the new value to push on the stack.
-		 */
-
-		if(cur_ari->type == AMP_TYPE_OPER)
+		else if(cur_ari->type == AMP_TYPE_OPER)
 		{
-			result = expr_apply_op(cur_ari, &stack);
+			success = p_expr_push_op(cur_ari, stack, &num);
 		}
 		else
 		{
-			result = expr_get_val(cur_ari);
+			success = p_expr_push_val(cur_ari, stack, &num);
 		}
 
-		if(result == NULL)
+		if(success != AMP_OK)
 		{
 			AMP_DEBUG_ERR("expr_eval","Cannot evaluate expression.", NULL);
-
-			vec_release(&stack, 0);
-			return NULL;
-		}
-
-		if(vec_push(&stack, result) != AMP_OK)
-		{
-			AMP_DEBUG_ERR("expr_eval","Can't push new values to stack at %d", vecit_idx(it));
-			tnv_release(result, 1);
-			vec_release(&stack, 0);
-			return NULL;
 		}
 	}
 
 	/* Step 3 - Sanity check. We should have 1 result on the stack. */
-	if(vec_num_entries(stack) > 1)
+	if((success == AMP_OK) && (num != 1))
 	{
-		AMP_DEBUG_ERR("expr_eval","Stack has %d items?", vec_num_entries(stack));
-		vec_release(&stack, 0);
-		return NULL;
+		AMP_DEBUG_ERR("expr_eval","Stack has %d items?", num);
+		success = AMP_FAIL;
 	}
 
 	/* Step 4 - Get the last value and return it. */
-	result = vec_pop(&stack, &success);
-	vec_release(&stack, 0);
+	if(success == AMP_OK)
+	{
+		result = p_expr_box(&(stack[0]));
+	}
+	while(num > 0)
+	{
+		tnv_release(&(stack[--num]), 0);
+	}
 
-	if((success != AMP_OK) || (result == NULL))
+	if(result == NULL)
 	{
 		AMP_DEBUG_ERR("expr_eval", "Cannot convert type.", NULL);
-		tnv_release(result, 1);
 		return NULL;
 	}
 
@@ -624,10 +732,15 @@ int     op_cb_ht_comp_fn(void *key, void *value)
 op_t*     op_copy_ptr(op_t *src)
 {
 	ari_t *new_ari = NULL;
+	op_t *result;
 
 	CHKNULL(src);
 	new_ari = ari_copy_ptr(src->id);
-	return op_create(new_ari, src->num_parms, src->apply);
+	if((result = op_create(new_ari, src->num_parms, src->apply)) != NULL)
+	{
+		result->kernel = src->kernel;
+	}
+	return result;
 }
 
 void op_cb_ht_del_fn(rh_elt_t *elt)
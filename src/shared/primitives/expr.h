@@ -94,12 +94,21 @@ extern int gValNumCvtResult[6][6];
 
 typedef tnv_t* (*op_fn)(vector_t *stack);
 
+/*
+ * Applies an operator to unboxed operands, deepest in the stack first,
+ * writing the result in place. Returns AMP_FAIL without touching the
+ * operands if it does not handle their types, in which case the operator's
+ * op_fn is applied instead.
+ */
+typedef int (*op_kernel_fn)(const tnv_t *args, tnv_t *result);
+
 
 typedef struct
 {
 	ari_t *id;		    /**> The ARI identifying this def.        */
 	uint8_t num_parms;  /**> # params needed to complete this MID.*/
 	op_fn apply;        /**> Configured operator apply function. */
+	op_kernel_fn kernel;/**> Optional fast path for unboxed values. */
 } op_t;
 
 
@@ -464,6 +464,11 @@ int rpttpl_add_item(rpttpl_t *rpttpl, ari_t *item)
 	CHKERR(rpttpl);
 	CHKERR(item);
 
+	if((item->type != AMP_TYPE_LIT) && ari_parms_mapped(&(item->as_reg.parms)))
+	{
+		rpttpl->mapped = 1;
+	}
+
 	return vec_push(&(rpttpl->contents.values), item);
 }
 
@@ -536,6 +541,7 @@ rpttpl_t *rpttpl_copy_ptr(rpttpl_t *rpttpl)
 rpttpl_t* rpttpl_create(ari_t *id, ac_t items)
 {
 	rpttpl_t *result = NULL;
+	uint8_t i;
 
 	CHKNULL(id);
 
@@ -548,6 +554,17 @@ rpttpl_t* rpttpl_create(ari_t *id, ac_t items)
 	result->id = id;
 	result->contents = items;
 
+	for(i = 0; i < ac_get_count(&items); i++)
+	{
+		ari_t *item = ac_get(&items, i);
+
+		if((item->type != AMP_TYPE_LIT) && ari_parms_mapped(&(item->as_reg.parms)))
+		{
+			result->mapped = 1;
+			break;
+		}
+	}
+
 	return result;
 }
 
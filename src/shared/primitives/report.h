@@ -93,6 +93,7 @@ typedef struct
 {
 	ari_t *id;		   /**> The template id.   */
 	ac_t contents;     /**> Each item is of type (ari_t *)*/
+	uint8_t mapped;    /**> Whether any item maps a parm of the template. */
 
 	db_desc_t desc;    /**> Descriptor of def in the SDR. */
 } rpttpl_t;
@@ -107,6 +107,7 @@ rule_t*   rule_copy_ptr(rule_t *src)
 	/* Shallow copy the easy things. */
 	result->eval_at = src->eval_at;
 	result->flags = src->flags;
+	result->prio = src->prio;
 	result->num_eval = src->num_eval;
 	result->num_fire = src->num_fire;
 	result->start = src->start;
@@ -136,6 +137,7 @@ rule_t*  rule_create_sbr(ari_t id, OS_time_t start, sbr_def_t def, ac_t action)
 	result->def.as_sbr = def;
 
 	RULE_SET_ACTIVE(result->flags);
+	result->prio = AMP_PRIO_HIGH;
 
 	if(OS_TimeGetTotalSeconds(start) < EPOCH_ABSTIME_DTN + EPOCH_DTN_POSIX)
 	{
@@ -182,6 +184,7 @@ rule_t*  rule_create_tbr(ari_t id, OS_time_t start, tbr_def_t def, ac_t action)
 	result->def.as_tbr = def;
 
 	RULE_SET_ACTIVE(result->flags);
+	result->prio = AMP_PRIO_NORMAL;
 
 	if(OS_TimeGetTotalSeconds(start) < EPOCH_ABSTIME_DTN + EPOCH_DTN_POSIX)
 	{
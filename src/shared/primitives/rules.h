@@ -122,6 +122,7 @@ typedef struct {
 	amp_uvast    num_eval;   /**> Number of times rule evaluated.       */
 	amp_uvast    num_fire;   /**> Number of times a rule action was run. */
 	uint8_t  flags;      /**> Status of rule: Active or not.        */
+	uint8_t  prio;       /**> Class (amp_prio_e) of the action's output. */
 
 	db_desc_t desc;      /**> SDR info. for persistent storage.     */
 } rule_t;
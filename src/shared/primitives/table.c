@@ -39,6 +39,331 @@
 #include "tnv.h"
 
 
+/* Whether a column of the given type holds tnv_t values. */
+static int p_tbl_col_boxed(amp_type_e type)
+{
+	switch(type)
+	{
+		case AMP_TYPE_BOOL:
+		case AMP_TYPE_BYTE:
+		case AMP_TYPE_INT:
+		case AMP_TYPE_UINT:
+		case AMP_TYPE_REAL32:
+		case AMP_TYPE_VAST:
+		case AMP_TYPE_UVAST:
+		case AMP_TYPE_TV:
+		case AMP_TYPE_TS:
+		case AMP_TYPE_REAL64: return 0;
+		default:              return 1;
+	}
+}
+
+/* Size of one value held in a column of the given type. */
+static size_t p_tbl_col_size(amp_type_e type)
+{
+	switch(type)
+	{
+		case AMP_TYPE_BOOL:
+		case AMP_TYPE_BYTE:   return sizeof(uint8_t);
+		case AMP_TYPE_INT:    return sizeof(int32_t);
+		case AMP_TYPE_UINT:   return sizeof(uint32_t);
+		case AMP_TYPE_REAL32: return sizeof(float);
+		case AMP_TYPE_VAST:   return sizeof(amp_vast);
+		case AMP_TYPE_UVAST:
+		case AMP_TYPE_TV:
+		case AMP_TYPE_TS:     return sizeof(amp_uvast);
+		case AMP_TYPE_REAL64: return sizeof(double);
+		default:              return sizeof(tnv_t);
+	}
+}
+
+/* Sets up the columns of a table from its template. */
+static int p_tbl_cols_init(tbl_t *tbl)
+{
+	tblt_t *tblt;
+	uint32_t i;
+
+	if((tblt = VDB_FINDKEY_TBLT(tbl->id)) == NULL)
+	{
+		AMP_DEBUG_ERR("p_tbl_cols_init", "Can't find table template.", NULL);
+		return AMP_FAIL;
+	}
+
+	if(tblt_num_cols(tblt) == 0)
+	{
+		AMP_DEBUG_ERR("p_tbl_cols_init", "Table template has no columns.", NULL);
+		return AMP_FAIL;
+	}
+
+	tbl->num_cols = tblt_num_cols(tblt);
+	if((tbl->cols = STAKE(tbl->num_cols * sizeof(tbl_col_t))) == NULL)
+	{
+		tbl->num_cols = 0;
+		return AMP_SYSERR;
+	}
+
+	for(i = 0; i < tbl->num_cols; i++)
+	{
+		tbl->cols[i].type = tblt_get_type(tblt, i);
+	}
+
+	return AMP_OK;
+}
+
+/*
+ * Makes room for num rows in every column. New rows are zeroed, so a
+ * partially appended row can always be released.
+ */
+static int p_tbl_cols_reserve(tbl_t *tbl, uint32_t num)
+{
+	void **tmp;
+	uint32_t new_max;
+	uint32_t i;
+
+	if(num <= tbl->max_rows)
+	{
+		return AMP_OK;
+	}
+
+	new_max = (tbl->max_rows == 0) ? TBL_DEFAULT_NUM_ROWS : tbl->max_rows;
+	while(new_max < num)
+	{
+		new_max *= 2;
+	}
+
+	/* Allocate every column first, so that failure leaves the table as is. */
+	if((tmp = STAKE(tbl->num_cols * sizeof(void*))) == NULL)
+	{
+		return AMP_SYSERR;
+	}
+
+	for(i = 0; i < tbl->num_cols; i++)
+	{
+		if((tmp[i] = STAKE(new_max * p_tbl_col_size(tbl->cols[i].type))) == NULL)
+		{
+			while(i > 0)
+			{
+				SRELEASE(tmp[--i]);
+			}
+			SRELEASE(tmp);
+			return AMP_SYSERR;
+		}
+	}
+
+	for(i = 0; i < tbl->num_cols; i++)
+	{
+		if(tbl->cols[i].values != NULL)
+		{
+			memcpy(tmp[i], tbl->cols[i].values, tbl->max_rows * p_tbl_col_size(tbl->cols[i].type));
+			SRELEASE(tbl->cols[i].values);
+		}
+		tbl->cols[i].values = tmp[i];
+	}
+
+	SRELEASE(tmp);
+	tbl->max_rows = new_max;
+	return AMP_OK;
+}
+
+/* Releases all columns, including any partially appended row. */
+static void p_tbl_cols_release(tbl_t *tbl)
+{
+	uint32_t num = tbl->num_rows + ((tbl->cur_col > 0) ? 1 : 0);
+	uint32_t i;
+	uint32_t j;
+
+	for(i = 0; i < tbl->num_cols; i++)
+	{
+		if(p_tbl_col_boxed(tbl->cols[i].type))
+		{
+			tnv_t *vals = (tnv_t*) tbl->cols[i].values;
+			for(j = 0; j < num; j++)
+			{
+				tnv_release(&(vals[j]), 0);
+			}
+		}
+		SRELEASE(tbl->cols[i].values);
+	}
+
+	SRELEASE(tbl->cols);
+	tbl->cols = NULL;
+	tbl->num_cols = 0;
+	tbl->num_rows = 0;
+	tbl->max_rows = 0;
+	tbl->cur_col = 0;
+}
+
+/* Drops a partially appended row, so the next value starts a new row. */
+static void p_tbl_row_abort(tbl_t *tbl)
+{
+	uint32_t i;
+
+	for(i = 0; i < tbl->cur_col; i++)
+	{
+		if(p_tbl_col_boxed(tbl->cols[i].type))
+		{
+			tnv_t *vals = (tnv_t*) tbl->cols[i].values;
+			tnv_release(&(vals[tbl->num_rows]), 0);
+			memset(&(vals[tbl->num_rows]), 0, sizeof(tnv_t));
+		}
+	}
+	tbl->cur_col = 0;
+}
+
+/* Appends a deep copy of one row of src to dst. */
+static int p_tbl_copy_row(tbl_t *dst, tbl_t *src, uint32_t row)
+{
+	int success = AMP_OK;
+	tnv_t cell;
+	uint32_t j;
+
+	for(j = 0; (j < src->num_cols) && (success == AMP_OK); j++)
+	{
+		tbl_get_cell(src, row, j, &cell);
+		cell = tnv_copy(cell, &success);
+		if(success == AMP_OK)
+		{
+			success = tbl_append_val(dst, cell);
+		}
+	}
+
+	return success;
+}
+
+/* Whether the given columns of two rows hold the same values. */
+static int p_tbl_rows_equal(tbl_t *t1, uint32_t r1, tbl_t *t2, uint32_t r2, uint32_t cols)
+{
+	tnv_t c1;
+	tnv_t c2;
+	uint32_t j;
+
+	if(t1->num_cols != t2->num_cols)
+	{
+		return 0;
+	}
+
+	for(j = 0; j < t1->num_cols; j++)
+	{
+		if((j < 32) && ((cols & (1u << j)) == 0))
+		{
+			continue;
+		}
+		tbl_get_cell(t1, r1, j, &c1);
+		tbl_get_cell(t2, r2, j, &c2);
+		if(tnv_compare(&c1, &c2) != 0)
+		{
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+/* FNV-1a hash of the key columns of a row. */
+static uint32_t p_tbl_key_hash(tbl_t *tbl, uint32_t row, uint32_t key)
+{
+	uint32_t hash = 2166136261u;
+	uint64_t bits;
+	rhht_t ht = { .num_bkts = UINT16_MAX };
+	tnv_t cell;
+	uint32_t j;
+	size_t i;
+
+	for(j = 0; (j < tbl->num_cols) && (j < 32); j++)
+	{
+		if((key & (1u << j)) == 0)
+		{
+			continue;
+		}
+
+		tbl_get_cell(tbl, row, j, &cell);
+		if(!p_tbl_col_boxed(cell.type))
+		{
+			bits = cell.value.as_uvast;
+		}
+		else if((cell.type == AMP_TYPE_STR) && (cell.value.as_ptr != NULL))
+		{
+			const char *str = cell.value.as_ptr;
+			for(i = 0, bits = 0; str[i] != 0; i++)
+			{
+				bits = (bits * 131) + (uint8_t) str[i];
+			}
+		}
+		else if((cell.type == AMP_TYPE_ARI) && (cell.value.as_ptr != NULL))
+		{
+			bits = ari_cb_hash(&ht, cell.value.as_ptr);
+		}
+		else
+		{
+			bits = cell.type;
+		}
+
+		for(i = 0; i < sizeof(bits); i++)
+		{
+			hash = (hash ^ (uint8_t) (bits >> (8 * i))) * 16777619u;
+		}
+	}
+
+	return hash;
+}
+
+/*
+ * Indexes the rows of a table by key, with open addressing. Each slot holds
+ * a row index plus 1, or 0 if empty. Fails if two rows have the same key.
+ */
+static uint32_t* p_tbl_index(tbl_t *tbl, uint32_t key, uint32_t *mask)
+{
+	uint32_t *slots;
+	uint32_t num = 8;
+	uint32_t row;
+	uint32_t pos;
+
+	while(num < 2 * tbl->num_rows)
+	{
+		num *= 2;
+	}
+
+	if((slots = STAKE(num * sizeof(uint32_t))) == NULL)
+	{
+		return NULL;
+	}
+	*mask = num - 1;
+
+	for(row = 0; row < tbl->num_rows; row++)
+	{
+		for(pos = p_tbl_key_hash(tbl, row, key) & *mask; slots[pos] != 0; pos = (pos + 1) & *mask)
+		{
+			if(p_tbl_rows_equal(tbl, slots[pos] - 1, tbl, row, key))
+			{
+				AMP_DEBUG_WARN("p_tbl_index", "Rows %d and %d have the same key.", slots[pos] - 1, row);
+				SRELEASE(slots);
+				return NULL;
+			}
+		}
+		slots[pos] = row + 1;
+	}
+
+	return slots;
+}
+
+/* Finds the row of an indexed table with the same key as a row of another. */
+static int p_tbl_index_find(tbl_t *tbl, uint32_t *slots, uint32_t mask, tbl_t *other, uint32_t row, uint32_t key)
+{
+	uint32_t pos;
+
+	for(pos = p_tbl_key_hash(other, row, key) & mask; slots[pos] != 0; pos = (pos + 1) & mask)
+	{
+		if(p_tbl_rows_equal(tbl, slots[pos] - 1, other, row, key))
+		{
+			return slots[pos] - 1;
+		}
+	}
+
+	return -1;
+}
+
+
+
 /******************************************************************************
  *
  * \par Function Name: tbl_add_row
@@ -51,8 +376,9 @@
  * \param[in]     row  The row being added
  *
  * \par Notes:
- *  - This function SHALLOW-COPIES the row into the table. The calling function
- *     MUST NOT release this memory.
+ *  - This function MOVES the values of the row into the table and releases
+ *    the row. The calling function MUST NOT release this memory, unless the
+ *    row could not be added.
  *  - Each entry in the row MUST have type information. Tables are strongly
  *    typed in this implementation, even if type information isn't in the
  *    serialized rows in the AMP protocol.
@@ -66,22 +392,226 @@
 
 int tbl_add_row(tbl_t *tbl, tnvc_t *row)
 {
+	uint32_t i;
+	int result;
+
 	CHKUSR(tbl, AMP_FAIL);
 	CHKUSR(row, AMP_FAIL);
 
+	if(tbl->cur_col != 0)
+	{
+		AMP_DEBUG_ERR("tbl_add_row", "A row is partially appended.", NULL);
+		return AMP_FAIL;
+	}
+
 	if(tblt_check_row(VDB_FINDKEY_TBLT(tbl->id), row) != AMP_OK)
 	{
 		AMP_DEBUG_ERR("tbl_add_row", "row doesn't match template.", NULL);
 		return AMP_FAIL;
 	}
 
-	return vec_push(&(tbl->rows), row);
+	/* Make room first, so that moving the values can't fail. */
+	if(((tbl->cols == NULL) && ((result = p_tbl_cols_init(tbl)) != AMP_OK)) ||
+	   ((result = p_tbl_cols_reserve(tbl, tbl->num_rows + 1)) != AMP_OK))
+	{
+		return result;
+	}
+
+	for(i = 0; i < row->num; i++)
+	{
+		tbl_append_val(tbl, row->values[i]);
+	}
+
+	row->num = 0;
+	tnvc_release(row, 1);
+	return AMP_OK;
+}
+
+
+
+/******************************************************************************
+ *
+ * \par Function Name: tbl_append_val
+ *
+ * \par Purpose: Appends the next value to a table.
+ *
+ * \return AMP Status Code
+ *
+ * \param[in|out] tbl  The table having a value appended
+ * \param[in]     val  The value being appended
+ *
+ * \par Notes:
+ *  - Values are appended in row order, one column at a time, and a row is
+ *    part of the table once its last column is appended.
+ *  - The value is MOVED into the table, even on failure. The calling function
+ *    MUST NOT release anything it points to.
+ *  - The type of the value MUST match the type of its column in the table
+ *    template. If it does not, the row being appended is dropped and the
+ *    next value appended starts a new row.
+ *****************************************************************************/
+
+int tbl_append_val(tbl_t *tbl, tnv_t val)
+{
+	tbl_col_t *col;
+	uint32_t row;
+	int result;
+
+	if(tbl == NULL)
+	{
+		tnv_release(&val, 0);
+		return AMP_FAIL;
+	}
+
+	if((tbl->cols == NULL) && ((result = p_tbl_cols_init(tbl)) != AMP_OK))
+	{
+		tnv_release(&val, 0);
+		return result;
+	}
+
+	row = tbl->num_rows;
+	if((tbl->cur_col == 0) && ((result = p_tbl_cols_reserve(tbl, row + 1)) != AMP_OK))
+	{
+		AMP_DEBUG_ERR("tbl_append_val", "Can't make room for row %d.", row);
+		tnv_release(&val, 0);
+		return result;
+	}
+
+	col = &(tbl->cols[tbl->cur_col]);
+	if(val.type != col->type)
+	{
+		AMP_DEBUG_ERR("tbl_append_val", "Column %d holds type %d, not %d.", tbl->cur_col, col->type, val.type);
+		tnv_release(&val, 0);
+		p_tbl_row_abort(tbl);
+		return AMP_FAIL;
+	}
+
+	switch(col->type)
+	{
+		case AMP_TYPE_BOOL:
+		case AMP_TYPE_BYTE:   ((uint8_t*) col->values)[row] = val.value.as_byte;     break;
+		case AMP_TYPE_INT:    ((int32_t*) col->values)[row] = val.value.as_int;      break;
+		case AMP_TYPE_UINT:   ((uint32_t*) col->values)[row] = val.value.as_uint;    break;
+		case AMP_TYPE_REAL32: ((float*) col->values)[row] = val.value.as_real32;     break;
+		case AMP_TYPE_VAST:   ((amp_vast*) col->values)[row] = val.value.as_vast;    break;
+		case AMP_TYPE_UVAST:
+		case AMP_TYPE_TV:
+		case AMP_TYPE_TS:     ((amp_uvast*) col->values)[row] = val.value.as_uvast;  break;
+		case AMP_TYPE_REAL64: ((double*) col->values)[row] = val.value.as_real64;    break;
+		default:              ((tnv_t*) col->values)[row] = val;                     break;
+	}
+
+	if(++(tbl->cur_col) == tbl->num_cols)
+	{
+		tbl->cur_col = 0;
+		tbl->num_rows++;
+	}
+
+	return AMP_OK;
+}
+
+/*
+ * Typed variants of tbl_append_val(), for building tables without
+ * allocating each value.
+ */
+
+int tbl_append_bool(tbl_t *tbl, uint8_t val)
+{
+	tnv_t tnv;
+	tnv_init(&tnv, AMP_TYPE_BOOL);
+	tnv.value.as_byte = (val) ? 1 : 0;
+	return tbl_append_val(tbl, tnv);
+}
+
+int tbl_append_byte(tbl_t *tbl, uint8_t val)
+{
+	tnv_t tnv;
+	tnv_init(&tnv, AMP_TYPE_BYTE);
+	tnv.value.as_byte = val;
+	return tbl_append_val(tbl, tnv);
+}
+
+int tbl_append_int(tbl_t *tbl, int32_t val)
+{
+	tnv_t tnv;
+	tnv_init(&tnv, AMP_TYPE_INT);
+	tnv.value.as_int = val;
+	return tbl_append_val(tbl, tnv);
+}
+
+int tbl_append_uint(tbl_t *tbl, uint32_t val)
+{
+	tnv_t tnv;
+	tnv_init(&tnv, AMP_TYPE_UINT);
+	tnv.value.as_uint = val;
+	return tbl_append_val(tbl, tnv);
+}
+
+int tbl_append_vast(tbl_t *tbl, amp_vast val)
+{
+	tnv_t tnv;
+	tnv_init(&tnv, AMP_TYPE_VAST);
+	tnv.value.as_vast = val;
+	return tbl_append_val(tbl, tnv);
+}
+
+int tbl_append_uvast(tbl_t *tbl, amp_uvast val)
+{
+	tnv_t tnv;
+	tnv_init(&tnv, AMP_TYPE_UVAST);
+	tnv.value.as_uvast = val;
+	return tbl_append_val(tbl, tnv);
+}
+
+int tbl_append_real32(tbl_t *tbl, float val)
+{
+	tnv_t tnv;
+	tnv_init(&tnv, AMP_TYPE_REAL32);
+	tnv.value.as_real32 = val;
+	return tbl_append_val(tbl, tnv);
+}
+
+int tbl_append_real64(tbl_t *tbl, double val)
+{
+	tnv_t tnv;
+	tnv_init(&tnv, AMP_TYPE_REAL64);
+	tnv.value.as_real64 = val;
+	return tbl_append_val(tbl, tnv);
+}
+
+int tbl_append_str(tbl_t *tbl, const char *str)
+{
+	tnv_t tnv;
+	size_t len;
+
+	CHKUSR(str, AMP_FAIL);
+	tnv_init(&tnv, AMP_TYPE_STR);
+	len = strlen(str);
+	if((tnv.value.as_ptr = STAKE(len + 1)) == NULL)
+	{
+		return AMP_SYSERR;
+	}
+	memcpy(tnv.value.as_ptr, str, len);
+	TNV_SET_ALLOC(tnv.flags);
+	return tbl_append_val(tbl, tnv);
+}
+
+int tbl_append_tv(tbl_t *tbl, amp_tv_t val)
+{
+	tnv_t tnv;
+	tnv_init(&tnv, AMP_TYPE_TV);
+	tnv.value.as_uvast = OS_TimeGetTotalSeconds(val.secs);
+	return tbl_append_val(tbl, tnv);
 }
 
+
+
 void     tbl_clear(tbl_t *tbl)
 {
 	CHKVOID(tbl);
-	vec_clear(&(tbl->rows));
+	if(tbl->cols != NULL)
+	{
+		p_tbl_cols_release(tbl);
+	}
 }
 
 
@@ -89,6 +619,7 @@ tbl_t* tbl_copy_ptr(tbl_t *tbl)
 {
 	tbl_t *result = NULL;
 	int success;
+	uint32_t i;
 
 	CHKNULL(tbl);
 
@@ -103,11 +634,16 @@ tbl_t* tbl_copy_ptr(tbl_t *tbl)
 		return NULL;
 	}
 
-	result->rows = vec_copy(&(tbl->rows), &success);
+	/* Only complete rows are copied. */
+	success = AMP_OK;
+	for(i = 0; (i < tbl->num_rows) && (success == AMP_OK); i++)
+	{
+		success = p_tbl_copy_row(result, tbl, i);
+	}
+
 	if(success != AMP_OK)
 	{
-		ari_release(result->id,1);
-		SRELEASE(result);
+		tbl_release(result, 1);
 		result = NULL;
 	}
 
@@ -117,7 +653,6 @@ tbl_t* tbl_copy_ptr(tbl_t *tbl)
 tbl_t*   tbl_create(ari_t *id)
 {
 	tbl_t *result = NULL;
-	int success;
 
 	CHKNULL(id);
 
@@ -132,14 +667,6 @@ tbl_t*   tbl_create(ari_t *id)
 		return NULL;
 	}
 
-	result->rows = vec_create(0, tnvc_cb_del, tnvc_cb_comp, tnvc_cb_copy_fn, 0, &success);
-
-	if(success != AMP_OK)
-	{
-		tbl_release(result, 1);
-		result = NULL;
-	}
-
 	return result;
 }
 
@@ -268,12 +795,57 @@ tbl_t* tbl_deserialize_raw(blob_t *data, int *success)
 
 
 
-tnvc_t*  tbl_get_row(tbl_t *tbl, int row_idx)
+/******************************************************************************
+ *
+ * \par Function Name: tbl_get_cell
+ *
+ * \par Purpose: Gets one value of a table, however it is held.
+ *
+ * \return AMP Status Code
+ *
+ * \param[in]  tbl      The table
+ * \param[in]  row_idx  The row of the value
+ * \param[in]  col_idx  The column of the value
+ * \param[out] val      The value
+ *
+ * \par Notes:
+ *  - The value is a SHALLOW copy which never owns what it points to. It is
+ *    valid only until the table is changed.
+ *****************************************************************************/
+
+int tbl_get_cell(tbl_t *tbl, uint32_t row_idx, uint32_t col_idx, tnv_t *val)
 {
-	tnvc_t *result = NULL;
-	CHKNULL(tbl);
-	result = (tnvc_t*) vec_at(&tbl->rows, row_idx);
-	return result;
+	tbl_col_t *col;
+
+	CHKUSR(tbl, AMP_FAIL);
+	CHKUSR(val, AMP_FAIL);
+
+	if((row_idx >= tbl->num_rows) || (col_idx >= tbl->num_cols))
+	{
+		return AMP_FAIL;
+	}
+
+	col = &(tbl->cols[col_idx]);
+	tnv_init(val, col->type);
+	switch(col->type)
+	{
+		case AMP_TYPE_BOOL:
+		case AMP_TYPE_BYTE:   val->value.as_byte = ((uint8_t*) col->values)[row_idx];     break;
+		case AMP_TYPE_INT:    val->value.as_int = ((int32_t*) col->values)[row_idx];      break;
+		case AMP_TYPE_UINT:   val->value.as_uint = ((uint32_t*) col->values)[row_idx];    break;
+		case AMP_TYPE_REAL32: val->value.as_real32 = ((float*) col->values)[row_idx];     break;
+		case AMP_TYPE_VAST:   val->value.as_vast = ((amp_vast*) col->values)[row_idx];    break;
+		case AMP_TYPE_UVAST:
+		case AMP_TYPE_TV:
+		case AMP_TYPE_TS:     val->value.as_uvast = ((amp_uvast*) col->values)[row_idx];  break;
+		case AMP_TYPE_REAL64: val->value.as_real64 = ((double*) col->values)[row_idx];    break;
+		default:
+			*val = ((tnv_t*) col->values)[row_idx];
+			TNV_CLEAR_ALLOC(val->flags);
+			break;
+	}
+
+	return AMP_OK;
 }
 
 
@@ -281,7 +853,10 @@ void tbl_release(tbl_t *tbl, int destroy)
 {
 	CHKVOID(tbl);
 	ari_release(tbl->id, 1);
-	vec_release(&(tbl->rows), 0);
+	if(tbl->cols != NULL)
+	{
+		p_tbl_cols_release(tbl);
+	}
 
 	if(destroy)
 	{
@@ -292,21 +867,58 @@ void tbl_release(tbl_t *tbl, int destroy)
 int tbl_num_rows(tbl_t *tbl)
 {
 	CHKZERO(tbl);
-	return vec_num_entries(tbl->rows);
+	return tbl->num_rows;
 }
 
 int tbl_serialize(QCBOREncodeContext *encoder, void *item)
+{
+	return tbl_serialize_rows(encoder, (tbl_t *) item, 0, tbl_num_rows((tbl_t *) item));
+}
+
+
+/******************************************************************************
+ *
+ * \par Function Name: tbl_serialize_rows
+ *
+ * \par Purpose: Serializes a range of rows of a table as a table of its own.
+ *
+ * \return AMP Status Code
+ *
+ * \param[in|out] encoder  The encoder
+ * \param[in]     tbl      The table
+ * \param[in]     first    The first row to serialize
+ * \param[in]     num      The number of rows to serialize
+ *
+ * \par Notes:
+ *  - A large table may be sent as several smaller tables with the same ID by
+ *    serializing it in ranges of rows. The agent does not do so itself, as
+ *    the manager would keep each range as a separate table; tbl_serialize()
+ *    encodes the whole table.
+ *  - Rows are encoded straight from the columns, through one reused row of
+ *    shallow copies.
+ *****************************************************************************/
+
+int tbl_serialize_rows(QCBOREncodeContext *encoder, tbl_t *tbl, int first, int num)
 {
 	blob_t *result;
 	int err = AMP_OK;
-	size_t num;
-	size_t i;
-	tbl_t *tbl = (tbl_t *) item;
+	tnvc_t view;
+	int i;
+	uint32_t j;
 
 	CHKUSR(encoder, AMP_FAIL);
 	CHKUSR(tbl, AMP_FAIL);
 
-	num = tbl_num_rows(tbl) + 1;
+	if((first < 0) || (num < 0) || (first + num > tbl_num_rows(tbl)))
+	{
+		AMP_DEBUG_ERR("tbl_serialize_rows", "Bad row range %d + %d.", first, num);
+		return AMP_FAIL;
+	}
+
+	if(tnvc_init(&view, tbl->num_cols) != AMP_OK)
+	{
+		return AMP_SYSERR;
+	}
 
 	/* Start a container. */
 	QCBOREncode_OpenArray(encoder);
@@ -321,39 +933,40 @@ int tbl_serialize(QCBOREncodeContext *encoder, void *item)
 	err = ari_serialize(encoder, tbl->id);
 	QCBOREncode_CloseArrayOctet(encoder);
 #endif
-	if(err != AMP_OK)
-	{
-		QCBOREncode_CloseArray(encoder);
-		return err;
-	}
 
 	/*
-	 * For each row. We start counting at 1 because we already
-	 * accounted for the ARI ID in the array.
+	 * Step 2: Encode each row.
 	 *
 	 * We don't need to do lots of NULL checks here because the
 	 * functions called check for NULL themselves.
 	 */
-	for(i = 1; i < num; i++)
+	for(i = first; (i < first + num) && (err == AMP_OK); i++)
 	{
-		tnvc_t *cur_row = tbl_get_row(tbl, i-1);
+		tnv_t cell;
+
+		view.num = 0;
+		for(j = 0; j < tbl->num_cols; j++)
+		{
+			tbl_get_cell(tbl, i, j, &cell);
+			tnvc_insert_val(&view, cell);
+		}
+
 #if AMP_VERSION < 7
-		result = tnvc_serialize_wrapper(cur_row);
+		result = tnvc_serialize_wrapper(&view);
 		err = blob_serialize(encoder, result);
 		blob_release(result, 1);
 #else
 		QCBOREncode_OpenArray(encoder);
-		err = tnvc_serialize(encoder, cur_row);
+		err = tnvc_serialize(encoder, &view);
 		QCBOREncode_CloseArrayOctet(encoder);
 #endif
-		if(err != AMP_OK)
-		{
-			QCBOREncode_CloseArray(encoder);
-			return err;
-		}
 	}
 
 	QCBOREncode_CloseArray(encoder);
+
+	/* Cells in the view own nothing. */
+	tnvc_release(&view, 0);
+
 	return err;
 }
 
@@ -401,6 +1014,280 @@ void* tbl_cb_copy_fn(void *item)
 
 
 
+/* INCREMENTAL TABLE FUNCTIONS */
+
+
+/******************************************************************************
+ *
+ * \par Function Name: tbl_delta_apply
+ *
+ * \par Purpose: Rebuilds a whole table from the table a delta was made
+ *               against and the delta.
+ *
+ * \return The new table, or NULL on error.
+ *
+ * \param[in] prev   The table the delta applies to, or NULL if its base is 0
+ * \param[in] delta  The delta
+ *
+ * \par Notes:
+ *  - Changed rows keep their place in the table. Inserted rows follow the
+ *    rows of the previous table.
+ *  - The caller checks that the delta applies to prev.
+ *****************************************************************************/
+
+tbl_t* tbl_delta_apply(tbl_t *prev, tbl_delta_t *delta)
+{
+	tbl_t *result;
+	uint32_t *rows_idx = NULL;
+	uint32_t *gone_idx = NULL;
+	uint32_t rows_mask;
+	uint32_t gone_mask;
+	uint8_t *used = NULL;
+	int success = AMP_OK;
+	int found;
+	uint32_t i;
+
+	CHKNULL(delta);
+	CHKNULL(delta->rows);
+	CHKNULL(delta->gone);
+
+	if((result = tbl_create(delta->rows->id)) == NULL)
+	{
+		return NULL;
+	}
+
+	if(((rows_idx = p_tbl_index(delta->rows, delta->key, &rows_mask)) == NULL) ||
+	   ((gone_idx = p_tbl_index(delta->gone, delta->key, &gone_mask)) == NULL) ||
+	   ((used = STAKE(delta->rows->num_rows + 1)) == NULL))
+	{
+		success = AMP_FAIL;
+	}
+
+	/* Step 1: Rows of the previous table, unless deleted or changed. */
+	for(i = 0; (prev != NULL) && (i < prev->num_rows) && (success == AMP_OK); i++)
+	{
+		if(p_tbl_index_find(delta->gone, gone_idx, gone_mask, prev, i, delta->key) >= 0)
+		{
+			continue;
+		}
+
+		if((found = p_tbl_index_find(delta->rows, rows_idx, rows_mask, prev, i, delta->key)) >= 0)
+		{
+			used[found] = 1;
+			success = p_tbl_copy_row(result, delta->rows, found);
+		}
+		else
+		{
+			success = p_tbl_copy_row(result, prev, i);
+		}
+	}
+
+	/* Step 2: Inserted rows. */
+	for(i = 0; (i < delta->rows->num_rows) && (success == AMP_OK); i++)
+	{
+		if(used[i] == 0)
+		{
+			success = p_tbl_copy_row(result, delta->rows, i);
+		}
+	}
+
+	SRELEASE(rows_idx);
+	SRELEASE(gone_idx);
+	SRELEASE(used);
+
+	if(success != AMP_OK)
+	{
+		AMP_DEBUG_ERR("tbl_delta_apply", "Can't apply delta %d.", delta->seq);
+		tbl_release(result, 1);
+		result = NULL;
+	}
+
+	return result;
+}
+
+
+void tbl_delta_cb_del_fn(void *item)
+{
+	tbl_delta_release((tbl_delta_t*) item, 1);
+}
+
+
+/******************************************************************************
+ *
+ * \par Function Name: tbl_delta_create
+ *
+ * \par Purpose: Finds the rows inserted, changed or deleted between two
+ *               versions of a table.
+ *
+ * \return The delta, or NULL on error.
+ *
+ * \param[in] prev  The table last sent, or NULL to hold the whole of cur
+ * \param[in] cur   The table now
+ * \param[in] key   The key columns, one bit per column
+ *
+ * \par Notes:
+ *  - The delta deep-copies the rows it holds. The caller sets its base and
+ *    sequence numbers.
+ *  - Rows are matched through a hash of their key columns, so this is linear
+ *    in the number of rows. It fails if two rows of cur have the same key.
+ *****************************************************************************/
+
+tbl_delta_t* tbl_delta_create(tbl_t *prev, tbl_t *cur, uint32_t key)
+{
+	tbl_delta_t *result;
+	uint32_t *cur_idx = NULL;
+	uint32_t *prev_idx = NULL;
+	uint32_t cur_mask;
+	uint32_t prev_mask;
+	uint8_t *matched = NULL;
+	int success = AMP_OK;
+	int found;
+	uint32_t i;
+
+	CHKNULL(cur);
+
+	if((result = STAKE(sizeof(tbl_delta_t))) == NULL)
+	{
+		return NULL;
+	}
+	result->key = key;
+
+	if(((result->rows = tbl_create(cur->id)) == NULL) ||
+	   ((result->gone = tbl_create(cur->id)) == NULL))
+	{
+		tbl_delta_release(result, 1);
+		return NULL;
+	}
+
+	/* The index of cur is only built to reject duplicate keys. */
+	if(((cur_idx = p_tbl_index(cur, key, &cur_mask)) == NULL) ||
+	   ((prev != NULL) && ((prev_idx = p_tbl_index(prev, key, &prev_mask)) == NULL)) ||
+	   ((prev != NULL) && ((matched = STAKE(prev->num_rows + 1)) == NULL)))
+	{
+		success = AMP_FAIL;
+	}
+
+	/* Step 1: Rows inserted or changed. */
+	for(i = 0; (i < cur->num_rows) && (success == AMP_OK); i++)
+	{
+		if((prev != NULL) && ((found = p_tbl_index_find(prev, prev_idx, prev_mask, cur, i, key)) >= 0))
+		{
+			matched[found] = 1;
+			if(p_tbl_rows_equal(prev, found, cur, i, UINT32_MAX))
+			{
+				continue;
+			}
+		}
+		success = p_tbl_copy_row(result->rows, cur, i);
+	}
+
+	/* Step 2: Rows deleted. */
+	for(i = 0; (prev != NULL) && (i < prev->num_rows) && (success == AMP_OK); i++)
+	{
+		if(matched[i] == 0)
+		{
+			success = p_tbl_copy_row(result->gone, prev, i);
+		}
+	}
+
+	SRELEASE(cur_idx);
+	SRELEASE(prev_idx);
+	SRELEASE(matched);
+
+	if(success != AMP_OK)
+	{
+		tbl_delta_release(result, 1);
+		result = NULL;
+	}
+
+	return result;
+}
+
+
+void* tbl_delta_deserialize_ptr(QCBORDecodeContext *it, int *success)
+{
+	tbl_delta_t *result = NULL;
+	QCBORError err;
+	QCBORItem item;
+
+	AMP_DEBUG_ENTRY("tbl_delta_deserialize_ptr",
+					"(%"PRIxPTR",%"PRIxPTR")", it, success);
+
+	CHKNULL(success);
+	*success = AMP_FAIL;
+	CHKNULL(it);
+
+	/* Step 1: An array of base, sequence, key, rows and deleted rows. */
+	err = QCBORDecode_GetNext(it, &item);
+	if((err != QCBOR_SUCCESS) || (item.uDataType != QCBOR_TYPE_ARRAY) || (item.val.uCount != 5))
+	{
+		return NULL;
+	}
+
+	if((result = STAKE(sizeof(tbl_delta_t))) == NULL)
+	{
+		return NULL;
+	}
+
+	if((cut_get_cbor_numeric(it, AMP_TYPE_UINT, &(result->base)) != AMP_OK) ||
+	   (cut_get_cbor_numeric(it, AMP_TYPE_UINT, &(result->seq)) != AMP_OK) ||
+	   (cut_get_cbor_numeric(it, AMP_TYPE_UINT, &(result->key)) != AMP_OK))
+	{
+		tbl_delta_release(result, 1);
+		return NULL;
+	}
+
+	/* Step 2: The rows, as tables of their own. */
+	if(((result->rows = tbl_deserialize_ptr(it, success)) == NULL) ||
+	   ((result->gone = tbl_deserialize_ptr(it, success)) == NULL))
+	{
+		AMP_DEBUG_ERR("tbl_delta_deserialize_ptr", "Can't get rows.", NULL);
+		*success = AMP_FAIL;
+		tbl_delta_release(result, 1);
+		return NULL;
+	}
+
+	return result;
+}
+
+
+void tbl_delta_release(tbl_delta_t *delta, int destroy)
+{
+	CHKVOID(delta);
+	tbl_release(delta->rows, 1);
+	tbl_release(delta->gone, 1);
+
+	if(destroy)
+	{
+		SRELEASE(delta);
+	}
+}
+
+
+int tbl_delta_serialize(QCBOREncodeContext *encoder, void *item)
+{
+	tbl_delta_t *delta = (tbl_delta_t *) item;
+	int err;
+
+	CHKUSR(encoder, AMP_FAIL);
+	CHKUSR(delta, AMP_FAIL);
+
+	QCBOREncode_OpenArray(encoder);
+	QCBOREncode_AddUInt64(encoder, delta->base);
+	QCBOREncode_AddUInt64(encoder, delta->seq);
+	QCBOREncode_AddUInt64(encoder, delta->key);
+
+	if((err = tbl_serialize(encoder, delta->rows)) == AMP_OK)
+	{
+		err = tbl_serialize(encoder, delta->gone);
+	}
+
+	QCBOREncode_CloseArray(encoder);
+	return err;
+}
+
+
+
 /* TABLE TEMPLATE FUNCTIONS */
 
 
@@ -539,6 +1426,8 @@ tblt_t* tblt_copy_ptr(tblt_t *tblt)
 		return NULL;
 	}
 
+	result->key = tblt->key;
+	result->version = tblt->version;
 	result->cols = vec_copy(&(tblt->cols), &success);
 	if(success != AMP_OK)
 	{
@@ -602,6 +1491,41 @@ int tblt_num_cols(tblt_t *tblt)
 	return vec_num_entries(tblt->cols);
 }
 
+
+/******************************************************************************
+ *
+ * \par Function Name: tblt_set_key
+ *
+ * \par Purpose: Makes the tables of a template incremental, so that they are
+ *               sent as the rows changed since the table last sent.
+ *
+ * \return AMP Status Code
+ *
+ * \param[in|out] tblt     The table template
+ * \param[in]     key      The columns identifying a row, one bit per column
+ * \param[in]     version  Optional. Lets the agent skip building a table which
+ *                         has not changed since it was last sent.
+ *
+ * \par Notes:
+ *  - No two rows of a table may have the same key. A table which does is
+ *    sent whole.
+ *****************************************************************************/
+
+int tblt_set_key(tblt_t *tblt, uint32_t key, tblt_version_fn version)
+{
+	CHKUSR(tblt, AMP_FAIL);
+
+	if((key == 0) || ((tblt_num_cols(tblt) < 32) && ((key >> tblt_num_cols(tblt)) != 0)))
+	{
+		AMP_DEBUG_ERR("tblt_set_key", "Bad key columns 0x%x.", key);
+		return AMP_FAIL;
+	}
+
+	tblt->key = key;
+	tblt->version = version;
+	return AMP_OK;
+}
+
 void tblt_release(tblt_t *tblt, int destroy)
 {
 	if(tblt == NULL)
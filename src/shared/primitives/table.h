@@ -63,6 +63,12 @@ extern "C" {
 
 #define TBLT_DEFAULT_ENC_SIZE 1024
 
+/* Rows first allocated for a columnar table. */
+#define TBL_DEFAULT_NUM_ROWS 16
+
+/* Deltas sent for an incremental table before the whole table is resent. */
+#define TBL_DELTA_MAX_CHAIN 16
+
 /*
  * +--------------------------------------------------------------------------+
  * |							  	MACROS  								  +
@@ -75,14 +81,56 @@ extern "C" {
  * |							  DATA TYPES  								  +
  * +--------------------------------------------------------------------------+
  */
+
+/**
+ * One column of a table.
+ *
+ * Numeric values (including times) are held unboxed in an array of their
+ * C type. Values of other types are held in an array of tnv_t.
+ */
+typedef struct
+{
+	amp_type_e type;
+	void *values;
+} tbl_col_t;
+
+
+/**
+ * Tables are held by column, whether built one value at a time with
+ * tbl_append_val() and its typed variants or one row at a time with
+ * tbl_add_row(), so numeric values are never allocated on their own.
+ */
 typedef struct
 {
 	ari_t    *id;   /**> The ID of the table template that this populates. */
-	vector_t rows; /**> Vector of rows in the table. (tnvc_t*) */
+
+	tbl_col_t *cols;   /**> Columns, from the template, or NULL if empty. */
+	uint32_t num_cols;
+	uint32_t num_rows; /**> Complete rows in the table. */
+	uint32_t max_rows; /**> Rows allocated in each column. */
+	uint32_t cur_col;  /**> Column of the next appended value. */
 } tbl_t;
 
 typedef tbl_t* (*tblt_build_fn)(ari_t *id);
 
+/* Returns a value that changes whenever the table built for id would. */
+typedef uint64_t (*tblt_version_fn)(ari_t *id);
+
+
+/**
+ * The changes to an incremental table since a table the recipient already
+ * has. Rows are matched between the two tables by their key columns.
+ *
+ * A delta with a base of 0 holds the whole table.
+ */
+typedef struct
+{
+	uint32_t base;  /**> Sequence number of the table this applies to, or 0. */
+	uint32_t seq;   /**> Sequence number of the table once applied. */
+	uint32_t key;   /**> Key columns, as in tblt_t. */
+	tbl_t   *rows;  /**> Rows inserted or changed. */
+	tbl_t   *gone;  /**> Rows deleted, as last sent. */
+} tbl_delta_t;
 
 
 typedef struct
@@ -99,6 +147,10 @@ typedef struct
 
 	tblt_build_fn build;
 	db_desc_t desc;
+
+	/* Incremental tables only. */
+	uint32_t key;            /* Key columns, one bit per column, or 0. */
+	tblt_version_fn version; /* Optional, to skip building unchanged tables. */
 } tblt_t;
 
 
@@ -111,6 +163,18 @@ typedef struct
 
 int      tbl_add_row(tbl_t *tbl, tnvc_t *row);
 
+int      tbl_append_val(tbl_t *tbl, tnv_t val);
+int      tbl_append_bool(tbl_t *tbl, uint8_t val);
+int      tbl_append_byte(tbl_t *tbl, uint8_t val);
+int      tbl_append_int(tbl_t *tbl, int32_t val);
+int      tbl_append_uint(tbl_t *tbl, uint32_t val);
+int      tbl_append_vast(tbl_t *tbl, amp_vast val);
+int      tbl_append_uvast(tbl_t *tbl, amp_uvast val);
+int      tbl_append_real32(tbl_t *tbl, float val);
+int      tbl_append_real64(tbl_t *tbl, double val);
+int      tbl_append_str(tbl_t *tbl, const char *str);
+int      tbl_append_tv(tbl_t *tbl, amp_tv_t val);
+
 void     tbl_clear(tbl_t *tbl);
 
 tbl_t*   tbl_copy_ptr(tbl_t *tbl);
@@ -121,7 +185,7 @@ void*   tbl_deserialize_ptr(QCBORDecodeContext *it, int *success);
 
 tbl_t*   tbl_deserialize_raw(blob_t *data, int *success);
 
-tnvc_t*  tbl_get_row(tbl_t *tbl, int row_idx);
+int      tbl_get_cell(tbl_t *tbl, uint32_t row_idx, uint32_t col_idx, tnv_t *val);
 
 void     tbl_release(tbl_t *tbl, int destroy);
 
@@ -129,6 +193,8 @@ int      tbl_num_rows(tbl_t *tbl);
 
 int      tbl_serialize(QCBOREncodeContext *encoder, void *item);
 
+int      tbl_serialize_rows(QCBOREncodeContext *encoder, tbl_t *tbl, int first, int num);
+
 blob_t*   tbl_serialize_wrapper(tbl_t *tbl);
 
 void      tbl_cb_del_fn(void *item);
@@ -137,6 +203,22 @@ int tbl_cb_comp_fn(void *i1, void *i2);
 
 
 
+/* Incremental table functions */
+
+tbl_t*       tbl_delta_apply(tbl_t *prev, tbl_delta_t *delta);
+
+void         tbl_delta_cb_del_fn(void *item);
+
+tbl_delta_t* tbl_delta_create(tbl_t *prev, tbl_t *cur, uint32_t key);
+
+void*        tbl_delta_deserialize_ptr(QCBORDecodeContext *it, int *success);
+
+void         tbl_delta_release(tbl_delta_t *delta, int destroy);
+
+int          tbl_delta_serialize(QCBOREncodeContext *encoder, void *item);
+
+
+
 /* tbl Template Functions */
 
 int       tblt_add_col(tblt_t *tblt, amp_type_e type, char *name);
@@ -157,6 +239,8 @@ amp_type_e tblt_get_type(tblt_t *tblt, int idx);
 
 int       tblt_num_cols(tblt_t *tblt);
 
+int       tblt_set_key(tblt_t *tblt, uint32_t key, tblt_version_fn version);
+
 void      tblt_release(tblt_t *tblt, int destroy);
 
 
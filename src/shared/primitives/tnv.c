@@ -1409,6 +1409,49 @@ amp_tv_t tnv_to_tv(tnv_t val, int *success)
 // TNVC Stuff.
 
 
+/* Make room for at least num TNVs in a TNVC. */
+static int p_tnvc_reserve(tnvc_t *tnvc, size_t num)
+{
+	size_t new_max;
+	tnv_t *tmp;
+
+	if(num <= tnvc->max)
+	{
+		return AMP_OK;
+	}
+
+	if(num > VEC_MAX_IDX)
+	{
+		AMP_DEBUG_ERR("p_tnvc_reserve","Too many TNVs: %d", num);
+		return AMP_FAIL;
+	}
+
+	new_max = (tnvc->max == 0) ? VEC_DEFAULT_NUM : tnvc->max;
+	while(new_max < num)
+	{
+		new_max *= 2;
+	}
+	if(new_max > VEC_MAX_IDX)
+	{
+		new_max = VEC_MAX_IDX;
+	}
+
+	if((tmp = STAKE(new_max * sizeof(tnv_t))) == NULL)
+	{
+		return AMP_SYSERR;
+	}
+
+	if(tnvc->num > 0)
+	{
+		memcpy(tmp, tnvc->values, tnvc->num * sizeof(tnv_t));
+	}
+	SRELEASE(tnvc->values);
+	tnvc->values = tmp;
+	tnvc->max = new_max;
+	return AMP_OK;
+}
+
+
 /******************************************************************************
  * Append one TNVC to another TNVC.
  *
@@ -1423,9 +1466,8 @@ amp_tv_t tnv_to_tv(tnv_t val, int *success)
 
 int tnvc_append(tnvc_t *dst, tnvc_t *src)
 {
-	uint8_t i;
-	vec_idx_t max;
-	int success = AMP_OK;
+	vec_idx_t i;
+	int success;
 
 	if((dst == NULL) || (src == NULL))
 	{
@@ -1434,41 +1476,31 @@ int tnvc_append(tnvc_t *dst, tnvc_t *src)
 	}
 
 	/* Appending an empty list is easy... */
-	if((max = vec_num_entries(src->values)) == 0)
+	if(src->num == 0)
 	{
 		return AMP_OK;
 	}
 
 	/* Make sure the destination TNVC has room. */
-	vec_make_room(&(dst->values), max);
+	if((success = p_tnvc_reserve(dst, dst->num + src->num)) != AMP_OK)
+	{
+		return success;
+	}
 
 	/* Deep copy each item. */
-	for(i = 0; i < max; i++)
+	for(i = 0; i < src->num; i++)
 	{
-		tnv_t *cur_tnv = (tnv_t *)vec_at(&(src->values), i);
-		tnv_t *new_tnv = NULL;
-
-		if((cur_tnv == NULL) ||
-		   ((new_tnv = tnv_copy_ptr(cur_tnv)) == NULL))
+		dst->values[dst->num] = tnv_copy(src->values[i], &success);
+		if(success != AMP_OK)
 		{
 			AMP_DEBUG_ERR("tnvc_append","Unable to copy item %d", i);
-			break;
-		}
-
-		if(vec_insert(&(dst->values), new_tnv, NULL) != VEC_OK)
-		{
-			AMP_DEBUG_ERR("tnvc_append","Unable to insert item %d", i);
-			tnv_release(new_tnv, 1);
-			break;
+			tnv_release(&(dst->values[dst->num]), 0);
+			return AMP_FAIL;
 		}
+		dst->num++;
 	}
 
-	if (i < max)
-	{
-		success = AMP_FAIL;
-	}
-
-	return success;
+	return AMP_OK;
 }
 
 
@@ -1497,9 +1529,15 @@ void* tnvc_cb_copy_fn(void *item)
 
 void tnvc_clear(tnvc_t* tnvc)
 {
+	vec_idx_t i;
+
 	if(tnvc != NULL)
 	{
-		vec_clear(&(tnvc->values));
+		for(i = 0; i < tnvc->num; i++)
+		{
+			tnv_release(&(tnvc->values[i]), 0);
+		}
+		tnvc->num = 0;
 	}
 }
 
@@ -1519,26 +1557,22 @@ void tnvc_clear(tnvc_t* tnvc)
 
 int tnvc_compare(tnvc_t *t1, tnvc_t *t2)
 {
-	uint8_t i = 0;
+	vec_idx_t i = 0;
 	int diff = 0;
-	vecit_t it1, it2;
 
 	if((t1 == NULL) || (t2 == NULL))
 	{
 		return -1;
 	}
 
-	if(vec_num_entries(t1->values) != vec_num_entries(t2->values))
+	if(t1->num != t2->num)
 	{
 		return 1;
 	}
 
-	// Use iterator to ensure we are comparing values and not internal storage
-	it1 = vecit_first(&(t1->values));
-	it2 = vecit_first(&(t2->values));
-	for(i = 0; i < vec_num_entries(t1->values); i++, vecit_next(it1), vecit_next(it2))
+	for(i = 0; i < t1->num; i++)
 	{
-		if( (diff = tnv_compare(vecit_data(it1), vecit_data(it2)) ) != 0)
+		if( (diff = tnv_compare(&(t1->values[i]), &(t2->values[i])) ) != 0)
 		{
 			return diff;
 		}
@@ -1558,13 +1592,12 @@ int tnvc_compare(tnvc_t *t1, tnvc_t *t2)
  * \param[in]  num  The expected number of entries in the TNVC.
  *
  * \note
- *   - This allocated the TNVC and sets up the vector that holds its TNVs
+ *   - This allocates the TNVC and room for num TNVs.
  *****************************************************************************/
 
 tnvc_t *tnvc_create(uint8_t num)
 {
 	tnvc_t *result = NULL;
-	int success = AMP_FAIL;
 
 	if((result = (tnvc_t *) STAKE(sizeof(tnvc_t))) == NULL)
 	{
@@ -1572,11 +1605,9 @@ tnvc_t *tnvc_create(uint8_t num)
 		return NULL;
 	}
 
-	result->values = vec_create(num,tnv_cb_del,tnv_cb_comp,tnv_cb_copy, VEC_FLAG_AS_STACK, &success);
-
-	if(success != AMP_OK)
+	if(tnvc_init(result, num) != AMP_OK)
 	{
-		AMP_DEBUG_ERR("tdc_create","Can't allocate vector.", NULL);
+		AMP_DEBUG_ERR("tdc_create","Can't allocate values.", NULL);
 		SRELEASE(result);
 		return NULL;
 	}
@@ -1600,7 +1631,7 @@ tnvc_t* tnvc_copy(tnvc_t *src)
    tnvc_t *result = NULL;
 
    if((src == NULL) ||
-      ((result = tnvc_create(vec_size(&(src->values)))) == NULL))
+      ((result = tnvc_create(src->num)) == NULL))
    {
 	   return NULL;
    }
@@ -1870,29 +1901,27 @@ static tnvc_t tnvc_deserialize_tvc(QCBORDecodeContext *array_it, size_t array_le
 		return result;
 	}
 	
-	result.values = vec_create(array_len - 2, tnv_cb_del,tnv_cb_comp,tnv_cb_copy, VEC_FLAG_AS_STACK, success);
-
-	if(*success != AMP_OK)
+	if((*success = tnvc_init(&result, array_len - 2)) != AMP_OK)
 	{
-		AMP_DEBUG_ERR("tnvc_deserialize_tvc","Can;t allocate vector.", NULL);
+		AMP_DEBUG_ERR("tnvc_deserialize_tvc","Can;t allocate values.", NULL);
 		blob_release(&types, 0);
 		return result;
 	}
 
-	/* For each type deserialize values */
+	/* For each type deserialize values directly into the collection. */
 	for(i = 0; i < types.length; i++)
 	{
-		tnv_t *val = tnv_create();
+		tnv_t *val = &(result.values[result.num]);
 		*success = AMP_FAIL;
 
 		blob_t *blob = blob_deserialize_ptr(array_it, success);
 
 		if(blob != NULL)
 		{
-			val->type = types.value[i];
+			tnv_init(val, types.value[i]);
 			if((*success = tnv_deserialize_val_raw(blob, val)) == AMP_OK)
 			{
-				vec_insert(&(result.values), val, NULL);
+				result.num++;
 			}
 			blob_release(blob, 1);
 		}
@@ -1908,7 +1937,7 @@ static tnvc_t tnvc_deserialize_tvc(QCBORDecodeContext *array_it, size_t array_le
 	if(*success != AMP_OK)
 	{
 		AMP_DEBUG_ERR("tnv_deserialize_tvc","Failed to deserialize values (last was %d).", i);
-		vec_release(&(result.values), 0);
+		tnvc_release(&result, 0);
 		return result;
 	}
 
@@ -1933,35 +1962,27 @@ static tnvc_t tnvc_deserialize_tvc(QCBORDecodeContext *array_it, size_t array_le
 		return result;
 	}
 
-	result.values = vec_create(array_len, tnv_cb_del,tnv_cb_comp,tnv_cb_copy, VEC_FLAG_AS_STACK, success);
-
-	if(*success != AMP_OK)
+	if((*success = tnvc_init(&result, array_len)) != AMP_OK)
 	{
-		AMP_DEBUG_ERR("tnvc_deserialize_tvc","Can;t allocate vector.", NULL);
+		AMP_DEBUG_ERR("tnvc_deserialize_tvc","Can;t allocate values.", NULL);
 		blob_release(&types, 0);
 		return result;
 	}
 
-	/* For each type deserialize values */
+	/* For each type deserialize values directly into the collection. */
 	for(i = 0; i < array_len; i++)
 	{
-		tnv_t *val = tnv_create();
-		*success = AMP_FAIL;
-		if (val == NULL)
-		{
-			AMP_DEBUG_ERR("tnv_deserialize_tvc","Error allocating TNV", NULL);
-			break;
-		}
-		val->type = types.value[i];
+		tnv_t *val = &(result.values[result.num]);
 
+		tnv_init(val, types.value[i]);
 		*success = tnv_deserialize_val_by_type(array_it, val);
 		if (*success == AMP_OK)
 		{
-			vec_insert(&(result.values), val, NULL);
+			result.num++;
 		}
 		else
 		{
-			tnv_release(val, 1);
+			tnv_release(val, 0);
 			AMP_DEBUG_ERR("tnv_deserialize_tvc", "Failed to deserialize TNV %i\n", i);
 			break;
 		}
@@ -1972,7 +1993,7 @@ static tnvc_t tnvc_deserialize_tvc(QCBORDecodeContext *array_it, size_t array_le
 	if(*success != AMP_OK)
 	{
 		AMP_DEBUG_ERR("tnv_deserialize_tvc","Failed to deserialize values (last was %d).", i);
-		vec_release(&(result.values), 0);
+		tnvc_release(&result, 0);
 		return result;
 	}
 
@@ -1992,13 +2013,11 @@ static tnvc_t tnvc_deserialize_tvc(QCBORDecodeContext *array_it, size_t array_le
 
 tnv_t* tnvc_get(tnvc_t* tnvc, uint8_t index)
 {
-	tnv_t *result = NULL;
-
-	if(tnvc != NULL)
+	if((tnvc == NULL) || (index >= tnvc->num))
 	{
-		result = vec_at(&(tnvc->values), index);
+		return NULL;
 	}
-	return result;
+	return &(tnvc->values[index]);
 }
 
 
@@ -2013,12 +2032,7 @@ tnv_t* tnvc_get(tnvc_t* tnvc, uint8_t index)
 
 uint8_t tnvc_get_count(tnvc_t* tnvc)
 {
-	uint8_t count = 0;
-	if(tnvc != NULL)
-	{
-		count = vec_num_entries(tnvc->values);
-	}
-	return count;
+	return (tnvc == NULL) ? 0 : tnvc->num;
 }
 
 
@@ -2049,12 +2063,8 @@ tnv_enc_e tnvc_get_encode_type(tnvc_t *tnvc)
 
 amp_type_e tnvc_get_type(tnvc_t *tnvc, uint8_t index)
 {
-	tnv_t *tnv = NULL;
+	tnv_t *tnv = tnvc_get(tnvc, index);
 
-	if(tnvc != NULL)
-	{
-		tnv = (tnv_t *) vec_at(&(tnvc->values), index);
-	}
 	return ((tnv == NULL) ? AMP_TYPE_UNK : tnv->type);
 }
 
@@ -2084,7 +2094,7 @@ blob_t tnvc_get_types(tnvc_t *tnvc, int *success)
 		return types;
 	}
 
-	length = vec_num_entries(tnvc->values);
+	length = tnvc->num;
 	blob_init(&types, NULL, 0, length);
 	for(i = 0; i < length; i++)
 	{
@@ -2110,14 +2120,10 @@ blob_t tnvc_get_types(tnvc_t *tnvc, int *success)
 
 int tnvc_init(tnvc_t *tnvc, size_t num)
 {
-	int success = AMP_FAIL;
-
-	if(tnvc != NULL)
-	{
-		tnvc->values = vec_create(num, tnv_cb_del, tnv_cb_comp, tnv_cb_copy, VEC_FLAG_AS_STACK, &success);
-	}
+	CHKUSR(tnvc, AMP_FAIL);
 
-	return success;
+	memset(tnvc, 0, sizeof(tnvc_t));
+	return p_tnvc_reserve(tnvc, num);
 }
 
 
@@ -2131,8 +2137,9 @@ int tnvc_init(tnvc_t *tnvc, size_t num)
  * \param[in]   tnv   The new TNV value.
  *
  * \note
- *   1. The new TNV is shallow-copied into the TNVC and MUST NOT be freed
- *      by the caller if this function succeeds.
+ *   1. The new TNV is moved into the TNVC and released, so it MUST NOT be
+ *      used or freed by the caller if this function succeeds. It is
+ *      released if this function fails.
  *****************************************************************************/
 
 int tnvc_insert(tnvc_t* tnvc, tnv_t *tnv)
@@ -2145,13 +2152,142 @@ int tnvc_insert(tnvc_t* tnvc, tnv_t *tnv)
 		return AMP_FAIL;
 	}
 
-	if((result = vec_insert(&(tnvc->values), tnv, NULL)) != AMP_OK)
+	result = tnvc_insert_val(tnvc, *tnv);
+	SRELEASE(tnv);
+
+	return result;
+}
+
+
+
+/******************************************************************************
+ * Inserts a TNV value to the end of a TNVC, without allocating a TNV.
+ *
+ * \returns AMP status code.
+ *
+ * \param[out]  tnvc  The TNVC receiving the new TNV.
+ * \param[in]   val   The new TNV value.
+ *
+ * \note
+ *   1. The TNVC takes over any storage owned by the value, which is
+ *      released if this function fails.
+ *****************************************************************************/
+
+int tnvc_insert_val(tnvc_t *tnvc, tnv_t val)
+{
+	int result;
+
+	if(tnvc == NULL)
 	{
-		AMP_DEBUG_ERR("tnvc_insert","Error vector inserting.", NULL);
-		tnv_release(tnv, 1);
+		tnv_release(&val, 0);
+		return AMP_FAIL;
 	}
 
-	return result;
+	if((result = p_tnvc_reserve(tnvc, tnvc->num + 1)) != AMP_OK)
+	{
+		AMP_DEBUG_ERR("tnvc_insert_val","Error making room.", NULL);
+		tnv_release(&val, 0);
+		return result;
+	}
+
+	tnvc->values[tnvc->num++] = val;
+	return AMP_OK;
+}
+
+
+
+/*
+ * Typed variants of tnvc_insert_val(), for filling reports and table rows
+ * without allocating each value.
+ */
+
+int tnvc_insert_bool(tnvc_t *tnvc, uint8_t val)
+{
+	tnv_t tnv;
+	tnv_init(&tnv, AMP_TYPE_BOOL);
+	tnv.value.as_byte = val;
+	return tnvc_insert_val(tnvc, tnv);
+}
+
+int tnvc_insert_byte(tnvc_t *tnvc, uint8_t val)
+{
+	tnv_t tnv;
+	tnv_init(&tnv, AMP_TYPE_BYTE);
+	tnv.value.as_byte = val;
+	return tnvc_insert_val(tnvc, tnv);
+}
+
+int tnvc_insert_int(tnvc_t *tnvc, int32_t val)
+{
+	tnv_t tnv;
+	tnv_init(&tnv, AMP_TYPE_INT);
+	tnv.value.as_int = val;
+	return tnvc_insert_val(tnvc, tnv);
+}
+
+int tnvc_insert_uint(tnvc_t *tnvc, uint32_t val)
+{
+	tnv_t tnv;
+	tnv_init(&tnv, AMP_TYPE_UINT);
+	tnv.value.as_uint = val;
+	return tnvc_insert_val(tnvc, tnv);
+}
+
+int tnvc_insert_vast(tnvc_t *tnvc, amp_vast val)
+{
+	tnv_t tnv;
+	tnv_init(&tnv, AMP_TYPE_VAST);
+	tnv.value.as_vast = val;
+	return tnvc_insert_val(tnvc, tnv);
+}
+
+int tnvc_insert_uvast(tnvc_t *tnvc, amp_uvast val)
+{
+	tnv_t tnv;
+	tnv_init(&tnv, AMP_TYPE_UVAST);
+	tnv.value.as_uvast = val;
+	return tnvc_insert_val(tnvc, tnv);
+}
+
+int tnvc_insert_real32(tnvc_t *tnvc, float val)
+{
+	tnv_t tnv;
+	tnv_init(&tnv, AMP_TYPE_REAL32);
+	tnv.value.as_real32 = val;
+	return tnvc_insert_val(tnvc, tnv);
+}
+
+int tnvc_insert_real64(tnvc_t *tnvc, double val)
+{
+	tnv_t tnv;
+	tnv_init(&tnv, AMP_TYPE_REAL64);
+	tnv.value.as_real64 = val;
+	return tnvc_insert_val(tnvc, tnv);
+}
+
+int tnvc_insert_str(tnvc_t *tnvc, const char *str)
+{
+	tnv_t tnv;
+	size_t len;
+
+	CHKUSR(str, AMP_FAIL);
+	tnv_init(&tnv, AMP_TYPE_STR);
+	len = strlen(str);
+	if((tnv.value.as_ptr = STAKE(len + 1)) == NULL)
+	{
+		return AMP_SYSERR;
+	}
+	memcpy(tnv.value.as_ptr, str, len);
+	TNV_SET_ALLOC(tnv.flags);
+	return tnvc_insert_val(tnvc, tnv);
+}
+
+int tnvc_insert_tv(tnvc_t *tnvc, amp_tv_t val)
+{
+	tnv_t tnv;
+	tnv_init(&tnv, AMP_TYPE_TV);
+	tnv.value.as_uvast = OS_TimeGetTotalSeconds(val.secs);
+	return tnvc_insert_val(tnvc, tnv);
 }
 
 
@@ -2171,7 +2307,10 @@ void tnvc_release(tnvc_t *tnvc, int destroy)
 {
 	if(tnvc != NULL)
 	{
-		vec_release(&(tnvc->values), 0);
+		tnvc_clear(tnvc);
+		SRELEASE(tnvc->values);
+		tnvc->values = NULL;
+		tnvc->max = 0;
 
 		if(destroy)
 		{
@@ -2247,7 +2386,7 @@ static int tnvc_serialize_tvc(QCBOREncodeContext *encoder, tnvc_t *tnvc)
 	CHKUSR(tnvc, AMP_FAIL);
 
     /* Step 1: Setup Container Flags */
-	num = vec_num_entries(tnvc->values);
+	num = tnvc->num;
 
 	// Start an Array. (Octets Array for AMP_VERSION >=7)
 	QCBOREncode_OpenArray(encoder);
@@ -2312,7 +2451,7 @@ static int tnvc_serialize_tvc(QCBOREncodeContext *encoder, tnvc_t *tnvc)
 	/* Step 4: For each value, encode it. */
 	for(i = 0; i < num; i++)
 	{
-		tnv_t *tnv = (tnv_t*) vec_at(&(tnvc->values),i);
+		tnv_t *tnv = &(tnvc->values[i]);
 
 #if AMP_VERSION < 7
 		/* Go through the trouble of getting a serialized string because we don't
@@ -2357,7 +2496,7 @@ static int tnvc_serialize_tvc(QCBOREncodeContext *encoder, tnvc_t *tnvc)
 size_t  tnvc_size(tnvc_t *tnvc)
 {
 	CHKZERO(tnvc);
-	return vec_num_entries(tnvc->values);
+	return tnvc->num;
 }
 
 
@@ -2367,19 +2506,16 @@ size_t  tnvc_size(tnvc_t *tnvc)
 
 int tnvc_update(tnvc_t *tnvc, uint8_t idx, tnv_t *src_tnv)
 {
-	int success = AMP_FAIL;
-	tnv_t *old = NULL;
-
 	CHKUSR(tnvc,AMP_FAIL);
 	CHKUSR(src_tnv,AMP_FAIL);
 
-
-	old = (tnv_t *) vec_set(&(tnvc->values), idx, src_tnv, &success);
-	if(success != AMP_OK)
+	if(idx >= tnvc->num)
 	{
-		return success;
+		return AMP_FAIL;
 	}
 
-	tnv_release(old, 1);
+	tnv_release(&(tnvc->values[idx]), 0);
+	tnvc->values[idx] = *src_tnv;
+	SRELEASE(src_tnv);
 	return AMP_OK;
-}
\ No newline at end of file
+}
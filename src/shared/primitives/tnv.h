@@ -126,6 +126,7 @@ typedef enum
 typedef struct
 {
 	amp_type_e type;        /**> The type of the information in this TNV. */
+	uint8_t flags;         /**> Flags for this TNV.*/
 
 	union {
 		void*    as_ptr;    /**> Value of the TNV. */
@@ -138,18 +139,26 @@ typedef struct
 		double   as_real64;
 	} value;
 
-	uint8_t flags;         /**> Flags for this TNV.*/
-
 } tnv_t;
 
 
 
 /**
  * A Type-Name-Value Collection (TNVC)...
+ *
+ * TNVs are packed by value into one array, so a collection of primitive
+ * values (such as a report or a table row) costs a single allocation however
+ * many values it holds. Strings, byte strings, and objects are stored out of
+ * line, as in any TNV.
+ *
+ * A TNV returned by tnvc_get() points into the collection and is only valid
+ * until the collection is next changed.
  */
 typedef struct
 {
-	vector_t values; /* Typed as tnv_t pointers. */
+	tnv_t *values;   /* Packed TNVs, of which num are in use. */
+	vec_idx_t num;
+	vec_idx_t max;
 } tnvc_t;
 
 
@@ -234,6 +243,17 @@ blob_t     tnvc_get_types(tnvc_t *tnvc, int *success);
 
 int      tnvc_init(tnvc_t *tnvc, size_t num);
 int      tnvc_insert(tnvc_t* tnvc, tnv_t *tnv);
+int      tnvc_insert_val(tnvc_t *tnvc, tnv_t val);
+int      tnvc_insert_bool(tnvc_t *tnvc, uint8_t val);
+int      tnvc_insert_byte(tnvc_t *tnvc, uint8_t val);
+int      tnvc_insert_int(tnvc_t *tnvc, int32_t val);
+int      tnvc_insert_uint(tnvc_t *tnvc, uint32_t val);
+int      tnvc_insert_vast(tnvc_t *tnvc, amp_vast val);
+int      tnvc_insert_uvast(tnvc_t *tnvc, amp_uvast val);
+int      tnvc_insert_real32(tnvc_t *tnvc, float val);
+int      tnvc_insert_real64(tnvc_t *tnvc, double val);
+int      tnvc_insert_str(tnvc_t *tnvc, const char *str);
+int      tnvc_insert_tv(tnvc_t *tnvc, amp_tv_t val);
 void     tnvc_release(tnvc_t *tnvc, int destroy);
 
 int      tnvc_serialize(QCBOREncodeContext *encoder, void *item);
@@ -37,6 +37,13 @@
  **  09/02/18  E. Birrane     Cleanup and update to latest spec. (JHU/APL)
  *****************************************************************************/
 
+#include <errno.h>
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
 #include "db.h"
 #include "rhht.h"
 #include "utils.h"
@@ -52,209 +59,780 @@
 
 
 vdb_store_t gVDB;
-db_store_t  gDB;
+db_store_t  gDB = { .lock = PTHREAD_MUTEX_INITIALIZER, .fd = -1 };
+__thread vdb_inst_t *gVDBInst = &gVDB.inst;
+
 
+#define DB_FILE_MAGIC   0x4a424441 /* "ADBJ" in host byte order */
+#define DB_FILE_VERSION 1
 
-int  db_forget(db_desc_t *desc, void* list)
+/* Leading header of both the journal and snapshot files. */
+typedef struct
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t next_id;
+	uint32_t unused;
+} db_file_hdr_t;
+
+/* Header of each record. The CRC covers everything after itself. */
+typedef struct
 {
-#if 0
-	Sdr sdr = getIonsdr();
-	Object elt;
+	uint32_t len;
+	uint32_t crc;
+	uint32_t id;
+	uint8_t  type;
+	uint8_t  op;
+	uint16_t unused;
+} db_rec_hdr_t;
+
+/* Payload of a DB_OP_STATE record. */
+#define DB_RULE_STATE_LEN 26
+
+/* A record parsed from a loaded file, pointing into the file contents. */
+typedef struct
+{
+	uint32_t id;
+	uint32_t seq;
+	uint8_t  type;
+	uint8_t  op;
+	uint32_t len;
+	const uint8_t *data;
+} db_rec_t;
+
+typedef struct
+{
+	db_rec_t *recs;
+	size_t    num;
+	size_t    cap;
+	uint32_t  next_id;
+} db_rec_list_t;
 
-	CHKERR(desc);
-	CHKERR(list != 0);
 
-	CHKERR(sdr_begin_xn(sdr));
+static uint32_t db_rec_crc(const db_rec_hdr_t *hdr, const uint8_t *data)
+{
+	uint32_t crc = utils_crc32(0, (const uint8_t *) &(hdr->id),
+	                           sizeof(db_rec_hdr_t) - offsetof(db_rec_hdr_t, id));
+	return utils_crc32(crc, data, hdr->len);
+}
 
-	/* Free the item wherever it is in the SDR. */
-	if(desc->itemObj != 0)
+static int db_write_all(int fd, const uint8_t *data, size_t len)
+{
+	while(len > 0)
 	{
-	  sdr_free(sdr, desc->itemObj);
-	  desc->itemObj = 0;
-	  desc->itemSize = 0;
+		ssize_t got = write(fd, data, len);
+		if(got < 0)
+		{
+			if(errno == EINTR)
+			{
+				continue;
+			}
+			return AMP_SYSERR;
+		}
+		data += got;
+		len -= got;
 	}
+	return AMP_OK;
+}
 
-	/* Remove the object descriptor from the list. */
-	if(desc->descObj != 0)
+static int db_write_file_hdr(int fd, uint32_t next_id)
+{
+	db_file_hdr_t hdr = { DB_FILE_MAGIC, DB_FILE_VERSION, next_id, 0 };
+	return db_write_all(fd, (const uint8_t *) &hdr, sizeof(hdr));
+}
+
+/*
+ * Read an entire file into memory. A missing file is not an error and
+ * yields an empty result.
+ */
+static int db_file_load(const char *path, uint8_t **data, size_t *len)
+{
+	struct stat st;
+	int fd;
+	size_t got = 0;
+
+	*data = NULL;
+	*len = 0;
+
+	if((fd = open(path, O_RDONLY)) < 0)
 	{
-	   elt = sdr_list_first(sdr, list);
-	   while(elt)
-	   {
-		   if(sdr_list_data(sdr, elt) == desc->descObj)
-		   {
-			   sdr_list_delete(sdr, elt, NULL, NULL);
-			   sdr_free(sdr, desc->descObj);
-			   desc->descObj = 0;
-			   elt = 0;
-		   }
-		   else
-		   {
-			   elt = sdr_list_next(sdr, elt);
-		   }
-	   }
+		return (errno == ENOENT) ? AMP_OK : AMP_SYSERR;
 	}
+	if((fstat(fd, &st) != 0) || ((*data = STAKE(st.st_size + 1)) == NULL))
+	{
+		close(fd);
+		return AMP_SYSERR;
+	}
+	while(got < (size_t) st.st_size)
+	{
+		ssize_t res = read(fd, *data + got, st.st_size - got);
+		if(res < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		if(res <= 0)
+		{
+			break;
+		}
+		got += res;
+	}
+	close(fd);
+	*len = got;
+	return AMP_OK;
+}
 
-	sdr_end_xn(sdr);
+/*
+ * Parse the records of a loaded file into list, stopping at the first
+ * torn or corrupt record.
+ *
+ * Returns the length of the valid prefix of the file, or 0 if the file
+ * header itself is missing or invalid.
+ */
+static size_t db_file_parse(const uint8_t *data, size_t len, db_rec_list_t *list)
+{
+	db_file_hdr_t fhdr;
+	size_t pos = sizeof(db_file_hdr_t);
 
-#endif
+	if(len < sizeof(fhdr))
+	{
+		return 0;
+	}
+	memcpy(&fhdr, data, sizeof(fhdr));
+	if((fhdr.magic != DB_FILE_MAGIC) || (fhdr.version != DB_FILE_VERSION))
+	{
+		AMP_DEBUG_ERR("db_file_parse", "Unknown DB file format.", NULL);
+		return 0;
+	}
+	if(fhdr.next_id > list->next_id)
+	{
+		list->next_id = fhdr.next_id;
+	}
+
+	while(len - pos >= sizeof(db_rec_hdr_t))
+	{
+		db_rec_hdr_t hdr;
+		db_rec_t *rec;
+
+		memcpy(&hdr, data + pos, sizeof(hdr));
+		if((hdr.len > len - pos - sizeof(hdr))
+		   || (hdr.crc != db_rec_crc(&hdr, data + pos + sizeof(hdr))))
+		{
+			AMP_DEBUG_WARN("db_file_parse", "Discarding %zu bytes after offset %zu.",
+			               len - pos, pos);
+			break;
+		}
+
+		if(list->num == list->cap)
+		{
+			size_t cap = list->cap ? (2 * list->cap) : 1024;
+			db_rec_t *recs = realloc(list->recs, cap * sizeof(db_rec_t));
+			if(recs == NULL)
+			{
+				break;
+			}
+			list->recs = recs;
+			list->cap = cap;
+		}
+
+		rec = &(list->recs[list->num]);
+		rec->id = hdr.id;
+		rec->seq = list->num;
+		rec->type = hdr.type;
+		rec->op = hdr.op;
+		rec->len = hdr.len;
+		rec->data = data + pos + sizeof(hdr);
+		list->num++;
+
+		if(hdr.id >= list->next_id)
+		{
+			list->next_id = hdr.id + 1;
+		}
+		pos += sizeof(hdr) + hdr.len;
+	}
+
+	return pos;
+}
+
+static int db_rec_cmp(const void *a, const void *b)
+{
+	const db_rec_t *r1 = a;
+	const db_rec_t *r2 = b;
+
+	if(r1->id != r2->id)
+	{
+		return (r1->id < r2->id) ? -1 : 1;
+	}
+	return (r1->seq < r2->seq) ? -1 : (r1->seq > r2->seq);
+}
+
+/*
+ * Reduce a record list to the live objects, in identifier order. Each
+ * live object is left as its latest PUT, optionally followed by the
+ * latest STATE recorded after that PUT.
+ */
+static void db_rec_merge(db_rec_list_t *list)
+{
+	size_t in = 0;
+	size_t out = 0;
+
+	qsort(list->recs, list->num, sizeof(db_rec_t), db_rec_cmp);
+
+	while(in < list->num)
+	{
+		uint32_t id = list->recs[in].id;
+		db_rec_t *put = NULL;
+		db_rec_t *state = NULL;
+
+		for(; (in < list->num) && (list->recs[in].id == id); in++)
+		{
+			db_rec_t *rec = &(list->recs[in]);
+			switch(rec->op)
+			{
+				case DB_OP_PUT:   put = rec; state = NULL; break;
+				case DB_OP_DEL:   put = NULL; state = NULL; break;
+				case DB_OP_STATE: state = (put != NULL) ? rec : NULL; break;
+				default: break;
+			}
+		}
+
+		if(put != NULL)
+		{
+			db_rec_t tmp_state = (state != NULL) ? *state : (db_rec_t){0};
+			list->recs[out++] = *put;
+			if(state != NULL)
+			{
+				list->recs[out++] = tmp_state;
+			}
+		}
+	}
+	list->num = out;
+}
+
+/* Load the snapshot and journal into a merged record list. */
+static int db_load(db_rec_list_t *list, uint8_t **snap, uint8_t **jnl, size_t *jnl_valid, size_t *jnl_len)
+{
+	size_t snap_len;
+
+	memset(list, 0, sizeof(db_rec_list_t));
+	list->next_id = 1;
+
+	if((db_file_load(gDB.snap_path, snap, &snap_len) != AMP_OK)
+	   || (db_file_load(gDB.path, jnl, jnl_len) != AMP_OK))
+	{
+		AMP_DEBUG_ERR("db_load", "Unable to read %s.", gDB.path);
+		SRELEASE(*snap);
+		*snap = NULL;
+		return AMP_SYSERR;
+	}
+
+	db_file_parse(*snap, snap_len, list);
+	*jnl_valid = db_file_parse(*jnl, *jnl_len, list);
+	db_rec_merge(list);
 	return AMP_OK;
 }
 
-int  db_read_objs(char *name)
+/* Write buffered records to the journal file. Caller holds gDB.lock. */
+static int db_journal_write()
 {
-#if 0
-	Sdr sdr = getIonsdr();
+	if(gDB.buf_len == 0)
+	{
+		return AMP_OK;
+	}
+	if(db_write_all(gDB.fd, gDB.buf, gDB.buf_len) != AMP_OK)
+	{
+		AMP_DEBUG_ERR("db_journal_write", "Journal write failed: %s", strerror(errno));
+		return AMP_SYSERR;
+	}
+	gDB.size += gDB.buf_len;
+	gDB.buf_len = 0;
+	gDB.dirty = 1;
+	return AMP_OK;
+}
 
-	CHKUSR(name, AMP_FAIL);
+/* Append one record to the journal buffer. Caller holds gDB.lock. */
+static int db_journal_append(uint32_t id, uint8_t type, uint8_t op, const uint8_t *data, size_t len)
+{
+	db_rec_hdr_t hdr = { len, 0, id, type, op, 0 };
+	size_t need = sizeof(hdr) + len;
 
-	// * Initialize the non-volatile database. * /
-	memset((char*) &gDB, 0, sizeof(gDB));
+	if((gDB.buf_len + need > DB_JOURNAL_BUF_SIZE) && (db_journal_write() != AMP_OK))
+	{
+		return AMP_SYSERR;
+	}
+	if(gDB.buf_len + need > gDB.buf_cap)
+	{
+		size_t cap = (need > DB_JOURNAL_BUF_SIZE) ? need : DB_JOURNAL_BUF_SIZE;
+		uint8_t *buf = realloc(gDB.buf, cap);
+		if(buf == NULL)
+		{
+			return AMP_SYSERR;
+		}
+		gDB.buf = buf;
+		gDB.buf_cap = cap;
+	}
 
-	/* Recover the Agent database, creating it if necessary. */
-	CHKERR(sdr_begin_xn(sdr));
+	hdr.crc = db_rec_crc(&hdr, data);
+	memcpy(gDB.buf + gDB.buf_len, &hdr, sizeof(hdr));
+	if(len > 0)
+	{
+		memcpy(gDB.buf + gDB.buf_len + sizeof(hdr), data, len);
+	}
+	gDB.buf_len += need;
+	return AMP_OK;
+}
+
+/*
+ * Commit the directory entry of a renamed file, so that the rename itself
+ * survives a crash.
+ */
+static int db_sync_dir(const char *path)
+{
+	const char *slash = strrchr(path, '/');
+	char *dir;
+	int fd;
+	int success = AMP_SYSERR;
+
+	if(slash == NULL)
+	{
+		dir = strdup(".");
+	}
+	else
+	{
+		dir = strndup(path, (slash == path) ? 1 : (size_t)(slash - path));
+	}
+	if(dir == NULL)
+	{
+		return AMP_SYSERR;
+	}
+	if((fd = open(dir, O_RDONLY | O_DIRECTORY)) >= 0)
+	{
+		if(fsync(fd) == 0)
+		{
+			success = AMP_OK;
+		}
+		close(fd);
+	}
+	free(dir);
+	return success;
+}
 
-	gDB.descObj = sdr_find(sdr, name, NULL);
-	switch(gDB.descObj)
+/*
+ * Fold the journal into a new snapshot of the live objects and truncate
+ * the journal. Caller holds gDB.lock with the journal fully written.
+ */
+static int db_compact()
+{
+	db_rec_list_t list;
+	uint8_t *snap = NULL;
+	uint8_t *jnl = NULL;
+	size_t jnl_valid, jnl_len;
+	char *tmp_path = NULL;
+	int fd = -1;
+	int success = AMP_SYSERR;
+
+	if(db_load(&list, &snap, &jnl, &jnl_valid, &jnl_len) != AMP_OK)
+	{
+		return AMP_SYSERR;
+	}
+	if(list.next_id < gDB.next_id)
 	{
-		case -1:  // SDR error. * /
-			sdr_cancel_xn(sdr);
-			AMP_DEBUG_ERR("db_read_objs", "Can't search for DB in SDR.", NULL);
-			return -1;
+		list.next_id = gDB.next_id;
+	}
 
-		case 0: // Not found; Must create new DB. * /
+	if((asprintf(&tmp_path, "%s.tmp", gDB.snap_path) < 0)
+	   || ((fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0))
+	{
+		AMP_DEBUG_ERR("db_compact", "Unable to create snapshot.", NULL);
+		goto cleanup;
+	}
 
-			if((gDB.descObj = sdr_malloc(sdr, sizeof(gDB))) == 0)
+	/* Records are copied unchanged, reusing the journal buffer for batching. */
+	gDB.buf_len = 0;
+	if(db_write_file_hdr(fd, list.next_id) != AMP_OK)
+	{
+		goto cleanup;
+	}
+	for(size_t i = 0; i < list.num; i++)
+	{
+		db_rec_t *rec = &(list.recs[i]);
+		db_rec_hdr_t hdr = { rec->len, 0, rec->id, rec->type, rec->op, 0 };
+		size_t need = sizeof(hdr) + rec->len;
+
+		hdr.crc = db_rec_crc(&hdr, rec->data);
+		if(gDB.buf_len + need > gDB.buf_cap)
+		{
+			if(db_write_all(fd, gDB.buf, gDB.buf_len) != AMP_OK)
+			{
+				goto cleanup;
+			}
+			gDB.buf_len = 0;
+		}
+		if(need > gDB.buf_cap)
+		{
+			if((db_write_all(fd, (uint8_t *) &hdr, sizeof(hdr)) != AMP_OK)
+			   || (db_write_all(fd, rec->data, rec->len) != AMP_OK))
 			{
-				sdr_cancel_xn(sdr);
-				AMP_DEBUG_ERR("db_read_objs", "No space for database.", NULL);
-				return -1;
+				goto cleanup;
 			}
-			AMP_DEBUG_ALWAYS("db_read_objs", "Creating DB: %s", name);
+			continue;
+		}
+		memcpy(gDB.buf + gDB.buf_len, &hdr, sizeof(hdr));
+		memcpy(gDB.buf + gDB.buf_len + sizeof(hdr), rec->data, rec->len);
+		gDB.buf_len += need;
+	}
+	if((db_write_all(fd, gDB.buf, gDB.buf_len) != AMP_OK) || (fsync(fd) != 0))
+	{
+		goto cleanup;
+	}
+	gDB.buf_len = 0;
+	close(fd);
+	fd = -1;
 
-			gDB.ctrls = sdr_list_create(sdr);
-			gDB.macdefs = sdr_list_create(sdr);
-			gDB.rpttpls = sdr_list_create(sdr);
-			gDB.rules = sdr_list_create(sdr);
-			gDB.vars = sdr_list_create(sdr);
+	/* Once renamed the snapshot covers the journal, so replaying both is safe. */
+	if((rename(tmp_path, gDB.snap_path) != 0) || (db_sync_dir(gDB.snap_path) != AMP_OK))
+	{
+		goto cleanup;
+	}
+	if((ftruncate(gDB.fd, 0) != 0)
+	   || (db_write_file_hdr(gDB.fd, list.next_id) != AMP_OK)
+	   || (fdatasync(gDB.fd) != 0))
+	{
+		goto cleanup;
+	}
+	gDB.size = sizeof(db_file_hdr_t);
+	gDB.dirty = 0;
 
-			sdr_write(sdr, gDB.descObj, (char *) &gDB, sizeof(gDB));
-			sdr_catlg(sdr, name, 0, gDB.descObj);
+	AMP_DEBUG_INFO("db_compact", "Snapshot holds %zu records.", list.num);
+	success = AMP_OK;
 
-			break;
+cleanup:
+	if(success != AMP_OK)
+	{
+		AMP_DEBUG_ERR("db_compact", "Snapshot failed: %s", strerror(errno));
+		gDB.buf_len = 0;
+	}
+	if(fd >= 0)
+	{
+		close(fd);
+		unlink(tmp_path);
+	}
+	free(tmp_path);
+	free(list.recs);
+	SRELEASE(snap);
+	SRELEASE(jnl);
+	return success;
+}
+
+static inline int db_persisting()
+{
+	return gDB.fd >= 0;
+}
+
+/*
+ * Only the process's own instance is persisted, as the store has no
+ * notion of which instance an object belongs to.
+ */
+static inline int db_inst_persisting()
+{
+	return db_persisting() && (gVDBInst == &gVDB.inst);
+}
+
+
+/*
+ * Record that an object is no longer persisted.
+ *
+ * desc : The descriptor of the object being removed.
+ */
+int  db_forget(db_desc_t *desc)
+{
+	int success = AMP_OK;
+
+	CHKUSR(desc, AMP_FAIL);
+
+	pthread_mutex_lock(&gDB.lock);
+	if(db_inst_persisting() && (desc->itemId != 0))
+	{
+		success = db_journal_append(desc->itemId, 0, DB_OP_DEL, NULL, 0);
+	}
+	desc->itemId = 0;
+	desc->itemSize = 0;
+	pthread_mutex_unlock(&gDB.lock);
+
+	return success;
+}
+
+/* Restore a rule, overriding its stored execution state with a later delta. */
+static int db_init_rule(blob_t *data, db_desc_t desc, const db_rec_t *state)
+{
+	rule_t *rule = NULL;
+	int success;
+
+	CHKUSR(data, AMP_FAIL);
+
+	if((rule = rule_db_deserialize_raw(data, &success)) == NULL)
+	{
+		AMP_DEBUG_ERR("db_init_rule","Can't deserialize raw rule.", NULL);
+		return AMP_FAIL;
+	}
 
-		default:  /* Found DB in the SDR */
-			/* Read in the Database. */
-			sdr_read(sdr, (char *) &gDB, gDB.descObj, sizeof(gDB));
-			AMP_DEBUG_ALWAYS("db_read_objs", "Found DB", NULL);
+	rule->desc = desc;
+	if((state != NULL) && (state->len == DB_RULE_STATE_LEN))
+	{
+		int64_t eval_ms;
+
+		memcpy(&eval_ms, state->data, sizeof(eval_ms));
+		memcpy(&(rule->num_eval), state->data + 8, sizeof(uint64_t));
+		memcpy(&(rule->num_fire), state->data + 16, sizeof(uint64_t));
+		rule->flags = state->data[24];
+		if(state->data[25] < AMP_NUM_PRIO)
+		{
+			rule->prio = state->data[25];
+		}
+		rule->eval_at = OS_TimeFromTotalMilliseconds(eval_ms);
+	}
+	else if(state != NULL)
+	{
+		AMP_DEBUG_WARN("db_init_rule", "Ignoring state of %u bytes for rule %u.", state->len, desc.itemId);
 	}
 
-	if(sdr_end_xn(sdr))
+	if(VDB_ADD_RULE(&(rule->id), rule) != RH_OK)
 	{
-		AMP_DEBUG_ERR("db_read_objs", "Can't create Agent database.", NULL);
-		return -1;
+		AMP_DEBUG_ERR("db_init_rule","Can't add new rule.", NULL);
+		rule_release(rule, 1);
+		return AMP_FAIL;
 	}
 
-#endif
-	return 1;
+	return AMP_OK;
+}
+
+static void db_compile_macdef_cb(rh_elt_t *elt, void *tag)
+{
+	macdef_t *mac = (macdef_t *) elt->value;
+
+	(void) tag;
+
+	if((mac->steps == NULL) && (macdef_compile(mac) != AMP_OK))
+	{
+		AMP_DEBUG_WARN("db_compile_macdefs", "Macro will run uncompiled.", NULL);
+	}
+}
+
+/*
+ * Compile each macro of an instance not yet compiled, once the macros it
+ * may nest have all been added.
+ */
+static void db_compile_macdefs(vdb_inst_t *inst)
+{
+	rhht_foreach(&(inst->macdefs), db_compile_macdef_cb, NULL);
+}
+
+/*
+ * Open the persistent store, creating it if necessary, and load all of
+ * the objects it holds into the VDB. Until this is called nothing is
+ * persisted.
+ *
+ * name : Path prefix of the journal and snapshot files.
+ */
+int  db_read_objs(char *name)
+{
+	db_rec_list_t list;
+	uint8_t *snap = NULL;
+	uint8_t *jnl = NULL;
+	size_t jnl_valid, jnl_len;
+	int num[DB_REC_VAR + 1] = {0};
+	int fd;
+
+	CHKUSR(name, AMP_FAIL);
+
+	pthread_mutex_lock(&gDB.lock);
+	if(db_persisting())
+	{
+		pthread_mutex_unlock(&gDB.lock);
+		AMP_DEBUG_ERR("db_read_objs", "DB already open.", NULL);
+		return AMP_FAIL;
+	}
+
+	if((asprintf(&gDB.path, "%s.jnl", name) < 0)
+	   || (asprintf(&gDB.snap_path, "%s.snap", name) < 0)
+	   || (db_load(&list, &snap, &jnl, &jnl_valid, &jnl_len) != AMP_OK))
+	{
+		pthread_mutex_unlock(&gDB.lock);
+		AMP_DEBUG_ERR("db_read_objs", "Can't read DB %s.", name);
+		return AMP_SYSERR;
+	}
+
+	for(size_t i = 0; i < list.num; i++)
+	{
+		db_rec_t *rec = &(list.recs[i]);
+		db_rec_t *state = NULL;
+		blob_t data = { (uint8_t *) rec->data, rec->len, rec->len };
+		db_desc_t desc = { rec->id, rec->len };
+		int success = AMP_FAIL;
+
+		if((i + 1 < list.num) && (list.recs[i + 1].op == DB_OP_STATE))
+		{
+			state = &(list.recs[++i]);
+		}
+
+		switch(rec->type)
+		{
+			case DB_REC_CTRL:   success = vdb_db_init_ctrl(&data, desc);   break;
+			case DB_REC_MACDEF: success = vdb_db_init_macdef(&data, desc); break;
+			case DB_REC_RPTT:   success = vdb_db_init_rpttpl(&data, desc); break;
+			case DB_REC_VAR:    success = vdb_db_init_var(&data, desc);    break;
+			case DB_REC_RULE:   success = db_init_rule(&data, desc, state); break;
+			default:
+				break;
+		}
+
+		if(success == AMP_OK)
+		{
+			num[rec->type]++;
+		}
+		else
+		{
+			AMP_DEBUG_ERR("db_read_objs", "Unable to restore item %u.", rec->id);
+		}
+	}
+
+	AMP_DEBUG_ALWAYS("db_read_objs", "Added %d Controls from DB.", num[DB_REC_CTRL]);
+	AMP_DEBUG_ALWAYS("db_read_objs", "Added %d Macro Definitions from DB.", num[DB_REC_MACDEF]);
+	AMP_DEBUG_ALWAYS("db_read_objs", "Added %d Report Template Definitions from DB.", num[DB_REC_RPTT]);
+	AMP_DEBUG_ALWAYS("db_read_objs", "Added %d Rule Definitions from DB.", num[DB_REC_RULE]);
+	AMP_DEBUG_ALWAYS("db_read_objs", "Added %d Variable Definitions from DB.", num[DB_REC_VAR]);
+
+	db_compile_macdefs(gVDBInst);
+
+	gDB.next_id = list.next_id;
+	free(list.recs);
+	SRELEASE(snap);
+	SRELEASE(jnl);
+
+	/* Drop any torn tail so new records follow the last good one. */
+	if((fd = open(gDB.path, O_RDWR | O_CREAT | O_APPEND, 0644)) < 0)
+	{
+		pthread_mutex_unlock(&gDB.lock);
+		AMP_DEBUG_ERR("db_read_objs", "Can't open %s: %s", gDB.path, strerror(errno));
+		return AMP_SYSERR;
+	}
+	if(jnl_valid < jnl_len || jnl_valid == 0)
+	{
+		if((ftruncate(fd, jnl_valid) != 0)
+		   || ((jnl_valid == 0) && (db_write_file_hdr(fd, gDB.next_id) != AMP_OK)))
+		{
+			close(fd);
+			pthread_mutex_unlock(&gDB.lock);
+			AMP_DEBUG_ERR("db_read_objs", "Can't repair %s.", gDB.path);
+			return AMP_SYSERR;
+		}
+		jnl_valid = (jnl_valid == 0) ? sizeof(db_file_hdr_t) : jnl_valid;
+		fdatasync(fd);
+	}
+	gDB.fd = fd;
+	gDB.size = jnl_valid;
+	gDB.dirty = 0;
+	pthread_mutex_unlock(&gDB.lock);
+
+	return AMP_OK;
 }
 
 /*
- * This function writes an item and its associated descriptor into the SDR,
- * allocating space for each, and adding the SDR descriptor pointer to a
- * given SDR list.
+ * Append the serialized form of an object to the journal, assigning it
+ * a journal identifier the first time it is persisted.
  *
- * blob    : The serialized item to store in the SDR.
- * desc    : The db descriptor holding where this should live
- * list    : The SDR list holding the item descriptor (at *descrObj).
+ * blob    : The serialized item to store.
+ * desc    : The db descriptor of the item.
+ * type    : The kind of item being stored.
  */
-int  db_persist(blob_t *blob, db_desc_t *desc, void* list)
+int  db_persist(blob_t *blob, db_desc_t *desc, db_rec_type_e type)
 {
-#if 0
-	Sdr sdr = getIonsdr();
+	int success = AMP_OK;
 
 	CHKUSR(blob, AMP_FAIL);
 	CHKUSR(desc, AMP_FAIL);
 
-	/* Step 0: Sanity Checks. */
-	if (((desc->itemObj == 0) && (desc->itemSize != 0)) ||
-	   ((desc->itemObj != 0) && (desc->itemSize == 0)))
+	pthread_mutex_lock(&gDB.lock);
+	if(db_inst_persisting())
 	{
-		AMP_DEBUG_ERR("db_persist","bad params.",NULL);
-		return AMP_FAIL;
+		if(desc->itemId == 0)
+		{
+			desc->itemId = gDB.next_id++;
+		}
+		desc->itemSize = blob->length;
+		success = db_journal_append(desc->itemId, type, DB_OP_PUT, blob->value, blob->length);
+	}
+	pthread_mutex_unlock(&gDB.lock);
+
+	return success;
+}
+
+/*
+ * Write and commit everything persisted since the last call, taking a
+ * new snapshot if the journal has grown large. Callers batch as many
+ * updates as they can between calls.
+ */
+int  db_sync()
+{
+	int success = AMP_OK;
+
+	pthread_mutex_lock(&gDB.lock);
+	if(db_persisting())
+	{
+		success = db_journal_write();
+		if((success == AMP_OK) && gDB.dirty)
+		{
+			if(fdatasync(gDB.fd) != 0)
+			{
+				AMP_DEBUG_ERR("db_sync", "Journal sync failed: %s", strerror(errno));
+				success = AMP_SYSERR;
+			}
+			gDB.dirty = 0;
+		}
+		if((success == AMP_OK) && (gDB.size > DB_JOURNAL_COMPACT_SIZE))
+		{
+			success = db_compact();
+		}
 	}
+	pthread_mutex_unlock(&gDB.lock);
+
+	return success;
+}
 
+/*
+ * Write everything persisted so far and fold the journal into a new
+ * snapshot now, regardless of the journal size.
+ */
+int  db_snapshot()
+{
+	int success = AMP_OK;
 
-	/*
-	 * If the object is already in the SDR, remove it. We will
-	 * be writing over it, and we could have changed size since the
-	 * last time we persisted the object.
-	 */
-	if(desc->itemObj != 0)
-	{
-		db_forget(desc, list);
-	}
-
-	desc->itemSize = blob->length;
-
-	CHKUSR(sdr_begin_xn(sdr), AMP_FAIL);
-
-   /* Step 1: Allocate a descriptor object for this item in the SDR. */
-   if((desc->descObj = sdr_malloc(sdr, sizeof(db_desc_t))) == 0)
-   {
-	   sdr_cancel_xn(sdr);
-	   AMP_DEBUG_ERR("db_persist",
-			   	     "Can't allocate descriptor of size %d.",
-					 sizeof(db_desc_t));
-	   return AMP_SYSERR;
-   }
-
-   /* Step 2: Allocate space for the serialized rule in the SDR. */
-   if((desc->itemObj = sdr_malloc(sdr, desc->itemSize)) == 0)
-   {
-	   sdr_free(sdr, desc->descObj);
-	   sdr_cancel_xn(sdr);
-	   desc->descObj = 0;
-	   AMP_DEBUG_ERR("db_persist",
-			         "Unable to allocate Item in SDR. Size %d.",
-					 desc->itemSize);
-	   return AMP_SYSERR;
-   }
-
-   /* Step 3: Write the item to the SDR. */
-   sdr_write(sdr, desc->itemObj, (char *) blob->value, desc->itemSize);
-
-   /* Step 4: Write the item descriptor to the SDR. */
-   sdr_write(sdr, desc->descObj, (char *) desc, sizeof(db_desc_t));
-
-   /* Step 5: Save the descriptor in the AgentDB active rules list. */
-   if (sdr_list_insert_last(sdr, list, desc->descObj) == 0)
-   {
-	   db_forget(desc, list);
-
-	   sdr_cancel_xn(sdr);
-	   AMP_DEBUG_ERR("db_persist",
-			         "Unable to insert item Descr. in SDR.", NULL);
-	   return AMP_SYSERR;
-   }
-
-   if(sdr_end_xn(sdr))
-   {
-	   AMP_DEBUG_ERR("db_persist", "Can't persist db item.", NULL);
-	   return AMP_SYSERR;
-   }
+	pthread_mutex_lock(&gDB.lock);
+	if(db_persisting())
+	{
+		success = db_journal_write();
+		if(success == AMP_OK)
+		{
+			success = db_compact();
+		}
+	}
+	pthread_mutex_unlock(&gDB.lock);
 
-#endif
-   return AMP_OK;
+	return success;
 }
 
 int  db_persist_ctrl(void* item)
 {
 	int result;
 	ctrl_t *ctrl = (ctrl_t *) item;
-	blob_t *blob = ctrl_db_serialize(ctrl);
+	blob_t *blob;
 
+	if(!db_inst_persisting())
+	{
+		return AMP_OK;
+	}
+	blob = ctrl_db_serialize(ctrl);
 	CHKERR(blob);
-//	result = db_persist(blob, &(ctrl->desc), gDB.ctrls);
+	result = db_persist(blob, &(ctrl->desc), DB_REC_CTRL);
 	blob_release(blob, 1);
 	return result;
 }
@@ -264,10 +842,15 @@ int  db_persist_macdef(void* item)
 {
 	int result;
 	macdef_t *def = (macdef_t*) item;
-	blob_t *blob = macdef_serialize_wrapper(def);
+	blob_t *blob;
 
+	if(!db_inst_persisting())
+	{
+		return AMP_OK;
+	}
+	blob = macdef_serialize_wrapper(def);
 	CHKERR(blob);
-//	result = db_persist(blob, &(def->desc), gDB.macdefs);
+	result = db_persist(blob, &(def->desc), DB_REC_MACDEF);
 	blob_release(blob, 1);
 	return result;
 }
@@ -276,10 +859,15 @@ int  db_persist_rpttpl(void *item)
 {
 	int result;
 	rpttpl_t* rpttpl = (rpttpl_t*) item;
-	blob_t *blob = rpttpl_serialize_wrapper(rpttpl);
+	blob_t *blob;
 
+	if(!db_inst_persisting())
+	{
+		return AMP_OK;
+	}
+	blob = rpttpl_serialize_wrapper(rpttpl);
 	CHKERR(blob);
-//	result = db_persist(blob, &(rpttpl->desc), gDB.rpttpls);
+	result = db_persist(blob, &(rpttpl->desc), DB_REC_RPTT);
 	blob_release(blob, 1);
 	return result;
 }
@@ -288,93 +876,75 @@ int  db_persist_rule(void* item)
 {
 	int result;
 	rule_t *rule = (rule_t *) item;
-	blob_t *blob = rule_db_serialize_wrapper(rule);
+	blob_t *blob;
 
+	if(!db_inst_persisting())
+	{
+		return AMP_OK;
+	}
+	blob = rule_db_serialize_wrapper(rule);
 	CHKERR(blob);
-//	result = db_persist(blob, &(rule->desc), gDB.rules);
+	result = db_persist(blob, &(rule->desc), DB_REC_RULE);
 	blob_release(blob, 1);
 	return result;
 }
 
+/*
+ * Persist only the execution state of a rule which has already been
+ * persisted, as a fixed-size delta record.
+ */
+int  db_persist_rule_state(void* item)
+{
+	rule_t *rule = (rule_t *) item;
+	uint8_t state[DB_RULE_STATE_LEN];
+	int64_t eval_ms;
+	int result;
+
+	CHKUSR(rule, AMP_FAIL);
+	if(!db_inst_persisting())
+	{
+		return AMP_OK;
+	}
+	if(rule->desc.itemId == 0)
+	{
+		return db_persist_rule(rule);
+	}
+
+	eval_ms = OS_TimeGetTotalMilliseconds(rule->eval_at);
+	memcpy(state, &eval_ms, sizeof(eval_ms));
+	memcpy(state + 8, &(rule->num_eval), sizeof(uint64_t));
+	memcpy(state + 16, &(rule->num_fire), sizeof(uint64_t));
+	state[24] = rule->flags;
+	state[25] = rule->prio;
+
+	pthread_mutex_lock(&gDB.lock);
+	result = db_journal_append(rule->desc.itemId, DB_REC_RULE, DB_OP_STATE, state, sizeof(state));
+	pthread_mutex_unlock(&gDB.lock);
+	return result;
+}
+
 
 int  db_persist_var(void* item)
 {
 	int result;
 	var_t *var = (var_t *) item;
-	blob_t *blob = var_serialize_wrapper(var);
+	blob_t *blob;
 
+	if(!db_inst_persisting())
+	{
+		return AMP_OK;
+	}
+	blob = var_serialize_wrapper(var);
 	if(blob == NULL)
 	{
 		return AMP_FAIL;
 	}
-//	result = db_persist(blob, &(var->desc), gDB.vars);
+	result = db_persist(blob, &(var->desc), DB_REC_VAR);
 	blob_release(blob, 1);
 	return result;
 }
 
 
-
-/*
- * Initialize VDB list from a list in the SDR.
- */
-
-int vdb_obj_init(void* sdr_list, vdb_init_cb_fn init_cb)
-{
-#if 0
-	Object elt;
-	Object descObj;
-	db_desc_t cur_desc;
-	blob_t *data;
-	uint32_t num = 0;
-	Sdr sdr = getIonsdr();
-
-	CHKUSR(sdr_begin_xn(sdr), AMP_FAIL);
-
-	/* Step 1: Walk through report definitions. */
-	for (elt = sdr_list_first(sdr, sdr_list); elt;
-	    		elt = sdr_list_next(sdr, elt))
-	{
-
-		/* Step 1.1: Grab the descriptor. */
-	    descObj = sdr_list_data(sdr, elt);
-	    oK(sdr_read(sdr, (char *) &cur_desc, descObj, sizeof(cur_desc)));
-
-	    cur_desc.descObj = descObj;
-
-	    /* Step 1.2: Allocate space for the def. */
-	    if((data = blob_create(NULL, 0, cur_desc.itemSize)) == NULL)
-	    {
-	    	AMP_DEBUG_ERR("vdb_init","Can't allocate %d bytes.",
-	    					cur_desc.itemSize);
-	    }
-	    else
-	    {
-	    	/* Step 1.3: Grab the serialized rule */
-	    	oK(sdr_read(sdr, (char *) data->value, cur_desc.itemObj, cur_desc.itemSize));
-	    	data->length = cur_desc.itemSize;
-
-	    	if(init_cb(data, cur_desc) != AMP_OK)
-	    	{
-		    	AMP_DEBUG_ERR("vdb_init","Unable to insert new data item. Removing item.", NULL);
-		    	//db_forget(&cur_desc, sdr_list);
-	    	}
-	    	else
-	    	{
-	    		num++;
-	    	}
-
-	    	blob_release(data, 1);
-	    }
-	}
-	sdr_end_xn(sdr);
-
-	return num;
-#else
-	return 0;
-#endif
-}
-
-
 int vdb_db_init_ctrl(blob_t *data, db_desc_t desc)
 {
 	ctrl_t *ctrl = NULL;
@@ -389,7 +959,7 @@ int vdb_db_init_ctrl(blob_t *data, db_desc_t desc)
 
 	ctrl->desc = desc;
 
-	if(VDB_ADD_CTRL(ctrl, NULL) != RH_OK)
+	if(VDB_ADD_CTRL(ctrl, NULL) != AMP_OK)
 	{
 		AMP_DEBUG_ERR("vdb_db_init_cb_ctrl","Can't add new control.", NULL);
 		ctrl_release(ctrl, 1);
@@ -453,27 +1023,7 @@ int vdb_db_init_rpttpl(blob_t *data, db_desc_t desc)
 
 int vdb_db_init_rule(blob_t *data, db_desc_t desc)
 {
-	rule_t *rule = NULL;
-	int success;
-
-	CHKUSR(data, AMP_FAIL);
-
-	if((rule = rule_db_deserialize_raw(data, &success)) == NULL)
-	{
-		AMP_DEBUG_ERR("vdb_db_init_rule","Can't deserialize raw rule.", NULL);
-		return AMP_FAIL;
-	}
-
-	rule->desc = desc;
-
-	if(VDB_ADD_RULE(&(rule->id), rule) != RH_OK)
-	{
-		AMP_DEBUG_ERR("vdb_db_init_rule","Can't add new rule.", NULL);
-		rule_release(rule, 1);
-		return AMP_FAIL;
-	}
-
-	return AMP_OK;
+	return db_init_rule(data, desc, NULL);
 }
 
 
@@ -504,29 +1054,114 @@ int vdb_db_init_var(blob_t *data, db_desc_t desc)
 }
 
 
+/*
+ * Create the tables of one agent instance.
+ */
+int vdb_inst_init(vdb_inst_t *inst)
+{
+	int success = AMP_FAIL;
+
+	CHKUSR(inst, AMP_FAIL);
+	memset(inst, 0, sizeof(vdb_inst_t));
+
+	success = timeq_init(&(inst->ctrls), DB_MAX_CTRL, ctrl_cb_del_fn);
+	CHKUSR(success == AMP_OK, success);
+
+	inst->macdefs = rhht_create(DB_MAX_MACDEF, ari_cb_comp_fn, ari_cb_hash, macdef_cb_ht_del_fn, &success);
+	CHKUSR(success == AMP_OK, success);
+
+	inst->rpttpls = rhht_create(DB_MAX_RPTT, ari_cb_comp_fn, ari_cb_hash, rpttpl_cb_ht_del_fn, &success);
+	CHKUSR(success == AMP_OK, success);
+
+	inst->rules = rhht_create(DB_MAX_SBR, ari_cb_comp_fn, ari_cb_hash, rule_cb_ht_del_fn, &success);
+	CHKUSR(success == AMP_OK, success);
+
+	inst->vars = rhht_create(DB_MAX_VAR, ari_cb_comp_fn, ari_cb_hash, var_cb_ht_del_fn, &success);
+	CHKUSR(success == AMP_OK, success);
+
+	inst->ctrl_classes = rhht_create(DB_MAX_CTRL_CLASS, ari_cb_comp_no_parm_fn, ari_cb_hash, ctrldef_class_cb_ht_del_fn, &success);
+	CHKUSR(success == AMP_OK, success);
+
+	return AMP_OK;
+}
+
+void vdb_inst_destroy(vdb_inst_t *inst)
+{
+	CHKVOID(inst);
+
+	timeq_destroy(&(inst->ctrls));
+	rhht_release(&(inst->macdefs), 0);
+	rhht_release(&(inst->rpttpls), 0);
+	rhht_release(&(inst->rules), 0);
+	rhht_release(&(inst->vars), 0);
+	rhht_release(&(inst->ctrl_classes), 0);
+}
+
+/*
+ * Make an instance the one this thread uses and return the one it used
+ * before, so that callers can restore it. NULL selects &gVDB.inst.
+ */
+vdb_inst_t *vdb_inst_select(vdb_inst_t *inst)
+{
+	vdb_inst_t *prev = gVDBInst;
+
+	gVDBInst = (inst != NULL) ? inst : &(gVDB.inst);
+	return prev;
+}
+
+/*
+ * Find an object by key in one table of this thread's instance. Objects
+ * defined by ADMs are held in &gVDB.adm only, so that is searched next.
+ *
+ * offset : The offset of the table in vdb_inst_t.
+ */
+void *vdb_inst_findkey(size_t offset, void *key)
+{
+	void *value = rhht_retrieve_key((rhht_t *)((uint8_t *)gVDBInst + offset), key);
+
+	if(value == NULL)
+	{
+		value = rhht_retrieve_key((rhht_t *)((uint8_t *)&(gVDB.adm) + offset), key);
+	}
+	return value;
+}
+
+
 void db_destroy()
 {
+	db_sync();
+	pthread_mutex_lock(&gDB.lock);
+	if(db_persisting())
+	{
+		close(gDB.fd);
+		gDB.fd = -1;
+	}
+	free(gDB.path);
+	free(gDB.snap_path);
+	free(gDB.buf);
+	gDB.path = NULL;
+	gDB.snap_path = NULL;
+	gDB.buf = NULL;
+	gDB.buf_len = gDB.buf_cap = 0;
+	pthread_mutex_unlock(&gDB.lock);
+
 	rhht_release(&(gVDB.adm_atomics), 0);
 	rhht_release(&(gVDB.adm_edds), 0);
 	rhht_release(&(gVDB.adm_ctrl_defs), 0);
 	rhht_release(&(gVDB.adm_ops), 0);
 	rhht_release(&(gVDB.adm_tblts), 0);
-	vec_release(&(gVDB.ctrls), 0);
-	rhht_release(&(gVDB.macdefs), 0);
-	rhht_release(&(gVDB.rpttpls), 0);
-	rhht_release(&(gVDB.rules), 0);
-	rhht_release(&(gVDB.vars), 0);
+	vdb_inst_destroy(&(gVDB.inst));
+	vdb_inst_destroy(&(gVDB.adm));
 
-	vec_release(&(gVDB.issuers), 0);
-	vec_release(&(gVDB.nicknames), 0);
-	vec_release(&(gVDB.tags), 0);
+	reg_release(&(gVDB.issuers));
+	reg_release(&(gVDB.nicknames));
+	reg_release(&(gVDB.tags));
 }
 
 
 int db_init(char *name, void (*adm_init_cb)()) 
 {
 	int success = AMP_FAIL;
-	int num;
 	memset(&gVDB, 0, sizeof(gVDB));
 
 	gVDB.adm_atomics = rhht_create(DB_MAX_ATOMIC, ari_cb_comp_no_parm_fn, ari_cb_hash, edd_cb_ht_del, &success);
@@ -535,43 +1170,32 @@ int db_init(char *name, void (*adm_init_cb)())
 	gVDB.adm_edds = rhht_create(DB_MAX_ATOMIC, ari_cb_comp_no_parm_fn, ari_cb_hash, edd_cb_ht_del, &success);
 	CHKUSR(success == AMP_OK, success);
 
-	gVDB.ctrls =  vec_create(DB_MAX_CTRL, ctrl_cb_del_fn, ctrl_cb_comp_fn, ctrl_cb_copy_fn, 0, &success);
-	CHKUSR(success == AMP_OK, success);
-
 	gVDB.adm_ctrl_defs = rhht_create(DB_MAX_CTRLDEF, ari_cb_comp_no_parm_fn, ari_cb_hash, ctrldef_del_fn, &success);
 	CHKUSR(success == AMP_OK, success);
 
-	gVDB.macdefs = rhht_create(DB_MAX_MACDEF, ari_cb_comp_fn, ari_cb_hash, macdef_cb_ht_del_fn, &success);
-	CHKUSR(success == AMP_OK, success);
-
 	gVDB.adm_ops = rhht_create(DB_MAX_OP, ari_cb_comp_no_parm_fn, ari_cb_hash, op_cb_ht_del_fn, &success);
 	CHKUSR(success == AMP_OK, success);
 
-	gVDB.rpttpls = rhht_create(DB_MAX_RPTT, ari_cb_comp_fn, ari_cb_hash, rpttpl_cb_ht_del_fn, &success);
-	CHKUSR(success == AMP_OK, success);
-
-	gVDB.rules = rhht_create(DB_MAX_SBR, ari_cb_comp_fn, ari_cb_hash, rule_cb_ht_del_fn, &success);
+	gVDB.adm_tblts = rhht_create(DB_MAX_TBLT, ari_cb_comp_no_parm_fn, ari_cb_hash, tblt_cb_ht_del_fn, &success);
 	CHKUSR(success == AMP_OK, success);
 
-	gVDB.adm_tblts = rhht_create(DB_MAX_TBLT, ari_cb_comp_no_parm_fn, ari_cb_hash, tblt_cb_ht_del_fn, &success);
+	success = vdb_inst_init(&(gVDB.adm));
 	CHKUSR(success == AMP_OK, success);
 
-	gVDB.vars = rhht_create(DB_MAX_VAR, ari_cb_comp_fn, ari_cb_hash, var_cb_ht_del_fn, &success);
+	success = vdb_inst_init(&(gVDB.inst));
 	CHKUSR(success == AMP_OK, success);
 
-	gVDB.nicknames = vec_create(DB_MAX_NN, vec_simple_del, vec_uvast_comp, vec_uvast_copy, 0, &success);
+	success = reg_init(&(gVDB.nicknames), REG_UVAST, DB_MAX_NN);
 	CHKUSR(success == AMP_OK, success);
 
-	gVDB.issuers = vec_create(DB_MAX_NN,
 #if AMP_VERSION < 7
-		vec_simple_del, vec_uvast_comp, vec_uvast_copy,
+	success = reg_init(&(gVDB.issuers), REG_UVAST, DB_MAX_NN);
 #else
-		vec_blob_del, vec_blob_comp, vec_blob_copy,
+	success = reg_init(&(gVDB.issuers), REG_BLOB, DB_MAX_NN);
 #endif
-		0, &success);
 	CHKUSR(success == AMP_OK, success);
 
-	gVDB.tags = vec_create(DB_MAX_NN, vec_blob_del, vec_blob_comp, vec_blob_copy, 0, &success);
+	success = reg_init(&(gVDB.tags), REG_BLOB, DB_MAX_NN);
 	CHKUSR(success == AMP_OK, success);
 
 	adm_common_init();
@@ -583,26 +1207,13 @@ int db_init(char *name, void (*adm_init_cb)())
 	{
 		adm_init_cb();
 	}
+	db_compile_macdefs(&(gVDB.adm));
 
 
-	success = db_read_objs(name);
-
-#if 0
-	num = vdb_obj_init(gDB.ctrls, vdb_db_init_ctrl);
-	AMP_DEBUG_ALWAYS("vdb_init", "Added %d Controls from DB.", num);
-
-	num = vdb_obj_init(gDB.macdefs,  vdb_db_init_macdef);
-	AMP_DEBUG_ALWAYS("vdb_init", "Added %d Macro Definitions from DB.", num);
-
-	num = vdb_obj_init(gDB.rpttpls, vdb_db_init_rpttpl);
-	AMP_DEBUG_ALWAYS("vdb_init", "Added %d Report Template Definitions from DB.", num);
-
-	num = vdb_obj_init(gDB.rules,   vdb_db_init_rule);
-	AMP_DEBUG_ALWAYS("vdb_init", "Added %d Rule Definitions from DB.", num);
-
-	num = vdb_obj_init(gDB.vars,    vdb_db_init_var);
-	AMP_DEBUG_ALWAYS("vdb_init", "Added %d Variable Definitions from DB.", num);
-#endif
+	/* The persistent store is opened separately by db_read_objs(), once
+	 * the application has registered all of its ADMs.
+	 */
+	success = AMP_OK;
 
 	return success;
 }
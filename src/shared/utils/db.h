@@ -41,9 +41,13 @@
 #ifndef DB_H_
 #define DB_H_
 
+#include <pthread.h>
+#include <stddef.h>
 #include "shared/platform.h"
 #include "rhht.h"
+#include "timeq.h"
 #include "vector.h"
+#include "reg.h"
 #include "nm_types.h"
 
 
@@ -67,6 +71,7 @@ extern "C" {
 #define DB_MAX_TBLT 50
 #define DB_MAX_TBR  50
 #define DB_MAX_VAR  50
+#define DB_MAX_CTRL_CLASS 50
 #define DB_MAX_NN   100
 #define DB_MAX_ISS  20
 #define DB_MAX_TAG  25
@@ -81,70 +86,74 @@ extern "C" {
 #define VDB_ADD_EDD(key, value)     rhht_insert(&(gVDB.adm_edds),  key, value, NULL)
 #define VDB_ADD_CONST(key, value)   rhht_insert(&(gVDB.adm_atomics),  key, value, NULL)
 #define VDB_ADD_LIT(key, value)     rhht_insert(&(gVDB.adm_atomics),  key, value, NULL)
-#define VDB_ADD_CTRL(value, idx)    vec_insert(&(gVDB.ctrls),         value, idx)
+#define VDB_ADD_CTRL(value, idx)    timeq_push(&(gVDBInst->ctrls), (value)->start, value, idx)
 #define VDB_ADD_CTRLDEF(key, value) rhht_insert(&(gVDB.adm_ctrl_defs),key, value, NULL)
-#define VDB_ADD_MACDEF(key, value)  rhht_insert(&(gVDB.macdefs),      key, value, NULL)
+#define VDB_ADD_MACDEF(key, value)  rhht_insert(&(gVDBInst->macdefs),      key, value, NULL)
 #define VDB_ADD_OP(key, value)      rhht_insert(&(gVDB.adm_ops),      key, value, NULL)
-#define VDB_ADD_RPTT(key, value)    rhht_insert(&(gVDB.rpttpls),      key, value, NULL)
-#define VDB_ADD_RULE(key, value)    rhht_insert(&(gVDB.rules),        key, value, NULL)
+#define VDB_ADD_RPTT(key, value)    rhht_insert(&(gVDBInst->rpttpls),      key, value, NULL)
+#define VDB_ADD_RULE(key, value)    rhht_insert(&(gVDBInst->rules),        key, value, NULL)
 #define VDB_ADD_TBLT(key, value)    rhht_insert(&(gVDB.adm_tblts),    key, value, NULL)
-#define VDB_ADD_VAR(key, value)     rhht_insert(&(gVDB.vars),         key, value, NULL)
-#define VDB_ADD_NN(value, idx)      vec_uvast_add(&(gVDB.nicknames),  value, idx)
+#define VDB_ADD_VAR(key, value)     rhht_insert(&(gVDBInst->vars),         key, value, NULL)
+#define VDB_ADD_ADM_MACDEF(key, value) rhht_insert(&(gVDB.adm.macdefs), key, value, NULL)
+#define VDB_ADD_ADM_RPTT(key, value)   rhht_insert(&(gVDB.adm.rpttpls), key, value, NULL)
+#define VDB_ADD_ADM_VAR(key, value)    rhht_insert(&(gVDB.adm.vars),    key, value, NULL)
+#define VDB_ADD_NN(value, idx)      reg_add_uvast(&(gVDB.nicknames),  value, idx)
 #if AMP_VERSION < 7
-#define VDB_ADD_ISS(value, idx)     vec_uvast_add(&(gVDB.issuers),    value, idx)
+#define VDB_ADD_ISS(value, idx)     reg_add_uvast(&(gVDB.issuers),    value, idx)
 #else
-#define VDB_ADD_ISS(value, idx)     vec_blob_add(&(gVDB.issuers),    value, idx)
+#define VDB_ADD_ISS(value, idx)     reg_add_blob(&(gVDB.issuers),     value, idx)
 #endif
-#define VDB_ADD_TAG(value, idx)     vec_blob_add(&(gVDB.tags),        value, idx)
+#define VDB_ADD_TAG(value, idx)     reg_add_blob(&(gVDB.tags),        value, idx)
 
 #define VDB_FINDKEY_EDD(key)     rhht_retrieve_key(&(gVDB.adm_edds),  key)
 #define VDB_FINDKEY_CONST(key)   rhht_retrieve_key(&(gVDB.adm_atomics),  key)
 #define VDB_FINDKEY_LIT(key)     rhht_retrieve_key(&(gVDB.adm_atomics),  key)
 #define VDB_FINDKEY_CTRLDEF(key) rhht_retrieve_key(&(gVDB.adm_ctrl_defs),key)
-#define VDB_FINDKEY_MACDEF(key)  rhht_retrieve_key(&(gVDB.macdefs),      key)
+#define VDB_FINDKEY_MACDEF(key)  vdb_inst_findkey(offsetof(vdb_inst_t, macdefs), key)
 #define VDB_FINDKEY_OP(key)      rhht_retrieve_key(&(gVDB.adm_ops),      key)
-#define VDB_FINDKEY_RPTT(key)    rhht_retrieve_key(&(gVDB.rpttpls),      key)
-#define VDB_FINDKEY_RULE(key)    rhht_retrieve_key(&(gVDB.rules),        key)
+#define VDB_FINDKEY_RPTT(key)    vdb_inst_findkey(offsetof(vdb_inst_t, rpttpls), key)
+#define VDB_FINDKEY_RULE(key)    rhht_retrieve_key(&(gVDBInst->rules),        key)
 #define VDB_FINDKEY_TBLT(key)    rhht_retrieve_key(&(gVDB.adm_tblts),    key)
-#define VDB_FINDKEY_VAR(key)     rhht_retrieve_key(&(gVDB.vars),         key)
+#define VDB_FINDKEY_VAR(key)     vdb_inst_findkey(offsetof(vdb_inst_t, vars), key)
+#define VDB_FINDKEY_ADM_VAR(key) rhht_retrieve_key(&(gVDB.adm.vars), key)
 
 #define VDB_FINDIDX_EDD(idx)     rhht_retrieve_idx(&(gVDB.adm_edds),   idx)
 #define VDB_FINDIDX_CONST(idx)   rhht_retrieve_idx(&(gVDB.adm_atomics),   idx)
 #define VDB_FINDIDX_LIT(idx)     rhht_retrieve_idx(&(gVDB.adm_atomics),   idx)
-#define VDB_FINDIDX_CTRL(idx, s) vec_at(&(gVDB.ctrls),     idx, s)
+#define VDB_FINDIDX_CTRL(idx)    timeq_at(&(gVDBInst->ctrls),         idx)
 #define VDB_FINDIDX_CTRLDEF(idx) rhht_retrieve_idx(&(gVDB.adm_ctrl_defs), idx)
-#define VDB_FINDIDX_MACDEF(idx)  rhht_retrieve_idx(&(gVDB.macdefs),       idx)
+#define VDB_FINDIDX_MACDEF(idx)  rhht_retrieve_idx(&(gVDBInst->macdefs),       idx)
 #define VDB_FINDIDX_OP(idx)      rhht_retrieve_idx(&(gVDB.adm_ops),       idx)
-#define VDB_FINDIDX_RPTT(idx)    rhht_retrieve_idx(&(gVDB.rpttpls),       idx)
-#define VDB_FINDIDX_RULE(idx)    rhht_retrieve_idx(&(gVDB.rules),         idx)
+#define VDB_FINDIDX_RPTT(idx)    rhht_retrieve_idx(&(gVDBInst->rpttpls),       idx)
+#define VDB_FINDIDX_RULE(idx)    rhht_retrieve_idx(&(gVDBInst->rules),         idx)
 #define VDB_FINDIDX_TBLT(idx)    rhht_retrieve_idx(&(gVDB.adm_tblts),     idx)
-#define VDB_FINDIDX_VAR(idx)     rhht_retrieve_idx(&(gVDB.vars),          idx)
-#define VDB_FINDIDX_NN(idx)    vec_at(&gVDB.nicknames, idx)
-#define VDB_FINDIDX_ISS(idx)   vec_at(&gVDB.issuers,   idx)
-#define VDB_FINDIDX_TAG(idx)   vec_at(&gVDB.tags,      idx)
+#define VDB_FINDIDX_VAR(idx)     rhht_retrieve_idx(&(gVDBInst->vars),          idx)
+#define VDB_FINDIDX_NN(idx)    reg_at(&gVDB.nicknames, idx)
+#define VDB_FINDIDX_ISS(idx)   reg_at(&gVDB.issuers,   idx)
+#define VDB_FINDIDX_TAG(idx)   reg_at(&gVDB.tags,      idx)
 
 #define VDB_DELKEY_EDD(key)     rhht_del_key(&(gVDB.adm_edds),  key)
 #define VDB_DELKEY_CONST(key)   rhht_del_key(&(gVDB.adm_atomics),  key)
 #define VDB_DELKEY_LIT(key)     rhht_del_key(&(gVDB.adm_atomics),  key)
 #define VDB_DELKEY_CTRLDEF(key) rhht_del_key(&(gVDB.adm_ctrl_defs),key)
-#define VDB_DELKEY_MACDEF(key)  rhht_del_key(&(gVDB.macdefs),       key)
+#define VDB_DELKEY_MACDEF(key)  rhht_del_key(&(gVDBInst->macdefs),       key)
 #define VDB_DELKEY_OP(key)      rhht_del_key(&(gVDB.adm_ops),      key)
-#define VDB_DELKEY_RPTT(key)    rhht_del_key(&(gVDB.rpttpls),      key)
-#define VDB_DELKEY_RULE(key)    rhht_del_key(&(gVDB.rules),        key)
+#define VDB_DELKEY_RPTT(key)    rhht_del_key(&(gVDBInst->rpttpls),      key)
+#define VDB_DELKEY_RULE(key)    rhht_del_key(&(gVDBInst->rules),        key)
 #define VDB_DELKEY_TBLT(key)    rhht_del_key(&(gVDB.adm_tblts),    key)
-#define VDB_DELKEY_VAR(key)     rhht_del_key(&(gVDB.vars),         key)
+#define VDB_DELKEY_VAR(key)     rhht_del_key(&(gVDBInst->vars),         key)
 
 #define VDB_DELIDX_EDD(idx)     rhht_del_idx(&(gVDB.adm_edds),   idx)
 #define VDB_DELIDX_CONST(idx)   rhht_del_idx(&(gVDB.adm_atomics),   idx)
 #define VDB_DELIDX_LIT(idx)     rhht_del_idx(&(gVDB.adm_atomics),   idx)
-#define VDB_DELIDX_CTRL(idx)    vec_del_idx(&(gVDB.ctrls),          idx)
+#define VDB_DELIDX_CTRL(idx)    ctrl_cb_del_fn(timeq_remove(&(gVDBInst->ctrls), idx))
 #define VDB_DELIDX_CTRLDEF(idx) rhht_del_idx(&(gVDB.adm_ctrl_defs), idx)
-#define VDB_DELIDX_MACDEF(idx)  rhht_del_idx(&(gVDB.macdefs),       idx)
+#define VDB_DELIDX_MACDEF(idx)  rhht_del_idx(&(gVDBInst->macdefs),       idx)
 #define VDB_DELIDX_OP(idx)      rhht_del_idx(&(gVDB.adm_ops),       idx)
-#define VDB_DELIDX_RPTT(idx)    rhht_del_idx(&(gVDB.rpttpls),       idx)
-#define VDB_DELIDX_RULE(idx)    rhht_del_idx(&(gVDB.rules),         idx)
+#define VDB_DELIDX_RPTT(idx)    rhht_del_idx(&(gVDBInst->rpttpls),       idx)
+#define VDB_DELIDX_RULE(idx)    rhht_del_idx(&(gVDBInst->rules),         idx)
 #define VDB_DELIDX_TBLT(idx)    rhht_del_idx(&(gVDB.adm_tblts),     idx)
-#define VDB_DELIDX_VAR(idx)     rhht_del_idx(&(gVDB.vars),          idx)
+#define VDB_DELIDX_VAR(idx)     rhht_del_idx(&(gVDBInst->vars),          idx)
 /*
  * +--------------------------------------------------------------------------+
  * |							  DATA TYPES  								  +
@@ -153,80 +162,126 @@ extern "C" {
 
 
 /*
- * TODO: This description needs to be updated.
+ * The persistent store is an append-only journal paired with a snapshot.
  *
- * This structure implements an SDR database which keeps a list
- * of all AMM information that must be persisted across a reset.
+ * Every persisted object is given a journal identifier, kept in its
+ * db_desc_t. Creating or replacing an object appends a PUT record holding
+ * its serialized form, deleting it appends a DEL record, and rule execution
+ * state (next evaluation time and counters) is appended as a small STATE
+ * record rather than re-serializing the whole rule.
  *
- * Each object in the database represents an sdr_list. Each list is populated
- * with a series of pointers to "descriptor" objects.  Each descriptor object
- * captures meta-data associated with the associated AMP object and a
- * pointer to that object. AMM Objects are stored in the SDR in their
- * message-serialized form as that comprises the most space-efficient
- * representation of the object.
+ * Records are buffered in memory and written with a single fdatasync()
+ * per db_sync() call, so many updates share one commit. When the journal
+ * grows past DB_JOURNAL_COMPACT_SIZE it is folded into a new snapshot
+ * holding only the live objects, and the journal is truncated.
+ * db_snapshot() does the same on demand.
  *
- * On startup, AMM object types are deserialized and copied into
- * associated VDB data stores.
+ * On startup, db_read_objs() loads the snapshot and journal, keeps the
+ * latest record of each live object, and deserializes each into the VDB.
  *
- * For example, the tbrs Object in the database is an sdr_list. Each
- * item in the tbrs list is an Object which points to a
- * db_desc_t object.  This descriptor object captures information
- * such as the execution state of the TBR. One of the entries of the
- * db_desc_t object is an Object pointer to the serialized
- * TBR in the SDR.  On system startup, the application will grab the descriptor
- * object and use it to find the serialized TBR. The rule will be de-serialized
- * into a new tbr_t structure.  The meta-data associated with the rule will be
- * populated by additional meta-data in the rule's descriptor object.
- *
- * All entities in the DB operate in this way.
+ * +--------+--------+--------+--------+--------+--------+---------+
+ * | Length |  CRC   |   ID   |  Type  |   Op   | Unused | Payload |
+ * | [U32]  | [U32]  | [U32]  | [BYTE] | [BYTE] | [U16]  |         |
+ * +--------+--------+--------+--------+--------+--------+---------+
  */
 
+/** Journal size that triggers a new snapshot. */
+#define DB_JOURNAL_COMPACT_SIZE (4 * 1024 * 1024)
+/** Bytes of records buffered before writing to the journal file. */
+#define DB_JOURNAL_BUF_SIZE (64 * 1024)
+
+/** Type of object held by a journal record. */
+typedef enum
+{
+	DB_REC_CTRL = 1,
+	DB_REC_MACDEF,
+	DB_REC_RPTT,
+	DB_REC_RULE,
+	DB_REC_VAR,
+} db_rec_type_e;
+
+/** Operation recorded by a journal record. */
+typedef enum
+{
+	DB_OP_PUT = 1, /**> Full serialized object. */
+	DB_OP_DEL,     /**> Object removed. */
+	DB_OP_STATE,   /**> Rule execution state only. */
+} db_rec_op_e;
+
+/*
+ * State of the persistent store. The journal is closed (fd < 0) until
+ * db_read_objs() is called, and persisting is a no-op while closed.
+ */
 typedef struct
 {
-  //Object  ctrls;
-  //Object  macdefs;
-  //Object  rpttpls;
-  //Object  rules;
-  //Object  vars;
-  //Object  descObj;  /**> The pointer to the store object in the SDR. */
+	pthread_mutex_t lock; /**> Serializes journal access.              */
+	int      fd;          /**> Open journal file, -1 if not persisting. */
+	char    *path;        /**> Journal file name.                       */
+	char    *snap_path;   /**> Snapshot file name.                      */
+	uint32_t next_id;     /**> Next journal identifier to assign.       */
+	size_t   size;        /**> Bytes written to the journal file.       */
+	int      dirty;       /**> Data written since the last fdatasync.  */
+
+	uint8_t *buf;         /**> Records not yet written to the file.     */
+	size_t   buf_len;
+	size_t   buf_cap;
 } db_store_t;
 
 
+/*
+ * The part of the "volatile" database configured by managers, which
+ * belongs to one agent instance. A process normally has only the instance
+ * held in gVDB, but may host more agents each with its own instance.
+ */
+typedef struct
+{
+	timeq_t ctrls;        /**> Deferred controls, by start time. */
+	rhht_t macdefs;
+	rhht_t rpttpls;
+	rhht_t rules;
+	rhht_t vars;
+	rhht_t ctrl_classes;  /**> Output class of ADM controls set by this
+	                           instance, by control ARI. */
+} vdb_inst_t;
+
 /*
  * This structure captures the "volatile" database, which is the set of
  * information relating to configured items kept in the agent's memory.
+ * ADM definitions are read-only once initialized and shared by all agent
+ * instances in the process.
  */
 
 typedef struct
 {
 	rhht_t adm_atomics;   /**> Set by ADM support only. */
 	rhht_t adm_edds;      /**> Set by ADM support only. */
-	vector_t ctrls;
 	rhht_t adm_ctrl_defs; /**> Set by ADM support only. */
-	rhht_t macdefs;
 	rhht_t adm_ops;       /**> Set by ADM support only. */
-	rhht_t rpttpls;
-	rhht_t rules;
 	rhht_t adm_tblts;     /**> Set by ADM support only. */
-	rhht_t vars;
 
-	vector_t nicknames;
-	vector_t issuers;
-	vector_t tags;
+	/** Macros, report templates, and variables defined by ADMs. These
+	 * are read-only once initialized, and are found by every instance
+	 * after its own objects.
+	 */
+	vdb_inst_t adm;
+
+	/** The process's own instance. */
+	vdb_inst_t inst;
+
+	reg_t nicknames;      /**> Registered ARI nicknames. */
+	reg_t issuers;        /**> Registered ARI issuers. */
+	reg_t tags;           /**> Registered ARI tags. */
 } vdb_store_t;
 
 
 /**
- * This is a generic structure used to capture AMM objects stored in
- * the ION SDR.
+ * This is a generic structure used to capture where an AMM object is
+ * kept in the persistent store.
  */
 typedef struct
 {
-  //Object itemObj;     /**> Serialized object in an SDR. */
-	uint32_t itemSize;  /**> Size of object in itemObj.   */
-
-    /* Below is not kept in the SDR. */
-  //Object descObj;     /**> This descriptor in SDR.      */
+	uint32_t itemId;    /**> Journal identifier, 0 if not persisted. */
+	uint32_t itemSize;  /**> Size of the last persisted form.       */
 } db_desc_t;
 
 
@@ -237,6 +292,11 @@ typedef int     (*vdb_init_cb_fn)(blob_t *data, db_desc_t desc);
 extern vdb_store_t gVDB;
 extern db_store_t  gDB;
 
+/** The agent instance used by this thread, &gVDB.inst unless changed
+ * by vdb_inst_select().
+ */
+extern __thread vdb_inst_t *gVDBInst;
+
 
 /*
  * +--------------------------------------------------------------------------+
@@ -245,24 +305,31 @@ extern db_store_t  gDB;
  */
 
 
-int  db_forget(db_desc_t *desc, void* list);
+int  db_forget(db_desc_t *desc);
 
-int  db_persist(blob_t *blob, db_desc_t *desc, void* list);
+int  db_persist(blob_t *blob, db_desc_t *desc, db_rec_type_e type);
 
 int  db_persist_ctrl(void* item);
 int  db_persist_macdef(void* item);
 int  db_persist_rpttpl(void* item);
 int  db_persist_rule(void* item);
+int  db_persist_rule_state(void* item);
 int  db_persist_var(void* item);
 
 int  db_read_objs(char *name);
 
+int  db_sync();
+int  db_snapshot();
+
 void db_destroy();
 
 int db_init(char *name, void (*adm_init_cb)());
 
+int  vdb_inst_init(vdb_inst_t *inst);
+void vdb_inst_destroy(vdb_inst_t *inst);
+vdb_inst_t *vdb_inst_select(vdb_inst_t *inst);
+void *vdb_inst_findkey(size_t offset, void *key);
 
-//int vdb_obj_init(Object sdr_list, vdb_init_cb_fn init_cb);
 
 int vdb_db_init_ctrl(blob_t *data, db_desc_t desc);
 
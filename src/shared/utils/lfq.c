@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2023 The Johns Hopkins University Applied Physics
+ * Laboratory LLC.
+ *
+ * This file is part of the Delay-Tolerant Networking Management
+ * Architecture (DTNMA) Tools package.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stdint.h>
+#include "lfq.h"
+#include "debug.h"
+#include "utils.h"
+
+int lfq_init(lfq_t *q, size_t capacity)
+{
+  size_t count = 2;
+  size_t i;
+
+  CHKUSR(q, AMP_FAIL);
+  while (count < capacity)
+  {
+    count <<= 1;
+  }
+
+  q->slots = STAKE(count * sizeof(lfq_slot_t));
+  if (q->slots == NULL)
+  {
+    AMP_DEBUG_ERR("lfq_init", "Cannot allocate %d slots.", count);
+    return AMP_SYSERR;
+  }
+  for (i = 0; i < count; i++)
+  {
+    atomic_init(&(q->slots[i].seq), i);
+    q->slots[i].value = NULL;
+  }
+  q->mask = count - 1;
+  atomic_init(&(q->head), 0);
+  atomic_init(&(q->tail), 0);
+
+  return AMP_OK;
+}
+
+void lfq_destroy(lfq_t *q)
+{
+  CHKVOID(q);
+  SRELEASE(q->slots);
+  q->slots = NULL;
+  q->mask = 0;
+}
+
+bool lfq_push(lfq_t *q, void *value)
+{
+  lfq_slot_t *slot;
+  size_t pos = atomic_load_explicit(&(q->head), memory_order_relaxed);
+
+  while (true)
+  {
+    slot = &(q->slots[pos & q->mask]);
+    size_t seq = atomic_load_explicit(&(slot->seq), memory_order_acquire);
+    intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+    if (diff == 0)
+    {
+      // Slot is free for this position, try to claim it
+      if (atomic_compare_exchange_weak_explicit(&(q->head), &pos, pos + 1,
+                                                memory_order_relaxed, memory_order_relaxed))
+      {
+        break;
+      }
+    }
+    else if (diff < 0)
+    {
+      // Slot still holds a value from the previous lap
+      return false;
+    }
+    else
+    {
+      pos = atomic_load_explicit(&(q->head), memory_order_relaxed);
+    }
+  }
+
+  slot->value = value;
+  atomic_store_explicit(&(slot->seq), pos + 1, memory_order_release);
+  return true;
+}
+
+void *lfq_pop(lfq_t *q)
+{
+  lfq_slot_t *slot;
+  void *value;
+  size_t pos = atomic_load_explicit(&(q->tail), memory_order_relaxed);
+
+  while (true)
+  {
+    slot = &(q->slots[pos & q->mask]);
+    size_t seq = atomic_load_explicit(&(slot->seq), memory_order_acquire);
+    intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+
+    if (diff == 0)
+    {
+      if (atomic_compare_exchange_weak_explicit(&(q->tail), &pos, pos + 1,
+                                                memory_order_relaxed, memory_order_relaxed))
+      {
+        break;
+      }
+    }
+    else if (diff < 0)
+    {
+      // Nothing has been pushed to this slot yet
+      return NULL;
+    }
+    else
+    {
+      pos = atomic_load_explicit(&(q->tail), memory_order_relaxed);
+    }
+  }
+
+  value = slot->value;
+  slot->value = NULL;
+  atomic_store_explicit(&(slot->seq), pos + q->mask + 1, memory_order_release);
+  return value;
+}
+
+size_t lfq_size(lfq_t *q)
+{
+  size_t head = atomic_load_explicit(&(q->head), memory_order_relaxed);
+  size_t tail = atomic_load_explicit(&(q->tail), memory_order_relaxed);
+  return (head > tail) ? (head - tail) : 0;
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2023 The Johns Hopkins University Applied Physics
+ * Laboratory LLC.
+ *
+ * This file is part of the Delay-Tolerant Networking Management
+ * Architecture (DTNMA) Tools package.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SRC_SHARED_UTILS_LFQ_H_
+#define SRC_SHARED_UTILS_LFQ_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** One slot of a lock-free queue.
+ * The sequence number tells producers and the consumer whose turn it is
+ * to use the slot.
+ */
+typedef struct {
+  atomic_size_t seq;
+  void *value;
+} lfq_slot_t;
+
+/** A bounded, lock-free, multi-producer queue of opaque pointers.
+ * This follows the D. Vyukov bounded queue design: each slot carries a
+ * sequence number so that pushes and pops never take a lock and never
+ * block. A full queue causes lfq_push() to fail rather than wait.
+ */
+typedef struct {
+  /// Ring of slots, sized to a power of two
+  lfq_slot_t *slots;
+  /// Index mask, one less than the slot count
+  size_t mask;
+  /// Next position to push
+  atomic_size_t head;
+  /// Next position to pop
+  atomic_size_t tail;
+} lfq_t;
+
+/** Initialize a queue.
+ * @param q The queue to initialize.
+ * @param capacity The minimum number of entries, rounded up to a power of two.
+ * @return AMP_OK if successful.
+ */
+int lfq_init(lfq_t *q, size_t capacity);
+
+/** Free queue storage.
+ * Any values still in the queue are not touched.
+ * @param q The queue to destroy.
+ */
+void lfq_destroy(lfq_t *q);
+
+/** Push a value to the queue.
+ * This is safe to call from any number of threads concurrently.
+ * @param q The queue to push to.
+ * @param value The non-null value to push.
+ * @return True if the value was pushed, false if the queue was full.
+ */
+bool lfq_push(lfq_t *q, void *value);
+
+/** Pop a value from the queue.
+ * This is safe to call from any number of threads concurrently.
+ * @param q The queue to pop from.
+ * @return The oldest value, or NULL if the queue was empty.
+ */
+void *lfq_pop(lfq_t *q);
+
+/** Get an approximate count of values waiting in the queue.
+ * @param q The queue to inspect.
+ * @return The number of values pushed but not yet popped.
+ */
+size_t lfq_size(lfq_t *q);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRC_SHARED_UTILS_LFQ_H_ */
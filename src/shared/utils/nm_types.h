@@ -99,6 +99,24 @@ typedef enum
 } amp_type_e;
 
 
+/*
+ * Priority classes of agent output, most urgent first. These are local to
+ * an agent and never appear on the wire.
+ */
+typedef enum
+{
+  AMP_PRIO_URGENT = 0, /* Sent ahead of anything held, never rate limited. */
+  AMP_PRIO_HIGH   = 1, /* Default for state-based rules.                   */
+  AMP_PRIO_NORMAL = 2, /* Default for time-based rules and controls.       */
+  AMP_PRIO_BULK   = 3, /* Table sets and other large, deferrable output.   */
+
+  AMP_NUM_PRIO    = 4
+} amp_prio_e;
+
+/* Class of a control that runs in the class of whatever invoked it. */
+#define AMP_PRIO_INHERIT (0xFF)
+
+
 
 
 #define AMP_MAX_EID_LEN (16)
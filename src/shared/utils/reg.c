@@ -0,0 +1,345 @@
+/*
+ * Copyright (c) 2023 The Johns Hopkins University Applied Physics
+ * Laboratory LLC.
+ *
+ * This file is part of the Delay-Tolerant Networking Management
+ * Architecture (DTNMA) Tools package.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stdbool.h>
+#include <string.h>
+#include "reg.h"
+#include "debug.h"
+#include "utils.h"
+
+/// Smallest number of hash table slots
+#define REG_MIN_SLOTS 64
+
+static uint32_t reg_hash(reg_kind_e kind, const void *value)
+{
+  const uint8_t *cursor;
+  size_t len;
+  uint64_t hash = UINT64_C(0xcbf29ce484222325);
+
+  if (kind == REG_UVAST)
+  {
+    cursor = value;
+    len = sizeof(amp_uvast);
+  }
+  else
+  {
+    cursor = ((const blob_t *)value)->value;
+    len = ((const blob_t *)value)->length;
+  }
+
+  // FNV-1a, folded to 32 bits
+  while (len-- > 0)
+  {
+    hash ^= *(cursor++);
+    hash *= UINT64_C(0x100000001b3);
+  }
+  return (uint32_t)(hash ^ (hash >> 32));
+}
+
+static bool reg_equal(reg_kind_e kind, const void *v1, const void *v2)
+{
+  if (kind == REG_UVAST)
+  {
+    return *(const amp_uvast *)v1 == *(const amp_uvast *)v2;
+  }
+  else
+  {
+    const blob_t *b1 = v1;
+    const blob_t *b2 = v2;
+    return (b1->length == b2->length)
+           && ((b1->length == 0) || (memcmp(b1->value, b2->value, b1->length) == 0));
+  }
+}
+
+static void reg_value_release(reg_kind_e kind, void *value)
+{
+  if (kind == REG_BLOB)
+  {
+    blob_release(value, 1);
+  }
+  else
+  {
+    SRELEASE(value);
+  }
+}
+
+static reg_tbl_t *reg_tbl_create(uint32_t count)
+{
+  uint32_t num = REG_MIN_SLOTS;
+  uint32_t i;
+  reg_tbl_t *tbl;
+
+  while (num < count)
+  {
+    num <<= 1;
+  }
+
+  tbl = STAKE(sizeof(reg_tbl_t) + num * sizeof(reg_slot_t));
+  if (tbl == NULL)
+  {
+    AMP_DEBUG_ERR("reg_tbl_create", "Cannot allocate %d slots.", num);
+    return NULL;
+  }
+  tbl->prev = NULL;
+  tbl->mask = num - 1;
+  for (i = 0; i < num; i++)
+  {
+    atomic_init(&(tbl->slots[i].idx), 0);
+    tbl->slots[i].hash = 0;
+  }
+  return tbl;
+}
+
+/** Place an index in a table known to have room for it.
+ * The hash is written before the index is published.
+ */
+static void reg_tbl_put(reg_tbl_t *tbl, uint32_t hash, reg_idx_t idx)
+{
+  uint32_t pos = hash & tbl->mask;
+
+  while (atomic_load_explicit(&(tbl->slots[pos].idx), memory_order_relaxed) != 0)
+  {
+    pos = (pos + 1) & tbl->mask;
+  }
+  tbl->slots[pos].hash = hash;
+  atomic_store_explicit(&(tbl->slots[pos].idx), idx + 1, memory_order_release);
+}
+
+int reg_init(reg_t *reg, reg_kind_e kind, uint32_t hint)
+{
+  reg_tbl_t *tbl;
+  size_t i;
+
+  CHKUSR(reg, AMP_FAIL);
+
+  reg->blocks = STAKE(REG_MAX_BLOCKS * sizeof(*(reg->blocks)));
+  if (reg->blocks == NULL)
+  {
+    AMP_DEBUG_ERR("reg_init", "Cannot allocate block table.", NULL);
+    return AMP_SYSERR;
+  }
+  for (i = 0; i < REG_MAX_BLOCKS; i++)
+  {
+    atomic_init(&(reg->blocks[i]), NULL);
+  }
+
+  // Keep the table at most half full
+  if ((tbl = reg_tbl_create(2 * hint)) == NULL)
+  {
+    SRELEASE(reg->blocks);
+    reg->blocks = NULL;
+    return AMP_SYSERR;
+  }
+
+  reg->kind = kind;
+  pthread_mutex_init(&(reg->lock), NULL);
+  atomic_init(&(reg->num), 0);
+  atomic_init(&(reg->tbl), tbl);
+  return AMP_OK;
+}
+
+void reg_release(reg_t *reg)
+{
+  reg_tbl_t *tbl;
+  uint32_t num;
+  uint32_t i;
+
+  CHKVOID(reg);
+  if (reg->blocks == NULL)
+  {
+    return;
+  }
+
+  num = atomic_load(&(reg->num));
+  for (i = 0; i < num; i++)
+  {
+    reg_value_release(reg->kind, reg_at(reg, i));
+  }
+  for (i = 0; i < REG_MAX_BLOCKS; i++)
+  {
+    SRELEASE(atomic_load(&(reg->blocks[i])));
+  }
+  SRELEASE(reg->blocks);
+  reg->blocks = NULL;
+
+  tbl = atomic_load(&(reg->tbl));
+  while (tbl != NULL)
+  {
+    reg_tbl_t *prev = tbl->prev;
+    SRELEASE(tbl);
+    tbl = prev;
+  }
+  atomic_store(&(reg->tbl), NULL);
+  atomic_store(&(reg->num), 0);
+
+  pthread_mutex_destroy(&(reg->lock));
+}
+
+/** Search one table without locking. */
+static int reg_tbl_find(reg_t *reg, reg_tbl_t *tbl, uint32_t hash, const void *value, reg_idx_t *idx)
+{
+  uint32_t pos = hash & tbl->mask;
+  unsigned int found;
+
+  while ((found = atomic_load_explicit(&(tbl->slots[pos].idx), memory_order_acquire)) != 0)
+  {
+    if ((tbl->slots[pos].hash == hash)
+        && reg_equal(reg->kind, reg_at(reg, found - 1), value))
+    {
+      if (idx != NULL)
+      {
+        *idx = found - 1;
+      }
+      return AMP_OK;
+    }
+    pos = (pos + 1) & tbl->mask;
+  }
+  return AMP_FAIL;
+}
+
+int reg_find(reg_t *reg, const void *value, reg_idx_t *idx)
+{
+  CHKUSR(reg, AMP_FAIL);
+  CHKUSR(value, AMP_FAIL);
+
+  return reg_tbl_find(reg, atomic_load_explicit(&(reg->tbl), memory_order_acquire),
+                      reg_hash(reg->kind, value), value, idx);
+}
+
+int reg_add(reg_t *reg, const void *value, reg_idx_t *idx)
+{
+  uint32_t hash;
+  uint32_t num;
+  reg_tbl_t *tbl;
+  void **block;
+  void *entry;
+
+  CHKUSR(reg, AMP_FAIL);
+  CHKUSR(value, AMP_FAIL);
+
+  hash = reg_hash(reg->kind, value);
+
+  // Most values are already registered
+  if (reg_tbl_find(reg, atomic_load_explicit(&(reg->tbl), memory_order_acquire),
+                   hash, value, idx) == AMP_OK)
+  {
+    return AMP_OK;
+  }
+
+  pthread_mutex_lock(&(reg->lock));
+
+  // Another thread may have added it since
+  tbl = atomic_load_explicit(&(reg->tbl), memory_order_relaxed);
+  if (reg_tbl_find(reg, tbl, hash, value, idx) == AMP_OK)
+  {
+    pthread_mutex_unlock(&(reg->lock));
+    return AMP_OK;
+  }
+
+  num = atomic_load_explicit(&(reg->num), memory_order_relaxed);
+  if (num >= REG_MAX_BLOCKS * REG_BLOCK_SIZE)
+  {
+    pthread_mutex_unlock(&(reg->lock));
+    AMP_DEBUG_ERR("reg_add", "Registry full at %d values.", num);
+    return AMP_FAIL;
+  }
+
+  // Copy the value
+  if (reg->kind == REG_BLOB)
+  {
+    const blob_t *blob = value;
+    entry = blob_create(blob->value, blob->length, (blob->length > 0) ? blob->length : 1);
+  }
+  else if ((entry = STAKE(sizeof(amp_uvast))) != NULL)
+  {
+    *(amp_uvast *)entry = *(const amp_uvast *)value;
+  }
+  if (entry == NULL)
+  {
+    pthread_mutex_unlock(&(reg->lock));
+    return AMP_SYSERR;
+  }
+
+  // Grow the hash table before it is half full. The old table stays
+  // readable by anyone still searching it.
+  if (2 * (num + 1) > tbl->mask + 1)
+  {
+    reg_tbl_t *next = reg_tbl_create(4 * (num + 1));
+    uint32_t i;
+
+    if (next == NULL)
+    {
+      pthread_mutex_unlock(&(reg->lock));
+      reg_value_release(reg->kind, entry);
+      return AMP_SYSERR;
+    }
+    for (i = 0; i <= tbl->mask; i++)
+    {
+      unsigned int found = atomic_load_explicit(&(tbl->slots[i].idx), memory_order_relaxed);
+      if (found != 0)
+      {
+        reg_tbl_put(next, tbl->slots[i].hash, found - 1);
+      }
+    }
+    next->prev = tbl;
+    atomic_store_explicit(&(reg->tbl), next, memory_order_release);
+    tbl = next;
+  }
+
+  // Store the value, then publish its index
+  block = atomic_load_explicit(&(reg->blocks[num / REG_BLOCK_SIZE]), memory_order_relaxed);
+  if (block == NULL)
+  {
+    if ((block = STAKE(REG_BLOCK_SIZE * sizeof(void *))) == NULL)
+    {
+      pthread_mutex_unlock(&(reg->lock));
+      reg_value_release(reg->kind, entry);
+      return AMP_SYSERR;
+    }
+    atomic_store_explicit(&(reg->blocks[num / REG_BLOCK_SIZE]), block, memory_order_release);
+  }
+  block[num % REG_BLOCK_SIZE] = entry;
+  atomic_store_explicit(&(reg->num), num + 1, memory_order_release);
+  reg_tbl_put(tbl, hash, num);
+
+  pthread_mutex_unlock(&(reg->lock));
+
+  if (idx != NULL)
+  {
+    *idx = num;
+  }
+  return AMP_OK;
+}
+
+void *reg_at(reg_t *reg, reg_idx_t idx)
+{
+  void **block;
+
+  CHKNULL(reg);
+  if (idx >= atomic_load_explicit(&(reg->num), memory_order_acquire))
+  {
+    return NULL;
+  }
+  block = atomic_load_explicit(&(reg->blocks[idx / REG_BLOCK_SIZE]), memory_order_acquire);
+  return block[idx % REG_BLOCK_SIZE];
+}
+
+uint32_t reg_size(reg_t *reg)
+{
+  CHKZERO(reg);
+  return atomic_load(&(reg->num));
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2023 The Johns Hopkins University Applied Physics
+ * Laboratory LLC.
+ *
+ * This file is part of the Delay-Tolerant Networking Management
+ * Architecture (DTNMA) Tools package.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SRC_SHARED_UTILS_REG_H_
+#define SRC_SHARED_UTILS_REG_H_
+
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "shared/platform.h"
+#include "shared/primitives/blob.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Index of a registered value
+typedef uint32_t reg_idx_t;
+
+/// Number of values in each block of a registry
+#define REG_BLOCK_SIZE 256
+/// Largest number of blocks, bounding a registry to 1M values
+#define REG_MAX_BLOCKS 4096
+
+/** Kind of value held by a registry. */
+typedef enum
+{
+  /// Values are amp_uvast
+  REG_UVAST,
+  /// Values are blob_t
+  REG_BLOB
+} reg_kind_e;
+
+/** One slot of the value-to-index hash table. */
+typedef struct
+{
+  /// One more than the index held, or zero if the slot is empty
+  atomic_uint idx;
+  /// Low bits of the hash of the value held
+  uint32_t hash;
+} reg_slot_t;
+
+/** The value-to-index hash table.
+ * Tables replaced by a larger one are kept until the registry is released,
+ * so that readers never see freed memory.
+ */
+typedef struct reg_tbl_s
+{
+  struct reg_tbl_s *prev;
+  uint32_t mask;
+  reg_slot_t slots[];
+} reg_tbl_t;
+
+/** A bidirectional registry of unique values and their indices.
+ * Values are only ever added, and each keeps the index it was given, so
+ * indices may be stored in place of the values (e.g. ARI nicknames).
+ * Looking up a value by index or an index by value takes no lock. Adding a
+ * value takes a lock only if it is not already registered.
+ */
+typedef struct
+{
+  reg_kind_e kind;
+  /// Serializes adding values
+  pthread_mutex_t lock;
+  /// Blocks of value pointers, allocated as needed
+  _Atomic(void **) *blocks;
+  /// Number of values
+  atomic_uint num;
+  /// Current hash table
+  _Atomic(reg_tbl_t *) tbl;
+} reg_t;
+
+/** Initialize an empty registry.
+ * @param reg The registry to initialize.
+ * @param kind The kind of value it holds.
+ * @param hint The expected number of values.
+ * @return AMP_OK if successful.
+ */
+int reg_init(reg_t *reg, reg_kind_e kind, uint32_t hint);
+
+/** Release a registry and its values.
+ * Values must no longer be in use by any thread.
+ * @param reg The registry to release.
+ */
+void reg_release(reg_t *reg);
+
+/** Find the index of a value.
+ * @param reg The registry.
+ * @param value The value, an amp_uvast or blob_t according to the kind.
+ * @param[out] idx The index of the value, if found.
+ * @return AMP_OK if found, or AMP_FAIL.
+ */
+int reg_find(reg_t *reg, const void *value, reg_idx_t *idx);
+
+/** Register a value, or find it if already registered.
+ * @param reg The registry.
+ * @param value The value, which is copied.
+ * @param[out] idx The index of the value.
+ * @return AMP_OK if successful.
+ */
+int reg_add(reg_t *reg, const void *value, reg_idx_t *idx);
+
+/** Get a registered value.
+ * @param reg The registry.
+ * @param idx The index of the value.
+ * @return The value, an amp_uvast or blob_t according to the kind, or NULL
+ * if no value has the index. It remains valid until reg_release().
+ */
+void *reg_at(reg_t *reg, reg_idx_t idx);
+
+/** Get the number of registered values.
+ * @param reg The registry.
+ */
+uint32_t reg_size(reg_t *reg);
+
+/** Register an integer value.
+ * @sa reg_add()
+ */
+static inline int reg_add_uvast(reg_t *reg, amp_uvast value, reg_idx_t *idx)
+{
+  return reg_add(reg, &value, idx);
+}
+
+/** Register a byte string value.
+ * @sa reg_add()
+ */
+static inline int reg_add_blob(reg_t *reg, blob_t value, reg_idx_t *idx)
+{
+  return reg_add(reg, &value, idx);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRC_SHARED_UTILS_REG_H_ */
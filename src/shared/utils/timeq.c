@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) 2023 The Johns Hopkins University Applied Physics
+ * Laboratory LLC.
+ *
+ * This file is part of the Delay-Tolerant Networking Management
+ * Architecture (DTNMA) Tools package.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stdlib.h>
+#include "timeq.h"
+#include "debug.h"
+#include "utils.h"
+
+/// True if slot a is due before slot b
+static inline int timeq_before(const timeq_t *q, uint32_t a, uint32_t b)
+{
+  const timeq_slot_t *sa = &(q->slots[a]);
+  const timeq_slot_t *sb = &(q->slots[b]);
+  int cmp = TimeCompare(sa->key, sb->key);
+  return (cmp < 0) || ((cmp == 0) && (sa->seq < sb->seq));
+}
+
+static inline void timeq_place(timeq_t *q, uint32_t pos, uint32_t slot)
+{
+  q->heap[pos] = slot;
+  q->slots[slot].pos = pos;
+}
+
+static void timeq_sift_up(timeq_t *q, uint32_t pos)
+{
+  const uint32_t slot = q->heap[pos];
+  while (pos > 0)
+  {
+    const uint32_t parent = (pos - 1) / 2;
+    if (!timeq_before(q, slot, q->heap[parent]))
+    {
+      break;
+    }
+    timeq_place(q, pos, q->heap[parent]);
+    pos = parent;
+  }
+  timeq_place(q, pos, slot);
+}
+
+static void timeq_sift_down(timeq_t *q, uint32_t pos)
+{
+  const uint32_t slot = q->heap[pos];
+  while (1)
+  {
+    uint32_t child = 2 * pos + 1;
+    if (child >= q->num)
+    {
+      break;
+    }
+    if ((child + 1 < q->num) && timeq_before(q, q->heap[child + 1], q->heap[child]))
+    {
+      ++child;
+    }
+    if (!timeq_before(q, q->heap[child], slot))
+    {
+      break;
+    }
+    timeq_place(q, pos, q->heap[child]);
+    pos = child;
+  }
+  timeq_place(q, pos, slot);
+}
+
+static int timeq_grow(timeq_t *q)
+{
+  const uint32_t cap = q->cap * 2;
+  timeq_slot_t *slots = realloc(q->slots, cap * sizeof(timeq_slot_t));
+  if (slots == NULL)
+  {
+    return AMP_SYSERR;
+  }
+  q->slots = slots;
+
+  uint32_t *heap = realloc(q->heap, cap * sizeof(uint32_t));
+  if (heap == NULL)
+  {
+    return AMP_SYSERR;
+  }
+  q->heap = heap;
+
+  // New slots, excluding the reserved slot zero, join the free list
+  for (uint32_t ix = cap - 1; ix >= q->cap; --ix)
+  {
+    q->slots[ix].item = NULL;
+    q->slots[ix].pos = q->free_slot;
+    q->free_slot = ix;
+  }
+  q->cap = cap;
+  return AMP_OK;
+}
+
+/// Remove the item at a heap position, with the lock held
+static void *timeq_remove_pos(timeq_t *q, uint32_t pos)
+{
+  const uint32_t slot = q->heap[pos];
+  void *item = q->slots[slot].item;
+
+  q->num--;
+  if (pos < q->num)
+  {
+    timeq_place(q, pos, q->heap[q->num]);
+    if ((pos > 0) && timeq_before(q, q->heap[pos], q->heap[(pos - 1) / 2]))
+    {
+      timeq_sift_up(q, pos);
+    }
+    else
+    {
+      timeq_sift_down(q, pos);
+    }
+  }
+
+  q->slots[slot].item = NULL;
+  q->slots[slot].pos = q->free_slot;
+  q->free_slot = slot;
+
+  if (pos == 0)
+  {
+    pthread_cond_broadcast(&(q->cond_head));
+  }
+  return item;
+}
+
+int timeq_init(timeq_t *q, uint32_t capacity, void (*delete_fn)(void *item))
+{
+  pthread_mutexattr_t attr;
+
+  CHKUSR(q, AMP_FAIL);
+  memset(q, 0, sizeof(timeq_t));
+
+  pthread_mutexattr_init(&attr);
+  pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+  if (pthread_mutex_init(&(q->lock), &attr))
+  {
+    AMP_DEBUG_ERR("timeq_init", "Unable to make mutex", NULL);
+    pthread_mutexattr_destroy(&attr);
+    return AMP_SYSERR;
+  }
+  pthread_mutexattr_destroy(&attr);
+  if (pthread_cond_init(&(q->cond_head), NULL))
+  {
+    AMP_DEBUG_ERR("timeq_init", "Unable to make condition", NULL);
+    pthread_mutex_destroy(&(q->lock));
+    return AMP_SYSERR;
+  }
+
+  // Slot zero is reserved so that no handle is zero
+  q->delete_fn = delete_fn;
+  q->slots = calloc(1, sizeof(timeq_slot_t));
+  q->heap = calloc(1, sizeof(uint32_t));
+  q->cap = 1;
+  while ((q->slots != NULL) && (q->heap != NULL) && (q->cap <= capacity))
+  {
+    if (timeq_grow(q) != AMP_OK)
+    {
+      break;
+    }
+  }
+  if ((q->slots == NULL) || (q->heap == NULL) || (q->cap <= capacity))
+  {
+    AMP_DEBUG_ERR("timeq_init", "Unable to allocate queue", NULL);
+    timeq_destroy(q);
+    return AMP_SYSERR;
+  }
+
+  return AMP_OK;
+}
+
+void timeq_destroy(timeq_t *q)
+{
+  CHKVOID(q);
+
+  if (q->delete_fn)
+  {
+    for (uint32_t ix = 0; ix < q->num; ++ix)
+    {
+      q->delete_fn(q->slots[q->heap[ix]].item);
+    }
+  }
+  free(q->slots);
+  free(q->heap);
+  if (q->cap > 0)
+  {
+    // Only an initialized queue has slots
+    pthread_cond_destroy(&(q->cond_head));
+    pthread_mutex_destroy(&(q->lock));
+  }
+  memset(q, 0, sizeof(timeq_t));
+}
+
+int timeq_push(timeq_t *q, OS_time_t key, void *item, timeq_handle_t *handle)
+{
+  uint32_t slot;
+  int success = AMP_OK;
+
+  CHKUSR(q, AMP_FAIL);
+  CHKUSR(item, AMP_FAIL);
+
+  pthread_mutex_lock(&(q->lock));
+  if ((q->free_slot == 0) && (timeq_grow(q) != AMP_OK))
+  {
+    AMP_DEBUG_ERR("timeq_push", "Unable to grow queue", NULL);
+    success = AMP_SYSERR;
+  }
+  else
+  {
+    slot = q->free_slot;
+    q->free_slot = q->slots[slot].pos;
+    q->slots[slot].key = key;
+    q->slots[slot].seq = q->next_seq++;
+    q->slots[slot].item = item;
+
+    q->heap[q->num] = slot;
+    timeq_sift_up(q, q->num++);
+
+    if (handle)
+    {
+      *handle = slot;
+    }
+    if (q->slots[slot].pos == 0)
+    {
+      pthread_cond_broadcast(&(q->cond_head));
+    }
+  }
+  pthread_mutex_unlock(&(q->lock));
+
+  return success;
+}
+
+OS_time_t timeq_next(timeq_t *q)
+{
+  OS_time_t result = OS_TIME_MAX;
+
+  CHKUSR(q, result);
+  pthread_mutex_lock(&(q->lock));
+  if (q->num > 0)
+  {
+    result = q->slots[q->heap[0]].key;
+  }
+  pthread_mutex_unlock(&(q->lock));
+  return result;
+}
+
+void *timeq_pop_due(timeq_t *q, OS_time_t nowtime)
+{
+  void *item = NULL;
+
+  CHKNULL(q);
+  pthread_mutex_lock(&(q->lock));
+  if ((q->num > 0) && (TimeCompare(q->slots[q->heap[0]].key, nowtime) <= 0))
+  {
+    item = timeq_remove_pos(q, 0);
+  }
+  pthread_mutex_unlock(&(q->lock));
+  return item;
+}
+
+void *timeq_at(timeq_t *q, timeq_handle_t handle)
+{
+  void *item = NULL;
+
+  CHKNULL(q);
+  pthread_mutex_lock(&(q->lock));
+  if ((handle > 0) && (handle < q->cap))
+  {
+    item = q->slots[handle].item;
+  }
+  pthread_mutex_unlock(&(q->lock));
+  return item;
+}
+
+void *timeq_remove(timeq_t *q, timeq_handle_t handle)
+{
+  void *item = NULL;
+
+  CHKNULL(q);
+  pthread_mutex_lock(&(q->lock));
+  if ((handle > 0) && (handle < q->cap) && (q->slots[handle].item != NULL))
+  {
+    item = timeq_remove_pos(q, q->slots[handle].pos);
+  }
+  pthread_mutex_unlock(&(q->lock));
+  return item;
+}
+
+uint32_t timeq_size(timeq_t *q)
+{
+  uint32_t num;
+
+  CHKUSR(q, 0);
+  pthread_mutex_lock(&(q->lock));
+  num = q->num;
+  pthread_mutex_unlock(&(q->lock));
+  return num;
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2023 The Johns Hopkins University Applied Physics
+ * Laboratory LLC.
+ *
+ * This file is part of the Delay-Tolerant Networking Management
+ * Architecture (DTNMA) Tools package.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SRC_SHARED_UTILS_TIMEQ_H_
+#define SRC_SHARED_UTILS_TIMEQ_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "shared/primitives/time.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** A stable reference to a queued item.
+ * Handles stay valid while the item is queued, no matter how the queue is
+ * reordered. The value zero is never a valid handle.
+ */
+typedef uint32_t timeq_handle_t;
+
+/** Storage for one queued item, indexed by handle. */
+typedef struct {
+  /// Time at which the item is due
+  OS_time_t key;
+  /// Insertion order, keeping items with equal times first-in-first-out
+  uint64_t seq;
+  /// The queued item, or NULL for an unused slot
+  void *item;
+  /// Position in the heap, or the next free slot when unused
+  uint32_t pos;
+} timeq_slot_t;
+
+/** A time-ordered queue of opaque items.
+ * This is a binary min-heap of slot indices, so insertion and removal are
+ * O(log n) and the earliest item is found in constant time.
+ * All functions take the queue lock, which is recursive so that a caller
+ * can hold it across several calls or while waiting on #cond_head.
+ */
+typedef struct {
+  pthread_mutex_t lock;
+  /// Signaled whenever the earliest item changes
+  pthread_cond_t cond_head;
+
+  /// Slots indexed by handle, slot zero is unused
+  timeq_slot_t *slots;
+  /// Allocated size of #slots and #heap
+  uint32_t cap;
+  /// Head of the unused slot list, zero if none
+  uint32_t free_slot;
+  /// Heap of slot indices
+  uint32_t *heap;
+  /// Number of queued items
+  uint32_t num;
+  /// Next insertion sequence number
+  uint64_t next_seq;
+
+  /// Called on items still queued when the queue is destroyed
+  void (*delete_fn)(void *item);
+} timeq_t;
+
+/** Initialize a queue.
+ * @param q The queue to initialize.
+ * @param capacity The initial number of items; the queue grows as needed.
+ * @param delete_fn Optional function to release items.
+ * @return AMP_OK if successful.
+ */
+int timeq_init(timeq_t *q, uint32_t capacity, void (*delete_fn)(void *item));
+
+/** Release all queue storage and any items still queued.
+ * @param q The queue to destroy.
+ */
+void timeq_destroy(timeq_t *q);
+
+/** Add an item to the queue.
+ * Waiters on timeq_t::cond_head are woken only if this becomes the
+ * earliest item.
+ * @param q The queue to add to.
+ * @param key The time at which the item is due.
+ * @param item The non-null item to add.
+ * @param[out] handle If not null, set to the handle of the new item.
+ * @return AMP_OK if successful.
+ */
+int timeq_push(timeq_t *q, OS_time_t key, void *item, timeq_handle_t *handle);
+
+/** Get the due time of the earliest item.
+ * @param q The queue to inspect.
+ * @return The earliest time, or OS_TIME_MAX if the queue is empty.
+ */
+OS_time_t timeq_next(timeq_t *q);
+
+/** Remove the earliest item if it is due.
+ * @param q The queue to take from.
+ * @param nowtime The current time.
+ * @return The earliest item with a time not after @c nowtime, or NULL.
+ */
+void *timeq_pop_due(timeq_t *q, OS_time_t nowtime);
+
+/** Get a queued item by its handle.
+ * @param q The queue to inspect.
+ * @param handle The item handle.
+ * @return The item, or NULL if the handle is not queued.
+ */
+void *timeq_at(timeq_t *q, timeq_handle_t handle);
+
+/** Remove an item by its handle.
+ * @param q The queue to remove from.
+ * @param handle The item handle.
+ * @return The removed item, or NULL if the handle is not queued.
+ */
+void *timeq_remove(timeq_t *q, timeq_handle_t handle);
+
+/** Get the number of queued items.
+ * @param q The queue to inspect.
+ * @return The item count.
+ */
+uint32_t timeq_size(timeq_t *q);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRC_SHARED_UTILS_TIMEQ_H_ */
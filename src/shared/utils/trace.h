@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2023 The Johns Hopkins University Applied Physics
+ * Laboratory LLC.
+ *
+ * This file is part of the Delay-Tolerant Networking Management
+ * Architecture (DTNMA) Tools package.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/** @file
+ * Static tracepoints for the agent and manager hot paths.
+ *
+ * When built with USE_USDT and <sys/sdt.h> is available, each NM_TRACE
+ * macro places a USDT probe under the provider "dtnma". A probe which is
+ * not attached costs one no-op instruction and never evaluates anything
+ * beyond its already computed arguments, so probe arguments must be cheap
+ * expressions. Otherwise the macros compile to nothing.
+ *
+ * Probes are listed with `bpftrace -l 'usdt:<binary>:dtnma:*'` and
+ * examples of their use are in the bpftrace directory.
+ */
+#ifndef SRC_SHARED_UTILS_TRACE_H_
+#define SRC_SHARED_UTILS_TRACE_H_
+
+#if defined(USE_USDT) && defined(HAVE_SYS_SDT_H)
+
+#include <sys/sdt.h>
+
+#define NM_TRACE0(name) DTRACE_PROBE(dtnma, name)
+#define NM_TRACE1(name, a1) DTRACE_PROBE1(dtnma, name, a1)
+#define NM_TRACE2(name, a1, a2) DTRACE_PROBE2(dtnma, name, a1, a2)
+#define NM_TRACE3(name, a1, a2, a3) DTRACE_PROBE3(dtnma, name, a1, a2, a3)
+#define NM_TRACE4(name, a1, a2, a3, a4) DTRACE_PROBE4(dtnma, name, a1, a2, a3, a4)
+
+#else
+
+#define NM_TRACE0(name) do {} while(0)
+#define NM_TRACE1(name, a1) do {} while(0)
+#define NM_TRACE2(name, a1, a2) do {} while(0)
+#define NM_TRACE3(name, a1, a2, a3) do {} while(0)
+#define NM_TRACE4(name, a1, a2, a3, a4) do {} while(0)
+
+#endif
+
+#endif /* SRC_SHARED_UTILS_TRACE_H_ */
@@ -44,6 +44,13 @@
 
 #include <stdlib.h>
 #include <stdarg.h>
+#include <pthread.h>
+#include <time.h>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 #include <osapi-mutex.h>
 #include <osapi-error.h>
 #include "shared/platform.h"
@@ -233,6 +240,205 @@ unsigned long utils_atox(const char *s, int *success)
 
 
 
+static const char utils_hex_digits[] = "0123456789abcdef";
+
+/* The value of a hex digit, or 0xFF if it is not one. */
+static inline uint8_t utils_hex_nibble(uint8_t c)
+{
+	if((c >= '0') && (c <= '9')) return c - '0';
+	c |= 0x20;
+	if((c >= 'a') && (c <= 'f')) return c - 'a' + 10;
+	return 0xFF;
+}
+
+#if defined(__SSE2__)
+/* Hex digits for 16 nibbles: '0' + n, plus the gap to 'a' for n > 9. */
+static inline __m128i utils_hex_digits_sse2(__m128i nib)
+{
+	const __m128i gap = _mm_and_si128(_mm_cmpgt_epi8(nib, _mm_set1_epi8(9)), _mm_set1_epi8('a' - '0' - 10));
+	return _mm_add_epi8(_mm_add_epi8(nib, _mm_set1_epi8('0')), gap);
+}
+
+/* Values of 16 hex digits, clearing *valid if any is not one. */
+static inline __m128i utils_hex_values_sse2(__m128i c, int *valid)
+{
+	const __m128i lc = _mm_or_si128(c, _mm_set1_epi8(0x20));
+	const __m128i is_dig = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)),
+	                                     _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+	const __m128i is_alp = _mm_and_si128(_mm_cmpgt_epi8(lc, _mm_set1_epi8('a' - 1)),
+	                                     _mm_cmplt_epi8(lc, _mm_set1_epi8('f' + 1)));
+
+	if(_mm_movemask_epi8(_mm_or_si128(is_dig, is_alp)) != 0xFFFF)
+	{
+		*valid = 0;
+	}
+	return _mm_or_si128(_mm_and_si128(is_dig, _mm_sub_epi8(c, _mm_set1_epi8('0'))),
+	                    _mm_and_si128(is_alp, _mm_sub_epi8(lc, _mm_set1_epi8('a' - 10))));
+}
+
+/* Bytes from 16 digit values, as the low byte of each 16-bit lane. */
+static inline __m128i utils_hex_pairs_sse2(__m128i val)
+{
+	return _mm_or_si128(_mm_and_si128(_mm_slli_epi16(val, 4), _mm_set1_epi16(0x00F0)),
+	                    _mm_srli_epi16(val, 8));
+}
+#endif
+
+#if defined(__AVX2__)
+static inline __m256i utils_hex_digits_avx2(__m256i nib)
+{
+	const __m256i gap = _mm256_and_si256(_mm256_cmpgt_epi8(nib, _mm256_set1_epi8(9)), _mm256_set1_epi8('a' - '0' - 10));
+	return _mm256_add_epi8(_mm256_add_epi8(nib, _mm256_set1_epi8('0')), gap);
+}
+
+static inline __m256i utils_hex_values_avx2(__m256i c, int *valid)
+{
+	const __m256i lc = _mm256_or_si256(c, _mm256_set1_epi8(0x20));
+	const __m256i is_dig = _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('0' - 1)),
+	                                        _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), c));
+	const __m256i is_alp = _mm256_and_si256(_mm256_cmpgt_epi8(lc, _mm256_set1_epi8('a' - 1)),
+	                                        _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), lc));
+
+	if(_mm256_movemask_epi8(_mm256_or_si256(is_dig, is_alp)) != -1)
+	{
+		*valid = 0;
+	}
+	return _mm256_or_si256(_mm256_and_si256(is_dig, _mm256_sub_epi8(c, _mm256_set1_epi8('0'))),
+	                       _mm256_and_si256(is_alp, _mm256_sub_epi8(lc, _mm256_set1_epi8('a' - 10))));
+}
+
+static inline __m256i utils_hex_pairs_avx2(__m256i val)
+{
+	return _mm256_or_si256(_mm256_and_si256(_mm256_slli_epi16(val, 4), _mm256_set1_epi16(0x00F0)),
+	                       _mm256_srli_epi16(val, 8));
+}
+#endif
+
+/******************************************************************************
+ *
+ * \par Function Name: utils_hex_encode
+ *
+ * \par Purpose: Writes a buffer as lowercase hex digits, with no prefix.
+ *
+ * \return The number of digits written, which is twice the buffer size.
+ *
+ * \param[out] out     Room for 2 * size digits and a NULL terminator.
+ * \param[in]  buffer  The buffer to encode.
+ * \param[in]  size    Size of the buffer, in bytes.
+ *
+ * \par Notes:
+ *   - Blocks are encoded with AVX2 or SSE2 when the build targets them.
+ *****************************************************************************/
+
+size_t utils_hex_encode(char *out, const uint8_t *buffer, size_t size)
+{
+	size_t i = 0;
+
+#if defined(__AVX2__)
+	for(; i + 32 <= size; i += 32)
+	{
+		const __m256i in = _mm256_loadu_si256((const __m256i *)(buffer + i));
+		const __m256i lo = utils_hex_digits_avx2(_mm256_and_si256(in, _mm256_set1_epi8(0x0F)));
+		const __m256i hi = utils_hex_digits_avx2(_mm256_and_si256(_mm256_srli_epi16(in, 4), _mm256_set1_epi8(0x0F)));
+		/* Unpacking is within each 128-bit lane, so put the halves back in order. */
+		const __m256i a = _mm256_unpacklo_epi8(hi, lo);
+		const __m256i b = _mm256_unpackhi_epi8(hi, lo);
+		_mm256_storeu_si256((__m256i *)(out + 2 * i), _mm256_permute2x128_si256(a, b, 0x20));
+		_mm256_storeu_si256((__m256i *)(out + 2 * i + 32), _mm256_permute2x128_si256(a, b, 0x31));
+	}
+#endif
+#if defined(__SSE2__)
+	for(; i + 16 <= size; i += 16)
+	{
+		const __m128i in = _mm_loadu_si128((const __m128i *)(buffer + i));
+		const __m128i lo = utils_hex_digits_sse2(_mm_and_si128(in, _mm_set1_epi8(0x0F)));
+		const __m128i hi = utils_hex_digits_sse2(_mm_and_si128(_mm_srli_epi16(in, 4), _mm_set1_epi8(0x0F)));
+		_mm_storeu_si128((__m128i *)(out + 2 * i), _mm_unpacklo_epi8(hi, lo));
+		_mm_storeu_si128((__m128i *)(out + 2 * i + 16), _mm_unpackhi_epi8(hi, lo));
+	}
+#endif
+	for(; i < size; i++)
+	{
+		out[2 * i] = utils_hex_digits[buffer[i] >> 4];
+		out[2 * i + 1] = utils_hex_digits[buffer[i] & 0x0F];
+	}
+
+	out[2 * size] = '\0';
+	return 2 * size;
+}
+
+
+
+/******************************************************************************
+ *
+ * \par Function Name: utils_hex_decode
+ *
+ * \par Purpose: Converts hex digits, in either case and with no prefix, to
+ *               bytes. An odd number of digits is read as if it had a
+ *               leading zero.
+ *
+ * \return AMP_OK if every character was a hex digit, otherwise AMP_FAIL
+ *         and the output is incomplete.
+ *
+ * \param[out] out      Room for (len + 1) / 2 bytes.
+ * \param[in]  value    The digits, which need not be terminated.
+ * \param[in]  len      The number of digits.
+ * \param[out] out_len  The number of bytes written, if not NULL.
+ *
+ * \par Notes:
+ *   - Blocks are decoded and checked with AVX2 or SSE2 when the build
+ *     targets them.
+ *****************************************************************************/
+
+int utils_hex_decode(uint8_t *out, const char *value, size_t len, size_t *out_len)
+{
+	const uint8_t *in = (const uint8_t *) value;
+	size_t i = 0;
+	size_t o = 0;
+	int valid = 1;
+
+	if(len % 2)
+	{
+		const uint8_t nib = utils_hex_nibble(in[0]);
+		valid = (nib != 0xFF);
+		out[o++] = nib;
+		i = 1;
+	}
+
+#if defined(__AVX2__)
+	for(; valid && (i + 64 <= len); i += 64, o += 32)
+	{
+		const __m256i a = utils_hex_pairs_avx2(utils_hex_values_avx2(_mm256_loadu_si256((const __m256i *)(in + i)), &valid));
+		const __m256i b = utils_hex_pairs_avx2(utils_hex_values_avx2(_mm256_loadu_si256((const __m256i *)(in + i + 32)), &valid));
+		/* Packing is within each 128-bit lane, so put the quarters back in order. */
+		_mm256_storeu_si256((__m256i *)(out + o), _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8));
+	}
+#endif
+#if defined(__SSE2__)
+	for(; valid && (i + 32 <= len); i += 32, o += 16)
+	{
+		const __m128i a = utils_hex_pairs_sse2(utils_hex_values_sse2(_mm_loadu_si128((const __m128i *)(in + i)), &valid));
+		const __m128i b = utils_hex_pairs_sse2(utils_hex_values_sse2(_mm_loadu_si128((const __m128i *)(in + i + 16)), &valid));
+		_mm_storeu_si128((__m128i *)(out + o), _mm_packus_epi16(a, b));
+	}
+#endif
+	for(; valid && (i < len); i += 2)
+	{
+		const uint8_t hi = utils_hex_nibble(in[i]);
+		const uint8_t lo = utils_hex_nibble(in[i + 1]);
+		valid = (hi != 0xFF) && (lo != 0xFF);
+		out[o++] = (hi << 4) | lo;
+	}
+
+	if(out_len != NULL)
+	{
+		*out_len = o;
+	}
+	return valid ? AMP_OK : AMP_FAIL;
+}
+
+
+
 /******************************************************************************
  *
  * \par Function Name: utils_hex_to_string
@@ -256,11 +462,7 @@ unsigned long utils_atox(const char *s, int *success)
 char *utils_hex_to_string(const uint8_t *buffer, size_t size)
 {
     char *result = NULL;
-    uint32_t char_size = 0;
-
-    char temp[3];
-    size_t i = 0;
-    int r = 0;
+    size_t char_size = 0;
 
     AMP_DEBUG_ENTRY("utils_hex_to_string","(%x,%d)",
     		          (size_t) buffer, size);
@@ -281,16 +483,7 @@ char *utils_hex_to_string(const uint8_t *buffer, size_t size)
 
     result[0] = '0';
     result[1] = 'x';
-    r = 2;
-
-    for(i = 0; i < size; i++)
-    {
-        sprintf(temp, "%.2x", (unsigned int)buffer[i]);
-        result[r++] = temp[0];
-        result[r++] = temp[1];
-    }
-
-    result[r] = '\0';
+    utils_hex_encode(result + 2, buffer, size);
 
     AMP_DEBUG_EXIT("mid_to_string","->%s.", result);
 
@@ -365,10 +558,7 @@ uint8_t getNibble(char c)
 blob_t* utils_string_to_hex(const char *value)
 {
 	blob_t *result = NULL;
-	char tmp_s[3];
-	int len = 0;
-	int success = 0;
-	int pad = 0; 
+	size_t len = 0;
 	size_t size = 0;
 
 	/*
@@ -386,58 +576,86 @@ blob_t* utils_string_to_hex(const char *value)
 	 *          character represents a nibble, the size of the byte array is
 	 *          half the size of the string (accounting for odd values).
 	 */
-	len = strlen((char*)value);
+	len = strlen(value);
+	size = (len + 1) / 2;
 
-	if((len%2) == 0)
-	{
-	  size = len/2;
-	}
-	else
+	if((result = blob_create(NULL, 0, size+1)) == NULL)
 	{
-		size = (len/2) + 1;
-       pad = 1;
+		AMP_DEBUG_ERR("utils_string_to_hex","Can't Alloc %d bytes.", size);
+		AMP_DEBUG_EXIT("utils_string_to_hex", "->NULL.", NULL);
+		return NULL;
 	}
 
-	if((result = blob_create(NULL, 0, size+1)) == NULL)
+	/* Step 2 - Decode and check all of the digits at once. */
+	if(utils_hex_decode(result->value, value, len, &(result->length)) != AMP_OK)
 	{
-		AMP_DEBUG_ERR("utils_string_to_hex","Can't Alloc %d bytes.", size);
+		AMP_DEBUG_ERR("utils_string_to_hex","Can't AtoX %s.", value);
+		blob_release(result, 1);
+
 		AMP_DEBUG_EXIT("utils_string_to_hex", "->NULL.", NULL);
 		return NULL;
 	}
 
-	/* Step 2 - For each byte, copy in the nibbles. */
-	tmp_s[2] = '\0';
-	int incr = 1;
-    int i = 0;
+	AMP_DEBUG_EXIT("utils_string_to_hex", "->%#llx.", result);
+	return result;
+}
+
+
+
+static uint32_t utils_crc_table[256];
+static pthread_once_t utils_crc_once = PTHREAD_ONCE_INIT;
 
-	for(i = 0; i < len;)
+static void utils_crc_init(void)
+{
+	for(uint32_t i = 0; i < 256; i++)
 	{
-		if(pad == 1)
-		{
-			tmp_s[0] = '0';
-			tmp_s[1] = value[i];
-			pad = 0;
-			incr = 1;
-		}
-		else
+		uint32_t c = i;
+		for(int k = 0; k < 8; k++)
 		{
-			memcpy(tmp_s, &(value[i]), 2);
-			incr = 2;
+			c = (c & 1) ? (0xEDB88320 ^ (c >> 1)) : (c >> 1);
 		}
-		uint8_t tmp_x = (uint8_t) utils_atox(tmp_s, &success);
-		blob_append(result, &tmp_x, 1);
-	
-		i += incr;
-		if(success == 0)
-		{
-			AMP_DEBUG_ERR("utils_string_to_hex","Can't AtoX %s.", tmp_s);
-			blob_release(result, 1);
+		utils_crc_table[i] = c;
+	}
+}
 
-			AMP_DEBUG_EXIT("utils_string_to_hex", "->NULL.", NULL);
-			return NULL;
-		}
+/******************************************************************************
+ *
+ * \par Function Name: utils_crc32
+ *
+ * \par Purpose: Computes or continues a CRC-32 (IEEE 802.3) over a buffer.
+ *
+ * \return The updated CRC.
+ *
+ * \param[in]  crc   The CRC of any preceding data, or 0 to start.
+ * \param[in]  data  The data to add.
+ * \param[in]  len   Size of the data, in bytes.
+ *****************************************************************************/
+
+uint32_t utils_crc32(uint32_t crc, const uint8_t *data, size_t len)
+{
+	pthread_once(&utils_crc_once, utils_crc_init);
+
+	crc = ~crc;
+	while(len--)
+	{
+		crc = utils_crc_table[(crc ^ *data++) & 0xFF] ^ (crc >> 8);
 	}
+	return ~crc;
+}
 
-	AMP_DEBUG_EXIT("utils_string_to_hex", "->%#llx.", result);
-	return result;
+/******************************************************************************
+ *
+ * \par Function Name: utils_now_us
+ *
+ * \par Purpose: Gets a monotonic time, for measuring intervals.
+ *
+ * \return The time in microseconds, from an arbitrary start.
+ *****************************************************************************/
+
+uint64_t utils_now_us()
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t) ts.tv_sec * 1000000) + (ts.tv_nsec / 1000);
 }
@@ -102,9 +102,15 @@ void*  utils_safe_take(size_t size);
 unsigned long utils_atox(const char *s, int *success);
 
 char*    utils_hex_to_string(const uint8_t *buffer, size_t size);
+size_t   utils_hex_encode(char *out, const uint8_t *buffer, size_t size);
 void     utils_print_hex(const unsigned char *s, size_t len);
 
 blob_t*  utils_string_to_hex(const char *value);
+int      utils_hex_decode(uint8_t *out, const char *value, size_t len, size_t *out_len);
+
+uint32_t utils_crc32(uint32_t crc, const uint8_t *data, size_t len);
+
+uint64_t utils_now_us();
 
 
 #ifdef __cplusplus
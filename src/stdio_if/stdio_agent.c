@@ -17,6 +17,7 @@
  */
 #include <sys/select.h>
 #include <signal.h>
+#include <unistd.h>
 #include <osapi-common.h>
 #include <osapi-bsp.h>
 #include <osapi-error.h>
@@ -31,10 +32,13 @@
 #include "shared/adm/adm_amp_agent.h"
 
 #define MAX_HEXMSG_SIZE 10240
+/// Bytes encoded at a time when sending
+#define STDIO_HEX_CHUNK 1024
 
 static nmagent_t agent;
 static eid_t manager_eid;
 static eid_t agent_eid;
+static char *db_path = NULL;
 
 static void
 daemon_signal_handler(int signum)
@@ -46,15 +50,23 @@ daemon_signal_handler(int signum)
 
 static int stdout_send(const blob_t *data, const eid_t *dest, void *ctx)
 {
-  char *buf = utils_hex_to_string(data->value, data->length);
-  if (fputs(buf, stdout) <= 0)
+  // Encoded a piece at a time, so nothing is allocated
+  char buf[2 * STDIO_HEX_CHUNK + 1];
+  size_t pos;
+
+  flockfile(stdout);
+  int ok = (fputs("0x", stdout) > 0);
+  for (pos = 0; ok && (pos < data->length); pos += STDIO_HEX_CHUNK)
   {
-    SRELEASE(buf);
-    return AMP_SYSERR;
+    size_t len = utils_hex_encode(buf, data->value + pos, MIN(data->length - pos, STDIO_HEX_CHUNK));
+    ok = (fwrite(buf, 1, len, stdout) == len);
   }
-  SRELEASE(buf);
-
-  if (fputs("\n", stdout) <= 0)
+  if (ok)
+  {
+    ok = (fputs("\n", stdout) > 0);
+  }
+  funlockfile(stdout);
+  if (!ok)
   {
     return AMP_SYSERR;
   }
@@ -135,6 +147,21 @@ OS_Application_Startup()
   }
 
   /* Step 1: Process Command Line Arguments. */
+  const int argc = OS_BSP_GetArgC();
+  char *const *argv = OS_BSP_GetArgV();
+  int c;
+  while ((c = getopt(argc, argv, "j:")) != -1)
+  {
+    switch (c)
+    {
+      case 'j':
+        db_path = optarg;
+        break;
+      default:
+        fprintf(stderr, "Usage: stdio_agent [-j <db path>]\n");
+        OS_ApplicationExit(-1);
+    }
+  }
   strncpy(agent_eid.name, "", AMP_MAX_EID_LEN);
   strncpy(manager_eid.name, "", AMP_MAX_EID_LEN);
 
@@ -166,6 +193,11 @@ OS_Application_Startup()
 #endif
 #endif
 
+  if (db_path && !nmagent_restore(&agent, db_path))
+  {
+    OS_ApplicationExit(EXIT_FAILURE);
+  }
+
   /* Step 4: Register signal handlers. */
   struct sigaction act;
   memset(&act, 0, sizeof(struct sigaction));
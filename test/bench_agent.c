@@ -0,0 +1,506 @@
+/*
+ * Copyright (c) 2023 The Johns Hopkins University Applied Physics
+ * Laboratory LLC.
+ *
+ * This file is part of the Delay-Tolerant Networking Management
+ * Architecture (DTNMA) Tools package.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/** @file
+ * End-to-end load generator for the agent.
+ *
+ * The agent runs in-process with all of its threads, behind a loopback
+ * messaging interface. Everything it does is driven by perform-control
+ * messages, as a manager would send them: rules over synthetic EDDs are
+ * added with add_tbr and add_sbr, then bursts of gen_rpts and gen_tbls
+ * are sent for the length of the run. The sustained report rate, rule
+ * lag and other latencies, CPU time per report and peak RSS are written
+ * as JSON.
+ *
+ * Usage: bench_agent [-m <edds>] [-n <tbrs>] [-s <sbrs>] [-k <edds/rule>]
+ *                    [-p <period ms>] [-b <gen_rpts/burst>]
+ *                    [-g <gen_tbls/burst>] [-i <burst ms>]
+ *                    [-d <secs>] [-o <file>]
+ */
+#include <osapi-common.h>
+#include <osapi-bsp.h>
+#include <osapi-task.h>
+#include <shared/adm/adm.h>
+#include <shared/msg/msg.h>
+#include <shared/msg/msg_if.h>
+#include <shared/primitives/expr.h>
+#include <shared/utils/lfq.h>
+#include <shared/utils/utils.h>
+#include <agent/instr.h>
+#include <agent/nmagent.h>
+#include <shared/adm/adm_amp_agent.h>
+#include <inttypes.h>
+#include <semaphore.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+
+/// Nickname of the synthetic objects
+#define BENCH_NN 12
+/// First object ID of the synthetic EDDs
+#define BENCH_EDD_BASE 2000
+/// First object ID of the rules
+#define BENCH_RULE_BASE 3000
+/// Most controls sent in one message
+#define BENCH_CTRLS_PER_MSG 64
+/// Messages which can wait for the agent
+#define BENCH_QUEUE_LEN 4096
+/// Longest wait for the agent to add all rules, in seconds
+#define BENCH_SETUP_SECS 30
+
+static nmagent_t agent;
+/// The manager the controls come from and reports go to
+static const char *bench_mgr = "ipn:1.7";
+
+static size_t bench_edds = 64;
+static size_t bench_tbrs = 16;
+static size_t bench_sbrs = 16;
+static size_t bench_edds_per_rule = 4;
+static unsigned bench_period_ms = 100;
+static size_t bench_gen_rpts = 1;
+static size_t bench_gen_tbls = 0;
+static unsigned bench_burst_ms = 100;
+static double bench_duration = 10;
+static const char *bench_out = NULL;
+
+/// Messages from the generator to the agent
+static lfq_t bench_rxq;
+static sem_t bench_rx_ready;
+/// Totals of what the agent sent
+static atomic_uint_fast64_t bench_tx_msgs;
+static atomic_uint_fast64_t bench_tx_bytes;
+/// Value of every synthetic EDD
+static atomic_uint_fast64_t bench_edd_val;
+
+
+static tnv_t *bench_edd(tnvc_t *params)
+{
+  (void) params;
+  return tnv_from_uvast(atomic_fetch_add_explicit(&bench_edd_val, 1, memory_order_relaxed) + 1);
+}
+
+static int bench_send(const blob_t *data, const eid_t *dest, void *ctx)
+{
+  (void) dest;
+  (void) ctx;
+  atomic_fetch_add_explicit(&bench_tx_msgs, 1, memory_order_relaxed);
+  atomic_fetch_add_explicit(&bench_tx_bytes, data->length, memory_order_relaxed);
+  return AMP_OK;
+}
+
+static blob_t *bench_receive(msg_metadata_t *meta, daemon_run_t *running, int *success, void *ctx)
+{
+  blob_t *res;
+
+  (void) ctx;
+
+  while ((res = lfq_pop(&bench_rxq)) == NULL)
+  {
+    struct timespec timeout;
+    clock_gettime(CLOCK_REALTIME, &timeout);
+    timeout.tv_nsec += 100000000;
+    if (timeout.tv_nsec >= 1000000000)
+    {
+      timeout.tv_sec += 1;
+      timeout.tv_nsec -= 1000000000;
+    }
+    sem_timedwait(&bench_rx_ready, &timeout);
+    if (!daemon_run_get(running))
+    {
+      *success = AMP_FAIL;
+      return NULL;
+    }
+  }
+
+  strncpy(meta->source.name, bench_mgr, AMP_MAX_EID_LEN - 1);
+  *success = AMP_OK;
+  return res;
+}
+
+static double bench_now()
+{
+  return 1e-6 * utils_now_us();
+}
+
+static double bench_cpu_secs()
+{
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec
+      + 1e-6 * (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+}
+
+static ari_t *bench_ctrl(amp_uvast id)
+{
+  return adm_build_ari(AMP_TYPE_CTRL, true, g_amp_agent_idx[ADM_CTRL_IDX], id);
+}
+
+static tnv_t *bench_tv_ms(unsigned ms)
+{
+  amp_tv_t tv = { .secs = OS_TimeFromTotalMilliseconds(ms) };
+  return tnv_from_tv(tv);
+}
+
+/* A gen_rpts of count EDDs starting at first, sent to the manager. */
+static ari_t *bench_gen_rpts_ctrl(size_t first, size_t count)
+{
+  ari_t *ctrl = bench_ctrl(AMP_AGENT_CTRL_GEN_RPTS);
+  ac_t *ids = ac_create();
+  tnvc_t *mgrs = tnvc_create(1);
+
+  for (size_t ix = 0; ix < count; ++ix)
+  {
+    ac_insert(ids, adm_build_ari(AMP_TYPE_EDD, false, BENCH_NN, BENCH_EDD_BASE + ((first + ix) % bench_edds)));
+  }
+  tnvc_insert_str(mgrs, bench_mgr);
+  ari_add_parm_val(ctrl, tnv_from_obj(AMP_TYPE_AC, ids));
+  ari_add_parm_val(ctrl, tnv_from_obj(AMP_TYPE_TNVC, mgrs));
+  return ctrl;
+}
+
+/* A gen_tbls of the agent's own latency table. */
+static ari_t *bench_gen_tbls_ctrl()
+{
+  ari_t *ctrl = bench_ctrl(AMP_AGENT_CTRL_GEN_TBLS);
+  ac_t *ids = ac_create();
+  tnvc_t *mgrs = tnvc_create(1);
+
+  ac_insert(ids, adm_build_ari(AMP_TYPE_TBLT, false, g_amp_agent_idx[ADM_TBLT_IDX], AMP_AGENT_TBLT_LATENCIES));
+  tnvc_insert_str(mgrs, bench_mgr);
+  ari_add_parm_val(ctrl, tnv_from_obj(AMP_TYPE_AC, ids));
+  ari_add_parm_val(ctrl, tnv_from_obj(AMP_TYPE_TNVC, mgrs));
+  return ctrl;
+}
+
+static ari_t *bench_add_tbr_ctrl(size_t idx)
+{
+  ari_t *ctrl = bench_ctrl(AMP_AGENT_CTRL_ADD_TBR);
+  ac_t *action = ac_create();
+
+  ac_insert(action, bench_gen_rpts_ctrl(idx * bench_edds_per_rule, bench_edds_per_rule));
+  ari_add_parm_val(ctrl, tnv_from_obj(AMP_TYPE_ARI, adm_build_ari(AMP_TYPE_TBR, false, BENCH_NN, BENCH_RULE_BASE + idx)));
+  ari_add_parm_val(ctrl, bench_tv_ms(0));
+  ari_add_parm_val(ctrl, bench_tv_ms(bench_period_ms));
+  ari_add_parm_val(ctrl, tnv_from_uvast(0));
+  ari_add_parm_val(ctrl, tnv_from_obj(AMP_TYPE_AC, action));
+  return ctrl;
+}
+
+/* An SBR whose state is one EDD, which is never zero, so it always fires. */
+static ari_t *bench_add_sbr_ctrl(size_t idx)
+{
+  ari_t *ctrl = bench_ctrl(AMP_AGENT_CTRL_ADD_SBR);
+  ac_t *action = ac_create();
+  expr_t *state = expr_create(AMP_TYPE_UVAST);
+
+  expr_add_item(state, adm_build_ari(AMP_TYPE_EDD, false, BENCH_NN, BENCH_EDD_BASE + (idx % bench_edds)));
+  ac_insert(action, bench_gen_rpts_ctrl(idx * bench_edds_per_rule, bench_edds_per_rule));
+  ari_add_parm_val(ctrl, tnv_from_obj(AMP_TYPE_ARI, adm_build_ari(AMP_TYPE_SBR, false, BENCH_NN, BENCH_RULE_BASE + bench_tbrs + idx)));
+  ari_add_parm_val(ctrl, bench_tv_ms(0));
+  ari_add_parm_val(ctrl, tnv_from_obj(AMP_TYPE_EXPR, state));
+  ari_add_parm_val(ctrl, tnv_from_uvast(0));
+  ari_add_parm_val(ctrl, tnv_from_uvast(0));
+  ari_add_parm_val(ctrl, tnv_from_obj(AMP_TYPE_AC, action));
+  return ctrl;
+}
+
+/* Queues one perform-control message holding all of ctrls for the agent. */
+static int bench_inject(ac_t *ctrls)
+{
+  msg_ctrl_t *msg = msg_ctrl_create();
+  blob_t *data;
+
+  CHKUSR(msg, AMP_FAIL);
+  msg->ac = ctrls;
+  msg->start = AMP_TV_ZERO;
+  data = mif_serialize_msg(MSG_TYPE_PERF_CTRL, msg, AMP_TV_ZERO);
+  msg_ctrl_release(msg, 1);
+  CHKUSR(data, AMP_FAIL);
+
+  if (!lfq_push(&bench_rxq, data))
+  {
+    blob_release(data, 1);
+    return AMP_FAIL;
+  }
+  sem_post(&bench_rx_ready);
+  return AMP_OK;
+}
+
+/* Adds all rules, a message at a time, and waits for the agent to have them. */
+static int bench_add_rules()
+{
+  size_t total = bench_tbrs + bench_sbrs;
+  ac_t *ctrls = NULL;
+  double deadline;
+
+  for (size_t ix = 0; ix < total; ++ix)
+  {
+    if ((ctrls == NULL) && ((ctrls = ac_create()) == NULL))
+    {
+      return AMP_FAIL;
+    }
+    ac_insert(ctrls, (ix < bench_tbrs) ? bench_add_tbr_ctrl(ix) : bench_add_sbr_ctrl(ix - bench_tbrs));
+    if ((ac_get_count(ctrls) >= BENCH_CTRLS_PER_MSG) || (ix + 1 == total))
+    {
+      if (bench_inject(ctrls) != AMP_OK)
+      {
+        return AMP_FAIL;
+      }
+      ctrls = NULL;
+    }
+  }
+
+  deadline = bench_now() + BENCH_SETUP_SECS;
+  while ((agent_instr_get(AGENT_INSTR_TBRS) < bench_tbrs) || (agent_instr_get(AGENT_INSTR_SBRS) < bench_sbrs))
+  {
+    if (bench_now() > deadline)
+    {
+      fprintf(stderr, "Agent has %" PRIu64 " TBRs and %" PRIu64 " SBRs after %d s\n",
+              agent_instr_get(AGENT_INSTR_TBRS), agent_instr_get(AGENT_INSTR_SBRS), BENCH_SETUP_SECS);
+      return AMP_FAIL;
+    }
+    OS_TaskDelay(10);
+  }
+  return AMP_OK;
+}
+
+static int bench_burst()
+{
+  ac_t *ctrls = ac_create();
+
+  CHKUSR(ctrls, AMP_FAIL);
+  for (size_t ix = 0; ix < bench_gen_rpts; ++ix)
+  {
+    ac_insert(ctrls, bench_gen_rpts_ctrl(0, bench_edds));
+  }
+  for (size_t ix = 0; ix < bench_gen_tbls; ++ix)
+  {
+    ac_insert(ctrls, bench_gen_tbls_ctrl());
+  }
+  if (ac_get_count(ctrls) == 0)
+  {
+    ac_release(ctrls, 1);
+    return AMP_OK;
+  }
+  return bench_inject(ctrls);
+}
+
+static void bench_write(FILE *out, double secs, double cpu_secs, uint64_t bursts)
+{
+  const uint64_t rpts = agent_instr_get(AGENT_INSTR_SENT_RPTS);
+  const uint64_t tbls = agent_instr_get(AGENT_INSTR_SENT_TBLS);
+  struct rusage usage;
+
+  getrusage(RUSAGE_SELF, &usage);
+
+  fprintf(out, "{\n  \"config\": {\"edds\": %zu, \"tbrs\": %zu, \"sbrs\": %zu, \"edds_per_rule\": %zu, "
+          "\"period_ms\": %u, \"gen_rpts\": %zu, \"gen_tbls\": %zu, \"burst_ms\": %u, \"duration\": %g},\n",
+          bench_edds, bench_tbrs, bench_sbrs, bench_edds_per_rule,
+          bench_period_ms, bench_gen_rpts, bench_gen_tbls, bench_burst_ms, bench_duration);
+  fprintf(out, "  \"secs\": %.3f,\n  \"bursts\": %" PRIu64 ",\n", secs, bursts);
+  fprintf(out, "  \"reports\": %" PRIu64 ",\n  \"tables\": %" PRIu64 ",\n", rpts, tbls);
+  fprintf(out, "  \"reports_per_sec\": %.1f,\n", rpts / secs);
+  fprintf(out, "  \"tbrs_run\": %" PRIu64 ",\n  \"sbrs_run\": %" PRIu64 ",\n  \"ctrls_run\": %" PRIu64 ",\n",
+          agent_instr_get(AGENT_INSTR_TBRS_RUN), agent_instr_get(AGENT_INSTR_SBRS_RUN),
+          agent_instr_get(AGENT_INSTR_CTRLS_RUN));
+  fprintf(out, "  \"messages_sent\": %" PRIu64 ",\n  \"bytes_sent\": %" PRIu64 ",\n",
+          atomic_load(&bench_tx_msgs), atomic_load(&bench_tx_bytes));
+  fprintf(out, "  \"cpu_secs\": %.3f,\n  \"cpu_us_per_report\": %.2f,\n",
+          cpu_secs, (rpts > 0) ? (1e6 * cpu_secs / rpts) : 0.0);
+  fprintf(out, "  \"peak_rss_kb\": %ld,\n", usage.ru_maxrss);
+
+  fprintf(out, "  \"latencies_us\": {");
+  for (int lat = 0; lat < AGENT_INSTR_NUM_LATS; ++lat)
+  {
+    agent_instr_lat_t sum;
+    agent_instr_lat_get(lat, &sum);
+    fprintf(out, "%s\n    \"%s\": {\"count\": %" PRIu64 ", \"mean\": %.1f, \"p50\": %" PRIu64
+            ", \"p90\": %" PRIu64 ", \"p99\": %" PRIu64 ", \"max\": %" PRIu64 "}",
+            (lat > 0) ? "," : "", agent_instr_lat_name(lat), sum.count,
+            (sum.count > 0) ? ((double)sum.total_us / sum.count) : 0.0,
+            sum.p50_us, sum.p90_us, sum.p99_us, sum.max_us);
+  }
+  fprintf(out, "\n  }\n}\n");
+}
+
+static size_t bench_arg_size(const char *arg)
+{
+  long val = strtol(arg, NULL, 10);
+  if (val < 0)
+  {
+    fprintf(stderr, "Counts must not be negative\n");
+    OS_ApplicationExit(-1);
+  }
+  return val;
+}
+
+void OS_Application_Startup()
+{
+  if (OS_API_Init() != OS_SUCCESS)
+  {
+    fprintf(stderr, "Failed OS_API_Init\n");
+    OS_ApplicationExit(-1);
+  }
+
+  const int argc = OS_BSP_GetArgC();
+  char *const *argv = OS_BSP_GetArgV();
+  int c;
+  while ((c = getopt(argc, argv, "m:n:s:k:p:b:g:i:d:o:")) != -1)
+  {
+    switch (c)
+    {
+      case 'm':
+        bench_edds = bench_arg_size(optarg);
+        break;
+      case 'n':
+        bench_tbrs = bench_arg_size(optarg);
+        break;
+      case 's':
+        bench_sbrs = bench_arg_size(optarg);
+        break;
+      case 'k':
+        bench_edds_per_rule = bench_arg_size(optarg);
+        break;
+      case 'p':
+        bench_period_ms = bench_arg_size(optarg);
+        break;
+      case 'b':
+        bench_gen_rpts = bench_arg_size(optarg);
+        break;
+      case 'g':
+        bench_gen_tbls = bench_arg_size(optarg);
+        break;
+      case 'i':
+        bench_burst_ms = bench_arg_size(optarg);
+        break;
+      case 'd':
+        bench_duration = atof(optarg);
+        break;
+      case 'o':
+        bench_out = optarg;
+        break;
+      default:
+        fprintf(stderr, "Usage: bench_agent [-m <edds>] [-n <tbrs>] [-s <sbrs>] [-k <edds/rule>] [-p <period ms>]"
+                " [-b <gen_rpts/burst>] [-g <gen_tbls/burst>] [-i <burst ms>] [-d <secs>] [-o <file>]\n");
+        OS_ApplicationExit(-1);
+    }
+  }
+  if ((bench_edds == 0) || (bench_period_ms == 0) || (bench_burst_ms == 0) || (bench_duration <= 0))
+  {
+    fprintf(stderr, "EDDs, periods and duration must be positive\n");
+    OS_ApplicationExit(-1);
+  }
+
+  if ((lfq_init(&bench_rxq, BENCH_QUEUE_LEN) != AMP_OK) || sem_init(&bench_rx_ready, 0, 0))
+  {
+    OS_ApplicationExit(EXIT_FAILURE);
+  }
+
+  if (!nmagent_init(&agent))
+  {
+    OS_ApplicationExit(EXIT_FAILURE);
+  }
+  agent.mif.send = bench_send;
+  agent.mif.receive = bench_receive;
+
+  agent_instr_init();
+  amp_agent_init();
+  for (size_t ix = 0; ix < bench_edds; ++ix)
+  {
+    if (adm_add_edd(adm_build_ari(AMP_TYPE_EDD, false, BENCH_NN, BENCH_EDD_BASE + ix), bench_edd) != AMP_OK)
+    {
+      fprintf(stderr, "Failed to define EDD %zu\n", ix);
+      OS_ApplicationExit(EXIT_FAILURE);
+    }
+  }
+
+  if (!nmagent_start(&agent))
+  {
+    OS_ApplicationExit(2);
+  }
+}
+
+void OS_Application_Run()
+{
+  FILE *out = stdout;
+  int status = EXIT_SUCCESS;
+  uint64_t bursts = 0;
+  blob_t *left;
+
+  if (bench_add_rules() != AMP_OK)
+  {
+    status = EXIT_FAILURE;
+  }
+  else
+  {
+    // Count only the steady state, but keep the rule gauges
+    agent_instr_clear();
+
+    const double cpu_start = bench_cpu_secs();
+    const double start = bench_now();
+    double next = start;
+    double stop = start + bench_duration;
+    double now;
+
+    while ((now = bench_now()) < stop)
+    {
+      if (now >= next)
+      {
+        if (bench_burst() == AMP_OK)
+        {
+          ++bursts;
+        }
+        next += bench_burst_ms * 1e-3;
+        continue;
+      }
+      OS_TaskDelay((uint32_t)(1e3 * (next - now)) + 1);
+    }
+
+    const double secs = bench_now() - start;
+    const double cpu_secs = bench_cpu_secs() - cpu_start;
+
+    if ((bench_out != NULL) && ((out = fopen(bench_out, "w")) == NULL))
+    {
+      fprintf(stderr, "Cannot open %s\n", bench_out);
+      out = stdout;
+      status = EXIT_FAILURE;
+    }
+    bench_write(out, secs, cpu_secs, bursts);
+    if (out != stdout)
+    {
+      fclose(out);
+    }
+  }
+
+  nmagent_stop(&agent);
+  while ((left = lfq_pop(&bench_rxq)) != NULL)
+  {
+    blob_release(left, 1);
+  }
+  lfq_destroy(&bench_rxq);
+  sem_destroy(&bench_rx_ready);
+
+  nmagent_destroy(&agent);
+  adm_common_destroy();
+  db_destroy();
+  utils_mem_teardown();
+  OS_BSP_SetExitCode(status);
+}
@@ -0,0 +1,66 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2023 The Johns Hopkins University Applied Physics
+# Laboratory LLC.
+#
+# This file is part of the Delay-Tolerant Networking Management
+# Architecture (DTNMA) Tools package.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#     http://www.apache.org/licenses/LICENSE-2.0
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+''' Compare two bench_prims JSON results and flag regressions.
+
+The exit code is non-zero if any benchmark in both results got slower by
+more than the threshold, so this can gate a build.
+'''
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path, 'r') as infile:
+        doc = json.load(infile)
+    return {
+        (res['name'], res['size']): res['ns_per_op']
+        for res in doc['results']
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('base', help='Results of the baseline commit')
+    parser.add_argument('new', help='Results of the commit under test')
+    parser.add_argument('--threshold', type=float, default=10.0,
+                        help='Slowdown, in percent, counted as a regression')
+    args = parser.parse_args()
+
+    base = load(args.base)
+    new = load(args.new)
+
+    regressions = 0
+    print(f'{"benchmark":28} {"size":>6} {"base ns":>12} {"new ns":>12} {"change":>8}')
+    for key in sorted(base.keys() & new.keys()):
+        change = 100.0 * (new[key] - base[key]) / base[key]
+        flag = ''
+        if change > args.threshold:
+            flag = ' REGRESSION'
+            regressions += 1
+        print(f'{key[0]:28} {key[1]:6} {base[key]:12.1f} {new[key]:12.1f} {change:+7.1f}%{flag}')
+
+    for key in sorted(base.keys() ^ new.keys()):
+        print(f'{key[0]:28} {key[1]:6} only in {"base" if key in base else "new"}')
+
+    return 1 if regressions else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
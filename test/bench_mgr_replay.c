@@ -0,0 +1,668 @@
+/*
+ * Copyright (c) 2023 The Johns Hopkins University Applied Physics
+ * Laboratory LLC.
+ *
+ * This file is part of the Delay-Tolerant Networking Management
+ * Architecture (DTNMA) Tools package.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/** @file
+ * Replays captured message groups into the manager's receive path.
+ *
+ * Input is either text with one group per line, as the manager writes it
+ * to stdout ("RX from <eid>: msgs:<hex>") or to agent logs with rx_cbor
+ * ("RX: msgs:<hex>"), or a binary capture. All input is loaded before the
+ * replay starts, so parsing it is not measured. Groups are then handed to
+ * the unmodified manager receive thread through a messaging interface
+ * which paces them, with the log writer and, when built in, the SQL
+ * writer and REST server running as usual.
+ *
+ * The binary capture is the magic "NMRX" followed by records of a
+ * big-endian 64-bit receive time in microseconds, 16-bit EID length and
+ * 32-bit group length, then the EID and group bytes. Text input can be
+ * converted to it with -w, with times assigned at the -r rate.
+ *
+ * Usage: bench_mgr_replay [-e <eid>] [-a <copies>] [-n <loops>]
+ *                         [-r <groups/s> | -x <speed>] [-t <workers>]
+ *                         [-l] [-D <dir>] [-W] [-w <capture>] [-o <file>]
+ *                         <input>
+ *
+ * With -t, groups are processed by that many receive workers, from 1 to
+ * MGR_RX_MAX_WORKERS, sharded by source EID, and -a spreads a capture from
+ * one agent across several.
+ *
+ * Debugging builds of the manager echo each group to stdout, so the report
+ * goes to the -o file or to stderr.
+ */
+#include <osapi-common.h>
+#include <osapi-bsp.h>
+#include <shared/nm.h>
+#include <shared/adm/adm.h>
+#include <shared/primitives/blob.h>
+#include <shared/utils/utils.h>
+#include <mgr/agents.h>
+#include <mgr/nm_mgr_log.h>
+#include <mgr/nm_mgr_metrics.h>
+#include <mgr/nm_mgr_rx.h>
+#include <mgr/nmmgr.h>
+#ifdef USE_CIVETWEB
+#include <mgr/nm_rest.h>
+#endif
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+
+/// Magic at the start of a binary capture
+#define REPLAY_MAGIC "NMRX"
+/// Most distinct source EIDs in the input
+#define REPLAY_MAX_SOURCES 1024
+
+/** One captured group.
+ */
+typedef struct {
+  /// Receive time, for binary captures
+  uint64_t time_us;
+  /// Index into ::replay_sources
+  size_t source;
+  blob_t *data;
+} replay_rec_t;
+
+static nmmgr_t mgr;
+
+static const char *replay_def_eid = "ipn:2.1";
+static size_t replay_copies = 1;
+static size_t replay_loops = 1;
+static double replay_rate = 0;
+static double replay_speed = 0;
+static int replay_rest = 0;
+static size_t replay_workers = 0;
+static const char *replay_capture = NULL;
+static const char *replay_out = NULL;
+
+static replay_rec_t *replay_recs = NULL;
+static size_t replay_num_recs = 0;
+static eid_t replay_sources[REPLAY_MAX_SOURCES];
+static size_t replay_num_sources = 0;
+/// Source EID of each copy of each source, indexed by source then copy
+static eid_t *replay_eids = NULL;
+
+/* State of the receive callback, only used from the receive thread. */
+static size_t replay_next = 0;
+static size_t replay_total = 0;
+static uint64_t replay_start_us = 0;
+static uint64_t replay_handed_us = 0;
+static uint64_t replay_end_us = 0;
+/// Time between handing a group to the receive thread and its next receive
+static mgr_metrics_hist_t replay_group_us;
+
+
+static size_t replay_source(const char *name, size_t len)
+{
+  size_t idx;
+
+  if (len >= AMP_MAX_EID_LEN)
+  {
+    len = AMP_MAX_EID_LEN - 1;
+  }
+  for (idx = 0; idx < replay_num_sources; ++idx)
+  {
+    if ((strncmp(replay_sources[idx].name, name, len) == 0) && (replay_sources[idx].name[len] == '\0'))
+    {
+      return idx;
+    }
+  }
+  if (replay_num_sources == REPLAY_MAX_SOURCES)
+  {
+    fprintf(stderr, "More than %d source EIDs\n", REPLAY_MAX_SOURCES);
+    OS_ApplicationExit(EXIT_FAILURE);
+  }
+  memcpy(replay_sources[idx].name, name, len);
+  replay_sources[idx].name[len] = '\0';
+  return replay_num_sources++;
+}
+
+static void replay_add(uint64_t time_us, size_t source, blob_t *data)
+{
+  static size_t alloc = 0;
+
+  if (replay_num_recs == alloc)
+  {
+    alloc = (alloc > 0) ? (2 * alloc) : 1024;
+    if ((replay_recs = realloc(replay_recs, alloc * sizeof(replay_rec_t))) == NULL)
+    {
+      fprintf(stderr, "Cannot hold %zu groups\n", alloc);
+      OS_ApplicationExit(EXIT_FAILURE);
+    }
+  }
+  replay_recs[replay_num_recs++] = (replay_rec_t){ time_us, source, data };
+}
+
+static int replay_load_text(FILE *in)
+{
+  const size_t def_src = replay_source(replay_def_eid, strlen(replay_def_eid));
+  char *line = NULL;
+  size_t line_len = 0;
+  ssize_t got;
+
+  while ((got = getline(&line, &line_len, in)) >= 0)
+  {
+    char *hex = strstr(line, "msgs:");
+    char *from = strstr(line, "RX from ");
+    size_t source = def_src;
+    blob_t *data;
+
+    if (hex == NULL)
+    {
+      continue;
+    }
+    if ((from != NULL) && (from < hex) && (hex - from > 10) && (strncmp(hex - 2, ": ", 2) == 0))
+    {
+      from += strlen("RX from ");
+      source = replay_source(from, (hex - 2) - from);
+    }
+    hex += strlen("msgs:");
+    hex[strcspn(hex, " \t\r\n")] = '\0';
+
+    if ((*hex == '\0') || ((data = utils_string_to_hex(hex)) == NULL))
+    {
+      continue;
+    }
+    replay_add(0, source, data);
+  }
+  free(line);
+  return AMP_OK;
+}
+
+static int replay_read_be(FILE *in, size_t size, uint64_t *val)
+{
+  uint8_t buf[8];
+
+  if (fread(buf, 1, size, in) != size)
+  {
+    return AMP_FAIL;
+  }
+  *val = 0;
+  for (size_t ix = 0; ix < size; ++ix)
+  {
+    *val = (*val << 8) | buf[ix];
+  }
+  return AMP_OK;
+}
+
+static void replay_write_be(FILE *out, size_t size, uint64_t val)
+{
+  uint8_t buf[8];
+
+  for (size_t ix = size; ix > 0; --ix)
+  {
+    buf[ix - 1] = val & 0xFF;
+    val >>= 8;
+  }
+  fwrite(buf, 1, size, out);
+}
+
+static int replay_load_capture(FILE *in)
+{
+  uint64_t time_us;
+
+  while (replay_read_be(in, 8, &time_us) == AMP_OK)
+  {
+    uint64_t eid_len;
+    uint64_t len;
+    char eid[AMP_MAX_EID_LEN];
+    blob_t *data;
+
+    if ((replay_read_be(in, 2, &eid_len) != AMP_OK) || (replay_read_be(in, 4, &len) != AMP_OK)
+        || (eid_len >= AMP_MAX_EID_LEN) || (fread(eid, 1, eid_len, in) != eid_len))
+    {
+      return AMP_FAIL;
+    }
+    if ((data = blob_create(NULL, 0, len)) == NULL)
+    {
+      return AMP_SYSERR;
+    }
+    if (fread(data->value, 1, len, in) != len)
+    {
+      blob_release(data, 1);
+      return AMP_FAIL;
+    }
+    data->length = len;
+    replay_add(time_us, replay_source(eid, eid_len), data);
+  }
+  return AMP_OK;
+}
+
+static int replay_load(const char *path)
+{
+  char magic[4];
+  FILE *in;
+  int res;
+
+  if ((in = fopen(path, "rb")) == NULL)
+  {
+    fprintf(stderr, "Cannot open %s\n", path);
+    return AMP_FAIL;
+  }
+  if ((fread(magic, 1, sizeof(magic), in) == sizeof(magic)) && (memcmp(magic, REPLAY_MAGIC, sizeof(magic)) == 0))
+  {
+    res = replay_load_capture(in);
+  }
+  else
+  {
+    rewind(in);
+    res = replay_load_text(in);
+  }
+  fclose(in);
+
+  if (res != AMP_OK)
+  {
+    fprintf(stderr, "Capture %s is truncated or corrupt\n", path);
+  }
+  return res;
+}
+
+static int replay_write_capture(const char *path)
+{
+  const double rate = (replay_rate > 0) ? replay_rate : 1;
+  FILE *out;
+
+  if ((out = fopen(path, "wb")) == NULL)
+  {
+    fprintf(stderr, "Cannot open %s\n", path);
+    return AMP_FAIL;
+  }
+  fwrite(REPLAY_MAGIC, 1, strlen(REPLAY_MAGIC), out);
+  for (size_t ix = 0; ix < replay_num_recs; ++ix)
+  {
+    const replay_rec_t *rec = &(replay_recs[ix]);
+    const char *eid = replay_sources[rec->source].name;
+    const uint64_t time_us = (rec->time_us > 0) ? rec->time_us : (uint64_t)(ix * 1e6 / rate);
+
+    replay_write_be(out, 8, time_us);
+    replay_write_be(out, 2, strlen(eid));
+    replay_write_be(out, 4, rec->data->length);
+    fwrite(eid, 1, strlen(eid), out);
+    fwrite(rec->data->value, 1, rec->data->length, out);
+  }
+  return (fclose(out) == 0) ? AMP_OK : AMP_FAIL;
+}
+
+/* Each copy of each source gets its own agent, so copies are stored apart. */
+static int replay_add_agents()
+{
+  if ((replay_eids = calloc(replay_num_sources * replay_copies, sizeof(eid_t))) == NULL)
+  {
+    return AMP_SYSERR;
+  }
+  for (size_t src = 0; src < replay_num_sources; ++src)
+  {
+    for (size_t copy = 0; copy < replay_copies; ++copy)
+    {
+      eid_t *eid = &(replay_eids[src * replay_copies + copy]);
+      if (replay_copies > 1)
+      {
+        snprintf(eid->name, AMP_MAX_EID_LEN, "%s#%zu", replay_sources[src].name, copy);
+      }
+      else
+      {
+        *eid = replay_sources[src];
+      }
+      if (agent_get(eid) == NULL)
+      {
+        agent_add(*eid);
+      }
+    }
+  }
+  return AMP_OK;
+}
+
+/* When the next delivery should happen, relative to the start. */
+static uint64_t replay_offset_us(size_t idx)
+{
+  const size_t per_loop = replay_num_recs * replay_copies;
+  const replay_rec_t *rec = &(replay_recs[(idx % per_loop) / replay_copies]);
+
+  if (replay_rate > 0)
+  {
+    return idx * 1e6 / replay_rate;
+  }
+  if (replay_speed > 0)
+  {
+    const uint64_t first = replay_recs[0].time_us;
+    const uint64_t span = replay_recs[replay_num_recs - 1].time_us - first;
+    return ((idx / per_loop) * span + (rec->time_us - first)) / replay_speed;
+  }
+  return 0;
+}
+
+static blob_t *replay_receive(msg_metadata_t *meta, daemon_run_t *running, int *success, void *ctx)
+{
+  uint64_t now = utils_now_us();
+  const replay_rec_t *rec;
+  size_t within;
+  uint64_t due;
+
+  (void) ctx;
+
+  if (replay_next == 0)
+  {
+    replay_start_us = now;
+  }
+  else
+  {
+    mgr_metrics_hist_record(&replay_group_us, now - replay_handed_us);
+  }
+  if ((replay_next >= replay_total) || !daemon_run_get(running))
+  {
+    // Stopping the receive thread stops the manager
+    replay_end_us = now;
+    *success = AMP_FAIL;
+    return NULL;
+  }
+
+  due = replay_start_us + replay_offset_us(replay_next);
+  while (now < due)
+  {
+    struct timespec wait = { .tv_sec = (due - now) / 1000000, .tv_nsec = ((due - now) % 1000000) * 1000 };
+    nanosleep(&wait, NULL);
+    now = utils_now_us();
+  }
+
+  within = replay_next % (replay_num_recs * replay_copies);
+  rec = &(replay_recs[within / replay_copies]);
+  meta->source = replay_eids[rec->source * replay_copies + (within % replay_copies)];
+  ++replay_next;
+
+  // The receive thread releases what it is given
+  replay_handed_us = utils_now_us();
+  *success = AMP_OK;
+  return blob_copy_ptr(rec->data);
+}
+
+/* Resident set size in kilobytes. */
+static long replay_rss_kb()
+{
+  long pages = 0;
+  FILE *statm = fopen("/proc/self/statm", "r");
+
+  if (statm != NULL)
+  {
+    if (fscanf(statm, "%*s %ld", &pages) != 1)
+    {
+      pages = 0;
+    }
+    fclose(statm);
+  }
+  return pages * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+/* A quantile from a histogram, as the upper bound of its bucket. */
+static uint64_t replay_quantile(mgr_metrics_hist_t *hist, double q)
+{
+  const uint64_t count = atomic_load(&(hist->count));
+  uint64_t cumul = 0;
+
+  for (int ix = 0; ix < MGR_METRICS_HIST_BUCKETS; ++ix)
+  {
+    cumul += atomic_load(&(hist->buckets[ix]));
+    if ((count > 0) && (cumul >= q * count))
+    {
+      return 1ULL << ix;
+    }
+  }
+  return (count > 0) ? (1ULL << MGR_METRICS_HIST_BUCKETS) : 0;
+}
+
+static void replay_write_hist(FILE *out, const char *name, mgr_metrics_hist_t *hist, int last)
+{
+  const uint64_t count = atomic_load(&(hist->count));
+
+  fprintf(out, "    \"%s\": {\"count\": %" PRIu64 ", \"mean\": %.1f, \"p50\": %" PRIu64
+          ", \"p90\": %" PRIu64 ", \"p99\": %" PRIu64 "}%s\n",
+          name, count, (count > 0) ? ((double)atomic_load(&(hist->sum)) / count) : 0.0,
+          replay_quantile(hist, 0.5), replay_quantile(hist, 0.9), replay_quantile(hist, 0.99),
+          last ? "" : ",");
+}
+
+static void replay_write(FILE *out, long rss_start_kb, long rss_end_kb)
+{
+  const double secs = (replay_end_us - replay_start_us) * 1e-6;
+  const uint64_t groups = atomic_load(&(gMgrMetrics.rx_groups));
+  const uint64_t bytes = atomic_load(&(gMgrMetrics.rx_bytes));
+  struct rusage usage;
+
+  getrusage(RUSAGE_SELF, &usage);
+
+  fprintf(out, "{\n  \"captured_groups\": %zu,\n  \"sources\": %zu,\n  \"copies\": %zu,\n  \"loops\": %zu,\n",
+          replay_num_recs, replay_num_sources, replay_copies, replay_loops);
+  fprintf(out, "  \"rx_workers\": %zu,\n", replay_workers);
+  fprintf(out, "  \"secs\": %.3f,\n  \"groups\": %" PRIu64 ",\n  \"bytes\": %" PRIu64 ",\n", secs, groups, bytes);
+  fprintf(out, "  \"groups_per_sec\": %.1f,\n  \"bytes_per_sec\": %.1f,\n",
+          (secs > 0) ? (groups / secs) : 0.0, (secs > 0) ? (bytes / secs) : 0.0);
+  fprintf(out, "  \"invalid_groups\": %" PRIu64 ",\n  \"dropped\": %" PRIu64 ",\n",
+          atomic_load(&(gMgrMetrics.rx_invalid)), atomic_load(&(gMgrMetrics.rx_dropped)));
+  fprintf(out, "  \"stored_reports\": %" PRIu64 ",\n  \"stored_tables\": %" PRIu64 ",\n",
+          (uint64_t)gMgrDB.tot_rpts, (uint64_t)gMgrDB.tot_tbls);
+  fprintf(out, "  \"log_dropped\": %" PRIu64 ",\n", (uint64_t)mgr_log_dropped());
+  fprintf(out, "  \"rss_start_kb\": %ld,\n  \"rss_end_kb\": %ld,\n  \"rss_growth_kb\": %ld,\n  \"peak_rss_kb\": %ld,\n",
+          rss_start_kb, rss_end_kb, rss_end_kb - rss_start_kb, usage.ru_maxrss);
+  fprintf(out, "  \"latencies_us\": {\n");
+  replay_write_hist(out, "group", &replay_group_us, 0);
+  replay_write_hist(out, "decode", &(gMgrMetrics.decode_us), 0);
+  replay_write_hist(out, "sql_insert", &(gMgrMetrics.sql_insert_us), 1);
+  fprintf(out, "  }\n}\n");
+}
+
+static void replay_cleanup()
+{
+  for (size_t ix = 0; ix < replay_num_recs; ++ix)
+  {
+    blob_release(replay_recs[ix].data, 1);
+  }
+  free(replay_recs);
+  free(replay_eids);
+  nmmgr_destroy(&mgr);
+}
+
+static void replay_usage()
+{
+  fprintf(stderr, "Usage: bench_mgr_replay [-e <eid>] [-a <copies>] [-n <loops>] [-r <groups/s> | -x <speed>] [-t <workers>]"
+          " [-l] [-D <dir>] [-W] [-w <capture>] [-o <file>]"
+#if defined(HAVE_MYSQL) || defined(HAVE_POSTGRESQL)
+          " [-s <sql host>] [-u <sql user>] [-p <sql pass>] [-S <sql db>]"
+#endif
+          " <input>\n");
+  OS_ApplicationExit(EXIT_FAILURE);
+}
+
+void OS_Application_Startup()
+{
+  if (OS_API_Init() != OS_SUCCESS)
+  {
+    fprintf(stderr, "Failed OS_API_Init\n");
+    OS_ApplicationExit(-1);
+  }
+
+  const int argc = OS_BSP_GetArgC();
+  char *const *argv = OS_BSP_GetArgV();
+#if defined(HAVE_MYSQL) || defined(HAVE_POSTGRESQL)
+  sql_db_t sql_info;
+  memset(&sql_info, 0, sizeof(sql_info));
+#endif
+  int c;
+
+  while ((c = getopt(argc, argv, "e:a:n:r:x:t:lD:Ww:o:s:u:p:S:")) != -1)
+  {
+    switch (c)
+    {
+      case 'e':
+        replay_def_eid = optarg;
+        break;
+      case 'a':
+        replay_copies = strtoul(optarg, NULL, 10);
+        break;
+      case 'n':
+        replay_loops = strtoul(optarg, NULL, 10);
+        break;
+      case 'r':
+        replay_rate = atof(optarg);
+        break;
+      case 'x':
+        replay_speed = atof(optarg);
+        break;
+      case 't':
+        if ((replay_workers = strtoul(optarg, NULL, 10)) == 0)
+        {
+          replay_usage();
+        }
+        break;
+      case 'l':
+        agent_log_cfg.enabled = 1;
+        agent_log_cfg.rx_rpt = 1;
+        agent_log_cfg.rx_tbl = 1;
+        break;
+      case 'D':
+        strncpy(agent_log_cfg.dir, optarg, sizeof(agent_log_cfg.dir) - 1);
+        break;
+      case 'W':
+        replay_rest = 1;
+        break;
+      case 'w':
+        replay_capture = optarg;
+        break;
+      case 'o':
+        replay_out = optarg;
+        break;
+#if defined(HAVE_MYSQL) || defined(HAVE_POSTGRESQL)
+      case 's':
+        strncpy(sql_info.server, optarg, UI_SQL_SERVERLEN - 1);
+        break;
+      case 'u':
+        strncpy(sql_info.username, optarg, UI_SQL_ACCTLEN - 1);
+        break;
+      case 'p':
+        strncpy(sql_info.password, optarg, UI_SQL_ACCTLEN - 1);
+        break;
+      case 'S':
+        strncpy(sql_info.database, optarg, UI_SQL_DBLEN - 1);
+        break;
+#endif
+      default:
+        replay_usage();
+    }
+  }
+  if ((argc - optind != 1) || (replay_copies == 0) || (replay_loops == 0) || (replay_rate < 0) || (replay_speed < 0)
+      || (replay_workers > MGR_RX_MAX_WORKERS))
+  {
+    replay_usage();
+  }
+
+#if defined(HAVE_MYSQL) || defined(HAVE_POSTGRESQL)
+  if ((replay_capture == NULL) && (sql_info.server[0] != '\0'))
+  {
+    db_mgr_sql_init();
+    db_mgt_init(sql_info, 0, 1);
+  }
+#endif
+  if (nmmgr_init(&mgr) != AMP_OK)
+  {
+    fprintf(stderr, "Can't init Manager\n");
+    OS_ApplicationExit(EXIT_FAILURE);
+  }
+
+  if ((replay_load(argv[optind]) != AMP_OK) || (replay_num_recs == 0))
+  {
+    fprintf(stderr, "No groups to replay from %s\n", argv[optind]);
+    OS_ApplicationExit(EXIT_FAILURE);
+  }
+  if (replay_capture != NULL)
+  {
+    return;
+  }
+  replay_total = replay_num_recs * replay_copies * replay_loops;
+  mgr.mif.receive = replay_receive;
+  mgr.rx_workers = replay_workers;
+
+  if (replay_add_agents() != AMP_OK)
+  {
+    OS_ApplicationExit(EXIT_FAILURE);
+  }
+}
+
+void OS_Application_Run()
+{
+  // Everything but the interactive UI
+  threadinfo_t threadinfo[] = {
+      {&mgr_rx_thread, "nm_mgr_rx"},
+      {&mgr_log_thread, "nm_mgr_log"},
+      {NULL, NULL},
+  };
+  FILE *out = stderr;
+  int status = EXIT_SUCCESS;
+  long rss_start_kb;
+
+  if (replay_capture != NULL)
+  {
+    status = (replay_write_capture(replay_capture) == AMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+    replay_cleanup();
+    OS_BSP_SetExitCode(status);
+    return;
+  }
+
+#if defined(HAVE_MYSQL) || defined(HAVE_POSTGRESQL)
+  threadinfo[2] = (threadinfo_t){&db_mgt_daemon, "nm_mgr_db"};
+#endif
+  rss_start_kb = replay_rss_kb();
+  if (threadset_start(&mgr.threads, threadinfo, sizeof(threadinfo) / sizeof(threadinfo_t), &mgr) != AMP_OK)
+  {
+    daemon_run_stop(&mgr.running);
+    nmmgr_stop(&mgr);
+    replay_cleanup();
+    OS_BSP_SetExitCode(EXIT_FAILURE);
+    return;
+  }
+#ifdef USE_CIVETWEB
+  if (replay_rest)
+  {
+    nm_rest_start(&mgr);
+  }
+#endif
+
+  // The receive thread stops the manager after the last group
+  daemon_run_wait(&mgr.running);
+  const long rss_end_kb = replay_rss_kb();
+  nmmgr_stop(&mgr);
+  if (replay_workers > 0)
+  {
+    // The run ends when the workers have handled the last group
+    replay_end_us = utils_now_us();
+  }
+
+  if ((replay_out != NULL) && ((out = fopen(replay_out, "w")) == NULL))
+  {
+    fprintf(stderr, "Cannot open %s\n", replay_out);
+    out = stderr;
+    status = EXIT_FAILURE;
+  }
+  replay_write(out, rss_start_kb, rss_end_kb);
+  if (out != stderr)
+  {
+    fclose(out);
+  }
+
+  replay_cleanup();
+  OS_BSP_SetExitCode(status);
+}
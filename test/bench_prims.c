@@ -0,0 +1,614 @@
+/*
+ * Copyright (c) 2023 The Johns Hopkins University Applied Physics
+ * Laboratory LLC.
+ *
+ * This file is part of the Delay-Tolerant Networking Management
+ * Architecture (DTNMA) Tools package.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/** @file
+ * Microbenchmarks of the shared primitives and codecs.
+ *
+ * Each benchmark is run for every input size given, repeated until each
+ * sample takes a minimum time, and the results are written as JSON so that
+ * runs from different commits can be compared with bench_compare.py.
+ *
+ * Usage: bench_prims [-s <sizes>] [-t <secs>] [-r <reps>] [-f <filter>]
+ *                    [-l <label>] [-o <file>]
+ */
+#include <osapi-common.h>
+#include <osapi-bsp.h>
+#include <shared/adm/adm.h>
+#include <shared/msg/msg.h>
+#include <shared/primitives/expr.h>
+#include <shared/primitives/report.h>
+#include <shared/utils/rhht.h>
+#include <shared/utils/utils.h>
+#include <shared/utils/vector.h>
+#include <agent/instr.h>
+#include <agent/nmagent.h>
+#include <shared/adm/adm_amp_agent.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/// Most input sizes which can be given
+#define BENCH_MAX_SIZES 16
+/// Largest input size, as each input is held in a ::vector_t
+#define BENCH_MAX_SIZE VEC_MAX_IDX
+/// Most samples taken of each benchmark
+#define BENCH_MAX_REPS 64
+/// Entries in each report of a message group
+#define BENCH_RPT_ENTRIES 4
+/// Most literals in the summed expression, whose items include the operators
+#define BENCH_EXPR_LITS (VEC_MAX_IDX / 2)
+
+/** Inputs for all benchmarks at one size.
+ */
+typedef struct {
+  size_t size;
+  /// Rotates through the lookup keys
+  size_t next;
+
+  ari_t *ari;
+  blob_t *ari_data;
+  tnvc_t *tnvc;
+  blob_t *tnvc_data;
+  rpt_t *rpt;
+  msg_grp_t *grp;
+  blob_t *grp_data;
+  ari_t **keys;
+  /// Copies of #keys without their interned identity, as before interning
+  ari_t **plain_keys;
+  rhht_t ht;
+  vector_t vec;
+  amp_uvast *vals;
+  expr_t *expr;
+  /// The operator of #expr, whose kernel is dropped for the generic path
+  op_t *op;
+  uint8_t *bytes;
+  char *hex;
+  /// Output of the no-allocation hex codec
+  char *hex_out;
+  uint8_t *bytes_out;
+} bench_ctx_t;
+
+/** A benchmark, where one operation is a single call of #run.
+ */
+typedef struct {
+  const char *name;
+  void (*run)(bench_ctx_t *ctx);
+  /// Non-zero if one operation handles size bytes, to report throughput
+  int per_byte;
+} bench_t;
+
+static nmagent_t agent;
+
+static size_t bench_sizes[BENCH_MAX_SIZES] = { 1, 16, BENCH_MAX_SIZE };
+static size_t bench_num_sizes = 3;
+static double bench_min_time = 0.2;
+static int bench_reps = 5;
+static const char *bench_filter = NULL;
+static const char *bench_label = "";
+static const char *bench_out = NULL;
+
+
+static double bench_now()
+{
+  return 1e-6 * utils_now_us();
+}
+
+static tnvc_t *bench_tnvc(size_t num)
+{
+  tnvc_t *tnvc = tnvc_create(0);
+  for (size_t ix = 0; (tnvc != NULL) && (ix < num); ++ix)
+  {
+    if (tnvc_insert_uvast(tnvc, 1000 * ix) != AMP_OK)
+    {
+      tnvc_release(tnvc, 1);
+      return NULL;
+    }
+  }
+  return tnvc;
+}
+
+static tnv_t *bench_edd(tnvc_t *params)
+{
+  (void) params;
+  return tnv_from_uvast(0);
+}
+
+static ari_t *bench_lit(amp_uvast val)
+{
+  ari_t *ari = ari_create(AMP_TYPE_LIT);
+  tnv_init(&(ari->as_lit), AMP_TYPE_UVAST);
+  ari->as_lit.value.as_uvast = val;
+  return ari;
+}
+
+/* Sets up the inputs of one size, failing if any of them could not be
+ * filled completely, so that no benchmark runs on less than its size.
+ */
+static int bench_setup(bench_ctx_t *ctx, size_t size)
+{
+  int success;
+  vec_idx_t idx;
+
+  memset(ctx, 0, sizeof(*ctx));
+  ctx->size = size;
+
+  // A parameterized control with size parameters
+  ctx->ari = adm_build_ari(AMP_TYPE_CTRL, true, 12, 34);
+  for (size_t ix = 0; ix < size; ++ix)
+  {
+    if (ari_add_parm_val(ctx->ari, tnv_from_uvast(ix)) != AMP_OK)
+    {
+      return AMP_FAIL;
+    }
+  }
+  ctx->ari_data = ari_serialize_wrapper(ctx->ari);
+
+  ctx->tnvc = bench_tnvc(size);
+  ctx->tnvc_data = tnvc_serialize_wrapper(ctx->tnvc);
+
+  ctx->rpt = rpt_create(adm_build_ari(AMP_TYPE_RPT, false, 12, 78), OS_TimeAssembleFromMilliseconds(1000, 0), bench_tnvc(size));
+
+  // One report set of size reports, each of a few entries
+  msg_rpt_t *msg = msg_rpt_create("ipn:1.7");
+  for (size_t ix = 0; ix < size; ++ix)
+  {
+    rpt_t *rpt = rpt_create(adm_build_ari(AMP_TYPE_RPT, false, 12, 78), OS_TimeAssembleFromMilliseconds(1000, 0), bench_tnvc(BENCH_RPT_ENTRIES));
+    if (msg_rpt_add_rpt(msg, rpt) != AMP_OK)
+    {
+      rpt_release(rpt, 1);
+      msg_rpt_release(msg, 1);
+      return AMP_FAIL;
+    }
+  }
+  ctx->grp = msg_grp_create(1);
+  success = msg_grp_add_msg_rpt(ctx->grp, msg);
+  msg_rpt_release(msg, 1);
+  if (success != AMP_OK)
+  {
+    return AMP_FAIL;
+  }
+  ctx->grp_data = msg_grp_serialize_wrapper(ctx->grp);
+
+  // Hash table and vector of size distinct keys
+  ctx->keys = STAKE(size * sizeof(ari_t *));
+  ctx->plain_keys = STAKE(size * sizeof(ari_t *));
+  ctx->vals = STAKE(size * sizeof(amp_uvast));
+  ctx->ht = rhht_create(2 * size, ari_cb_comp_fn, ari_cb_hash, NULL, &success);
+  vec_uvast_init(&(ctx->vec), 0);
+  for (size_t ix = 0; (ctx->keys != NULL) && (ctx->plain_keys != NULL) && (ctx->vals != NULL) && (ix < size); ++ix)
+  {
+    ctx->keys[ix] = adm_build_ari(AMP_TYPE_EDD, false, 12, 1000 + ix);
+    ctx->vals[ix] = 1000 + ix;
+    if ((rhht_insert(&(ctx->ht), ctx->keys[ix], ctx->keys[ix], NULL) != RH_OK)
+        || (vec_uvast_add(&(ctx->vec), ctx->vals[ix], &idx) != VEC_OK))
+    {
+      return AMP_FAIL;
+    }
+
+    // Each key is also an EDD defined in the VDB, kept from earlier sizes
+    if ((VDB_FINDKEY_EDD(ctx->keys[ix]) == NULL)
+        && (adm_add_edd(adm_build_ari(AMP_TYPE_EDD, false, 12, 1000 + ix), bench_edd) != AMP_OK))
+    {
+      return AMP_FAIL;
+    }
+    if ((ctx->plain_keys[ix] = ari_copy_ptr(ctx->keys[ix])) == NULL)
+    {
+      return AMP_FAIL;
+    }
+    ctx->plain_keys[ix]->as_reg.ident = NULL;
+  }
+
+  // A sum of size literals, as many as the expression can hold
+  const size_t num_lits = MIN(size, BENCH_EXPR_LITS);
+  ctx->expr = expr_create(AMP_TYPE_UVAST);
+  if (expr_add_item(ctx->expr, bench_lit(1)) != AMP_OK)
+  {
+    return AMP_FAIL;
+  }
+  for (size_t ix = 1; ix < num_lits; ++ix)
+  {
+    if ((expr_add_item(ctx->expr, bench_lit(ix)) != AMP_OK)
+        || (expr_add_item(ctx->expr, adm_build_ari(AMP_TYPE_OPER, false, g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_PLUSUVAST)) != AMP_OK))
+    {
+      return AMP_FAIL;
+    }
+  }
+  ari_t *op_id = adm_build_ari(AMP_TYPE_OPER, false, g_amp_agent_idx[ADM_OPER_IDX], AMP_AGENT_OP_PLUSUVAST);
+  ctx->op = VDB_FINDKEY_OP(op_id);
+  ari_release(op_id, 1);
+
+  ctx->bytes = STAKE(size);
+  for (size_t ix = 0; ix < size; ++ix)
+  {
+    ctx->bytes[ix] = (uint8_t)(ix * 37);
+  }
+  ctx->hex = utils_hex_to_string(ctx->bytes, size);
+  ctx->hex_out = STAKE(2 * size + 1);
+  ctx->bytes_out = STAKE(size);
+
+  if ((ctx->ari_data == NULL) || (ctx->tnvc_data == NULL) || (ctx->rpt == NULL)
+      || (ctx->grp_data == NULL) || (ctx->keys == NULL) || (ctx->plain_keys == NULL) || (ctx->vals == NULL)
+      || (ctx->expr == NULL) || (ctx->op == NULL) || (ctx->bytes == NULL) || (ctx->hex == NULL)
+      || (ctx->hex_out == NULL) || (ctx->bytes_out == NULL))
+  {
+    return AMP_FAIL;
+  }
+  return AMP_OK;
+}
+
+static void bench_teardown(bench_ctx_t *ctx)
+{
+  ari_release(ctx->ari, 1);
+  blob_release(ctx->ari_data, 1);
+  tnvc_release(ctx->tnvc, 1);
+  blob_release(ctx->tnvc_data, 1);
+  rpt_release(ctx->rpt, 1);
+  msg_grp_release(ctx->grp, 1);
+  blob_release(ctx->grp_data, 1);
+  rhht_release(&(ctx->ht), 0);
+  vec_release(&(ctx->vec), 0);
+  for (size_t ix = 0; (ctx->keys != NULL) && (ix < ctx->size); ++ix)
+  {
+    ari_release(ctx->keys[ix], 1);
+  }
+  for (size_t ix = 0; (ctx->plain_keys != NULL) && (ix < ctx->size); ++ix)
+  {
+    ari_release(ctx->plain_keys[ix], 1);
+  }
+  SRELEASE(ctx->keys);
+  SRELEASE(ctx->plain_keys);
+  SRELEASE(ctx->vals);
+  expr_release(ctx->expr, 1);
+  SRELEASE(ctx->bytes);
+  SRELEASE(ctx->hex);
+  SRELEASE(ctx->hex_out);
+  SRELEASE(ctx->bytes_out);
+}
+
+static void run_ari_serialize(bench_ctx_t *ctx)
+{
+  blob_release(ari_serialize_wrapper(ctx->ari), 1);
+}
+
+static void run_ari_deserialize(bench_ctx_t *ctx)
+{
+  int success;
+  ari_release(ari_deserialize_raw(ctx->ari_data, &success), 1);
+}
+
+static void run_tnvc_serialize(bench_ctx_t *ctx)
+{
+  blob_release(tnvc_serialize_wrapper(ctx->tnvc), 1);
+}
+
+static void run_tnvc_deserialize(bench_ctx_t *ctx)
+{
+  int success;
+  tnvc_release(tnvc_deserialize_ptr_raw(ctx->tnvc_data, &success), 1);
+}
+
+static void run_rpt_serialize(bench_ctx_t *ctx)
+{
+  blob_release(rpt_serialize_wrapper(ctx->rpt), 1);
+}
+
+static void run_msg_grp_serialize(bench_ctx_t *ctx)
+{
+  blob_release(msg_grp_serialize_wrapper(ctx->grp), 1);
+}
+
+static void run_msg_grp_deserialize(bench_ctx_t *ctx)
+{
+  int success;
+  msg_grp_release(msg_grp_deserialize(ctx->grp_data, &success), 1);
+}
+
+/* Fills a new table with all keys, so one operation is size inserts. */
+static void run_rhht_insert(bench_ctx_t *ctx)
+{
+  int success;
+  rhht_t ht = rhht_create(2 * ctx->size, ari_cb_comp_fn, ari_cb_hash, NULL, &success);
+  for (size_t ix = 0; ix < ctx->size; ++ix)
+  {
+    if (rhht_insert(&ht, ctx->keys[ix], ctx->keys[ix], NULL) != RH_OK)
+    {
+      abort();
+    }
+  }
+  rhht_release(&ht, 0);
+}
+
+static void run_rhht_retrieve_key(bench_ctx_t *ctx)
+{
+  rhht_retrieve_key(&(ctx->ht), ctx->keys[ctx->next]);
+  ctx->next = (ctx->next + 1) % ctx->size;
+}
+
+/* Fills a new vector, so one operation is size pushes. */
+static void run_vec_push(bench_ctx_t *ctx)
+{
+  int success;
+  vector_t vec = vec_create(0, NULL, NULL, NULL, 0, &success);
+  for (size_t ix = 0; ix < ctx->size; ++ix)
+  {
+    if (vec_push(&vec, ctx->keys[ix]) != VEC_OK)
+    {
+      abort();
+    }
+  }
+  vec_release(&vec, 0);
+}
+
+static void run_vec_find(bench_ctx_t *ctx)
+{
+  int success;
+  vec_find(&(ctx->vec), &(ctx->vals[ctx->next]), &success);
+  ctx->next = (ctx->next + 1) % ctx->size;
+}
+
+static void run_vdb_findkey_edd(bench_ctx_t *ctx)
+{
+  VDB_FINDKEY_EDD(ctx->keys[ctx->next]);
+  ctx->next = (ctx->next + 1) % ctx->size;
+}
+
+/* The same lookups by keys which aren't interned, as before interning. */
+static void run_vdb_findkey_edd_plain(bench_ctx_t *ctx)
+{
+  VDB_FINDKEY_EDD(ctx->plain_keys[ctx->next]);
+  ctx->next = (ctx->next + 1) % ctx->size;
+}
+
+static void run_expr_eval(bench_ctx_t *ctx)
+{
+  tnv_release(expr_eval(ctx->expr), 1);
+}
+
+/* The same sum through the boxed op_fn, as without operator kernels. */
+static void run_expr_eval_generic(bench_ctx_t *ctx)
+{
+  op_kernel_fn kernel = ctx->op->kernel;
+  ctx->op->kernel = NULL;
+  tnv_release(expr_eval(ctx->expr), 1);
+  ctx->op->kernel = kernel;
+}
+
+static void run_hex_to_string(bench_ctx_t *ctx)
+{
+  char *hex = utils_hex_to_string(ctx->bytes, ctx->size);
+  SRELEASE(hex);
+}
+
+static void run_string_to_hex(bench_ctx_t *ctx)
+{
+  blob_release(utils_string_to_hex(ctx->hex), 1);
+}
+
+static void run_hex_encode(bench_ctx_t *ctx)
+{
+  utils_hex_encode(ctx->hex_out, ctx->bytes, ctx->size);
+}
+
+static void run_hex_decode(bench_ctx_t *ctx)
+{
+  // Skip the "0x" prefix
+  utils_hex_decode(ctx->bytes_out, ctx->hex + 2, 2 * ctx->size, NULL);
+}
+
+static const bench_t benches[] = {
+  { .name = "ari_serialize", .run = run_ari_serialize },
+  { .name = "ari_deserialize", .run = run_ari_deserialize },
+  { .name = "tnvc_serialize", .run = run_tnvc_serialize },
+  { .name = "tnvc_deserialize", .run = run_tnvc_deserialize },
+  { .name = "rpt_serialize_wrapper", .run = run_rpt_serialize },
+  { .name = "msg_grp_serialize_wrapper", .run = run_msg_grp_serialize },
+  { .name = "msg_grp_deserialize", .run = run_msg_grp_deserialize },
+  { .name = "rhht_insert", .run = run_rhht_insert },
+  { .name = "rhht_retrieve_key", .run = run_rhht_retrieve_key },
+  { .name = "vec_push", .run = run_vec_push },
+  { .name = "vec_find", .run = run_vec_find },
+  { .name = "vdb_findkey_edd", .run = run_vdb_findkey_edd },
+  { .name = "vdb_findkey_edd_plain", .run = run_vdb_findkey_edd_plain },
+  { .name = "expr_eval", .run = run_expr_eval },
+  { .name = "expr_eval_generic", .run = run_expr_eval_generic },
+  { .name = "utils_hex_to_string", .run = run_hex_to_string, .per_byte = 1 },
+  { .name = "utils_string_to_hex", .run = run_string_to_hex, .per_byte = 1 },
+  { .name = "utils_hex_encode", .run = run_hex_encode, .per_byte = 1 },
+  { .name = "utils_hex_decode", .run = run_hex_decode, .per_byte = 1 },
+};
+
+static double bench_sample(const bench_t *bench, bench_ctx_t *ctx, uint64_t iters)
+{
+  double start = bench_now();
+  for (uint64_t ix = 0; ix < iters; ++ix)
+  {
+    bench->run(ctx);
+  }
+  return bench_now() - start;
+}
+
+static int bench_cmp_double(const void *a, const void *b)
+{
+  double da = *(const double *)a;
+  double db = *(const double *)b;
+  return (da > db) - (da < db);
+}
+
+/* Runs one benchmark and writes its JSON result object. */
+static void bench_run(FILE *out, const bench_t *bench, bench_ctx_t *ctx, int first)
+{
+  double samples[BENCH_MAX_REPS];
+  uint64_t iters = 1;
+  double secs;
+
+  // Grow the iteration count until one sample takes the minimum time
+  while ((secs = bench_sample(bench, ctx, iters)) < bench_min_time)
+  {
+    iters = (secs > 0) ? (uint64_t)(iters * 1.2 * bench_min_time / secs) + 1 : iters * 10;
+  }
+  samples[0] = secs;
+  for (int ix = 1; ix < bench_reps; ++ix)
+  {
+    samples[ix] = bench_sample(bench, ctx, iters);
+  }
+  qsort(samples, bench_reps, sizeof(double), bench_cmp_double);
+
+  double median_ns = 1e9 * samples[bench_reps / 2] / iters;
+  double min_ns = 1e9 * samples[0] / iters;
+  fprintf(out, "%s\n    {\"name\": \"%s\", \"size\": %zu, \"iterations\": %" PRIu64
+          ", \"ns_per_op\": %.2f, \"ns_min\": %.2f, \"ops_per_sec\": %.1f",
+          first ? "" : ",", bench->name, ctx->size, iters, median_ns, min_ns, 1e9 / median_ns);
+  if (bench->per_byte)
+  {
+    // Bytes per nanosecond are GB/s
+    fprintf(out, ", \"gb_per_sec\": %.3f", ctx->size / median_ns);
+    fprintf(stderr, "%-28s size %-6zu %12.1f ns/op %8.3f GB/s\n", bench->name, ctx->size, median_ns, ctx->size / median_ns);
+  }
+  else
+  {
+    fprintf(stderr, "%-28s size %-6zu %12.1f ns/op\n", bench->name, ctx->size, median_ns);
+  }
+  fprintf(out, "}");
+}
+
+static int bench_parse_sizes(char *arg)
+{
+  char *saveptr = NULL;
+  char *part;
+
+  bench_num_sizes = 0;
+  for (part = strtok_r(arg, ",", &saveptr); part != NULL; part = strtok_r(NULL, ",", &saveptr))
+  {
+    long size = strtol(part, NULL, 10);
+    if ((bench_num_sizes >= BENCH_MAX_SIZES) || (size < 1) || (size > BENCH_MAX_SIZE))
+    {
+      return AMP_FAIL;
+    }
+    bench_sizes[bench_num_sizes++] = size;
+  }
+  return (bench_num_sizes > 0) ? AMP_OK : AMP_FAIL;
+}
+
+void OS_Application_Startup()
+{
+  if (OS_API_Init() != OS_SUCCESS)
+  {
+    fprintf(stderr, "Failed OS_API_Init\n");
+    OS_ApplicationExit(-1);
+  }
+
+  const int argc = OS_BSP_GetArgC();
+  char *const *argv = OS_BSP_GetArgV();
+  int c;
+  while ((c = getopt(argc, argv, "s:t:r:f:l:o:")) != -1)
+  {
+    switch (c)
+    {
+      case 's':
+        if (bench_parse_sizes(optarg) != AMP_OK)
+        {
+          fprintf(stderr, "Sizes must be a list of 1 to %d values from 1 to %d\n", BENCH_MAX_SIZES, BENCH_MAX_SIZE);
+          OS_ApplicationExit(-1);
+        }
+        break;
+      case 't':
+        bench_min_time = atof(optarg);
+        break;
+      case 'r':
+        bench_reps = atoi(optarg);
+        if ((bench_reps < 1) || (bench_reps > BENCH_MAX_REPS))
+        {
+          fprintf(stderr, "Repetitions must be from 1 to %d\n", BENCH_MAX_REPS);
+          OS_ApplicationExit(-1);
+        }
+        break;
+      case 'f':
+        bench_filter = optarg;
+        break;
+      case 'l':
+        bench_label = optarg;
+        break;
+      case 'o':
+        bench_out = optarg;
+        break;
+      default:
+        fprintf(stderr, "Usage: bench_prims [-s <sizes>] [-t <secs>] [-r <reps>] [-f <filter>] [-l <label>] [-o <file>]\n");
+        OS_ApplicationExit(-1);
+    }
+  }
+
+  if (!nmagent_init(&agent))
+  {
+    OS_ApplicationExit(EXIT_FAILURE);
+  }
+  agent_instr_init();
+  amp_agent_init();
+}
+
+void OS_Application_Run()
+{
+  FILE *out = stdout;
+  bench_ctx_t ctx;
+  int first = 1;
+  int status = EXIT_SUCCESS;
+
+  if ((bench_out != NULL) && ((out = fopen(bench_out, "w")) == NULL))
+  {
+    fprintf(stderr, "Cannot open %s\n", bench_out);
+    out = stdout;
+    status = EXIT_FAILURE;
+    bench_num_sizes = 0;
+  }
+
+  fprintf(out, "{\n  \"label\": \"%s\",\n  \"min_time\": %g,\n  \"reps\": %d,\n  \"results\": [",
+          bench_label, bench_min_time, bench_reps);
+  for (size_t sz = 0; sz < bench_num_sizes; ++sz)
+  {
+    if (bench_setup(&ctx, bench_sizes[sz]) != AMP_OK)
+    {
+      fprintf(stderr, "Failed to set up inputs of size %zu\n", bench_sizes[sz]);
+      status = EXIT_FAILURE;
+      bench_teardown(&ctx);
+      break;
+    }
+    for (size_t ix = 0; ix < sizeof(benches) / sizeof(benches[0]); ++ix)
+    {
+      if ((bench_filter != NULL) && (strstr(benches[ix].name, bench_filter) == NULL))
+      {
+        continue;
+      }
+      bench_run(out, &(benches[ix]), &ctx, first);
+      first = 0;
+    }
+    bench_teardown(&ctx);
+  }
+  fprintf(out, "\n  ]\n}\n");
+
+  if (out != stdout)
+  {
+    fclose(out);
+  }
+
+  nmagent_destroy(&agent);
+  adm_common_destroy();
+  db_destroy();
+  utils_mem_teardown();
+  OS_BSP_SetExitCode(status);
+}
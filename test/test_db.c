@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) 2023 The Johns Hopkins University Applied Physics
+ * Laboratory LLC.
+ *
+ * This file is part of the Delay-Tolerant Networking Management
+ * Architecture (DTNMA) Tools package.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <shared/adm/adm.h>
+#include <shared/utils/db.h>
+#include <shared/utils/utils.h>
+#include <shared/primitives/edd_var.h>
+#include <shared/primitives/rules.h>
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+/// Temporary directory holding the store of each test
+static char test_dir[64];
+/// Path prefix of the journal and snapshot
+static char test_name[96];
+static char test_jnl[128];
+static char test_snap[128];
+
+static void test_db_open(void)
+{
+  TEST_ASSERT_EQUAL_INT(AMP_OK, utils_mem_int());
+  TEST_ASSERT_EQUAL_INT(AMP_OK, db_init(test_name, &adm_common_init));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, db_read_objs(test_name));
+}
+
+static void test_db_close(void)
+{
+  adm_common_destroy();
+  db_destroy();
+  utils_mem_teardown();
+}
+
+/* Simulate a restart, keeping only what was committed to the files. */
+static void test_db_reopen(void)
+{
+  test_db_close();
+  test_db_open();
+}
+
+static off_t test_file_size(const char *path)
+{
+  struct stat st;
+  if (stat(path, &st) != 0)
+  {
+    return -1;
+  }
+  return st.st_size;
+}
+
+static ari_t *test_var_id(amp_uvast item)
+{
+  return adm_build_ari(AMP_TYPE_VAR, false, 12, item);
+}
+
+/* Add and persist a variable holding a value. */
+static var_t *test_var_put(amp_uvast item, amp_uvast value)
+{
+  tnv_t *val = tnv_from_uvast(value);
+  TEST_ASSERT_NOT_NULL(val);
+  var_t *var = var_create_from_tnv(test_var_id(item), *val);
+  tnv_release(val, 1);
+  TEST_ASSERT_NOT_NULL(var);
+  TEST_ASSERT_EQUAL_INT(RH_OK, VDB_ADD_VAR(var->id, var));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, db_persist_var(var));
+  return var;
+}
+
+static var_t *test_var_find(amp_uvast item)
+{
+  ari_t *id = test_var_id(item);
+  var_t *var = VDB_FINDKEY_VAR(id);
+  ari_release(id, 1);
+  return var;
+}
+
+static void test_var_check(amp_uvast item, amp_uvast value)
+{
+  int success;
+  var_t *var = test_var_find(item);
+  TEST_ASSERT_NOT_NULL(var);
+  TEST_ASSERT_EQUAL_UINT64(value, tnv_to_uvast(*(var->value), &success));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, success);
+}
+
+static rule_t *test_rule_put(amp_uvast item)
+{
+  ari_t *id = adm_build_ari(AMP_TYPE_TBR, false, 12, item);
+  tbr_def_t def;
+  ac_t action;
+
+  def.period = OS_TimeFromTotalSeconds(10);
+  def.max_fire = 100;
+  ac_init(&action);
+  ac_insert(&action, adm_build_ari(AMP_TYPE_CTRL, true, 12, 34));
+
+  rule_t *rule = rule_create_tbr(*id, OS_TimeFromTotalSeconds(0), def, action);
+  ari_release(id, 1);
+  TEST_ASSERT_NOT_NULL(rule);
+  TEST_ASSERT_EQUAL_INT(RH_OK, VDB_ADD_RULE(&(rule->id), rule));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, db_persist_rule(rule));
+  return rule;
+}
+
+static rule_t *test_rule_find(amp_uvast item)
+{
+  ari_t *id = adm_build_ari(AMP_TYPE_TBR, false, 12, item);
+  rule_t *rule = VDB_FINDKEY_RULE(id);
+  ari_release(id, 1);
+  return rule;
+}
+
+void setUp(void)
+{
+  strcpy(test_dir, "/tmp/test_db_XXXXXX");
+  TEST_ASSERT_NOT_NULL(mkdtemp(test_dir));
+  snprintf(test_name, sizeof(test_name), "%s/db", test_dir);
+  snprintf(test_jnl, sizeof(test_jnl), "%s.jnl", test_name);
+  snprintf(test_snap, sizeof(test_snap), "%s.snap", test_name);
+  test_db_open();
+}
+
+void tearDown(void)
+{
+  test_db_close();
+  unlink(test_jnl);
+  unlink(test_snap);
+  rmdir(test_dir);
+}
+
+void test_db_replay(void)
+{
+  test_var_put(1, 10);
+  test_var_put(2, 20);
+  // The latest PUT of an object wins
+  var_t *var = test_var_find(1);
+  TEST_ASSERT_NOT_NULL(var);
+  var->value->value.as_uvast = 11;
+  TEST_ASSERT_EQUAL_INT(AMP_OK, db_persist_var(var));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, db_sync());
+
+  test_db_reopen();
+  test_var_check(1, 11);
+  test_var_check(2, 20);
+  TEST_ASSERT_NULL(test_var_find(3));
+}
+
+void test_db_rule_state(void)
+{
+  rule_t *rule = test_rule_put(40);
+  rule->num_eval = 9;
+  rule->num_fire = 7;
+  rule->prio = AMP_PRIO_BULK;
+  TEST_ASSERT_EQUAL_INT(AMP_OK, db_persist_rule_state(rule));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, db_sync());
+
+  test_db_reopen();
+  rule = test_rule_find(40);
+  TEST_ASSERT_NOT_NULL(rule);
+  TEST_ASSERT_EQUAL_UINT64(9, rule->num_eval);
+  TEST_ASSERT_EQUAL_UINT64(7, rule->num_fire);
+  TEST_ASSERT_EQUAL_UINT8(AMP_PRIO_BULK, rule->prio);
+
+  // A later PUT replaces the state recorded before it
+  rule->num_fire = 0;
+  rule->num_eval = 0;
+  TEST_ASSERT_EQUAL_INT(AMP_OK, db_persist_rule(rule));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, db_sync());
+
+  test_db_reopen();
+  rule = test_rule_find(40);
+  TEST_ASSERT_NOT_NULL(rule);
+  TEST_ASSERT_EQUAL_UINT64(0, rule->num_fire);
+}
+
+void test_db_del(void)
+{
+  var_t *var = test_var_put(1, 10);
+  test_var_put(2, 20);
+  TEST_ASSERT_EQUAL_INT(AMP_OK, db_sync());
+
+  TEST_ASSERT_EQUAL_INT(AMP_OK, db_forget(&(var->desc)));
+  TEST_ASSERT_EQUAL_INT(0, var->desc.itemId);
+  TEST_ASSERT_EQUAL_INT(AMP_OK, db_sync());
+
+  test_db_reopen();
+  TEST_ASSERT_NULL(test_var_find(1));
+  test_var_check(2, 20);
+}
+
+void test_db_torn_tail(void)
+{
+  test_var_put(1, 10);
+  TEST_ASSERT_EQUAL_INT(AMP_OK, db_sync());
+  const off_t good = test_file_size(test_jnl);
+  test_var_put(2, 20);
+  TEST_ASSERT_EQUAL_INT(AMP_OK, db_sync());
+  const off_t full = test_file_size(test_jnl);
+  TEST_ASSERT_GREATER_THAN(good, full);
+  test_db_close();
+
+  // Lose the end of the last record, as from a crash mid-write
+  TEST_ASSERT_EQUAL_INT(0, truncate(test_jnl, full - 3));
+
+  test_db_open();
+  test_var_check(1, 10);
+  TEST_ASSERT_NULL(test_var_find(2));
+  // The torn record is dropped from the file
+  TEST_ASSERT_EQUAL_INT(good, test_file_size(test_jnl));
+
+  // New records follow the last good one
+  test_var_put(3, 30);
+  TEST_ASSERT_EQUAL_INT(AMP_OK, db_sync());
+  test_db_reopen();
+  test_var_check(1, 10);
+  test_var_check(3, 30);
+}
+
+void test_db_compact(void)
+{
+  var_t *var = test_var_put(1, 10);
+  test_var_put(2, 20);
+  rule_t *rule = test_rule_put(40);
+  rule->num_fire = 3;
+  TEST_ASSERT_EQUAL_INT(AMP_OK, db_persist_rule_state(rule));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, db_forget(&(var->desc)));
+  VDB_DELKEY_VAR(var->id);
+
+  TEST_ASSERT_EQUAL_INT(AMP_OK, db_snapshot());
+  TEST_ASSERT_GREATER_THAN(0, test_file_size(test_snap));
+  // The journal holds only its header afterward
+  const off_t empty = test_file_size(test_jnl);
+  TEST_ASSERT_LESS_THAN(64, empty);
+
+  // Records after the snapshot are replayed on top of it
+  test_var_put(5, 50);
+  var = test_var_find(2);
+  TEST_ASSERT_NOT_NULL(var);
+  var->value->value.as_uvast = 21;
+  TEST_ASSERT_EQUAL_INT(AMP_OK, db_persist_var(var));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, db_sync());
+  TEST_ASSERT_GREATER_THAN(empty, test_file_size(test_jnl));
+
+  test_db_reopen();
+  TEST_ASSERT_NULL(test_var_find(1));
+  test_var_check(2, 21);
+  test_var_check(5, 50);
+  rule = test_rule_find(40);
+  TEST_ASSERT_NOT_NULL(rule);
+  TEST_ASSERT_EQUAL_UINT64(3, rule->num_fire);
+
+  // Identifiers are not reused after a snapshot
+  var = test_var_put(6, 60);
+  TEST_ASSERT_NOT_EQUAL(0, var->desc.itemId);
+  TEST_ASSERT_NOT_EQUAL(test_var_find(5)->desc.itemId, var->desc.itemId);
+}
@@ -0,0 +1,616 @@
+/*
+ * Copyright (c) 2023 The Johns Hopkins University Applied Physics
+ * Laboratory LLC.
+ *
+ * This file is part of the Delay-Tolerant Networking Management
+ * Architecture (DTNMA) Tools package.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <shared/adm/adm.h>
+#include <shared/utils/utils.h>
+#include <mgr/metadata.h>
+#include <mgr/agents.h>
+#include <mgr/nm_mgr_fmt.h>
+#include <mgr/nm_mgr_log.h>
+#include <mgr/nm_mgr_metrics.h>
+#include <mgr/nm_mgr_rx.h>
+#include <mgr/nmmgr.h>
+#include <unity.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+static nmmgr_t mgr;
+
+void setUp(void)
+{
+  TEST_ASSERT_EQUAL_INT(AMP_OK, nmmgr_init(&mgr));
+}
+
+void tearDown(void)
+{
+  nmmgr_destroy(&mgr);
+}
+
+/* Format into a string, which the caller releases. */
+static char *test_fmt_json_str(const char *str)
+{
+  mgr_fmt_t fmt;
+  mgr_fmt_init_buf(&fmt);
+  mgr_fmt_json_str(&fmt, str);
+  return mgr_fmt_take(&fmt);
+}
+
+void test_fmt_json_escape(void)
+{
+  char *out = test_fmt_json_str("plain");
+  TEST_ASSERT_EQUAL_STRING("\"plain\"", out);
+  SRELEASE(out);
+
+  out = test_fmt_json_str("q\"b\\s/");
+  TEST_ASSERT_EQUAL_STRING("\"q\\\"b\\\\s/\"", out);
+  SRELEASE(out);
+
+  out = test_fmt_json_str("\n\r\t\x01\x1f\x7f");
+  TEST_ASSERT_EQUAL_STRING("\"\\n\\r\\t\\u0001\\u001f\x7f\"", out);
+  SRELEASE(out);
+
+  // UTF-8 is written as it is
+  out = test_fmt_json_str("caf\xc3\xa9 \xe2\x82\xac");
+  TEST_ASSERT_EQUAL_STRING("\"caf\xc3\xa9 \xe2\x82\xac\"", out);
+  SRELEASE(out);
+
+  // Keys and formatted output are escaped too, but not outside strings
+  mgr_fmt_t fmt;
+  mgr_fmt_init_buf(&fmt);
+  mgr_fmt_json_open(&fmt, '{');
+  mgr_fmt_json_key(&fmt, "k\"");
+  mgr_fmt_json_str_begin(&fmt);
+  mgr_fmt_printf(&fmt, "%d\t%s", 7, "\"x\"");
+  mgr_fmt_json_str_end(&fmt);
+  mgr_fmt_json_close(&fmt, '}');
+  mgr_fmt_write(&fmt, "\"", 1);
+  out = mgr_fmt_take(&fmt);
+  TEST_ASSERT_EQUAL_STRING("{\"k\\\"\":\"7\\t\\\"x\\\"\"}\"", out);
+  SRELEASE(out);
+}
+
+void test_fmt_json_nesting(void)
+{
+  mgr_fmt_t fmt;
+  mgr_fmt_init_buf(&fmt);
+  mgr_fmt_json_open(&fmt, '{');
+  mgr_fmt_json_key(&fmt, "a");
+  mgr_fmt_json_open(&fmt, '[');
+  mgr_fmt_json_uint(&fmt, 1);
+  mgr_fmt_json_open(&fmt, '{');
+  mgr_fmt_json_close(&fmt, '}');
+  mgr_fmt_json_open(&fmt, '[');
+  mgr_fmt_json_null(&fmt);
+  mgr_fmt_json_close(&fmt, ']');
+  mgr_fmt_json_uint(&fmt, 2);
+  mgr_fmt_json_close(&fmt, ']');
+  mgr_fmt_json_key(&fmt, "b");
+  mgr_fmt_json_str(&fmt, "c");
+  mgr_fmt_json_close(&fmt, '}');
+  char *out = mgr_fmt_take(&fmt);
+  TEST_ASSERT_EQUAL_STRING("{\"a\":[1,{},[null],2],\"b\":\"c\"}", out);
+  SRELEASE(out);
+  TEST_ASSERT_EQUAL_INT(0, fmt.depth);
+
+  // Two members at every depth, down to the deepest
+  char want[16 * MGR_FMT_JSON_MAX_DEPTH];
+  size_t len = 0;
+  mgr_fmt_init_buf(&fmt);
+  for (int ix = 0; ix < MGR_FMT_JSON_MAX_DEPTH; ++ix)
+  {
+    mgr_fmt_json_open(&fmt, '[');
+    mgr_fmt_json_uint(&fmt, ix % 10);
+    len += sprintf(want + len, "[%d,", ix % 10);
+  }
+  for (int ix = 0; ix < MGR_FMT_JSON_MAX_DEPTH; ++ix)
+  {
+    mgr_fmt_json_null(&fmt);
+    mgr_fmt_json_close(&fmt, ']');
+    len += sprintf(want + len, (ix == 0) ? "null]" : ",null]");
+  }
+  out = mgr_fmt_take(&fmt);
+  TEST_ASSERT_EQUAL_STRING(want, out);
+  SRELEASE(out);
+}
+
+void test_fmt_reserve_buf(void)
+{
+  const size_t total = 3 * MGR_FMT_LOCAL_SIZE + 5;
+  char *big = malloc(total + 1);
+  TEST_ASSERT_NOT_NULL(big);
+  for (size_t ix = 0; ix < total; ++ix)
+  {
+    big[ix] = 'a' + (ix % 26);
+  }
+  big[total] = '\0';
+
+  // Many small writes grow the buffer past the local one
+  mgr_fmt_t fmt;
+  mgr_fmt_init_buf(&fmt);
+  for (size_t ix = 0; ix < total; ix += 100)
+  {
+    mgr_fmt_write(&fmt, big + ix, MIN(100, total - ix));
+  }
+  TEST_ASSERT_TRUE(fmt.buf != fmt.local);
+  TEST_ASSERT_GREATER_THAN(total, fmt.max);
+  char *out = mgr_fmt_take(&fmt);
+  TEST_ASSERT_NOT_NULL(out);
+  TEST_ASSERT_EQUAL_size_t(total, strlen(out));
+  TEST_ASSERT_EQUAL_STRING(big, out);
+  SRELEASE(out);
+  TEST_ASSERT_TRUE(fmt.buf == fmt.local);
+
+  // As does one printf, after some output
+  mgr_fmt_puts(&fmt, "x=");
+  mgr_fmt_printf(&fmt, "%s;", big);
+  out = mgr_fmt_take(&fmt);
+  TEST_ASSERT_NOT_NULL(out);
+  TEST_ASSERT_EQUAL_size_t(total + 3, strlen(out));
+  TEST_ASSERT_EQUAL_STRING_LEN("x=", out, 2);
+  TEST_ASSERT_EQUAL_STRING_LEN(big, out + 2, total);
+  TEST_ASSERT_EQUAL_INT(';', out[total + 2]);
+  SRELEASE(out);
+
+  // And escaping inside a string, which lengthens it
+  for (size_t ix = 0; ix < total; ix += 2)
+  {
+    big[ix] = '"';
+  }
+  out = test_fmt_json_str(big);
+  TEST_ASSERT_NOT_NULL(out);
+  TEST_ASSERT_EQUAL_size_t(total + (total + 1) / 2 + 2, strlen(out));
+  TEST_ASSERT_EQUAL_STRING_LEN("\"\\\"b\\\"", out, 6);
+  SRELEASE(out);
+
+  free(big);
+}
+
+void test_fmt_reserve_sink(void)
+{
+  char *data = NULL;
+  size_t size = 0;
+  ui_print_cfg_t sink = { .fd = open_memstream(&data, &size) };
+  TEST_ASSERT_NOT_NULL(sink.fd);
+
+  // Output larger than the local buffer is flushed, not buffered
+  mgr_fmt_t fmt;
+  mgr_fmt_init_sink(&fmt, &sink);
+  const size_t num = 4 * MGR_FMT_LOCAL_SIZE / 10;
+  for (size_t ix = 0; ix < num; ++ix)
+  {
+    mgr_fmt_write(&fmt, "0123456789", 10);
+  }
+  TEST_ASSERT_TRUE(fmt.buf == fmt.local);
+
+  // Except for one value which outgrows it
+  uint8_t bytes[MGR_FMT_LOCAL_SIZE];
+  for (size_t ix = 0; ix < sizeof(bytes); ++ix)
+  {
+    bytes[ix] = ix;
+  }
+  mgr_fmt_hex(&fmt, bytes, sizeof(bytes));
+  mgr_fmt_printf(&fmt, "%*s", MGR_FMT_LOCAL_SIZE + 10, "end");
+  mgr_fmt_finish(&fmt);
+  TEST_ASSERT_TRUE(fmt.buf == fmt.local);
+  TEST_ASSERT_EQUAL_INT(0, fclose(sink.fd));
+
+  const size_t want = 10 * num + 2 + 2 * sizeof(bytes) + MGR_FMT_LOCAL_SIZE + 10;
+  TEST_ASSERT_EQUAL_size_t(want, size);
+  TEST_ASSERT_EQUAL_STRING_LEN("0123456789", data + 10 * (num - 1), 10);
+  TEST_ASSERT_EQUAL_STRING_LEN("0x000102", data + 10 * num, 8);
+  TEST_ASSERT_EQUAL_STRING_LEN("feff", data + 10 * num + 2 * sizeof(bytes) - 2, 4);
+  TEST_ASSERT_EQUAL_STRING("end", data + size - 3);
+  free(data);
+}
+
+/* Format an ARI by name into a string, which the caller releases. */
+static char *test_fmt_ari(ari_t *id)
+{
+  mgr_fmt_t fmt;
+  mgr_fmt_init_buf(&fmt);
+  mgr_fmt_ari(&fmt, id, NULL, 0);
+  return mgr_fmt_take(&fmt);
+}
+
+/// More ARIs than the name cache has entries, so that some share one
+#define TEST_NUM_NAMES (MGR_FMT_NAME_CACHE_SIZE + 100)
+
+void test_fmt_name_cache(void)
+{
+  ari_t **ids = calloc(TEST_NUM_NAMES, sizeof(ari_t *));
+  char **names = calloc(TEST_NUM_NAMES, sizeof(char *));
+  TEST_ASSERT_NOT_NULL(ids);
+  TEST_ASSERT_NOT_NULL(names);
+
+  // Every third has metadata
+  for (int ix = 0; ix < TEST_NUM_NAMES; ++ix)
+  {
+    ids[ix] = adm_build_ari(AMP_TYPE_EDD, false, 12, 1000 + ix);
+    TEST_ASSERT_NOT_NULL(ids[ix]);
+    TEST_ASSERT_NOT_NULL(ids[ix]->as_reg.ident);
+    if (ix % 3 == 0)
+    {
+      char name[32];
+      snprintf(name, sizeof(name), "edd_%d", ix);
+      TEST_ASSERT_NOT_NULL(meta_add_edd(AMP_TYPE_UINT, adm_build_ari(AMP_TYPE_EDD, false, 12, 1000 + ix), 12, name, "test"));
+    }
+  }
+
+  for (int ix = 0; ix < TEST_NUM_NAMES; ++ix)
+  {
+    names[ix] = test_fmt_ari(ids[ix]);
+    TEST_ASSERT_NOT_NULL(names[ix]);
+    if (ix % 3 == 0)
+    {
+      char name[32];
+      snprintf(name, sizeof(name), "edd_%d", ix);
+      TEST_ASSERT_EQUAL_STRING(name, names[ix]);
+    }
+    else
+    {
+      TEST_ASSERT_EQUAL_STRING_LEN("Anonymous ARI: 0x", names[ix], 17);
+    }
+  }
+
+  // Cached and evicted names are the same as the first time
+  for (int pass = 0; pass < 2; ++pass)
+  {
+    for (int ix = TEST_NUM_NAMES - 1; ix >= 0; --ix)
+    {
+      char *out = test_fmt_ari(ids[ix]);
+      TEST_ASSERT_EQUAL_STRING(names[ix], out);
+      SRELEASE(out);
+    }
+  }
+
+  // A different ARI of the same identity has the same name
+  ari_t *copy = ari_copy_ptr(ids[1]);
+  char *out = test_fmt_ari(copy);
+  TEST_ASSERT_EQUAL_STRING(names[1], out);
+  SRELEASE(out);
+  ari_release(copy, 1);
+
+  // Anonymous names differ by identity
+  TEST_ASSERT_TRUE(strcmp(names[1], names[2]) != 0);
+
+  for (int ix = 0; ix < TEST_NUM_NAMES; ++ix)
+  {
+    ari_release(ids[ix], 1);
+    SRELEASE(names[ix]);
+  }
+  free(ids);
+  free(names);
+}
+
+/* Check that each sample line names the family declared before it and
+ * ends in a number, and that histogram buckets never decrease.
+ */
+static void test_metrics_lines(const char *text)
+{
+  char family[128] = "";
+  uint64_t last_bucket = 0;
+
+  while (*text != '\0')
+  {
+    const char *end = strchr(text, '\n');
+    TEST_ASSERT_NOT_NULL_MESSAGE(end, "Every line ends in a newline");
+    char line[512];
+    TEST_ASSERT_LESS_THAN(sizeof(line), (size_t)(end - text));
+    memcpy(line, text, end - text);
+    line[end - text] = '\0';
+    text = end + 1;
+
+    if (strncmp(line, "# HELP ", 7) == 0)
+    {
+      continue;
+    }
+    char type[32];
+    if (sscanf(line, "# TYPE %127s %31s", family, type) == 2)
+    {
+      TEST_ASSERT_TRUE(strcmp(type, "counter") == 0
+                       || strcmp(type, "gauge") == 0
+                       || strcmp(type, "histogram") == 0);
+      last_bucket = 0;
+      continue;
+    }
+    TEST_ASSERT_TRUE_MESSAGE(line[0] != '#', line);
+
+    const size_t flen = strlen(family);
+    TEST_ASSERT_TRUE_MESSAGE(flen > 0 && strncmp(line, family, flen) == 0, line);
+    const char *rest = line + flen;
+    const bool is_bucket = (strncmp(rest, "_bucket{", 8) == 0);
+    if (is_bucket || strncmp(rest, "_sum ", 5) == 0 || strncmp(rest, "_count ", 7) == 0)
+    {
+      rest = strchr(rest, (is_bucket ? '{' : ' '));
+    }
+    if (*rest == '{')
+    {
+      rest = strstr(rest, "\"} ");
+      TEST_ASSERT_NOT_NULL_MESSAGE(rest, line);
+      rest += 2;
+    }
+    TEST_ASSERT_EQUAL_INT_MESSAGE(' ', *rest, line);
+
+    char *num_end;
+    const double val = strtod(rest + 1, &num_end);
+    TEST_ASSERT_TRUE_MESSAGE(num_end != rest + 1 && *num_end == '\0', line);
+    if (is_bucket)
+    {
+      TEST_ASSERT_TRUE_MESSAGE((uint64_t)val >= last_bucket, line);
+      last_bucket = val;
+    }
+  }
+}
+
+void test_metrics_exposition(void)
+{
+  memset(&gMgrMetrics, 0, sizeof(gMgrMetrics));
+  MGR_METRICS_ADD(gMgrMetrics.rx_groups, 5);
+  MGR_METRICS_ADD(gMgrMetrics.rx_bytes, 1234);
+  mgr_metrics_hist_record(&(gMgrMetrics.decode_us), 1);
+  mgr_metrics_hist_record(&(gMgrMetrics.decode_us), 3);
+  mgr_metrics_hist_record(&(gMgrMetrics.decode_us), 4);
+  mgr_metrics_hist_record(&(gMgrMetrics.decode_us), 1ULL << MGR_METRICS_HIST_BUCKETS);
+  mgr_metrics_hist_record(&(gMgrMetrics.sql_batch), 7);
+
+  // Label values are escaped
+  eid_t eid;
+  memset(&eid, 0, sizeof(eid));
+  strcpy(eid.name, "ipn:1.\"2\\3");
+  TEST_ASSERT_EQUAL_INT(AMP_OK, agent_add(eid));
+
+  mgr_fmt_t fmt;
+  mgr_fmt_init_buf(&fmt);
+  mgr_metrics_write(&fmt);
+  char *out = mgr_fmt_take(&fmt);
+  TEST_ASSERT_NOT_NULL(out);
+  test_metrics_lines(out);
+
+  const char *want[] = {
+    "# HELP nm_mgr_rx_groups_total Message groups received.\n"
+    "# TYPE nm_mgr_rx_groups_total counter\n"
+    "nm_mgr_rx_groups_total 5\n",
+    "\nnm_mgr_rx_bytes_total 1234\n",
+    "\nnm_mgr_rx_invalid_groups_total 0\n",
+    "# TYPE nm_mgr_rx_decode_seconds histogram\n"
+    "nm_mgr_rx_decode_seconds_bucket{le=\"1e-06\"} 1\n"
+    "nm_mgr_rx_decode_seconds_bucket{le=\"2e-06\"} 1\n"
+    "nm_mgr_rx_decode_seconds_bucket{le=\"4e-06\"} 3\n"
+    "nm_mgr_rx_decode_seconds_bucket{le=\"8e-06\"} 3\n",
+    "nm_mgr_rx_decode_seconds_bucket{le=\"+Inf\"} 4\n"
+    "nm_mgr_rx_decode_seconds_sum 268.435464\n"
+    "nm_mgr_rx_decode_seconds_count 4\n",
+    "nm_mgr_sql_batch_size_bucket{le=\"4\"} 0\n"
+    "nm_mgr_sql_batch_size_bucket{le=\"8\"} 1\n",
+    "\nnm_mgr_sql_batch_size_sum 7\n",
+    "\nnm_mgr_agents 1\n",
+    "\nnm_mgr_agent_rx_reports_total{agent=\"ipn:1.\\\"2\\\\3\"} 0\n",
+    "# TYPE nm_mgr_rest_request_seconds histogram\n",
+  };
+  for (size_t ix = 0; ix < sizeof(want) / sizeof(want[0]); ++ix)
+  {
+    TEST_ASSERT_NOT_NULL_MESSAGE(strstr(out, want[ix]), want[ix]);
+  }
+  SRELEASE(out);
+}
+
+/// Agents sending groups to the receive test
+#define TEST_RX_AGENTS 6
+/// Groups sent by each agent
+#define TEST_RX_GROUPS 40
+
+/// Groups given to the receive thread, in order, and their sources
+static blob_t *test_rx_bufs[TEST_RX_AGENTS * TEST_RX_GROUPS];
+static eid_t test_rx_eids[TEST_RX_AGENTS];
+static size_t test_rx_next;
+
+static blob_t *test_rx_receive(msg_metadata_t *meta, daemon_run_t *running, int *success, void *ctx)
+{
+  const size_t total = sizeof(test_rx_bufs) / sizeof(test_rx_bufs[0]);
+
+  (void) running;
+  (void) ctx;
+
+  if (test_rx_next >= total)
+  {
+    // Stopping the receive thread stops its workers once they are done
+    *success = AMP_FAIL;
+    return NULL;
+  }
+  meta->source = test_rx_eids[test_rx_next % TEST_RX_AGENTS];
+  *success = AMP_OK;
+  return test_rx_bufs[test_rx_next++];
+}
+
+/* A group of two reports timed by the sequence number, and a registration
+ * first if it is the agent's first group. */
+static blob_t *test_rx_group(const eid_t *eid, size_t seq)
+{
+  msg_grp_t *grp = msg_grp_create(2);
+  TEST_ASSERT_NOT_NULL(grp);
+
+  if (seq == 0)
+  {
+    msg_agent_t *reg = msg_agent_create();
+    TEST_ASSERT_NOT_NULL(reg);
+    msg_agent_set_agent(reg, *eid);
+    TEST_ASSERT_EQUAL_INT(AMP_OK, msg_grp_add_msg_agent(grp, reg));
+    msg_agent_release(reg, 1);
+  }
+
+  msg_rpt_t *msg = msg_rpt_create(NULL);
+  TEST_ASSERT_NOT_NULL(msg);
+  for (size_t ix = 0; ix < 2; ++ix)
+  {
+    ari_t *id = adm_build_ari(AMP_TYPE_RPTTPL, false, 12, 1);
+    rpt_t *rpt = rpt_create(id, OS_TimeFromTotalSeconds(2 * seq + ix + 1), NULL);
+    TEST_ASSERT_NOT_NULL(rpt);
+    TEST_ASSERT_EQUAL_INT(AMP_OK, msg_rpt_add_rpt(msg, rpt));
+  }
+  TEST_ASSERT_EQUAL_INT(AMP_OK, msg_grp_add_msg_rpt(grp, msg));
+  msg_rpt_release(msg, 1);
+
+  blob_t *buf = msg_grp_serialize_wrapper(grp);
+  TEST_ASSERT_NOT_NULL(buf);
+  msg_grp_release(grp, 1);
+  return buf;
+}
+
+void test_rx_workers_order(void)
+{
+  // Groups from all agents are interleaved
+  for (size_t agt = 0; agt < TEST_RX_AGENTS; ++agt)
+  {
+    memset(&(test_rx_eids[agt]), 0, sizeof(eid_t));
+    snprintf(test_rx_eids[agt].name, AMP_MAX_EID_LEN, "ipn:%zu.1", agt + 2);
+  }
+  for (size_t seq = 0; seq < TEST_RX_GROUPS; ++seq)
+  {
+    for (size_t agt = 0; agt < TEST_RX_AGENTS; ++agt)
+    {
+      test_rx_bufs[seq * TEST_RX_AGENTS + agt] = test_rx_group(&(test_rx_eids[agt]), seq);
+    }
+  }
+  test_rx_next = 0;
+
+  TEST_ASSERT_EQUAL_INT(0, daemon_run_init(&(mgr.running)));
+  mgr.mif.receive = test_rx_receive;
+  mgr.rx_workers = 4;
+  pthread_t thr;
+  TEST_ASSERT_EQUAL_INT(0, pthread_create(&thr, NULL, mgr_rx_thread, &mgr));
+  TEST_ASSERT_EQUAL_INT(0, pthread_join(thr, NULL));
+
+  // Each agent was registered by its first group and has every report,
+  // in the order it sent them
+  TEST_ASSERT_EQUAL_UINT64(2 * TEST_RX_AGENTS * TEST_RX_GROUPS, gMgrDB.tot_rpts);
+  for (size_t agt = 0; agt < TEST_RX_AGENTS; ++agt)
+  {
+    agent_t *agent = agent_get(&(test_rx_eids[agt]));
+    TEST_ASSERT_NOT_NULL_MESSAGE(agent, test_rx_eids[agt].name);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(2 * TEST_RX_GROUPS, vec_num_entries(agent->rpts), test_rx_eids[agt].name);
+
+    int64_t last = 0;
+    for (vecit_t it = vecit_first(&(agent->rpts)); vecit_valid(it); it = vecit_next(it))
+    {
+      rpt_t *rpt = vecit_data(it);
+      const int64_t secs = OS_TimeGetTotalSeconds(rpt->time);
+      TEST_ASSERT_TRUE_MESSAGE(secs == last + 1, test_rx_eids[agt].name);
+      last = secs;
+    }
+  }
+  daemon_run_cleanup(&(mgr.running));
+}
+
+static off_t test_log_size(const char *path)
+{
+  struct stat st;
+  if (stat(path, &st) != 0)
+  {
+    return -1;
+  }
+  return st.st_size;
+}
+
+/* Queue one entry, counted against the rotation limit. */
+static void test_log_commit(agent_t *agent, const char *text)
+{
+  mgr_log_buf_t buf;
+  TEST_ASSERT_EQUAL_INT(AMP_OK, mgr_log_buf_open(&buf));
+  fputs(text, buf.fd);
+  TEST_ASSERT_EQUAL_INT(AMP_OK, mgr_log_buf_commit(&buf, agent, 1));
+}
+
+void test_log_writer(void)
+{
+  const agent_autologging_cfg_t saved_cfg = agent_log_cfg;
+  char dir[sizeof(agent_log_cfg.dir)] = "/tmp/test_mgr_XXXXXX";
+  TEST_ASSERT_NOT_NULL(mkdtemp(dir));
+  agent_log_cfg.enabled = 1;
+  agent_log_cfg.limit = 2;
+  agent_log_cfg.agent_dirs = 0;
+  agent_log_cfg.flush_ms = 20;
+  agent_log_cfg.compress = 1;
+  strcpy(agent_log_cfg.dir, dir);
+
+  char first[64];
+  char first_gz[68];
+  char second[64];
+  snprintf(first, sizeof(first), "%s/ipn:7.1_0.log", dir);
+  snprintf(first_gz, sizeof(first_gz), "%s.gz", first);
+  snprintf(second, sizeof(second), "%s/ipn:7.1_1.log", dir);
+
+  // Opening the first file is queued when the agent is added
+  eid_t eid;
+  memset(&eid, 0, sizeof(eid));
+  strcpy(eid.name, "ipn:7.1");
+  TEST_ASSERT_EQUAL_INT(AMP_OK, agent_add(eid));
+  agent_t *agent = agent_get(&eid);
+  TEST_ASSERT_NOT_NULL(agent);
+  TEST_ASSERT_EQUAL_UINT(1, mgr_log_backlog());
+
+  TEST_ASSERT_EQUAL_INT(0, daemon_run_init(&(mgr.running)));
+  pthread_t thr;
+  TEST_ASSERT_EQUAL_INT(0, pthread_create(&thr, NULL, mgr_log_thread, &mgr));
+
+  // Text stays in the file buffer until the timer flushes it
+  test_log_commit(agent, "rpt 1\n");
+  for (int ix = 0; (ix < 2000) && (test_log_size(first) <= 0); ++ix)
+  {
+    usleep(1000);
+  }
+  TEST_ASSERT_EQUAL_INT(6, test_log_size(first));
+
+  // The entry over the limit is the last in its file
+  test_log_commit(agent, "rpt 2\n");
+  test_log_commit(agent, "rpt 3\n");
+  test_log_commit(agent, "rpt 4\n");
+
+  // Everything queued is written before the writer stops
+  daemon_run_stop(&(mgr.running));
+  mgr_log_wake();
+  TEST_ASSERT_EQUAL_INT(0, pthread_join(thr, NULL));
+  TEST_ASSERT_EQUAL_UINT(0, mgr_log_backlog());
+  TEST_ASSERT_EQUAL_INT(6, test_log_size(second));
+#ifdef HAVE_ZLIB
+  // and the rotated file was compressed, apart from the writer
+  TEST_ASSERT_EQUAL_INT(-1, test_log_size(first));
+  TEST_ASSERT_GREATER_THAN(0, test_log_size(first_gz));
+#else
+  TEST_ASSERT_EQUAL_INT(18, test_log_size(first));
+#endif
+
+  // Records over the queue length are dropped and counted
+  const uint64_t dropped = mgr_log_dropped();
+  for (int ix = 0; ix < MGR_LOG_DEF_QUEUE_LEN; ++ix)
+  {
+    TEST_ASSERT_EQUAL_INT(AMP_OK, mgr_log_printf(agent, "line %d\n", ix));
+  }
+  TEST_ASSERT_EQUAL_INT(AMP_FAIL, mgr_log_printf(agent, "dropped\n"));
+  TEST_ASSERT_EQUAL_UINT64(dropped + 1, mgr_log_dropped());
+  TEST_ASSERT_EQUAL_UINT(MGR_LOG_DEF_QUEUE_LEN, mgr_log_backlog());
+
+  daemon_run_cleanup(&(mgr.running));
+  agent_log_cfg = saved_cfg;
+  unlink(first);
+  unlink(first_gz);
+  unlink(second);
+  rmdir(dir);
+}
@@ -22,6 +22,7 @@
 #include <shared/adm/adm.h>
 #include <shared/msg/msg_if.h>
 #include <agent/instr.h>
+#include <agent/lcc.h>
 #include <agent/ldc.h>
 #include <agent/rda.h>
 #include <agent/ingest.h>
@@ -30,12 +31,17 @@
 #include <semaphore.h>
 #include <stdbool.h>
 #include <stdatomic.h>
+#include <time.h>
 
 /// Agent state for all tests
 static nmagent_t agent;
 
 static atomic_int test_count;
 static sem_t test_done;
+/// Number of sends for the transport to reject before accepting
+static atomic_int test_send_reject;
+/// Key left out of the table built for deltas, if any
+static uint32_t test_tbl_gone_key = UINT32_MAX;
 
 /** A simple EDD
  */
@@ -44,6 +50,13 @@ tnv_t * _test_edd_5(tnvc_t *params)
     return tnv_from_real32(1.5);
 }
 
+/** An EDD which reports its parameter.
+ */
+static tnv_t * _test_edd_parm(tnvc_t *params)
+{
+  return tnv_copy_ptr(tnvc_get(params, 0));
+}
+
 /** A control that produces a report if given a parameter.
  */
 tnv_t * _test_ctrl(eid_t *def_mgr, tnvc_t *params, int8_t *status)
@@ -56,12 +69,12 @@ tnv_t * _test_ctrl(eid_t *def_mgr, tnvc_t *params, int8_t *status)
   }
 
   *status = CTRL_SUCCESS;
-  if (!params || (vec_num_entries(params->values) == 0))
+  if (!params || (tnvc_size(params) == 0))
   {
     printf("No parameters\n");
     return NULL;
   }
-  tnv_t *param0 = vec_at(&(params->values), 0);
+  tnv_t *param0 = tnvc_get(params, 0);
   int success;
   printf("Parameter 0: %d\n", tnv_to_int(*param0, &success));
   return tnv_copy_ptr(param0);
@@ -70,6 +83,11 @@ tnv_t * _test_ctrl(eid_t *def_mgr, tnvc_t *params, int8_t *status)
 static int _test_send(const blob_t *data, const eid_t *dest, void *ctx)
 {
   printf("Called send to %s!\n", dest);
+  if (test_send_reject > 0)
+  {
+    --test_send_reject;
+    return AMP_FAIL;
+  }
   --test_count;
   if(test_count <= 0)
   {
@@ -120,6 +138,8 @@ void setUp(void) {
   agent_instr_init();
 
   test_count = 0;
+  test_send_reject = 0;
+  test_tbl_gone_key = UINT32_MAX;
   TEST_ASSERT_EQUAL_INT(0, sem_init(&test_done, 0, 0));
   TEST_ASSERT_EQUAL_INT(0, sem_init(&rx_blob_write, 0, 1));
   TEST_ASSERT_EQUAL_INT(0, sem_init(&rx_blob_read, 0, 0));
@@ -198,6 +218,44 @@ void test_rda_ctrls(void)
   TEST_ASSERT_EQUAL_INT(0, pthread_mutex_unlock(&(gAgentDb.rpt_msgs.lock)));
 }
 
+void test_rda_ctrls_deferred(void)
+{
+  pthread_t thr;
+  TEST_ASSERT_EQUAL_INT(0, pthread_create(&thr, NULL, rda_ctrls, &agent));
+  TEST_ASSERT_EQUAL_INT(OS_SUCCESS, OS_TaskDelay(1));
+  test_count = 2;
+
+  // A later control queued before an immediate one
+  OS_time_t nowtime;
+  OS_GetLocalTime(&nowtime);
+  ari_t *id = adm_build_ari(AMP_TYPE_CTRL, true, 12, 34);
+  ctrl_t *later = ctrl_create(id);
+  ctrl_t *now = ctrl_create(id);
+  ari_release(id, true);
+  TEST_ASSERT_NOT_NULL(later);
+  TEST_ASSERT_NOT_NULL(now);
+  later->start = OS_TimeAdd(nowtime, OS_TimeFromTotalMilliseconds(500));
+  now->start = OS_TimeFromTotalSeconds(0);
+
+  timeq_handle_t handle = 0;
+  TEST_ASSERT_EQUAL_INT(AMP_OK, VDB_ADD_CTRL(later, &handle));
+  TEST_ASSERT_EQUAL_PTR(later, VDB_FINDIDX_CTRL(handle));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, VDB_ADD_CTRL(now, NULL));
+
+  // wait for completion
+  struct timespec timeout;
+  clock_gettime(CLOCK_REALTIME, &timeout);
+  timeout.tv_sec += 10;
+  TEST_ASSERT_EQUAL_INT(0, sem_timedwait(&test_done, &timeout));
+  TEST_ASSERT_EQUAL_INT(0, test_count);
+  TEST_ASSERT_EQUAL_INT(0, timeq_size(&(gVDB.inst.ctrls)));
+  TEST_ASSERT_NULL(VDB_FINDIDX_CTRL(handle));
+
+  daemon_run_stop(&agent.running);
+  rda_signal_shutdown();
+  TEST_ASSERT_EQUAL_INT(NULL, pthread_join(thr, NULL));
+}
+
 void test_rda_ctrls_report(void)
 {
   TEST_ASSERT_EQUAL_INT(0, pthread_mutex_lock(&(gAgentDb.rpt_msgs.lock)));
@@ -240,8 +298,8 @@ void test_rda_ctrls_report(void)
     TEST_ASSERT_EQUAL_INT(1, vec_num_entries(msg->rpts));
     rpt_t *rpt = vec_at(&(msg->rpts), 0);
     TEST_ASSERT_NOT_NULL(rpt);
-    TEST_ASSERT_EQUAL_INT(1, vec_num_entries(rpt->entries->values));
-    tnv_t *val = vec_at(&(rpt->entries->values), 0);
+    TEST_ASSERT_EQUAL_INT(1, tnvc_size(rpt->entries));
+    tnv_t *val = tnvc_get(rpt->entries, 0);
     TEST_ASSERT_NOT_NULL(val);
     TEST_ASSERT_EQUAL(AMP_TYPE_INT, val->type);
     int success;
@@ -286,6 +344,145 @@ void test_rda_rules_tbr(void)
   TEST_ASSERT_EQUAL_INT(NULL, pthread_join(thr, NULL));
 }
 
+void test_rda_pool_instance(void)
+{
+  nmagent_t virt;
+  nmagent_pool_t pool;
+  TEST_ASSERT_TRUE(nmagent_init_instance(&virt));
+  TEST_ASSERT_TRUE(nmagent_pool_init(&pool, 2));
+  TEST_ASSERT_TRUE(nmagent_pool_add(&pool, &virt));
+  test_count = 2;
+
+  // Objects given to the other agent are not seen by this one
+  nmagent_select(&virt);
+  TEST_ASSERT_EQUAL_INT(AMP_OK, rda_init());
+
+  ari_t *id = adm_build_ari(AMP_TYPE_TBR, false, 12, 56);
+  tbr_def_t def;
+  def.period = OS_TimeFromTotalSeconds(1);
+  def.max_fire = test_count;
+
+  ac_t action;
+  ac_init(&action);
+  ac_insert(&action, adm_build_ari(AMP_TYPE_CTRL, true, 12, 34));
+
+  rule_t *tbr = rule_create_tbr(*id, OS_TimeFromTotalSeconds(0), def, action);
+  TEST_ASSERT_NOT_NULL(tbr);
+  TEST_ASSERT_EQUAL_INT(RH_OK, VDB_ADD_RULE(&(tbr->id), tbr));
+  nmagent_select(NULL);
+  TEST_ASSERT_NULL(VDB_FINDKEY_RULE(id));
+  ari_release(id, true);
+
+  TEST_ASSERT_TRUE(nmagent_pool_start(&pool));
+
+  // wait for completion
+  struct timespec timeout;
+  clock_gettime(CLOCK_REALTIME, &timeout);
+  timeout.tv_sec += 10;
+  TEST_ASSERT_EQUAL_INT(0, sem_timedwait(&test_done, &timeout));
+  TEST_ASSERT_EQUAL_INT(0, test_count);
+
+  TEST_ASSERT_TRUE(nmagent_pool_stop(&pool));
+  TEST_ASSERT_EQUAL_INT(0, virt.vdb->rules.num_elts);
+  TEST_ASSERT_EQUAL_INT(0, gVDB.inst.rules.num_elts);
+
+  nmagent_select(&virt);
+  rda_cleanup();
+  nmagent_select(NULL);
+  nmagent_pool_destroy(&pool);
+  nmagent_destroy(&virt);
+}
+
+/// More agents than a ::vector_t can hold
+#define TEST_POOL_AGENTS (VEC_MAX_IDX + 28)
+
+void test_rda_pool_many(void)
+{
+  nmagent_t *virt = calloc(TEST_POOL_AGENTS, sizeof(nmagent_t));
+  nmagent_pool_t pool;
+  TEST_ASSERT_NOT_NULL(virt);
+  TEST_ASSERT_TRUE(nmagent_pool_init(&pool, 4));
+  test_count = TEST_POOL_AGENTS;
+
+  ari_t *ctrl_id = adm_build_ari(AMP_TYPE_CTRL, true, 12, 34);
+  ctrldef_t *ctrl_def = VDB_FINDKEY_CTRLDEF(ctrl_id);
+  TEST_ASSERT_NOT_NULL(ctrl_def);
+  ari_t *var_id = adm_build_ari(AMP_TYPE_VAR, false, 12, 90);
+  ari_t *adm_var_id = adm_build_ari(AMP_TYPE_VAR, false, 12, 91);
+  tnv_t *val = tnv_from_uvast(3);
+  TEST_ASSERT_EQUAL_INT(AMP_OK, adm_add_var_from_tnv(ari_copy_ptr(adm_var_id), *val));
+
+  // A variable of the process's own agent
+  var_t *var = var_create_from_tnv(ari_copy_ptr(var_id), *val);
+  TEST_ASSERT_EQUAL_INT(RH_OK, VDB_ADD_VAR(var->id, var));
+
+  for (int ix = 0; ix < TEST_POOL_AGENTS; ++ix)
+  {
+    TEST_ASSERT_TRUE(nmagent_init_instance(&virt[ix]));
+    TEST_ASSERT_TRUE(nmagent_pool_add(&pool, &virt[ix]));
+
+    nmagent_select(&virt[ix]);
+    TEST_ASSERT_EQUAL_INT(AMP_OK, rda_init());
+
+    // Each agent sees ADM objects, but not those given to other agents
+    TEST_ASSERT_NOT_NULL(VDB_FINDKEY_VAR(adm_var_id));
+    TEST_ASSERT_NULL(VDB_FINDKEY_VAR(var_id));
+    if (ix == 0)
+    {
+      TEST_ASSERT_EQUAL_INT(AMP_OK, ctrldef_set_class(ctrl_def, AMP_PRIO_BULK));
+      var = var_create_from_tnv(ari_copy_ptr(var_id), *val);
+      TEST_ASSERT_EQUAL_INT(RH_OK, VDB_ADD_VAR(var->id, var));
+    }
+    TEST_ASSERT_EQUAL_UINT8((ix == 0) ? AMP_PRIO_BULK : AMP_PRIO_INHERIT, ctrldef_get_class(ctrl_def));
+
+    ari_t *id = adm_build_ari(AMP_TYPE_TBR, false, 12, 56);
+    tbr_def_t def;
+    def.period = OS_TimeFromTotalSeconds(1);
+    def.max_fire = 1;
+
+    ac_t action;
+    ac_init(&action);
+    ac_insert(&action, ari_copy_ptr(ctrl_id));
+
+    rule_t *tbr = rule_create_tbr(*id, OS_TimeFromTotalSeconds(0), def, action);
+    ari_release(id, true);
+    TEST_ASSERT_NOT_NULL(tbr);
+    TEST_ASSERT_EQUAL_INT(RH_OK, VDB_ADD_RULE(&(tbr->id), tbr));
+  }
+  nmagent_select(NULL);
+  tnv_release(val, 1);
+
+  // The shared definition is unchanged by any one agent
+  TEST_ASSERT_EQUAL_UINT8(AMP_PRIO_INHERIT, ctrl_def->prio);
+  TEST_ASSERT_EQUAL_UINT8(AMP_PRIO_INHERIT, ctrldef_get_class(ctrl_def));
+  TEST_ASSERT_NOT_NULL(VDB_FINDKEY_VAR(var_id));
+  TEST_ASSERT_EQUAL_INT(0, gVDB.inst.rules.num_elts);
+
+  TEST_ASSERT_TRUE(nmagent_pool_start(&pool));
+
+  // Every agent runs its rule once
+  struct timespec timeout;
+  clock_gettime(CLOCK_REALTIME, &timeout);
+  timeout.tv_sec += 10;
+  TEST_ASSERT_EQUAL_INT(0, sem_timedwait(&test_done, &timeout));
+  TEST_ASSERT_EQUAL_INT(0, test_count);
+
+  TEST_ASSERT_TRUE(nmagent_pool_stop(&pool));
+  for (int ix = 0; ix < TEST_POOL_AGENTS; ++ix)
+  {
+    TEST_ASSERT_EQUAL_INT(0, virt[ix].vdb->rules.num_elts);
+    nmagent_select(&virt[ix]);
+    rda_cleanup();
+    nmagent_select(NULL);
+    nmagent_destroy(&virt[ix]);
+  }
+  nmagent_pool_destroy(&pool);
+  free(virt);
+  ari_release(ctrl_id, true);
+  ari_release(var_id, true);
+  ari_release(adm_var_id, true);
+}
+
 void test_rda_reports(void)
 {
   pthread_t thr;
@@ -325,6 +522,698 @@ void test_rda_reports(void)
   TEST_ASSERT_EQUAL_INT(NULL, pthread_join(thr, NULL));
 }
 
+void test_rda_reports_held(void)
+{
+  // Retry soon after the transport rejects a send
+  outq_cfg_t cfg = { .retry_ms = 10 };
+  TEST_ASSERT_EQUAL_INT(AMP_OK, outq_open(&(gAgentDb.outq), &cfg));
+
+  pthread_t thr;
+  TEST_ASSERT_EQUAL_INT(0, pthread_create(&thr, NULL, rda_reports, &agent));
+  TEST_ASSERT_EQUAL_INT(OS_SUCCESS, OS_TaskDelay(1));
+  test_count = 1;
+  test_send_reject = 1;
+
+  eid_t recip;
+  strncpy(recip.name, "dtn:none", AMP_MAX_EID_LEN);
+  msg_rpt_t *msg_rpt = rda_get_msg_rpt(recip);
+  TEST_ASSERT_NOT_NULL(msg_rpt);
+
+  ari_t *id = adm_build_ari(AMP_TYPE_RPT, false, 12, 78);
+  TEST_ASSERT_NOT_NULL(id);
+  rpt_t *rpt = rpt_create(id, OS_TimeFromTotalSeconds(0), NULL);
+  TEST_ASSERT_NOT_NULL(rpt);
+  TEST_ASSERT_EQUAL_INT(AMP_OK, rpt_add_entry(rpt, tnv_from_int(567)));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, msg_rpt_add_rpt(msg_rpt, rpt));
+
+  pthread_mutex_lock(&gAgentDb.rpt_msgs.lock);
+  pthread_cond_signal(&gAgentDb.rpt_msgs.cond_ins_mod);
+  pthread_mutex_unlock(&gAgentDb.rpt_msgs.lock);
+
+  // the first send is rejected, the retry is not
+  struct timespec timeout;
+  clock_gettime(CLOCK_REALTIME, &timeout);
+  timeout.tv_sec += 10;
+  TEST_ASSERT_EQUAL_INT(0, sem_timedwait(&test_done, &timeout));
+  TEST_ASSERT_EQUAL_INT(0, test_count);
+  TEST_ASSERT_EQUAL_INT(0, test_send_reject);
+
+  daemon_run_stop(&agent.running);
+  rda_signal_shutdown();
+  TEST_ASSERT_EQUAL_INT(NULL, pthread_join(thr, NULL));
+
+  TEST_ASSERT_EQUAL_INT(0, outq_size(&(gAgentDb.outq)));
+  TEST_ASSERT_EQUAL_INT(1, agent_instr_get(AGENT_INSTR_SENT_RPTS));
+}
+
+void test_rda_reports_class(void)
+{
+  // A rate limit which any one report uses up
+  outq_cfg_t cfg = { .rate = 1, .burst = 1 };
+  TEST_ASSERT_EQUAL_INT(AMP_OK, outq_open(&(gAgentDb.outq), &cfg));
+
+  eid_t recip;
+  strncpy(recip.name, "dtn:none", AMP_MAX_EID_LEN);
+  const uint8_t classes[] = { AMP_PRIO_NORMAL, AMP_PRIO_NORMAL, AMP_PRIO_URGENT };
+  for (size_t ix = 0; ix < sizeof(classes); ++ix)
+  {
+    const uint8_t prev = lcc_set_class(classes[ix]);
+    msg_rpt_t *msg_rpt = rda_get_msg_rpt(recip);
+    lcc_set_class(prev);
+    TEST_ASSERT_NOT_NULL(msg_rpt);
+    TEST_ASSERT_EQUAL_INT(classes[ix], msg_rpt->prio);
+
+    ari_t *id = adm_build_ari(AMP_TYPE_RPT, false, 12, 78);
+    TEST_ASSERT_NOT_NULL(id);
+    rpt_t *rpt = rpt_create(id, OS_TimeFromTotalSeconds(0), NULL);
+    TEST_ASSERT_NOT_NULL(rpt);
+    TEST_ASSERT_EQUAL_INT(AMP_OK, rpt_add_entry(rpt, tnv_from_int(567)));
+    TEST_ASSERT_EQUAL_INT(AMP_OK, msg_rpt_add_rpt(msg_rpt, rpt));
+
+    TEST_ASSERT_EQUAL_INT(AMP_OK, rda_send_reports(&agent));
+  }
+
+  // the second report is over the limit, the urgent one is exempt
+  TEST_ASSERT_EQUAL_INT(1, outq_size(&(gAgentDb.outq)));
+  TEST_ASSERT_EQUAL_INT(2, agent_instr_get(AGENT_INSTR_SENT_RPTS));
+
+  outq_stats_t stats;
+  TEST_ASSERT_EQUAL_INT(AMP_OK, outq_get_stats(&(gAgentDb.outq), AMP_PRIO_NORMAL, &stats));
+  TEST_ASSERT_EQUAL_INT(1, stats.held);
+  TEST_ASSERT_EQUAL_INT(1, stats.sent);
+  TEST_ASSERT_EQUAL_INT(AMP_OK, outq_get_stats(&(gAgentDb.outq), AMP_PRIO_URGENT, &stats));
+  TEST_ASSERT_EQUAL_INT(0, stats.held);
+  TEST_ASSERT_EQUAL_INT(1, stats.sent);
+}
+
+void test_lcc_macro_compiled(void)
+{
+  // Inner macro maps its one parm into its control
+  macdef_t *inner = macdef_create(1, adm_build_ari(AMP_TYPE_MAC, false, 12, 40));
+  TEST_ASSERT_NOT_NULL(inner);
+  ari_t *id = adm_build_ari(AMP_TYPE_CTRL, true, 12, 34);
+  ari_add_parm_val(id, tnv_from_map(AMP_TYPE_INT, 0));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, adm_add_macdef_ctrl(inner, id));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, adm_add_macdef(inner));
+
+  // Outer macro runs a control, then the inner macro with a literal parm
+  macdef_t *outer = macdef_create(2, adm_build_ari(AMP_TYPE_MAC, false, 12, 41));
+  TEST_ASSERT_NOT_NULL(outer);
+  id = adm_build_ari(AMP_TYPE_CTRL, true, 12, 34);
+  ari_add_parm_val(id, tnv_from_int(567));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, adm_add_macdef_ctrl(outer, id));
+  id = adm_build_ari(AMP_TYPE_MAC, true, 12, 40);
+  ari_add_parm_val(id, tnv_from_int(890));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, adm_add_macdef_ctrl(outer, id));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, adm_add_macdef(outer));
+
+  // Compiled once complete, not as each control is added
+  TEST_ASSERT_NULL(outer->steps);
+  TEST_ASSERT_EQUAL_INT(AMP_OK, macdef_compile(outer));
+  TEST_ASSERT_NOT_NULL(outer->steps);
+  TEST_ASSERT_EQUAL_INT(2, outer->num_steps);
+  TEST_ASSERT_EQUAL_INT(2, outer->num_macs);
+
+  eid_t rx = { "dtn:none" };
+  TEST_ASSERT_EQUAL_INT(AMP_OK, lcc_run_macro(outer, NULL, &rx));
+  TEST_ASSERT_EQUAL_INT(2, agent_instr_get(AGENT_INSTR_MACROS_RUN));
+  TEST_ASSERT_EQUAL_INT(2, agent_instr_get(AGENT_INSTR_CTRLS_RUN));
+
+  // Both return values went out in one message
+  TEST_ASSERT_EQUAL_INT(1, vec_num_entries(gAgentDb.rpt_msgs));
+  msg_rpt_t *msg = vec_at(&(gAgentDb.rpt_msgs), 0);
+  TEST_ASSERT_NOT_NULL(msg);
+  TEST_ASSERT_EQUAL_INT(2, vec_num_entries(msg->rpts));
+  rpt_t *rpt = vec_at(&(msg->rpts), 1);
+  TEST_ASSERT_NOT_NULL(rpt);
+  int success;
+  TEST_ASSERT_EQUAL_INT(890, tnv_to_int(*tnvc_get(rpt->entries, 0), &success));
+
+  // Steps own their controls, so changing the inner macro leaves them intact
+  macdef_clear(inner);
+  TEST_ASSERT_EQUAL_INT(AMP_OK, lcc_run_macro(outer, NULL, &rx));
+  TEST_ASSERT_EQUAL_INT(4, agent_instr_get(AGENT_INSTR_CTRLS_RUN));
+  TEST_ASSERT_EQUAL_INT(4, vec_num_entries(msg->rpts));
+  rpt = vec_at(&(msg->rpts), 3);
+  TEST_ASSERT_NOT_NULL(rpt);
+  TEST_ASSERT_EQUAL_INT(890, tnv_to_int(*tnvc_get(rpt->entries, 0), &success));
+}
+
+void test_lcc_run_ac_borrowed(void)
+{
+  // A rule whose control has a literal parm and none mapped
+  ari_t *id = adm_build_ari(AMP_TYPE_TBR, false, 12, 57);
+  tbr_def_t def;
+  def.period = OS_TimeFromTotalSeconds(1);
+  def.max_fire = 2;
+
+  ac_t action;
+  ac_init(&action);
+  ari_t *ctrl_id = adm_build_ari(AMP_TYPE_CTRL, true, 12, 34);
+  ari_add_parm_val(ctrl_id, tnv_from_int(567));
+  ac_insert(&action, ctrl_id);
+
+  rule_t *tbr = rule_create_tbr(*id, OS_TimeFromTotalSeconds(0), def, action);
+  ari_release(id, true);
+  TEST_ASSERT_NOT_NULL(tbr);
+
+  ari_t *bound = ac_get(&(tbr->action), 0);
+  TEST_ASSERT_NOT_NULL(bound);
+  tnv_t *parm = tnvc_get(&(bound->as_reg.parms), 0);
+  TEST_ASSERT_NOT_NULL(parm);
+  const tnv_t before = *parm;
+
+  // Fired twice as rda_rules() does, each run reporting the parm
+  test_count = 2;
+  TEST_ASSERT_EQUAL_INT(AMP_OK, lcc_run_ac(&(tbr->action), &(tbr->id.as_reg.parms)));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, lcc_run_ac(&(tbr->action), &(tbr->id.as_reg.parms)));
+  TEST_ASSERT_EQUAL_INT(0, test_count);
+  TEST_ASSERT_EQUAL_INT(2, agent_instr_get(AGENT_INSTR_CTRLS_RUN));
+
+  // The controls only borrowed the parm, so it is as it was
+  int success;
+  TEST_ASSERT_EQUAL_INT(1, tnvc_size(&(bound->as_reg.parms)));
+  TEST_ASSERT_EQUAL_PTR(parm, tnvc_get(&(bound->as_reg.parms), 0));
+  TEST_ASSERT_EQUAL_INT(before.type, parm->type);
+  TEST_ASSERT_EQUAL_INT(before.flags, parm->flags);
+  TEST_ASSERT_EQUAL_INT(567, tnv_to_int(*parm, &success));
+  TEST_ASSERT_EQUAL_INT(1, success);
+
+  // and each run reported it
+  TEST_ASSERT_EQUAL_INT(1, vec_num_entries(gAgentDb.rpt_msgs));
+  msg_rpt_t *msg = vec_at(&(gAgentDb.rpt_msgs), 0);
+  TEST_ASSERT_NOT_NULL(msg);
+  TEST_ASSERT_EQUAL_INT(2, vec_num_entries(msg->rpts));
+  for (int ix = 0; ix < 2; ++ix)
+  {
+    rpt_t *rpt = vec_at(&(msg->rpts), ix);
+    TEST_ASSERT_NOT_NULL(rpt);
+    tnv_t *val = tnvc_get(rpt->entries, 0);
+    TEST_ASSERT_NOT_NULL(val);
+    TEST_ASSERT_EQUAL_INT(567, tnv_to_int(*val, &success));
+  }
+
+  rule_release(tbr, true);
+}
+
+void test_ldc_fill_rpt_mapped(void)
+{
+  TEST_ASSERT_EQUAL_INT(AMP_OK, adm_add_edd(adm_build_ari(AMP_TYPE_EDD, true, 12, 6), _test_edd_parm));
+
+  // A template whose item takes the first parm of the template
+  rpttpl_t *tpl = rpttpl_create_id(adm_build_ari(AMP_TYPE_RPTTPL, true, 12, 79));
+  TEST_ASSERT_NOT_NULL(tpl);
+  TEST_ASSERT_EQUAL_INT(0, tpl->mapped);
+  ari_t *item = adm_build_ari(AMP_TYPE_EDD, true, 12, 6);
+  ari_add_parm_val(item, tnv_from_map(AMP_TYPE_INT, 0));
+  TEST_ASSERT_EQUAL_INT(VEC_OK, rpttpl_add_item(tpl, item));
+  TEST_ASSERT_EQUAL_INT(1, tpl->mapped);
+
+  // A report of it gets the value given for the parm
+  ari_t *rpt_id = adm_build_ari(AMP_TYPE_RPTTPL, true, 12, 79);
+  ari_add_parm_val(rpt_id, tnv_from_int(321));
+  rpt_t *rpt = rpt_create(rpt_id, OS_TimeFromTotalSeconds(0), NULL);
+  TEST_ASSERT_NOT_NULL(rpt);
+  TEST_ASSERT_EQUAL_INT(AMP_OK, ldc_fill_rpt(tpl, rpt));
+  TEST_ASSERT_EQUAL_INT(1, tnvc_size(rpt->entries));
+  tnv_t *val = tnvc_get(rpt->entries, 0);
+  TEST_ASSERT_NOT_NULL(val);
+  int success;
+  TEST_ASSERT_EQUAL_INT(321, tnv_to_int(*val, &success));
+  TEST_ASSERT_EQUAL_INT(1, success);
+
+  // while the item itself stays mapped
+  tnv_t *parm = tnvc_get(&(item->as_reg.parms), 0);
+  TEST_ASSERT_NOT_NULL(parm);
+  TEST_ASSERT_TRUE(TNV_IS_MAP(parm->flags));
+  TEST_ASSERT_EQUAL_INT(0, parm->value.as_uint);
+
+  rpt_release(rpt, true);
+  rpttpl_release(tpl, true);
+}
+
+void test_ari_resolve_parms_view(void)
+{
+  tnvc_t parent;
+  tnvc_t src;
+  tnvc_t view;
+  TEST_ASSERT_EQUAL_INT(AMP_OK, tnvc_init(&parent, 1));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, tnvc_insert(&parent, tnv_from_int(11)));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, tnvc_init(&src, 2));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, tnvc_insert(&src, tnv_from_int(22)));
+
+  // Nothing mapped, so the source is used as it is
+  TEST_ASSERT_EQUAL_PTR(&src, ari_resolve_parms_view(&src, &parent, &view));
+
+  // A mapped parm is borrowed from the parent, the rest from the source
+  TEST_ASSERT_EQUAL_INT(AMP_OK, tnvc_insert(&src, tnv_from_map(AMP_TYPE_INT, 0)));
+  tnvc_t *parms = ari_resolve_parms_view(&src, &parent, &view);
+  TEST_ASSERT_EQUAL_PTR(&view, parms);
+  TEST_ASSERT_EQUAL_INT(2, tnvc_size(parms));
+  int success;
+  TEST_ASSERT_EQUAL_INT(22, tnv_to_int(*tnvc_get(parms, 0), &success));
+  TEST_ASSERT_EQUAL_INT(11, tnv_to_int(*tnvc_get(parms, 1), &success));
+  TEST_ASSERT_FALSE(TNV_IS_ALLOC(tnvc_get(parms, 1)->flags));
+  ari_release_parms_view(parms, &view);
+
+  // A map past the end of the parent fails
+  tnvc_get(&src, 1)->value.as_uint = 1;
+  TEST_ASSERT_NULL(ari_resolve_parms_view(&src, &parent, &view));
+
+  tnvc_release(&src, false);
+  tnvc_release(&parent, false);
+}
+
+static int _test_kernel_calls;
+
+static int _test_kernel(const tnv_t *args, tnv_t *result)
+{
+  if ((args[0].type != AMP_TYPE_INT) || (args[1].type != AMP_TYPE_INT))
+  {
+    return AMP_FAIL;
+  }
+  ++_test_kernel_calls;
+  tnv_init(result, AMP_TYPE_INT);
+  result->value.as_int = args[0].value.as_int + args[1].value.as_int;
+  return AMP_OK;
+}
+
+static tnv_t *_test_apply(vector_t *stack)
+{
+  int success;
+  tnv_release(vec_pop(stack, &success), 1);
+  tnv_release(vec_pop(stack, &success), 1);
+  return tnv_from_int(-1);
+}
+
+static ari_t *_test_lit(amp_type_e type, uint32_t val)
+{
+  ari_t *ari = ari_create(AMP_TYPE_LIT);
+  tnv_init(&(ari->as_lit), type);
+  ari->as_lit.value.as_uint = val;
+  return ari;
+}
+
+static int32_t _test_eval_op(amp_type_e ltype)
+{
+  expr_t *expr = expr_create(AMP_TYPE_INT);
+  int success;
+  expr_add_item(expr, _test_lit(ltype, 2));
+  expr_add_item(expr, _test_lit(AMP_TYPE_INT, 3));
+  expr_add_item(expr, adm_build_ari(AMP_TYPE_OPER, false, 12, 50));
+
+  tnv_t *val = expr_eval(expr);
+  TEST_ASSERT_NOT_NULL(val);
+  int32_t result = tnv_to_int(*val, &success);
+  tnv_release(val, 1);
+  expr_release(expr, 1);
+  return result;
+}
+
+void test_expr_eval_kernel(void)
+{
+  TEST_ASSERT_EQUAL_INT(AMP_OK,
+                        adm_add_op_kernel(adm_build_ari(AMP_TYPE_OPER, false, 12, 50), 2, _test_apply, _test_kernel));
+  _test_kernel_calls = 0;
+
+  // Operands the kernel handles never reach the generic function
+  TEST_ASSERT_EQUAL_INT(5, _test_eval_op(AMP_TYPE_INT));
+  TEST_ASSERT_EQUAL_INT(1, _test_kernel_calls);
+
+  // Others fall back to it
+  TEST_ASSERT_EQUAL_INT(-1, _test_eval_op(AMP_TYPE_UINT));
+  TEST_ASSERT_EQUAL_INT(1, _test_kernel_calls);
+}
+
+/// Number of EDDs defined to look up by interned identity
+#define TEST_NUM_EDDS 32
+
+void test_ari_intern(void)
+{
+  ari_t *interned[TEST_NUM_EDDS];
+  ari_t *plain[TEST_NUM_EDDS];
+
+  for (int ix = 0; ix < TEST_NUM_EDDS; ++ix)
+  {
+    ari_t *id = adm_build_ari(AMP_TYPE_EDD, false, 12, 1000 + ix);
+    TEST_ASSERT_NOT_NULL(id);
+    TEST_ASSERT_EQUAL_INT(AMP_OK, adm_add_edd(id, _test_edd_5));
+
+    interned[ix] = adm_build_ari(AMP_TYPE_EDD, false, 12, 1000 + ix);
+    TEST_ASSERT_NOT_NULL(interned[ix]);
+    TEST_ASSERT_NOT_NULL(interned[ix]->as_reg.ident);
+    // Same identity as the definition, as any other lookup key would be
+    TEST_ASSERT_EQUAL_PTR(id->as_reg.ident, interned[ix]->as_reg.ident);
+
+    // Lookup without the interned identity finds the same definition
+    plain[ix] = ari_copy_ptr(interned[ix]);
+    TEST_ASSERT_NOT_NULL(plain[ix]);
+    plain[ix]->as_reg.ident = NULL;
+    TEST_ASSERT_NOT_NULL(VDB_FINDKEY_EDD(interned[ix]));
+    TEST_ASSERT_EQUAL_PTR(VDB_FINDKEY_EDD(interned[ix]), VDB_FINDKEY_EDD(plain[ix]));
+  }
+
+  // A received ARI shares the identity of an ADM object
+  int success;
+  blob_t *data = ari_serialize_wrapper(interned[3]);
+  TEST_ASSERT_NOT_NULL(data);
+  ari_t *rx = ari_deserialize_raw(data, &success);
+  TEST_ASSERT_EQUAL_INT(AMP_OK, success);
+  TEST_ASSERT_NOT_NULL(rx);
+  TEST_ASSERT_EQUAL_PTR(interned[3]->as_reg.ident, rx->as_reg.ident);
+  ari_release(rx, 1);
+  blob_release(data, 1);
+
+  // but doesn't intern one of its own, which would never be freed
+  ari_t *other = ari_copy_ptr(plain[0]);
+  TEST_ASSERT_NOT_NULL(other);
+  blob_release(&(other->as_reg.name), 0);
+  TEST_ASSERT_EQUAL_INT(AMP_OK, cut_enc_uvast(5000, &(other->as_reg.name)));
+  data = ari_serialize_wrapper(other);
+  TEST_ASSERT_NOT_NULL(data);
+  rx = ari_deserialize_raw(data, &success);
+  TEST_ASSERT_EQUAL_INT(AMP_OK, success);
+  TEST_ASSERT_NOT_NULL(rx);
+  TEST_ASSERT_NULL(rx->as_reg.ident);
+  TEST_ASSERT_NULL(VDB_FINDKEY_EDD(rx));
+  ari_release(rx, 1);
+  blob_release(data, 1);
+  ari_release(other, 1);
+
+  for (int ix = 0; ix < TEST_NUM_EDDS; ++ix)
+  {
+    ari_release(interned[ix], 1);
+    ari_release(plain[ix], 1);
+  }
+}
+
+/// Rows in the test table, more than a vector can hold
+#define TEST_TBL_NUM_ROWS 1000
+
+static tbl_t * _test_tblt_build(ari_t *id)
+{
+  tbl_t *tbl = tbl_create(id);
+  for (uint32_t ix = 0; ix < TEST_TBL_NUM_ROWS; ++ix)
+  {
+    TEST_ASSERT_EQUAL_INT(AMP_OK, tbl_append_uint(tbl, ix));
+    TEST_ASSERT_EQUAL_INT(AMP_OK, tbl_append_str(tbl, (ix % 2) ? "odd" : "even"));
+    TEST_ASSERT_EQUAL_INT(AMP_OK, tbl_append_uvast(tbl, 1000000000000ULL + ix));
+  }
+  return tbl;
+}
+
+void test_tbl_append(void)
+{
+  tblt_t *def = tblt_create(adm_build_ari(AMP_TYPE_TBLT, false, 12, 90), _test_tblt_build);
+  TEST_ASSERT_NOT_NULL(def);
+  TEST_ASSERT_EQUAL_INT(AMP_OK, tblt_add_col(def, AMP_TYPE_UINT, "index"));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, tblt_add_col(def, AMP_TYPE_STR, "parity"));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, tblt_add_col(def, AMP_TYPE_UVAST, "value"));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, adm_add_tblt(def));
+
+  tbl_t *tbl = def->build(def->id);
+  TEST_ASSERT_NOT_NULL(tbl);
+  TEST_ASSERT_EQUAL_INT(TEST_TBL_NUM_ROWS, tbl_num_rows(tbl));
+  // values must match their column
+  TEST_ASSERT_EQUAL_INT(AMP_FAIL, tbl_append_int(tbl, 1));
+  // and a mismatch partway through a row drops that row
+  TEST_ASSERT_EQUAL_INT(AMP_OK, tbl_append_uint(tbl, 100));
+  TEST_ASSERT_EQUAL_INT(AMP_FAIL, tbl_append_uint(tbl, 101));
+  TEST_ASSERT_EQUAL_INT(TEST_TBL_NUM_ROWS, tbl_num_rows(tbl));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, tbl_append_uint(tbl, 100));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, tbl_append_str(tbl, "even"));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, tbl_append_uvast(tbl, 5));
+  TEST_ASSERT_EQUAL_INT(TEST_TBL_NUM_ROWS + 1, tbl_num_rows(tbl));
+
+  // a received table holds the same values as rows
+  blob_t *data = tbl_serialize_wrapper(tbl);
+  TEST_ASSERT_NOT_NULL(data);
+  int success;
+  tbl_t *rx_tbl = tbl_deserialize_raw(data, &success);
+  TEST_ASSERT_EQUAL_INT(AMP_OK, success);
+  TEST_ASSERT_NOT_NULL(rx_tbl);
+  TEST_ASSERT_EQUAL_INT(TEST_TBL_NUM_ROWS + 1, tbl_num_rows(rx_tbl));
+
+  tnv_t cell;
+  TEST_ASSERT_EQUAL_INT(AMP_OK, tbl_get_cell(rx_tbl, 7, 1, &cell));
+  TEST_ASSERT_EQUAL_INT(AMP_TYPE_STR, cell.type);
+  TEST_ASSERT_EQUAL_STRING("odd", (char *)cell.value.as_ptr);
+  TEST_ASSERT_EQUAL_INT(AMP_OK, tbl_get_cell(rx_tbl, 7, 2, &cell));
+  TEST_ASSERT_EQUAL_UINT64(1000000000007ULL, cell.value.as_uvast);
+  TEST_ASSERT_EQUAL_INT(AMP_OK, tbl_get_cell(rx_tbl, TEST_TBL_NUM_ROWS, 2, &cell));
+  TEST_ASSERT_EQUAL_UINT64(5, cell.value.as_uvast);
+  TEST_ASSERT_EQUAL_INT(AMP_FAIL, tbl_get_cell(rx_tbl, TEST_TBL_NUM_ROWS + 1, 0, &cell));
+
+  tbl_release(rx_tbl, 1);
+  blob_release(data, 1);
+  tbl_release(tbl, 1);
+}
+
+static tbl_t * _test_tblt_delta_build(ari_t *id)
+{
+  tbl_t *tbl = tbl_create(id);
+  for (uint32_t ix = 0; ix < TEST_TBL_NUM_ROWS; ++ix)
+  {
+    if (ix == test_tbl_gone_key)
+    {
+      continue;
+    }
+    TEST_ASSERT_EQUAL_INT(AMP_OK, tbl_append_uint(tbl, ix));
+    TEST_ASSERT_EQUAL_INT(AMP_OK, tbl_append_uvast(tbl, 2 * ix));
+  }
+  return tbl;
+}
+
+void test_tbl_delta(void)
+{
+  tblt_t *def = tblt_create(adm_build_ari(AMP_TYPE_TBLT, false, 12, 91), _test_tblt_delta_build);
+  TEST_ASSERT_NOT_NULL(def);
+  TEST_ASSERT_EQUAL_INT(AMP_OK, tblt_add_col(def, AMP_TYPE_UINT, "key"));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, tblt_add_col(def, AMP_TYPE_UVAST, "value"));
+  TEST_ASSERT_EQUAL_INT(AMP_FAIL, tblt_set_key(def, 0x4, NULL));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, tblt_set_key(def, 0x1, NULL));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, adm_add_tblt(def));
+
+  // change key 5, delete key 10, insert key TEST_TBL_NUM_ROWS
+  tbl_t *prev = def->build(def->id);
+  tbl_t *cur = tbl_create(def->id);
+  for (uint32_t ix = 0; ix <= TEST_TBL_NUM_ROWS; ++ix)
+  {
+    if (ix == 10)
+    {
+      continue;
+    }
+    TEST_ASSERT_EQUAL_INT(AMP_OK, tbl_append_uint(cur, ix));
+    TEST_ASSERT_EQUAL_INT(AMP_OK, tbl_append_uvast(cur, (ix == 5) ? 1 : 2 * ix));
+  }
+
+  tbl_delta_t *delta = tbl_delta_create(prev, cur, def->key);
+  TEST_ASSERT_NOT_NULL(delta);
+  TEST_ASSERT_EQUAL_INT(2, tbl_num_rows(delta->rows));
+  TEST_ASSERT_EQUAL_INT(1, tbl_num_rows(delta->gone));
+  delta->base = 1;
+  delta->seq = 2;
+
+  // the manager rebuilds the table from a received delta
+  blob_t *data = cut_serialize_wrapper(TBL_DEFAULT_ENC_SIZE_SMALL, delta, tbl_delta_serialize);
+  TEST_ASSERT_NOT_NULL(data);
+  QCBORDecodeContext it;
+  QCBORDecode_Init(&it, (UsefulBufC){data->value, data->length}, QCBOR_DECODE_MODE_NORMAL);
+  int success;
+  tbl_delta_t *rx_delta = tbl_delta_deserialize_ptr(&it, &success);
+  TEST_ASSERT_EQUAL_INT(AMP_OK, success);
+  TEST_ASSERT_NOT_NULL(rx_delta);
+  TEST_ASSERT_EQUAL_INT(2, rx_delta->seq);
+
+  tbl_t *rx_tbl = tbl_delta_apply(prev, rx_delta);
+  TEST_ASSERT_NOT_NULL(rx_tbl);
+  TEST_ASSERT_EQUAL_INT(TEST_TBL_NUM_ROWS, tbl_num_rows(rx_tbl));
+  for (int row = 0; row < TEST_TBL_NUM_ROWS; ++row)
+  {
+    tnv_t want, got;
+    for (int col = 0; col < 2; ++col)
+    {
+      TEST_ASSERT_EQUAL_INT(AMP_OK, tbl_get_cell(cur, row, col, &want));
+      TEST_ASSERT_EQUAL_INT(AMP_OK, tbl_get_cell(rx_tbl, row, col, &got));
+      TEST_ASSERT_EQUAL_UINT64(want.value.as_uvast, got.value.as_uvast);
+    }
+  }
+
+  // duplicate keys can't be tracked
+  TEST_ASSERT_EQUAL_INT(AMP_OK, tbl_append_uint(cur, 0));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, tbl_append_uvast(cur, 0));
+  TEST_ASSERT_NULL(tbl_delta_create(prev, cur, def->key));
+
+  tbl_release(rx_tbl, 1);
+  tbl_delta_release(rx_delta, 1);
+  blob_release(data, 1);
+  tbl_delta_release(delta, 1);
+  tbl_release(cur, 1);
+  tbl_release(prev, 1);
+}
+
+void test_tbl_delta_dropped(void)
+{
+  tblt_t *def = tblt_create(adm_build_ari(AMP_TYPE_TBLT, false, 12, 92), _test_tblt_delta_build);
+  TEST_ASSERT_NOT_NULL(def);
+  TEST_ASSERT_EQUAL_INT(AMP_OK, tblt_add_col(def, AMP_TYPE_UINT, "key"));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, tblt_add_col(def, AMP_TYPE_UVAST, "value"));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, tblt_set_key(def, 0x1, NULL));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, adm_add_tblt(def));
+
+  // Hold everything, and drop anything larger than a few bytes
+  outq_cfg_t cfg = { .max_bytes = 16 };
+  TEST_ASSERT_EQUAL_INT(AMP_OK, outq_open(&(gAgentDb.outq), &cfg));
+  outq_set_link(&(gAgentDb.outq), false);
+
+  eid_t recip;
+  strncpy(recip.name, "dtn:none", AMP_MAX_EID_LEN);
+
+  // the whole table, then a delta against it
+  TEST_ASSERT_EQUAL_INT(AMP_OK, rda_add_tbl(recip, def, def->id));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, rda_add_tbl(recip, def, def->id));
+  msg_tbl_t *msg_tbl = rda_get_msg_tbl(recip);
+  TEST_ASSERT_NOT_NULL(msg_tbl);
+  TEST_ASSERT_EQUAL_INT(2, vec_num_entries(msg_tbl->deltas));
+  tbl_delta_t *first = vec_at(&(msg_tbl->deltas), 0);
+  tbl_delta_t *delta = vec_at(&(msg_tbl->deltas), 1);
+  TEST_ASSERT_EQUAL_INT(0, first->base);
+  TEST_ASSERT_EQUAL_INT(first->seq, delta->base);
+
+  // a message to the recipient is lost, so the next table is whole
+  uint8_t bytes[64] = { 0 };
+  blob_t data = { bytes, sizeof(bytes), sizeof(bytes) };
+  TEST_ASSERT_EQUAL_INT(AMP_SYSERR, outq_send(&(gAgentDb.outq), &agent.mif, &data, &recip, AMP_PRIO_BULK, 1,
+                                              OS_TimeFromTotalSeconds(0)));
+  TEST_ASSERT_EQUAL_UINT64(1, outq_dropped(&(gAgentDb.outq), &recip));
+
+  TEST_ASSERT_EQUAL_INT(AMP_OK, rda_add_tbl(recip, def, def->id));
+  TEST_ASSERT_EQUAL_INT(3, vec_num_entries(msg_tbl->deltas));
+  delta = vec_at(&(msg_tbl->deltas), 2);
+  TEST_ASSERT_EQUAL_INT(0, delta->base);
+  TEST_ASSERT_EQUAL_INT(TEST_TBL_NUM_ROWS, tbl_num_rows(delta->rows));
+
+  // and deltas follow it again
+  TEST_ASSERT_EQUAL_INT(AMP_OK, rda_add_tbl(recip, def, def->id));
+  delta = vec_at(&(msg_tbl->deltas), 3);
+  TEST_ASSERT_NOT_NULL(delta);
+  TEST_ASSERT_NOT_EQUAL(0, delta->base);
+}
+
+void test_tbl_delta_chain(void)
+{
+  tblt_t *def = tblt_create(adm_build_ari(AMP_TYPE_TBLT, false, 12, 93), _test_tblt_delta_build);
+  TEST_ASSERT_NOT_NULL(def);
+  TEST_ASSERT_EQUAL_INT(AMP_OK, tblt_add_col(def, AMP_TYPE_UINT, "key"));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, tblt_add_col(def, AMP_TYPE_UVAST, "value"));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, tblt_set_key(def, 0x1, NULL));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, adm_add_tblt(def));
+
+  // Hold everything
+  outq_cfg_t cfg = { .max_bytes = 1 << 20 };
+  TEST_ASSERT_EQUAL_INT(AMP_OK, outq_open(&(gAgentDb.outq), &cfg));
+  outq_set_link(&(gAgentDb.outq), false);
+
+  eid_t recip;
+  strncpy(recip.name, "dtn:none", AMP_MAX_EID_LEN);
+
+  // the whole table, then a chain of deltas each against the one before
+  for (int ix = 0; ix <= TBL_DELTA_MAX_CHAIN; ++ix)
+  {
+    TEST_ASSERT_EQUAL_INT(AMP_OK, rda_add_tbl(recip, def, def->id));
+  }
+  msg_tbl_t *msg_tbl = rda_get_msg_tbl(recip);
+  TEST_ASSERT_NOT_NULL(msg_tbl);
+  TEST_ASSERT_EQUAL_INT(TBL_DELTA_MAX_CHAIN + 1, vec_num_entries(msg_tbl->deltas));
+  tbl_delta_t *prev = vec_at(&(msg_tbl->deltas), 0);
+  TEST_ASSERT_EQUAL_INT(0, prev->base);
+  for (int ix = 1; ix <= TBL_DELTA_MAX_CHAIN; ++ix)
+  {
+    tbl_delta_t *delta = vec_at(&(msg_tbl->deltas), ix);
+    TEST_ASSERT_EQUAL_INT(prev->seq, delta->base);
+    prev = delta;
+  }
+
+  // a full chain is ended by the whole table, which needs no base,
+  // without the row deleted since the last delta
+  test_tbl_gone_key = 10;
+  TEST_ASSERT_EQUAL_INT(AMP_OK, rda_add_tbl(recip, def, def->id));
+  tbl_delta_t *whole = vec_at(&(msg_tbl->deltas), TBL_DELTA_MAX_CHAIN + 1);
+  TEST_ASSERT_NOT_NULL(whole);
+  TEST_ASSERT_EQUAL_INT(0, whole->base);
+  TEST_ASSERT_EQUAL_INT(TEST_TBL_NUM_ROWS - 1, tbl_num_rows(whole->rows));
+
+  // the manager replaces its table rather than applying it to the old one
+  tbl_t *rx_tbl = tbl_delta_apply(NULL, whole);
+  TEST_ASSERT_NOT_NULL(rx_tbl);
+  TEST_ASSERT_EQUAL_INT(TEST_TBL_NUM_ROWS - 1, tbl_num_rows(rx_tbl));
+  tbl_release(rx_tbl, 1);
+
+  // and a new chain follows it, of deltas again
+  TEST_ASSERT_EQUAL_INT(AMP_OK, rda_add_tbl(recip, def, def->id));
+  tbl_delta_t *delta = vec_at(&(msg_tbl->deltas), TBL_DELTA_MAX_CHAIN + 2);
+  TEST_ASSERT_NOT_NULL(delta);
+  TEST_ASSERT_EQUAL_INT(whole->seq, delta->base);
+  TEST_ASSERT_EQUAL_INT(0, tbl_num_rows(delta->rows));
+}
+
+void test_reg_add_find(void)
+{
+  reg_t reg;
+  reg_idx_t idx;
+  amp_uvast i;
+  uint8_t bytes[] = {0x01, 0x02, 0x03};
+  blob_t tag = {bytes, sizeof(bytes), sizeof(bytes)};
+
+  // Indices are dense, stable and survive the table growing
+  TEST_ASSERT_EQUAL_INT(AMP_OK, reg_init(&reg, REG_UVAST, 4));
+  for (i = 0; i < 1000; i++)
+  {
+    TEST_ASSERT_EQUAL_INT(AMP_OK, reg_add_uvast(&reg, i * 20, &idx));
+    TEST_ASSERT_EQUAL_INT(i, idx);
+  }
+  TEST_ASSERT_EQUAL_INT(AMP_OK, reg_add_uvast(&reg, 500 * 20, &idx));
+  TEST_ASSERT_EQUAL_INT(500, idx);
+  TEST_ASSERT_EQUAL_INT(1000, reg_size(&reg));
+  TEST_ASSERT_EQUAL_UINT64(999 * 20, *(amp_uvast *)reg_at(&reg, 999));
+  TEST_ASSERT_NULL(reg_at(&reg, 1000));
+  i = 7;
+  TEST_ASSERT_EQUAL_INT(AMP_FAIL, reg_find(&reg, &i, &idx));
+  reg_release(&reg);
+
+  TEST_ASSERT_EQUAL_INT(AMP_OK, reg_init(&reg, REG_BLOB, 4));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, reg_add_blob(&reg, tag, &idx));
+  TEST_ASSERT_EQUAL_INT(0, idx);
+  TEST_ASSERT_EQUAL_INT(AMP_OK, reg_find(&reg, &tag, &idx));
+  TEST_ASSERT_EQUAL_INT(0, idx);
+  TEST_ASSERT_EQUAL_INT(0, memcmp(bytes, ((blob_t *)reg_at(&reg, 0))->value, sizeof(bytes)));
+  reg_release(&reg);
+}
+
+void test_adm_add_descs(void)
+{
+  static const reg_idx_t nn[ADM_META_IDX + 1] = { [ADM_EDD_IDX] = 12 };
+  static const adm_desc_t descs[] = {
+    ADM_DESC_EDD(ADM_EDD_IDX, 20, 0, _test_edd_5),
+    ADM_DESC_EDD(ADM_EDD_IDX, 200, 0, _test_edd_5),
+    ADM_DESC_EDD(ADM_EDD_IDX, 2000, 0, _test_edd_5),
+    ADM_DESC_EDD(ADM_EDD_IDX, 200000, 0, _test_edd_5),
+  };
+  size_t i;
+
+  TEST_ASSERT_EQUAL_INT(AMP_OK, adm_add_descs(nn, descs, ADM_NUM_DESCS(descs)));
+
+  // Names encoded at build time match those encoded at startup
+  for (i = 0; i < ADM_NUM_DESCS(descs); i++)
+  {
+    ari_t *id = adm_build_ari(AMP_TYPE_EDD, false, 12, descs[i].id);
+    TEST_ASSERT_NOT_NULL(id);
+    TEST_ASSERT_NOT_NULL(VDB_FINDKEY_EDD(id));
+    ari_release(id, 1);
+  }
+  TEST_ASSERT_EQUAL_INT(0, descs[3].name_len);
+}
+
 void test_ldc_edd_value(void)
 {
   ari_t *id = adm_build_ari(AMP_TYPE_EDD, false, 12, 5);
@@ -339,6 +1228,126 @@ void test_ldc_edd_value(void)
   TEST_ASSERT_FLOAT_WITHIN(1.5, cval, 1e-6);
 }
 
+void test_instr_latency(void)
+{
+  agent_instr_lat_t summary;
+
+  // 98 fast values and two slow ones
+  for (int i = 0; i < 98; i++)
+  {
+    agent_instr_lat_record(AGENT_INSTR_LAT_CTRL_RUN, 10);
+  }
+  agent_instr_lat_record(AGENT_INSTR_LAT_CTRL_RUN, 1000);
+  agent_instr_lat_record(AGENT_INSTR_LAT_CTRL_RUN, 5000);
+
+  agent_instr_lat_get(AGENT_INSTR_LAT_CTRL_RUN, &summary);
+  TEST_ASSERT_EQUAL_INT(100, summary.count);
+  TEST_ASSERT_EQUAL_INT(6980, summary.total_us);
+  TEST_ASSERT_EQUAL_INT(5000, summary.max_us);
+  // Percentiles are bucket bounds, within 25% of the values in them
+  TEST_ASSERT_EQUAL_INT(11, summary.p50_us);
+  TEST_ASSERT_EQUAL_INT(11, summary.p90_us);
+  TEST_ASSERT_EQUAL_INT(1023, summary.p99_us);
+
+  // Collect times are also kept by EDD
+  ari_t *id = adm_build_ari(AMP_TYPE_EDD, false, 12, 5);
+  tnv_t *val = ldc_collect(id, NULL);
+  tnv_release(val, 1);
+  ari_release(id, 1);
+
+  agent_instr_lat_get(AGENT_INSTR_LAT_EDD_COLLECT, &summary);
+  TEST_ASSERT_EQUAL_INT(1, summary.count);
+  int found = 0;
+  for (int i = 0; i < AGENT_INSTR_EDD_SLOTS; i++)
+  {
+    agent_instr_edd_t edd;
+    if (agent_instr_edd_get(i, &edd) == AMP_OK)
+    {
+      found += edd.count;
+    }
+  }
+  TEST_ASSERT_EQUAL_INT(1, found);
+
+  agent_instr_clear();
+  agent_instr_lat_get(AGENT_INSTR_LAT_CTRL_RUN, &summary);
+  TEST_ASSERT_EQUAL_INT(0, summary.count);
+}
+
+/// Number of times the test snapshot was fetched
+static int _test_snap_fetches;
+static uint32_t _test_snap_val;
+
+static int _test_snap_fetch(void *data)
+{
+  *(uint32_t *)data = ++_test_snap_fetches;
+  return AMP_OK;
+}
+
+/* Run one cycle reading the snapshot, as another worker would. */
+static void *_test_snap_other_cycle(void *arg)
+{
+  uint32_t val;
+  ldc_cycle_begin();
+  ldc_snap_read((ldc_snap_t *)arg, &val);
+  ldc_cycle_end();
+  return NULL;
+}
+
+void test_ldc_snap_cycle(void)
+{
+  static ldc_snap_t snap = LDC_SNAP_INIT(_test_snap_fetch, &_test_snap_val);
+  uint32_t val;
+  _test_snap_fetches = 0;
+  ldc_set_snap_max_age(0);
+
+  // Every read outside of a cycle fetches
+  TEST_ASSERT_EQUAL_INT(AMP_OK, ldc_snap_read(&snap, &val));
+  TEST_ASSERT_EQUAL_INT(AMP_OK, ldc_snap_read(&snap, &val));
+  TEST_ASSERT_EQUAL_INT(2, _test_snap_fetches);
+
+  // One fetch shared within a cycle, including nested ones
+  ldc_cycle_begin();
+  TEST_ASSERT_EQUAL_INT(AMP_OK, ldc_snap_read(&snap, &val));
+  ldc_cycle_begin();
+  TEST_ASSERT_EQUAL_INT(AMP_OK, ldc_snap_read(&snap, &val));
+  ldc_cycle_end();
+  TEST_ASSERT_EQUAL_INT(AMP_OK, ldc_snap_read(&snap, &val));
+  ldc_cycle_end();
+  TEST_ASSERT_EQUAL_INT(3, _test_snap_fetches);
+  TEST_ASSERT_EQUAL_INT(3, val);
+
+  // A new cycle fetches again, unless within the staleness bound
+  ldc_cycle_begin();
+  TEST_ASSERT_EQUAL_INT(AMP_OK, ldc_snap_read(&snap, &val));
+  ldc_cycle_end();
+  TEST_ASSERT_EQUAL_INT(4, _test_snap_fetches);
+
+  // A cycle on another thread fetching meanwhile doesn't change this one
+  pthread_t thr;
+  ldc_cycle_begin();
+  TEST_ASSERT_EQUAL_INT(AMP_OK, ldc_snap_read(&snap, &val));
+  TEST_ASSERT_EQUAL_INT(5, val);
+  TEST_ASSERT_EQUAL_INT(0, pthread_create(&thr, NULL, _test_snap_other_cycle, &snap));
+  TEST_ASSERT_EQUAL_INT(0, pthread_join(thr, NULL));
+  TEST_ASSERT_EQUAL_INT(6, _test_snap_fetches);
+  TEST_ASSERT_EQUAL_INT(AMP_OK, ldc_snap_read(&snap, &val));
+  TEST_ASSERT_EQUAL_INT(5, val);
+  // Invalidating drops this thread's copy
+  ldc_snap_invalidate(&snap);
+  TEST_ASSERT_EQUAL_INT(AMP_OK, ldc_snap_read(&snap, &val));
+  TEST_ASSERT_EQUAL_INT(7, val);
+  ldc_cycle_end();
+  TEST_ASSERT_EQUAL_INT(7, _test_snap_fetches);
+
+  ldc_set_snap_max_age(60000);
+  TEST_ASSERT_EQUAL_INT(AMP_OK, ldc_snap_read(&snap, &val));
+  TEST_ASSERT_EQUAL_INT(7, _test_snap_fetches);
+  ldc_snap_invalidate(&snap);
+  TEST_ASSERT_EQUAL_INT(AMP_OK, ldc_snap_read(&snap, &val));
+  TEST_ASSERT_EQUAL_INT(8, _test_snap_fetches);
+  ldc_set_snap_max_age(0);
+}
+
 void test_rx_thread(void)
 {
   pthread_t thr;
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2023 The Johns Hopkins University Applied Physics
+ * Laboratory LLC.
+ *
+ * This file is part of the Delay-Tolerant Networking Management
+ * Architecture (DTNMA) Tools package.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <shared/utils/utils.h>
+#include <unity.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/// Lengths around each block size of the vector and scalar paths
+static const size_t test_hex_lens[] = { 0, 1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 4096 };
+#define TEST_HEX_NUM_LENS (sizeof(test_hex_lens) / sizeof(test_hex_lens[0]))
+#define TEST_HEX_MAX_LEN 4096
+
+/// Characters just outside each range of hex digits
+static const char test_hex_bad[] = { '/', ':', '@', 'G', '`', 'g', ' ', '\x80', '\xff' };
+
+static uint8_t test_bytes[TEST_HEX_MAX_LEN];
+static char test_want[2 * TEST_HEX_MAX_LEN + 1];
+static char test_hex[2 * TEST_HEX_MAX_LEN + 2];
+static uint8_t test_out[TEST_HEX_MAX_LEN + 1];
+
+void setUp(void)
+{
+  TEST_ASSERT_EQUAL_INT(AMP_OK, utils_mem_int());
+}
+
+void tearDown(void)
+{
+  utils_mem_teardown();
+}
+
+/* Fill the test bytes with every value, and their digits one at a time. */
+static void test_hex_fill(size_t len)
+{
+  for (size_t ix = 0; ix < len; ++ix)
+  {
+    test_bytes[ix] = (uint8_t)(ix * 37 + len);
+    sprintf(test_want + 2 * ix, "%02x", test_bytes[ix]);
+  }
+  test_want[2 * len] = '\0';
+}
+
+void test_hex_encode(void)
+{
+  for (size_t lx = 0; lx < TEST_HEX_NUM_LENS; ++lx)
+  {
+    const size_t len = test_hex_lens[lx];
+    test_hex_fill(len);
+
+    memset(test_hex, 'x', sizeof(test_hex));
+    TEST_ASSERT_EQUAL_size_t(2 * len, utils_hex_encode(test_hex, test_bytes, len));
+    TEST_ASSERT_EQUAL_STRING(test_want, test_hex);
+    // Nothing past the terminator is written
+    TEST_ASSERT_EQUAL_INT('x', test_hex[2 * len + 1]);
+
+    char *str = utils_hex_to_string(test_bytes, len);
+    TEST_ASSERT_NOT_NULL(str);
+    TEST_ASSERT_EQUAL_STRING_LEN("0x", str, 2);
+    TEST_ASSERT_EQUAL_STRING(test_want, str + 2);
+    SRELEASE(str);
+  }
+}
+
+void test_hex_round_trip(void)
+{
+  for (size_t lx = 0; lx < TEST_HEX_NUM_LENS; ++lx)
+  {
+    const size_t len = test_hex_lens[lx];
+    test_hex_fill(len);
+    utils_hex_encode(test_hex, test_bytes, len);
+
+    size_t out_len = 1234;
+    memset(test_out, 0, sizeof(test_out));
+    TEST_ASSERT_EQUAL_INT(AMP_OK, utils_hex_decode(test_out, test_hex, 2 * len, &out_len));
+    TEST_ASSERT_EQUAL_size_t(len, out_len);
+    if (len > 0)
+    {
+      TEST_ASSERT_EQUAL_UINT8_ARRAY(test_bytes, test_out, len);
+    }
+
+    // Digits in either case decode the same
+    for (size_t ix = 0; ix < 2 * len; ++ix)
+    {
+      test_hex[ix] = (ix % 3) ? toupper(test_hex[ix]) : test_hex[ix];
+    }
+    memset(test_out, 0, sizeof(test_out));
+    TEST_ASSERT_EQUAL_INT(AMP_OK, utils_hex_decode(test_out, test_hex, 2 * len, NULL));
+    if (len > 0)
+    {
+      TEST_ASSERT_EQUAL_UINT8_ARRAY(test_bytes, test_out, len);
+    }
+
+    blob_t *blob = utils_string_to_hex(test_want);
+    TEST_ASSERT_NOT_NULL(blob);
+    TEST_ASSERT_EQUAL_size_t(len, blob->length);
+    if (len > 0)
+    {
+      TEST_ASSERT_EQUAL_UINT8_ARRAY(test_bytes, blob->value, len);
+    }
+    blob_release(blob, 1);
+  }
+}
+
+void test_hex_decode_upper(void)
+{
+  const uint8_t want[] = { 0xAB, 0xCD, 0xEF, 0x01, 0x9f };
+  size_t out_len;
+  TEST_ASSERT_EQUAL_INT(AMP_OK, utils_hex_decode(test_out, "ABCDEF019F", 10, &out_len));
+  TEST_ASSERT_EQUAL_size_t(sizeof(want), out_len);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(want, test_out, sizeof(want));
+
+  blob_t *blob = utils_string_to_hex("0xABcdEF019f");
+  TEST_ASSERT_NOT_NULL(blob);
+  TEST_ASSERT_EQUAL_size_t(sizeof(want), blob->length);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(want, blob->value, sizeof(want));
+  blob_release(blob, 1);
+}
+
+void test_hex_decode_odd(void)
+{
+  // An odd number of digits is read with a leading zero
+  const uint8_t want[] = { 0x0a, 0xbc };
+  size_t out_len;
+  TEST_ASSERT_EQUAL_INT(AMP_OK, utils_hex_decode(test_out, "abc", 3, &out_len));
+  TEST_ASSERT_EQUAL_size_t(2, out_len);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(want, test_out, 2);
+
+  // Including when the rest fills whole blocks
+  for (size_t lx = 0; lx < TEST_HEX_NUM_LENS; ++lx)
+  {
+    const size_t len = test_hex_lens[lx];
+    test_hex_fill(len);
+    test_hex[0] = '7';
+    strcpy(test_hex + 1, test_want);
+
+    memset(test_out, 0, sizeof(test_out));
+    TEST_ASSERT_EQUAL_INT(AMP_OK, utils_hex_decode(test_out, test_hex, 2 * len + 1, &out_len));
+    TEST_ASSERT_EQUAL_size_t(len + 1, out_len);
+    TEST_ASSERT_EQUAL_UINT8(0x07, test_out[0]);
+    if (len > 0)
+    {
+      TEST_ASSERT_EQUAL_UINT8_ARRAY(test_bytes, test_out + 1, len);
+    }
+
+    blob_t *blob = utils_string_to_hex(test_hex);
+    TEST_ASSERT_NOT_NULL(blob);
+    TEST_ASSERT_EQUAL_size_t(len + 1, blob->length);
+    blob_release(blob, 1);
+  }
+}
+
+void test_hex_decode_invalid(void)
+{
+  char msg[64];
+
+  // Each position of every vector lane and of the scalar tail
+  for (size_t lx = 0; lx < TEST_HEX_NUM_LENS; ++lx)
+  {
+    const size_t len = test_hex_lens[lx];
+    if (len > 65)
+    {
+      continue;
+    }
+    test_hex_fill(len);
+    for (size_t pos = 0; pos < 2 * len; ++pos)
+    {
+      for (size_t bx = 0; bx < sizeof(test_hex_bad); ++bx)
+      {
+        strcpy(test_hex, test_want);
+        test_hex[pos] = test_hex_bad[bx];
+        snprintf(msg, sizeof(msg), "length %zu position %zu char 0x%02x", len, pos, (uint8_t)test_hex_bad[bx]);
+        TEST_ASSERT_EQUAL_INT_MESSAGE(AMP_FAIL, utils_hex_decode(test_out, test_hex, 2 * len, NULL), msg);
+        // And with one more digit, which shifts every lane
+        memmove(test_hex + 1, test_hex, 2 * len + 1);
+        test_hex[0] = '0';
+        TEST_ASSERT_EQUAL_INT_MESSAGE(AMP_FAIL, utils_hex_decode(test_out, test_hex, 2 * len + 1, NULL), msg);
+      }
+    }
+  }
+
+  TEST_ASSERT_EQUAL_INT(AMP_FAIL, utils_hex_decode(test_out, "g", 1, NULL));
+  TEST_ASSERT_NULL(utils_string_to_hex("0x12z4"));
+}